@@ -0,0 +1,142 @@
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "benchmark/benchmark.h"
+#include "catalog/catalog.h"
+#include "execution/exec/execution_context.h"
+#include "execution/parsing/parser.h"
+#include "execution/parsing/scanner.h"
+#include "execution/sema/error_reporter.h"
+#include "execution/sema/sema.h"
+#include "execution/table_generator/table_generator.h"
+#include "execution/util/cpu_info.h"
+#include "execution/vm/bytecode_generator.h"
+#include "execution/vm/bytecode_module.h"
+#include "execution/vm/module.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "storage/garbage_collector.h"
+#include "transaction/deferred_action_manager.h"
+#include "transaction/timestamp_manager.h"
+#include "transaction/transaction_manager.h"
+#include "transaction/transaction_util.h"
+
+namespace terrier {
+
+// This benchmark runs short programs from sample_tpl in the interpreter alone, as queries too short to ever be worth
+// compiling do, once with superinstructions and once without. The argument of each benchmark is whether the
+// interpreter uses superinstructions.
+
+class InterpreterBenchmark : public benchmark::Fixture {
+ public:
+  void SetUp(const benchmark::State &state) final {
+    execution::CpuInfo::Instance();
+    timestamp_manager_ = std::make_unique<transaction::TimestampManager>();
+    deferred_action_manager_ = std::make_unique<transaction::DeferredActionManager>(timestamp_manager_.get());
+    txn_manager_ = std::make_unique<transaction::TransactionManager>(
+        timestamp_manager_.get(), deferred_action_manager_.get(), &buffer_pool_, true, DISABLED);
+    gc_ = std::make_unique<storage::GarbageCollector>(timestamp_manager_.get(), deferred_action_manager_.get(),
+                                                      txn_manager_.get(), nullptr);
+    txn_ = txn_manager_->BeginTransaction();
+
+    // Create the catalog and the test tables the SQL programs scan
+    catalog_ = std::make_unique<catalog::Catalog>(txn_manager_.get(), &block_store_);
+    const auto db_oid = catalog_->CreateDatabase(txn_, "test_db", true);
+    auto accessor = std::unique_ptr<catalog::CatalogAccessor>(catalog_->GetAccessor(txn_, db_oid));
+    const auto ns_oid = accessor->GetDefaultNamespace();
+    exec_ctx_ =
+        std::make_unique<execution::exec::ExecutionContext>(db_oid, txn_, nullptr, nullptr, std::move(accessor));
+    execution::sql::TableGenerator table_generator{exec_ctx_.get(), &block_store_, ns_oid};
+    table_generator.GenerateTestTables();
+  }
+
+  void TearDown(const benchmark::State &state) final {
+    exec_ctx_.reset();
+    txn_manager_->Commit(txn_, transaction::TransactionUtil::EmptyCallback, nullptr);
+    catalog_->TearDown();
+    gc_->PerformGarbageCollection();
+    gc_->PerformGarbageCollection();
+    catalog_.reset();
+    gc_.reset();
+    txn_manager_.reset();
+    deferred_action_manager_.reset();
+    timestamp_manager_.reset();
+  }
+
+  // Compile the given program in sample_tpl and interpret its main function once per iteration
+  void RunInterpreted(benchmark::State *state, const std::string &filename, const bool is_sql) {
+    auto file = llvm::MemoryBuffer::getFile(std::string(SAMPLE_TPL_DIR) + "/" + filename);
+    if (std::error_code error = file.getError()) {
+      state->SkipWithError(("cannot read " + filename + ": " + error.message()).c_str());
+      return;
+    }
+    const std::string source = (*file)->getBuffer().str();
+
+    execution::util::Region region("interpreter_benchmark");
+    execution::sema::ErrorReporter error_reporter(&region);
+    execution::ast::Context context(&region, &error_reporter);
+    execution::parsing::Scanner scanner(source.data(), source.length());
+    execution::parsing::Parser parser(&scanner, &context);
+    auto *root = parser.Parse();
+    execution::sema::Sema type_check(&context);
+    type_check.Run(root);
+    if (error_reporter.HasErrors()) {
+      state->SkipWithError(("cannot compile " + filename + ": " + error_reporter.SerializeErrors()).c_str());
+      return;
+    }
+
+    auto bytecode_module = execution::vm::BytecodeGenerator::Compile(root, exec_ctx_.get(), "interpreter_benchmark");
+    bytecode_module->SetSuperinstructionsEnabled(state->range(0) != 0);
+    execution::vm::Module module(std::move(bytecode_module));
+
+    std::function<int64_t()> main;
+    std::function<int64_t(execution::exec::ExecutionContext *)> sql_main;
+    const bool found = is_sql ? module.GetFunction("main", execution::vm::ExecutionMode::Interpret, &sql_main)
+                              : module.GetFunction("main", execution::vm::ExecutionMode::Interpret, &main);
+    if (!found) {
+      state->SkipWithError((filename + " has no main function of the expected type").c_str());
+      return;
+    }
+
+    // NOLINTNEXTLINE
+    for (auto _ : *state) {
+      benchmark::DoNotOptimize(is_sql ? sql_main(exec_ctx_.get()) : main());
+    }
+    state->SetItemsProcessed(state->iterations());
+  }
+
+ private:
+  storage::BlockStore block_store_{1000, 1000};
+  storage::RecordBufferSegmentPool buffer_pool_{100000, 100000};
+  std::unique_ptr<transaction::TimestampManager> timestamp_manager_;
+  std::unique_ptr<transaction::DeferredActionManager> deferred_action_manager_;
+  std::unique_ptr<transaction::TransactionManager> txn_manager_;
+  std::unique_ptr<storage::GarbageCollector> gc_;
+  std::unique_ptr<catalog::Catalog> catalog_;
+  transaction::TransactionContext *txn_;
+  std::unique_ptr<execution::exec::ExecutionContext> exec_ctx_;
+};
+
+// NOLINTNEXTLINE
+BENCHMARK_DEFINE_F(InterpreterBenchmark, Loop)(benchmark::State &state) { RunInterpreted(&state, "loop2.tpl", false); }
+
+// NOLINTNEXTLINE
+BENCHMARK_DEFINE_F(InterpreterBenchmark, Fib)(benchmark::State &state) { RunInterpreted(&state, "fib.tpl", false); }
+
+// NOLINTNEXTLINE
+BENCHMARK_DEFINE_F(InterpreterBenchmark, Scan)(benchmark::State &state) {
+  RunInterpreted(&state, "scan-table.tpl", true);
+}
+
+// NOLINTNEXTLINE
+BENCHMARK_DEFINE_F(InterpreterBenchmark, ScanFilter)(benchmark::State &state) {
+  RunInterpreted(&state, "scan-table-3.tpl", true);
+}
+
+BENCHMARK_REGISTER_F(InterpreterBenchmark, Loop)->Unit(benchmark::kMicrosecond)->Arg(0)->Arg(1);
+BENCHMARK_REGISTER_F(InterpreterBenchmark, Fib)->Unit(benchmark::kMicrosecond)->Arg(0)->Arg(1);
+BENCHMARK_REGISTER_F(InterpreterBenchmark, Scan)->Unit(benchmark::kMicrosecond)->Arg(0)->Arg(1);
+BENCHMARK_REGISTER_F(InterpreterBenchmark, ScanFilter)->Unit(benchmark::kMicrosecond)->Arg(0)->Arg(1);
+
+}  // namespace terrier
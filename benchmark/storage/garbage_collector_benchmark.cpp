@@ -2,27 +2,43 @@
 #include <vector>
 
 #include "benchmark/benchmark.h"
+#include "catalog/catalog.h"
 #include "common/scoped_timer.h"
+#include "common/worker_pool.h"
 #include "storage/garbage_collector.h"
+#include "transaction/deferred_action_manager.h"
 #include "util/data_table_benchmark_util.h"
+#include "util/storage_test_util.h"
+#include "util/tpcc/builder.h"
+#include "util/tpcc/database.h"
+#include "util/tpcc/loader.h"
+#include "util/tpcc/worker.h"
+#include "util/tpcc/workload.h"
 
 namespace terrier {
 
 class GarbageCollectorBenchmark : public benchmark::Fixture {
  public:
   void StartGC(transaction::TimestampManager *const timestamp_manager,
-               transaction::TransactionManager *const txn_manager) {
-    gc_ = new storage::GarbageCollector(timestamp_manager, DISABLED, txn_manager, DISABLED);
+               transaction::TransactionManager *const txn_manager, common::WorkerPool *const gc_worker_pool = nullptr,
+               transaction::DeferredActionManager *const deferred_action_manager = DISABLED) {
+    gc_ = new storage::GarbageCollector(timestamp_manager, deferred_action_manager, txn_manager, DISABLED);
+    gc_->SetWorkerPool(gc_worker_pool);
     run_gc_ = true;
     gc_thread_ = std::thread([this] { GCThreadLoop(); });
   }
 
-  uint32_t EndGC() {
+  // Stops the GC thread and returns the number of txns it had not gotten around to deallocating
+  uint32_t StopGC() {
     run_gc_ = false;
     gc_thread_.join();
     // Make sure all garbage is collected. This take 2 runs for unlink and deallocate
     gc_->PerformGarbageCollection();
-    const uint32_t lag_count = gc_->PerformGarbageCollection().first;
+    return gc_->PerformGarbageCollection().first;
+  }
+
+  uint32_t EndGC() {
+    const uint32_t lag_count = StopGC();
     delete gc_;
     return lag_count;
   }
@@ -151,6 +167,63 @@ BENCHMARK_DEFINE_F(GarbageCollectorBenchmark, HighContention)(benchmark::State &
   state.SetItemsProcessed(state.iterations() * num_txns_ - lag_count);
 }
 
+/**
+ * Run TPC-C while the GC collects in the background over the given number of threads. Measure the reclamation lag, that
+ * is the number of transactions that the GC still had to clean up once the workload was done running.
+ */
+// NOLINTNEXTLINE
+BENCHMARK_DEFINE_F(GarbageCollectorBenchmark, TPCCReclamationLag)(benchmark::State &state) {
+  const auto num_gc_threads = static_cast<uint32_t>(state.range(0));
+  const int8_t num_terminals = 4;
+  const uint32_t num_txns_per_terminal = 20000;
+  const auto precomputed_args =
+      tpcc::PrecomputeArgs(&generator_, tpcc::TransactionWeights(), num_terminals, num_txns_per_terminal);
+  std::vector<tpcc::Worker> workers;
+  workers.reserve(num_terminals);
+  common::WorkerPool thread_pool(num_terminals, {});
+  uint64_t lag_count = 0;
+  // NOLINTNEXTLINE
+  for (auto _ : state) {
+    transaction::TimestampManager timestamp_manager;
+    transaction::DeferredActionManager deferred_action_manager(&timestamp_manager);
+    transaction::TransactionManager txn_manager(&timestamp_manager, &deferred_action_manager, &buffer_pool_, true,
+                                                DISABLED);
+    catalog::Catalog catalog(&txn_manager, &block_store_);
+    tpcc::Builder tpcc_builder(&block_store_, &catalog, &txn_manager);
+    auto *const tpcc_db = tpcc_builder.Build(storage::index::IndexType::HASHMAP);
+    workers.clear();
+    for (int8_t i = 0; i < num_terminals; i++) workers.emplace_back(tpcc_db);
+    tpcc::Loader::PopulateDatabase(&txn_manager, tpcc_db, &workers, &thread_pool);
+
+    // A single GC thread collects without a worker pool
+    auto *const gc_worker_pool = num_gc_threads > 1 ? new common::WorkerPool(num_gc_threads, {}) : nullptr;
+    StartGC(&timestamp_manager, &txn_manager, gc_worker_pool, &deferred_action_manager);
+    tpcc::Util::RegisterIndexesForGC(gc_, tpcc_db);
+    uint64_t elapsed_ms;
+    {
+      common::ScopedTimer<std::chrono::milliseconds> timer(&elapsed_ms);
+      for (int8_t i = 0; i < num_terminals; i++) {
+        thread_pool.SubmitTask([i, tpcc_db, &txn_manager, &precomputed_args, &workers] {
+          tpcc::Workload(i, tpcc_db, &txn_manager, precomputed_args, &workers);
+        });
+      }
+      thread_pool.WaitUntilAllFinished();
+    }
+    tpcc::Util::UnregisterIndexesForGC(gc_, tpcc_db);
+    lag_count += StopGC();
+    state.SetIterationTime(static_cast<double>(elapsed_ms) / 1000.0);
+
+    catalog.TearDown();
+    StorageTestUtil::FullyPerformGC(gc_, DISABLED);
+    delete gc_;
+    delete gc_worker_pool;
+    delete tpcc_db;
+  }
+  tpcc::CleanUpVarlensInPrecomputedArgs(&precomputed_args);
+  state.counters["lag_txns"] = static_cast<double>(lag_count) / static_cast<double>(state.iterations());
+  state.SetItemsProcessed(state.iterations() * num_terminals * num_txns_per_terminal);
+}
+
 BENCHMARK_REGISTER_F(GarbageCollectorBenchmark, UnlinkTime)->Unit(benchmark::kMillisecond)->UseManualTime()->MinTime(1);
 BENCHMARK_REGISTER_F(GarbageCollectorBenchmark, ReclaimTime)
     ->Unit(benchmark::kMillisecond)
@@ -160,4 +233,10 @@ BENCHMARK_REGISTER_F(GarbageCollectorBenchmark, HighContention)
     ->Unit(benchmark::kMillisecond)
     ->UseManualTime()
     ->MinTime(2);
+BENCHMARK_REGISTER_F(GarbageCollectorBenchmark, TPCCReclamationLag)
+    ->Unit(benchmark::kMillisecond)
+    ->UseManualTime()
+    ->MinTime(5)
+    ->RangeMultiplier(2)
+    ->Range(1, 8);
 }  // namespace terrier
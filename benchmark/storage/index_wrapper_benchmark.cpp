@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <memory>
 #include <vector>
 
@@ -45,7 +46,7 @@ class IndexBenchmark : public benchmark::Fixture {
   storage::ProjectedRowInitializer tuple_initializer_ =
       storage::ProjectedRowInitializer::Create(std::vector<uint8_t>{1}, std::vector<uint16_t>{1});  // This is a dummy
 
-  // HashIndex or BwTreeIndex
+  // HashIndex, BwTreeIndex or BPlusTreeIndex
   common::ManagedPointer<storage::index::Index> index_;
   transaction::TimestampManager *timestamp_manager_;
   transaction::DeferredActionManager *deferred_action_manager_;
@@ -137,6 +138,31 @@ class IndexBenchmark : public benchmark::Fixture {
     txn_manager_->Commit(insert_txn, transaction::TransactionUtil::EmptyCallback, nullptr);
   }
 
+  // Table is populated with keys drawn from [0, num_keys) with a quadratic skew towards the smallest ones, so that
+  // every key has many duplicates on average and a few keys have orders of magnitude more than that. Returns the
+  // number of tuples with each key.
+  std::vector<uint32_t> PopulateSkewedTableAndIndex(const uint32_t num_keys) {
+    auto *const insert_key = index_->GetProjectedRowInitializer().InitializeRow(key_buffer_);
+    auto *const insert_txn = txn_manager_->BeginTransaction();
+    std::vector<uint32_t> key_counts(num_keys, 0);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+    for (uint32_t i = 0; i < table_size_; i++) {
+      const double u = uniform(generator_);
+      const auto key = std::min(static_cast<uint32_t>(u * u * num_keys), num_keys - 1);
+      key_counts[key]++;
+      auto *const insert_redo =
+          insert_txn->StageWrite(CatalogTestUtil::TEST_DB_OID, CatalogTestUtil::TEST_TABLE_OID, tuple_initializer_);
+      auto *const insert_tuple = insert_redo->Delta();
+      *reinterpret_cast<uint32_t *>(insert_tuple->AccessForceNotNull(0)) = key;
+      const auto tuple_slot = sql_table_->Insert(insert_txn, insert_redo);
+      *reinterpret_cast<uint32_t *>(insert_key->AccessForceNotNull(0)) = key;
+      EXPECT_TRUE(index_->Insert(insert_txn, *insert_key, tuple_slot));
+    }
+    txn_manager_->Commit(insert_txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+    return key_counts;
+  }
+
   // Do a random lookup of a subset of keys in the domain; scoped timer only times ScanKey operation
   // and will accumulate into a value for the total amount of time required
   uint64_t RunWorkload() {
@@ -165,6 +191,63 @@ class IndexBenchmark : public benchmark::Fixture {
     txn_manager_->Commit(scan_txn, transaction::TransactionUtil::EmptyCallback, nullptr);
     return total_ns;
   }
+
+  // Look up as many keys as there are in the domain, uniformly at random, timed like the lookups above. Lookups do not
+  // follow the skew of the data, which would make a handful of keys dominate the running time.
+  uint64_t RunSkewedWorkload(const std::vector<uint32_t> &key_counts) {
+    auto *scan_txn = txn_manager_->BeginTransaction();
+    auto *const scan_key_pr = index_->GetProjectedRowInitializer().InitializeRow(key_buffer_);
+    const auto num_keys = static_cast<uint32_t>(key_counts.size());
+    uint64_t total_ns = 0;
+    uint64_t elapsed_ns = 0;
+
+    std::vector<storage::TupleSlot> results;
+    for (uint32_t i = 0; i < num_keys; i++) {
+      const uint32_t random_key = std::uniform_int_distribution(static_cast<uint32_t>(0), num_keys - 1)(generator_);
+      *reinterpret_cast<uint32_t *>(scan_key_pr->AccessForceNotNull(0)) = random_key;
+      {
+        common::ScopedTimer<std::chrono::nanoseconds> timer(&elapsed_ns);
+        index_->ScanKey(*scan_txn, *scan_key_pr, &results);
+      }
+      EXPECT_EQ(results.size(), key_counts[random_key]);
+      results.clear();
+      total_ns += elapsed_ns;
+    }
+
+    txn_manager_->Commit(scan_txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+    return total_ns;
+  }
+
+  // Do ascending scans over random ranges of the given number of keys, timed like the lookups above. There are as
+  // many scans as it takes to visit about table_size keys.
+  uint64_t RunScanWorkload(const uint32_t scan_size) {
+    auto *scan_txn = txn_manager_->BeginTransaction();
+    byte *const high_key_buffer =
+        common::AllocationUtil::AllocateAligned(index_->GetProjectedRowInitializer().ProjectedRowSize());
+    auto *const low_key_pr = index_->GetProjectedRowInitializer().InitializeRow(key_buffer_);
+    auto *const high_key_pr = index_->GetProjectedRowInitializer().InitializeRow(high_key_buffer);
+    uint64_t total_ns = 0;
+    uint64_t elapsed_ns = 0;
+
+    std::vector<storage::TupleSlot> results;
+    for (uint32_t i = 0; i < table_size_ / scan_size; i++) {
+      const uint32_t random_key = std::uniform_int_distribution(
+          static_cast<uint32_t>(0), static_cast<uint32_t>(table_size_ - scan_size))(generator_);
+      *reinterpret_cast<uint32_t *>(low_key_pr->AccessForceNotNull(0)) = random_key;
+      *reinterpret_cast<uint32_t *>(high_key_pr->AccessForceNotNull(0)) = random_key + scan_size - 1;
+      {
+        common::ScopedTimer<std::chrono::nanoseconds> timer(&elapsed_ns);
+        index_->ScanAscending(*scan_txn, *low_key_pr, *high_key_pr, &results);
+      }
+      EXPECT_EQ(results.size(), scan_size);
+      results.clear();
+      total_ns += elapsed_ns;
+    }
+
+    txn_manager_->Commit(scan_txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+    delete[] high_key_buffer;
+    return total_ns;
+  }
 };
 
 // Determine required time to run key lookup with BwTree structure for index
@@ -198,7 +281,87 @@ BENCHMARK_DEFINE_F(IndexBenchmark, HashIndexRandomScanKey)(benchmark::State &sta
   state.SetItemsProcessed(state.iterations() * table_size_);
 }
 
+// Determine required time to run key lookup with B+Tree structure for index
+// NOLINTNEXTLINE
+BENCHMARK_DEFINE_F(IndexBenchmark, BPlusTreeIndexRandomScanKey)(benchmark::State &state) {
+  CreateIndex(storage::index::IndexType::BPLUSTREE);
+  PopulateTableAndIndex();
+  // NOLINTNEXTLINE
+  for (auto _ : state) {
+    // Run key lookup and record amount of time required in seconds
+    const auto total_ns = RunWorkload();
+    state.SetIterationTime(static_cast<double>(total_ns) / 1000000000.0);
+  }
+  // Determine total number of items processed
+  state.SetItemsProcessed(state.iterations() * table_size_);
+}
+
+// Determine required time to run range scans of the given size with BwTree structure for index
+// NOLINTNEXTLINE
+BENCHMARK_DEFINE_F(IndexBenchmark, BwTreeIndexRandomScanAscending)(benchmark::State &state) {
+  const auto scan_size = static_cast<uint32_t>(state.range(0));
+  CreateIndex(storage::index::IndexType::BWTREE);
+  PopulateTableAndIndex();
+  // NOLINTNEXTLINE
+  for (auto _ : state) {
+    // Run range scans and record amount of time required in seconds
+    const auto total_ns = RunScanWorkload(scan_size);
+    state.SetIterationTime(static_cast<double>(total_ns) / 1000000000.0);
+  }
+  // Determine total number of keys scanned
+  state.SetItemsProcessed(state.iterations() * (table_size_ / scan_size) * scan_size);
+}
+
+// Determine required time to run range scans of the given size with B+Tree structure for index
+// NOLINTNEXTLINE
+BENCHMARK_DEFINE_F(IndexBenchmark, BPlusTreeIndexRandomScanAscending)(benchmark::State &state) {
+  const auto scan_size = static_cast<uint32_t>(state.range(0));
+  CreateIndex(storage::index::IndexType::BPLUSTREE);
+  PopulateTableAndIndex();
+  // NOLINTNEXTLINE
+  for (auto _ : state) {
+    // Run range scans and record amount of time required in seconds
+    const auto total_ns = RunScanWorkload(scan_size);
+    state.SetIterationTime(static_cast<double>(total_ns) / 1000000000.0);
+  }
+  // Determine total number of keys scanned
+  state.SetItemsProcessed(state.iterations() * (table_size_ / scan_size) * scan_size);
+}
+
+// Determine required time to look up keys with many, unevenly distributed duplicates with HashMap structure for index.
+// The argument is the average number of tuples per key.
+// NOLINTNEXTLINE
+BENCHMARK_DEFINE_F(IndexBenchmark, HashIndexSkewedDuplicateScanKey)(benchmark::State &state) {
+  const auto num_keys = table_size_ / static_cast<uint32_t>(state.range(0));
+  CreateIndex(storage::index::IndexType::HASHMAP);
+  const auto key_counts = PopulateSkewedTableAndIndex(num_keys);
+  // NOLINTNEXTLINE
+  for (auto _ : state) {
+    // Run key lookup and record amount of time required in seconds
+    const auto total_ns = RunSkewedWorkload(key_counts);
+    state.SetIterationTime(static_cast<double>(total_ns) / 1000000000.0);
+  }
+  // Determine total number of values returned, assuming the random keys averaged out
+  state.SetItemsProcessed(state.iterations() * table_size_);
+}
+
 BENCHMARK_REGISTER_F(IndexBenchmark, BwTreeIndexRandomScanKey)->UseManualTime()->Unit(benchmark::kMillisecond);
 BENCHMARK_REGISTER_F(IndexBenchmark, HashIndexRandomScanKey)->UseManualTime()->Unit(benchmark::kMillisecond);
+BENCHMARK_REGISTER_F(IndexBenchmark, BPlusTreeIndexRandomScanKey)->UseManualTime()->Unit(benchmark::kMillisecond);
+BENCHMARK_REGISTER_F(IndexBenchmark, HashIndexSkewedDuplicateScanKey)
+    ->UseManualTime()
+    ->Unit(benchmark::kMillisecond)
+    ->Arg(4)
+    ->Arg(100);
+BENCHMARK_REGISTER_F(IndexBenchmark, BwTreeIndexRandomScanAscending)
+    ->UseManualTime()
+    ->Unit(benchmark::kMillisecond)
+    ->Arg(10)
+    ->Arg(1000);
+BENCHMARK_REGISTER_F(IndexBenchmark, BPlusTreeIndexRandomScanAscending)
+    ->UseManualTime()
+    ->Unit(benchmark::kMillisecond)
+    ->Arg(10)
+    ->Arg(1000);
 
 }  // namespace terrier
@@ -1,9 +1,12 @@
+#include <atomic>
+#include <thread>  // NOLINT
 #include <vector>
 #include "benchmark/benchmark.h"
 #include "common/scoped_timer.h"
 #include "storage/garbage_collector_thread.h"
 #include "storage/storage_defs.h"
 #include "storage/write_ahead_log/log_manager.h"
+#include "util/catalog_test_util.h"
 #include "util/data_table_benchmark_util.h"
 
 #define LOG_FILE_NAME "/mnt/ramdisk/benchmark.txt"
@@ -230,6 +233,56 @@ BENCHMARK_DEFINE_F(LoggingBenchmark, SingleStatementSelect)(benchmark::State &st
   state.SetItemsProcessed(state.iterations() * num_txns_ - abort_count);
 }
 
+/**
+ * Latency of committing a single insert, from the call to Commit until the commit callback is invoked, which happens
+ * once the commit record is persisted. Transactions run one at a time, so each waits for its own commit record to go
+ * through the serializer and the disk log consumer. The argument is the log serialization interval in microseconds.
+ */
+// NOLINTNEXTLINE
+BENCHMARK_DEFINE_F(LoggingBenchmark, CommitLatency)(benchmark::State &state) {
+  const uint32_t num_commits = 1000;
+  const std::chrono::microseconds serialization_interval{state.range(0)};
+  storage::BlockLayout layout(attr_sizes_);
+  const auto row_initializer =
+      storage::ProjectedRowInitializer::Create(layout, StorageTestUtil::ProjectionListAllColumns(layout));
+  // NOLINTNEXTLINE
+  for (auto _ : state) {
+    unlink(LOG_FILE_NAME);
+    log_manager_ = new storage::LogManager(LOG_FILE_NAME, num_log_buffers_, serialization_interval,
+                                           log_persist_interval_, log_persist_threshold_, &buffer_pool_,
+                                           common::ManagedPointer<common::DedicatedThreadRegistry>(&thread_registry_));
+    log_manager_->Start();
+    storage::DataTable table(&block_store_, layout, storage::layout_version_t(0));
+    transaction::TimestampManager timestamp_manager;
+    transaction::TransactionManager txn_manager(&timestamp_manager, DISABLED, &buffer_pool_, true, log_manager_);
+    gc_ = new storage::GarbageCollector(&timestamp_manager, DISABLED, &txn_manager, DISABLED);
+    gc_thread_ = new storage::GarbageCollectorThread(gc_, gc_period_);
+
+    uint64_t elapsed_ns = 0;
+    for (uint32_t i = 0; i < num_commits; i++) {
+      auto *const txn = txn_manager.BeginTransaction();
+      auto *const redo =
+          txn->StageWrite(CatalogTestUtil::TEST_DB_OID, CatalogTestUtil::TEST_TABLE_OID, row_initializer);
+      StorageTestUtil::PopulateRandomRow(redo->Delta(), layout, 0.0, &generator_);
+      redo->SetTupleSlot(table.Insert(txn, *(redo->Delta())));
+      std::atomic<bool> persisted{false};
+      const auto start = std::chrono::high_resolution_clock::now();
+      txn_manager.Commit(txn, [](void *arg) { static_cast<std::atomic<bool> *>(arg)->store(true); }, &persisted);
+      while (!persisted.load()) std::this_thread::yield();
+      elapsed_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::high_resolution_clock::now() -
+                                                                         start)
+                        .count();
+    }
+    state.SetIterationTime(static_cast<double>(elapsed_ns) / 1e9);
+    log_manager_->PersistAndStop();
+    delete log_manager_;
+    delete gc_thread_;
+    delete gc_;
+    unlink(LOG_FILE_NAME);
+  }
+  state.SetItemsProcessed(state.iterations() * num_commits);
+}
+
 BENCHMARK_REGISTER_F(LoggingBenchmark, TPCCish)->Unit(benchmark::kMillisecond)->UseManualTime()->MinTime(3);
 
 BENCHMARK_REGISTER_F(LoggingBenchmark, HighAbortRate)->Unit(benchmark::kMillisecond)->UseManualTime()->MinTime(10);
@@ -248,4 +301,11 @@ BENCHMARK_REGISTER_F(LoggingBenchmark, SingleStatementSelect)
     ->Unit(benchmark::kMillisecond)
     ->UseManualTime()
     ->MinTime(1);
+
+// Serialization intervals of the benchmarks above, and the default of the log_serialization_interval setting
+BENCHMARK_REGISTER_F(LoggingBenchmark, CommitLatency)
+    ->Unit(benchmark::kMillisecond)
+    ->UseManualTime()
+    ->Arg(5)
+    ->Arg(10000);
 }  // namespace terrier
@@ -1,3 +1,4 @@
+#include <memory>
 #include <vector>
 #include "benchmark/benchmark.h"
 #include "catalog/catalog_accessor.h"
@@ -38,8 +39,10 @@ class RecoveryBenchmark : public benchmark::Fixture {
    * Runs the recovery benchmark with the provided config
    * @param state benchmark state
    * @param config config to use for test object
+   * @param num_replay_threads number of threads to replay the log on, or 0 to replay on the recovery thread only
    */
-  void RunBenchmark(benchmark::State *state, const LargeSqlTableTestConfiguration &config) {
+  void RunBenchmark(benchmark::State *state, const LargeSqlTableTestConfiguration &config,
+                    const uint32_t num_replay_threads = 0) {
     // NOLINTNEXTLINE
     for (auto _ : *state) {
       // Blow away log file after every benchmark iteration
@@ -78,9 +81,13 @@ class RecoveryBenchmark : public benchmark::Fixture {
 
       // Instantiate recovery manager, and recover the tables.
       storage::DiskLogProvider log_provider(LOG_FILE_NAME);
+      std::unique_ptr<common::WorkerPool> replay_pool;
+      if (num_replay_threads > 0)
+        replay_pool = std::make_unique<common::WorkerPool>(num_replay_threads, common::TaskQueue());
       storage::RecoveryManager recovery_manager(&log_provider, common::ManagedPointer(&recovered_catalog),
                                                 &recovery_txn_manager, &recovery_deferred_action_manager,
-                                                common::ManagedPointer(thread_registry_), &block_store_);
+                                                common::ManagedPointer(thread_registry_), &block_store_,
+                                                replay_pool.get());
 
       uint64_t elapsed_ms;
       {
@@ -144,6 +151,25 @@ BENCHMARK_DEFINE_F(RecoveryBenchmark, HighStress)(benchmark::State &state) {
   RunBenchmark(&state, config);
 }
 
+/**
+ * Same as the read-write workload, but replays the log in parallel on the number of threads given by the benchmark
+ * argument. Items processed per second is the replay throughput in transactions.
+ */
+// NOLINTNEXTLINE
+BENCHMARK_DEFINE_F(RecoveryBenchmark, ParallelReplay)(benchmark::State &state) {
+  LargeSqlTableTestConfiguration config = LargeSqlTableTestConfiguration::Builder()
+                                              .SetNumDatabases(1)
+                                              .SetNumTables(1)
+                                              .SetMaxColumns(5)
+                                              .SetInitialTableSize(initial_table_size_)
+                                              .SetTxnLength(5)
+                                              .SetInsertUpdateSelectDeleteRatio({0.5, 0.0, 0.5, 0.0})
+                                              .SetVarlenAllowed(true)
+                                              .Build();
+
+  RunBenchmark(&state, config, static_cast<uint32_t>(state.range(0)));
+}
+
 /**
  * Similar to high-stress workload, blast a narrow table with inserts (1 statements per txn, 100% inserts), but also
  * recovery indexes built on the table
@@ -267,6 +293,15 @@ BENCHMARK_REGISTER_F(RecoveryBenchmark, ReadWriteWorkload)->Unit(benchmark::kMil
 
 BENCHMARK_REGISTER_F(RecoveryBenchmark, HighStress)->Unit(benchmark::kMillisecond)->UseManualTime()->MinTime(10);
 
+BENCHMARK_REGISTER_F(RecoveryBenchmark, ParallelReplay)
+    ->Unit(benchmark::kMillisecond)
+    ->UseManualTime()
+    ->MinTime(10)
+    ->Arg(1)
+    ->Arg(2)
+    ->Arg(4)
+    ->Arg(8);
+
 BENCHMARK_REGISTER_F(RecoveryBenchmark, IndexRecovery)->Unit(benchmark::kMillisecond)->UseManualTime()->MinTime(4);
 
 }  // namespace terrier
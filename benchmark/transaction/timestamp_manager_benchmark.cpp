@@ -0,0 +1,90 @@
+#include "benchmark/benchmark.h"
+#include "common/scoped_timer.h"
+#include "common/worker_pool.h"
+#include "storage/garbage_collector_thread.h"
+#include "transaction/deferred_action_manager.h"
+#include "transaction/transaction_manager.h"
+#include "transaction/transaction_util.h"
+
+namespace terrier {
+
+// This benchmark measures how transaction begin and commit scale with the number of threads. The transactions do no
+// work, so the time is all spent checking out timestamps, tracking them as active in the TimestampManager and handing
+// them to the GC, which runs in the background and keeps scanning for the oldest active transaction. Every benchmark
+// runs with timestamp checkouts batched and not.
+class TimestampManagerBenchmark : public benchmark::Fixture {
+ public:
+  const uint32_t num_txns_ = 1000000;
+  const uint32_t num_checkouts_ = 10000000;
+  storage::RecordBufferSegmentPool buffer_pool_{1000000, 1000000};
+  const std::chrono::milliseconds gc_period_{10};
+};
+
+// Check out timestamps and nothing else from the given number of threads
+// NOLINTNEXTLINE
+BENCHMARK_DEFINE_F(TimestampManagerBenchmark, CheckOut)(benchmark::State &state) {
+  const auto num_threads = static_cast<uint32_t>(state.range(0));
+  const bool batch_checkouts = state.range(1) != 0;
+  // NOLINTNEXTLINE
+  for (auto _ : state) {
+    transaction::TimestampManager timestamp_manager(batch_checkouts);
+    auto workload = [&] {
+      for (uint32_t i = 0; i < num_checkouts_ / num_threads; i++) timestamp_manager.CheckOutTimestamp();
+    };
+    common::WorkerPool thread_pool(num_threads, {});
+    uint64_t elapsed_ms;
+    {
+      common::ScopedTimer<std::chrono::milliseconds> timer(&elapsed_ms);
+      for (uint32_t j = 0; j < num_threads; j++) thread_pool.SubmitTask(workload);
+      thread_pool.WaitUntilAllFinished();
+    }
+    state.SetIterationTime(static_cast<double>(elapsed_ms) / 1000.0);
+  }
+  state.SetItemsProcessed(state.iterations() * num_checkouts_);
+}
+
+// Begin and commit read-only transactions from the given number of threads
+// NOLINTNEXTLINE
+BENCHMARK_DEFINE_F(TimestampManagerBenchmark, BeginCommit)(benchmark::State &state) {
+  const auto num_threads = static_cast<uint32_t>(state.range(0));
+  const bool batch_checkouts = state.range(1) != 0;
+  // NOLINTNEXTLINE
+  for (auto _ : state) {
+    transaction::TimestampManager timestamp_manager(batch_checkouts);
+    transaction::DeferredActionManager deferred_action_manager(&timestamp_manager);
+    transaction::TransactionManager txn_manager(&timestamp_manager, &deferred_action_manager, &buffer_pool_, true,
+                                                DISABLED);
+    storage::GarbageCollector gc(&timestamp_manager, &deferred_action_manager, &txn_manager, DISABLED);
+    auto *gc_thread = new storage::GarbageCollectorThread(&gc, gc_period_);
+
+    auto workload = [&] {
+      for (uint32_t i = 0; i < num_txns_ / num_threads; i++) {
+        auto *txn = txn_manager.BeginTransaction();
+        txn_manager.Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+      }
+    };
+    common::WorkerPool thread_pool(num_threads, {});
+    uint64_t elapsed_ms;
+    {
+      common::ScopedTimer<std::chrono::milliseconds> timer(&elapsed_ms);
+      for (uint32_t j = 0; j < num_threads; j++) thread_pool.SubmitTask(workload);
+      thread_pool.WaitUntilAllFinished();
+    }
+    state.SetIterationTime(static_cast<double>(elapsed_ms) / 1000.0);
+    delete gc_thread;
+  }
+  state.SetItemsProcessed(state.iterations() * num_txns_);
+}
+
+BENCHMARK_REGISTER_F(TimestampManagerBenchmark, CheckOut)
+    ->Unit(benchmark::kMillisecond)
+    ->UseManualTime()
+    ->RangeMultiplier(2)
+    ->Ranges({{1, 64}, {0, 1}});
+
+BENCHMARK_REGISTER_F(TimestampManagerBenchmark, BeginCommit)
+    ->Unit(benchmark::kMillisecond)
+    ->UseManualTime()
+    ->RangeMultiplier(2)
+    ->Ranges({{1, 64}, {0, 1}});
+}  // namespace terrier
@@ -0,0 +1,107 @@
+// Perform using hash join, discarding probe tuples through the bloom filter of
+// the build side before probing:
+//
+// SELECT t1.col_a, t1'.col_a FROM test_1 AS t1, test_1 AS t1'
+// WHERE t1.col_a = t1'.col_a AND t1.col_a < 1000
+//
+// Should return 1000 (number of output rows)
+
+struct State {
+  table: JoinHashTable
+  filter: FilterManager
+  num_matches: int64
+}
+
+struct BuildRow {
+  key: Integer
+}
+
+fun probeKeyHash(vec: *ProjectedColumnsIterator) -> uint64 {
+  return @hash(@pciGetInt(vec, 0))
+}
+
+fun setUpState(execCtx: *ExecutionContext, state: *State) -> nil {
+  @joinHTInit(&state.table, @execCtxGetMem(execCtx), @sizeOf(BuildRow))
+  @filterManagerInit(&state.filter)
+  @filterManagerInsertJoinFilter(&state.filter, &state.table, probeKeyHash)
+  @filterManagerFinalize(&state.filter)
+  state.num_matches = 0
+}
+
+fun tearDownState(state: *State) -> nil {
+  @filterManagerFree(&state.filter)
+  @joinHTFree(&state.table)
+}
+
+fun checkKey(execCtx: *ExecutionContext, vec: *ProjectedColumnsIterator, tuple: *BuildRow) -> bool {
+  if (@pciGetInt(vec, 0) == tuple.key) {
+    return true
+  }
+  return false
+}
+
+fun pipeline_1(execCtx: *ExecutionContext, state: *State) -> nil {
+  var jht: *JoinHashTable = &state.table
+  var tvi: TableVectorIterator
+  var col_oids : [1]uint32
+  col_oids[0] = 1
+  @tableIterInitBind(&tvi, execCtx, "test_1", col_oids)
+  for (@tableIterAdvance(&tvi)) {
+    var vec = @tableIterGetPCI(&tvi)
+    for (; @pciHasNext(vec); @pciAdvance(vec)) {
+      if (@pciGetInt(vec, 0) < 1000) {
+        var elem : *BuildRow = @ptrCast(*BuildRow, @joinHTInsert(jht, @hash(@pciGetInt(vec, 0))))
+        elem.key = @pciGetInt(vec, 0)
+      }
+    }
+  }
+  @tableIterClose(&tvi)
+}
+
+fun pipeline_2(execCtx: *ExecutionContext, state: *State) -> nil {
+  var tvi: TableVectorIterator
+  var col_oids : [1]uint32
+  col_oids[0] = 1
+  @tableIterInitBind(&tvi, execCtx, "test_1", col_oids)
+  for (@tableIterAdvance(&tvi)) {
+    var vec = @tableIterGetPCI(&tvi)
+    // Join filter
+    @filtersRun(&state.filter, vec)
+    // Probe
+    for (; @pciHasNextFiltered(vec); @pciAdvanceFiltered(vec)) {
+      var hti: JoinHashTableIterator
+      for (@joinHTIterInit(&hti, &state.table, @hash(@pciGetInt(vec, 0))); @joinHTIterHasNext(&hti, checkKey, execCtx, vec); ) {
+        var build_row = @ptrCast(*BuildRow, @joinHTIterGetRow(&hti))
+        if (build_row.key == @pciGetInt(vec, 0)) {
+          state.num_matches = state.num_matches + 1
+        }
+      }
+      @joinHTIterClose(&hti)
+    }
+    @pciResetFiltered(vec)
+  }
+  @tableIterClose(&tvi)
+}
+
+fun main(execCtx: *ExecutionContext) -> int64 {
+  var state: State
+
+  // Initialize state
+  setUpState(execCtx, &state)
+
+  // Run pipeline 1
+  pipeline_1(execCtx, &state)
+
+  // Build table, and with it, the join filter
+  @joinHTBuild(&state.table)
+
+  // Run the second pipeline
+  pipeline_2(execCtx, &state)
+
+  var ret = state.num_matches
+
+  // Cleanup
+  tearDownState(&state)
+
+  return ret
+}
@@ -1,5 +1,8 @@
-// Perform parallel aggregation
-// This will be supported after the parallel scans are added
+// Perform parallel aggregation:
+//
+// SELECT col_b, count(col_a) FROM test_1 GROUP BY col_b
+//
+// Should output 10 (number of distinct col_b)
 
 struct State {
   table: AggregationHashTable
@@ -72,9 +75,9 @@ fun p1_worker(queryState: *State, state: *ThreadState_1, tvi: *TableVectorIterat
   var ht: *AggregationHashTable = &state.table
 
   for (@tableIterAdvance(tvi)) {
-    var vec = @tableIterGetVPI(tvi)
+    var vec = @tableIterGetPCI(tvi)
     iters[0] = vec
-    @aggHTProcessBatch(ht, &iters, hashFn, keyCheck, constructAgg, updateAgg)
+    @aggHTProcessBatch(ht, &iters, hashFn, keyCheck, constructAgg, updateAgg, true)
   }
   return
 }
@@ -130,7 +133,10 @@ fun main(execCtx: *ExecutionContext) -> int {
   @tlsReset(&tls, @sizeOf(ThreadState_1), p1_worker_initThreadState, p1_worker_tearDownThreadState, execCtx)
 
   // Parallel Scan
-  @iterateTableParallel("test_1", &state, &tls, p1_worker)
+  var col_oids : [2]uint32
+  col_oids[0] = 1
+  col_oids[1] = 2
+  @iterateTableParallel("test_1", col_oids, &state, execCtx, &tls, p1_worker)
 
   // ---- Pipeline 1 End ---- // 
 
@@ -1,5 +1,4 @@
 // Perform parallel join
-// This will be supported after the parallel scans are added
 
 struct State {
   jht: JoinHashTable
@@ -41,7 +40,7 @@ fun _1_Lt500(pci: *ProjectedColumnsIterator) -> int32 {
 }
 
 fun _1_Lt500_Vec(pci: *ProjectedColumnsIterator) -> int32 {
-  return @filterLt(pci, "colA", 500)
+  return @filterLt(pci, 0, 4, 500)
 }
 
 fun _1_pipelineWorker_InitThreadState(execCtx: *ExecutionContext, state: *ThreadState_1) -> nil {
@@ -88,7 +87,9 @@ fun main(execCtx: *ExecutionContext) -> int {
   @tlsReset(&tls, @sizeOf(ThreadState_1), _1_pipelineWorker_InitThreadState, _1_pipelineWorker_TearDownThreadState, execCtx)
 
   // Parallel scan
- @iterateTableParallel("test_1", &state, &tls, _1_pipelineWorker)
+  var col_oids : [1]uint32
+  col_oids[0] = 1
+  @iterateTableParallel("test_1", col_oids, &state, execCtx, &tls, _1_pipelineWorker)
 
   // ---- Pipeline 1 End ---- //
   var off: uint32 = 0
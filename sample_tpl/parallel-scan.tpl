@@ -1,12 +1,16 @@
-// Perform parallel scan
-// This is not yet supported with the current SQL table API.
+// Perform parallel scan:
+//
+// SELECT count(*) FROM test_1 WHERE colA < 500
+//
+// Should output 500
 
 struct State {
+  count: int32
 }
 
-
 struct ThreadState_1 {
   filter: FilterManager
+  count: int32
 }
 
 fun _1_Lt500(pci: *ProjectedColumnsIterator) -> int32 {
@@ -28,13 +32,14 @@ fun _1_Lt500(pci: *ProjectedColumnsIterator) -> int32 {
 }
 
 fun _1_Lt500_Vec(pci: *ProjectedColumnsIterator) -> int32 {
-  return @filterLt(pci, "colA", 500)
+  return @filterLt(pci, 0, 4, 500)
 }
 
 fun _1_pipelineWorker_InitThreadState(execCtx: *ExecutionContext, state: *ThreadState_1) -> nil {
   @filterManagerInit(&state.filter)
   @filterManagerInsertFilter(&state.filter, _1_Lt500, _1_Lt500_Vec)
   @filterManagerFinalize(&state.filter)
+  state.count = 0
 }
 
 fun _1_pipelineWorker_TearDownThreadState(execCtx: *ExecutionContext, state: *ThreadState_1) -> nil {
@@ -46,11 +51,21 @@ fun _1_pipelineWorker(query_state: *State, state: *ThreadState_1, tvi: *TableVec
   for (@tableIterAdvance(tvi)) {
     var pci = @tableIterGetPCI(tvi)
     @filtersRun(filter, pci)
+    for (; @pciHasNextFiltered(pci); @pciAdvanceFiltered(pci)) {
+      state.count = state.count + 1
+    }
   }
   return
 }
 
+fun _1_pipelineWorker_Finalize(query_state: *State, state: *ThreadState_1) -> nil {
+  query_state.count = query_state.count + state.count
+}
+
 fun main(execCtx: *ExecutionContext) -> int {
+  var state: State
+  state.count = 0
+
   // Pipeline 1 - parallel scan table
 
   // First the thread state container
@@ -59,12 +74,14 @@ fun main(execCtx: *ExecutionContext) -> int {
   @tlsReset(&tls, @sizeOf(ThreadState_1), _1_pipelineWorker_InitThreadState, _1_pipelineWorker_TearDownThreadState, execCtx)
 
   // Now scan
-  @iterateTableParallel("test_1", &state, &tls, _1_pipelineWorker)
+  var col_oids : [1]uint32
+  col_oids[0] = 1
+  @iterateTableParallel("test_1", col_oids, &state, execCtx, &tls, _1_pipelineWorker)
 
-  // Pipeline 2
+  @tlsIterate(&tls, &state, _1_pipelineWorker_Finalize)
 
   // Cleanup
   @tlsFree(&tls)
 
-  return 0
+  return state.count
 }
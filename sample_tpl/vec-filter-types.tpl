@@ -0,0 +1,145 @@
+// Perform (in vectorized fashion) filters on the DECIMAL, VARCHAR and NULLable columns of test_3. colB holds 0 to
+// 999, colC the same numbers as strings, and colD random digits, some of them NULL.
+//
+// SELECT colB FROM test_3 WHERE colB >= 100 AND colB < 499.5     (400 rows)
+// SELECT colC FROM test_3 WHERE colC = '42'                      (1 row)
+// SELECT colC FROM test_3 WHERE colC > '9'                       (110 rows)
+// SELECT colC FROM test_3 WHERE colC LIKE '1%'                   (111 rows)
+// SELECT colC FROM test_3 WHERE colC LIKE '%5'                   (100 rows)
+// SELECT colD FROM test_3 WHERE colD IS NULL                     (some rows)
+// SELECT colD FROM test_3 WHERE colD IS NOT NULL                 (the other rows)
+// SELECT colD FROM test_3 WHERE colD < 10                        (the rows that are not NULL)
+//
+// Should return 1722 (the number of rows of the first five queries, plus the number of rows of the table)
+
+fun decimalFilter(execCtx: *ExecutionContext) -> int64 {
+  var ret = 0
+  var tvi: TableVectorIterator
+  var oids: [1]uint32
+  oids[0] = 2 // colB
+  @tableIterInitBind(&tvi, execCtx, "test_3", oids)
+  for (@tableIterAdvance(&tvi)) {
+    var pci = @tableIterGetPCI(&tvi)
+    @filterGe(pci, 0, 6, 100)
+    ret = ret + @filterLt(pci, 0, 6, 499.5)
+    @pciReset(pci)
+  }
+  @tableIterClose(&tvi)
+  return ret
+}
+
+fun stringEqualFilter(execCtx: *ExecutionContext) -> int64 {
+  var ret = 0
+  var tvi: TableVectorIterator
+  var oids: [1]uint32
+  oids[0] = 3 // colC
+  @tableIterInitBind(&tvi, execCtx, "test_3", oids)
+  for (@tableIterAdvance(&tvi)) {
+    var pci = @tableIterGetPCI(&tvi)
+    ret = ret + @filterEq(pci, 0, 9, "42")
+    @pciReset(pci)
+  }
+  @tableIterClose(&tvi)
+  return ret
+}
+
+fun stringGreaterFilter(execCtx: *ExecutionContext) -> int64 {
+  var ret = 0
+  var tvi: TableVectorIterator
+  var oids: [1]uint32
+  oids[0] = 3 // colC
+  @tableIterInitBind(&tvi, execCtx, "test_3", oids)
+  for (@tableIterAdvance(&tvi)) {
+    var pci = @tableIterGetPCI(&tvi)
+    ret = ret + @filterGt(pci, 0, 9, "9")
+    @pciReset(pci)
+  }
+  @tableIterClose(&tvi)
+  return ret
+}
+
+fun prefixFilter(execCtx: *ExecutionContext) -> int64 {
+  var ret = 0
+  var tvi: TableVectorIterator
+  var oids: [1]uint32
+  oids[0] = 3 // colC
+  @tableIterInitBind(&tvi, execCtx, "test_3", oids)
+  for (@tableIterAdvance(&tvi)) {
+    var pci = @tableIterGetPCI(&tvi)
+    ret = ret + @filterPrefix(pci, 0, "1")
+    @pciReset(pci)
+  }
+  @tableIterClose(&tvi)
+  return ret
+}
+
+fun likeFilter(execCtx: *ExecutionContext) -> int64 {
+  var ret = 0
+  var tvi: TableVectorIterator
+  var oids: [1]uint32
+  oids[0] = 3 // colC
+  @tableIterInitBind(&tvi, execCtx, "test_3", oids)
+  for (@tableIterAdvance(&tvi)) {
+    var pci = @tableIterGetPCI(&tvi)
+    ret = ret + @filterLike(pci, 0, "%5")
+    @pciReset(pci)
+  }
+  @tableIterClose(&tvi)
+  return ret
+}
+
+fun nullFilter(execCtx: *ExecutionContext) -> int64 {
+  var ret = 0
+  var tvi: TableVectorIterator
+  var oids: [1]uint32
+  oids[0] = 4 // colD
+  @tableIterInitBind(&tvi, execCtx, "test_3", oids)
+  for (@tableIterAdvance(&tvi)) {
+    var pci = @tableIterGetPCI(&tvi)
+    ret = ret + @filterNull(pci, 0)
+    @pciReset(pci)
+  }
+  @tableIterClose(&tvi)
+  return ret
+}
+
+fun notNullFilter(execCtx: *ExecutionContext) -> int64 {
+  var ret = 0
+  var tvi: TableVectorIterator
+  var oids: [1]uint32
+  oids[0] = 4 // colD
+  @tableIterInitBind(&tvi, execCtx, "test_3", oids)
+  for (@tableIterAdvance(&tvi)) {
+    var pci = @tableIterGetPCI(&tvi)
+    ret = ret + @filterNotNull(pci, 0)
+    @pciReset(pci)
+  }
+  @tableIterClose(&tvi)
+  return ret
+}
+
+fun nullableFilter(execCtx: *ExecutionContext) -> int64 {
+  var ret = 0
+  var tvi: TableVectorIterator
+  var oids: [1]uint32
+  oids[0] = 4 // colD
+  @tableIterInitBind(&tvi, execCtx, "test_3", oids)
+  for (@tableIterAdvance(&tvi)) {
+    var pci = @tableIterGetPCI(&tvi)
+    ret = ret + @filterLt(pci, 0, 4, 10, true)
+    @pciReset(pci)
+  }
+  @tableIterClose(&tvi)
+  return ret
+}
+
+fun main(execCtx: *ExecutionContext) -> int64 {
+  var num_null = nullFilter(execCtx)
+  var num_not_null = notNullFilter(execCtx)
+  if (num_null == 0 or num_not_null == 0 or nullableFilter(execCtx) != num_not_null) {
+    return -1
+  }
+  var ret = decimalFilter(execCtx) + stringEqualFilter(execCtx) + stringGreaterFilter(execCtx)
+  ret = ret + prefixFilter(execCtx) + likeFilter(execCtx)
+  return ret + num_null + num_not_null
+}
@@ -1,8 +1,11 @@
 #include "execution/sema/sema.h"
 
+#include <utility>
+
 #include "execution/ast/ast_node_factory.h"
 #include "execution/ast/context.h"
 #include "execution/ast/type.h"
+#include "type/type_id.h"
 
 namespace terrier::execution::sema {
 
@@ -120,9 +123,17 @@ void Sema::CheckBuiltinSqlConversionCall(ast::CallExpr *call, ast::Builtin built
   }
 }
 
-void Sema::CheckBuiltinFilterCall(ast::CallExpr *call) {
-  if (!CheckArgCount(call, 4)) {
-    return;
+void Sema::CheckBuiltinFilterCall(ast::CallExpr *call, ast::Builtin builtin) {
+  // @filterNull and @filterNotNull take the iterator and the column index. @filterPrefix and @filterLike also take
+  // a string literal, and the comparison filters a column type and a constant. All but the NULL filters take an
+  // optional boolean literal telling whether the column is NULLable.
+  const bool null_filter = builtin == ast::Builtin::FilterNull || builtin == ast::Builtin::FilterNotNull;
+  const bool pattern_filter = builtin == ast::Builtin::FilterPrefix || builtin == ast::Builtin::FilterLike;
+  const uint32_t num_args = null_filter ? 2 : pattern_filter ? 3 : 4;
+  if (null_filter || call->NumArgs() != num_args + 1) {
+    if (!CheckArgCount(call, num_args)) {
+      return;
+    }
   }
 
   const auto &args = call->Arguments();
@@ -141,11 +152,47 @@ void Sema::CheckBuiltinFilterCall(ast::CallExpr *call) {
     return;
   }
 
-  // The third call argument must be an type represented by an integer.
-  // TODO(Amadou): This is subject to change. Ideally, there should be a builtin for every type like for PCIGet.
-  if (!args[2]->IsIntegerLiteral()) {
-    ReportIncorrectCallArg(call, 2, GetBuiltinType(int32_kind));
-    return;
+  if (pattern_filter) {
+    // The third call argument is the prefix or pattern
+    if (!args[2]->IsStringLiteral()) {
+      ReportIncorrectCallArg(call, 2, ast::StringType::Get(GetContext()));
+      return;
+    }
+  } else if (!null_filter) {
+    // The third call argument must be an type represented by an integer.
+    // TODO(Amadou): This is subject to change. Ideally, there should be a builtin for every type like for PCIGet.
+    if (!args[2]->IsIntegerLiteral()) {
+      ReportIncorrectCallArg(call, 2, GetBuiltinType(int32_kind));
+      return;
+    }
+
+    // The fourth call argument is the constant. DECIMAL columns are compared to floating-point literals, VARCHAR
+    // columns to string literals, and the others to integer literals.
+    const auto col_type = static_cast<type::TypeId>(args[2]->As<ast::LitExpr>()->Int64Val());
+    auto *val = args[3]->SafeAs<ast::LitExpr>();
+    if (col_type == type::TypeId::DECIMAL) {
+      if (val == nullptr || (!val->IsIntLitExpr() && !val->IsFloatLitExpr())) {
+        ReportIncorrectCallArg(call, 3, GetBuiltinType(ast::BuiltinType::Float64));
+        return;
+      }
+    } else if (col_type == type::TypeId::VARCHAR) {
+      if (val == nullptr || !val->IsStringLitExpr()) {
+        ReportIncorrectCallArg(call, 3, ast::StringType::Get(GetContext()));
+        return;
+      }
+    } else if (val == nullptr || !val->IsIntLitExpr()) {
+      ReportIncorrectCallArg(call, 3, GetBuiltinType(ast::BuiltinType::Int64));
+      return;
+    }
+  }
+
+  // The optional last call argument tells whether the column is NULLable
+  if (call->NumArgs() == num_args + 1) {
+    auto *nullable = args[num_args]->SafeAs<ast::LitExpr>();
+    if (nullable == nullptr || !nullable->IsBoolLitExpr()) {
+      ReportIncorrectCallArg(call, num_args, GetBuiltinType(ast::BuiltinType::Bool));
+      return;
+    }
   }
 
   // Set return type
@@ -916,7 +963,7 @@ void Sema::CheckBuiltinTableIterCall(ast::CallExpr *call, ast::Builtin builtin)
 }
 
 void Sema::CheckBuiltinTableIterParCall(ast::CallExpr *call) {
-  if (!CheckArgCount(call, 4)) {
+  if (!CheckArgCount(call, 6)) {
     return;
   }
 
@@ -928,24 +975,42 @@ void Sema::CheckBuiltinTableIterParCall(ast::CallExpr *call) {
     return;
   }
 
-  // Second argument is an opaque query state. For now, check it's a pointer.
+  // Second argument is a uint32_t array of column oids
+  if (!call_args[1]->GetType()->IsArrayType()) {
+    ReportIncorrectCallArg(call, 1, "Second argument should be a uint32 array");
+    return;
+  }
+  auto *arr_type = call_args[1]->GetType()->SafeAs<ast::ArrayType>();
+  if (!arr_type->ElementType()->IsSpecificBuiltin(ast::BuiltinType::Uint32)) {
+    ReportIncorrectCallArg(call, 1, "Second argument should be a uint32 array");
+    return;
+  }
+
+  // Third argument is an opaque query state. For now, check it's a pointer.
   const auto void_kind = ast::BuiltinType::Nil;
-  if (!call_args[1]->GetType()->IsPointerType()) {
-    ReportIncorrectCallArg(call, 1, GetBuiltinType(void_kind)->PointerTo());
+  if (!call_args[2]->GetType()->IsPointerType()) {
+    ReportIncorrectCallArg(call, 2, GetBuiltinType(void_kind)->PointerTo());
+    return;
+  }
+
+  // Fourth argument is the execution context
+  const auto exec_ctx_kind = ast::BuiltinType::ExecutionContext;
+  if (!IsPointerToSpecificBuiltin(call_args[3]->GetType(), exec_ctx_kind)) {
+    ReportIncorrectCallArg(call, 3, GetBuiltinType(exec_ctx_kind)->PointerTo());
     return;
   }
 
-  // Third argument is the thread state container
+  // Fifth argument is the thread state container
   const auto tls_kind = ast::BuiltinType::ThreadStateContainer;
-  if (!IsPointerToSpecificBuiltin(call_args[2]->GetType(), tls_kind)) {
-    ReportIncorrectCallArg(call, 2, GetBuiltinType(tls_kind)->PointerTo());
+  if (!IsPointerToSpecificBuiltin(call_args[4]->GetType(), tls_kind)) {
+    ReportIncorrectCallArg(call, 4, GetBuiltinType(tls_kind)->PointerTo());
     return;
   }
 
-  // Third argument is scanner function
-  auto *scan_fn_type = call_args[3]->GetType()->SafeAs<ast::FunctionType>();
+  // Sixth argument is scanner function
+  auto *scan_fn_type = call_args[5]->GetType()->SafeAs<ast::FunctionType>();
   if (scan_fn_type == nullptr) {
-    GetErrorReporter()->Report(call->Position(), ErrorMessages::kBadParallelScanFunction, call_args[3]->GetType());
+    GetErrorReporter()->Report(call->Position(), ErrorMessages::kBadParallelScanFunction, call_args[5]->GetType());
     return;
   }
   // Check type
@@ -953,7 +1018,7 @@ void Sema::CheckBuiltinTableIterParCall(ast::CallExpr *call) {
   const auto &params = scan_fn_type->Params();
   if (params.size() != 3 || !params[0].type_->IsPointerType() || !params[1].type_->IsPointerType() ||
       !IsPointerToSpecificBuiltin(params[2].type_, tvi_kind)) {
-    GetErrorReporter()->Report(call->Position(), ErrorMessages::kBadParallelScanFunction, call_args[3]->GetType());
+    GetErrorReporter()->Report(call->Position(), ErrorMessages::kBadParallelScanFunction, call_args[5]->GetType());
     return;
   }
 
@@ -1095,6 +1160,36 @@ void Sema::CheckBuiltinFilterManagerCall(ast::CallExpr *const call, const ast::B
       call->SetType(GetBuiltinType(ast::BuiltinType::Nil));
       break;
     }
+    case ast::Builtin::FilterManagerInsertJoinFilter: {
+      if (!CheckArgCount(call, 3)) {
+        return;
+      }
+      // The second argument is the join hash table whose bloom filter to probe
+      const auto jht_kind = ast::BuiltinType::JoinHashTable;
+      if (!IsPointerToSpecificBuiltin(call->Arguments()[1]->GetType(), jht_kind)) {
+        ReportIncorrectCallArg(call, 1, GetBuiltinType(jht_kind)->PointerTo());
+        return;
+      }
+      // The third argument is a (*ProjectedColumnsIterator)->uint64 function hashing the probe key
+      // clang-format off
+      auto *hash_fn_type = call->Arguments()[2]->GetType()->SafeAs<ast::FunctionType>();
+      if (hash_fn_type == nullptr ||                                                       // not a function
+          !hash_fn_type->ReturnType()->IsSpecificBuiltin(ast::BuiltinType::Uint64) ||      // doesn't return a hash
+          hash_fn_type->NumParams() != 1 ||                                                // isn't a single-arg func
+          hash_fn_type->Params()[0].type_->GetPointeeType() == nullptr ||                  // first arg isn't a *PCI
+          !hash_fn_type->Params()[0].type_->GetPointeeType()->IsSpecificBuiltin(
+              ast::BuiltinType::ProjectedColumnsIterator)) {
+        util::RegionVector<ast::Field> params(GetContext()->Region());
+        params.emplace_back(GetContext()->GetIdentifier("pci"),
+                            GetBuiltinType(ast::BuiltinType::ProjectedColumnsIterator)->PointerTo());
+        ReportIncorrectCallArg(call, 2, ast::FunctionType::Get(std::move(params),
+                                                               GetBuiltinType(ast::BuiltinType::Uint64)));
+        return;
+      }
+      // clang-format on
+      call->SetType(GetBuiltinType(ast::BuiltinType::Nil));
+      break;
+    }
     case ast::Builtin::FilterManagerRunFilters: {
       const auto pci_kind = ast::BuiltinType::ProjectedColumnsIterator;
       if (!IsPointerToSpecificBuiltin(call->Arguments()[1]->GetType(), pci_kind)) {
@@ -1658,8 +1753,12 @@ void Sema::CheckBuiltinCall(ast::CallExpr *call) {
     case ast::Builtin::FilterGt:
     case ast::Builtin::FilterLt:
     case ast::Builtin::FilterNe:
-    case ast::Builtin::FilterLe: {
-      CheckBuiltinFilterCall(call);
+    case ast::Builtin::FilterLe:
+    case ast::Builtin::FilterPrefix:
+    case ast::Builtin::FilterLike:
+    case ast::Builtin::FilterNull:
+    case ast::Builtin::FilterNotNull: {
+      CheckBuiltinFilterCall(call, builtin);
       break;
     }
     case ast::Builtin::ExecutionContextGetMemoryPool: {
@@ -1718,6 +1817,7 @@ void Sema::CheckBuiltinCall(ast::CallExpr *call) {
     }
     case ast::Builtin::FilterManagerInit:
     case ast::Builtin::FilterManagerInsertFilter:
+    case ast::Builtin::FilterManagerInsertJoinFilter:
     case ast::Builtin::FilterManagerFinalize:
     case ast::Builtin::FilterManagerRunFilters:
     case ast::Builtin::FilterManagerFree: {
@@ -1833,11 +1933,14 @@ void Sema::CheckBuiltinCall(ast::CallExpr *call) {
       CheckBuiltinIndexIteratorInit(call, builtin);
       break;
     }
-    case ast::Builtin::IndexIteratorScanKey: {
+    case ast::Builtin::IndexIteratorScanKey:
+    case ast::Builtin::IndexIteratorAddBatchKey:
+    case ast::Builtin::IndexIteratorScanKeyBatch: {
       CheckBuiltinIndexIteratorScanKey(call);
       break;
     }
-    case ast::Builtin::IndexIteratorAdvance: {
+    case ast::Builtin::IndexIteratorAdvance:
+    case ast::Builtin::IndexIteratorNextBatchKey: {
       CheckBuiltinIndexIteratorAdvance(call);
       break;
     }
@@ -16,11 +16,17 @@ BloomFilter::BloomFilter(MemoryPool *memory)
 BloomFilter::BloomFilter(MemoryPool *memory, uint32_t num_elems) : BloomFilter() { Init(memory, num_elems); }
 
 BloomFilter::~BloomFilter() {
-  const auto num_bytes = GetNumBlocks() * sizeof(Block);
-  memory_->Deallocate(blocks_, num_bytes);
+  if (blocks_ != nullptr) {
+    memory_->Deallocate(blocks_, GetSizeInBytes());
+  }
 }
 
 void BloomFilter::Init(MemoryPool *memory, uint32_t num_elems) {
+  // Release the blocks of an earlier initialization
+  if (blocks_ != nullptr) {
+    memory_->Deallocate(blocks_, GetSizeInBytes());
+  }
+
   memory_ = memory;
   lazily_added_hashes_ = MemPoolVector<hash_t>(memory_);
 
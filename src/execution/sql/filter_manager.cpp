@@ -8,6 +8,7 @@
 #include "execution/bandit/agent.h"
 #include "execution/bandit/multi_armed_bandit.h"
 #include "execution/bandit/policy.h"
+#include "execution/sql/bloom_filter.h"
 #include "execution/sql/projected_columns_iterator.h"
 #include "execution/util/timer.h"
 #include "loggers/execution_logger.h"
@@ -54,9 +55,19 @@ void FilterManager::StartNewClause() {
 void FilterManager::InsertClauseFlavor(const FilterManager::MatchFn flavor) {
   TERRIER_ASSERT(!finalized_, "Cannot modify filter manager after finalization");
   TERRIER_ASSERT(!clauses_.empty(), "Inserting flavor without clause");
+  TERRIER_ASSERT(!clauses_.back().IsJoinFilter(), "Join filter clauses have fixed flavors");
   clauses_.back().flavors_.push_back(flavor);
 }
 
+void FilterManager::InsertJoinFilterClause(const BloomFilter *const bloom_filter, const FilterManager::HashFn hash_fn) {
+  TERRIER_ASSERT(!finalized_, "Cannot modify filter manager after finalization");
+  TERRIER_ASSERT(bloom_filter != nullptr && hash_fn != nullptr, "Join filter needs a bloom filter and a hash function");
+  join_filter_clauses_.push_back(static_cast<uint32_t>(clauses_.size()));
+  clauses_.emplace_back();
+  clauses_.back().bloom_filter_ = bloom_filter;
+  clauses_.back().hash_fn_ = hash_fn;
+}
+
 void FilterManager::Finalize() {
   if (finalized_) {
     return;
@@ -78,6 +89,13 @@ void FilterManager::Finalize() {
 void FilterManager::RunFilters(ProjectedColumnsIterator *const pci) {
   TERRIER_ASSERT(finalized_, "Must finalize the filter before it can be used");
 
+  // The previous vector is done with once the next one arrives
+  if (vector_in_flight_) {
+    ObserveJoinFilters();
+  }
+  vector_timer_.Start();
+  vector_in_flight_ = !join_filter_clauses_.empty();
+
   // Execute the clauses in what we currently believe to be the optimal order
   for (const uint32_t opt_clause_idx : optimal_clause_order_) {
     RunFilterClause(pci, opt_clause_idx);
@@ -85,6 +103,11 @@ void FilterManager::RunFilters(ProjectedColumnsIterator *const pci) {
 }
 
 void FilterManager::RunFilterClause(ProjectedColumnsIterator *const pci, const uint32_t clause_index) {
+  if (ClauseAt(clause_index)->IsJoinFilter()) {
+    RunJoinFilterClause(pci, clause_index);
+    return;
+  }
+
   //
   // This function will execute the clause at the given clause index. But, we'll
   // be smart about it. We'll use our multi-armed bandit agent to predict the
@@ -123,11 +146,49 @@ std::pair<uint32_t, double> FilterManager::RunFilterClauseImpl(ProjectedColumnsI
   return std::make_pair(num_selected, timer.Elapsed());
 }
 
+void FilterManager::RunJoinFilterClause(ProjectedColumnsIterator *const pci, const uint32_t clause_index) {
+  //
+  // A join filter pays off when the time it takes is less than the time saved
+  // by not hashing, probing and processing the tuples it discards later in the
+  // pipeline. Timing the filter alone would always favor skipping it. Thus, the
+  // agent only chooses the flavor here, and is rewarded with the time to
+  // process the whole vector once the next vector arrives.
+  //
+
+  const uint32_t flavor_idx = GetAgentFor(clause_index)->NextAction();
+  if (flavor_idx == K_SKIP_JOIN_FILTER) {
+    // Callers iterate over the filtered tuples after running the filters, so
+    // select all tuples if no other clause did
+    if (!pci->IsFiltered()) {
+      pci->RunFilter([]() { return true; });
+    }
+    return;
+  }
+
+  const Clause *clause = ClauseAt(clause_index);
+  const BloomFilter *bloom_filter = clause->bloom_filter_;
+  const HashFn hash_fn = clause->hash_fn_;
+  pci->RunFilter([=]() { return bloom_filter->Contains(hash_fn(pci)); });
+}
+
+void FilterManager::ObserveJoinFilters() {
+  vector_timer_.Stop();
+  const double reward = bandit::MultiArmedBandit::ExecutionTimeToReward(vector_timer_.Elapsed());
+  for (const uint32_t clause_idx : join_filter_clauses_) {
+    GetAgentFor(clause_idx)->Observe(reward);
+    EXECUTION_LOG_DEBUG("Join filter clause {} observed reward {}", clause_idx, reward);
+  }
+}
+
 uint32_t FilterManager::GetOptimalFlavorForClause(const uint32_t clause_index) const {
   const bandit::Agent *agent = GetAgentFor(clause_index);
   return agent->GetCurrentOptimalAction();
 }
 
+const std::vector<uint32_t> &FilterManager::GetFlavorAttemptsForClause(const uint32_t clause_index) const {
+  return GetAgentFor(clause_index)->ActionAttempts();
+}
+
 bandit::Agent *FilterManager::GetAgentFor(const uint32_t clause_index) { return &agents_[clause_index]; }
 
 const bandit::Agent *FilterManager::GetAgentFor(const uint32_t clause_index) const { return &agents_[clause_index]; }
@@ -1,4 +1,6 @@
 #include "execution/sql/index_iterator.h"
+#include <cstring>
+#include "common/constants.h"
 #include "execution/sql/value.h"
 
 namespace terrier::execution::sql {
@@ -29,10 +31,39 @@ void IndexIterator::ScanKey() {
   tuples_.clear();
   curr_index_ = 0;
   index_->ScanKey(*exec_ctx_->GetTxn(), *index_pr_, &tuples_);
+  curr_end_ = static_cast<uint32_t>(tuples_.size());
+}
+
+void IndexIterator::AddBatchKey() {
+  TERRIER_ASSERT(key_batch_.size() < common::Constants::K_DEFAULT_VECTOR_SIZE, "Key batch is full.");
+  const uint32_t key_size = index_pr_->Size();
+  if (key_batch_buffer_ == nullptr) {
+    key_batch_buffer_ = exec_ctx_->GetMemoryPool()->AllocateAligned(
+        key_size * common::Constants::K_DEFAULT_VECTOR_SIZE, alignof(uint64_t), false);
+  }
+  // The size of a ProjectedRow is padded to 8 bytes, so the copies stay aligned
+  auto *const key = reinterpret_cast<byte *>(key_batch_buffer_) + key_size * key_batch_.size();
+  std::memcpy(key, index_pr_, key_size);
+  key_batch_.push_back(reinterpret_cast<const storage::ProjectedRow *>(key));
+}
+
+void IndexIterator::ScanKeyBatch() {
+  tuples_.clear();
+  key_ends_.clear();
+  curr_index_ = curr_end_ = curr_key_ = 0;
+  index_->ScanKeyBatch(*exec_ctx_->GetTxn(), key_batch_, &tuples_, &key_ends_);
+  key_batch_.clear();
+}
+
+bool IndexIterator::NextBatchKey() {
+  if (curr_key_ == key_ends_.size()) return false;
+  curr_index_ = curr_end_;
+  curr_end_ = key_ends_[curr_key_++];
+  return true;
 }
 
 bool IndexIterator::Advance() {
-  if (curr_index_ < tuples_.size()) {
+  if (curr_index_ < curr_end_) {
     table_->Select(exec_ctx_->GetTxn(), tuples_[curr_index_], table_pr_);
     ++curr_index_;
     return true;
@@ -43,6 +74,10 @@ bool IndexIterator::Advance() {
 IndexIterator::~IndexIterator() {
   // Free allocated buffers
   exec_ctx_->GetMemoryPool()->Deallocate(table_buffer_, table_pr_->Size());
+  if (key_batch_buffer_ != nullptr) {
+    exec_ctx_->GetMemoryPool()->Deallocate(key_batch_buffer_,
+                                           index_pr_->Size() * common::Constants::K_DEFAULT_VECTOR_SIZE);
+  }
   exec_ctx_->GetMemoryPool()->Deallocate(index_buffer_, index_pr_->Size());
 }
 }  // namespace terrier::execution::sql
@@ -19,9 +19,12 @@
 namespace terrier::execution::sql {
 
 JoinHashTable::JoinHashTable(MemoryPool *memory, uint32_t tuple_size, bool use_concise_ht)
-    : entries_(sizeof(HashTableEntry) + tuple_size, MemoryPoolAllocator<byte>(memory)),
+    : memory_(memory),
+      entries_(sizeof(HashTableEntry) + tuple_size, MemoryPoolAllocator<byte>(memory)),
       owned_(memory),
       concise_hash_table_(0),
+      bloom_filter_requested_(false),
+      merged_(false),
       hll_estimator_(libcount::HLL::Create(K_DEFAULT_HLL_PRECISION)),
       built_(false),
       use_concise_ht_(use_concise_ht) {}
@@ -570,6 +573,36 @@ void JoinHashTable::BuildConciseHashTable() {
   }
 }
 
+const BloomFilter *JoinHashTable::RequestBloomFilter() {
+  if (!bloom_filter_requested_) {
+    bloom_filter_requested_ = true;
+    if (IsBuilt() || merged_) {
+      BuildBloomFilter();
+    }
+  }
+  return &bloom_filter_;
+}
+
+void JoinHashTable::BuildBloomFilter() {
+  uint64_t num_elems = NumElements();
+  for (const auto &owned_entries : owned_) {
+    num_elems += owned_entries.size();
+  }
+
+  // Size the filter for at least one element so that an empty filter rejects
+  // all probes, as an empty build side does
+  bloom_filter_.Init(memory_, static_cast<uint32_t>(std::max(num_elems, uint64_t{1})));
+
+  for (uint64_t idx = 0; idx < NumElements(); idx++) {
+    bloom_filter_.Add(EntryAt(idx)->hash_);
+  }
+  for (const auto &owned_entries : owned_) {
+    for (uint64_t idx = 0; idx < owned_entries.size(); idx++) {
+      bloom_filter_.Add(reinterpret_cast<const HashTableEntry *>(owned_entries[idx])->hash_);
+    }
+  }
+}
+
 void JoinHashTable::Build() {
   if (IsBuilt()) {
     return;
@@ -587,6 +620,10 @@ void JoinHashTable::Build() {
     BuildGenericHashTable();
   }
 
+  if (bloom_filter_requested_) {
+    BuildBloomFilter();
+  }
+
   timer.Stop();
   UNUSED_ATTRIBUTE double tps = (static_cast<double>(NumElements()) / timer.Elapsed()) / 1000.0;
   EXECUTION_LOG_DEBUG("JHT: built {} tuples in {} ms ({:.2f} tps)", NumElements(), timer.Elapsed(), tps);
@@ -721,6 +758,11 @@ void JoinHashTable::MergeParallel(const ThreadStateContainer *thread_state_conta
       MergeIncomplete<false, true>(source);
     }
   });
+
+  merged_ = true;
+  if (bloom_filter_requested_) {
+    BuildBloomFilter();
+  }
 }
 
 }  // namespace terrier::execution::sql
@@ -23,18 +23,13 @@ void ProjectedColumnsIterator::SetProjectedColumn(storage::ProjectedColumns *pro
   selection_vector_write_idx_ = 0;
 }
 
-template <typename T, template <typename> typename Op>
-uint32_t ProjectedColumnsIterator::FilterColByColImpl(const uint32_t col_idx_1, const uint32_t col_idx_2) {
-  // Get the input column's data
-  const auto *input_1 = reinterpret_cast<const T *>(projected_column_->ColumnStart(static_cast<uint16_t>(col_idx_1)));
-  const auto *input_2 = reinterpret_cast<const T *>(projected_column_->ColumnStart(static_cast<uint16_t>(col_idx_2)));
-
+template <typename F>
+uint32_t ProjectedColumnsIterator::RunVectorFilter(const F &filter) {
   // Use the existing selection vector if this PCI has been filtered
   const uint32_t *sel_vec = (IsFiltered() ? selection_vector_ : nullptr);
 
   // Filter!
-  selection_vector_write_idx_ =
-      util::VectorUtil::FilterVectorByVector<T, Op>(input_1, input_2, num_selected_, selection_vector_, sel_vec);
+  selection_vector_write_idx_ = filter(sel_vec);
 
   // After the filter has been run on the entire vector projection, we need to
   // ensure that we reset it so that clients can query the updated state of the
@@ -47,34 +42,43 @@ uint32_t ProjectedColumnsIterator::FilterColByColImpl(const uint32_t col_idx_1,
   return NumSelected();
 }
 
+template <typename T, template <typename> typename Op>
+uint32_t ProjectedColumnsIterator::FilterColByColImpl(const uint32_t col_idx_1, const uint32_t col_idx_2) {
+  // Get the input column's data
+  const auto *input_1 = reinterpret_cast<const T *>(projected_column_->ColumnStart(static_cast<uint16_t>(col_idx_1)));
+  const auto *input_2 = reinterpret_cast<const T *>(projected_column_->ColumnStart(static_cast<uint16_t>(col_idx_2)));
+
+  return RunVectorFilter([&](const uint32_t *sel_vec) {
+    if constexpr (std::is_same_v<T, storage::VarlenEntry>) {
+      return util::VectorUtil::FilterStringByVector<Op>(input_1, input_2, num_selected_, selection_vector_, sel_vec);
+    } else {  // NOLINT
+      return util::VectorUtil::FilterVectorByVector<T, Op>(input_1, input_2, num_selected_, selection_vector_,
+                                                          sel_vec);
+    }
+  });
+}
+
 // Filter an entire column's data by the provided constant value
 template <typename T, template <typename> typename Op>
 uint32_t ProjectedColumnsIterator::FilterColByValImpl(uint32_t col_idx, T val) {
   // Get the input column's data
   const auto *input = reinterpret_cast<const T *>(projected_column_->ColumnStart(static_cast<uint16_t>(col_idx)));
 
-  // Use the existing selection vector if this PCI has been filtered
-  const uint32_t *sel_vec = (IsFiltered() ? selection_vector_ : nullptr);
-
-  // Filter!
-  selection_vector_write_idx_ =
-      util::VectorUtil::FilterVectorByVal<T, Op>(input, num_selected_, val, selection_vector_, sel_vec);
-
-  // After the filter has been run on the entire vector projection, we need to
-  // ensure that we reset it so that clients can query the updated state of the
-  // PCI, and subsequent filters operate only on valid tuples potentially
-  // filtered out in this filter.
-  ResetFiltered();
-
-  // After the call to ResetFiltered(), num_selected_ should indicate the number
-  // of valid tuples in the filter.
-  return NumSelected();
+  return RunVectorFilter([&](const uint32_t *sel_vec) {
+    return util::VectorUtil::FilterVectorByVal<T, Op>(input, num_selected_, val, selection_vector_, sel_vec);
+  });
 }
 
 // Filter an entire column's data by the provided constant value
-template <template <typename> typename Op>
+template <template <typename> typename Op, bool Nullable>
 uint32_t ProjectedColumnsIterator::FilterColByVal(uint32_t col_idx, type::TypeId type, FilterVal val) {
+  // NOLINTNEXTLINE: bugprone-suspicious-semicolon: seems like a false positive because of constexpr
+  if constexpr (Nullable) FilterColNotNull(col_idx);
+
   switch (type) {
+    case type::TypeId::TINYINT: {
+      return FilterColByValImpl<int8_t, Op>(col_idx, val.ti_);
+    }
     case type::TypeId::SMALLINT: {
       return FilterColByValImpl<int16_t, Op>(col_idx, val.si_);
     }
@@ -84,18 +88,36 @@ uint32_t ProjectedColumnsIterator::FilterColByVal(uint32_t col_idx, type::TypeId
     case type::TypeId::BIGINT: {
       return FilterColByValImpl<int64_t, Op>(col_idx, val.bi_);
     }
+    case type::TypeId::DECIMAL: {
+      return FilterColByValImpl<double, Op>(col_idx, val.d_);
+    }
+    case type::TypeId::DATE: {
+      return FilterColByValImpl<uint32_t, Op>(col_idx, val.date_);
+    }
+    case type::TypeId::TIMESTAMP: {
+      return FilterColByValImpl<uint64_t, Op>(col_idx, val.ts_);
+    }
     default: {
       throw std::runtime_error("Filter not supported on type");
     }
   }
 }
 
-template <template <typename> typename Op>
+template <template <typename> typename Op, bool Nullable>
 uint32_t ProjectedColumnsIterator::FilterColByCol(const uint32_t col_idx_1, type::TypeId type_1,
                                                   const uint32_t col_idx_2, type::TypeId type_2) {
   TERRIER_ASSERT(type_1 == type_2, "Incompatible column types for filter");
 
+  // NOLINTNEXTLINE: bugprone-suspicious-semicolon: seems like a false positive because of constexpr
+  if constexpr (Nullable) {
+    FilterColNotNull(col_idx_1);
+    FilterColNotNull(col_idx_2);
+  }
+
   switch (type_1) {
+    case type::TypeId::TINYINT: {
+      return FilterColByColImpl<int8_t, Op>(col_idx_1, col_idx_2);
+    }
     case type::TypeId::SMALLINT: {
       return FilterColByColImpl<int16_t, Op>(col_idx_1, col_idx_2);
     }
@@ -105,28 +127,95 @@ uint32_t ProjectedColumnsIterator::FilterColByCol(const uint32_t col_idx_1, type
     case type::TypeId::BIGINT: {
       return FilterColByColImpl<int64_t, Op>(col_idx_1, col_idx_2);
     }
+    case type::TypeId::DECIMAL: {
+      return FilterColByColImpl<double, Op>(col_idx_1, col_idx_2);
+    }
+    case type::TypeId::DATE: {
+      return FilterColByColImpl<uint32_t, Op>(col_idx_1, col_idx_2);
+    }
+    case type::TypeId::TIMESTAMP: {
+      return FilterColByColImpl<uint64_t, Op>(col_idx_1, col_idx_2);
+    }
+    case type::TypeId::VARCHAR: {
+      return FilterColByColImpl<storage::VarlenEntry, Op>(col_idx_1, col_idx_2);
+    }
     default: {
       throw std::runtime_error("Filter not supported on type");
     }
   }
 }
 
-template uint32_t ProjectedColumnsIterator::FilterColByVal<std::equal_to>(uint32_t, type::TypeId, FilterVal);
-template uint32_t ProjectedColumnsIterator::FilterColByVal<std::greater>(uint32_t, type::TypeId, FilterVal);
-template uint32_t ProjectedColumnsIterator::FilterColByVal<std::greater_equal>(uint32_t, type::TypeId, FilterVal);
-template uint32_t ProjectedColumnsIterator::FilterColByVal<std::less>(uint32_t, type::TypeId, FilterVal);
-template uint32_t ProjectedColumnsIterator::FilterColByVal<std::less_equal>(uint32_t, type::TypeId, FilterVal);
-template uint32_t ProjectedColumnsIterator::FilterColByVal<std::not_equal_to>(uint32_t, type::TypeId, FilterVal);
-template uint32_t ProjectedColumnsIterator::FilterColByCol<std::equal_to>(uint32_t, type::TypeId, uint32_t,
-                                                                          type::TypeId);
-template uint32_t ProjectedColumnsIterator::FilterColByCol<std::greater>(uint32_t, type::TypeId, uint32_t,
-                                                                         type::TypeId);
-template uint32_t ProjectedColumnsIterator::FilterColByCol<std::greater_equal>(uint32_t, type::TypeId, uint32_t,
-                                                                               type::TypeId);
-template uint32_t ProjectedColumnsIterator::FilterColByCol<std::less>(uint32_t, type::TypeId, uint32_t, type::TypeId);
-template uint32_t ProjectedColumnsIterator::FilterColByCol<std::less_equal>(uint32_t, type::TypeId, uint32_t,
-                                                                            type::TypeId);
-template uint32_t ProjectedColumnsIterator::FilterColByCol<std::not_equal_to>(uint32_t, type::TypeId, uint32_t,
-                                                                              type::TypeId);
+template <template <typename> typename Op, bool Nullable>
+uint32_t ProjectedColumnsIterator::FilterColByString(const uint32_t col_idx, const std::string_view val) {
+  // NOLINTNEXTLINE: bugprone-suspicious-semicolon: seems like a false positive because of constexpr
+  if constexpr (Nullable) FilterColNotNull(col_idx);
+
+  const auto *input =
+      reinterpret_cast<const storage::VarlenEntry *>(projected_column_->ColumnStart(static_cast<uint16_t>(col_idx)));
+  return RunVectorFilter([&](const uint32_t *sel_vec) {
+    return util::VectorUtil::FilterStringByVal<Op>(input, num_selected_, val, selection_vector_, sel_vec);
+  });
+}
+
+template <bool Nullable>
+uint32_t ProjectedColumnsIterator::FilterColByPrefix(const uint32_t col_idx, const std::string_view prefix) {
+  // NOLINTNEXTLINE: bugprone-suspicious-semicolon: seems like a false positive because of constexpr
+  if constexpr (Nullable) FilterColNotNull(col_idx);
+
+  const auto *input =
+      reinterpret_cast<const storage::VarlenEntry *>(projected_column_->ColumnStart(static_cast<uint16_t>(col_idx)));
+  return RunVectorFilter([&](const uint32_t *sel_vec) {
+    return util::VectorUtil::FilterStringPrefix(input, num_selected_, prefix, selection_vector_, sel_vec);
+  });
+}
+
+template <bool Nullable>
+uint32_t ProjectedColumnsIterator::FilterColByLike(const uint32_t col_idx, const std::string_view pattern) {
+  // NOLINTNEXTLINE: bugprone-suspicious-semicolon: seems like a false positive because of constexpr
+  if constexpr (Nullable) FilterColNotNull(col_idx);
+
+  const auto *input =
+      reinterpret_cast<const storage::VarlenEntry *>(projected_column_->ColumnStart(static_cast<uint16_t>(col_idx)));
+  return RunVectorFilter([&](const uint32_t *sel_vec) {
+    return util::VectorUtil::FilterStringLike(input, num_selected_, pattern, selection_vector_, sel_vec);
+  });
+}
+
+uint32_t ProjectedColumnsIterator::FilterColNull(const uint32_t col_idx) {
+  const auto *null_bitmap = projected_column_->ColumnNullBitmap(static_cast<uint16_t>(col_idx));
+  return RunVectorFilter([&](const uint32_t *sel_vec) {
+    return util::VectorUtil::SelectNull(null_bitmap, num_selected_, selection_vector_, sel_vec);
+  });
+}
+
+uint32_t ProjectedColumnsIterator::FilterColNotNull(const uint32_t col_idx) {
+  const auto *null_bitmap = projected_column_->ColumnNullBitmap(static_cast<uint16_t>(col_idx));
+  return RunVectorFilter([&](const uint32_t *sel_vec) {
+    return util::VectorUtil::SelectNotNull(null_bitmap, num_selected_, selection_vector_, sel_vec);
+  });
+}
+
+#define INSTANTIATE_FILTERS(Op)                                                                             \
+  template uint32_t ProjectedColumnsIterator::FilterColByVal<Op, false>(uint32_t, type::TypeId, FilterVal); \
+  template uint32_t ProjectedColumnsIterator::FilterColByVal<Op, true>(uint32_t, type::TypeId, FilterVal);  \
+  template uint32_t ProjectedColumnsIterator::FilterColByCol<Op, false>(uint32_t, type::TypeId, uint32_t,   \
+                                                                        type::TypeId);                      \
+  template uint32_t ProjectedColumnsIterator::FilterColByCol<Op, true>(uint32_t, type::TypeId, uint32_t,    \
+                                                                       type::TypeId);                       \
+  template uint32_t ProjectedColumnsIterator::FilterColByString<Op, false>(uint32_t, std::string_view);     \
+  template uint32_t ProjectedColumnsIterator::FilterColByString<Op, true>(uint32_t, std::string_view);
+
+INSTANTIATE_FILTERS(std::equal_to)
+INSTANTIATE_FILTERS(std::greater)
+INSTANTIATE_FILTERS(std::greater_equal)
+INSTANTIATE_FILTERS(std::less)
+INSTANTIATE_FILTERS(std::less_equal)
+INSTANTIATE_FILTERS(std::not_equal_to)
+#undef INSTANTIATE_FILTERS
+
+template uint32_t ProjectedColumnsIterator::FilterColByPrefix<false>(uint32_t, std::string_view);
+template uint32_t ProjectedColumnsIterator::FilterColByPrefix<true>(uint32_t, std::string_view);
+template uint32_t ProjectedColumnsIterator::FilterColByLike<false>(uint32_t, std::string_view);
+template uint32_t ProjectedColumnsIterator::FilterColByLike<true>(uint32_t, std::string_view);
 
 }  // namespace terrier::execution::sql
@@ -1,9 +1,13 @@
+#include <algorithm>
+#include <limits>
 #include <memory>
 #include <vector>
 
 #include "execution/exec/execution_context.h"
 #include "execution/sql/table_vector_iterator.h"
+#include "execution/sql/thread_state_container.h"
 #include "execution/util/timer.h"
+#include "loggers/execution_logger.h"
 #include "tbb/blocked_range.h"
 #include "tbb/parallel_for.h"
 #include "tbb/task_scheduler_init.h"
@@ -11,7 +15,15 @@
 namespace terrier::execution::sql {
 TableVectorIterator::TableVectorIterator(exec::ExecutionContext *exec_ctx, uint32_t table_oid, uint32_t *col_oids,
                                          uint32_t num_oids)
-    : exec_ctx_(exec_ctx), table_oid_(table_oid), col_oids_(col_oids, col_oids + num_oids) {}
+    : TableVectorIterator(exec_ctx, table_oid, col_oids, num_oids, 0, std::numeric_limits<uint32_t>::max()) {}
+
+TableVectorIterator::TableVectorIterator(exec::ExecutionContext *exec_ctx, uint32_t table_oid, uint32_t *col_oids,
+                                         uint32_t num_oids, uint32_t start_block_idx, uint32_t end_block_idx)
+    : exec_ctx_(exec_ctx),
+      table_oid_(table_oid),
+      col_oids_(col_oids, col_oids + num_oids),
+      start_block_idx_(start_block_idx),
+      end_block_idx_(end_block_idx) {}
 
 TableVectorIterator::~TableVectorIterator() {
   exec_ctx_->GetMemoryPool()->Deallocate(buffer_, projected_columns_->Size());
@@ -30,27 +42,56 @@ bool TableVectorIterator::Init() {
   initialized_ = true;
 
   // Begin iterating
-  iter_ = std::make_unique<storage::DataTable::SlotIterator>(table_->begin());
+  iter_ = std::make_unique<storage::DataTable::SlotIterator>(table_->beginAt(start_block_idx_));
   return true;
 }
 
 bool TableVectorIterator::Advance() {
   if (!initialized_) return false;
-  // First check if the iterator ended.
-  if (*iter_ == table_->end()) {
+  // First check if the iterator ended. The end of the range is recomputed on every call because it moves with
+  // concurrent inserts when the range extends to the end of the table.
+  const auto end = table_->endAt(end_block_idx_);
+  if (*iter_ == end) {
     return false;
   }
   // Scan the table to set the projected column.
-  table_->Scan(exec_ctx_->GetTxn(), iter_.get(), projected_columns_);
+  table_->Scan(exec_ctx_->GetTxn(), iter_.get(), end, projected_columns_);
   pci_.SetProjectedColumn(projected_columns_);
   return true;
 }
 
-bool TableVectorIterator::ParallelScan(uint32_t db_oid, uint32_t table_oid, void *const query_state,
+bool TableVectorIterator::ParallelScan(const uint32_t table_oid, uint32_t *const col_oids, const uint32_t num_oids,
+                                       void *const query_state, exec::ExecutionContext *const exec_ctx,
                                        ThreadStateContainer *const thread_states, const ScanFn scan_fn,
                                        const uint32_t min_grain_size) {
-  // TODO(Amadou): Implement Me!!
-  return false;
+  // Lookup table
+  const auto table = exec_ctx->GetAccessor()->GetTable(catalog::table_oid_t(table_oid));
+  if (table == nullptr) {
+    return false;
+  }
+
+  // Time
+  util::Timer<std::milli> timer;
+  timer.Start();
+
+  // Execute parallel scan. Each morsel is a contiguous range of blocks scanned by a fresh iterator, and handed to the
+  // scan function along with the executing thread's state.
+  tbb::task_scheduler_init scan_scheduler;
+  tbb::blocked_range<uint32_t> block_range(0, table->GetNumBlocks(), std::max(min_grain_size, 1u));
+  tbb::parallel_for(block_range, [&](const tbb::blocked_range<uint32_t> &morsel) {
+    // The last morsel extends to the end of the table so that it covers blocks added after the range was split.
+    const uint32_t end_block_idx =
+        morsel.end() == block_range.end() ? std::numeric_limits<uint32_t>::max() : morsel.end();
+    TableVectorIterator iter(exec_ctx, table_oid, col_oids, num_oids, morsel.begin(), end_block_idx);
+    iter.Init();
+    scan_fn(query_state, thread_states->AccessThreadStateOfCurrentThread(), &iter);
+  });
+
+  timer.Stop();
+
+  EXECUTION_LOG_DEBUG("Scanned {} blocks in {} ms", block_range.size(), timer.Elapsed());
+
+  return true;
 }
 
 }  // namespace terrier::execution::sql
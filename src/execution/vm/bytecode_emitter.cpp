@@ -263,9 +263,10 @@ void BytecodeEmitter::EmitAddCol(Bytecode bytecode, LocalVar iter, uint32_t col_
   EmitAll(bytecode, iter, col_oid);
 }
 
-void BytecodeEmitter::EmitParallelTableScan(uint32_t db_oid, uint32_t table_oid, LocalVar ctx, LocalVar thread_states,
+void BytecodeEmitter::EmitParallelTableScan(uint32_t table_oid, LocalVar col_oids, uint32_t num_oids,
+                                            LocalVar query_state, LocalVar exec_ctx, LocalVar thread_states,
                                             FunctionId scan_fn) {
-  EmitAll(Bytecode::ParallelScanTable, db_oid, table_oid, ctx, thread_states, scan_fn);
+  EmitAll(Bytecode::ParallelScanTable, table_oid, col_oids, num_oids, query_state, exec_ctx, thread_states, scan_fn);
 }
 
 void BytecodeEmitter::EmitPCIGet(Bytecode bytecode, LocalVar out, LocalVar pci, uint16_t col_idx) {
@@ -273,14 +274,32 @@ void BytecodeEmitter::EmitPCIGet(Bytecode bytecode, LocalVar out, LocalVar pci,
 }
 
 void BytecodeEmitter::EmitPCIVectorFilter(Bytecode bytecode, LocalVar selected, LocalVar pci, uint32_t col_idx,
-                                          int8_t type, int64_t val) {
-  EmitAll(bytecode, selected, pci, col_idx, type, val);
+                                          int8_t type, int64_t val, bool nullable) {
+  EmitAll(bytecode, selected, pci, col_idx, type, val, static_cast<int8_t>(nullable));
+}
+
+void BytecodeEmitter::EmitPCIVectorFilter(Bytecode bytecode, LocalVar selected, LocalVar pci, uint32_t col_idx,
+                                          int8_t type, double val, bool nullable) {
+  EmitAll(bytecode, selected, pci, col_idx, type, val, static_cast<int8_t>(nullable));
+}
+
+void BytecodeEmitter::EmitPCIVectorStringFilter(Bytecode bytecode, LocalVar selected, LocalVar pci, uint32_t col_idx,
+                                                uint64_t length, uintptr_t data, bool nullable) {
+  EmitAll(bytecode, selected, pci, col_idx, length, data, static_cast<int8_t>(nullable));
+}
+
+void BytecodeEmitter::EmitPCIVectorNullFilter(Bytecode bytecode, LocalVar selected, LocalVar pci, uint32_t col_idx) {
+  EmitAll(bytecode, selected, pci, col_idx);
 }
 
 void BytecodeEmitter::EmitFilterManagerInsertFlavor(LocalVar fmb, FunctionId func) {
   EmitAll(Bytecode::FilterManagerInsertFlavor, fmb, func);
 }
 
+void BytecodeEmitter::EmitFilterManagerInsertJoinFilter(LocalVar fmb, LocalVar join_hash_table, FunctionId hash_fn) {
+  EmitAll(Bytecode::FilterManagerInsertJoinFilter, fmb, join_hash_table, hash_fn);
+}
+
 void BytecodeEmitter::EmitAggHashTableLookup(LocalVar dest, LocalVar agg_ht, LocalVar hash, FunctionId key_eq_fn,
                                              LocalVar arg) {
   EmitAll(Bytecode::AggregationHashTableLookup, dest, agg_ht, hash, key_eq_fn, arg);
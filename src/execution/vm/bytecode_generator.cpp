@@ -13,6 +13,7 @@
 #include "execution/vm/bytecode_module.h"
 #include "execution/vm/control_flow_builders.h"
 #include "loggers/execution_logger.h"
+#include "type/type_id.h"
 
 namespace terrier::execution::vm {
 
@@ -555,7 +556,26 @@ void BytecodeGenerator::VisitBuiltinTableIterCall(ast::CallExpr *call, ast::Buil
 }
 
 void BytecodeGenerator::VisitBuiltinTableIterParallelCall(ast::CallExpr *call) {
-  UNREACHABLE("Parallel scan is not implemented yet!");
+  // The first argument is the table name
+  ast::Identifier table_name = call->Arguments()[0]->As<ast::LitExpr>()->RawStringVal();
+  auto ns_oid = exec_ctx_->GetAccessor()->GetDefaultNamespace();
+  auto table_oid = exec_ctx_->GetAccessor()->GetTableOid(ns_oid, table_name.Data());
+  TERRIER_ASSERT(table_oid != terrier::catalog::INVALID_TABLE_OID, "Table does not exists");
+  // The second argument is the array of column oids
+  auto *arr_type = call->Arguments()[1]->GetType()->As<ast::ArrayType>();
+  LocalVar col_oids = VisitExpressionForLValue(call->Arguments()[1]);
+  // The third argument is the opaque query state
+  LocalVar query_state = VisitExpressionForRValue(call->Arguments()[2]);
+  // The fourth argument is the execution context
+  LocalVar exec_ctx = VisitExpressionForRValue(call->Arguments()[3]);
+  // The fifth argument is the thread state container
+  LocalVar thread_states = VisitExpressionForRValue(call->Arguments()[4]);
+  // The sixth argument is the scan function as an identifier
+  const auto scan_fn_name = call->Arguments()[5]->As<ast::IdentifierExpr>()->Name();
+  const auto scan_fn_id = LookupFuncIdByName(scan_fn_name.Data());
+  // Emit the scan call
+  Emitter()->EmitParallelTableScan(!table_oid, col_oids, static_cast<uint32_t>(arr_type->Length()), query_state,
+                                   exec_ctx, thread_states, scan_fn_id);
 }
 
 void BytecodeGenerator::VisitBuiltinPCICall(ast::CallExpr *call, ast::Builtin builtin) {
@@ -760,6 +780,12 @@ void BytecodeGenerator::VisitBuiltinFilterManagerCall(ast::CallExpr *call, ast::
       }
       break;
     }
+    case ast::Builtin::FilterManagerInsertJoinFilter: {
+      LocalVar join_hash_table = VisitExpressionForRValue(call->Arguments()[1]);
+      const std::string hash_fn_name = call->Arguments()[2]->As<ast::IdentifierExpr>()->Name().Data();
+      Emitter()->EmitFilterManagerInsertJoinFilter(filter_manager, join_hash_table, LookupFuncIdByName(hash_fn_name));
+      break;
+    }
     case ast::Builtin::FilterManagerFinalize: {
       Emitter()->Emit(Bytecode::FilterManagerFinalize, filter_manager);
       break;
@@ -788,46 +814,98 @@ void BytecodeGenerator::VisitBuiltinFilterCall(ast::CallExpr *call, ast::Builtin
     ret_val = CurrentFunction()->NewLocal(call->GetType());
   }
 
-  // Collect the three call arguments
+  // Collect the call arguments
   // Projected Column Iterator
   LocalVar pci = VisitExpressionForRValue(call->Arguments()[0]);
   // Column index
   auto col_idx = static_cast<uint16_t>(call->Arguments()[1]->As<ast::LitExpr>()->Int64Val());
+
+  // The NULL filters take no other argument
+  if (builtin == ast::Builtin::FilterNull || builtin == ast::Builtin::FilterNotNull) {
+    auto bytecode = builtin == ast::Builtin::FilterNull ? Bytecode::PCIFilterNull : Bytecode::PCIFilterNotNull;
+    Emitter()->EmitPCIVectorNullFilter(bytecode, ret_val, pci, col_idx);
+    return;
+  }
+
+  // Whether the column is NULLable, from the optional last argument
+  const bool pattern_filter = builtin == ast::Builtin::FilterPrefix || builtin == ast::Builtin::FilterLike;
+  const uint32_t nullable_arg = pattern_filter ? 3 : 4;
+  const bool nullable =
+      call->NumArgs() > nullable_arg && call->Arguments()[nullable_arg]->As<ast::LitExpr>()->BoolVal();
+
+  // String constants are copied into the execution context's buffer, like string literals, and their address is
+  // embedded in the bytecode
+  const auto emit_string_filter = [&](Bytecode bytecode, ast::Expr *arg) {
+    auto input = arg->As<ast::LitExpr>()->RawStringVal();
+    auto input_length = input.Length();
+    auto *data = exec_ctx_->GetStringAllocator()->Allocate(input_length);
+    std::memcpy(data, input.Data(), input_length);
+    Emitter()->EmitPCIVectorStringFilter(bytecode, ret_val, pci, col_idx, input_length,
+                                         reinterpret_cast<uintptr_t>(data), nullable);
+  };
+
+  if (pattern_filter) {
+    auto bytecode = builtin == ast::Builtin::FilterPrefix ? Bytecode::PCIFilterPrefix : Bytecode::PCIFilterLike;
+    emit_string_filter(bytecode, call->Arguments()[2]);
+    return;
+  }
+
   auto col_type = static_cast<int8_t>(call->Arguments()[2]->As<ast::LitExpr>()->Int64Val());
   // Filter value
-  int64_t val = call->Arguments()[3]->As<ast::LitExpr>()->Int64Val();
+  auto *val = call->Arguments()[3]->As<ast::LitExpr>();
 
-  Bytecode bytecode;
+  // The bytecodes of the operator, comparing to an integer, floating-point or string constant
+  Bytecode bytecode, real_bytecode, string_bytecode;
   switch (builtin) {
     case ast::Builtin::FilterEq: {
       bytecode = Bytecode::PCIFilterEqual;
+      real_bytecode = Bytecode::PCIFilterEqualReal;
+      string_bytecode = Bytecode::PCIFilterEqualString;
       break;
     }
     case ast::Builtin::FilterGt: {
       bytecode = Bytecode::PCIFilterGreaterThan;
+      real_bytecode = Bytecode::PCIFilterGreaterThanReal;
+      string_bytecode = Bytecode::PCIFilterGreaterThanString;
       break;
     }
     case ast::Builtin::FilterGe: {
       bytecode = Bytecode::PCIFilterGreaterThanEqual;
+      real_bytecode = Bytecode::PCIFilterGreaterThanEqualReal;
+      string_bytecode = Bytecode::PCIFilterGreaterThanEqualString;
       break;
     }
     case ast::Builtin::FilterLt: {
       bytecode = Bytecode::PCIFilterLessThan;
+      real_bytecode = Bytecode::PCIFilterLessThanReal;
+      string_bytecode = Bytecode::PCIFilterLessThanString;
       break;
     }
     case ast::Builtin::FilterLe: {
       bytecode = Bytecode::PCIFilterLessThanEqual;
+      real_bytecode = Bytecode::PCIFilterLessThanEqualReal;
+      string_bytecode = Bytecode::PCIFilterLessThanEqualString;
       break;
     }
     case ast::Builtin::FilterNe: {
       bytecode = Bytecode::PCIFilterNotEqual;
+      real_bytecode = Bytecode::PCIFilterNotEqualReal;
+      string_bytecode = Bytecode::PCIFilterNotEqualString;
       break;
     }
     default: {
       UNREACHABLE("Impossible bytecode");
     }
   }
-  Emitter()->EmitPCIVectorFilter(bytecode, ret_val, pci, col_idx, col_type, val);
+
+  if (static_cast<type::TypeId>(col_type) == type::TypeId::DECIMAL) {
+    const double d = val->IsFloatLitExpr() ? val->Float64Val() : static_cast<double>(val->Int64Val());
+    Emitter()->EmitPCIVectorFilter(real_bytecode, ret_val, pci, col_idx, col_type, d, nullable);
+  } else if (static_cast<type::TypeId>(col_type) == type::TypeId::VARCHAR) {
+    emit_string_filter(string_bytecode, val);
+  } else {
+    Emitter()->EmitPCIVectorFilter(bytecode, ret_val, pci, col_idx, col_type, val->Int64Val(), nullable);
+  }
 }
 
 void BytecodeGenerator::VisitBuiltinAggHashTableCall(ast::CallExpr *call, ast::Builtin builtin) {
@@ -1445,6 +1523,20 @@ void BytecodeGenerator::VisitBuiltinIndexIteratorCall(ast::CallExpr *call, ast::
       ExecutionResult()->SetDestination(cond.ValueOf());
       break;
     }
+    case ast::Builtin::IndexIteratorAddBatchKey: {
+      Emitter()->Emit(Bytecode::IndexIteratorAddBatchKey, iterator);
+      break;
+    }
+    case ast::Builtin::IndexIteratorScanKeyBatch: {
+      Emitter()->Emit(Bytecode::IndexIteratorScanKeyBatch, iterator);
+      break;
+    }
+    case ast::Builtin::IndexIteratorNextBatchKey: {
+      LocalVar cond = ExecutionResult()->GetOrCreateDestination(ast::BuiltinType::Get(ctx, ast::BuiltinType::Bool));
+      Emitter()->Emit(Bytecode::IndexIteratorNextBatchKey, cond, iterator);
+      ExecutionResult()->SetDestination(cond.ValueOf());
+      break;
+    }
     case ast::Builtin::IndexIteratorFree: {
       Emitter()->Emit(Bytecode::IndexIteratorFree, iterator);
       break;
@@ -1621,7 +1713,11 @@ void BytecodeGenerator::VisitBuiltinCallExpr(ast::CallExpr *call) {
     case ast::Builtin::FilterGe:
     case ast::Builtin::FilterLt:
     case ast::Builtin::FilterLe:
-    case ast::Builtin::FilterNe: {
+    case ast::Builtin::FilterNe:
+    case ast::Builtin::FilterPrefix:
+    case ast::Builtin::FilterLike:
+    case ast::Builtin::FilterNull:
+    case ast::Builtin::FilterNotNull: {
       VisitBuiltinFilterCall(call, builtin);
       break;
     }
@@ -1681,6 +1777,7 @@ void BytecodeGenerator::VisitBuiltinCallExpr(ast::CallExpr *call) {
     };
     case ast::Builtin::FilterManagerInit:
     case ast::Builtin::FilterManagerInsertFilter:
+    case ast::Builtin::FilterManagerInsertJoinFilter:
     case ast::Builtin::FilterManagerFinalize:
     case ast::Builtin::FilterManagerRunFilters:
     case ast::Builtin::FilterManagerFree: {
@@ -1776,6 +1873,9 @@ void BytecodeGenerator::VisitBuiltinCallExpr(ast::CallExpr *call) {
     case ast::Builtin::IndexIteratorInitBind:
     case ast::Builtin::IndexIteratorScanKey:
     case ast::Builtin::IndexIteratorAdvance:
+    case ast::Builtin::IndexIteratorAddBatchKey:
+    case ast::Builtin::IndexIteratorScanKeyBatch:
+    case ast::Builtin::IndexIteratorNextBatchKey:
     case ast::Builtin::IndexIteratorGetTinyInt:
     case ast::Builtin::IndexIteratorGetSmallInt:
     case ast::Builtin::IndexIteratorGetInt:
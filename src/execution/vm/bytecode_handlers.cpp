@@ -1,9 +1,26 @@
 #include "execution/vm/bytecode_handlers.h"
+
+#include <string_view>
+
 #include "execution/sql/projected_columns_iterator.h"
 
 #include "catalog/catalog_defs.h"
 #include "execution/exec/execution_context.h"
 
+namespace {
+
+// Filter a column by a constant, which is made into a filter value of the column's type
+template <template <typename> typename Op, typename T>
+uint32_t PCIFilterByVal(terrier::execution::sql::ProjectedColumnsIterator *iter, uint32_t col_idx, int8_t type, T val,
+                        int8_t nullable) {
+  auto sql_type = static_cast<terrier::type::TypeId>(type);
+  auto v = iter->MakeFilterVal(val, sql_type);
+  return nullable != 0 ? iter->FilterColByVal<Op, true>(col_idx, sql_type, v)
+                       : iter->FilterColByVal<Op, false>(col_idx, sql_type, v);
+}
+
+}  // namespace
+
 extern "C" {
 
 // ---------------------------------------------------------
@@ -38,45 +55,127 @@ void OpTableVectorIteratorFree(terrier::execution::sql::TableVectorIterator *ite
 }
 
 void OpPCIFilterEqual(uint64_t *size, terrier::execution::sql::ProjectedColumnsIterator *iter, uint32_t col_idx,
-                      int8_t type, int64_t val) {
-  auto sql_type = static_cast<terrier::type::TypeId>(type);
-  auto v = iter->MakeFilterVal(val, sql_type);
-  *size = iter->FilterColByVal<std::equal_to>(col_idx, sql_type, v);
+                      int8_t type, int64_t val, int8_t nullable) {
+  *size = PCIFilterByVal<std::equal_to>(iter, col_idx, type, val, nullable);
 }
 
 void OpPCIFilterGreaterThan(uint64_t *size, terrier::execution::sql::ProjectedColumnsIterator *iter, uint32_t col_idx,
-                            int8_t type, int64_t val) {
-  auto sql_type = static_cast<terrier::type::TypeId>(type);
-  auto v = iter->MakeFilterVal(val, sql_type);
-  *size = iter->FilterColByVal<std::greater>(col_idx, sql_type, v);
+                            int8_t type, int64_t val, int8_t nullable) {
+  *size = PCIFilterByVal<std::greater>(iter, col_idx, type, val, nullable);
 }
 
 void OpPCIFilterGreaterThanEqual(uint64_t *size, terrier::execution::sql::ProjectedColumnsIterator *iter,
-                                 uint32_t col_idx, int8_t type, int64_t val) {
-  auto sql_type = static_cast<terrier::type::TypeId>(type);
-  auto v = iter->MakeFilterVal(val, sql_type);
-  *size = iter->FilterColByVal<std::greater_equal>(col_idx, sql_type, v);
+                                 uint32_t col_idx, int8_t type, int64_t val, int8_t nullable) {
+  *size = PCIFilterByVal<std::greater_equal>(iter, col_idx, type, val, nullable);
 }
 
 void OpPCIFilterLessThan(uint64_t *size, terrier::execution::sql::ProjectedColumnsIterator *iter, uint32_t col_idx,
-                         int8_t type, int64_t val) {
-  auto sql_type = static_cast<terrier::type::TypeId>(type);
-  auto v = iter->MakeFilterVal(val, sql_type);
-  *size = iter->FilterColByVal<std::less>(col_idx, sql_type, v);
+                         int8_t type, int64_t val, int8_t nullable) {
+  *size = PCIFilterByVal<std::less>(iter, col_idx, type, val, nullable);
 }
 
 void OpPCIFilterLessThanEqual(uint64_t *size, terrier::execution::sql::ProjectedColumnsIterator *iter, uint32_t col_idx,
-                              int8_t type, int64_t val) {
-  auto sql_type = static_cast<terrier::type::TypeId>(type);
-  auto v = iter->MakeFilterVal(val, sql_type);
-  *size = iter->FilterColByVal<std::less_equal>(col_idx, sql_type, v);
+                              int8_t type, int64_t val, int8_t nullable) {
+  *size = PCIFilterByVal<std::less_equal>(iter, col_idx, type, val, nullable);
 }
 
 void OpPCIFilterNotEqual(uint64_t *size, terrier::execution::sql::ProjectedColumnsIterator *iter, uint32_t col_idx,
-                         int8_t type, int64_t val) {
-  auto sql_type = static_cast<terrier::type::TypeId>(type);
-  auto v = iter->MakeFilterVal(val, sql_type);
-  *size = iter->FilterColByVal<std::not_equal_to>(col_idx, sql_type, v);
+                         int8_t type, int64_t val, int8_t nullable) {
+  *size = PCIFilterByVal<std::not_equal_to>(iter, col_idx, type, val, nullable);
+}
+
+void OpPCIFilterEqualReal(uint64_t *size, terrier::execution::sql::ProjectedColumnsIterator *iter, uint32_t col_idx,
+                          int8_t type, double val, int8_t nullable) {
+  *size = PCIFilterByVal<std::equal_to>(iter, col_idx, type, val, nullable);
+}
+
+void OpPCIFilterGreaterThanReal(uint64_t *size, terrier::execution::sql::ProjectedColumnsIterator *iter,
+                                uint32_t col_idx, int8_t type, double val, int8_t nullable) {
+  *size = PCIFilterByVal<std::greater>(iter, col_idx, type, val, nullable);
+}
+
+void OpPCIFilterGreaterThanEqualReal(uint64_t *size, terrier::execution::sql::ProjectedColumnsIterator *iter,
+                                     uint32_t col_idx, int8_t type, double val, int8_t nullable) {
+  *size = PCIFilterByVal<std::greater_equal>(iter, col_idx, type, val, nullable);
+}
+
+void OpPCIFilterLessThanReal(uint64_t *size, terrier::execution::sql::ProjectedColumnsIterator *iter, uint32_t col_idx,
+                             int8_t type, double val, int8_t nullable) {
+  *size = PCIFilterByVal<std::less>(iter, col_idx, type, val, nullable);
+}
+
+void OpPCIFilterLessThanEqualReal(uint64_t *size, terrier::execution::sql::ProjectedColumnsIterator *iter,
+                                  uint32_t col_idx, int8_t type, double val, int8_t nullable) {
+  *size = PCIFilterByVal<std::less_equal>(iter, col_idx, type, val, nullable);
+}
+
+void OpPCIFilterNotEqualReal(uint64_t *size, terrier::execution::sql::ProjectedColumnsIterator *iter, uint32_t col_idx,
+                             int8_t type, double val, int8_t nullable) {
+  *size = PCIFilterByVal<std::not_equal_to>(iter, col_idx, type, val, nullable);
+}
+
+void OpPCIFilterEqualString(uint64_t *size, terrier::execution::sql::ProjectedColumnsIterator *iter, uint32_t col_idx,
+                            uint64_t length, uintptr_t data, int8_t nullable) {
+  const std::string_view val(reinterpret_cast<const char *>(data), length);
+  *size = nullable != 0 ? iter->FilterColByString<std::equal_to, true>(col_idx, val)
+                        : iter->FilterColByString<std::equal_to, false>(col_idx, val);
+}
+
+void OpPCIFilterGreaterThanString(uint64_t *size, terrier::execution::sql::ProjectedColumnsIterator *iter,
+                                  uint32_t col_idx, uint64_t length, uintptr_t data, int8_t nullable) {
+  const std::string_view val(reinterpret_cast<const char *>(data), length);
+  *size = nullable != 0 ? iter->FilterColByString<std::greater, true>(col_idx, val)
+                        : iter->FilterColByString<std::greater, false>(col_idx, val);
+}
+
+void OpPCIFilterGreaterThanEqualString(uint64_t *size, terrier::execution::sql::ProjectedColumnsIterator *iter,
+                                       uint32_t col_idx, uint64_t length, uintptr_t data, int8_t nullable) {
+  const std::string_view val(reinterpret_cast<const char *>(data), length);
+  *size = nullable != 0 ? iter->FilterColByString<std::greater_equal, true>(col_idx, val)
+                        : iter->FilterColByString<std::greater_equal, false>(col_idx, val);
+}
+
+void OpPCIFilterLessThanString(uint64_t *size, terrier::execution::sql::ProjectedColumnsIterator *iter,
+                               uint32_t col_idx, uint64_t length, uintptr_t data, int8_t nullable) {
+  const std::string_view val(reinterpret_cast<const char *>(data), length);
+  *size = nullable != 0 ? iter->FilterColByString<std::less, true>(col_idx, val)
+                        : iter->FilterColByString<std::less, false>(col_idx, val);
+}
+
+void OpPCIFilterLessThanEqualString(uint64_t *size, terrier::execution::sql::ProjectedColumnsIterator *iter,
+                                    uint32_t col_idx, uint64_t length, uintptr_t data, int8_t nullable) {
+  const std::string_view val(reinterpret_cast<const char *>(data), length);
+  *size = nullable != 0 ? iter->FilterColByString<std::less_equal, true>(col_idx, val)
+                        : iter->FilterColByString<std::less_equal, false>(col_idx, val);
+}
+
+void OpPCIFilterNotEqualString(uint64_t *size, terrier::execution::sql::ProjectedColumnsIterator *iter,
+                               uint32_t col_idx, uint64_t length, uintptr_t data, int8_t nullable) {
+  const std::string_view val(reinterpret_cast<const char *>(data), length);
+  *size = nullable != 0 ? iter->FilterColByString<std::not_equal_to, true>(col_idx, val)
+                        : iter->FilterColByString<std::not_equal_to, false>(col_idx, val);
+}
+
+void OpPCIFilterPrefix(uint64_t *size, terrier::execution::sql::ProjectedColumnsIterator *iter, uint32_t col_idx,
+                       uint64_t length, uintptr_t data, int8_t nullable) {
+  const std::string_view prefix(reinterpret_cast<const char *>(data), length);
+  *size = nullable != 0 ? iter->FilterColByPrefix<true>(col_idx, prefix)
+                        : iter->FilterColByPrefix<false>(col_idx, prefix);
+}
+
+void OpPCIFilterLike(uint64_t *size, terrier::execution::sql::ProjectedColumnsIterator *iter, uint32_t col_idx,
+                     uint64_t length, uintptr_t data, int8_t nullable) {
+  const std::string_view pattern(reinterpret_cast<const char *>(data), length);
+  *size = nullable != 0 ? iter->FilterColByLike<true>(col_idx, pattern)
+                        : iter->FilterColByLike<false>(col_idx, pattern);
+}
+
+void OpPCIFilterNull(uint64_t *size, terrier::execution::sql::ProjectedColumnsIterator *iter, uint32_t col_idx) {
+  *size = iter->FilterColNull(col_idx);
+}
+
+void OpPCIFilterNotNull(uint64_t *size, terrier::execution::sql::ProjectedColumnsIterator *iter, uint32_t col_idx) {
+  *size = iter->FilterColNotNull(col_idx);
 }
 
 // ---------------------------------------------------------
@@ -96,6 +195,12 @@ void OpFilterManagerInsertFlavor(terrier::execution::sql::FilterManager *filter_
   filter_manager->InsertClauseFlavor(flavor);
 }
 
+void OpFilterManagerInsertJoinFilter(terrier::execution::sql::FilterManager *filter_manager,
+                                     terrier::execution::sql::JoinHashTable *join_hash_table,
+                                     terrier::execution::sql::FilterManager::HashFn hash_fn) {
+  filter_manager->InsertJoinFilterClause(join_hash_table->RequestBloomFilter(), hash_fn);
+}
+
 void OpFilterManagerFinalize(terrier::execution::sql::FilterManager *filter_manager) { filter_manager->Finalize(); }
 
 void OpFilterManagerRunFilters(terrier::execution::sql::FilterManager *filter_manager,
@@ -1,8 +1,10 @@
 #include "execution/vm/bytecode_module.h"
 
 #include <algorithm>
+#include <cstring>
 #include <iomanip>
 #include <numeric>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
@@ -11,8 +13,78 @@
 
 namespace terrier::execution::vm {
 
+namespace {
+
+// The operand through which a bytecode in a superinstruction reads the result
+// of the bytecode before it, if the superinstruction hands that result over
+// directly instead of reloading it from the frame
+std::optional<uint32_t> ChainedOperand(Bytecode bytecode) {
+  switch (bytecode) {
+    case Bytecode::ForceBoolTruth:
+      return 1;
+    case Bytecode::JumpIfFalse:
+      return 0;
+    default:
+      return std::nullopt;
+  }
+}
+
+// Can the instructions starting at the i-th instruction of a function be fused
+// into the given superinstruction?
+bool CanFuse(BytecodeIterator *iter, const std::vector<std::size_t> &positions, std::size_t i,
+             Bytecode superinstruction) {
+  const auto &fused = Bytecodes::GetFusedBytecodes(superinstruction);
+  if (i + fused.size() > positions.size()) return false;
+  for (std::size_t j = 0; j < fused.size(); j++) {
+    iter->SetPosition(positions[i + j]);
+    if (iter->CurrentBytecode() != fused[j]) return false;
+    if (j == 0) continue;
+    // Each result handed over must be the one the next bytecode reads
+    if (const auto chained = ChainedOperand(fused[j]); chained.has_value()) {
+      const auto input_offset = iter->GetLocalOperand(*chained).GetOffset();
+      iter->SetPosition(positions[i + j - 1]);
+      if (iter->GetLocalOperand(0).GetOffset() != input_offset) return false;
+    }
+  }
+  return true;
+}
+
+// Overwrite the first opcode of every sequence of bytecodes that makes up a
+// superinstruction, leaving operands and the remaining opcodes in place
+std::vector<uint8_t> FuseSuperinstructions(const std::vector<uint8_t> &code,
+                                           const std::vector<FunctionInfo> &functions) {
+  std::vector<uint8_t> fused_code(code);
+  for (const auto &func : functions) {
+    // NOLINTNEXTLINE
+    auto [start, end] = func.BytecodeRange();
+    BytecodeIterator iter(code, start, end);
+    std::vector<std::size_t> positions;
+    for (; !iter.Done(); iter.Advance()) positions.push_back(iter.GetPosition());
+
+    for (std::size_t i = 0; i < positions.size(); i++) {
+      iter.SetPosition(positions[i]);
+      const Bytecode first = iter.CurrentBytecode();
+      for (uint32_t s = 0; s < Bytecodes::NumSuperinstructions(); s++) {
+        const auto superinstruction = static_cast<Bytecode>(Bytecodes::NumBytecodes() + s);
+        if (Bytecodes::GetFusedBytecodes(superinstruction)[0] != first) continue;
+        if (!CanFuse(&iter, positions, i, superinstruction)) continue;
+        const auto op = Bytecodes::ToByte(superinstruction);
+        std::memcpy(&fused_code[start + positions[i]], &op, sizeof(op));
+        i += Bytecodes::GetFusedBytecodes(superinstruction).size() - 1;
+        break;
+      }
+    }
+  }
+  return fused_code;
+}
+
+}  // namespace
+
 BytecodeModule::BytecodeModule(std::string name, std::vector<uint8_t> &&code, std::vector<FunctionInfo> &&functions)
-    : name_(std::move(name)), code_(std::move(code)), functions_(std::move(functions)) {}
+    : name_(std::move(name)),
+      code_(std::move(code)),
+      functions_(std::move(functions)),
+      interpreter_code_(FuseSuperinstructions(code_, functions_)) {}
 
 namespace {
 
@@ -9,7 +9,7 @@ namespace terrier::execution::vm {
 // static
 const char *Bytecodes::k_bytecode_names[] = {
 #define ENTRY(name, ...) #name,
-    BYTECODE_LIST(ENTRY)
+    BYTECODE_LIST(ENTRY) SUPERINSTRUCTION_LIST(ENTRY)
 #undef ENTRY
 };
 
@@ -41,6 +41,13 @@ const char *Bytecodes::k_bytecode_handler_name[] = {
 #undef ENTRY
 };
 
+// static
+const std::vector<Bytecode> Bytecodes::k_superinstruction_bytecodes[] = {
+#define ENTRY(name, ...) {__VA_ARGS__},
+    SUPERINSTRUCTION_LIST(ENTRY)
+#undef ENTRY
+};
+
 // static
 uint32_t Bytecodes::MaxBytecodeNameLength() {
   static constexpr const uint32_t k_max_inst_name_length = std::max({
@@ -1,8 +1,11 @@
 #include "execution/vm/llvm_engine.h"
 
+#include <iomanip>
 #include <map>
 #include <memory>
+#include <sstream>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -11,6 +14,7 @@
 #include "llvm/Analysis/TargetLibraryInfo.h"
 #include "llvm/Analysis/TargetTransformInfo.h"
 #include "llvm/Bitcode/BitcodeReader.h"
+#include "llvm/Config/llvm-config.h"
 #include "llvm/ExecutionEngine/RuntimeDyld.h"
 #include "llvm/ExecutionEngine/SectionMemoryManager.h"
 #include "llvm/IR/IRBuilder.h"
@@ -19,6 +23,8 @@
 #include "llvm/IR/Verifier.h"
 #include "llvm/MC/MCContext.h"
 #include "llvm/Support/DynamicLibrary.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Host.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/SmallVectorMemoryBuffer.h"
 #include "llvm/Support/TargetRegistry.h"
@@ -29,7 +35,9 @@
 #include "llvm/Transforms/IPO/PassManagerBuilder.h"
 #include "llvm/Transforms/Scalar.h"
 
+#include "common/hash_util.h"
 #include "execution/ast/type.h"
+#include "execution/util/hash.h"
 #include "execution/vm/bytecode_module.h"
 #include "execution/vm/bytecode_traits.h"
 #include "loggers/execution_logger.h"
@@ -58,6 +66,11 @@ bool FunctionHasDirectReturn(const ast::FunctionType *func_type) {
 
 class LLVMEngine::TPLMemoryManager : public llvm::SectionMemoryManager {
  public:
+  // Resolve the given symbol to the given address, rather than looking it up in the process
+  void AddSymbol(const std::string &name, void *address) {
+    symbols_[name] = {reinterpret_cast<uint64_t>(address), llvm::JITSymbolFlags::Exported};
+  }
+
   llvm::JITSymbol findSymbol(const std::string &name) override {
     EXECUTION_LOG_INFO("Resolving symbol '{}' ...", name);
 
@@ -369,6 +382,10 @@ class LLVMEngine::CompiledModuleBuilder {
   // declarations before they can be defined.
   void DefineFunctions();
 
+  // Generate an LLVM function implementation for only the function with the
+  // given ID. The other functions stay declarations.
+  void DefineFunction(FunctionId func_id);
+
   // Verify that all generated code is good
   void Verify();
 
@@ -496,6 +513,7 @@ LLVMEngine::CompiledModuleBuilder::CompiledModuleBuilder(const CompilerOptions &
     auto memory_buffer = llvm::MemoryBuffer::getFile(options.GetBytecodeHandlersBcPath());
     if (auto error = memory_buffer.getError()) {
       EXECUTION_LOG_ERROR("There was an error loading the handler bytecode: {}", error.message());
+      throw std::runtime_error(error.message());
     }
 
     auto module = llvm::parseBitcodeFile(*(memory_buffer.get()), *context_);
@@ -859,6 +877,11 @@ void LLVMEngine::CompiledModuleBuilder::DefineFunctions() {
   }
 }
 
+void LLVMEngine::CompiledModuleBuilder::DefineFunction(const FunctionId func_id) {
+  llvm::IRBuilder<> ir_builder(GetContext());
+  DefineFunction(*TplModule().GetFuncInfoById(func_id), &ir_builder);
+}
+
 void LLVMEngine::CompiledModuleBuilder::Verify() {
   std::string result;
   llvm::raw_string_ostream ostream(result);
@@ -887,10 +910,15 @@ void LLVMEngine::CompiledModuleBuilder::Optimize() {
   // provide a nice balance of performance and compilation times. We use an
   // aggressive function inlining pass followed by a CFG simplification pass
   // that should clean up work done during earlier inlining and DCE work.
+  // Cheaper optimization levels skip inlining TPL functions into each other.
+  // The bytecode handlers have already been inlined by Simplify().
   //
 
   llvm::PassManagerBuilder pm_builder;
-  pm_builder.Inliner = llvm::createFunctionInliningPass(3, 0, false);
+  pm_builder.OptLevel = Options().GetOptLevel();
+  if (Options().GetOptLevel() >= 2) {
+    pm_builder.Inliner = llvm::createFunctionInliningPass(3, 0, false);
+  }
 
   //
   // The function optimization passes ...
@@ -918,8 +946,11 @@ void LLVMEngine::CompiledModuleBuilder::Optimize() {
 
   function_pm.doInitialization();
   for (const auto &func_info : TplModule().Functions()) {
+    // Functions that aren't defined in this module may have been removed
     auto *func = Module()->getFunction(func_info.Name());
-    function_pm.run(*func);
+    if (func != nullptr && !func->isDeclaration()) {
+      function_pm.run(*func);
+    }
   }
   function_pm.doFinalization();
 
@@ -964,7 +995,8 @@ std::unique_ptr<llvm::MemoryBuffer> LLVMEngine::CompiledModuleBuilder::EmitObjec
 }
 
 void LLVMEngine::CompiledModuleBuilder::PersistObjectToFile(const llvm::MemoryBuffer &obj_buffer) {
-  const std::string file_name = TplModule().Name() + ".to";
+  const std::string file_name =
+      Options().GetOutputObjectFileName().empty() ? TplModule().Name() + ".to" : Options().GetOutputObjectFileName();
 
   std::error_code error_code;
   llvm::raw_fd_ostream dest(file_name, error_code, llvm::sys::fs::F_None);
@@ -1011,7 +1043,12 @@ LLVMEngine::CompiledModule::CompiledModule(std::unique_ptr<llvm::MemoryBuffer> o
 
 // This destructor is needed because we have a unique_ptr to a forward-declared
 // TPLMemoryManager class.
-LLVMEngine::CompiledModule::~CompiledModule() = default;
+LLVMEngine::CompiledModule::~CompiledModule() {
+  // The unwinder walks the EH frames of all loaded code when an exception is thrown, so they must not outlive the code
+  if (memory_manager_ != nullptr) {
+    memory_manager_->deregisterEHFrames();
+  }
+}
 
 void *LLVMEngine::CompiledModule::GetFunctionPointer(const std::string &name) const {
   TERRIER_ASSERT(IsLoaded(), "Compiled module isn't loaded!");
@@ -1023,12 +1060,17 @@ void *LLVMEngine::CompiledModule::GetFunctionPointer(const std::string &name) co
   return nullptr;
 }
 
-void LLVMEngine::CompiledModule::Load(const BytecodeModule &module) {
+void LLVMEngine::CompiledModule::Load(const BytecodeModule &module,
+                                      const std::unordered_map<std::string, void *> &external_functions) {
   // If already loaded, do nothing
   if (IsLoaded()) {
     return;
   }
 
+  for (const auto &[name, address] : external_functions) {
+    memory_manager_->AddSymbol(name, address);
+  }
+
   //
   // CompiledModules can be created with or without an in-memory object file. If
   // this one was created without an in-memory object file, we need to load it
@@ -1092,6 +1134,189 @@ void LLVMEngine::CompiledModule::Load(const BytecodeModule &module) {
   loaded_ = true;
 }
 
+// ---------------------------------------------------------
+// Compiled Module Cache
+// ---------------------------------------------------------
+
+LLVMEngine::CompiledModuleCache *LLVMEngine::CompiledModuleCache::Instance() {
+  static CompiledModuleCache instance;
+  return &instance;
+}
+
+std::string LLVMEngine::CompiledModuleCache::CacheKey(const BytecodeModule &module) {
+  std::string key;
+  for (const auto &func : module.Functions()) {
+    key += func.Name() + ':' + ast::Type::ToString(func.FuncType()) + '{';
+    for (const auto &local : func.Locals()) {
+      key += local.Name() + ':' + ast::Type::ToString(local.GetType()) + '@' + std::to_string(local.Offset()) + ',';
+    }
+    const auto [start, end] = func.BytecodeRange();
+    key += '}' + std::to_string(start) + '-' + std::to_string(end) + ';';
+  }
+  key.append(reinterpret_cast<const char *>(module.code_.data()), module.code_.size());
+  return key;
+}
+
+bool LLVMEngine::CompiledModuleCache::IsCacheable(const BytecodeModule &module) {
+  // String literals are copied into the query's string allocator, and their address is an operand of InitString and
+  // of the filters comparing a VARCHAR column to a constant
+  for (const auto &func : module.Functions()) {
+    for (auto iter = module.BytecodeForFunction(func); !iter.Done(); iter.Advance()) {
+      switch (iter.CurrentBytecode()) {
+        case Bytecode::InitString:
+        case Bytecode::PCIFilterEqualString:
+        case Bytecode::PCIFilterGreaterThanString:
+        case Bytecode::PCIFilterGreaterThanEqualString:
+        case Bytecode::PCIFilterLessThanString:
+        case Bytecode::PCIFilterLessThanEqualString:
+        case Bytecode::PCIFilterNotEqualString:
+        case Bytecode::PCIFilterPrefix:
+        case Bytecode::PCIFilterLike:
+          return false;
+        default:
+          break;
+      }
+    }
+  }
+  return true;
+}
+
+std::shared_ptr<LLVMEngine::CompiledModule> LLVMEngine::CompiledModuleCache::GetOrCompile(
+    const BytecodeModule &module) {
+  if (!IsCacheable(module)) {
+    std::unique_lock<std::mutex> lock(latch_);
+    CompilerOptions options = options_;
+    lock.unlock();
+    num_uncacheable_.fetch_add(1, std::memory_order_relaxed);
+    return LLVMEngine::Compile(module, options.SetPersistObjectFile(false));
+  }
+
+  std::string key = CacheKey(module);
+
+  std::unique_lock<std::mutex> lock(latch_);
+  if (auto iter = entries_.find(key); iter != entries_.end()) {
+    lru_.splice(lru_.begin(), lru_, iter->second.lru_pos_);
+    auto compiled_module = iter->second.module_;
+    lock.unlock();
+    num_hits_.fetch_add(1, std::memory_order_relaxed);
+    return compiled_module.get();
+  }
+
+  // Miss. Publish the entry before compiling, so that concurrent requests for the same module wait on this
+  // compilation instead of starting their own.
+  if (entries_.size() >= capacity_) {
+    entries_.erase(lru_.back());
+    lru_.pop_back();
+  }
+  std::promise<std::shared_ptr<CompiledModule>> promise;
+  const uint64_t entry_id = next_entry_id_++;
+  lru_.push_front(key);
+  entries_.emplace(key, Entry{promise.get_future().share(), lru_.begin(), entry_id});
+  const CompilerOptions options = options_;
+  lock.unlock();
+
+  num_misses_.fetch_add(1, std::memory_order_relaxed);
+  std::shared_ptr<CompiledModule> compiled_module;
+  try {
+    compiled_module = CompileOrLoad(module, key, options);
+  } catch (...) {
+    // Drop the entry, unless it was evicted in the meantime, so that later requests try again. Requests waiting on it
+    // fail along with this one.
+    lock.lock();
+    if (auto iter = entries_.find(key); iter != entries_.end() && iter->second.id_ == entry_id) {
+      lru_.erase(iter->second.lru_pos_);
+      entries_.erase(iter);
+    }
+    lock.unlock();
+    promise.set_exception(std::current_exception());
+    throw;
+  }
+  promise.set_value(compiled_module);
+  return compiled_module;
+}
+
+bool LLVMEngine::CompiledModuleCache::Contains(const BytecodeModule &module) {
+  const std::string key = CacheKey(module);
+  std::lock_guard<std::mutex> guard(latch_);
+  auto iter = entries_.find(key);
+  return iter != entries_.end() &&
+         iter->second.module_.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+void LLVMEngine::CompiledModuleCache::Clear() {
+  std::lock_guard<std::mutex> guard(latch_);
+  entries_.clear();
+  lru_.clear();
+}
+
+std::string LLVMEngine::CompiledModuleCache::CodeGenStamp(const CompilerOptions &options) {
+  auto handlers = llvm::MemoryBuffer::getFile(options.GetBytecodeHandlersBcPath());
+  if (!handlers) {
+    return "";
+  }
+  const llvm::StringRef handlers_bitcode = handlers.get()->getBuffer();
+  const auto handlers_hash = util::Hasher::Hash<util::HashMethod::xxHash3>(
+      std::string_view(handlers_bitcode.data(), handlers_bitcode.size()));
+
+  std::ostringstream stamp;
+  stamp << "tpl-object-v1"
+        << " handlers:" << std::hex << handlers_hash << std::dec << '/' << handlers_bitcode.size()
+        << " llvm:" << LLVM_VERSION_STRING << " target:" << llvm::sys::getProcessTriple()
+        << " cpu:" << llvm::sys::getHostCPUName().str() << " opt:" << options.GetOptLevel();
+  return stamp.str();
+}
+
+std::shared_ptr<LLVMEngine::CompiledModule> LLVMEngine::CompiledModuleCache::CompileOrLoad(
+    const BytecodeModule &module, const std::string &key, CompilerOptions options) {
+  if (!options.ShouldPersistObjectFile()) {
+    return LLVMEngine::Compile(module, options);
+  }
+
+  // Object files are named after the hash of the key. Next to each one, a key file stores the full key, and what else
+  // the machine code was generated from. The object file is only loaded if both match, so that modules whose keys
+  // collide in 64 bits, and object files persisted by another build, are compiled instead.
+  std::ostringstream base_name;
+  base_name << "tpl_" << std::hex << std::setw(16) << std::setfill('0') << common::HashUtil::Hash(key);
+  const std::string object_file_name = base_name.str() + ".to";
+  const std::string key_file_name = base_name.str() + ".key";
+  const std::string stamp = CodeGenStamp(options);
+  const std::string key_file_contents = stamp + '\n' + key;
+
+  auto key_file = llvm::MemoryBuffer::getFile(key_file_name);
+  if (!stamp.empty() && key_file && key_file.get()->getBuffer() == key_file_contents) {
+    if (auto file_buffer = llvm::MemoryBuffer::getFile(object_file_name); file_buffer) {
+      auto compiled_module = std::make_shared<CompiledModule>(std::move(file_buffer.get()));
+      compiled_module->Load(module);
+      if (compiled_module->IsLoaded()) {
+        num_file_loads_.fetch_add(1, std::memory_order_relaxed);
+        return compiled_module;
+      }
+      EXECUTION_LOG_ERROR("LLVMEngine: Could not load cached object file '{}', recompiling", object_file_name);
+    }
+  } else if (key_file) {
+    EXECUTION_LOG_DEBUG("LLVMEngine: Cached object file '{}' is for another module or build, recompiling",
+                        object_file_name);
+  }
+
+  // The key file goes before the object file is overwritten, and comes back once the new one is complete, so that it
+  // never vouches for an object file it does not describe
+  llvm::sys::fs::remove(key_file_name);
+  options.SetOutputObjectFileName(object_file_name);
+  auto compiled_module = LLVMEngine::Compile(module, options);
+  uint64_t object_file_size = 0;
+  if (!stamp.empty() && compiled_module->IsLoaded() && !llvm::sys::fs::file_size(object_file_name, object_file_size) &&
+      object_file_size == compiled_module->GetModuleObjectCodeSizeInBytes()) {
+    std::error_code error_code;
+    llvm::raw_fd_ostream dest(key_file_name, error_code, llvm::sys::fs::F_None);
+    if (error_code) {
+      EXECUTION_LOG_ERROR("LLVMEngine: Could not write key file '{}': {}", key_file_name, error_code.message());
+    } else {
+      dest.write(key_file_contents.data(), key_file_contents.size());
+    }
+  }
+  return compiled_module;
+}
+
 // ---------------------------------------------------------
 // LLVM Engine
 // ---------------------------------------------------------
@@ -1129,4 +1354,26 @@ std::unique_ptr<LLVMEngine::CompiledModule> LLVMEngine::Compile(const BytecodeMo
   return compiled_module;
 }
 
+std::unique_ptr<LLVMEngine::CompiledModule> LLVMEngine::CompileFunction(
+    const BytecodeModule &module, const FunctionId func_id, const CompilerOptions &options,
+    const std::unordered_map<std::string, void *> &external_functions) {
+  CompiledModuleBuilder builder(options, module);
+
+  builder.DeclareFunctions();
+
+  builder.DefineFunction(func_id);
+
+  builder.Simplify();
+
+  builder.Verify();
+
+  builder.Optimize();
+
+  auto compiled_module = builder.Finalize();
+
+  compiled_module->Load(module, external_functions);
+
+  return compiled_module;
+}
+
 }  // namespace terrier::execution::vm
@@ -2,6 +2,7 @@
 
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <utility>
 
 #include "common/constants.h"
@@ -34,6 +35,24 @@ class Module::AsyncCompileTask : public tbb::task {
   Module *module_;
 };
 
+// This class encapsulates the ability to asynchronously JIT compile a single
+// function of a module.
+class Module::AsyncCompileFunctionTask : public tbb::task {
+ public:
+  // Construct an asynchronous compilation task to compile the given function
+  AsyncCompileFunctionTask(Module *module, FunctionId func_id) : module_(module), func_id_(func_id) {}
+
+  // Execute
+  tbb::task *execute() override {
+    module_->CompileFunctionToMachineCode(func_id_);
+    return nullptr;
+  }
+
+ private:
+  Module *module_;
+  FunctionId func_id_;
+};
+
 // ---------------------------------------------------------
 // Module
 // ---------------------------------------------------------
@@ -44,10 +63,16 @@ Module::Module(std::unique_ptr<BytecodeModule> bytecode_module, std::unique_ptr<
     : bytecode_module_(std::move(bytecode_module)),
       jit_module_(std::move(llvm_module)),
       functions_(std::make_unique<std::atomic<void *>[]>(bytecode_module_->NumFunctions())),
-      bytecode_trampolines_(std::make_unique<Trampoline[]>(bytecode_module_->NumFunctions())) {
+      bytecode_trampolines_(std::make_unique<Trampoline[]>(bytecode_module_->NumFunctions())),
+      hotness_(std::make_unique<std::atomic<uint32_t>[]>(bytecode_module_->NumFunctions())),
+      compile_requested_(std::make_unique<std::atomic<bool>[]>(bytecode_module_->NumFunctions())),
+      vm_callable_(std::make_unique<bool[]>(bytecode_module_->NumFunctions())) {
   // Create the trampolines for all bytecode functions
   for (const auto &func : bytecode_module_->Functions()) {
     CreateFunctionTrampoline(func.Id());
+    hotness_[func.Id()] = 0;
+    compile_requested_[func.Id()] = false;
+    vm_callable_[func.Id()] = VM::CanInvokeCompiledFunction(func);
   }
 
   // If a compiled module wasn't provided, all internal function stubs point to
@@ -68,6 +93,35 @@ Module::Module(std::unique_ptr<BytecodeModule> bytecode_module, std::unique_ptr<
 
 namespace {
 
+// Generates the dispatch stubs of all functions of a module. Each stub jumps
+// to the address the module currently holds for its function, leaving the
+// arguments untouched. Compiled functions call each other through them, so
+// that they pick up newly compiled implementations.
+class DispatchStubGenerator : public Xbyak::CodeGenerator {
+ public:
+  DispatchStubGenerator(std::atomic<void *> *functions, std::size_t num_functions, std::size_t stub_size, void *mem,
+                        std::size_t mem_size)
+      : Xbyak::CodeGenerator(mem_size, mem),
+        functions_(functions),
+        num_functions_(num_functions),
+        stub_size_(stub_size) {}
+
+  void Generate() {
+    static_assert(sizeof(std::atomic<void *>) == sizeof(void *), "Stubs read function addresses as plain pointers");
+    for (std::size_t idx = 0; idx < num_functions_; idx++) {
+      mov(rax, reinterpret_cast<std::size_t>(&functions_[idx]));
+      jmp(ptr[rax]);
+      align(static_cast<int>(stub_size_));
+      TERRIER_ASSERT(getSize() == (idx + 1) * stub_size_, "Dispatch stub does not fit");
+    }
+  }
+
+ private:
+  std::atomic<void *> *functions_;
+  std::size_t num_functions_;
+  std::size_t stub_size_;
+};
+
 // TODO(pmenon): Implement generator for non x86_64 machines
 // TODO(pmenon): Implement generator for Windows
 // TODO(pmenon): Implement non-integer input and output arguments
@@ -199,10 +253,12 @@ class TrampolineGenerator : public Xbyak::CodeGenerator {
       ret_type_size = static_cast<uint32_t>(common::MathUtil::AlignTo(ret_type->Size(), sizeof(intptr_t)));
     }
 
-    // Set up the arguments to VM::InvokeFunction(module, function ID, args)
+    // Set up the arguments to VM::InvokeFunction(module, function ID, args, hand off). Callers through the trampoline
+    // want the function's current implementation, so it hands off to compiled code if the module executes adaptively.
     mov(rdi, reinterpret_cast<std::size_t>(&module_));
     mov(rsi, func_.Id());
     lea(rdx, ptr[rsp + ret_type_size]);
+    mov(ecx, 1);
 
     // Call VM::InvokeFunction()
     mov(rax, reinterpret_cast<std::size_t>(&VM::InvokeFunction));
@@ -274,11 +330,13 @@ void Module::CompileToMachineCode() {
       return;
     }
 
-    // JIT
-    LLVMEngine::CompilerOptions options;
-    jit_module_ = LLVMEngine::Compile(*bytecode_module_, options);
+    // JIT, unless a module with the same bytecode was compiled before
+    auto jit_module = LLVMEngine::CompiledModuleCache::Instance()->GetOrCompile(*bytecode_module_);
 
-    // Setup function pointers
+    // Setup function pointers, replacing functions that were compiled on their
+    // own
+    std::lock_guard<std::mutex> guard(tiering_latch_);
+    jit_module_ = std::move(jit_module);
     for (const auto &func_info : bytecode_module_->Functions()) {
       auto *jit_function = jit_module_->GetFunctionPointer(func_info.Name());
       TERRIER_ASSERT(jit_function != nullptr, "Missing function in compiled module!");
@@ -288,8 +346,87 @@ void Module::CompileToMachineCode() {
 }
 
 void Module::CompileToMachineCodeAsync() {
+  // Fetching cached machine code is cheap enough to do right away, so that the
+  // very first call runs compiled code.
+  if (LLVMEngine::CompiledModuleCache::Instance()->Contains(*bytecode_module_)) {
+    CompileToMachineCode();
+    return;
+  }
+
   auto *compile_task = new (tbb::task::allocate_root()) AsyncCompileTask(this);
   tbb::task::enqueue(*compile_task);
 }
 
+void Module::EnableTiering() {
+  adaptive_.store(true, std::memory_order_relaxed);
+  if (LLVMEngine::CompiledModuleCache::Instance()->Contains(*bytecode_module_)) {
+    CompileToMachineCode();
+    return;
+  }
+  tiering_.store(true, std::memory_order_relaxed);
+}
+
+void Module::CompileFunctionToMachineCode(const FunctionId func_id) {
+  std::call_once(dispatch_stubs_flag_, [this]() { CreateDispatchStubs(); });
+
+  // The function calls the module's other functions through their dispatch
+  // stubs, so it always calls their current implementation.
+  const FunctionInfo *func_info = GetFuncInfoById(func_id);
+  std::unordered_map<std::string, void *> external_functions;
+  for (const auto &other_func_info : bytecode_module_->Functions()) {
+    if (other_func_info.Id() != func_id) {
+      external_functions[other_func_info.Name()] = GetDispatchStub(other_func_info.Id());
+    }
+  }
+
+  LLVMEngine::CompilerOptions options;
+  options.SetOptLevel(K_BASELINE_OPT_LEVEL);
+  auto function_module = LLVMEngine::CompileFunction(*bytecode_module_, func_id, options, external_functions);
+
+  // Swap it in, unless the whole module has been compiled in the meantime
+  if (function_module->IsLoaded()) {
+    if (auto *jit_function = function_module->GetFunctionPointer(func_info->Name()); jit_function != nullptr) {
+      std::lock_guard<std::mutex> guard(tiering_latch_);
+      if (jit_module_ == nullptr) {
+        functions_[func_id].store(jit_function, std::memory_order_relaxed);
+        function_modules_.push_back(std::move(function_module));
+      }
+    }
+  }
+
+  // Now that part of the module runs compiled, fully optimize all of it
+  if (!whole_module_requested_.exchange(true)) {
+    CompileToMachineCodeAsync();
+  }
+}
+
+void Module::CompileFunctionToMachineCodeAsync(const FunctionId func_id) {
+  auto *compile_task = new (tbb::task::allocate_root()) AsyncCompileFunctionTask(this, func_id);
+  tbb::task::enqueue(*compile_task);
+}
+
+void Module::CreateDispatchStubs() {
+  // Allocate memory
+  const std::size_t size =
+      common::MathUtil::AlignTo(bytecode_module_->NumFunctions() * K_DISPATCH_STUB_SIZE, 1 << 12);
+  std::error_code error;
+  uint32_t flags = llvm::sys::Memory::ProtectionFlags::MF_READ | llvm::sys::Memory::ProtectionFlags::MF_WRITE;
+  llvm::sys::MemoryBlock mem = llvm::sys::Memory::allocateMappedMemory(size, nullptr, flags, error);
+  if (error) {
+    EXECUTION_LOG_ERROR("There was an error allocating executable memory {}", error.message());
+    return;
+  }
+
+  // Generate code
+  DispatchStubGenerator generator(functions_.get(), bytecode_module_->NumFunctions(), K_DISPATCH_STUB_SIZE,
+                                  mem.base(), size);
+  generator.Generate();
+
+  // Make the stubs read+exec
+  llvm::sys::Memory::protectMappedMemory(
+      mem, llvm::sys::Memory::ProtectionFlags::MF_READ | llvm::sys::Memory::ProtectionFlags::MF_EXEC);
+
+  dispatch_stubs_ = Trampoline(llvm::sys::OwningMemoryBlock(mem));
+}
+
 }  // namespace terrier::execution::vm
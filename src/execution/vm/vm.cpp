@@ -1,10 +1,14 @@
 #include "execution/vm/vm.h"
 
+#include <algorithm>
+#include <cstring>
 #include <numeric>
 #include <string>
+#include <utility>
 #include <vector>
 #include "execution/sql/projected_columns_iterator.h"
 
+#include "execution/ast/type.h"
 #include "execution/sql/value.h"
 #include "execution/util/execution_common.h"
 #include "execution/util/memory.h"
@@ -15,6 +19,13 @@
 
 namespace terrier::execution::vm {
 
+// Backward jumps are reported to the module in batches of this many, to keep
+// the cost of counting them low
+static constexpr const uint32_t K_BACK_EDGES_PER_REPORT = 256;
+
+// The maximum number of arguments passed in registers
+static constexpr const uint32_t K_MAX_REGISTER_ARGS = 6;
+
 /**
  * An execution frame where all function's local variables and parameters live
  * for the duration of the function's lifetime.
@@ -26,7 +37,8 @@ class VM::Frame {
   /**
    * Constructor
    */
-  Frame(uint8_t *frame_data, std::size_t frame_size) : frame_data_(frame_data), frame_size_(frame_size) {
+  Frame(uint8_t *frame_data, std::size_t frame_size, FunctionId func_id)
+      : frame_data_(frame_data), frame_size_(frame_size), func_id_(func_id) {
     TERRIER_ASSERT(frame_data_ != nullptr, "Frame data cannot be null");
     TERRIER_ASSERT(frame_size_ >= 0, "Frame size must be >= 0");
     (void)frame_size_;
@@ -74,6 +86,10 @@ class VM::Frame {
  private:
   uint8_t *frame_data_;
   std::size_t frame_size_;
+  // The function running in this frame, and the number of backward jumps it
+  // can take before they are reported to the module.
+  FunctionId func_id_;
+  uint32_t back_edges_until_report_{K_BACK_EDGES_PER_REPORT};
 };
 
 // ---------------------------------------------------------
@@ -88,10 +104,94 @@ static constexpr const uint32_t K_MAX_STACK_ALLOC_SIZE = 1ull << 14ull;
 // requires less, use the stack.
 static constexpr const uint32_t K_SOFT_MAX_STACK_ALLOC_SIZE = 1ull << 12ull;
 
-VM::VM(const Module *module) : module_(module) {}
+VM::VM(const Module *module, const bool hand_off) : module_(module), hand_off_(hand_off) {}
+
+#ifdef TPL_DEBUG_TRACE_INSTRUCTIONS
+VM::~VM() {
+  // Log how often each opcode, and each of the most frequent pairs of opcodes, was dispatched
+  for (uint32_t op = 0; op < K_NUM_OPS; op++) {
+    if (bytecode_counts_[op] == 0) continue;
+    EXECUTION_LOG_INFO("{}: {}", Bytecodes::ToString(static_cast<Bytecode>(op)), bytecode_counts_[op]);
+  }
+  std::vector<std::pair<uint32_t, uint64_t>> pairs(bytecode_pair_counts_.begin(), bytecode_pair_counts_.end());
+  std::sort(pairs.begin(), pairs.end(), [](const auto &a, const auto &b) { return a.second > b.second; });
+  constexpr std::size_t k_num_logged_pairs = 32;
+  pairs.resize(std::min(pairs.size(), k_num_logged_pairs));
+  for (const auto &[key, count] : pairs) {
+    EXECUTION_LOG_INFO("{}, {}: {}", Bytecodes::ToString(static_cast<Bytecode>(key / K_NUM_OPS)),
+                       Bytecodes::ToString(static_cast<Bytecode>(key % K_NUM_OPS)), count);
+  }
+}
+#endif
+
+namespace {
+
+// Is the type passed in a general-purpose register?
+bool IsRegisterType(const ast::Type *type) {
+  return type->IsPointerType() || type->IsStringType() ||
+         ((type->IsBoolType() || type->IsIntegerType()) && type->Size() <= sizeof(uint64_t));
+}
+
+}  // namespace
+
+// static
+bool VM::CanInvokeCompiledFunction(const FunctionInfo &func_info) {
+  // Compiled functions returning values up to 8 bytes return them directly,
+  // and take one argument less than the bytecode function. Larger values are
+  // returned through a pointer, which is the first argument of both.
+  const ast::FunctionType *func_type = func_info.FuncType();
+  const ast::Type *ret_type = func_type->ReturnType();
+  if (!ret_type->IsNilType() && ret_type->Size() <= sizeof(uint64_t) && !IsRegisterType(ret_type)) {
+    return false;
+  }
+  const bool direct_return = !ret_type->IsNilType() && ret_type->Size() <= sizeof(uint64_t);
+  const uint32_t num_args = func_info.NumParams() - (direct_return ? 1 : 0);
+  if (num_args > K_MAX_REGISTER_ARGS) {
+    return false;
+  }
+  return std::all_of(func_type->Params().begin(), func_type->Params().end(),
+                     [](const auto &param) { return IsRegisterType(param.type_); });
+}
+
+// static
+bool VM::InvokeCompiledFunction(const Module *module, const FunctionInfo &func_info, const uint8_t *frame_data) {
+  if (!module->IsCallableCompiledImpl(func_info.Id())) {
+    return false;
+  }
+
+  // Load the arguments from the frame, zero-extending them to full registers.
+  // Passing unused registers to a function with fewer arguments is harmless.
+  const ast::Type *ret_type = func_info.FuncType()->ReturnType();
+  const bool direct_return = !ret_type->IsNilType() && ret_type->Size() <= sizeof(uint64_t);
+  const auto &locals = func_info.Locals();
+  uint64_t args[K_MAX_REGISTER_ARGS] = {0};
+  for (uint32_t local_idx = direct_return ? 1 : 0, arg_idx = 0; local_idx < func_info.NumParams();
+       local_idx++, arg_idx++) {
+    std::memcpy(&args[arg_idx], frame_data + locals[local_idx].Offset(), locals[local_idx].Size());
+  }
+
+  using CompiledFn = uint64_t (*)(uint64_t, uint64_t, uint64_t, uint64_t, uint64_t, uint64_t);
+  auto compiled_fn = reinterpret_cast<CompiledFn>(module->GetRawFunctionImpl(func_info.Id()));
+  const uint64_t ret = compiled_fn(args[0], args[1], args[2], args[3], args[4], args[5]);
+
+  // Store a directly returned value where the bytecode function would have
+  if (direct_return) {
+    void *ret_dest;
+    std::memcpy(&ret_dest, frame_data + locals[0].Offset(), sizeof(ret_dest));
+    std::memcpy(ret_dest, &ret, ret_type->Size());
+  }
+  return true;
+}
+
+inline void VM::RecordBackEdge(Frame *frame) {
+  if (UNLIKELY(--frame->back_edges_until_report_ == 0)) {
+    frame->back_edges_until_report_ = K_BACK_EDGES_PER_REPORT;
+    module_->RecordExecutions(frame->func_id_, K_BACK_EDGES_PER_REPORT);
+  }
+}
 
 // static
-void VM::InvokeFunction(const Module *module, const FunctionId func_id, const uint8_t args[]) {
+void VM::InvokeFunction(const Module *module, const FunctionId func_id, const uint8_t args[], bool hand_off) {
   // The function's info
   const FunctionInfo *func_info = module->GetFuncInfoById(func_id);
   TERRIER_ASSERT(func_info != nullptr, "Function doesn't exist in module!");
@@ -112,15 +212,27 @@ void VM::InvokeFunction(const Module *module, const FunctionId func_id, const ui
   // Copy args into frame
   std::memcpy(raw_frame + func_info->ParamsStartPos(), args, func_info->ParamsSize());
 
+  // Hand off to compiled code, if there is some by now
+  hand_off = hand_off && module->IsAdaptive();
+  if (hand_off) {
+    module->RecordExecutions(func_id, 1);
+  }
+  if (hand_off && InvokeCompiledFunction(module, *func_info, raw_frame)) {
+    if (used_heap) {
+      std::free(raw_frame);
+    }
+    return;
+  }
+
   EXECUTION_LOG_DEBUG("Executing function '{}'", func_info->Name());
 
   // Let's go. First, create the virtual machine instance.
-  VM vm(module);
+  VM vm(module, hand_off);
 
   // Now get the bytecode for the function and fire it off
   const uint8_t *bytecode = module->GetBytecodeModule()->GetBytecodeForFunction(*func_info);
   TERRIER_ASSERT(bytecode != nullptr, "Bytecode cannot be null");
-  Frame frame(raw_frame, frame_size);
+  Frame frame(raw_frame, frame_size, func_id);
   vm.Interpret(bytecode, &frame);
 
   // Cleanup
@@ -155,7 +267,7 @@ inline ALWAYS_INLINE T Peek(const uint8_t **ip) {
 void VM::Interpret(const uint8_t *ip, Frame *frame) {
   static void *kDispatchTable[] = {
 #define ENTRY(name, ...) &&op_##name,
-      BYTECODE_LIST(ENTRY)
+      BYTECODE_LIST(ENTRY) SUPERINSTRUCTION_LIST(ENTRY)
 #undef ENTRY
   };
 
@@ -164,6 +276,8 @@ void VM::Interpret(const uint8_t *ip, Frame *frame) {
   do {                                                                                                                \
     auto bytecode = Bytecodes::FromByte(op);                                                                          \
     bytecode_counts_[op]++;                                                                                           \
+    if (last_bytecode_ < K_NUM_OPS) bytecode_pair_counts_[PairKey(last_bytecode_, op)]++;                             \
+    last_bytecode_ = op;                                                                                              \
     EXECUTION_LOG_INFO("{0:p}: {1:s}", ip - sizeof(std::underlying_type_t<Bytecode>), Bytecodes::ToString(bytecode)); \
   } while (false)
 #else
@@ -313,6 +427,7 @@ void VM::Interpret(const uint8_t *ip, Frame *frame) {
   OP(Jump) : {
     auto skip = PEEK_JMP_OFFSET();
     if (LIKELY(OpJump())) {
+      if (skip < 0) RecordBackEdge(frame);
       ip += skip;
     }
     DISPATCH_NEXT();
@@ -322,6 +437,7 @@ void VM::Interpret(const uint8_t *ip, Frame *frame) {
     auto cond = frame->LocalAt<bool>(READ_LOCAL_ID());
     auto skip = PEEK_JMP_OFFSET();
     if (OpJumpIfTrue(cond)) {
+      if (skip < 0) RecordBackEdge(frame);
       ip += skip;
     } else {
       READ_JMP_OFFSET();
@@ -333,6 +449,7 @@ void VM::Interpret(const uint8_t *ip, Frame *frame) {
     auto cond = frame->LocalAt<bool>(READ_LOCAL_ID());
     auto skip = PEEK_JMP_OFFSET();
     if (OpJumpIfFalse(cond)) {
+      if (skip < 0) RecordBackEdge(frame);
       ip += skip;
     } else {
       READ_JMP_OFFSET();
@@ -527,14 +644,16 @@ void VM::Interpret(const uint8_t *ip, Frame *frame) {
   }
 
   OP(ParallelScanTable) : {
-    auto db_oid = READ_UIMM4();
     auto table_oid = READ_UIMM4();
+    auto col_oids = frame->LocalAt<uint32_t *>(READ_LOCAL_ID());
+    auto num_oids = READ_UIMM4();
     auto query_state = frame->LocalAt<void *>(READ_LOCAL_ID());
+    auto exec_ctx = frame->LocalAt<exec::ExecutionContext *>(READ_LOCAL_ID());
     auto thread_state_container = frame->LocalAt<sql::ThreadStateContainer *>(READ_LOCAL_ID());
     auto scan_fn_id = READ_FUNC_ID();
 
     auto scan_fn = reinterpret_cast<sql::TableVectorIterator::ScanFn>(module_->GetRawFunctionImpl(scan_fn_id));
-    OpParallelScanTable(db_oid, table_oid, query_state, thread_state_container, scan_fn);
+    OpParallelScanTable(table_oid, col_oids, num_oids, query_state, exec_ctx, thread_state_container, scan_fn);
     DISPATCH_NEXT();
   }
 
@@ -631,7 +750,28 @@ void VM::Interpret(const uint8_t *ip, Frame *frame) {
     auto col_idx = READ_UIMM4();                                                   \
     auto type = READ_IMM1();                                                       \
     auto val = READ_IMM8();                                                        \
-    OpPCIFilter##Op(size, iter, col_idx, type, val);                               \
+    auto nullable = READ_IMM1();                                                   \
+    OpPCIFilter##Op(size, iter, col_idx, type, val, nullable);                     \
+    DISPATCH_NEXT();                                                               \
+  }                                                                                \
+  OP(PCIFilter##Op##Real) : {                                                      \
+    auto *size = frame->LocalAt<uint64_t *>(READ_LOCAL_ID());                      \
+    auto *iter = frame->LocalAt<sql::ProjectedColumnsIterator *>(READ_LOCAL_ID()); \
+    auto col_idx = READ_UIMM4();                                                   \
+    auto type = READ_IMM1();                                                       \
+    auto val = READ_IMM8F();                                                       \
+    auto nullable = READ_IMM1();                                                   \
+    OpPCIFilter##Op##Real(size, iter, col_idx, type, val, nullable);               \
+    DISPATCH_NEXT();                                                               \
+  }                                                                                \
+  OP(PCIFilter##Op##String) : {                                                    \
+    auto *size = frame->LocalAt<uint64_t *>(READ_LOCAL_ID());                      \
+    auto *iter = frame->LocalAt<sql::ProjectedColumnsIterator *>(READ_LOCAL_ID()); \
+    auto col_idx = READ_UIMM4();                                                   \
+    auto length = READ_IMM8();                                                     \
+    auto data = READ_IMM8();                                                       \
+    auto nullable = READ_IMM1();                                                   \
+    OpPCIFilter##Op##String(size, iter, col_idx, length, data, nullable);          \
     DISPATCH_NEXT();                                                               \
   }
   GEN_PCI_FILTER(Equal)
@@ -642,6 +782,33 @@ void VM::Interpret(const uint8_t *ip, Frame *frame) {
   GEN_PCI_FILTER(NotEqual)
 #undef GEN_PCI_FILTER
 
+#define GEN_PCI_STRING_FILTER(Op)                                                  \
+  OP(PCIFilter##Op) : {                                                            \
+    auto *size = frame->LocalAt<uint64_t *>(READ_LOCAL_ID());                      \
+    auto *iter = frame->LocalAt<sql::ProjectedColumnsIterator *>(READ_LOCAL_ID()); \
+    auto col_idx = READ_UIMM4();                                                   \
+    auto length = READ_IMM8();                                                     \
+    auto data = READ_IMM8();                                                       \
+    auto nullable = READ_IMM1();                                                   \
+    OpPCIFilter##Op(size, iter, col_idx, length, data, nullable);                  \
+    DISPATCH_NEXT();                                                               \
+  }
+  GEN_PCI_STRING_FILTER(Prefix)
+  GEN_PCI_STRING_FILTER(Like)
+#undef GEN_PCI_STRING_FILTER
+
+#define GEN_PCI_NULL_FILTER(Op)                                                    \
+  OP(PCIFilter##Op) : {                                                            \
+    auto *size = frame->LocalAt<uint64_t *>(READ_LOCAL_ID());                      \
+    auto *iter = frame->LocalAt<sql::ProjectedColumnsIterator *>(READ_LOCAL_ID()); \
+    auto col_idx = READ_UIMM4();                                                   \
+    OpPCIFilter##Op(size, iter, col_idx);                                          \
+    DISPATCH_NEXT();                                                               \
+  }
+  GEN_PCI_NULL_FILTER(Null)
+  GEN_PCI_NULL_FILTER(NotNull)
+#undef GEN_PCI_NULL_FILTER
+
   // ------------------------------------------------------
   // Hashing
   // ------------------------------------------------------
@@ -698,6 +865,15 @@ void VM::Interpret(const uint8_t *ip, Frame *frame) {
     DISPATCH_NEXT();
   }
 
+  OP(FilterManagerInsertJoinFilter) : {
+    auto *filter_manager = frame->LocalAt<sql::FilterManager *>(READ_LOCAL_ID());
+    auto *join_hash_table = frame->LocalAt<sql::JoinHashTable *>(READ_LOCAL_ID());
+    auto func_id = READ_FUNC_ID();
+    auto fn = reinterpret_cast<sql::FilterManager::HashFn>(module_->GetRawFunctionImpl(func_id));
+    OpFilterManagerInsertJoinFilter(filter_manager, join_hash_table, fn);
+    DISPATCH_NEXT();
+  }
+
   OP(FilterManagerFinalize) : {
     auto *filter_manager = frame->LocalAt<sql::FilterManager *>(READ_LOCAL_ID());
     OpFilterManagerFinalize(filter_manager);
@@ -1401,6 +1577,25 @@ void VM::Interpret(const uint8_t *ip, Frame *frame) {
     DISPATCH_NEXT();
   }
 
+  OP(IndexIteratorAddBatchKey) : {
+    auto *iter = frame->LocalAt<sql::IndexIterator *>(READ_LOCAL_ID());
+    OpIndexIteratorAddBatchKey(iter);
+    DISPATCH_NEXT();
+  }
+
+  OP(IndexIteratorScanKeyBatch) : {
+    auto *iter = frame->LocalAt<sql::IndexIterator *>(READ_LOCAL_ID());
+    OpIndexIteratorScanKeyBatch(iter);
+    DISPATCH_NEXT();
+  }
+
+  OP(IndexIteratorNextBatchKey) : {
+    auto *has_more = frame->LocalAt<bool *>(READ_LOCAL_ID());
+    auto *iter = frame->LocalAt<sql::IndexIterator *>(READ_LOCAL_ID());
+    OpIndexIteratorNextBatchKey(has_more, iter);
+    DISPATCH_NEXT();
+  }
+
   // -------------------------------------------------------
   // IndexIterator element access
   // -------------------------------------------------------
@@ -1657,6 +1852,117 @@ void VM::Interpret(const uint8_t *ip, Frame *frame) {
     DISPATCH_NEXT();
   }
 
+  // -------------------------------------------------------
+  // Superinstructions
+  // -------------------------------------------------------
+
+  // A superinstruction runs the bytecodes it fuses one after the other,
+  // reading their operands where they were emitted, but saves dispatching all
+  // but the first. Results handed from one bytecode to the next are kept in
+  // registers rather than reloaded from the frame.
+
+#define SKIP_OP() (void)READ_OP()
+#define FUSED_JUMP_IF_FALSE(cond)          \
+  do {                                     \
+    SKIP_OP();                             \
+    (void)READ_LOCAL_ID();                 \
+    auto skip = PEEK_JMP_OFFSET();         \
+    if (OpJumpIfFalse(cond)) {             \
+      if (skip < 0) RecordBackEdge(frame); \
+      ip += skip;                          \
+    } else {                               \
+      READ_JMP_OFFSET();                   \
+    }                                      \
+  } while (false)
+
+  OP(TableVectorIteratorNext_JumpIfFalse) : {
+    auto *has_more = frame->LocalAt<bool *>(READ_LOCAL_ID());
+    auto *iter = frame->LocalAt<sql::TableVectorIterator *>(READ_LOCAL_ID());
+    OpTableVectorIteratorNext(has_more, iter);
+    FUSED_JUMP_IF_FALSE(*has_more);
+    DISPATCH_NEXT();
+  }
+
+  OP(PCIHasNext_JumpIfFalse) : {
+    auto *has_more = frame->LocalAt<bool *>(READ_LOCAL_ID());
+    auto *iter = frame->LocalAt<sql::ProjectedColumnsIterator *>(READ_LOCAL_ID());
+    OpPCIHasNext(has_more, iter);
+    FUSED_JUMP_IF_FALSE(*has_more);
+    DISPATCH_NEXT();
+  }
+
+  OP(PCIHasNextFiltered_JumpIfFalse) : {
+    auto *has_more = frame->LocalAt<bool *>(READ_LOCAL_ID());
+    auto *iter = frame->LocalAt<sql::ProjectedColumnsIterator *>(READ_LOCAL_ID());
+    OpPCIHasNextFiltered(has_more, iter);
+    FUSED_JUMP_IF_FALSE(*has_more);
+    DISPATCH_NEXT();
+  }
+
+#define DO_GEN_COMPARISON_JUMP(op, type)                  \
+  OP(op##_##type##_JumpIfFalse) : {                       \
+    auto *dest = frame->LocalAt<bool *>(READ_LOCAL_ID()); \
+    auto lhs = frame->LocalAt<type>(READ_LOCAL_ID());     \
+    auto rhs = frame->LocalAt<type>(READ_LOCAL_ID());     \
+    Op##op##_##type(dest, lhs, rhs);                      \
+    FUSED_JUMP_IF_FALSE(*dest);                           \
+    DISPATCH_NEXT();                                      \
+  }
+#define GEN_COMPARISON_JUMP_TYPES(type, ...)     \
+  DO_GEN_COMPARISON_JUMP(GreaterThan, type)      \
+  DO_GEN_COMPARISON_JUMP(GreaterThanEqual, type) \
+  DO_GEN_COMPARISON_JUMP(Equal, type)            \
+  DO_GEN_COMPARISON_JUMP(LessThan, type)         \
+  DO_GEN_COMPARISON_JUMP(LessThanEqual, type)    \
+  DO_GEN_COMPARISON_JUMP(NotEqual, type)
+
+  INT_TYPES(GEN_COMPARISON_JUMP_TYPES)
+#undef GEN_COMPARISON_JUMP_TYPES
+#undef DO_GEN_COMPARISON_JUMP
+
+#define GEN_CMP_JUMP(op)                                            \
+  OP(op##Integer_JumpIfFalse) : {                                   \
+    auto *result = frame->LocalAt<sql::BoolVal *>(READ_LOCAL_ID()); \
+    auto *left = frame->LocalAt<sql::Integer *>(READ_LOCAL_ID());   \
+    auto *right = frame->LocalAt<sql::Integer *>(READ_LOCAL_ID());  \
+    Op##op##Integer(result, left, right);                           \
+    SKIP_OP();                                                      \
+    auto *truth = frame->LocalAt<bool *>(READ_LOCAL_ID());          \
+    (void)READ_LOCAL_ID();                                          \
+    OpForceBoolTruth(truth, result);                                \
+    FUSED_JUMP_IF_FALSE(*truth);                                    \
+    DISPATCH_NEXT();                                                \
+  }
+  GEN_CMP_JUMP(GreaterThan);
+  GEN_CMP_JUMP(GreaterThanEqual);
+  GEN_CMP_JUMP(Equal);
+  GEN_CMP_JUMP(LessThan);
+  GEN_CMP_JUMP(LessThanEqual);
+  GEN_CMP_JUMP(NotEqual);
+#undef GEN_CMP_JUMP
+
+#define DO_GEN_IMM_ARITHMETIC_OP(op, type)                       \
+  OP(AssignImm8_##op##_##type) : {                               \
+    auto *imm_dest = frame->LocalAt<int64_t *>(READ_LOCAL_ID()); \
+    OpAssignImm8(imm_dest, READ_IMM8());                         \
+    SKIP_OP();                                                   \
+    auto *dest = frame->LocalAt<type *>(READ_LOCAL_ID());        \
+    auto lhs = frame->LocalAt<type>(READ_LOCAL_ID());            \
+    auto rhs = frame->LocalAt<type>(READ_LOCAL_ID());            \
+    Op##op##_##type(dest, lhs, rhs);                             \
+    DISPATCH_NEXT();                                             \
+  }
+#define GEN_IMM_ARITHMETIC_OP(type, ...) \
+  DO_GEN_IMM_ARITHMETIC_OP(Add, type)    \
+  DO_GEN_IMM_ARITHMETIC_OP(Sub, type)
+
+  INT_TYPES(GEN_IMM_ARITHMETIC_OP)
+#undef GEN_IMM_ARITHMETIC_OP
+#undef DO_GEN_IMM_ARITHMETIC_OP
+
+#undef FUSED_JUMP_IF_FALSE
+#undef SKIP_OP
+
   // Impossible
   UNREACHABLE("Impossible to reach end of interpreter loop. Bad code!");
 }  // NOLINT (function is too long)
@@ -1691,13 +1997,19 @@ const uint8_t *VM::ExecuteCall(const uint8_t *ip, VM::Frame *caller) {
     std::memcpy(raw_frame + param_info.Offset(), &param, param_info.Size());
   }
 
-  EXECUTION_LOG_DEBUG("Executing function '{}'", func_info->Name());
+  // Hand off to compiled code, if there is some by now
+  if (hand_off_) {
+    module_->RecordExecutions(func_id, 1);
+  }
+  if (!hand_off_ || !InvokeCompiledFunction(module_, *func_info, raw_frame)) {
+    EXECUTION_LOG_DEBUG("Executing function '{}'", func_info->Name());
 
-  // Let's go
-  const uint8_t *bytecode = module_->GetBytecodeModule()->GetBytecodeForFunction(*func_info);
-  TERRIER_ASSERT(bytecode != nullptr, "Bytecode cannot be null");
-  VM::Frame callee(raw_frame, func_info->FrameSize());
-  Interpret(bytecode, &callee);
+    // Let's go
+    const uint8_t *bytecode = module_->GetBytecodeModule()->GetBytecodeForFunction(*func_info);
+    TERRIER_ASSERT(bytecode != nullptr, "Bytecode cannot be null");
+    VM::Frame callee(raw_frame, func_info->FrameSize(), func_id);
+    Interpret(bytecode, &callee);
+  }
 
   if (used_heap) {
     std::free(raw_frame);
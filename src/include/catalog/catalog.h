@@ -109,6 +109,7 @@ class Catalog {
   std::unique_ptr<CatalogAccessor> GetAccessor(transaction::TransactionContext *txn, db_oid_t database);
 
  private:
+  friend class storage::CheckpointManager;
   friend class storage::RecoveryManager;
   transaction::TransactionManager *txn_manager_;
   storage::BlockStore *catalog_block_store_;
@@ -19,6 +19,7 @@ class StorageTestUtil;
 }
 
 namespace terrier::storage {
+class CheckpointManager;
 class RecoveryManager;
 }
 
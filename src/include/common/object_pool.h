@@ -1,9 +1,12 @@
 #pragma once
 
+#include <atomic>
 #include <queue>
 #include <string>
 #include <utility>
+#include <vector>
 #include "common/allocator.h"
+#include "common/constants.h"
 #include "common/container/concurrent_queue.h"
 #include "common/spin_latch.h"
 #include "common/strong_typedef.h"
@@ -52,6 +55,13 @@ class AllocatorFailureException : public std::exception {
  *
  * This prevents liberal calls to malloc and new in the code and makes tracking
  * our memory performance easier.
+ *
+ * Released objects are cached in a small number of magazines in front of the
+ * shared reuse queue, and every thread sticks to its own magazine. Most Get and
+ * Release calls thus only touch a latch nobody else is likely to hold, and only
+ * go to the shared queue to move objects in batches. Cached objects count
+ * towards the reuse limit, and new objects are only ever allocated from the
+ * shared queue, so the size limit holds just the same.
  * @tparam T the type of objects in the pool.
  * @tparam The allocator to use when constructing and destructing a new object.
  *         In most cases it can be left out and the default allocator will
@@ -83,6 +93,9 @@ class ObjectPool {
    * not explicitly released via a Release call.
    */
   ~ObjectPool() {
+    for (auto &magazine : magazines_) {
+      for (T *obj : magazine.objects_) alloc_.Delete(obj);
+    }
     T *result = nullptr;
     while (!reuse_queue_.empty()) {
       result = reuse_queue_.front();
@@ -98,20 +111,25 @@ class ObjectPool {
    * @return pointer to memory that can hold T
    */
   T *Get() {
-    SpinLatch::ScopedSpinLatch guard(&latch_);
-    if (reuse_queue_.empty() && current_size_ >= size_limit_) throw NoMoreObjectException(size_limit_);
+    Magazine &magazine = magazines_[ThreadMagazine()];
     T *result = nullptr;
-    if (reuse_queue_.empty()) {
-      result = alloc_.New();  // result could be null because the allocator may not find enough memory space
-      if (result != nullptr) current_size_++;
-    } else {
-      result = reuse_queue_.front();
-      reuse_queue_.pop();
-      alloc_.Reuse(result);
+    {
+      SpinLatch::ScopedSpinLatch magazine_guard(&magazine.latch_);
+      if (magazine.objects_.empty()) {
+        result = Refill(&magazine);
+        // Objects fresh from the allocator need not be reused
+        if (result != nullptr) return result;
+      }
+      if (!magazine.objects_.empty()) {
+        result = magazine.objects_.back();
+        magazine.objects_.pop_back();
+        num_reusable_--;
+      }
     }
-    // If result is nullptr. The call to alloc_.New() failed (i.e. can't allocate more memory from the system).
-    if (result == nullptr) throw AllocatorFailureException();
-    TERRIER_ASSERT(current_size_ <= size_limit_, "Object pool has exceeded its size limit.");
+    // The size limit is reached, but other threads may still be holding on to objects they could give us
+    if (result == nullptr) result = Steal();
+    if (result == nullptr) throw NoMoreObjectException(size_limit_);
+    alloc_.Reuse(result);
     return result;
   }
 
@@ -151,14 +169,22 @@ class ObjectPool {
    * @param new_reuse_limit
    */
   void SetReuseLimit(uint64_t new_reuse_limit) {
-    SpinLatch::ScopedSpinLatch guard(&latch_);
     reuse_limit_ = new_reuse_limit;
+    // Flush all the magazines so that the objects over the limit can be found in the reuse queue
+    for (auto &magazine : magazines_) {
+      SpinLatch::ScopedSpinLatch magazine_guard(&magazine.latch_);
+      SpinLatch::ScopedSpinLatch guard(&latch_);
+      for (T *obj : magazine.objects_) reuse_queue_.push(obj);
+      magazine.objects_.clear();
+    }
+    SpinLatch::ScopedSpinLatch guard(&latch_);
     T *obj = nullptr;
     while (reuse_queue_.size() > reuse_limit_) {
       obj = reuse_queue_.front();
       alloc_.Delete(obj);
       reuse_queue_.pop();
       current_size_--;
+      num_reusable_--;
     }
   }
 
@@ -171,12 +197,21 @@ class ObjectPool {
    */
   void Release(T *obj) {
     TERRIER_ASSERT(obj != nullptr, "releasing a null pointer");
-    SpinLatch::ScopedSpinLatch guard(&latch_);
-    if (reuse_queue_.size() >= reuse_limit_) {
+    if (num_reusable_++ >= reuse_limit_) {
+      num_reusable_--;
+      SpinLatch::ScopedSpinLatch guard(&latch_);
       alloc_.Delete(obj);
       current_size_--;
-    } else {
-      reuse_queue_.push(obj);
+      return;
+    }
+    Magazine &magazine = magazines_[ThreadMagazine()];
+    SpinLatch::ScopedSpinLatch magazine_guard(&magazine.latch_);
+    magazine.objects_.push_back(obj);
+    if (magazine.objects_.size() > MAGAZINE_SIZE) {
+      // Hand the oldest half over to everyone else
+      SpinLatch::ScopedSpinLatch guard(&latch_);
+      for (uint32_t i = 0; i < MAGAZINE_BATCH_SIZE; i++) reuse_queue_.push(magazine.objects_[i]);
+      magazine.objects_.erase(magazine.objects_.begin(), magazine.objects_.begin() + MAGAZINE_BATCH_SIZE);
     }
   }
 
@@ -186,13 +221,65 @@ class ObjectPool {
   uint64_t GetSizeLimit() const { return size_limit_; }
 
  private:
+  // Number of magazines in front of the reuse queue. Threads beyond this many share magazines.
+  static constexpr uint32_t NUM_MAGAZINES = 16;
+  // Number of objects a magazine holds before it hands a batch over to the reuse queue
+  static constexpr uint32_t MAGAZINE_SIZE = 32;
+  // Number of objects moved between a magazine and the reuse queue at once
+  static constexpr uint32_t MAGAZINE_BATCH_SIZE = MAGAZINE_SIZE / 2;
+
+  struct alignas(Constants::CACHELINE_SIZE) Magazine {
+    SpinLatch latch_;
+    std::vector<T *> objects_;
+  };
+
+  // Every thread starts out at its own magazine, so that threads rarely compete for one
+  static uint32_t ThreadMagazine() {
+    static std::atomic<uint32_t> next_thread_magazine{0};
+    static thread_local const uint32_t thread_magazine = next_thread_magazine++ % NUM_MAGAZINES;
+    return thread_magazine;
+  }
+
+  // Fills an empty magazine with a batch from the reuse queue. If there is nothing to reuse, returns a newly allocated
+  // object instead, or nullptr if the size limit is reached. Called with the magazine latched.
+  T *Refill(Magazine *const magazine) {
+    SpinLatch::ScopedSpinLatch guard(&latch_);
+    for (uint32_t i = 0; i < MAGAZINE_BATCH_SIZE && !reuse_queue_.empty(); i++) {
+      magazine->objects_.push_back(reuse_queue_.front());
+      reuse_queue_.pop();
+    }
+    if (!magazine->objects_.empty() || current_size_ >= size_limit_) return nullptr;
+    // result could be null because the allocator may not find enough memory space
+    T *result = alloc_.New();
+    if (result == nullptr) throw AllocatorFailureException();
+    current_size_++;
+    TERRIER_ASSERT(current_size_ <= size_limit_, "Object pool has exceeded its size limit.");
+    return result;
+  }
+
+  // Takes a cached object from any magazine, or returns nullptr if there is none
+  T *Steal() {
+    if (num_reusable_.load() == 0) return nullptr;
+    for (auto &magazine : magazines_) {
+      SpinLatch::ScopedSpinLatch magazine_guard(&magazine.latch_);
+      if (magazine.objects_.empty()) continue;
+      T *result = magazine.objects_.back();
+      magazine.objects_.pop_back();
+      num_reusable_--;
+      return result;
+    }
+    return nullptr;
+  }
+
   Allocator alloc_;
   SpinLatch latch_;
   // TODO(yangjuns): We don't need to reuse objects in a FIFO pattern. We could potentially pass a second template
   // parameter to define the backing container for the std::queue. That way we can measure each backing container.
   std::queue<T *> reuse_queue_;
-  uint64_t size_limit_;   // the maximum number of objects a object pool can have
-  uint64_t reuse_limit_;  // the maximum number of reusable objects in reuse_queue
+  Magazine magazines_[NUM_MAGAZINES];
+  uint64_t size_limit_;                    // the maximum number of objects a object pool can have
+  std::atomic<uint64_t> reuse_limit_;      // the maximum number of reusable objects in reuse_queue and the magazines
+  std::atomic<uint64_t> num_reusable_{0};  // the number of objects in reuse_queue and the magazines
   // current_size_ represents the number of objects the object pool has allocated,
   // including objects that have been given out to callers and those reside in reuse_queue
   uint64_t current_size_;
@@ -349,6 +349,18 @@ struct atomic<terrier::common::StrongTypeAlias<Tag, IntType>> {
     return t(result);
   }
 
+  /**
+   * Atomically adds to the underlying value. The operation is read-modify-write operation.
+   * Memory is affected according to the value of order.
+   * @param arg the value to add.
+   * @param order memory order constraints to enforce.
+   * @return The value of the atomic variable before the call.
+   */
+  // NOLINTNEXTLINE
+  t fetch_add(IntType arg, memory_order order = memory_order_seq_cst) volatile noexcept {
+    return t(underlying_.fetch_add(arg, order));
+  }
+
  private:
   atomic<IntType> underlying_;
 };
@@ -120,6 +120,28 @@ class WorkerPool {
     finished_cv_.wait(lock, [&] { return busy_workers_ == 0 && task_queue_.empty(); });
   }
 
+  /**
+   * Submit the given tasks and block until they have been completed. Unlike WaitUntilAllFinished(), this does not wait
+   * for unrelated tasks, so it is safe on a pool shared with other work. It must not be called from a task in this
+   * pool, as it blocks a worker while waiting on the others.
+   *
+   * @param tasks the tasks to run
+   */
+  void RunTasksAndWait(const std::vector<std::function<void()>> &tasks) {
+    std::mutex pending_lock;
+    std::condition_variable pending_cv;
+    uint64_t num_pending = tasks.size();
+    for (const auto &task : tasks) {
+      SubmitTask([&, task] {
+        task();
+        std::lock_guard<std::mutex> lock(pending_lock);
+        if (--num_pending == 0) pending_cv.notify_all();
+      });
+    }
+    std::unique_lock<std::mutex> lock(pending_lock);
+    pending_cv.wait(lock, [&] { return num_pending == 0; });
+  }
+
   /**
    * Get the number of worker threads in this pool
    *
@@ -23,6 +23,10 @@ namespace terrier::execution::ast {
   F(FilterLe, filterLe)                                               \
   F(FilterLt, filterLt)                                               \
   F(FilterNe, filterNe)                                               \
+  F(FilterPrefix, filterPrefix)                                       \
+  F(FilterLike, filterLike)                                           \
+  F(FilterNull, filterNull)                                           \
+  F(FilterNotNull, filterNotNull)                                     \
                                                                       \
   /* Thread State Container */                                        \
   F(ExecutionContextGetMemoryPool, execCtxGetMem)                     \
@@ -71,6 +75,7 @@ namespace terrier::execution::ast {
   /* Filter Manager */                                                \
   F(FilterManagerInit, filterManagerInit)                             \
   F(FilterManagerInsertFilter, filterManagerInsertFilter)             \
+  F(FilterManagerInsertJoinFilter, filterManagerInsertJoinFilter)     \
   F(FilterManagerFinalize, filterManagerFinalize)                     \
   F(FilterManagerRunFilters, filtersRun)                              \
   F(FilterManagerFree, filterManagerFree)                             \
@@ -145,6 +150,9 @@ namespace terrier::execution::ast {
   F(IndexIteratorInitBind, indexIteratorInitBind)                     \
   F(IndexIteratorScanKey, indexIteratorScanKey)                       \
   F(IndexIteratorAdvance, indexIteratorAdvance)                       \
+  F(IndexIteratorAddBatchKey, indexIteratorAddBatchKey)               \
+  F(IndexIteratorScanKeyBatch, indexIteratorScanKeyBatch)             \
+  F(IndexIteratorNextBatchKey, indexIteratorNextBatchKey)             \
   F(IndexIteratorGetTinyInt, indexIteratorGetTinyInt)                 \
   F(IndexIteratorGetSmallInt, indexIteratorGetSmallInt)               \
   F(IndexIteratorGetInt, indexIteratorGetInt)                         \
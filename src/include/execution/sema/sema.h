@@ -118,7 +118,7 @@ class Sema : public ast::AstVisitor<Sema> {
   void CheckBuiltinCall(ast::CallExpr *call);
   void CheckBuiltinMapCall(ast::CallExpr *call);
   void CheckBuiltinSqlConversionCall(ast::CallExpr *call, ast::Builtin builtin);
-  void CheckBuiltinFilterCall(ast::CallExpr *call);
+  void CheckBuiltinFilterCall(ast::CallExpr *call, ast::Builtin builtin);
   void CheckBuiltinAggHashTableCall(ast::CallExpr *call, ast::Builtin builtin);
   void CheckBuiltinAggHashTableIterCall(ast::CallExpr *call, ast::Builtin builtin);
   void CheckBuiltinAggPartIterCall(ast::CallExpr *call, ast::Builtin builtin);
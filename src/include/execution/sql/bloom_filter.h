@@ -65,7 +65,8 @@ class BloomFilter {
   ~BloomFilter();
 
   /**
-   * Initialize this bloom filter with the given size
+   * Initialize this bloom filter with the given size, releasing the memory of
+   * any earlier initialization
    * @param memory The allocator where this filter's memory is sourced from
    * @param num_elems The expected number of elements
    */
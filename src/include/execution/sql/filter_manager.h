@@ -5,11 +5,14 @@
 #include <vector>
 
 #include "common/macros.h"
+#include "common/strong_typedef.h"
 #include "execution/bandit/policy.h"
 #include "execution/util/execution_common.h"
+#include "execution/util/timer.h"
 
 namespace terrier::execution::sql {
 
+class BloomFilter;
 class ProjectedColumnsIterator;
 
 /**
@@ -24,10 +27,30 @@ class EXPORT FilterManager {
    */
   using MatchFn = uint32_t (*)(ProjectedColumnsIterator *);
 
+  /**
+   * A function computing the hash of the join key of the tuple the input
+   * projection is currently positioned at.
+   */
+  using HashFn = hash_t (*)(ProjectedColumnsIterator *);
+
+  /**
+   * The flavor of a join filter clause that probes the bloom filter
+   */
+  static constexpr uint32_t K_APPLY_JOIN_FILTER = 0;
+
+  /**
+   * The flavor of a join filter clause that lets all tuples through
+   */
+  static constexpr uint32_t K_SKIP_JOIN_FILTER = 1;
+
   /**
    * A clause in a multi-clause filter. Clauses come in multiple flavors.
    * Flavors are logically equivalent, but may differ in implementation, and
    * thus, exhibit different runtimes.
+   *
+   * A join filter clause instead has exactly two flavors: probe the bloom
+   * filter built over the build side of a hash join, or skip it. Both are
+   * correct since the join discards probe tuples without a match anyway.
    */
   struct Clause {
     /**
@@ -35,10 +58,25 @@ class EXPORT FilterManager {
      */
     std::vector<MatchFn> flavors_;
 
+    /**
+     * The bloom filter of a join filter clause, or NULL
+     */
+    const BloomFilter *bloom_filter_{nullptr};
+
+    /**
+     * The function hashing the probe key of a join filter clause, or NULL
+     */
+    HashFn hash_fn_{nullptr};
+
+    /**
+     * Is this a join filter clause?
+     */
+    bool IsJoinFilter() const { return bloom_filter_ != nullptr; }
+
     /**
      * Return the number of flavors
      */
-    uint32_t NumFlavors() const { return static_cast<uint32_t>(flavors_.size()); }
+    uint32_t NumFlavors() const { return IsJoinFilter() ? 2 : static_cast<uint32_t>(flavors_.size()); }
   };
 
   /**
@@ -68,6 +106,19 @@ class EXPORT FilterManager {
    */
   void InsertClauseFlavor(FilterManager::MatchFn flavor);
 
+  /**
+   * Insert a clause discarding tuples whose join key, as hashed by @em hash_fn,
+   * is definitely not in @em bloom_filter. The filter is only read when the
+   * filters run, so it may be populated (i.e., the join hash table built) after
+   * the clause is inserted. Since probing the filter may cost more than it
+   * saves, whether to probe it is learned like any other clause flavor, except
+   * that the reward is the time to process a whole vector, from the filters to
+   * the probe of the join hash table and beyond, and not just the filter's.
+   * @param bloom_filter The bloom filter over the build side of an inner join
+   * @param hash_fn The function hashing the probe key of the current tuple
+   */
+  void InsertJoinFilterClause(const BloomFilter *bloom_filter, FilterManager::HashFn hash_fn);
+
   /**
    * Make the manager immutable.
    */
@@ -87,6 +138,14 @@ class EXPORT FilterManager {
    */
   uint32_t GetOptimalFlavorForClause(uint32_t clause_index) const;
 
+  /**
+   * Return the number of times each implementation flavor of the clause at
+   * index @em clause_index was run and rewarded
+   * @param clause_index The index of the clause
+   * @return The number of attempts, indexed by flavor
+   */
+  const std::vector<uint32_t> &GetFlavorAttemptsForClause(uint32_t clause_index) const;
+
  private:
   // Run a specific clause of the filter
   void RunFilterClause(ProjectedColumnsIterator *pci, uint32_t clause_index);
@@ -94,6 +153,12 @@ class EXPORT FilterManager {
   // Run the given matching function
   std::pair<uint32_t, double> RunFilterClauseImpl(ProjectedColumnsIterator *pci, FilterManager::MatchFn func);
 
+  // Run a join filter clause
+  void RunJoinFilterClause(ProjectedColumnsIterator *pci, uint32_t clause_index);
+
+  // Reward the join filter clauses with the time spent on the previous vector
+  void ObserveJoinFilters();
+
   // Return the clause at the given index in the filter
   const Clause *ClauseAt(uint32_t index) const { return &clauses_[index]; }
 
@@ -110,6 +175,12 @@ class EXPORT FilterManager {
   std::unique_ptr<bandit::Policy> policy_;
   // The agents, one per clause
   std::vector<bandit::Agent> agents_;
+  // The indexes of the join filter clauses
+  std::vector<uint32_t> join_filter_clauses_;
+  // Times the processing of a vector, from one call to RunFilters() to the next
+  util::Timer<> vector_timer_;
+  // Have the join filters been run on a vector whose time is yet to be observed?
+  bool vector_in_flight_{false};
   // Has the manager's clauses been finalized?
   bool finalized_{false};
 };
@@ -39,6 +39,24 @@ class EXPORT IndexIterator {
    */
   void ScanKey();
 
+  /**
+   * Adds the key set so far to the batch of keys probed by the next ScanKeyBatch. A batch holds up to as many keys as
+   * there are tuples in a vector.
+   */
+  void AddBatchKey();
+
+  /**
+   * Wrapper around the index's ScanKeyBatch, probing every key added to the batch since the last call
+   */
+  void ScanKeyBatch();
+
+  /**
+   * Moves on to the matches of the next key of the batch, in the order the keys were added. Advance then iterates
+   * over them.
+   * @return whether there was another key in the batch
+   */
+  bool NextBatchKey();
+
   /**
    * Advances the iterator. Return true if successful
    * @return whether the iterator was advanced or not.
@@ -90,11 +108,19 @@ class EXPORT IndexIterator {
   common::ManagedPointer<storage::SqlTable> table_;
 
   uint32_t curr_index_ = 0;
+  // End of the matches Advance iterates over, in tuples_
+  uint32_t curr_end_ = 0;
   void *index_buffer_;
   void *table_buffer_;
   storage::ProjectedRow *index_pr_;
   storage::ProjectedRow *table_pr_;
   std::vector<storage::TupleSlot> tuples_{};
+
+  // Batched probes. The keys are copies of index_pr_, in a buffer allocated on the first AddBatchKey.
+  void *key_batch_buffer_ = nullptr;
+  std::vector<const storage::ProjectedRow *> key_batch_{};
+  std::vector<uint32_t> key_ends_{};
+  uint32_t curr_key_ = 0;
 };
 
 }  // namespace terrier::execution::sql
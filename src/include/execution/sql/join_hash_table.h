@@ -66,8 +66,10 @@ class EXPORT JoinHashTable {
   byte *AllocInputTuple(hash_t hash);
 
   /**
-   * Fully construct the join hash table. Nothing is done if the join hash table
-   * has already been built. After building, the table becomes read-only.
+   * Fully construct the join hash table, along with a bloom filter over the
+   * hash values of all its tuples if one was requested. Nothing is done if the
+   * join hash table has already been built. After building, the table becomes
+   * read-only.
    */
   void Build();
 
@@ -135,6 +137,16 @@ class EXPORT JoinHashTable {
    */
   bool UseConciseHashTable() const noexcept { return use_concise_ht_; }
 
+  /**
+   * Request the bloom filter over the hash values of the tuples in this table,
+   * e.g., for a probe-side join filter. Only tables whose filter is requested
+   * pay for building it. The filter is populated once the table is built or
+   * merged into, or right away if that already happened. Its address is
+   * stable, so it can be requested before the table is built.
+   * @return The bloom filter
+   */
+  const BloomFilter *RequestBloomFilter();
+
  private:
   friend class execution::sql::test::JoinHashTableTest;
 
@@ -145,6 +157,9 @@ class EXPORT JoinHashTable {
     return reinterpret_cast<const HashTableEntry *>(entries_[idx]);
   }
 
+  // Populate the bloom filter with the hashes of all buffered and owned tuples
+  void BuildBloomFilter();
+
   // Dispatched from Build() to build either a generic or concise hash table
   void BuildGenericHashTable() noexcept;
   void BuildConciseHashTable();
@@ -186,6 +201,9 @@ class EXPORT JoinHashTable {
   void MergeIncomplete(JoinHashTable *source);
 
  private:
+  // The memory pool the bloom filter is allocated from
+  MemoryPool *memory_;
+
   // The vector where we store the build-side input
   util::ChunkedVector<MemoryPoolAllocator<byte>> entries_;
 
@@ -203,6 +221,12 @@ class EXPORT JoinHashTable {
   // The bloom filter
   BloomFilter bloom_filter_;
 
+  // Has the bloom filter been requested?
+  bool bloom_filter_requested_;
+
+  // Has the hash table been merged into from thread-local tables?
+  bool merged_;
+
   // Estimator of unique elements
   std::unique_ptr<libcount::HLL> hll_estimator_;
 
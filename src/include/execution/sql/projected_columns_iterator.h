@@ -1,6 +1,7 @@
 #pragma once
 
 #include <limits>
+#include <string_view>
 #include <type_traits>
 #include "storage/projected_columns.h"
 
@@ -161,6 +162,18 @@ class EXPORT ProjectedColumnsIterator {
      * an int64_t filter value
      */
     int64_t bi_;
+    /**
+     * a double filter value, for DECIMAL columns
+     */
+    double d_;
+    /**
+     * a date filter value, as stored in DATE columns
+     */
+    uint32_t date_;
+    /**
+     * a timestamp filter value, as stored in TIMESTAMP columns
+     */
+    uint64_t ts_;
   };
 
   /**
@@ -179,6 +192,27 @@ class EXPORT ProjectedColumnsIterator {
         return FilterVal{.i_ = static_cast<int32_t>(val)};
       case type::TypeId::BIGINT:
         return FilterVal{.bi_ = static_cast<int64_t>(val)};
+      case type::TypeId::DECIMAL:
+        return FilterVal{.d_ = static_cast<double>(val)};
+      case type::TypeId::DATE:
+        return FilterVal{.date_ = static_cast<uint32_t>(val)};
+      case type::TypeId::TIMESTAMP:
+        return FilterVal{.ts_ = static_cast<uint64_t>(val)};
+      default:
+        throw std::runtime_error("Filter not supported on type");
+    }
+  }
+
+  /**
+   * Creates a filter value from a floating-point constant. Only DECIMAL columns are compared to such constants.
+   * @param val filter value
+   * @param type type of the value
+   * @return filter val of the given type
+   */
+  FilterVal MakeFilterVal(double val, type::TypeId type) {
+    switch (type) {
+      case type::TypeId::DECIMAL:
+        return FilterVal{.d_ = val};
       default:
         throw std::runtime_error("Filter not supported on type");
     }
@@ -187,25 +221,72 @@ class EXPORT ProjectedColumnsIterator {
   /**
    * Filter the column at index @em col_idx by the given constant value @em val.
    * @tparam Op The filtering operator.
+   * @tparam Nullable Whether the column is NULLable. If so, tuples whose value is NULL are filtered out as well.
    * @param col_idx The index of the column in the projection to filter.
-   * @param type The type of the column.
+   * @param type The type of the column. VARCHAR columns are filtered with FilterColByString() instead.
    * @param val The value to filter on.
    * @return The number of selected elements.
    */
-  template <template <typename> typename Op>
+  template <template <typename> typename Op, bool Nullable = false>
   uint32_t FilterColByVal(uint32_t col_idx, type::TypeId type, FilterVal val);
 
+  /**
+   * Filter the VARCHAR column at index @em col_idx by the given constant string @em val.
+   * @tparam Op The filtering operator.
+   * @tparam Nullable Whether the column is NULLable. If so, tuples whose value is NULL are filtered out as well.
+   * @param col_idx The index of the column in the projection to filter.
+   * @param val The string to filter on.
+   * @return The number of selected elements.
+   */
+  template <template <typename> typename Op, bool Nullable = false>
+  uint32_t FilterColByString(uint32_t col_idx, std::string_view val);
+
+  /**
+   * Filter the VARCHAR column at index @em col_idx, keeping tuples whose value starts with @em prefix.
+   * @tparam Nullable Whether the column is NULLable. If so, tuples whose value is NULL are filtered out as well.
+   * @param col_idx The index of the column in the projection to filter.
+   * @param prefix The prefix to look for.
+   * @return The number of selected elements.
+   */
+  template <bool Nullable = false>
+  uint32_t FilterColByPrefix(uint32_t col_idx, std::string_view prefix);
+
+  /**
+   * Filter the VARCHAR column at index @em col_idx, keeping tuples whose value matches the LIKE pattern @em pattern.
+   * @tparam Nullable Whether the column is NULLable. If so, tuples whose value is NULL are filtered out as well.
+   * @param col_idx The index of the column in the projection to filter.
+   * @param pattern The LIKE pattern. See util::VectorUtil::MatchLike().
+   * @return The number of selected elements.
+   */
+  template <bool Nullable = false>
+  uint32_t FilterColByLike(uint32_t col_idx, std::string_view pattern);
+
+  /**
+   * Filter the column at index @em col_idx, keeping tuples whose value is NULL.
+   * @param col_idx The index of the column in the projection to filter.
+   * @return The number of selected elements.
+   */
+  uint32_t FilterColNull(uint32_t col_idx);
+
+  /**
+   * Filter the column at index @em col_idx, keeping tuples whose value is not NULL.
+   * @param col_idx The index of the column in the projection to filter.
+   * @return The number of selected elements.
+   */
+  uint32_t FilterColNotNull(uint32_t col_idx);
+
   /**
    * Filter the column at index @em col_idx_1 with the contents of the column
    * at index @em col_idx_2.
    * @tparam Op The filtering operator.
+   * @tparam Nullable Whether the columns are NULLable. If so, tuples where either value is NULL are filtered out too.
    * @param col_idx_1 The index of the first column to compare.
    * @param type_1 the Type of the first column.
    * @param col_idx_2 The index of the second column to compare.
    * @param type_2 The type of the second column.
    * @return The number of selected elements.
    */
-  template <template <typename> typename Op>
+  template <template <typename> typename Op, bool Nullable = false>
   uint32_t FilterColByCol(uint32_t col_idx_1, type::TypeId type_1, uint32_t col_idx_2, type::TypeId type_2);
 
   /**
@@ -222,6 +303,11 @@ class EXPORT ProjectedColumnsIterator {
   template <typename T, template <typename> typename Op>
   uint32_t FilterColByColImpl(uint32_t col_idx_1, uint32_t col_idx_2);
 
+  // Run a filter kernel on the tuples selected so far. The kernel is given the selection vector to read from (or
+  // nullptr if this PCI is not filtered) and writes the selected tuples into this PCI's selection vector.
+  template <typename F>
+  uint32_t RunVectorFilter(const F &filter);
+
  private:
   // The selection vector used to filter the ProjectedColumns
   alignas(common::Constants::CACHELINE_SIZE) uint32_t selection_vector_[common::Constants::K_DEFAULT_VECTOR_SIZE];
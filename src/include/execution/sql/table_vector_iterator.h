@@ -31,6 +31,19 @@ class EXPORT TableVectorIterator {
   explicit TableVectorIterator(exec::ExecutionContext *exec_ctx, uint32_t table_oid, uint32_t *col_oids,
                                uint32_t num_oids);
 
+  /**
+   * Create a new vectorized iterator over a contiguous range of blocks [start_block_idx, end_block_idx) of the given
+   * table. An end index past the last block means the iterator runs until the end of the table.
+   * @param exec_ctx execution context of the query
+   * @param table_oid oid of the table
+   * @param col_oids array column oids to scan
+   * @param num_oids length of the array
+   * @param start_block_idx index of the first block to scan
+   * @param end_block_idx index one past the last block to scan
+   */
+  TableVectorIterator(exec::ExecutionContext *exec_ctx, uint32_t table_oid, uint32_t *col_oids, uint32_t num_oids,
+                      uint32_t start_block_idx, uint32_t end_block_idx);
+
   /**
    * Destructor
    */
@@ -71,17 +84,24 @@ class EXPORT TableVectorIterator {
   /**
    * Perform a parallel scan over the table with ID @em table_oid using the
    * callback function @em scanner on each input vector projection from the
-   * source table. This call is blocking, meaning that it only returns after
-   * the whole table has been scanned. Iteration order is non-deterministic.
-   * @param db_oid The ID of the database containing the table
+   * source table. The table's blocks are split into morsels of at least
+   * @em min_grain_size blocks, and each morsel is handed to a worker thread
+   * along with that thread's state from @em thread_states. This call is
+   * blocking, meaning that it only returns after the whole table has been
+   * scanned. Iteration order is non-deterministic.
    * @param table_oid The ID of the table
+   * @param col_oids array column oids to scan
+   * @param num_oids length of the array
    * @param query_state the query state
+   * @param exec_ctx execution context of the query
    * @param thread_states the thread state container
    * @param scan_fn The callback function invoked for vectors of table input
    * @param min_grain_size The minimum number of blocks to give a scan task
+   * @return True if the scan was performed; false if the table does not exist
    */
-  static bool ParallelScan(uint32_t db_oid, uint32_t table_oid, void *query_state, ThreadStateContainer *thread_states,
-                           ScanFn scan_fn, uint32_t min_grain_size = K_MIN_BLOCK_RANGE_SIZE);
+  static bool ParallelScan(uint32_t table_oid, uint32_t *col_oids, uint32_t num_oids, void *query_state,
+                           exec::ExecutionContext *exec_ctx, ThreadStateContainer *thread_states, ScanFn scan_fn,
+                           uint32_t min_grain_size = K_MIN_BLOCK_RANGE_SIZE);
 
  private:
   exec::ExecutionContext *exec_ctx_;
@@ -96,6 +116,9 @@ class EXPORT TableVectorIterator {
   storage::ProjectedColumns *projected_columns_ = nullptr;
   // Iterator of the slots in the PC
   std::unique_ptr<storage::DataTable::SlotIterator> iter_ = nullptr;
+  // The range of blocks to scan
+  const uint32_t start_block_idx_;
+  const uint32_t end_block_idx_;
 
   bool initialized_ = false;
 };
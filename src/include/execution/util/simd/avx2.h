@@ -243,6 +243,50 @@ ALWAYS_INLINE inline void Vec4::Store(int32_t *arr) const {
 
 ALWAYS_INLINE inline void Vec4::Store(int64_t *arr) const { Vec256b::Store(reinterpret_cast<void *>(arr)); }
 
+// ---------------------------------------------------------
+// Vec4d Definition
+// ---------------------------------------------------------
+
+/**
+ * A 256-bit SIMD register interpreted as four double-precision floating point values. Positions (i.e., selection
+ * vector entries) are still loaded as 64-bit integers through the Vec4 interface, so that a Vec4d can be used with the
+ * generic filters below.
+ */
+class Vec4d : public Vec4 {
+ public:
+  Vec4d() = default;
+  /**
+   * Create a vector with 4 copies of val.
+   * @param val initial value for entire vector
+   */
+  explicit Vec4d(double val) { reg_ = _mm256_castpd_si256(_mm256_set1_pd(val)); }
+
+  using Vec4::Load;
+
+  /**
+   * Load four 64-bit floating point values from the input array
+   */
+  Vec4d &Load(const double *ptr) {
+    reg_ = _mm256_castpd_si256(_mm256_loadu_pd(ptr));
+    return *this;
+  }
+
+  /**
+   * Gather four non-contiguous floating point values from the input array ptr stored at index positions from pos.
+   */
+  Vec4d &Gather(const double *ptr, const Vec4 &pos) {
+    alignas(32) int64_t x[Size()];
+    pos.Store(x);
+    reg_ = _mm256_castpd_si256(_mm256_setr_pd(ptr[x[0]], ptr[x[1]], ptr[x[2]], ptr[x[3]]));
+    return *this;
+  }
+
+  /**
+   * @return the underlying register, as four floating point values for use with floating point intrinsics
+   */
+  ALWAYS_INLINE __m256d DoubleReg() const { return _mm256_castsi256_pd(Reg()); }
+};
+
 // ------------------gre---------------------------------------
 // Vec8 Definition
 // ---------------------------------------------------------
@@ -622,6 +666,32 @@ ALWAYS_INLINE inline Vec4Mask operator<=(const Vec4 &a, const Vec4 &b) { return
 
 ALWAYS_INLINE inline Vec4Mask operator!=(const Vec4 &a, const Vec4 &b) { return Vec4Mask(~Vec256b(a == b)); }
 
+// ---------------------------------------------------------
+// Vec4d - Comparison Operations
+// ---------------------------------------------------------
+
+// Ordered comparisons are false if either value is NaN, and != is true, like the scalar operators.
+
+ALWAYS_INLINE inline Vec4Mask operator>(const Vec4d &a, const Vec4d &b) {
+  return Vec4Mask(_mm256_castpd_si256(_mm256_cmp_pd(a.DoubleReg(), b.DoubleReg(), _CMP_GT_OQ)));
+}
+
+ALWAYS_INLINE inline Vec4Mask operator==(const Vec4d &a, const Vec4d &b) {
+  return Vec4Mask(_mm256_castpd_si256(_mm256_cmp_pd(a.DoubleReg(), b.DoubleReg(), _CMP_EQ_OQ)));
+}
+
+ALWAYS_INLINE inline Vec4Mask operator>=(const Vec4d &a, const Vec4d &b) {
+  return Vec4Mask(_mm256_castpd_si256(_mm256_cmp_pd(a.DoubleReg(), b.DoubleReg(), _CMP_GE_OQ)));
+}
+
+ALWAYS_INLINE inline Vec4Mask operator<(const Vec4d &a, const Vec4d &b) { return b > a; }
+
+ALWAYS_INLINE inline Vec4Mask operator<=(const Vec4d &a, const Vec4d &b) { return b >= a; }
+
+ALWAYS_INLINE inline Vec4Mask operator!=(const Vec4d &a, const Vec4d &b) {
+  return Vec4Mask(_mm256_castpd_si256(_mm256_cmp_pd(a.DoubleReg(), b.DoubleReg(), _CMP_NEQ_UQ)));
+}
+
 // ---------------------------------------------------------
 // Vec4 - Arithmetic Operations
 // ---------------------------------------------------------
@@ -707,7 +777,7 @@ ALWAYS_INLINE inline Vec8Mask operator>(const Vec8 &a, const Vec8 &b) { return V
 ALWAYS_INLINE inline Vec8Mask operator==(const Vec8 &a, const Vec8 &b) { return Vec8Mask(_mm256_cmpeq_epi32(a, b)); }
 
 ALWAYS_INLINE inline Vec8Mask operator>=(const Vec8 &a, const Vec8 &b) {
-  __m256i max_a_b = _mm256_max_epu32(a, b);
+  __m256i max_a_b = _mm256_max_epi32(a, b);
   return Vec8Mask(_mm256_cmpeq_epi32(a, max_a_b));
 }
 
@@ -871,6 +941,21 @@ struct FilterVecSizer<int64_t> {
   using VecMask = Vec4Mask;
 };
 
+/**
+ * double Filter
+ */
+template <>
+struct FilterVecSizer<double> {
+  /**
+   * Four 64-bit floating point values.
+   */
+  using Vec = Vec4d;
+  /**
+   * Mask for four 64-bit values.
+   */
+  using VecMask = Vec4Mask;
+};
+
 #ifdef __APPLE__  // need this explicit instantiation
 /**
  * intptr_t Filter
@@ -274,6 +274,48 @@ ALWAYS_INLINE inline bool Vec8::AllBitsAtPositionsSet(const Vec8 &mask) const {
   return _mm512_testn_epi64_mask(Reg(), mask) == 0;
 }
 
+// ---------------------------------------------------------
+// Vec8d Definition
+// ---------------------------------------------------------
+
+/**
+ * A 512-bit SIMD register interpreted as eight double-precision floating point values. Positions (i.e., selection
+ * vector entries) are still loaded as 64-bit integers through the Vec8 interface, so that a Vec8d can be used with the
+ * generic filters below.
+ */
+class Vec8d : public Vec8 {
+ public:
+  Vec8d() = default;
+  /**
+   * Create a vector with 8 copies of val.
+   * @param val initial value for entire vector
+   */
+  explicit Vec8d(double val) { reg_ = _mm512_castpd_si512(_mm512_set1_pd(val)); }
+
+  using Vec8::Load;
+
+  /**
+   * Load eight 64-bit floating point values from the input array
+   */
+  Vec8d &Load(const double *ptr) {
+    reg_ = _mm512_castpd_si512(_mm512_loadu_pd(ptr));
+    return *this;
+  }
+
+  /**
+   * Gather eight non-contiguous floating point values from the input array ptr stored at index positions from pos.
+   */
+  Vec8d &Gather(const double *ptr, const Vec8 &pos) {
+    reg_ = _mm512_castpd_si512(_mm512_i64gather_pd(pos, ptr, 8));
+    return *this;
+  }
+
+  /**
+   * @return the underlying register, as eight floating point values for use with floating point intrinsics
+   */
+  ALWAYS_INLINE __m512d DoubleReg() const { return _mm512_castsi512_pd(Reg()); }
+};
+
 /**
  * Vector with sixteen 32-bit values.
  */
@@ -660,6 +702,36 @@ ALWAYS_INLINE inline Vec8Mask operator!=(const Vec8 &a, const Vec8 &b) {
   return Vec8Mask(_mm512_cmpneq_epi64_mask(a, b));
 }
 
+// ---------------------------------------------------------
+// Vec8d Comparison Operations
+// ---------------------------------------------------------
+
+// Ordered comparisons are false if either value is NaN, and != is true, like the scalar operators.
+
+ALWAYS_INLINE inline Vec8Mask operator>(const Vec8d &a, const Vec8d &b) {
+  return Vec8Mask(_mm512_cmp_pd_mask(a.DoubleReg(), b.DoubleReg(), _CMP_GT_OQ));
+}
+
+ALWAYS_INLINE inline Vec8Mask operator==(const Vec8d &a, const Vec8d &b) {
+  return Vec8Mask(_mm512_cmp_pd_mask(a.DoubleReg(), b.DoubleReg(), _CMP_EQ_OQ));
+}
+
+ALWAYS_INLINE inline Vec8Mask operator<(const Vec8d &a, const Vec8d &b) {
+  return Vec8Mask(_mm512_cmp_pd_mask(a.DoubleReg(), b.DoubleReg(), _CMP_LT_OQ));
+}
+
+ALWAYS_INLINE inline Vec8Mask operator<=(const Vec8d &a, const Vec8d &b) {
+  return Vec8Mask(_mm512_cmp_pd_mask(a.DoubleReg(), b.DoubleReg(), _CMP_LE_OQ));
+}
+
+ALWAYS_INLINE inline Vec8Mask operator>=(const Vec8d &a, const Vec8d &b) {
+  return Vec8Mask(_mm512_cmp_pd_mask(a.DoubleReg(), b.DoubleReg(), _CMP_GE_OQ));
+}
+
+ALWAYS_INLINE inline Vec8Mask operator!=(const Vec8d &a, const Vec8d &b) {
+  return Vec8Mask(_mm512_cmp_pd_mask(a.DoubleReg(), b.DoubleReg(), _CMP_NEQ_UQ));
+}
+
 // ---------------------------------------------------------
 // Vec8 Arithmetic Operations
 // ---------------------------------------------------------
@@ -922,6 +994,21 @@ struct FilterVecSizer<int64_t> {
   using VecMask = Vec8Mask;
 };
 
+/**
+ * double Filter
+ */
+template <>
+struct FilterVecSizer<double> {
+  /**
+   * Eight 64-bit floating point values.
+   */
+  using Vec = Vec8d;
+  /**
+   * Mask for eight 64-bit values.
+   */
+  using VecMask = Vec8Mask;
+};
+
 #ifdef __APPLE__  // need this explicit instantiation
 /**
  * intptr_t Filter
@@ -1,9 +1,14 @@
 #pragma once
 
+#include <algorithm>
+#include <cstring>
 #include <functional>
+#include <string_view>
 
+#include "common/container/bitmap.h"
 #include "execution/util/execution_common.h"
 #include "execution/util/simd.h"
+#include "storage/storage_defs.h"
 
 namespace terrier::execution::util {
 
@@ -181,6 +186,227 @@ class VectorUtil {
                             uint32_t *RESTRICT sel) -> std::enable_if_t<std::is_pointer_v<T>, uint32_t> {
     return FilterNe(reinterpret_cast<const intptr_t *>(in), in_count, intptr_t(0), out, sel);
   }
+
+  /**
+   * Given the NULL bitmap of a column, insert the indexes of all NULL elements (i.e., elements whose bit is not set)
+   * into the selection vector @em out.
+   * @param null_bitmap The NULL bitmap of the column.
+   * @param in_count The number of elements in the input (or selection) vector.
+   * @param[out] out The output vector where results are stored.
+   * @param sel The selection vector storing indexes of elements to process.
+   * @return The number of NULL elements.
+   */
+  static uint32_t SelectNull(const common::RawBitmap *RESTRICT null_bitmap, const uint32_t in_count,
+                             uint32_t *RESTRICT out, const uint32_t *RESTRICT sel) {
+    return FilterByPredicate(in_count, out, sel, [=](const uint32_t i) { return !null_bitmap->Test(i); });
+  }
+
+  /**
+   * Given the NULL bitmap of a column, insert the indexes of all non-NULL elements (i.e., elements whose bit is set)
+   * into the selection vector @em out.
+   * @param null_bitmap The NULL bitmap of the column.
+   * @param in_count The number of elements in the input (or selection) vector.
+   * @param[out] out The output vector where results are stored.
+   * @param sel The selection vector storing indexes of elements to process.
+   * @return The number of non-NULL elements.
+   */
+  static uint32_t SelectNotNull(const common::RawBitmap *RESTRICT null_bitmap, const uint32_t in_count,
+                                uint32_t *RESTRICT out, const uint32_t *RESTRICT sel) {
+    if (sel == nullptr) {
+      // Columns rarely have NULLs, so whole bytes of the bitmap are usually set and select eight elements at once
+      const auto *const bits = reinterpret_cast<const uint8_t *>(null_bitmap);
+      uint32_t in_pos = 0, out_pos = 0;
+      for (; in_pos + BYTE_SIZE <= in_count; in_pos += BYTE_SIZE) {
+        const uint8_t byte = bits[in_pos / BYTE_SIZE];
+        for (uint32_t bit = 0; bit < BYTE_SIZE; bit++) {
+          out[out_pos] = in_pos + bit;
+          out_pos += (byte >> bit) & 1u;
+        }
+      }
+      for (; in_pos < in_count; in_pos++) {
+        out[out_pos] = in_pos;
+        out_pos += static_cast<uint32_t>(null_bitmap->Test(in_pos));
+      }
+      return out_pos;
+    }
+    return FilterByPredicate(in_count, out, sel, [=](const uint32_t i) { return null_bitmap->Test(i); });
+  }
+
+  // -------------------------------------------------------
+  // String filters
+  // -------------------------------------------------------
+
+  /**
+   * Filter an input vector of strings by a constant string and store the indexes of valid elements in the output
+   * vector. If a selection vector is provided, only vector elements from the selection vector will be read. Strings
+   * compare as byte strings. Equality compares lengths and the prefix stored in the entries before the out-of-line
+   * contents, so that most mismatching strings are rejected without a cache miss.
+   * @tparam Op The filter comparison operation.
+   * @param in The input vector.
+   * @param in_count The number of elements in the input (or selection) vector.
+   * @param val The constant string to compare with.
+   * @param[out] out The vector storing indexes of valid input elements.
+   * @param sel The selection vector used to read input values.
+   * @return The number of elements that pass the filter.
+   */
+  template <template <typename> typename Op>
+  static uint32_t FilterStringByVal(const storage::VarlenEntry *RESTRICT in, const uint32_t in_count,
+                                    const std::string_view val, uint32_t *RESTRICT out, const uint32_t *RESTRICT sel) {
+    static_assert(std::is_same_v<bool, std::invoke_result_t<Op<std::string_view>, std::string_view, std::string_view>>);
+
+    if constexpr (std::is_same_v<Op<std::string_view>, std::equal_to<std::string_view>>) {
+      return FilterByPredicate(in_count, out, sel, [&](const uint32_t i) { return StringEquals(in[i], val); });
+    } else if constexpr (std::is_same_v<Op<std::string_view>, std::not_equal_to<std::string_view>>) {  // NOLINT
+      return FilterByPredicate(in_count, out, sel, [&](const uint32_t i) { return !StringEquals(in[i], val); });
+    } else {  // NOLINT
+      return FilterByPredicate(in_count, out, sel,
+                               [&](const uint32_t i) { return Op<std::string_view>()(in[i].StringView(), val); });
+    }
+  }
+
+  /**
+   * Filter an input vector of strings by the strings in a second input vector, and store indexes of the valid
+   * elements into an output vector. If a selection vector is provided, only the vector elements whose indexes are in
+   * the selection vector will be read.
+   * @tparam Op The filter comparison operation.
+   * @param in_1 The first input vector.
+   * @param in_2 The second input vector.
+   * @param in_count The number of elements in the input (or selection) vector.
+   * @param[out] out The vector storing the indexes of the valid input elements.
+   * @param sel The selection vector storing indexes of elements to process.
+   * @return The number of elements that pass the filter.
+   */
+  template <template <typename> typename Op>
+  static uint32_t FilterStringByVector(const storage::VarlenEntry *RESTRICT in_1,
+                                       const storage::VarlenEntry *RESTRICT in_2, const uint32_t in_count,
+                                       uint32_t *RESTRICT out, const uint32_t *RESTRICT sel) {
+    return FilterByPredicate(in_count, out, sel, [&](const uint32_t i) {
+      return Op<std::string_view>()(in_1[i].StringView(), in_2[i].StringView());
+    });
+  }
+
+  /**
+   * Insert the indexes of all strings in the input vector that start with the given prefix into the selection
+   * vector @em out.
+   * @param in The input vector.
+   * @param in_count The number of elements in the input (or selection) vector.
+   * @param prefix The prefix to look for.
+   * @param[out] out The vector storing indexes of valid input elements.
+   * @param sel The selection vector used to read input values.
+   * @return The number of elements that pass the filter.
+   */
+  static uint32_t FilterStringPrefix(const storage::VarlenEntry *RESTRICT in, const uint32_t in_count,
+                                     const std::string_view prefix, uint32_t *RESTRICT out,
+                                     const uint32_t *RESTRICT sel) {
+    return FilterByPredicate(in_count, out, sel, [&](const uint32_t i) { return StartsWith(in[i], prefix); });
+  }
+
+  /**
+   * Insert the indexes of all strings in the input vector that match the given SQL LIKE pattern into the selection
+   * vector @em out. Patterns that only test for equality, a prefix or a substring are run as such.
+   * @param in The input vector.
+   * @param in_count The number of elements in the input (or selection) vector.
+   * @param pattern The LIKE pattern, where '%' matches any string, '_' any character, and a backslash escapes either.
+   * @param[out] out The vector storing indexes of valid input elements.
+   * @param sel The selection vector used to read input values.
+   * @return The number of elements that pass the filter.
+   */
+  static uint32_t FilterStringLike(const storage::VarlenEntry *RESTRICT in, const uint32_t in_count,
+                                   const std::string_view pattern, uint32_t *RESTRICT out,
+                                   const uint32_t *RESTRICT sel) {
+    // Find the wildcards of a pattern without escapes
+    const bool simple = pattern.find_first_of("_\\") == std::string_view::npos;
+    const auto first_wildcard = pattern.find('%');
+    if (simple && first_wildcard == std::string_view::npos) {
+      return FilterStringByVal<std::equal_to>(in, in_count, pattern, out, sel);
+    }
+    if (simple && first_wildcard == pattern.size() - 1) {
+      return FilterStringPrefix(in, in_count, pattern.substr(0, first_wildcard), out, sel);
+    }
+    if (simple && first_wildcard == 0 && pattern.size() > 1 && pattern.find('%', 1) == pattern.size() - 1) {
+      const auto needle = pattern.substr(1, pattern.size() - 2);
+      return FilterByPredicate(in_count, out, sel, [&](const uint32_t i) {
+        return in[i].StringView().find(needle) != std::string_view::npos;
+      });
+    }
+    return FilterByPredicate(in_count, out, sel,
+                             [&](const uint32_t i) { return MatchLike(in[i].StringView(), pattern); });
+  }
+
+  /**
+   * Match a string against a SQL LIKE pattern.
+   * @param str The string to match.
+   * @param pattern The LIKE pattern, where '%' matches any string, '_' any character, and a backslash escapes either.
+   * @return True if the whole string matches the pattern; false otherwise.
+   */
+  static bool MatchLike(const std::string_view str, const std::string_view pattern) {
+    constexpr char escape = '\\';
+    // Match greedily, and on a mismatch retry from the last '%' with it consuming one more character
+    std::size_t s = 0, p = 0, star_p = std::string_view::npos, star_s = 0;
+    while (s < str.size()) {
+      if (p < pattern.size() && pattern[p] == '%') {
+        star_p = ++p;
+        star_s = s;
+        continue;
+      }
+      if (p < pattern.size()) {
+        char c = pattern[p++];
+        bool any = c == '_';
+        if (c == escape && p < pattern.size()) {
+          c = pattern[p++];
+          any = false;
+        }
+        if (any || c == str[s]) {
+          s++;
+          continue;
+        }
+      }
+      if (star_p == std::string_view::npos) return false;
+      p = star_p;
+      s = ++star_s;
+    }
+    while (p < pattern.size() && pattern[p] == '%') p++;
+    return p == pattern.size();
+  }
+
+ private:
+  // Store the indexes of the elements (read through the selection vector, if one is provided) that satisfy the
+  // predicate into the output vector. Like the scalar filters above, this writes every index and only advances the
+  // output position for valid ones, so that it does not branch on the result of the predicate.
+  template <typename P>
+  static uint32_t FilterByPredicate(const uint32_t in_count, uint32_t *RESTRICT out, const uint32_t *RESTRICT sel,
+                                    const P &pred) {
+    uint32_t out_pos = 0;
+    if (sel == nullptr) {
+      for (uint32_t in_pos = 0; in_pos < in_count; in_pos++) {
+        out[out_pos] = in_pos;
+        out_pos += static_cast<uint32_t>(pred(in_pos));
+      }
+    } else {
+      for (uint32_t in_pos = 0; in_pos < in_count; in_pos++) {
+        const uint32_t idx = sel[in_pos];
+        out[out_pos] = idx;
+        out_pos += static_cast<uint32_t>(pred(idx));
+      }
+    }
+    return out_pos;
+  }
+
+  // Compare the lengths and stored prefixes first, which are in the entry itself
+  static bool StringEquals(const storage::VarlenEntry &entry, const std::string_view val) {
+    const uint32_t size = entry.Size();
+    if (size != val.size()) return false;
+    const uint32_t prefix_size = std::min(size, storage::VarlenEntry::PrefixSize());
+    return std::memcmp(entry.Prefix(), val.data(), prefix_size) == 0 &&
+           std::memcmp(entry.Content(), val.data(), size) == 0;
+  }
+
+  static bool StartsWith(const storage::VarlenEntry &entry, const std::string_view prefix) {
+    if (entry.Size() < prefix.size()) return false;
+    const auto prefix_size = std::min(static_cast<uint32_t>(prefix.size()), storage::VarlenEntry::PrefixSize());
+    return std::memcmp(entry.Prefix(), prefix.data(), prefix_size) == 0 &&
+           std::memcmp(entry.Content(), prefix.data(), prefix.size()) == 0;
+  }
 };
 
 }  // namespace terrier::execution::util
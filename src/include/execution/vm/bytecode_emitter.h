@@ -321,9 +321,16 @@ class BytecodeEmitter {
 
   /**
    * Emit a parallel table scan
+   * @param table_oid oid of the table to scan
+   * @param col_oids array of column oids to scan
+   * @param num_oids length of the array
+   * @param query_state the opaque query state passed to the scan function
+   * @param exec_ctx the execution context
+   * @param thread_states the thread state container
+   * @param scan_fn the function invoked on every morsel of the table
    */
-  void EmitParallelTableScan(uint32_t db_oid, uint32_t table_oid, LocalVar ctx, LocalVar thread_states,
-                             FunctionId scan_fn);
+  void EmitParallelTableScan(uint32_t table_oid, LocalVar col_oids, uint32_t num_oids, LocalVar query_state,
+                             LocalVar exec_ctx, LocalVar thread_states, FunctionId scan_fn);
 
   // Reading integer values from an iterator
   /**
@@ -343,15 +350,56 @@ class BytecodeEmitter {
    * @param col_idx index of the iterator to filter
    * @param type type of the column
    * @param val filter value
+   * @param nullable whether tuples whose value is NULL must be filtered out too
    */
   void EmitPCIVectorFilter(Bytecode bytecode, LocalVar selected, LocalVar pci, uint32_t col_idx, int8_t type,
-                           int64_t val);
+                           int64_t val, bool nullable);
+
+  /**
+   * Filter a DECIMAL column in the iterator by a floating-point constant
+   * @param bytecode filter bytecode to emit
+   * @param selected output variable for the number of selected values
+   * @param pci PCI to filter
+   * @param col_idx index of the iterator to filter
+   * @param type type of the column
+   * @param val filter value
+   * @param nullable whether tuples whose value is NULL must be filtered out too
+   */
+  void EmitPCIVectorFilter(Bytecode bytecode, LocalVar selected, LocalVar pci, uint32_t col_idx, int8_t type,
+                           double val, bool nullable);
+
+  /**
+   * Filter a VARCHAR column in the iterator by a string constant, or a prefix or LIKE pattern
+   * @param bytecode filter bytecode to emit
+   * @param selected output variable for the number of selected values
+   * @param pci PCI to filter
+   * @param col_idx index of the iterator to filter
+   * @param length length of the string
+   * @param data address of the string's characters
+   * @param nullable whether tuples whose value is NULL must be filtered out too
+   */
+  void EmitPCIVectorStringFilter(Bytecode bytecode, LocalVar selected, LocalVar pci, uint32_t col_idx,
+                                 uint64_t length, uintptr_t data, bool nullable);
+
+  /**
+   * Filter a column in the iterator by whether its values are NULL
+   * @param bytecode filter bytecode to emit
+   * @param selected output variable for the number of selected values
+   * @param pci PCI to filter
+   * @param col_idx index of the iterator to filter
+   */
+  void EmitPCIVectorNullFilter(Bytecode bytecode, LocalVar selected, LocalVar pci, uint32_t col_idx);
 
   /**
    * Insert a filter flavor into the filter manager builder
    */
   void EmitFilterManagerInsertFlavor(LocalVar fmb, FunctionId func);
 
+  /**
+   * Insert a clause filtering probe tuples through the bloom filter of a join hash table into the filter manager
+   */
+  void EmitFilterManagerInsertJoinFilter(LocalVar fmb, LocalVar join_hash_table, FunctionId hash_fn);
+
   /**
    * Lookup a single entry in the aggregation hash table
    */
@@ -222,10 +222,12 @@ VM_OP_HOT void OpTableVectorIteratorGetPCI(terrier::execution::sql::ProjectedCol
   *pci = iter->GetProjectedColumnsIterator();
 }
 
-VM_OP_HOT void OpParallelScanTable(const uint32_t db_oid, const uint32_t table_oid, void *const query_state,
+VM_OP_HOT void OpParallelScanTable(const uint32_t table_oid, uint32_t *const col_oids, const uint32_t num_oids,
+                                   void *const query_state, terrier::execution::exec::ExecutionContext *const exec_ctx,
                                    terrier::execution::sql::ThreadStateContainer *const thread_states,
                                    const terrier::execution::sql::TableVectorIterator::ScanFn scanner) {
-  terrier::execution::sql::TableVectorIterator::ParallelScan(db_oid, table_oid, query_state, thread_states, scanner);
+  terrier::execution::sql::TableVectorIterator::ParallelScan(table_oid, col_oids, num_oids, query_state, exec_ctx,
+                                                             thread_states, scanner);
 }
 
 VM_OP_HOT void OpPCIIsFiltered(bool *is_filtered, terrier::execution::sql::ProjectedColumnsIterator *pci) {
@@ -453,22 +455,69 @@ VM_OP_HOT void OpPCIGetVarlenNull(terrier::execution::sql::StringVal *out,
 }
 
 VM_OP void OpPCIFilterEqual(uint64_t *size, terrier::execution::sql::ProjectedColumnsIterator *iter, uint32_t col_idx,
-                            int8_t type, int64_t val);
+                            int8_t type, int64_t val, int8_t nullable);
 
 VM_OP void OpPCIFilterGreaterThan(uint64_t *size, terrier::execution::sql::ProjectedColumnsIterator *iter,
-                                  uint32_t col_idx, int8_t type, int64_t val);
+                                  uint32_t col_idx, int8_t type, int64_t val, int8_t nullable);
 
 VM_OP void OpPCIFilterGreaterThanEqual(uint64_t *size, terrier::execution::sql::ProjectedColumnsIterator *iter,
-                                       uint32_t col_idx, int8_t type, int64_t val);
+                                       uint32_t col_idx, int8_t type, int64_t val, int8_t nullable);
 
 VM_OP void OpPCIFilterLessThan(uint64_t *size, terrier::execution::sql::ProjectedColumnsIterator *iter,
-                               uint32_t col_idx, int8_t type, int64_t val);
+                               uint32_t col_idx, int8_t type, int64_t val, int8_t nullable);
 
 VM_OP void OpPCIFilterLessThanEqual(uint64_t *size, terrier::execution::sql::ProjectedColumnsIterator *iter,
-                                    uint32_t col_idx, int8_t type, int64_t val);
+                                    uint32_t col_idx, int8_t type, int64_t val, int8_t nullable);
 
 VM_OP void OpPCIFilterNotEqual(uint64_t *size, terrier::execution::sql::ProjectedColumnsIterator *iter,
-                               uint32_t col_idx, int8_t type, int64_t val);
+                               uint32_t col_idx, int8_t type, int64_t val, int8_t nullable);
+
+VM_OP void OpPCIFilterEqualReal(uint64_t *size, terrier::execution::sql::ProjectedColumnsIterator *iter,
+                                uint32_t col_idx, int8_t type, double val, int8_t nullable);
+
+VM_OP void OpPCIFilterGreaterThanReal(uint64_t *size, terrier::execution::sql::ProjectedColumnsIterator *iter,
+                                      uint32_t col_idx, int8_t type, double val, int8_t nullable);
+
+VM_OP void OpPCIFilterGreaterThanEqualReal(uint64_t *size, terrier::execution::sql::ProjectedColumnsIterator *iter,
+                                           uint32_t col_idx, int8_t type, double val, int8_t nullable);
+
+VM_OP void OpPCIFilterLessThanReal(uint64_t *size, terrier::execution::sql::ProjectedColumnsIterator *iter,
+                                   uint32_t col_idx, int8_t type, double val, int8_t nullable);
+
+VM_OP void OpPCIFilterLessThanEqualReal(uint64_t *size, terrier::execution::sql::ProjectedColumnsIterator *iter,
+                                        uint32_t col_idx, int8_t type, double val, int8_t nullable);
+
+VM_OP void OpPCIFilterNotEqualReal(uint64_t *size, terrier::execution::sql::ProjectedColumnsIterator *iter,
+                                   uint32_t col_idx, int8_t type, double val, int8_t nullable);
+
+VM_OP void OpPCIFilterEqualString(uint64_t *size, terrier::execution::sql::ProjectedColumnsIterator *iter,
+                                  uint32_t col_idx, uint64_t length, uintptr_t data, int8_t nullable);
+
+VM_OP void OpPCIFilterGreaterThanString(uint64_t *size, terrier::execution::sql::ProjectedColumnsIterator *iter,
+                                        uint32_t col_idx, uint64_t length, uintptr_t data, int8_t nullable);
+
+VM_OP void OpPCIFilterGreaterThanEqualString(uint64_t *size, terrier::execution::sql::ProjectedColumnsIterator *iter,
+                                             uint32_t col_idx, uint64_t length, uintptr_t data, int8_t nullable);
+
+VM_OP void OpPCIFilterLessThanString(uint64_t *size, terrier::execution::sql::ProjectedColumnsIterator *iter,
+                                     uint32_t col_idx, uint64_t length, uintptr_t data, int8_t nullable);
+
+VM_OP void OpPCIFilterLessThanEqualString(uint64_t *size, terrier::execution::sql::ProjectedColumnsIterator *iter,
+                                          uint32_t col_idx, uint64_t length, uintptr_t data, int8_t nullable);
+
+VM_OP void OpPCIFilterNotEqualString(uint64_t *size, terrier::execution::sql::ProjectedColumnsIterator *iter,
+                                     uint32_t col_idx, uint64_t length, uintptr_t data, int8_t nullable);
+
+VM_OP void OpPCIFilterPrefix(uint64_t *size, terrier::execution::sql::ProjectedColumnsIterator *iter, uint32_t col_idx,
+                             uint64_t length, uintptr_t data, int8_t nullable);
+
+VM_OP void OpPCIFilterLike(uint64_t *size, terrier::execution::sql::ProjectedColumnsIterator *iter, uint32_t col_idx,
+                           uint64_t length, uintptr_t data, int8_t nullable);
+
+VM_OP void OpPCIFilterNull(uint64_t *size, terrier::execution::sql::ProjectedColumnsIterator *iter, uint32_t col_idx);
+
+VM_OP void OpPCIFilterNotNull(uint64_t *size, terrier::execution::sql::ProjectedColumnsIterator *iter,
+                              uint32_t col_idx);
 
 // ---------------------------------------------------------
 // Hashing
@@ -505,6 +554,10 @@ VM_OP void OpFilterManagerStartNewClause(terrier::execution::sql::FilterManager
 VM_OP void OpFilterManagerInsertFlavor(terrier::execution::sql::FilterManager *filter_manager,
                                        terrier::execution::sql::FilterManager::MatchFn flavor);
 
+VM_OP void OpFilterManagerInsertJoinFilter(terrier::execution::sql::FilterManager *filter_manager,
+                                           terrier::execution::sql::JoinHashTable *join_hash_table,
+                                           terrier::execution::sql::FilterManager::HashFn hash_fn);
+
 VM_OP void OpFilterManagerFinalize(terrier::execution::sql::FilterManager *filter_manager);
 
 VM_OP void OpFilterManagerRunFilters(terrier::execution::sql::FilterManager *filter_manager,
@@ -1325,6 +1378,14 @@ VM_OP_HOT void OpIndexIteratorAdvance(bool *has_more, terrier::execution::sql::I
   *has_more = iter->Advance();
 }
 
+VM_OP_HOT void OpIndexIteratorAddBatchKey(terrier::execution::sql::IndexIterator *iter) { iter->AddBatchKey(); }
+
+VM_OP_HOT void OpIndexIteratorScanKeyBatch(terrier::execution::sql::IndexIterator *iter) { iter->ScanKeyBatch(); }
+
+VM_OP_HOT void OpIndexIteratorNextBatchKey(bool *has_more, terrier::execution::sql::IndexIterator *iter) {
+  *has_more = iter->NextBatchKey();
+}
+
 VM_OP_HOT void OpIndexIteratorGetTinyInt(terrier::execution::sql::Integer *out,
                                          terrier::execution::sql::IndexIterator *iter, uint16_t col_idx) {
   // Read
@@ -62,6 +62,19 @@ class BytecodeModule {
     return BytecodeIterator(code_, start, end);
   }
 
+  /**
+   * Controls whether the interpreter runs this module's code with superinstructions fused in, which it does unless
+   * told otherwise. Only the interpreter ever sees superinstructions; iterators and the LLVM engine see the code as it
+   * was generated.
+   * @param enabled whether to interpret using superinstructions
+   */
+  void SetSuperinstructionsEnabled(bool enabled) { superinstructions_enabled_ = enabled; }
+
+  /**
+   * @return true if the interpreter runs this module's code with superinstructions fused in
+   */
+  bool SuperinstructionsEnabled() const { return superinstructions_enabled_; }
+
   /**
    * Pretty print all the module's contents into the provided output stream
    * @param os The stream into which we dump the module's contents
@@ -90,18 +103,23 @@ class BytecodeModule {
 
  private:
   friend class VM;
+  friend class LLVMEngine;
 
   const uint8_t *GetBytecodeForFunction(const FunctionInfo &func) const {
     // NOLINTNEXTLINE
     auto [start, _] = func.BytecodeRange();
     (void)_;
-    return &code_[start];
+    return superinstructions_enabled_ ? &interpreter_code_[start] : &code_[start];
   }
 
  private:
   const std::string name_;
   const std::vector<uint8_t> code_;
   const std::vector<FunctionInfo> functions_;
+  // A copy of the code where the first opcode of every fused sequence is
+  // replaced by its superinstruction. Positions match those in code_.
+  const std::vector<uint8_t> interpreter_code_;
+  bool superinstructions_enabled_{true};
 };
 
 }  // namespace terrier::execution::vm
@@ -2,6 +2,7 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <vector>
 
 #include "common/macros.h"
 #include "execution/util/execution_common.h"
@@ -105,8 +106,8 @@ namespace terrier::execution::vm {
   F(TableVectorIteratorNext, OperandType::Local, OperandType::Local)                                                  \
   F(TableVectorIteratorFree, OperandType::Local)                                                                      \
   F(TableVectorIteratorGetPCI, OperandType::Local, OperandType::Local)                                                \
-  F(ParallelScanTable, OperandType::UImm4, OperandType::UImm4, OperandType::Local, OperandType::Local,                \
-    OperandType::FunctionId)                                                                                          \
+  F(ParallelScanTable, OperandType::UImm4, OperandType::Local, OperandType::UImm4, OperandType::Local,                \
+    OperandType::Local, OperandType::Local, OperandType::FunctionId)                                                  \
                                                                                                                       \
   /* ProjectedColumns Iterator (PCI) */                                                                               \
   F(PCIIsFiltered, OperandType::Local, OperandType::Local)                                                            \
@@ -135,22 +136,54 @@ namespace terrier::execution::vm {
   F(PCIGetDecimalNull, OperandType::Local, OperandType::Local, OperandType::UImm2)                                    \
   F(PCIGetDateNull, OperandType::Local, OperandType::Local, OperandType::UImm2)                                       \
   F(PCIGetVarlenNull, OperandType::Local, OperandType::Local, OperandType::UImm2)                                     \
-  F(PCIFilterEqual, OperandType::Local, OperandType::Local, OperandType::UImm4, OperandType::Imm1, OperandType::Imm8) \
+  F(PCIFilterEqual, OperandType::Local, OperandType::Local, OperandType::UImm4, OperandType::Imm1,                    \
+    OperandType::Imm8, OperandType::Imm1)                                                                             \
   F(PCIFilterGreaterThan, OperandType::Local, OperandType::Local, OperandType::UImm4, OperandType::Imm1,              \
-    OperandType::Imm8)                                                                                                \
+    OperandType::Imm8, OperandType::Imm1)                                                                             \
   F(PCIFilterGreaterThanEqual, OperandType::Local, OperandType::Local, OperandType::UImm4, OperandType::Imm1,         \
-    OperandType::Imm8)                                                                                                \
+    OperandType::Imm8, OperandType::Imm1)                                                                             \
   F(PCIFilterLessThan, OperandType::Local, OperandType::Local, OperandType::UImm4, OperandType::Imm1,                 \
-    OperandType::Imm8)                                                                                                \
+    OperandType::Imm8, OperandType::Imm1)                                                                             \
   F(PCIFilterLessThanEqual, OperandType::Local, OperandType::Local, OperandType::UImm4, OperandType::Imm1,            \
-    OperandType::Imm8)                                                                                                \
+    OperandType::Imm8, OperandType::Imm1)                                                                             \
   F(PCIFilterNotEqual, OperandType::Local, OperandType::Local, OperandType::UImm4, OperandType::Imm1,                 \
-    OperandType::Imm8)                                                                                                \
+    OperandType::Imm8, OperandType::Imm1)                                                                             \
+  F(PCIFilterEqualReal, OperandType::Local, OperandType::Local, OperandType::UImm4, OperandType::Imm1,                \
+    OperandType::Imm8F, OperandType::Imm1)                                                                            \
+  F(PCIFilterGreaterThanReal, OperandType::Local, OperandType::Local, OperandType::UImm4, OperandType::Imm1,          \
+    OperandType::Imm8F, OperandType::Imm1)                                                                            \
+  F(PCIFilterGreaterThanEqualReal, OperandType::Local, OperandType::Local, OperandType::UImm4, OperandType::Imm1,     \
+    OperandType::Imm8F, OperandType::Imm1)                                                                            \
+  F(PCIFilterLessThanReal, OperandType::Local, OperandType::Local, OperandType::UImm4, OperandType::Imm1,             \
+    OperandType::Imm8F, OperandType::Imm1)                                                                            \
+  F(PCIFilterLessThanEqualReal, OperandType::Local, OperandType::Local, OperandType::UImm4, OperandType::Imm1,        \
+    OperandType::Imm8F, OperandType::Imm1)                                                                            \
+  F(PCIFilterNotEqualReal, OperandType::Local, OperandType::Local, OperandType::UImm4, OperandType::Imm1,             \
+    OperandType::Imm8F, OperandType::Imm1)                                                                            \
+  F(PCIFilterEqualString, OperandType::Local, OperandType::Local, OperandType::UImm4, OperandType::Imm8,              \
+    OperandType::Imm8, OperandType::Imm1)                                                                             \
+  F(PCIFilterGreaterThanString, OperandType::Local, OperandType::Local, OperandType::UImm4, OperandType::Imm8,        \
+    OperandType::Imm8, OperandType::Imm1)                                                                             \
+  F(PCIFilterGreaterThanEqualString, OperandType::Local, OperandType::Local, OperandType::UImm4, OperandType::Imm8,   \
+    OperandType::Imm8, OperandType::Imm1)                                                                             \
+  F(PCIFilterLessThanString, OperandType::Local, OperandType::Local, OperandType::UImm4, OperandType::Imm8,           \
+    OperandType::Imm8, OperandType::Imm1)                                                                             \
+  F(PCIFilterLessThanEqualString, OperandType::Local, OperandType::Local, OperandType::UImm4, OperandType::Imm8,      \
+    OperandType::Imm8, OperandType::Imm1)                                                                             \
+  F(PCIFilterNotEqualString, OperandType::Local, OperandType::Local, OperandType::UImm4, OperandType::Imm8,           \
+    OperandType::Imm8, OperandType::Imm1)                                                                             \
+  F(PCIFilterPrefix, OperandType::Local, OperandType::Local, OperandType::UImm4, OperandType::Imm8,                   \
+    OperandType::Imm8, OperandType::Imm1)                                                                             \
+  F(PCIFilterLike, OperandType::Local, OperandType::Local, OperandType::UImm4, OperandType::Imm8, OperandType::Imm8,  \
+    OperandType::Imm1)                                                                                                \
+  F(PCIFilterNull, OperandType::Local, OperandType::Local, OperandType::UImm4)                                        \
+  F(PCIFilterNotNull, OperandType::Local, OperandType::Local, OperandType::UImm4)                                     \
                                                                                                                       \
   /* Filter Manager */                                                                                                \
   F(FilterManagerInit, OperandType::Local)                                                                            \
   F(FilterManagerStartNewClause, OperandType::Local)                                                                  \
   F(FilterManagerInsertFlavor, OperandType::Local, OperandType::FunctionId)                                           \
+  F(FilterManagerInsertJoinFilter, OperandType::Local, OperandType::Local, OperandType::FunctionId)                   \
   F(FilterManagerFinalize, OperandType::Local)                                                                        \
   F(FilterManagerRunFilters, OperandType::Local, OperandType::Local)                                                  \
   F(FilterManagerFree, OperandType::Local)                                                                            \
@@ -327,6 +360,9 @@ namespace terrier::execution::vm {
   F(IndexIteratorScanKey, OperandType::Local)                                                                         \
   F(IndexIteratorFree, OperandType::Local)                                                                            \
   F(IndexIteratorAdvance, OperandType::Local, OperandType::Local)                                                     \
+  F(IndexIteratorAddBatchKey, OperandType::Local)                                                                     \
+  F(IndexIteratorScanKeyBatch, OperandType::Local)                                                                    \
+  F(IndexIteratorNextBatchKey, OperandType::Local, OperandType::Local)                                                \
   F(IndexIteratorGetTinyInt, OperandType::Local, OperandType::Local, OperandType::UImm2)                              \
   F(IndexIteratorGetSmallInt, OperandType::Local, OperandType::Local, OperandType::UImm2)                             \
   F(IndexIteratorGetInteger, OperandType::Local, OperandType::Local, OperandType::UImm2)                              \
@@ -401,12 +437,69 @@ namespace terrier::execution::vm {
   F(Trim, OperandType::Local, OperandType::Local, OperandType::Local, OperandType::Local)                             \
   F(Upper, OperandType::Local, OperandType::Local, OperandType::Local)
 
+// Creates superinstructions fusing a given opcode for all integer primitive types with the bytecode that follows it
+#define CREATE_SUPERINSTRUCTIONS_FOR_INT_TYPES(F, op, next)              \
+  F(op##_##int8_t##_##next, Bytecode::op##_##int8_t, Bytecode::next)     \
+  F(op##_##int16_t##_##next, Bytecode::op##_##int16_t, Bytecode::next)   \
+  F(op##_##int32_t##_##next, Bytecode::op##_##int32_t, Bytecode::next)   \
+  F(op##_##int64_t##_##next, Bytecode::op##_##int64_t, Bytecode::next)   \
+  F(op##_##uint8_t##_##next, Bytecode::op##_##uint8_t, Bytecode::next)   \
+  F(op##_##uint16_t##_##next, Bytecode::op##_##uint16_t, Bytecode::next) \
+  F(op##_##uint32_t##_##next, Bytecode::op##_##uint32_t, Bytecode::next) \
+  F(op##_##uint64_t##_##next, Bytecode::op##_##uint64_t, Bytecode::next)
+
+// Creates superinstructions fusing an 8-byte immediate assignment with a given opcode for all integer primitive types
+#define CREATE_IMM_SUPERINSTRUCTIONS_FOR_INT_TYPES(F, op)                          \
+  F(AssignImm8_##op##_##int8_t, Bytecode::AssignImm8, Bytecode::op##_##int8_t)     \
+  F(AssignImm8_##op##_##int16_t, Bytecode::AssignImm8, Bytecode::op##_##int16_t)   \
+  F(AssignImm8_##op##_##int32_t, Bytecode::AssignImm8, Bytecode::op##_##int32_t)   \
+  F(AssignImm8_##op##_##int64_t, Bytecode::AssignImm8, Bytecode::op##_##int64_t)   \
+  F(AssignImm8_##op##_##uint8_t, Bytecode::AssignImm8, Bytecode::op##_##uint8_t)   \
+  F(AssignImm8_##op##_##uint16_t, Bytecode::AssignImm8, Bytecode::op##_##uint16_t) \
+  F(AssignImm8_##op##_##uint32_t, Bytecode::AssignImm8, Bytecode::op##_##uint32_t) \
+  F(AssignImm8_##op##_##uint64_t, Bytecode::AssignImm8, Bytecode::op##_##uint64_t)
+
+/**
+ * The list of all superinstructions, each followed by the sequence of bytecodes it fuses. The bytecode generator emits
+ * these sequences back-to-back in every loop header, filter and counter update. To check the choice against a
+ * workload, build with TPL_DEBUG_TRACE_INSTRUCTIONS and interpret it with superinstructions disabled: the VM then logs
+ * the pairs of bytecodes it dispatched most often. Superinstructions are never emitted: the interpreter's copy of a
+ * module's code has the first opcode of each fused sequence overwritten, leaving every operand and the remaining
+ * opcodes where they were (see BytecodeModule). Jump offsets thus stay valid, as do jumps into the middle of a
+ * sequence, and everything but the interpreter keeps seeing the original bytecode.
+ */
+#define SUPERINSTRUCTION_LIST(F)                                                                                       \
+  /* Loop headers */                                                                                                   \
+  F(TableVectorIteratorNext_JumpIfFalse, Bytecode::TableVectorIteratorNext, Bytecode::JumpIfFalse)                     \
+  F(PCIHasNext_JumpIfFalse, Bytecode::PCIHasNext, Bytecode::JumpIfFalse)                                               \
+  F(PCIHasNextFiltered_JumpIfFalse, Bytecode::PCIHasNextFiltered, Bytecode::JumpIfFalse)                               \
+  CREATE_SUPERINSTRUCTIONS_FOR_INT_TYPES(F, GreaterThan, JumpIfFalse)                                                  \
+  CREATE_SUPERINSTRUCTIONS_FOR_INT_TYPES(F, GreaterThanEqual, JumpIfFalse)                                             \
+  CREATE_SUPERINSTRUCTIONS_FOR_INT_TYPES(F, Equal, JumpIfFalse)                                                        \
+  CREATE_SUPERINSTRUCTIONS_FOR_INT_TYPES(F, LessThan, JumpIfFalse)                                                     \
+  CREATE_SUPERINSTRUCTIONS_FOR_INT_TYPES(F, LessThanEqual, JumpIfFalse)                                                \
+  CREATE_SUPERINSTRUCTIONS_FOR_INT_TYPES(F, NotEqual, JumpIfFalse)                                                     \
+                                                                                                                       \
+  /* SQL filters */                                                                                                    \
+  F(GreaterThanInteger_JumpIfFalse, Bytecode::GreaterThanInteger, Bytecode::ForceBoolTruth, Bytecode::JumpIfFalse)     \
+  F(GreaterThanEqualInteger_JumpIfFalse, Bytecode::GreaterThanEqualInteger, Bytecode::ForceBoolTruth,                  \
+    Bytecode::JumpIfFalse)                                                                                             \
+  F(EqualInteger_JumpIfFalse, Bytecode::EqualInteger, Bytecode::ForceBoolTruth, Bytecode::JumpIfFalse)                 \
+  F(LessThanInteger_JumpIfFalse, Bytecode::LessThanInteger, Bytecode::ForceBoolTruth, Bytecode::JumpIfFalse)           \
+  F(LessThanEqualInteger_JumpIfFalse, Bytecode::LessThanEqualInteger, Bytecode::ForceBoolTruth, Bytecode::JumpIfFalse) \
+  F(NotEqualInteger_JumpIfFalse, Bytecode::NotEqualInteger, Bytecode::ForceBoolTruth, Bytecode::JumpIfFalse)           \
+                                                                                                                       \
+  /* Counters and induction variables */                                                                               \
+  CREATE_IMM_SUPERINSTRUCTIONS_FOR_INT_TYPES(F, Add)                                                                   \
+  CREATE_IMM_SUPERINSTRUCTIONS_FOR_INT_TYPES(F, Sub)
+
 /**
- * The single enumeration of all possible bytecode instructions
+ * The single enumeration of all possible bytecode instructions, followed by all superinstructions
  */
 enum class Bytecode : uint32_t {
 #define DECLARE_OP(inst, ...) inst,
   BYTECODE_LIST(DECLARE_OP)
+  SUPERINSTRUCTION_LIST(DECLARE_OP)
 #undef DECLARE_OP
 #define COUNT_OP(inst, ...) +1
       Last = -1 BYTECODE_LIST(COUNT_OP)
@@ -428,13 +521,27 @@ class Bytecodes {
    */
   static constexpr uint32_t NumBytecodes() { return K_BYTECODE_COUNT; }
 
+  /**
+   * The total number of superinstructions
+   */
+  static constexpr const uint32_t K_SUPERINSTRUCTION_COUNT = 0
+#define COUNT_OP(inst, ...) +1
+      SUPERINSTRUCTION_LIST(COUNT_OP)
+#undef COUNT_OP
+      ;
+
+  /**
+   * @return total number of superinstructions
+   */
+  static constexpr uint32_t NumSuperinstructions() { return K_SUPERINSTRUCTION_COUNT; }
+
   /**
    * @return the maximum length of any bytecode instruction in bytes
    */
   static uint32_t MaxBytecodeNameLength();
 
   /**
-   * @param bytecode bytecode to convert
+   * @param bytecode bytecode or superinstruction to convert
    * @return the string representation of the given bytecode
    */
   static const char *ToString(Bytecode bytecode) { return k_bytecode_names[static_cast<uint32_t>(bytecode)]; }
@@ -504,7 +611,7 @@ class Bytecodes {
    * @return byte representation of the given bytecode
    */
   static constexpr std::underlying_type_t<Bytecode> ToByte(Bytecode bytecode) {
-    TERRIER_ASSERT(bytecode <= Bytecode::Last, "Invalid bytecode");
+    TERRIER_ASSERT(static_cast<uint32_t>(bytecode) < K_BYTECODE_COUNT + K_SUPERINSTRUCTION_COUNT, "Invalid bytecode");
     return static_cast<std::underlying_type_t<Bytecode>>(bytecode);
   }
 
@@ -516,7 +623,7 @@ class Bytecodes {
    */
   static constexpr Bytecode FromByte(std::underlying_type_t<Bytecode> val) {
     auto bytecode = static_cast<Bytecode>(val);
-    TERRIER_ASSERT(bytecode <= Bytecode::Last, "Invalid bytecode");
+    TERRIER_ASSERT(val < K_BYTECODE_COUNT + K_SUPERINSTRUCTION_COUNT, "Invalid bytecode");
     return bytecode;
   }
 
@@ -545,12 +652,29 @@ class Bytecodes {
     return bytecode == Bytecode::Jump || bytecode == Bytecode::Return;
   }
 
+  /**
+   * Checks whether the given bytecode is a superinstruction
+   * @param bytecode bytecode to check
+   * @return whether the given bytecode is a superinstruction
+   */
+  static constexpr bool IsSuperinstruction(Bytecode bytecode) { return bytecode > Bytecode::Last; }
+
+  /**
+   * @param superinstruction superinstruction for which the fused bytecodes are needed
+   * @return the sequence of bytecodes the given superinstruction fuses
+   */
+  static const std::vector<Bytecode> &GetFusedBytecodes(Bytecode superinstruction) {
+    TERRIER_ASSERT(IsSuperinstruction(superinstruction), "Only superinstructions fuse bytecodes");
+    return k_superinstruction_bytecodes[static_cast<uint32_t>(superinstruction) - K_BYTECODE_COUNT];
+  }
+
  private:
   static const char *k_bytecode_names[];
   static uint32_t k_bytecode_operand_counts[];
   static const OperandType *k_bytecode_operand_types[];
   static const OperandSize *k_bytecode_operand_sizes[];
   static const char *k_bytecode_handler_name[];
+  static const std::vector<Bytecode> k_superinstruction_bytecodes[];
 };
 
 }  // namespace terrier::execution::vm
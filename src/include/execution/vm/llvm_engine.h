@@ -1,13 +1,19 @@
 #pragma once
 
+#include <atomic>
+#include <future>  // NOLINT
+#include <list>
 #include <memory>
+#include <mutex>  // NOLINT
 #include <string>
 #include <unordered_map>
+#include <utility>
 
 #include "llvm/Support/MemoryBuffer.h"
 
 #include "common/macros.h"
 #include "execution/util/execution_common.h"
+#include "execution/vm/bytecode_function_info.h"
 #include "execution/vm/bytecodes.h"
 
 namespace terrier::execution::ast {
@@ -35,6 +41,7 @@ class LLVMEngine {
   class CompilerOptions;
   class CompiledModule;
   class CompiledModuleBuilder;
+  class CompiledModuleCache;
 
   // -------------------------------------------------------
   // Public API
@@ -58,6 +65,19 @@ class LLVMEngine {
    */
   static std::unique_ptr<CompiledModule> Compile(const BytecodeModule &module, const CompilerOptions &options);
 
+  /**
+   * JIT compile a single function of a TPL bytecode module to native code. The other functions of the module it calls
+   * are not compiled along, and must be provided by the caller.
+   * @param module The module containing the function
+   * @param func_id The ID of the function to compile
+   * @param options The compiler options
+   * @param external_functions The addresses of the module's other functions, by name
+   * @return The JIT compiled module, containing only the given function
+   */
+  static std::unique_ptr<CompiledModule> CompileFunction(
+      const BytecodeModule &module, FunctionId func_id, const CompilerOptions &options,
+      const std::unordered_map<std::string, void *> &external_functions);
+
   // -------------------------------------------------------
   // Compiler Options
   // -------------------------------------------------------
@@ -88,6 +108,21 @@ class LLVMEngine {
      */
     bool IsDebug() const { return debug_; }
 
+    /**
+     * Set the optimization level, from 0 to 3, like -O. Levels below 2 skip inlining of TPL functions.
+     * @param opt_level the optimization level
+     * @return the updated object
+     */
+    CompilerOptions &SetOptLevel(uint32_t opt_level) {
+      opt_level_ = opt_level;
+      return *this;
+    }
+
+    /**
+     * @return the optimization level
+     */
+    uint32_t GetOptLevel() const { return opt_level_; }
+
     /**
      * Set the persisting option
      * @param write_obj_file the persisting options
@@ -104,7 +139,7 @@ class LLVMEngine {
     bool ShouldPersistObjectFile() const { return write_obj_file_; }
 
     /**
-     * Set the output file name
+     * Set the output file name. If empty, object files are named after the module.
      * @param name name of the file
      * @return the updated object
      */
@@ -125,6 +160,7 @@ class LLVMEngine {
 
    private:
     bool debug_{false};
+    uint32_t opt_level_{3};
     bool write_obj_file_{false};
     std::string output_file_name_;
   };
@@ -177,8 +213,11 @@ class LLVMEngine {
     /**
      * Load the given module @em module into memory. If this module has already
      * been loaded, it will not be reloaded.
+     * @param module The bytecode module this module was compiled from
+     * @param external_functions The addresses of functions the module calls
+     *        but does not define, by name
      */
-    void Load(const BytecodeModule &module);
+    void Load(const BytecodeModule &module, const std::unordered_map<std::string, void *> &external_functions = {});
 
     /**
      * Has this module been loaded into memory and linked?
@@ -191,6 +230,145 @@ class LLVMEngine {
     std::unique_ptr<TPLMemoryManager> memory_manager_;
     std::unordered_map<std::string, void *> functions_;
   };
+
+  // -------------------------------------------------------
+  // Compiled Module Cache
+  // -------------------------------------------------------
+
+  /**
+   * A process-wide cache of compiled modules, keyed on the contents of the bytecode modules they were compiled from.
+   * Queries of the same shape generate the same bytecode, so all but the first get their machine code from the cache
+   * without going through LLVM's optimization and code generation. Cached modules are loaded and linked once, and
+   * shared by every Module using them.
+   *
+   * If the cache's options persist object files, modules compiled on a miss are also written to the current
+   * directory, under a name derived from the hash of their contents, along with a key file holding their full contents
+   * and a stamp of the bytecode handlers, LLVM version, target and optimization level they were compiled with. Later
+   * misses, including those of other processes, load such files instead of compiling, if the key file matches.
+   *
+   * The cache holds at most a fixed number of modules, evicting the least recently used one when full. It is
+   * thread-safe. Concurrent misses on the same module compile it only once.
+   *
+   * Modules that initialize strings from literals, or filter VARCHAR columns by them, are not cached. Their bytecode
+   * embeds the address of the literal's characters, which are owned by the query that generated the module, so no two
+   * queries share such a module and its machine code must not outlive the query.
+   */
+  class CompiledModuleCache {
+   public:
+    /**
+     * Default number of modules the cache holds
+     */
+    static constexpr uint32_t K_DEFAULT_CAPACITY = 1024;
+
+    /**
+     * Construct an empty cache
+     * @param capacity maximum number of modules in the cache
+     */
+    explicit CompiledModuleCache(uint32_t capacity = K_DEFAULT_CAPACITY) : capacity_(capacity) {}
+
+    /**
+     * This class cannot be copied or moved
+     */
+    DISALLOW_COPY_AND_MOVE(CompiledModuleCache);
+
+    /**
+     * @return the cache shared by all modules of the process
+     */
+    static CompiledModuleCache *Instance();
+
+    /**
+     * Return the compiled and loaded code of the given module, compiling it if no module with the same contents is in
+     * the cache. If another thread is compiling it, waits for that compilation. If compilation throws, the exception
+     * is passed on to every request waiting on it, and the module is not cached. Modules that cannot be cached are
+     * compiled on every call.
+     * @param module The module to compile
+     * @return The JIT compiled module
+     */
+    std::shared_ptr<CompiledModule> GetOrCompile(const BytecodeModule &module);
+
+    /**
+     * @param module The module to look for
+     * @return true if a module with the same contents is compiled and in the cache. GetOrCompile() then returns
+     * without waiting.
+     */
+    bool Contains(const BytecodeModule &module);
+
+    /**
+     * Set the options used to compile modules on a miss. Only affects later misses.
+     * @param options The compiler options
+     */
+    void SetOptions(const CompilerOptions &options) {
+      std::lock_guard<std::mutex> guard(latch_);
+      options_ = options;
+    }
+
+    /**
+     * Drop all modules from the cache. Modules in use stay alive until they are no longer used.
+     */
+    void Clear();
+
+    /**
+     * @return number of modules in the cache
+     */
+    uint64_t Size() const {
+      std::lock_guard<std::mutex> guard(latch_);
+      return entries_.size();
+    }
+
+    /**
+     * @return number of requests for a module that was in the cache
+     */
+    uint64_t NumHits() const { return num_hits_.load(std::memory_order_relaxed); }
+
+    /**
+     * @return number of requests for a module that was not in the cache, and was compiled or loaded from a file
+     */
+    uint64_t NumMisses() const { return num_misses_.load(std::memory_order_relaxed); }
+
+    /**
+     * @return number of misses that loaded the module from a persisted object file instead of compiling it
+     */
+    uint64_t NumFileLoads() const { return num_file_loads_.load(std::memory_order_relaxed); }
+
+    /**
+     * @return number of requests for a module that cannot be cached, and was compiled without looking in the cache
+     */
+    uint64_t NumUncacheable() const { return num_uncacheable_.load(std::memory_order_relaxed); }
+
+   private:
+    // A module in the cache, which is ready once its compilation is done. The id tells apart entries for the same key
+    // that were evicted and added again.
+    struct Entry {
+      std::shared_future<std::shared_ptr<CompiledModule>> module_;
+      std::list<std::string>::iterator lru_pos_;
+      uint64_t id_;
+    };
+
+    // Serialize everything code generation depends on: the bytecode, and the name, type and frame layout of each
+    // function
+    static std::string CacheKey(const BytecodeModule &module);
+
+    // Can the module's machine code be shared with other modules? Not if it embeds addresses owned by its query.
+    static bool IsCacheable(const BytecodeModule &module);
+
+    // Identify everything besides the module that persisted machine code depends on: the bytecode handlers inlined
+    // into it, which are generated along with the rest of the build, the LLVM version, the target and the optimization
+    // level. Returns an empty string if the bytecode handlers cannot be read.
+    static std::string CodeGenStamp(const CompilerOptions &options);
+
+    // Compile the module, or load it from the object file it was persisted to
+    std::shared_ptr<CompiledModule> CompileOrLoad(const BytecodeModule &module, const std::string &key,
+                                                  CompilerOptions options);
+
+    const uint32_t capacity_;
+    mutable std::mutex latch_;
+    CompilerOptions options_;
+    std::unordered_map<std::string, Entry> entries_;
+    // Keys of the entries, most recently used first
+    std::list<std::string> lru_;
+    uint64_t next_entry_id_ = 0;
+    std::atomic<uint64_t> num_hits_{0}, num_misses_{0}, num_file_loads_{0}, num_uncacheable_{0};
+  };
 };
 
 }  // namespace terrier::execution::vm
@@ -2,8 +2,10 @@
 
 #include <atomic>
 #include <memory>
+#include <mutex>  // NOLINT
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "llvm/Support/Memory.h"
 
@@ -13,6 +15,7 @@
 
 namespace terrier::execution::vm::test {
 class BytecodeTrampolineTest;
+class ModuleTieringTest;
 }  // namespace terrier::execution::vm::test
 
 namespace terrier::execution::vm {
@@ -23,9 +26,11 @@ namespace terrier::execution::vm {
 enum class ExecutionMode : uint8_t {
   // Always execute in interpreted mode
   Interpret,
-  // Execute in interpreted mode, but trigger a compilation asynchronously. As
-  // compiled code becomes available, seamlessly swap it in and execute mixed
-  // interpreter and compiled code.
+  // Execute in interpreted mode, but compile functions asynchronously as they
+  // become hot: first each on its own at a cheap optimization level, then the
+  // whole module at full optimization. As compiled code becomes available,
+  // seamlessly swap it in and execute mixed interpreter and compiled code. The
+  // interpreter hands off to compiled code at function calls.
   Adaptive,
   // Compile and generate all machine code before executing the function
   Compiled
@@ -42,6 +47,18 @@ enum class ExecutionMode : uint8_t {
  */
 class Module {
  public:
+  /**
+   * Number of calls and loop iterations after which a function is hot, and
+   * compiled on its own in adaptive mode.
+   */
+  static constexpr uint32_t K_HOT_FUNCTION_THRESHOLD = 10000;
+
+  /**
+   * Optimization level that hot functions are first compiled at. The whole
+   * module is later compiled at full optimization.
+   */
+  static constexpr uint32_t K_BASELINE_OPT_LEVEL = 1;
+
   /**
    * Create a TPL module using the given bytecode module as the only
    * implementation.
@@ -113,11 +130,21 @@ class Module {
  private:
   friend class VM;
   friend class AsyncCompileTask;
+  friend class AsyncCompileFunctionTask;
   friend class test::BytecodeTrampolineTest;
+  friend class test::ModuleTieringTest;
 
   // This class encapsulates the ability to asynchronously JIT compile a module.
   class AsyncCompileTask;
 
+  // This class encapsulates the ability to asynchronously JIT compile a single
+  // function of a module.
+  class AsyncCompileFunctionTask;
+
+  // Size of the stub through which compiled functions call each other's
+  // current implementation
+  static constexpr uint32_t K_DISPATCH_STUB_SIZE = 16;
+
   // A trampoline is a stub function that serves as a landing point for all
   // functions executed in interpreted mode. The purpose of the trampoline is
   // to arrange and adjust call arguments from the C/C++ ABI to the TPL ABI.
@@ -162,18 +189,67 @@ class Module {
     return jit_module_->GetFunctionPointer(func_info->Name());
   }
 
-  // Compile this module into machine code. This is a blocking call.
+  // Compile this module into machine code, or fetch its machine code from the
+  // compiled module cache. This is a blocking call.
   void CompileToMachineCode();
 
   // Compile this module into machine code. This is a non-blocking call that
-  // triggers a compilation in the background.
+  // triggers a compilation in the background, unless the module's machine code
+  // is already cached, in which case it is swapped in right away.
   void CompileToMachineCodeAsync();
 
+  // Start counting function executions, and compiling hot functions. If the
+  // module's machine code is cached, it is swapped in right away instead.
+  void EnableTiering();
+
+  // Has the module been asked to execute adaptively? Only then does the VM
+  // hand off to compiled code at call boundaries.
+  bool IsAdaptive() const { return adaptive_.load(std::memory_order_relaxed); }
+
+  // Record that the function with ID @em func_id was called, or iterated
+  // through a loop, @em count times. Triggers its compilation once it is hot.
+  // The VM only holds const modules, but swapping in compiled code is not an
+  // observable change.
+  void RecordExecutions(const FunctionId func_id, const uint32_t count) const {
+    if (!tiering_.load(std::memory_order_relaxed) || compile_requested_[func_id].load(std::memory_order_relaxed)) {
+      return;
+    }
+    if (hotness_[func_id].fetch_add(count, std::memory_order_relaxed) + count >= K_HOT_FUNCTION_THRESHOLD &&
+        !compile_requested_[func_id].exchange(true)) {
+      const_cast<Module *>(this)->CompileFunctionToMachineCodeAsync(func_id);  // NOLINT
+    }
+  }
+
+  // Is the current implementation of the function with ID @em func_id
+  // compiled code that the VM can call directly?
+  bool IsCallableCompiledImpl(const FunctionId func_id) const {
+    return vm_callable_[func_id] &&
+           functions_[func_id].load(std::memory_order_relaxed) != bytecode_trampolines_[func_id].Code();
+  }
+
+  // Compile only the function with ID @em func_id into machine code at the
+  // baseline optimization level, and swap it in. Triggers a compilation of the
+  // whole module afterwards. This is a blocking call.
+  void CompileFunctionToMachineCode(FunctionId func_id);
+
+  // Like CompileFunctionToMachineCode(), but in the background
+  void CompileFunctionToMachineCodeAsync(FunctionId func_id);
+
+  // Generate one dispatch stub per function, which jumps to the function's
+  // current implementation
+  void CreateDispatchStubs();
+
+  // Access the dispatch stub of the function with ID @em func_id
+  void *GetDispatchStub(const FunctionId func_id) const {
+    return static_cast<uint8_t *>(dispatch_stubs_.Code()) + func_id * K_DISPATCH_STUB_SIZE;
+  }
+
  private:
   // The module containing all TBC (i.e., bytecode) for the TPL program.
   std::unique_ptr<BytecodeModule> bytecode_module_;
-  // The module containing compiled machine code for the TPL program.
-  std::unique_ptr<LLVMEngine::CompiledModule> jit_module_;
+  // The module containing compiled machine code for the TPL program. It may
+  // be shared with other modules through the compiled module cache.
+  std::shared_ptr<LLVMEngine::CompiledModule> jit_module_;
   // Function pointers for all functions defined in the TPL program. Pointers
   // may point into bytecode stub functions (i.e., interpreted implementations),
   // or into compiled machine-code implementations.
@@ -183,6 +259,25 @@ class Module {
   // Compilation flag used to ensure compilation occurs only once, even under
   // concurrent invocations.
   std::once_flag compiled_flag_;
+
+  // Tiering state, for adaptive mode. Whether executions are counted, whether
+  // the module executes adaptively at all, how often each function was
+  // executed, and whether its compilation has been requested. Functions compiled on their own are kept alive in their own
+  // modules, since they may still be running after the whole module has been
+  // compiled.
+  std::atomic<bool> tiering_{false};
+  std::atomic<bool> adaptive_{false};
+  std::unique_ptr<std::atomic<uint32_t>[]> hotness_;
+  std::unique_ptr<std::atomic<bool>[]> compile_requested_;
+  std::atomic<bool> whole_module_requested_{false};
+  std::vector<std::unique_ptr<LLVMEngine::CompiledModule>> function_modules_;
+  // Whether the VM can call the compiled implementation of each function
+  std::unique_ptr<bool[]> vm_callable_;
+  // Dispatch stubs of all functions, created on first use
+  Trampoline dispatch_stubs_;
+  std::once_flag dispatch_stubs_flag_;
+  // Serializes swapping in compiled code
+  std::mutex tiering_latch_;
 };
 
 // ---------------------------------------------------------
@@ -222,12 +317,15 @@ inline bool Module::GetFunction(const std::string &name, const ExecutionMode exe
   }
 
   switch (exec_mode) {
-    case ExecutionMode::Adaptive: {
-      CompileToMachineCodeAsync();
-      TERRIER_FALLTHROUGH;
-    }
+    case ExecutionMode::Adaptive:
     case ExecutionMode::Interpret: {
-      *func = [this, func_info](ArgTypes... args) -> Ret {
+      // Only adaptive execution hands off to compiled code. Interpreted
+      // execution stays interpreted, even once the module has been compiled.
+      const bool adaptive = (exec_mode == ExecutionMode::Adaptive);
+      if (adaptive) {
+        EnableTiering();
+      }
+      *func = [this, func_info, adaptive](ArgTypes... args) -> Ret {
         // NOLINTNEXTLINE: bugprone-suspicious-semicolon: seems like a false positive because of constexpr
         if constexpr (std::is_void_v<Ret>) {
           // Create a temporary on-stack buffer and copy all arguments
@@ -235,7 +333,7 @@ inline bool Module::GetFunction(const std::string &name, const ExecutionMode exe
           detail::CopyAll(arg_buffer, args...);
 
           // Invoke and finish
-          VM::InvokeFunction(this, func_info->Id(), arg_buffer);
+          VM::InvokeFunction(this, func_info->Id(), arg_buffer, adaptive);
           return;
         }
         // The return value
@@ -246,7 +344,7 @@ inline bool Module::GetFunction(const std::string &name, const ExecutionMode exe
         detail::CopyAll(arg_buffer, &rv, args...);
 
         // Invoke and finish
-        VM::InvokeFunction(this, func_info->Id(), arg_buffer);
+        VM::InvokeFunction(this, func_info->Id(), arg_buffer, adaptive);
         return rv;
       };
       break;
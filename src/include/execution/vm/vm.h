@@ -1,5 +1,9 @@
 #pragma once
 
+#ifdef TPL_DEBUG_TRACE_INSTRUCTIONS
+#include <unordered_map>
+#endif
+
 #include "execution/util/execution_common.h"
 #include "execution/util/region_containers.h"
 #include "execution/vm/bytecode_function_info.h"
@@ -18,16 +22,32 @@ class VM {
   /**
    * Invoke the function with ID @em func_id in the module @em module. @em args
    * contains the output and input parameters stored contiguously.
+   * @param hand_off Whether the function, and the functions it calls, may run
+   * their compiled implementation instead of being interpreted. This is only
+   * done if the module also executes adaptively.
+   */
+  static void InvokeFunction(const Module *module, FunctionId func_id, const uint8_t args[], bool hand_off);
+
+  /**
+   * @return true if the VM can call a compiled implementation of the function
+   * @em func_info directly, rather than interpreting it. This is the case if
+   * all the function's arguments and its return value are passed in
+   * general-purpose registers.
    */
-  static void InvokeFunction(const Module *module, FunctionId func_id, const uint8_t args[]);
+  static bool CanInvokeCompiledFunction(const FunctionInfo &func_info);
 
  private:
   // Private constructor to force users to use InvokeFunction
-  explicit VM(const Module *module);
+  VM(const Module *module, bool hand_off);
 
   // This class cannot be copied or moved
   DISALLOW_COPY_AND_MOVE(VM);
 
+#ifdef TPL_DEBUG_TRACE_INSTRUCTIONS
+  // Log the dispatch profile of this VM
+  ~VM();
+#endif
+
   // Forward declare the frame
   class Frame;
 
@@ -37,9 +57,36 @@ class VM {
   // Execute a call instruction
   const uint8_t *ExecuteCall(const uint8_t *ip, Frame *caller);
 
+  // If the function has a compiled implementation that the VM can call, call
+  // it with the parameters stored in the given frame data and return true.
+  static bool InvokeCompiledFunction(const Module *module, const FunctionInfo &func_info, const uint8_t *frame_data);
+
+  // Record a backward jump taken in the function running in the given frame
+  void RecordBackEdge(Frame *frame);
+
  private:
   // The module
   const Module *module_;
+
+  // Whether calls hand off to compiled code
+  const bool hand_off_;
+
+#ifdef TPL_DEBUG_TRACE_INSTRUCTIONS
+  // The number of opcodes the VM dispatches on
+  static constexpr uint32_t K_NUM_OPS = Bytecodes::NumBytecodes() + Bytecodes::NumSuperinstructions();
+
+  // The key of a pair of opcodes in bytecode_pair_counts_
+  static constexpr uint32_t PairKey(uint32_t first, uint32_t second) { return first * K_NUM_OPS + second; }
+
+  // The number of times each bytecode and superinstruction was dispatched
+  uint64_t bytecode_counts_[K_NUM_OPS]{};
+  // The number of times each pair of opcodes was dispatched one right after the other. This is the profile
+  // superinstructions are picked from: interpret a workload with superinstructions disabled, and fuse the pairs
+  // dispatched most often.
+  std::unordered_map<uint32_t, uint64_t> bytecode_pair_counts_;
+  // The opcode dispatched last, or K_NUM_OPS before the first dispatch
+  uint32_t last_bytecode_{K_NUM_OPS};
+#endif
 };
 
 }  // namespace terrier::execution::vm
@@ -64,6 +64,7 @@ class DBMain {
     delete gc_thread_;
     delete metrics_manager_;
     delete garbage_collector_;
+    delete gc_worker_pool_;
     delete settings_manager_;
     delete txn_manager_;
     delete timestamp_manager_;
@@ -105,6 +106,7 @@ class DBMain {
   storage::LogManager *log_manager_;
   storage::GarbageCollector *garbage_collector_;
   storage::GarbageCollectorThread *gc_thread_;
+  common::WorkerPool *gc_worker_pool_;
   network::TerrierServer *server_;
   storage::RecordBufferSegmentPool *buffer_segment_pool_;
   common::WorkerPool *thread_pool_;
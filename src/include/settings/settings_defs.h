@@ -44,6 +44,26 @@ SETTING_int(
     terrier::settings::Callbacks::NoOp
 )
 
+// Timestamp checkout batching
+SETTING_bool(
+    batch_timestamp_checkouts,
+    "Serve concurrent timestamp checkouts together with a single increment of the clock. (default: false)",
+    false,
+    false,
+    terrier::settings::Callbacks::NoOp
+)
+
+// Number of threads the garbage collector spreads its work over
+SETTING_int(
+    gc_num_threads,
+    "The number of threads the garbage collector uses, 1 to collect on the garbage collector thread only (default: 1)",
+    1,
+    1,
+    64,
+    false,
+    terrier::settings::Callbacks::NoOp
+)
+
 // Number of worker pool threads
 SETTING_int(
     num_worker_threads,
@@ -108,6 +128,26 @@ SETTING_int(
     terrier::settings::Callbacks::NoOp
 )
 
+// Log segment size
+SETTING_int(
+    log_segment_size,
+    "Size (bytes) at which the log starts a new segment file, or 0 to write the log as a single file (default: 0)",
+    0,
+    0,
+    (1 << 30) /* 1GB */,
+    false,
+    terrier::settings::Callbacks::NoOp
+)
+
+// Log compression
+SETTING_bool(
+    log_compression,
+    "Compress log buffers before writing them out. The log is then written as segment files. (default: false)",
+    false,
+    false,
+    terrier::settings::Callbacks::NoOp
+)
+
 SETTING_bool(
     metrics_logging,
     "Metrics collection for the Logging component.",
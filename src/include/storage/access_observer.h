@@ -30,10 +30,11 @@ class BlockCompactor;
 class AccessObserver {
  public:
   /**
-   * Constructs a new AccessObserver that will send its observations to the given block compactor
+   * Constructs a new AccessObserver that will send its observations to the given block compactor, and registers
+   * itself with the compactor so it can be told about blocks that the compactor releases.
    * @param compactor the compactor to use after identifying a cold block
    */
-  explicit AccessObserver(BlockCompactor *compactor) : compactor_(compactor) {}
+  explicit AccessObserver(BlockCompactor *compactor);
 
   /**
    * Signals to the AccessObserver that a new GC run has begun. This is useful as a measurement of time to the
@@ -49,6 +50,13 @@ class AccessObserver {
    */
   void ObserveWrite(RawBlock *block);
 
+  /**
+   * Signals to the AccessObserver that the given block has left its table and is about to be returned to the block
+   * store, so it must not be sent to the compactor anymore.
+   * @param block the block that is being released
+   */
+  void ObserveBlockRelease(RawBlock *block) { last_touched_.erase(block); }
+
  private:
   uint64_t gc_epoch_ = 0;  // estimate time using the number of times GC has run
   // Here RawBlock * should suffice as a unique identifier of the block. Although a block can be
@@ -164,11 +164,22 @@ class ArrowColumnInfo {
    * @return type of the Arrow Column
    */
   ArrowColumnType &Type() { return type_; }
+
+  /**
+   * @return type of the Arrow Column
+   */
+  ArrowColumnType Type() const { return type_; }
+
   /**
    * @return ArrowVarlenColumn object for the column
    */
   ArrowVarlenColumn &VarlenColumn() { return varlen_column_; }
 
+  /**
+   * @return ArrowVarlenColumn object for the column
+   */
+  const ArrowVarlenColumn &VarlenColumn() const { return varlen_column_; }
+
   /**
    * Returns the indices array. This array is only meaningful if the column is dictionary compressed. The
    * size of this array is equal to the number of slots in a block.
@@ -180,6 +191,15 @@ class ArrowColumnInfo {
     return indices_;
   }
 
+  /**
+   * @return the indices array, only meaningful if the column is dictionary compressed
+   */
+  const uint32_t *Indices() const {
+    TERRIER_ASSERT(type_ == ArrowColumnType::DICTIONARY_COMPRESSED,
+                   "this array is only meaningful if the column is dicationary compressed");
+    return indices_;
+  }
+
   /**
    * Deallocates all associated buffers in the ArrowVarlenColumn
    */
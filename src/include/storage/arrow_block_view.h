@@ -0,0 +1,136 @@
+#pragma once
+#include <vector>
+#include "common/macros.h"
+#include "storage/arrow_block_metadata.h"
+#include "storage/storage_defs.h"
+#include "storage/tuple_access_strategy.h"
+
+namespace terrier::storage {
+/**
+ * A read-only view of a frozen block as Arrow buffers, for the columns of a projection list. None of the buffers
+ * are copied; they point straight into the block and its ArrowBlockMetadata. Fixed-length columns are exposed as
+ * the column itself, gathered varlen columns as an offsets and a values array, and dictionary compressed columns
+ * as an array of indices into a dictionary laid out like a gathered varlen column. In all cases the validity bitmap
+ * is the block's null bitmap for the column, which shares the bit order of Arrow's validity bitmap.
+ *
+ * The view is only valid while the block is held in the in-place read state, which is why it is only ever handed out
+ * inside the callback of DataTable::ExportFrozenBlocks.
+ * See https://arrow.apache.org/docs/format/Columnar.html
+ */
+class ArrowBlockView {
+ public:
+  /**
+   * Constructs a new view of the given block. The caller must hold the block's in-place read lock for the entire
+   * lifetime of the view.
+   * @param accessor accessor for the block's table
+   * @param block the block to view
+   * @param col_ids the columns to expose, in order
+   */
+  ArrowBlockView(const TupleAccessStrategy &accessor, RawBlock *block, const std::vector<col_id_t> &col_ids)
+      : accessor_(accessor), block_(block), metadata_(accessor.GetArrowBlockMetadata(block)), col_ids_(col_ids) {}
+
+  DISALLOW_COPY_AND_MOVE(ArrowBlockView)
+
+  /**
+   * @return the underlying block
+   */
+  RawBlock *GetBlock() const { return block_; }
+
+  /**
+   * @return number of records in the block, i.e. the length of every column in the view
+   */
+  uint32_t NumRecords() const { return metadata_.NumRecords(); }
+
+  /**
+   * @return number of columns in the view
+   */
+  uint16_t NumColumns() const { return static_cast<uint16_t>(col_ids_.size()); }
+
+  /**
+   * @param col index of the column in the projection list
+   * @return how the column is stored in Arrow format
+   */
+  ArrowColumnType ColumnType(uint16_t col) const {
+    const col_id_t col_id = ColId(col);
+    if (!accessor_.GetBlockLayout().IsVarlen(col_id)) return ArrowColumnType::FIXED_LENGTH;
+    return metadata_.GetColumnInfo(accessor_.GetBlockLayout(), col_id).Type();
+  }
+
+  /**
+   * @param col index of the column in the projection list
+   * @return size of an element of the values array in bytes for fixed-length columns
+   */
+  uint8_t AttrSize(uint16_t col) const { return accessor_.GetBlockLayout().AttrSize(ColId(col)); }
+
+  /**
+   * @param col index of the column in the projection list
+   * @return number of nulls in the column
+   */
+  uint32_t NullCount(uint16_t col) const { return metadata_.NullCount(ColId(col)); }
+
+  /**
+   * @param col index of the column in the projection list
+   * @return the validity bitmap of the column, where a set bit means the value is not null
+   */
+  const byte *Validity(uint16_t col) const {
+    return reinterpret_cast<const byte *>(accessor_.ColumnNullBitmap(block_, ColId(col)));
+  }
+
+  /**
+   * @param col index of the column in the projection list
+   * @return the values array of the column. For dictionary compressed columns these are the words of the dictionary.
+   */
+  const byte *Values(uint16_t col) const {
+    const col_id_t col_id = ColId(col);
+    if (ColumnType(col) == ArrowColumnType::FIXED_LENGTH) return accessor_.ColumnStart(block_, col_id);
+    return metadata_.GetColumnInfo(accessor_.GetBlockLayout(), col_id).VarlenColumn().Values();
+  }
+
+  /**
+   * @param col index of the column in the projection list
+   * @return length of the values array of the column in bytes
+   */
+  uint32_t ValuesLength(uint16_t col) const {
+    const col_id_t col_id = ColId(col);
+    if (ColumnType(col) == ArrowColumnType::FIXED_LENGTH) return NumRecords() * AttrSize(col);
+    return metadata_.GetColumnInfo(accessor_.GetBlockLayout(), col_id).VarlenColumn().ValuesLength();
+  }
+
+  /**
+   * @param col index of the column in the projection list, must not be fixed-length
+   * @return the offsets array of the column. For dictionary compressed columns these are offsets of dictionary words.
+   */
+  const uint32_t *Offsets(uint16_t col) const {
+    TERRIER_ASSERT(ColumnType(col) != ArrowColumnType::FIXED_LENGTH, "fixed-length columns have no offsets");
+    return metadata_.GetColumnInfo(accessor_.GetBlockLayout(), ColId(col)).VarlenColumn().Offsets();
+  }
+
+  /**
+   * @param col index of the column in the projection list, must not be fixed-length
+   * @return number of elements in the offsets array, which is one more than the number of values
+   */
+  uint32_t OffsetsLength(uint16_t col) const {
+    TERRIER_ASSERT(ColumnType(col) != ArrowColumnType::FIXED_LENGTH, "fixed-length columns have no offsets");
+    return metadata_.GetColumnInfo(accessor_.GetBlockLayout(), ColId(col)).VarlenColumn().OffsetsLength();
+  }
+
+  /**
+   * @param col index of the column in the projection list, must be dictionary compressed
+   * @return the dictionary code of every record in the column
+   */
+  const uint32_t *Indices(uint16_t col) const {
+    return metadata_.GetColumnInfo(accessor_.GetBlockLayout(), ColId(col)).Indices();
+  }
+
+ private:
+  const TupleAccessStrategy &accessor_;
+  RawBlock *const block_;
+  const ArrowBlockMetadata &metadata_;
+  const std::vector<col_id_t> &col_ids_;
+
+  col_id_t ColId(uint16_t col) const {
+    TERRIER_ASSERT(col < col_ids_.size(), "column index out of bounds");
+    return col_ids_[col];
+  }
+};
+}  // namespace terrier::storage
@@ -0,0 +1,54 @@
+#pragma once
+#include <ostream>
+#include <vector>
+#include "catalog/schema.h"
+#include "common/macros.h"
+#include "storage/arrow_block_view.h"
+#include "storage/sql_table.h"
+
+namespace terrier::storage {
+/**
+ * Writes out the frozen blocks of a SqlTable in the Arrow IPC streaming format, so that they can be read directly by
+ * Arrow-based analytics tools without going through the wire protocol. Every frozen block becomes one record batch,
+ * whose buffers are written straight out of the block without an intermediate copy. Dictionary compressed columns
+ * are written as dictionary-encoded fields, with every block replacing the dictionary of the previous one.
+ *
+ * SQL types are mapped to the Arrow type with the same in-memory representation: BOOLEAN is written as an unsigned
+ * 8-bit integer, DECIMAL as a double, TIMESTAMP and DATE as unsigned integers of their storage width, and VARCHAR
+ * and VARBINARY as Utf8 and Binary.
+ *
+ * Blocks that are not frozen, or whose varlen columns are stored differently from the first block written, are left
+ * out of the stream. It is up to the caller to read those transactionally.
+ * See https://arrow.apache.org/docs/format/Columnar.html#ipc-streaming-format
+ */
+class ArrowIpcWriter {
+ public:
+  /**
+   * Constructs a new writer
+   * @param out the stream to write to
+   */
+  explicit ArrowIpcWriter(std::ostream *out) : out_(out) {}
+
+  DISALLOW_COPY_AND_MOVE(ArrowIpcWriter)
+
+  /**
+   * Writes out a complete Arrow IPC stream for the given table, which consists of its schema, a record batch for
+   * every frozen block, and the end-of-stream marker.
+   * @param table the table to write out
+   * @param schema schema of the table
+   * @return number of blocks that were left out of the stream
+   */
+  uint32_t WriteTable(const SqlTable &table, const catalog::Schema &schema);
+
+ private:
+  std::ostream *const out_;
+  // How each column is encoded in the stream. Only meaningful for varlen columns, and fixed when the schema is written.
+  std::vector<ArrowColumnType> column_types_;
+
+  void WriteSchema(const catalog::Schema &schema);
+  bool CanWriteBlock(const ArrowBlockView &view) const;
+  void WriteDictionaryBatch(const ArrowBlockView &view, uint16_t col);
+  void WriteRecordBatch(const ArrowBlockView &view);
+  void WriteEndOfStream();
+};
+}  // namespace terrier::storage
@@ -1,8 +1,11 @@
 #pragma once
+#include <functional>
 #include <queue>
 #include <unordered_map>
 #include <utility>
 #include <vector>
+#include "common/worker_pool.h"
+#include "storage/access_observer.h"
 #include "storage/arrow_block_metadata.h"
 #include "storage/data_table.h"
 #include "storage/storage_defs.h"
@@ -21,6 +24,11 @@ using VarlenEntryMap = std::unordered_map<VarlenEntry, T, VarlenContentHasher, V
  * arrow-compatible. In the process, any gaps resulting from deletes or aborted transactions are also eliminated.
  * If the compaction is successful, the block is considered to be fully cold and will be accessed mostly as read-only
  * data.
+ *
+ * Hot blocks from the same table are compacted together in groups, sparsest first, so that the tuples of sparse blocks
+ * can be merged into fewer blocks. Blocks that end up empty are taken out of their table and returned to the block
+ * store once no running transaction can see them anymore. Different groups, and the gathering of different cooling
+ * blocks, are independent of each other and can be processed in parallel on a worker pool.
  */
 class BlockCompactor {
  private:
@@ -44,11 +52,33 @@ class BlockCompactor {
     transaction::TransactionContext *txn_;
     DataTable *table_;
     std::unordered_map<RawBlock *, std::vector<uint32_t>> blocks_to_compact_;
+    // Blocks that no longer hold any tuples after a successful compaction
+    std::vector<RawBlock *> emptied_blocks_;
     ProjectedRowInitializer all_cols_initializer_;
     ProjectedRow *read_buffer_;
   };
 
  public:
+  /**
+   * Default maximum number of blocks to compact together in a group
+   */
+  static constexpr uint32_t DEFAULT_MAX_BLOCKS_PER_GROUP = 8;
+
+  /**
+   * Constructs a new block compactor
+   * @param max_blocks_per_group maximum number of blocks from the same table to compact together in one transaction.
+   *                             Larger groups can free up more blocks, but make for larger compaction transactions that
+   *                             are more likely to conflict with user transactions.
+   * @param worker_pool pool to process independent groups and blocks on in parallel, or nullptr to process everything
+   *                    on the calling thread. The pool may be shared, but the compactor must not be run from one of its
+   *                    own tasks, as it blocks a worker while waiting on the others.
+   */
+  explicit BlockCompactor(uint32_t max_blocks_per_group = DEFAULT_MAX_BLOCKS_PER_GROUP,
+                          common::WorkerPool *worker_pool = nullptr)
+      : max_blocks_per_group_(max_blocks_per_group), worker_pool_(worker_pool) {
+    TERRIER_ASSERT(max_blocks_per_group > 0, "compaction groups cannot be empty");
+  }
+
   FAKED_IN_TEST ~BlockCompactor() = default;
 
   /**
@@ -65,7 +95,29 @@ class BlockCompactor {
    */
   FAKED_IN_TEST void PutInQueue(RawBlock *block) { compaction_queue_.push(block); }
 
+  /**
+   * Sets the access observer that feeds this compactor, so it can be told to forget about blocks that the compactor
+   * releases. This is called by the AccessObserver itself.
+   * @param observer the access observer sending blocks to this compactor
+   */
+  void SetAccessObserver(AccessObserver *observer) { observer_ = observer; }
+
  private:
+  // Splits the hot blocks of every table into compaction groups, sparsest blocks first
+  std::vector<std::vector<RawBlock *>> FormCompactionGroups(
+      const std::unordered_map<DataTable *, std::vector<RawBlock *>> &hot_blocks) const;
+
+  // Runs all the given tasks, in parallel if there is a worker pool, and waits for them to finish
+  void RunTasks(const std::vector<std::function<void()>> &tasks);
+
+  void CompactGroup(const std::vector<RawBlock *> &blocks, transaction::DeferredActionManager *deferred_action_manager,
+                    transaction::TransactionManager *txn_manager);
+
+  void GatherBlock(RawBlock *block, transaction::DeferredActionManager *deferred_action_manager);
+
+  // Returns a block emptied by compaction, and already detached from its table, to the block store
+  void ReleaseBlock(RawBlock *block);
+
   bool EliminateGaps(CompactionGroup *cg);
 
   bool CheckForVersionsAndGaps(const TupleAccessStrategy &accessor, RawBlock *block);
@@ -94,6 +146,9 @@ class BlockCompactor {
     }
   }
 
+  const uint32_t max_blocks_per_group_;
+  common::WorkerPool *const worker_pool_;
+  AccessObserver *observer_ = nullptr;
   std::queue<RawBlock *> compaction_queue_;
 };
 }  // namespace terrier::storage
@@ -0,0 +1,114 @@
+#pragma once
+#include <emmintrin.h>
+#include <array>
+#include <atomic>
+#include "common/macros.h"
+#include "storage/storage_defs.h"
+
+namespace terrier::storage {
+/**
+ * An append-only, latch-free directory of the blocks in a DataTable. Blocks are stored in a list of chunks whose sizes
+ * grow geometrically, so that an index can be mapped to its chunk with a little bit arithmetic and chunks never have
+ * to be moved or copied as the directory grows. Readers never wait: any index below Size() can be read at any time,
+ * concurrently with appends. A block that leaves the table has its entry cleared to nullptr, but the index is never
+ * reused, so that indexes held by readers stay meaningful.
+ *
+ * Appends reserve an index with a single fetch-and-add, and then publish it by bumping the size. Sizes are published in
+ * index order, so that readers always see a gap-free prefix of the directory. This means an append may briefly wait
+ * for concurrent appends with smaller indexes to finish, but that only happens once per new block.
+ */
+class BlockDirectory {
+ public:
+  /**
+   * Constructs a new, empty block directory
+   */
+  BlockDirectory() {
+    for (auto &chunk : chunks_) chunk.store(nullptr);
+  }
+
+  /**
+   * Destructs the block directory. The blocks themselves are not released.
+   */
+  ~BlockDirectory() {
+    for (auto &chunk : chunks_) delete[] chunk.load();
+  }
+
+  DISALLOW_COPY_AND_MOVE(BlockDirectory)
+
+  /**
+   * @return number of blocks in the directory visible to readers. This can only grow.
+   */
+  uint32_t Size() const { return size_.load(); }
+
+  /**
+   * @param index index of the block to read, must be less than a value previously returned by Size()
+   * @return the block at the given index, or nullptr if it has been erased
+   */
+  RawBlock *operator[](const uint32_t index) const {
+    TERRIER_ASSERT(index < Size(), "index out of bounds");
+    uint32_t offset;
+    const uint32_t chunk = ChunkForIndex(index, &offset);
+    return chunks_[chunk].load()[offset].load();
+  }
+
+  /**
+   * Clears the entry at the given index, so readers coming after will no longer see the block there.
+   * @param index index of the block to erase, must be less than a value previously returned by Size()
+   */
+  void Erase(const uint32_t index) {
+    TERRIER_ASSERT(index < Size(), "index out of bounds");
+    uint32_t offset;
+    const uint32_t chunk = ChunkForIndex(index, &offset);
+    chunks_[chunk].load()[offset].store(nullptr);
+  }
+
+  /**
+   * Appends a block to the end of the directory. Safe to call concurrently with other appends and with readers.
+   * @param block the block to append
+   * @return index of the appended block
+   */
+  uint32_t Append(RawBlock *const block) {
+    const uint32_t index = reserved_.fetch_add(1);
+    uint32_t offset;
+    const uint32_t chunk = ChunkForIndex(index, &offset);
+    EnsureChunk(chunk)[offset].store(block);
+    // Publish in index order, so a reader that sees Size() > i is guaranteed that every index up to i has been written
+    uint32_t expected = index;
+    while (!size_.compare_exchange_weak(expected, index + 1)) {
+      expected = index;
+      _mm_pause();
+    }
+    return index;
+  }
+
+ private:
+  // Number of entries in the first chunk. Chunk i holds FIRST_CHUNK_SIZE << i entries.
+  static constexpr uint32_t FIRST_CHUNK_SIZE = 64;
+  // Enough chunks to cover every index representable as a uint32_t
+  static constexpr uint32_t NUM_CHUNKS = 27;
+
+  std::array<std::atomic<std::atomic<RawBlock *> *>, NUM_CHUNKS> chunks_;
+  // Number of indexes handed out to appends, some of which might not have been published yet
+  std::atomic<uint32_t> reserved_ = 0;
+  // Number of indexes published to readers
+  std::atomic<uint32_t> size_ = 0;
+
+  static uint32_t ChunkForIndex(const uint32_t index, uint32_t *const offset) {
+    // Chunk i starts at FIRST_CHUNK_SIZE * (2^i - 1), so the chunk is given by the highest set bit of this value
+    const uint64_t scaled = static_cast<uint64_t>(index) / FIRST_CHUNK_SIZE + 1;
+    const auto chunk = static_cast<uint32_t>(63 - __builtin_clzll(scaled));
+    *offset = static_cast<uint32_t>(index - FIRST_CHUNK_SIZE * ((static_cast<uint64_t>(1) << chunk) - 1));
+    return chunk;
+  }
+
+  std::atomic<RawBlock *> *EnsureChunk(const uint32_t chunk) {
+    std::atomic<RawBlock *> *result = chunks_[chunk].load();
+    if (result != nullptr) return result;
+    // Race to install a new chunk. The loser throws its allocation away and uses the winner's.
+    auto *const allocated = new std::atomic<RawBlock *>[static_cast<uint64_t>(FIRST_CHUNK_SIZE) << chunk];
+    if (chunks_[chunk].compare_exchange_strong(result, allocated)) return allocated;
+    delete[] allocated;
+    return result;
+  }
+};
+}  // namespace terrier::storage
@@ -1,8 +1,11 @@
 #pragma once
-#include <list>
+#include <atomic>
+#include <functional>
 #include <unordered_map>
 #include <vector>
 #include "common/performance_counter.h"
+#include "storage/arrow_block_view.h"
+#include "storage/block_directory.h"
 #include "storage/projected_columns.h"
 #include "storage/storage_defs.h"
 #include "storage/tuple_access_strategy.h"
@@ -21,6 +24,8 @@ template <typename KeyType>
 class BwTreeIndex;
 template <typename KeyType>
 class HashIndex;
+template <typename KeyType>
+class BPlusTreeIndex;
 }  // namespace index
 
 // clang-format off
@@ -91,18 +96,15 @@ class DataTable {
 
    private:
     friend class DataTable;
-    /**
-     * @warning MUST BE CALLED ONLY WHEN CALLER HOLDS LOCK TO THE LIST OF RAW BLOCKS IN THE DATA TABLE
-     */
-    SlotIterator(const DataTable *table, std::list<RawBlock *>::const_iterator block, uint32_t offset_in_block)
-        : table_(table), block_(block) {
-      current_slot_ = {block == table->blocks_.end() ? nullptr : *block, offset_in_block};
+    SlotIterator(const DataTable *table, uint32_t block_index, uint32_t offset_in_block)
+        : table_(table), block_index_(block_index) {
+      current_slot_ = {table->SkipErasedBlocks(&block_index_), offset_in_block};
     }
 
     // TODO(Tianyu): Can potentially collapse this information into the RawBlock so we don't have to hold a pointer to
     // the table anymore. Right now we need the table to know how many slots there are in the block
     const DataTable *table_;
-    std::list<RawBlock *>::const_iterator block_;
+    uint32_t block_index_;
     TupleSlot current_slot_;
   };
   /**
@@ -150,13 +152,23 @@ class DataTable {
    */
   void Scan(transaction::TransactionContext *txn, SlotIterator *start_pos, ProjectedColumns *out_buffer) const;
 
+  /**
+   * Same as Scan above, except that the scan stops upon reaching the given end iterator (exclusive) instead of the end
+   * of the table. This is used to scan a sub-range of the table's blocks, e.g. a morsel in a parallel scan.
+   *
+   * @param txn the calling transaction
+   * @param start_pos iterator to the starting location for the sequential scan
+   * @param end_pos iterator to one slot past the last slot to scan
+   * @param out_buffer output buffer. The object should already contain projection list information. This buffer is
+   *                   always cleared of old values.
+   */
+  void Scan(transaction::TransactionContext *txn, SlotIterator *start_pos, const SlotIterator &end_pos,
+            ProjectedColumns *out_buffer) const;
+
   /**
    * @return the first tuple slot contained in the data table
    */
-  SlotIterator begin() const {  // NOLINT for STL name compability
-    common::SpinLatch::ScopedSpinLatch guard(&blocks_latch_);
-    return {this, blocks_.begin(), 0};
-  }
+  SlotIterator begin() const { return {this, 0, 0}; }  // NOLINT for STL name compability
 
   /**
    * Returns one past the last tuple slot contained in the data table. Note that this is not an accurate number when
@@ -167,6 +179,41 @@ class DataTable {
    */
   SlotIterator end() const;  // NOLINT for STL name compability
 
+  /**
+   * @param block_index index of the block in the table's block list
+   * @return the first tuple slot of the block at the given index, or end() if there is no such block
+   */
+  SlotIterator beginAt(uint32_t block_index) const;  // NOLINT for STL name compability
+
+  /**
+   * Returns one past the last tuple slot of the blocks in the range [0, block_index). If the range covers every block
+   * in the table, this is equivalent to end().
+   *
+   * @param block_index index of the block one past the end of the range
+   * @return one past the last tuple slot in the given range of blocks
+   */
+  SlotIterator endAt(uint32_t block_index) const;  // NOLINT for STL name compability
+
+  /**
+   * @return the number of blocks currently in this DataTable, including the positions of blocks that have since been
+   * released by compaction. Note that this number can only grow while the table is being inserted into, so it is a
+   * lower bound when there are concurrent inserts.
+   */
+  uint32_t GetNumBlocks() const { return blocks_.Size(); }
+
+  /**
+   * Hands out every frozen block in this DataTable, in block order, as a zero-copy Arrow view of the given columns.
+   * Each block is held in the in-place read state while the visitor runs on it, so writers to that block are blocked
+   * until the visitor returns, and the view must not be used afterwards. Blocks that are not frozen are skipped, since
+   * their contents are only meaningful with respect to a transaction; the caller needs to read those transactionally.
+   *
+   * @param col_ids the columns to expose in the view, in order. Should not reference col_id 0
+   * @param visitor function to call on the view of every frozen block
+   * @return number of blocks that were skipped because they were not frozen
+   */
+  uint32_t ExportFrozenBlocks(const std::vector<col_id_t> &col_ids,
+                              const std::function<void(const ArrowBlockView &)> &visitor) const;
+
   /**
    * Update the tuple according to the redo buffer given, and update the version chain to link to an
    * undo record that is allocated in the txn. The undo record is populated with a before-image of the tuple in the
@@ -224,6 +271,8 @@ class DataTable {
   friend class index::BwTreeIndex;
   template <typename KeyType>
   friend class index::HashIndex;
+  template <typename KeyType>
+  friend class index::BPlusTreeIndex;
   // The block compactor elides transactional protection in the gather/compression phase and
   // needs raw access to the underlying table.
   friend class BlockCompactor;
@@ -235,28 +284,38 @@ class DataTable {
   // TODO(Tianyu): For now, on insertion, we simply sequentially go through a block and allocate a
   // new one when the current one is full. Needless to say, we will need to revisit this when extending GC to handle
   // deleted tuples and recycle slots
-  // TODO(Tianyu): Now that we are switching to a linked list, there probably isn't a reason for it
-  // to be latched. Could just easily write a lock-free one if there's performance gain(probably not). vector->list has
-  // negligible difference in insert performance (within margin of error) when benchmarked.
-  // We also might need our own implementation because we need to handle GC of an unlinked block, as a sequential scan
-  // might be on it
-  std::list<RawBlock *> blocks_;
-  // latch used to protect block list
-  mutable common::SpinLatch blocks_latch_;
-  // latch used to protect insertion_head_
-  mutable common::SpinLatch header_latch_;
-  std::list<RawBlock *>::iterator insertion_head_;
-  // Check if we need to advance the insertion_head_
-  // This function uses header_latch_ to ensure correctness
-  void CheckMoveHead(std::list<RawBlock *>::iterator block);
+  // We also might need to handle GC of an unlinked block, as a sequential scan might be on it
+  BlockDirectory blocks_;
+  // Index of the first block that might still have free slots. Since slots are not recycled on the fly, a block never
+  // becomes insertable again once it is full, so every block in front of this index is full and the blocks from here
+  // to the end of the directory act as the free list. Only ever moves forward.
+  std::atomic<uint32_t> insertion_head_ = 0;
   mutable DataTableCounter data_table_counter_;
 
+  // Bulk copies the tuples of a frozen block, starting at the given iterator, into the output buffer. Returns false
+  // without doing anything if the block is not frozen, in which case the caller needs to fall back to materializing
+  // tuple-at-a-time. Otherwise, advances the iterator past the last slot copied and increments filled accordingly.
+  bool ScanFrozenBlock(SlotIterator *start_pos, const SlotIterator &end_pos, ProjectedColumns *out_buffer,
+                       uint32_t *filled) const;
+
+  // Copies the visible tuples of a block with no version pointers in it, starting at the given iterator, into the
+  // output buffer without looking at any version chains. Returns false without advancing the iterator or filled if the
+  // version synopsis shows the block has versions, or if a writer touched the block while we were copying. In that
+  // case, the caller needs to fall back to materializing tuple-at-a-time.
+  bool ScanCleanBlock(SlotIterator *start_pos, const SlotIterator &end_pos, ProjectedColumns *out_buffer,
+                      uint32_t *filled) const;
+
   // A templatized version for select, so that we can use the same code for both row and column access.
   // the method is explicitly instantiated for ProjectedRow and ProjectedColumns::RowView
   template <class RowType>
   bool SelectIntoBuffer(transaction::TransactionContext *txn, TupleSlot slot, RowType *out_buffer) const;
 
   void InsertInto(transaction::TransactionContext *txn, const ProjectedRow &redo, TupleSlot dest);
+
+  // Copies the before-image of an update into its undo record. Attributes the update writes the same value into are
+  // left out of the undo record, so that readers and the GC have less to go through. Varlens are always kept, as the
+  // undo record is what keeps track of their old buffers.
+  void CopyBeforeImage(TupleSlot slot, const ProjectedRow &redo, UndoRecord *undo) const;
   // Atomically read out the version pointer value.
   UndoRecord *AtomicallyReadVersionPtr(TupleSlot slot, const TupleAccessStrategy &accessor) const;
 
@@ -281,9 +340,26 @@ class DataTable {
   bool CompareAndSwapVersionPtr(TupleSlot slot, const TupleAccessStrategy &accessor, UndoRecord *expected,
                                 UndoRecord *desired);
 
+  // Keeps the version synopsis of the block in sync with a version pointer in it changing from old_ptr to new_ptr.
+  // Must be called after every change to a version pointer, and before the tuple is modified in place.
+  static void UpdateVersionSynopsis(RawBlock *block, const UndoRecord *old_ptr, const UndoRecord *new_ptr);
+
   // Allocates a new block to be used as insertion head.
   RawBlock *NewBlock();
 
+  // Returns the block at the given index in the block directory, moving the index forward past any blocks that have
+  // been erased. Returns nullptr if there is no block left at or after the index.
+  RawBlock *SkipErasedBlocks(uint32_t *block_index) const;
+
+  // Removes the given block from the block directory, so that scans and inserts starting after this call will no
+  // longer reach it. The block itself is left alone, since there may still be readers on it. Returns false if the
+  // block is not in this table.
+  bool DetachBlock(RawBlock *block);
+
+  // Returns a block previously detached from this table to the block store, along with any Arrow buffers it holds.
+  // The caller must make sure no one can still be reading the block, and that it holds no live tuples.
+  void ReleaseBlock(RawBlock *block);
+
   /**
    * Determine if a Tuple is visible (present and not deleted) to the given transaction. It's effectively Select's logic
    * (follow a version chain if present) without the materialization. If the logic of Select changes, this should change
@@ -293,5 +369,12 @@ class DataTable {
    * @return true if tuple is visible to this txn, false otherwise
    */
   bool IsVisible(const transaction::TransactionContext &txn, TupleSlot slot) const;
+
+  /**
+   * Hints the CPU to start loading the parts of a tuple that IsVisible reads: its version pointer, and the bits that
+   * say whether it is allocated and not deleted. Callers checking many tuples in a row can prefetch ahead.
+   * @param slot the slot of the tuple to prefetch
+   */
+  void PrefetchVisibility(TupleSlot slot) const;
 };
 }  // namespace terrier::storage
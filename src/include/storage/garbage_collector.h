@@ -3,7 +3,9 @@
 #include <queue>
 #include <unordered_set>
 #include <utility>
+#include <vector>
 #include "common/shared_latch.h"
+#include "common/worker_pool.h"
 #include "storage/access_observer.h"
 #include "storage/index/index.h"
 #include "transaction/transaction_context.h"
@@ -61,6 +63,16 @@ class GarbageCollector {
    */
   std::pair<uint32_t, uint32_t> PerformGarbageCollection();
 
+  /**
+   * Spreads the expensive parts of garbage collection over the given worker pool: truncating version chains,
+   * reclaiming slots and varlens of unlinked records, deallocating transactions, and collecting indexes. Version chains
+   * are partitioned among the workers by tuple slot, so that every chain is still only truncated by a single thread.
+   * Passes with little garbage run on the calling thread regardless.
+   * @param worker_pool pool to collect garbage on, or nullptr to collect everything on the calling thread. The pool may
+   *                    be shared, but garbage collection must not run from one of its own tasks.
+   */
+  void SetWorkerPool(common::WorkerPool *const worker_pool) { worker_pool_ = worker_pool; }
+
   /**
    * Register an index to be periodically garbage collected
    * @param index pointer to the index to register
@@ -74,6 +86,9 @@ class GarbageCollector {
   void UnregisterIndexForGC(common::ManagedPointer<index::Index> index);
 
  private:
+  // Minimum number of transactions to unlink or deallocate in a pass before the work is spread over the worker pool
+  static constexpr uint32_t PARALLEL_GC_THRESHOLD = 64;
+
   /**
    * Process the deallocate queue
    * @return number of txns (not UndoRecords) processed for debugging/testing
@@ -91,6 +106,18 @@ class GarbageCollector {
    */
   void ProcessDeferredActions(transaction::timestamp_t oldest_txn);
 
+  /**
+   * Unlinks the records of the given transactions, which must all be safe to garbage collect
+   */
+  void UnlinkTransactions(const std::vector<transaction::TransactionContext *> &txns,
+                          transaction::timestamp_t oldest_txn);
+
+  /**
+   * Same as UnlinkTransactions, but spread over the worker pool
+   */
+  void UnlinkTransactionsInParallel(const std::vector<transaction::TransactionContext *> &txns,
+                                    transaction::timestamp_t oldest_txn);
+
   void ReclaimSlotIfDeleted(UndoRecord *undo_record) const;
 
   void ReclaimBufferIfVarlen(transaction::TransactionContext *txn, UndoRecord *undo_record) const;
@@ -103,6 +130,7 @@ class GarbageCollector {
   transaction::DeferredActionManager *deferred_action_manager_;
   transaction::TransactionManager *const txn_manager_;
   AccessObserver *observer_;
+  common::WorkerPool *worker_pool_ = nullptr;
   // timestamp of the last time GC unlinked anything. We need this to know when unlinked versions are safe to deallocate
   transaction::timestamp_t last_unlinked_;
   // queue of txns that have been unlinked, and should possible be deleted on next GC run
@@ -0,0 +1,502 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <functional>
+#include <type_traits>
+#include "common/constants.h"
+#include "common/macros.h"
+#include "common/spin_latch.h"
+#include "storage/storage_defs.h"
+
+namespace terrier::storage::index {
+
+/**
+ * A B+Tree from keys to TupleSlots, synchronized with optimistic lock coupling (Leis et al., "The ART of Practical
+ * Synchronization", DaMoN 2016). Every node carries a version that its writer bumps when it unlocks the node. Readers
+ * take no latches at all: they note the version of a node, read what they need, and start over if the version changed
+ * in between. Writers only lock the nodes they change, and never wait for a lock while holding another one.
+ *
+ * Entries are ordered by key and then by TupleSlot, so a key can map to any number of TupleSlots, and every entry is
+ * unique. Full nodes are split on the way down. Nodes are never merged and only freed along with the tree, so a reader
+ * can never end up in freed memory, no matter how stale its view of the tree is.
+ *
+ * Readers copy keys out of a node and validate the version before comparing them, so comparators never see a key that
+ * is being overwritten.
+ * @tparam KeyType the type of keys stored in the tree. It must be trivially copyable and ordered by std::less.
+ */
+template <typename KeyType>
+class BPlusTree {
+  static_assert(std::is_trivially_copyable_v<KeyType>, "keys are copied out of nodes that may be changing");
+
+ public:
+  BPlusTree() : root_(new LeafNode) {}
+
+  /**
+   * Frees all of the nodes
+   */
+  ~BPlusTree() { FreeSubtree(root_.load()); }
+
+  DISALLOW_COPY_AND_MOVE(BPlusTree)
+
+  /**
+   * Inserts an entry
+   * @param key key of the entry
+   * @param value value of the entry
+   * @return false if the entry already exists, true otherwise
+   */
+  bool Insert(const KeyType &key, const TupleSlot value) {
+    bool inserted;
+    while (!TryInsert(key, value, &inserted)) {
+    }
+    return inserted;
+  }
+
+  /**
+   * Inserts an entry, unless the predicate holds for any value already mapped to by the key. The check and the insert
+   * are atomic with respect to other conditional inserts, but not to plain inserts of the same key.
+   * @tparam Predicate function from TupleSlot to bool
+   * @param key key of the entry
+   * @param value value of the entry
+   * @param predicate the predicate to check existing values for
+   * @param[out] predicate_satisfied whether the predicate held for any existing value
+   * @return true if the entry was inserted, false otherwise
+   */
+  template <class Predicate>
+  bool ConditionalInsert(const KeyType &key, const TupleSlot value, const Predicate &predicate,
+                         bool *const predicate_satisfied) {
+    common::SpinLatch::ScopedSpinLatch guard(&insert_latches_[hasher_(key) % NUM_INSERT_LATCHES]);
+    *predicate_satisfied = false;
+    ScanAscending(key, key, [&](const TupleSlot slot) {
+      *predicate_satisfied = predicate(slot);
+      return !*predicate_satisfied;
+    });
+    return !*predicate_satisfied && Insert(key, value);
+  }
+
+  /**
+   * Deletes an entry
+   * @param key key of the entry
+   * @param value value of the entry
+   * @return true if the entry existed, false otherwise
+   */
+  bool Delete(const KeyType &key, const TupleSlot value) {
+    bool deleted;
+    while (!TryDelete(key, value, &deleted)) {
+    }
+    return deleted;
+  }
+
+  /**
+   * Calls the callback on the values of all entries with keys between low and high, inclusive, in ascending order,
+   * until the callback returns false
+   * @tparam Callback function from TupleSlot to bool
+   * @param low the key to start at
+   * @param high the key to end at
+   * @param callback function to call on every value
+   */
+  template <class Callback>
+  void ScanAscending(const KeyType &low, const KeyType &high, const Callback &callback) const {
+    // Entries at or past this one are still to be visited
+    KeyType from_key = low;
+    uintptr_t from_slot = MIN_SLOT;
+    bool from_inclusive = true;
+    LeafNode *leaf;
+    uint64_t version;
+    while (!FindLeaf(from_key, from_slot, false, &leaf, &version, nullptr)) {
+    }
+
+    TupleSlot batch[LEAF_CAPACITY];
+    while (leaf != nullptr) {
+      // Copy out the entries in range first, as the callback should only see them once they are known to be valid
+      uint16_t batch_size = 0;
+      bool done = false;
+      LeafNode *next;
+      if (!ReadAscending(*leaf, version, high, from_key, from_slot, from_inclusive, batch, &batch_size, &done,
+                         &from_key, &next)) {
+        // A split only ever moves entries to the right, where we are headed anyways, so try this leaf again
+        version = WaitUntilUnlocked(*leaf);
+        continue;
+      }
+      for (uint16_t i = 0; i < batch_size; i++)
+        if (!callback(batch[i])) return;
+      if (done) return;
+      if (batch_size > 0) {
+        from_slot = SlotBits(batch[batch_size - 1]);
+        from_inclusive = false;
+      }
+      leaf = next;
+      if (leaf != nullptr) version = WaitUntilUnlocked(*leaf);
+    }
+  }
+
+  /**
+   * Calls the callback on the values of all entries with keys between low and high, inclusive, in descending order,
+   * until the callback returns false
+   * @tparam Callback function from TupleSlot to bool
+   * @param low the key to end at
+   * @param high the key to start at
+   * @param callback function to call on every value
+   */
+  template <class Callback>
+  void ScanDescending(const KeyType &low, const KeyType &high, const Callback &callback) const {
+    // Entries before this one are still to be visited. Leaves are not linked backwards, so every leaf is found from
+    // the root again, by looking for the entries before the lowest entry the last leaf could hold.
+    KeyType before_key = high;
+    uintptr_t before_slot = MAX_SLOT;
+    TupleSlot batch[LEAF_CAPACITY];
+    while (true) {
+      LeafNode *leaf;
+      uint64_t version;
+      Fence fence;
+      if (!FindLeaf(before_key, before_slot, true, &leaf, &version, &fence)) continue;
+      uint16_t batch_size = 0;
+      bool done = false;
+      if (!ReadDescending(*leaf, version, low, before_key, before_slot, batch, &batch_size, &done)) continue;
+      for (uint16_t i = 0; i < batch_size; i++)
+        if (!callback(batch[i])) return;
+      if (done || !fence.valid_) return;
+      before_key = fence.key_;
+      before_slot = fence.slot_;
+    }
+  }
+
+ private:
+  // Nodes take up about this many bytes, unless the keys are so large that they would hold too few entries
+  static constexpr uint32_t NODE_SIZE = 4096;
+  static constexpr uint16_t MIN_CAPACITY = 4;
+  static constexpr uint16_t LEAF_CAPACITY = static_cast<uint16_t>(
+      std::max<size_t>(MIN_CAPACITY, (NODE_SIZE - 32) / (sizeof(KeyType) + sizeof(TupleSlot))));
+  static constexpr uint16_t INNER_CAPACITY = static_cast<uint16_t>(
+      std::max<size_t>(MIN_CAPACITY, (NODE_SIZE - 32) / (sizeof(KeyType) + sizeof(uintptr_t) + sizeof(void *))));
+  // Number of latches that serialize conditional inserts, picked by the hash of the key
+  static constexpr uint32_t NUM_INSERT_LATCHES = 64;
+  // Bits of a TupleSlot that orders before and after any real TupleSlot
+  static constexpr uintptr_t MIN_SLOT = 0;
+  static constexpr uintptr_t MAX_SLOT = UINTPTR_MAX;
+
+  /**
+   * Common header of leaf and inner nodes. The version is odd while the node is locked.
+   */
+  struct Node {
+    explicit Node(const bool is_leaf) : is_leaf_(is_leaf) {}
+
+    bool Validate(const uint64_t version) const {
+      std::atomic_thread_fence(std::memory_order_acquire);
+      return version_.load(std::memory_order_relaxed) == version;
+    }
+
+    bool TryLock(uint64_t version) { return version_.compare_exchange_strong(version, version + 1); }
+
+    void Unlock() { version_.fetch_add(1, std::memory_order_release); }
+
+    std::atomic<uint64_t> version_{0};
+    const bool is_leaf_;
+    uint16_t count_ = 0;
+  };
+
+  /**
+   * Separators are copies of the entries that were first in the right node of a split. Child i holds the entries
+   * ordered at or after separator i - 1 and before separator i.
+   */
+  struct InnerNode : Node {
+    InnerNode() : Node(false) {}
+    KeyType keys_[INNER_CAPACITY];
+    uintptr_t slots_[INNER_CAPACITY];
+    Node *children_[INNER_CAPACITY + 1];
+  };
+
+  /**
+   * Leaves are linked to their right neighbors for ascending scans
+   */
+  struct LeafNode : Node {
+    LeafNode() : Node(true) {}
+    KeyType keys_[LEAF_CAPACITY];
+    TupleSlot slots_[LEAF_CAPACITY];
+    LeafNode *next_ = nullptr;
+  };
+
+  /**
+   * The lowest entry a leaf can hold, if there is any bound
+   */
+  struct Fence {
+    bool valid_ = false;
+    KeyType key_;
+    uintptr_t slot_;
+  };
+
+  static bool IsLocked(const uint64_t version) { return (version & 1U) == 1U; }
+
+  static uint16_t Capacity(const Node &node) { return node.is_leaf_ ? LEAF_CAPACITY : INNER_CAPACITY; }
+
+  static uintptr_t SlotBits(const TupleSlot slot) {
+    return reinterpret_cast<uintptr_t>(slot.GetBlock()) | slot.GetOffset();
+  }
+
+  static uint64_t WaitUntilUnlocked(const Node &node) {
+    uint64_t version = node.version_.load();
+    while (IsLocked(version)) version = node.version_.load();
+    return version;
+  }
+
+  bool EntryLess(const KeyType &lhs_key, const uintptr_t lhs_slot, const KeyType &rhs_key,
+                 const uintptr_t rhs_slot) const {
+    if (key_less_(lhs_key, rhs_key)) return true;
+    if (key_less_(rhs_key, lhs_key)) return false;
+    return lhs_slot < rhs_slot;
+  }
+
+  /**
+   * Counts the entries of a node ordered before the given one, or at or before it. The node may be changing, so this
+   * fails if the version does not hold up.
+   */
+  template <class NodeType>
+  bool CountBefore(const NodeType &node, const uint64_t version, const KeyType &key, const uintptr_t slot,
+                   const bool or_equal, uint16_t *const result) const {
+    uint16_t lo = 0, hi = std::min(node.count_, Capacity(node));
+    KeyType node_key;
+    while (lo < hi) {
+      const uint16_t mid = static_cast<uint16_t>((lo + hi) / 2);
+      std::memcpy(&node_key, &node.keys_[mid], sizeof(KeyType));
+      const uintptr_t node_slot = EntrySlotBits(node, mid);
+      if (!node.Validate(version)) return false;
+      const bool before = or_equal ? !EntryLess(key, slot, node_key, node_slot)
+                                   : EntryLess(node_key, node_slot, key, slot);
+      if (before)
+        lo = static_cast<uint16_t>(mid + 1);
+      else
+        hi = mid;
+    }
+    *result = lo;
+    return true;
+  }
+
+  static uintptr_t EntrySlotBits(const InnerNode &node, const uint16_t i) { return node.slots_[i]; }
+  static uintptr_t EntrySlotBits(const LeafNode &node, const uint16_t i) { return SlotBits(node.slots_[i]); }
+
+  /**
+   * Descends to the leaf holding the entry, or to the leaf holding the entries right before it. Fails if it has to
+   * start over from the root.
+   */
+  bool FindLeaf(const KeyType &key, const uintptr_t slot, const bool before, LeafNode **const leaf,
+                uint64_t *const leaf_version, Fence *const fence) const {
+    Node *node = root_.load();
+    uint64_t version = node->version_.load();
+    if (IsLocked(version) || node != root_.load()) return false;
+    while (!node->is_leaf_) {
+      const auto *const inner = static_cast<const InnerNode *>(node);
+      uint16_t pos;
+      if (!CountBefore(*inner, version, key, slot, !before, &pos)) return false;
+      if (fence != nullptr && pos > 0) {
+        std::memcpy(&fence->key_, &inner->keys_[pos - 1], sizeof(KeyType));
+        fence->slot_ = inner->slots_[pos - 1];
+        fence->valid_ = true;
+      }
+      Node *const child = inner->children_[pos];
+      if (!inner->Validate(version)) return false;
+      const uint64_t child_version = child->version_.load();
+      // The child is only known to be the right one if the parent did not change while we looked it up
+      if (IsLocked(child_version) || !inner->Validate(version)) return false;
+      node = child;
+      version = child_version;
+    }
+    *leaf = static_cast<LeafNode *>(node);
+    *leaf_version = version;
+    return true;
+  }
+
+  bool ReadAscending(const LeafNode &leaf, const uint64_t version, const KeyType &high, const KeyType &from_key,
+                     const uintptr_t from_slot, const bool from_inclusive, TupleSlot *const batch,
+                     uint16_t *const batch_size, bool *const done, KeyType *const last_key,
+                     LeafNode **const next) const {
+    uint16_t pos;
+    if (!CountBefore(leaf, version, from_key, from_slot, !from_inclusive, &pos)) return false;
+    const uint16_t count = std::min(leaf.count_, LEAF_CAPACITY);
+    KeyType key;
+    KeyType batch_last_key;
+    for (; pos < count; pos++) {
+      std::memcpy(&key, &leaf.keys_[pos], sizeof(KeyType));
+      const TupleSlot slot = leaf.slots_[pos];
+      if (!leaf.Validate(version)) return false;
+      if (key_less_(high, key)) {
+        *done = true;
+        break;
+      }
+      batch[(*batch_size)++] = slot;
+      batch_last_key = key;
+    }
+    *next = leaf.next_;
+    if (!leaf.Validate(version)) return false;
+    if (*batch_size > 0) *last_key = batch_last_key;
+    if (*next == nullptr) *done = true;
+    return true;
+  }
+
+  bool ReadDescending(const LeafNode &leaf, const uint64_t version, const KeyType &low, const KeyType &before_key,
+                      const uintptr_t before_slot, TupleSlot *const batch, uint16_t *const batch_size,
+                      bool *const done) const {
+    uint16_t pos;
+    if (!CountBefore(leaf, version, before_key, before_slot, false, &pos)) return false;
+    KeyType key;
+    for (; pos > 0; pos--) {
+      std::memcpy(&key, &leaf.keys_[pos - 1], sizeof(KeyType));
+      const TupleSlot slot = leaf.slots_[pos - 1];
+      if (!leaf.Validate(version)) return false;
+      if (key_less_(key, low)) {
+        *done = true;
+        break;
+      }
+      batch[(*batch_size)++] = slot;
+    }
+    return leaf.Validate(version);
+  }
+
+  bool TryInsert(const KeyType &key, const TupleSlot value, bool *const inserted) {
+    const uintptr_t slot = SlotBits(value);
+    Node *node = root_.load();
+    uint64_t version = node->version_.load();
+    if (IsLocked(version) || node != root_.load()) return false;
+    InnerNode *parent = nullptr;
+    uint64_t parent_version = 0;
+    while (true) {
+      if (node->count_ >= Capacity(*node)) {
+        // Split full nodes on the way down, so that the parent always has room for one more separator
+        if (parent != nullptr && !parent->TryLock(parent_version)) return false;
+        if (!node->TryLock(version)) {
+          if (parent != nullptr) parent->Unlock();
+          return false;
+        }
+        if (parent == nullptr && node != root_.load()) {
+          // Somebody else grew the tree in the meantime
+          node->Unlock();
+          return false;
+        }
+        Split(parent, node);
+        node->Unlock();
+        if (parent != nullptr) parent->Unlock();
+        return false;
+      }
+      if (node->is_leaf_) break;
+
+      auto *const inner = static_cast<InnerNode *>(node);
+      uint16_t pos;
+      if (!CountBefore(*inner, version, key, slot, true, &pos)) return false;
+      Node *const child = inner->children_[pos];
+      if (!inner->Validate(version)) return false;
+      const uint64_t child_version = child->version_.load();
+      if (IsLocked(child_version) || !inner->Validate(version)) return false;
+      parent = inner;
+      parent_version = version;
+      node = child;
+      version = child_version;
+    }
+
+    auto *const leaf = static_cast<LeafNode *>(node);
+    if (!leaf->TryLock(version)) return false;
+    uint16_t pos;
+    CountBefore(*leaf, version + 1, key, slot, false, &pos);
+    if (pos < leaf->count_ && !EntryLess(key, slot, leaf->keys_[pos], SlotBits(leaf->slots_[pos]))) {
+      *inserted = false;
+    } else {
+      std::memmove(&leaf->keys_[pos + 1], &leaf->keys_[pos], (leaf->count_ - pos) * sizeof(KeyType));
+      std::memmove(&leaf->slots_[pos + 1], &leaf->slots_[pos], (leaf->count_ - pos) * sizeof(TupleSlot));
+      leaf->keys_[pos] = key;
+      leaf->slots_[pos] = value;
+      leaf->count_++;
+      *inserted = true;
+    }
+    leaf->Unlock();
+    return true;
+  }
+
+  bool TryDelete(const KeyType &key, const TupleSlot value, bool *const deleted) {
+    const uintptr_t slot = SlotBits(value);
+    LeafNode *leaf;
+    uint64_t version;
+    if (!FindLeaf(key, slot, false, &leaf, &version, nullptr) || !leaf->TryLock(version)) return false;
+    uint16_t pos;
+    CountBefore(*leaf, version + 1, key, slot, false, &pos);
+    *deleted = pos < leaf->count_ && !EntryLess(key, slot, leaf->keys_[pos], SlotBits(leaf->slots_[pos]));
+    if (*deleted) {
+      std::memmove(&leaf->keys_[pos], &leaf->keys_[pos + 1], (leaf->count_ - pos - 1) * sizeof(KeyType));
+      std::memmove(&leaf->slots_[pos], &leaf->slots_[pos + 1], (leaf->count_ - pos - 1) * sizeof(TupleSlot));
+      leaf->count_--;
+    }
+    leaf->Unlock();
+    return true;
+  }
+
+  /**
+   * Moves the upper half of a full node into a new right sibling. Both the node and its parent, if any, must be
+   * locked. Without a parent, the tree grows a new root.
+   */
+  void Split(InnerNode *const parent, Node *const node) {
+    KeyType separator_key;
+    uintptr_t separator_slot;
+    Node *right;
+    if (node->is_leaf_) {
+      auto *const leaf = static_cast<LeafNode *>(node);
+      auto *const right_leaf = new LeafNode;
+      const uint16_t mid = static_cast<uint16_t>(leaf->count_ / 2);
+      right_leaf->count_ = static_cast<uint16_t>(leaf->count_ - mid);
+      std::memcpy(right_leaf->keys_, &leaf->keys_[mid], right_leaf->count_ * sizeof(KeyType));
+      std::memcpy(right_leaf->slots_, &leaf->slots_[mid], right_leaf->count_ * sizeof(TupleSlot));
+      right_leaf->next_ = leaf->next_;
+      separator_key = leaf->keys_[mid];
+      separator_slot = SlotBits(leaf->slots_[mid]);
+      leaf->count_ = mid;
+      leaf->next_ = right_leaf;
+      right = right_leaf;
+    } else {
+      auto *const inner = static_cast<InnerNode *>(node);
+      auto *const right_inner = new InnerNode;
+      const uint16_t mid = static_cast<uint16_t>(inner->count_ / 2);
+      right_inner->count_ = static_cast<uint16_t>(inner->count_ - mid - 1);
+      std::memcpy(right_inner->keys_, &inner->keys_[mid + 1], right_inner->count_ * sizeof(KeyType));
+      std::memcpy(right_inner->slots_, &inner->slots_[mid + 1], right_inner->count_ * sizeof(uintptr_t));
+      std::memcpy(right_inner->children_, &inner->children_[mid + 1], (right_inner->count_ + 1) * sizeof(Node *));
+      separator_key = inner->keys_[mid];
+      separator_slot = inner->slots_[mid];
+      inner->count_ = mid;
+      right = right_inner;
+    }
+
+    if (parent == nullptr) {
+      auto *const new_root = new InnerNode;
+      new_root->count_ = 1;
+      new_root->keys_[0] = separator_key;
+      new_root->slots_[0] = separator_slot;
+      new_root->children_[0] = node;
+      new_root->children_[1] = right;
+      root_.store(new_root);
+      return;
+    }
+    uint16_t pos;
+    CountBefore(*parent, parent->version_.load(), separator_key, separator_slot, true, &pos);
+    std::memmove(&parent->keys_[pos + 1], &parent->keys_[pos], (parent->count_ - pos) * sizeof(KeyType));
+    std::memmove(&parent->slots_[pos + 1], &parent->slots_[pos], (parent->count_ - pos) * sizeof(uintptr_t));
+    std::memmove(&parent->children_[pos + 2], &parent->children_[pos + 1], (parent->count_ - pos) * sizeof(Node *));
+    parent->keys_[pos] = separator_key;
+    parent->slots_[pos] = separator_slot;
+    parent->children_[pos + 1] = right;
+    parent->count_++;
+  }
+
+  static void FreeSubtree(Node *const node) {
+    if (node->is_leaf_) {
+      delete static_cast<LeafNode *>(node);
+      return;
+    }
+    auto *const inner = static_cast<InnerNode *>(node);
+    for (uint16_t i = 0; i <= inner->count_; i++) FreeSubtree(inner->children_[i]);
+    delete inner;
+  }
+
+  std::atomic<Node *> root_;
+  std::less<KeyType> key_less_;
+  std::hash<KeyType> hasher_;
+  common::SpinLatch insert_latches_[NUM_INSERT_LATCHES];
+};
+
+}  // namespace terrier::storage::index
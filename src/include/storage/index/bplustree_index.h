@@ -0,0 +1,209 @@
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "storage/index/bplustree.h"
+#include "storage/index/index.h"
+#include "storage/index/index_defs.h"
+#include "transaction/deferred_action_manager.h"
+#include "transaction/transaction_context.h"
+#include "transaction/transaction_manager.h"
+
+namespace terrier::storage::index {
+
+/**
+ * Wrapper around the optimistic lock coupling BPlusTree. An alternative to the BwTree for ordered indexes: readers
+ * never write to shared memory, and there are no delta chains to consolidate or garbage to collect.
+ * @tparam KeyType the type of keys stored in the BPlusTree
+ */
+template <typename KeyType>
+class BPlusTreeIndex final : public Index {
+  friend class IndexBuilder;
+
+ private:
+  explicit BPlusTreeIndex(IndexMetadata metadata)
+      : Index(std::move(metadata)), bplustree_{new BPlusTree<KeyType>} {}
+
+  const std::unique_ptr<BPlusTree<KeyType>> bplustree_;
+
+ public:
+  IndexType Type() const final { return IndexType::BPLUSTREE; }
+
+  bool Insert(transaction::TransactionContext *const txn, const ProjectedRow &tuple, const TupleSlot location) final {
+    TERRIER_ASSERT(!(metadata_.GetSchema().Unique()),
+                   "This Insert is designed for secondary indexes with no uniqueness constraints.");
+    KeyType index_key;
+    index_key.SetFromProjectedRow(tuple, metadata_);
+    const bool result = bplustree_->Insert(index_key, location);
+
+    TERRIER_ASSERT(result, "non-unique index shouldn't fail to insert. If it did, the same entry was inserted twice.");
+    // Register an abort action with the txn context in case of rollback
+    txn->RegisterAbortAction([=]() {
+      const bool UNUSED_ATTRIBUTE result = bplustree_->Delete(index_key, location);
+      TERRIER_ASSERT(result, "Delete on the index failed.");
+    });
+    return result;
+  }
+
+  bool InsertUnique(transaction::TransactionContext *const txn, const ProjectedRow &tuple,
+                    const TupleSlot location) final {
+    TERRIER_ASSERT(metadata_.GetSchema().Unique(), "This Insert is designed for indexes with uniqueness constraints.");
+    KeyType index_key;
+    index_key.SetFromProjectedRow(tuple, metadata_);
+    bool predicate_satisfied = false;
+
+    // The predicate checks if any matching keys have write-write conflicts or are still visible to the calling txn.
+    auto predicate = [txn](const TupleSlot slot) -> bool {
+      const auto *const data_table = slot.GetBlock()->data_table_;
+      const auto has_conflict = data_table->HasConflict(*txn, slot);
+      const auto is_visible = data_table->IsVisible(*txn, slot);
+      return has_conflict || is_visible;
+    };
+
+    const bool result = bplustree_->ConditionalInsert(index_key, location, predicate, &predicate_satisfied);
+
+    TERRIER_ASSERT(predicate_satisfied != result, "If predicate is not satisfied then insertion should succeed.");
+
+    if (result) {
+      // Register an abort action with the txn context in case of rollback
+      txn->RegisterAbortAction([=]() {
+        const bool UNUSED_ATTRIBUTE result = bplustree_->Delete(index_key, location);
+        TERRIER_ASSERT(result, "Delete on the index failed.");
+      });
+    } else {
+      // Presumably you've already made modifications to a DataTable (the source of the TupleSlot argument to this
+      // function) however, the index found a constraint violation and cannot allow that operation to succeed. For MVCC
+      // correctness, this txn must now abort for the GC to clean up the version chain in the DataTable correctly.
+      txn->MustAbort();
+    }
+
+    return result;
+  }
+
+  void Delete(transaction::TransactionContext *const txn, const ProjectedRow &tuple, const TupleSlot location) final {
+    KeyType index_key;
+    index_key.SetFromProjectedRow(tuple, metadata_);
+
+    TERRIER_ASSERT(!(location.GetBlock()->data_table_->HasConflict(*txn, location)) &&
+                       !(location.GetBlock()->data_table_->IsVisible(*txn, location)),
+                   "Called index delete on a TupleSlot that has a conflict with this txn or is still visible.");
+
+    // The entry may never have been inserted if the index is still being loaded. See IndexBuilder::BulkLoad.
+    const bool UNUSED_ATTRIBUTE under_construction = UnderConstruction();
+
+    // Register a deferred action for the GC with txn manager. See base function comment.
+    txn->RegisterCommitAction([=](transaction::DeferredActionManager *deferred_action_manager) {
+      deferred_action_manager->RegisterDeferredAction([=]() {
+        const bool UNUSED_ATTRIBUTE result = bplustree_->Delete(index_key, location);
+        TERRIER_ASSERT(result || under_construction, "Deferred delete on the index failed.");
+      });
+    });
+  }
+
+  void BulkInsert(const std::vector<std::pair<const ProjectedRow *, TupleSlot>> &entries) final {
+    std::vector<std::pair<KeyType, TupleSlot>> index_entries(entries.size());
+    for (uint32_t i = 0; i < entries.size(); i++) {
+      index_entries[i].first.SetFromProjectedRow(*entries[i].first, metadata_);
+      index_entries[i].second = entries[i].second;
+    }
+
+    // Inserting in key order makes consecutive inserts go to the same few nodes, which then stay in cache
+    std::sort(index_entries.begin(), index_entries.end(),
+              [](const auto &a, const auto &b) { return std::less<KeyType>()(a.first, b.first); });
+    // Pairs that are already in the index are refused
+    for (const auto &entry : index_entries) bplustree_->Insert(entry.first, entry.second);
+  }
+
+  void ScanKey(const transaction::TransactionContext &txn, const ProjectedRow &key,
+               std::vector<TupleSlot> *value_list) final {
+    TERRIER_ASSERT(value_list->empty(), "Result set should begin empty.");
+
+    // Build search key
+    KeyType index_key;
+    index_key.SetFromProjectedRow(key, metadata_);
+
+    // Perform lookup in BPlusTree, with visibility check on every result
+    bplustree_->ScanAscending(index_key, index_key, [&](const TupleSlot result) {
+      if (IsVisible(txn, result)) value_list->emplace_back(result);
+      return true;
+    });
+
+    // Until an index under construction has been checked, it may hold tuples that violate its uniqueness
+    TERRIER_ASSERT(!(metadata_.GetSchema().Unique()) || (metadata_.GetSchema().Unique() && value_list->size() <= 1) ||
+                       UnderConstruction(),
+                   "Invalid number of results for unique index.");
+  }
+
+  void ScanAscending(const transaction::TransactionContext &txn, const ProjectedRow &low_key,
+                     const ProjectedRow &high_key, std::vector<TupleSlot> *value_list) final {
+    TERRIER_ASSERT(value_list->empty(), "Result set should begin empty.");
+
+    // Build search keys
+    KeyType index_low_key, index_high_key;
+    index_low_key.SetFromProjectedRow(low_key, metadata_);
+    index_high_key.SetFromProjectedRow(high_key, metadata_);
+
+    // Perform lookup in BPlusTree, with visibility check on every result
+    bplustree_->ScanAscending(index_low_key, index_high_key, [&](const TupleSlot result) {
+      if (IsVisible(txn, result)) value_list->emplace_back(result);
+      return true;
+    });
+  }
+
+  void ScanDescending(const transaction::TransactionContext &txn, const ProjectedRow &low_key,
+                      const ProjectedRow &high_key, std::vector<TupleSlot> *value_list) final {
+    TERRIER_ASSERT(value_list->empty(), "Result set should begin empty.");
+
+    // Build search keys
+    KeyType index_low_key, index_high_key;
+    index_low_key.SetFromProjectedRow(low_key, metadata_);
+    index_high_key.SetFromProjectedRow(high_key, metadata_);
+
+    // Perform lookup in BPlusTree, with visibility check on every result
+    bplustree_->ScanDescending(index_low_key, index_high_key, [&](const TupleSlot result) {
+      if (IsVisible(txn, result)) value_list->emplace_back(result);
+      return true;
+    });
+  }
+
+  void ScanLimitAscending(const transaction::TransactionContext &txn, const ProjectedRow &low_key,
+                          const ProjectedRow &high_key, std::vector<TupleSlot> *value_list,
+                          const uint32_t limit) final {
+    TERRIER_ASSERT(value_list->empty(), "Result set should begin empty.");
+    TERRIER_ASSERT(limit > 0, "Limit must be greater than 0.");
+
+    // Build search keys
+    KeyType index_low_key, index_high_key;
+    index_low_key.SetFromProjectedRow(low_key, metadata_);
+    index_high_key.SetFromProjectedRow(high_key, metadata_);
+
+    // Perform lookup in BPlusTree, stopping once enough results are visible
+    bplustree_->ScanAscending(index_low_key, index_high_key, [&](const TupleSlot result) {
+      if (IsVisible(txn, result)) value_list->emplace_back(result);
+      return value_list->size() < limit;
+    });
+  }
+
+  void ScanLimitDescending(const transaction::TransactionContext &txn, const ProjectedRow &low_key,
+                           const ProjectedRow &high_key, std::vector<TupleSlot> *value_list,
+                           const uint32_t limit) final {
+    TERRIER_ASSERT(value_list->empty(), "Result set should begin empty.");
+    TERRIER_ASSERT(limit > 0, "Limit must be greater than 0.");
+
+    // Build search keys
+    KeyType index_low_key, index_high_key;
+    index_low_key.SetFromProjectedRow(low_key, metadata_);
+    index_high_key.SetFromProjectedRow(high_key, metadata_);
+
+    // Perform lookup in BPlusTree, stopping once enough results are visible
+    bplustree_->ScanDescending(index_low_key, index_high_key, [&](const TupleSlot result) {
+      if (IsVisible(txn, result)) value_list->emplace_back(result);
+      return value_list->size() < limit;
+    });
+  }
+};
+
+}  // namespace terrier::storage::index
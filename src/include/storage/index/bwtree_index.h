@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <functional>
 #include <memory>
 #include <utility>
@@ -93,15 +94,32 @@ class BwTreeIndex final : public Index {
                        !(location.GetBlock()->data_table_->IsVisible(*txn, location)),
                    "Called index delete on a TupleSlot that has a conflict with this txn or is still visible.");
 
+    // The entry may never have been inserted if the index is still being loaded. See IndexBuilder::BulkLoad.
+    const bool UNUSED_ATTRIBUTE under_construction = UnderConstruction();
+
     // Register a deferred action for the GC with txn manager. See base function comment.
     txn->RegisterCommitAction([=](transaction::DeferredActionManager *deferred_action_manager) {
       deferred_action_manager->RegisterDeferredAction([=]() {
         const bool UNUSED_ATTRIBUTE result = bwtree_->Delete(index_key, location);
-        TERRIER_ASSERT(result, "Deferred delete on the index failed.");
+        TERRIER_ASSERT(result || under_construction, "Deferred delete on the index failed.");
       });
     });
   }
 
+  void BulkInsert(const std::vector<std::pair<const ProjectedRow *, TupleSlot>> &entries) final {
+    std::vector<std::pair<KeyType, TupleSlot>> index_entries(entries.size());
+    for (uint32_t i = 0; i < entries.size(); i++) {
+      index_entries[i].first.SetFromProjectedRow(*entries[i].first, metadata_);
+      index_entries[i].second = entries[i].second;
+    }
+
+    // Inserting in key order makes consecutive inserts go to the same few nodes, which then stay in cache
+    std::sort(index_entries.begin(), index_entries.end(),
+              [](const auto &a, const auto &b) { return std::less<KeyType>()(a.first, b.first); });
+    // Pairs that are already in the index are refused
+    for (const auto &entry : index_entries) bwtree_->Insert(entry.first, entry.second, false);
+  }
+
   void ScanKey(const transaction::TransactionContext &txn, const ProjectedRow &key,
                std::vector<TupleSlot> *value_list) final {
     TERRIER_ASSERT(value_list->empty(), "Result set should begin empty.");
@@ -123,10 +141,32 @@ class BwTreeIndex final : public Index {
       if (IsVisible(txn, result)) value_list->emplace_back(result);
     }
 
-    TERRIER_ASSERT(!(metadata_.GetSchema().Unique()) || (metadata_.GetSchema().Unique() && value_list->size() <= 1),
+    // Until an index under construction has been checked, it may hold tuples that violate its uniqueness
+    TERRIER_ASSERT(!(metadata_.GetSchema().Unique()) || (metadata_.GetSchema().Unique() && value_list->size() <= 1) ||
+                       UnderConstruction(),
                    "Invalid number of results for unique index.");
   }
 
+  void ScanKeyBatch(const transaction::TransactionContext &txn, const std::vector<const ProjectedRow *> &keys,
+                    std::vector<TupleSlot> *value_list, std::vector<uint32_t> *key_ends) final {
+    TERRIER_ASSERT(value_list->empty() && key_ends->empty(), "Result sets should begin empty.");
+
+    // The BwTree traverses its nodes internally, so its lookups run one after the other. What we can overlap are the
+    // visibility checks, which are left to a second pass over the values of all the keys.
+    std::vector<TupleSlot> results;
+    KeyType index_key;
+    key_ends->reserve(keys.size());
+    for (const auto *const key : keys) {
+      index_key.SetFromProjectedRow(*key, metadata_);
+      bwtree_->GetValue(index_key, results);
+      value_list->insert(value_list->end(), results.begin(), results.end());
+      key_ends->push_back(static_cast<uint32_t>(value_list->size()));
+      results.clear();
+    }
+
+    FilterVisible(txn, value_list, key_ends);
+  }
+
   void ScanAscending(const transaction::TransactionContext &txn, const ProjectedRow &low_key,
                      const ProjectedRow &high_key, std::vector<TupleSlot> *value_list) final {
     TERRIER_ASSERT(value_list->empty(), "Result set should begin empty.");
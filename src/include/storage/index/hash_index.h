@@ -3,17 +3,15 @@
 #include <algorithm>
 #include <functional>
 #include <memory>
-#include <unordered_set>
 #include <utility>
-#include <variant>  // NOLINT (Matt): lint thinks this C++17 header is a C header because it only knows C++11
 #include <vector>
 #include "libcuckoo/cuckoohash_map.hh"
 #include "storage/index/index.h"
 #include "storage/index/index_defs.h"
+#include "storage/index/tuple_slot_list.h"
 #include "transaction/deferred_action_manager.h"
 #include "transaction/transaction_context.h"
 #include "transaction/transaction_manager.h"
-#include "xxHash/xxh3.h"
 
 namespace terrier::storage::index {
 
@@ -24,8 +22,8 @@ constexpr uint16_t INITIAL_CUCKOOHASH_MAP_SIZE = 256;
 /**
  * Wrapper around libcuckoo's hash map. The MVCC is logic is similar to our reference index (BwTreeIndex). Much of the
  * logic here is related to the cuckoohash_map not being a multimap. We get around this by making the value type a
- * std::variant that can either be a TupleSlot if there's only a single value for a given key, or a std::unordered_set
- * of TupleSlots if a single key needs to map to multiple TupleSlots.
+ * TupleSlotList, which holds a few TupleSlots inline and spills into a flat array if a single key needs to map to more.
+ * Per-key-size specializations come from the HashKey and GenericKey templates, chosen by the IndexBuilder.
  * @tparam KeyType the type of keys stored in the map
  */
 template <typename KeyType>
@@ -33,14 +31,7 @@ class HashIndex final : public Index {
   friend class IndexBuilder;
 
  private:
-  struct TupleSlotHash {
-    std::size_t operator()(const TupleSlot &slot) const {
-      return XXH3_64bits(reinterpret_cast<const void *>(&slot), sizeof(TupleSlot));
-    }
-  };
-
-  using ValueMap = std::unordered_set<TupleSlot, TupleSlotHash>;
-  using ValueType = std::variant<TupleSlot, ValueMap>;
+  using ValueType = TupleSlotList;
 
   explicit HashIndex(IndexMetadata metadata)
       : Index(std::move(metadata)), hash_map_{new cuckoohash_map<KeyType, ValueType>(INITIAL_CUCKOOHASH_MAP_SIZE)} {}
@@ -49,35 +40,23 @@ class HashIndex final : public Index {
 
   /**
    * The lambda below is used for aborted inserts as well as committed deletes to perform the erase logic. Macros are
-   * ugly but you can't define a macro that captures location outside of the scope of that variable
+   * ugly but you can't define a macro that captures location outside of the scope of that variable. may_be_missing
+   * is true if the index might not have the entry, which happens for deletes while the index is being loaded.
    */
-#define ERASE_KEY_ACTION                                                                                               \
+#define ERASE_KEY_ACTION(may_be_missing)                                                                               \
   [=]() {                                                                                                              \
     /* See the underlying container's API for more details, but the lambda below is invoked when the key is found. */  \
-    auto key_found_fn = [location](ValueType &value) -> bool {                                                         \
-      if (std::holds_alternative<TupleSlot>(value)) {                                                                  \
-        /* It's just a TupleSlot, functor should return true for cuckoohash_map's uprase_fn to erase key/value pair */ \
+    auto key_found_fn = [=](ValueType &value) -> bool {                                                                \
+      if (value.Size() == 1 && value.Contains(location)) {                                                             \
+        /* It's the last TupleSlot, functor should return true for cuckoohash_map's erase_fn to erase the pair */      \
         return true;                                                                                                   \
       }                                                                                                                \
-      auto &value_map = std::get<ValueMap>(value);                                                                     \
-      if (value_map.size() == 2) {                                                                                     \
-        /* functor should replace the ValueMap with a TupleSlot for the other location */                              \
-        for (const auto i : value_map) {                                                                               \
-          if (i != location) {                                                                                         \
-            value = i; /* Assigning TupleSlot type will change the std::variant to TupleSlot and free the ValueMap */  \
-            TERRIER_ASSERT(std::holds_alternative<TupleSlot>(value), "value should now be a TupleSlot.");              \
-            return false; /* Return false so cuckoohash_map's uprase_fn doesn't erase key/value pair */                \
-          }                                                                                                            \
-        }                                                                                                              \
-      }                                                                                                                \
-      /* ValueMap contains more than 2 elements, erase location from the ValueMap */                                   \
-      const auto UNUSED_ATTRIBUTE erase_result = value_map.erase(location);                                            \
-      TERRIER_ASSERT(erase_result == 1, "Erasing from the ValueMap should not fail.");                                 \
-      TERRIER_ASSERT(value_map.size() > 1, "ValueMap should not have fewer than 2 elements.");                         \
-      return false; /* Return false so cuckoohash_map's uprase_fn doesn't erase key/value pair */                      \
+      const bool UNUSED_ATTRIBUTE erase_result = value.Remove(location);                                               \
+      TERRIER_ASSERT(erase_result || (may_be_missing), "Erasing from the TupleSlotList should not fail.");             \
+      return false; /* Return false so cuckoohash_map's erase_fn doesn't erase key/value pair */                       \
     };                                                                                                                 \
-    const bool UNUSED_ATTRIBUTE uprase_result = hash_map_->uprase_fn(index_key, key_found_fn);                         \
-    TERRIER_ASSERT(!uprase_result, "This operation should NOT insert a new key into the cuckoohash_map.");             \
+    const bool UNUSED_ATTRIBUTE erase_result = hash_map_->erase_fn(index_key, key_found_fn);                           \
+    TERRIER_ASSERT(erase_result || (may_be_missing), "The key to erase should be in the cuckoohash_map.");             \
   }
 
  public:
@@ -105,16 +84,9 @@ class HashIndex final : public Index {
      * return true if cuckoohash_map's uprase_fn should delete the key/value pair. For inserts we always return false.
      */
     auto key_found_fn = [location, &insert_result](ValueType &value) -> bool {
-      if (std::holds_alternative<TupleSlot>(value)) {
-        // replace the TupleSlot with a ValueMap containing both the old and new inserted value
-        const auto existing_location = std::get<TupleSlot>(value);
-        value = ValueMap({{location}, {existing_location}}, 2);
-        insert_result = true;
-      } else {
-        // insert the location to the cuckoohash_map
-        auto &value_map = std::get<ValueMap>(value);
-        insert_result = value_map.emplace(location).second;
-      }
+      // add the location to the key's existing values
+      value.Add(location);
+      insert_result = true;
       return false;
     };
 
@@ -125,7 +97,7 @@ class HashIndex final : public Index {
                    "inserted (insert_result).");
 
     // Register an abort action with the txn context in case of rollback
-    txn->RegisterAbortAction(ERASE_KEY_ACTION);
+    txn->RegisterAbortAction(ERASE_KEY_ACTION(false));
 
     return true;
   }
@@ -164,26 +136,12 @@ class HashIndex final : public Index {
      * return true if cuckoohash_map's uprase_fn should delete the key/value pair. For inserts we always return false.
      */
     auto key_found_fn = [location, &insert_result, &predicate_satisfied, predicate](ValueType &value) -> bool {
-      if (std::holds_alternative<TupleSlot>(value)) {
-        const auto existing_location = std::get<TupleSlot>(value);
-        predicate_satisfied = predicate(existing_location);
-        if (!predicate_satisfied) {
-          // replace the TupleSlot with a ValueMap containing both the old and new inserted value
-          value = ValueMap({{location}, {existing_location}}, 2);
-          insert_result = true;
-        }
-      } else {
-        auto &value_map = std::get<ValueMap>(value);
-
-        predicate_satisfied = std::any_of(value_map.cbegin(), value_map.cend(), predicate);
-
-        if (!predicate_satisfied) {
-          // insert the location to the cuckoohash_map
-          insert_result = value_map.emplace(location).second;
-          TERRIER_ASSERT(insert_result,
-                         " index shouldn't fail to insert after predicate check. If it did, something went wrong deep "
-                         "inside the hash map itself.");
-        }
+      predicate_satisfied = std::any_of(value.begin(), value.end(), predicate);
+
+      if (!predicate_satisfied) {
+        // add the location to the key's existing values
+        value.Add(location);
+        insert_result = true;
       }
       return false;
     };
@@ -198,7 +156,7 @@ class HashIndex final : public Index {
                    "inserted (insert_result).");
 
     if (overall_result) {
-      txn->RegisterAbortAction(ERASE_KEY_ACTION);
+      txn->RegisterAbortAction(ERASE_KEY_ACTION(false));
     } else {
       // Presumably you've already made modifications to a DataTable (the source of the TupleSlot argument to this
       // function) however, the index found a constraint violation and cannot allow that operation to succeed. For MVCC
@@ -217,12 +175,34 @@ class HashIndex final : public Index {
                        !(location.GetBlock()->data_table_->IsVisible(*txn, location)),
                    "Called index delete on a TupleSlot that has a conflict with this txn or is still visible.");
 
+    // The entry may never have been inserted if the index is still being loaded. See IndexBuilder::BulkLoad.
+    const bool UNUSED_ATTRIBUTE under_construction = UnderConstruction();
+
     // Register a deferred action for the GC with txn manager. See base function comment.
     txn->RegisterCommitAction([=](transaction::DeferredActionManager *deferred_action_manager) {
-      deferred_action_manager->RegisterDeferredAction(ERASE_KEY_ACTION);
+      deferred_action_manager->RegisterDeferredAction(ERASE_KEY_ACTION(under_construction));
     });
   }
 
+  void BulkInsert(const std::vector<std::pair<const ProjectedRow *, TupleSlot>> &entries) final {
+    const auto num_entries = static_cast<uint32_t>(entries.size());
+    std::vector<KeyType> index_keys(num_entries);
+    for (uint32_t i = 0; i < num_entries; i++) index_keys[i].SetFromProjectedRow(*entries[i].first, metadata_);
+
+    // Like ScanKeyBatch, prefetch the buckets of keys a few inserts ahead
+    for (uint32_t i = 0; i < std::min(BATCH_PREFETCH_DISTANCE, num_entries); i++) hash_map_->prefetch(index_keys[i]);
+    for (uint32_t i = 0; i < num_entries; i++) {
+      if (i + BATCH_PREFETCH_DISTANCE < num_entries) hash_map_->prefetch(index_keys[i + BATCH_PREFETCH_DISTANCE]);
+      const TupleSlot location = entries[i].second;
+      // Add the location to the key's existing values, unless it is already there
+      auto key_found_fn = [location](ValueType &value) -> bool {
+        if (!value.Contains(location)) value.Add(location);
+        return false;
+      };
+      hash_map_->uprase_fn(index_keys[i], key_found_fn, location);
+    }
+  }
+
   void ScanKey(const transaction::TransactionContext &txn, const ProjectedRow &key,
                std::vector<TupleSlot> *value_list) final {
     TERRIER_ASSERT(value_list->empty(), "Result set should begin empty.");
@@ -243,24 +223,45 @@ class HashIndex final : public Index {
      * key_found_fn)
      */
     auto key_found_fn = [value_list, &txn](const ValueType &value) -> void {
-      if (std::holds_alternative<TupleSlot>(value)) {
-        const auto existing_location = std::get<TupleSlot>(value);
-        if (IsVisible(txn, existing_location)) value_list->emplace_back(existing_location);
-      } else {
-        const auto &value_map = std::get<ValueMap>(value);
-
-        for (const auto i : value_map) {
-          if (IsVisible(txn, i)) value_list->emplace_back(i);
-        }
+      for (const auto i : value) {
+        if (IsVisible(txn, i)) value_list->emplace_back(i);
       }
     };
 
     const bool UNUSED_ATTRIBUTE find_result = hash_map_->find_fn(index_key, key_found_fn);
 
-    TERRIER_ASSERT(!(metadata_.GetSchema().Unique()) || (metadata_.GetSchema().Unique() && value_list->size() <= 1),
+    // Until an index under construction has been checked, it may hold tuples that violate its uniqueness
+    TERRIER_ASSERT(!(metadata_.GetSchema().Unique()) || (metadata_.GetSchema().Unique() && value_list->size() <= 1) ||
+                       UnderConstruction(),
                    "Invalid number of results for unique index.");
   }
 
+  void ScanKeyBatch(const transaction::TransactionContext &txn, const std::vector<const ProjectedRow *> &keys,
+                    std::vector<TupleSlot> *value_list, std::vector<uint32_t> *key_ends) final {
+    TERRIER_ASSERT(value_list->empty() && key_ends->empty(), "Result sets should begin empty.");
+    const auto num_keys = static_cast<uint32_t>(keys.size());
+
+    // Build search keys
+    std::vector<KeyType> index_keys(num_keys);
+    for (uint32_t i = 0; i < num_keys; i++) index_keys[i].SetFromProjectedRow(*keys[i], metadata_);
+
+    // Collect every value first, and leave the visibility checks to a second pass over all of them
+    auto key_found_fn = [value_list](const ValueType &value) -> void {
+      value_list->insert(value_list->end(), value.begin(), value.end());
+    };
+
+    // Prefetch the buckets of keys a few lookups ahead, so that their cache misses overlap with the lookups in between
+    for (uint32_t i = 0; i < std::min(BATCH_PREFETCH_DISTANCE, num_keys); i++) hash_map_->prefetch(index_keys[i]);
+    key_ends->reserve(num_keys);
+    for (uint32_t i = 0; i < num_keys; i++) {
+      if (i + BATCH_PREFETCH_DISTANCE < num_keys) hash_map_->prefetch(index_keys[i + BATCH_PREFETCH_DISTANCE]);
+      hash_map_->find_fn(index_keys[i], key_found_fn);
+      key_ends->push_back(static_cast<uint32_t>(value_list->size()));
+    }
+
+    FilterVisible(txn, value_list, key_ends);
+  }
+
 #undef ERASE_KEY_ACTION
 };
 
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <algorithm>
+#include <atomic>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -24,9 +26,13 @@ namespace terrier::storage::index {
  */
 class Index {
  private:
+  friend class IndexBuilder;
   friend class IndexKeyTests;
   friend class storage::RecoveryManager;
 
+  // Set from the creation of an index over a populated table until the IndexBuilder is done loading it
+  std::atomic<bool> under_construction_ = false;
+
  protected:
   /**
    * Cached metadata that allows for performance optimizations in the index keys.
@@ -44,6 +50,42 @@ class Index {
     return data_table->IsVisible(txn, slot);
   }
 
+  /**
+   * Hints the CPU to start loading what IsVisible reads for a tuple, so that it is in cache by the time of the check.
+   * @param slot the slot of the tuple to prefetch
+   */
+  static void PrefetchVisibility(const TupleSlot slot) { slot.GetBlock()->data_table_->PrefetchVisibility(slot); }
+
+  /**
+   * How many keys or tuples ahead of the one being worked on batched lookups prefetch. Far enough ahead to hide a
+   * memory access behind the work on the ones in between, but not so far that prefetched lines get evicted again.
+   */
+  static constexpr uint32_t BATCH_PREFETCH_DISTANCE = 16;
+
+  /**
+   * Drops the values of a batched lookup that are not visible to the transaction, keeping them grouped by key. The
+   * tuples are prefetched ahead of their visibility checks, so that the cache misses of the checks overlap.
+   * @param txn the calling transaction
+   * @param[in,out] value_list values of all the keys in the batch, grouped by key
+   * @param[in,out] key_ends for every key, the end of its group of values in value_list
+   */
+  static void FilterVisible(const transaction::TransactionContext &txn, std::vector<TupleSlot> *const value_list,
+                            std::vector<uint32_t> *const key_ends) {
+    const auto num_values = static_cast<uint32_t>(value_list->size());
+    for (uint32_t i = 0; i < std::min(BATCH_PREFETCH_DISTANCE, num_values); i++) PrefetchVisibility((*value_list)[i]);
+    uint32_t num_visible = 0;
+    uint32_t begin = 0;
+    for (auto &end : *key_ends) {
+      for (uint32_t i = begin; i < end; i++) {
+        if (i + BATCH_PREFETCH_DISTANCE < num_values) PrefetchVisibility((*value_list)[i + BATCH_PREFETCH_DISTANCE]);
+        if (IsVisible(txn, (*value_list)[i])) (*value_list)[num_visible++] = (*value_list)[i];
+      }
+      begin = end;
+      end = num_visible;
+    }
+    value_list->resize(num_visible);
+  }
+
   /**
    * Creates a new index wrapper.
    * @param metadata index description
@@ -92,6 +134,21 @@ class Index {
    */
   virtual void Delete(transaction::TransactionContext *txn, const ProjectedRow &tuple, TupleSlot location) = 0;
 
+  /**
+   * Inserts key-value pairs without registering any transactional actions, skipping pairs that are already in the
+   * index. The IndexBuilder loads indexes over populated tables with it, while transactions keep maintaining them, so
+   * both may insert the same pair. Safe to call concurrently with itself and any other operation.
+   * @param entries keys and the values they map to
+   */
+  virtual void BulkInsert(const std::vector<std::pair<const ProjectedRow *, TupleSlot>> &entries) = 0;
+
+  /**
+   * @return true if the index was created over a populated table and the IndexBuilder has not finished loading it. Such
+   * an index must be maintained like any other, but may not be read from: it is missing entries. Transactions
+   * deleting from it may not find entries for tuples the load never got to, which is fine.
+   */
+  bool UnderConstruction() const { return under_construction_.load(); }
+
   /**
    * Finds all the values associated with the given key in our index.
    * @param txn txn context for the calling txn, used for visibility checks
@@ -101,6 +158,26 @@ class Index {
   virtual void ScanKey(const transaction::TransactionContext &txn, const ProjectedRow &key,
                        std::vector<TupleSlot> *value_list) = 0;
 
+  /**
+   * Finds all the values associated with each of the given keys in our index. The result is the same as that of
+   * calling ScanKey on every key in turn, but indexes can overlap the cache misses of the lookups.
+   * @param txn txn context for the calling txn, used for visibility checks
+   * @param keys the keys to look for
+   * @param[out] value_list the values associated with the keys, grouped by key in the order of the keys
+   * @param[out] key_ends for every key, the end of its group of values in value_list
+   */
+  virtual void ScanKeyBatch(const transaction::TransactionContext &txn, const std::vector<const ProjectedRow *> &keys,
+                            std::vector<TupleSlot> *value_list, std::vector<uint32_t> *key_ends) {
+    TERRIER_ASSERT(value_list->empty() && key_ends->empty(), "Result sets should begin empty.");
+    std::vector<TupleSlot> key_values;
+    for (const auto *const key : keys) {
+      ScanKey(txn, *key, &key_values);
+      value_list->insert(value_list->end(), key_values.begin(), key_values.end());
+      key_ends->push_back(static_cast<uint32_t>(value_list->size()));
+      key_values.clear();
+    }
+  }
+
   /**
    * Finds all the values between the given keys in our index, sorted in ascending order.
    * @param txn txn context for the calling txn, used for visibility checks
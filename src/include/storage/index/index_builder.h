@@ -1,9 +1,12 @@
 #pragma once
 
+#include <functional>
 #include <utility>
 #include <vector>
 #include "catalog/catalog_defs.h"
 #include "catalog/index_schema.h"
+#include "common/managed_pointer.h"
+#include "storage/index/bplustree_index.h"
 #include "storage/index/bwtree_index.h"
 #include "storage/index/compact_ints_key.h"
 #include "storage/index/generic_key.h"
@@ -13,23 +16,87 @@
 #include "storage/index/index_defs.h"
 #include "storage/index/index_metadata.h"
 #include "storage/projected_row.h"
+#include "storage/sql_table.h"
+#include "transaction/transaction_manager.h"
 
 namespace terrier::storage::index {
 
 /**
- * The IndexBuilder automatically creates the best possible index for the given parameters.
+ * The IndexBuilder automatically creates the best possible index for the given parameters. Given the table the index
+ * is on, it can also fill the index with the table's tuples without blocking transactions (see BulkLoad).
  */
 class IndexBuilder {
  private:
   catalog::IndexSchema key_schema_;
+  common::ManagedPointer<SqlTable> sql_table_;
+  transaction::TransactionManager *txn_manager_ = nullptr;
 
  public:
   IndexBuilder() = default;
 
   /**
-   * @return a new best-possible index for the current parameters, nullptr if it failed to construct a valid index
+   * @return a new best-possible index for the current parameters, nullptr if it failed to construct a valid index. If
+   * a table was set, the index is under construction until BulkLoad is done with it.
    */
   Index *Build() const {
+    Index *const index = BuildEmpty();
+    if (index != nullptr && sql_table_ != nullptr) index->under_construction_ = true;
+    return index;
+  }
+
+  /**
+   * Fills an index under construction with the entries of every tuple in the table. Transactions can keep writing to
+   * the table throughout, as long as the ones that started after the index was handed out maintain it.
+   *
+   * The protocol is that of building an index without a side file: transactions that know of the index maintain it
+   * themselves, and the load only has to account for the ones that don't. It waits for the transactions that started
+   * before the call to finish, and then inserts the entries of every tuple visible to a snapshot taken after that.
+   * Inserts skip entries that transactions already inserted. Deletes of tuples the snapshot sees are deferred until
+   * the snapshot is done, like any GC, so they find the loaded entries. Deletes of tuples it does not see find nothing
+   * to delete, which the index tolerates while under construction.
+   *
+   * The table's blocks are loaded in parallel, and ordered indexes insert the entries of every range of blocks in key
+   * order. Unique indexes are checked once the transactions that maintained them during the load are done, since
+   * they checked uniqueness against an incomplete index.
+   *
+   * @param index an index built by this builder, after the transactions that should maintain it can see it
+   * @return true if the index is complete and can be read from, false if the table violates its uniqueness. In that
+   * case, the index should be dropped.
+   */
+  bool BulkLoad(Index *index) const;
+
+  /**
+   * @param key_schema the index key schema
+   * @return the builder object
+   */
+  IndexBuilder &SetKeySchema(const catalog::IndexSchema &key_schema) {
+    key_schema_ = key_schema;
+    return *this;
+  }
+
+  /**
+   * @param sql_table the populated table the index is on
+   * @param txn_manager the transaction manager of the transactions writing to the table
+   * @return the builder object
+   */
+  IndexBuilder &SetSqlTableAndTransactionManager(const common::ManagedPointer<SqlTable> sql_table,
+                                                 transaction::TransactionManager *const txn_manager) {
+    sql_table_ = sql_table;
+    txn_manager_ = txn_manager;
+    return *this;
+  }
+
+ private:
+  // Waits until every transaction that started before the given time has finished
+  void WaitForTransactionsBefore(transaction::timestamp_t time) const;
+
+  // Hands the key of every tuple visible to the transaction, along with its slot, to the consumer. Ranges of blocks are
+  // scanned in parallel, and the consumer is called once per range.
+  void ScanKeys(transaction::TransactionContext *txn, const Index &index,
+                const std::function<void(const std::vector<std::pair<const ProjectedRow *, TupleSlot>> &)> &consumer)
+      const;
+
+  Index *BuildEmpty() const {
     TERRIER_ASSERT(!key_schema_.GetColumns().empty(), "Cannot build an index without a KeySchema.");
 
     IndexMetadata metadata(key_schema_);
@@ -53,21 +120,17 @@ class IndexBuilder {
         if (simple_key && metadata.KeySize() <= HASHKEY_MAX_SIZE) return BuildHashIntsKey(std::move(metadata));
         return BuildHashGenericKey(std::move(metadata));
       }
+      case IndexType::BPLUSTREE: {
+        if (simple_key && metadata.KeySize() <= COMPACTINTSKEY_MAX_SIZE) {
+          return BuildBPlusTreeIntsKey(std::move(metadata));
+        }
+        return BuildBPlusTreeGenericKey(std::move(metadata));
+      }
       default:
         return nullptr;
     }
   }
 
-  /**
-   * @param key_schema the index key schema
-   * @return the builder object
-   */
-  IndexBuilder &SetKeySchema(const catalog::IndexSchema &key_schema) {
-    key_schema_ = key_schema;
-    return *this;
-  }
-
- private:
   Index *BuildBwTreeIntsKey(IndexMetadata metadata) const {
     metadata.SetKeyKind(IndexKeyKind::COMPACTINTSKEY);
     const auto key_size = metadata.KeySize();
@@ -107,6 +170,45 @@ class IndexBuilder {
     return index;
   }
 
+  Index *BuildBPlusTreeIntsKey(IndexMetadata metadata) const {
+    metadata.SetKeyKind(IndexKeyKind::COMPACTINTSKEY);
+    const auto key_size = metadata.KeySize();
+    TERRIER_ASSERT(key_size <= COMPACTINTSKEY_MAX_SIZE, "Key size exceeds maximum for this key type.");
+    Index *index = nullptr;
+    if (key_size <= 8) {
+      index = new BPlusTreeIndex<CompactIntsKey<8>>(std::move(metadata));
+    } else if (key_size <= 16) {
+      index = new BPlusTreeIndex<CompactIntsKey<16>>(std::move(metadata));
+    } else if (key_size <= 24) {
+      index = new BPlusTreeIndex<CompactIntsKey<24>>(std::move(metadata));
+    } else if (key_size <= 32) {
+      index = new BPlusTreeIndex<CompactIntsKey<32>>(std::move(metadata));
+    }
+    TERRIER_ASSERT(index != nullptr, "Failed to create an IntsKey index.");
+    return index;
+  }
+
+  Index *BuildBPlusTreeGenericKey(IndexMetadata metadata) const {
+    metadata.SetKeyKind(IndexKeyKind::GENERICKEY);
+    const auto pr_size = metadata.GetInlinedPRInitializer().ProjectedRowSize();
+    Index *index = nullptr;
+
+    const auto key_size =
+        (pr_size + 8) +
+        sizeof(uintptr_t);  // account for potential padding of the PR and the size of the pointer for metadata
+    TERRIER_ASSERT(key_size <= GENERICKEY_MAX_SIZE, "Key size exceeds maximum for this key type.");
+
+    if (key_size <= 64) {
+      index = new BPlusTreeIndex<GenericKey<64>>(std::move(metadata));
+    } else if (key_size <= 128) {
+      index = new BPlusTreeIndex<GenericKey<128>>(std::move(metadata));
+    } else if (key_size <= 256) {
+      index = new BPlusTreeIndex<GenericKey<256>>(std::move(metadata));
+    }
+    TERRIER_ASSERT(index != nullptr, "Failed to create an GenericKey index.");
+    return index;
+  }
+
   Index *BuildHashIntsKey(IndexMetadata metadata) const {
     metadata.SetKeyKind(IndexKeyKind::HASHKEY);
     const auto key_size = metadata.KeySize();
@@ -0,0 +1,171 @@
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include "common/macros.h"
+#include "storage/storage_defs.h"
+
+namespace terrier::storage::index {
+
+/**
+ * The values a single key maps to in a HashIndex. Up to INLINE_CAPACITY values are stored inline, so keys without
+ * duplicates (and keys with only a few) never allocate. Beyond that, the values spill into one flat array on the heap
+ * that grows by doubling, and move back inline once they fit again. Lookups scan the values sequentially, which is
+ * cheaper than hashing into a node-based set for anything but very long lists.
+ *
+ * Values are kept in no particular order, and the list is not thread-safe: HashIndex only touches it under the lock
+ * of the bucket holding its key.
+ */
+class TupleSlotList {
+ public:
+  /**
+   * Number of values that fit without allocating. Chosen so that the whole list takes no more than three words, which
+   * keeps the cuckoohash_map's buckets small.
+   */
+  static constexpr uint32_t INLINE_CAPACITY = 2;
+
+  /**
+   * Constructs an empty list. The cuckoohash_map requires its values to be default-constructible.
+   */
+  TupleSlotList() : size_(0), capacity_(INLINE_CAPACITY) {}
+
+  /**
+   * Constructs a list holding a single value
+   * @param slot the value
+   */
+  explicit TupleSlotList(const TupleSlot slot) : size_(1), capacity_(INLINE_CAPACITY) { inline_[0] = slot; }
+
+  /**
+   * Copy constructor
+   * @param other list to copy
+   */
+  TupleSlotList(const TupleSlotList &other) : size_(other.size_), capacity_(other.capacity_) {
+    if (IsInline()) {
+      std::memcpy(inline_, other.inline_, sizeof(inline_));
+    } else {
+      heap_ = new TupleSlot[capacity_];
+      std::copy(other.begin(), other.end(), heap_);
+    }
+  }
+
+  /**
+   * Move constructor. The moved-from list is left empty.
+   * @param other list to move
+   */
+  TupleSlotList(TupleSlotList &&other) noexcept : size_(other.size_), capacity_(other.capacity_) {
+    std::memcpy(inline_, other.inline_, sizeof(inline_));
+    other.size_ = 0;
+    other.capacity_ = INLINE_CAPACITY;
+  }
+
+  /**
+   * Copy assignment
+   * @param other list to copy
+   * @return self-reference
+   */
+  TupleSlotList &operator=(const TupleSlotList &other) {
+    if (this != &other) *this = TupleSlotList(other);
+    return *this;
+  }
+
+  /**
+   * Move assignment. The moved-from list is left empty.
+   * @param other list to move
+   * @return self-reference
+   */
+  TupleSlotList &operator=(TupleSlotList &&other) noexcept {
+    if (this != &other) {
+      if (!IsInline()) delete[] heap_;
+      size_ = other.size_;
+      capacity_ = other.capacity_;
+      std::memcpy(inline_, other.inline_, sizeof(inline_));
+      other.size_ = 0;
+      other.capacity_ = INLINE_CAPACITY;
+    }
+    return *this;
+  }
+
+  /**
+   * Frees the spilled values, if any
+   */
+  ~TupleSlotList() {
+    if (!IsInline()) delete[] heap_;
+  }
+
+  /**
+   * @return number of values in the list
+   */
+  uint32_t Size() const { return size_; }
+
+  /**
+   * @return pointer to the first value
+   */
+  const TupleSlot *begin() const { return IsInline() ? inline_ : heap_; }  // NOLINT (STL naming for range-for)
+
+  /**
+   * @return pointer past the last value
+   */
+  const TupleSlot *end() const { return begin() + size_; }  // NOLINT (STL naming for range-for)
+
+  /**
+   * @param slot value to look for
+   * @return true if the list contains the value
+   */
+  bool Contains(const TupleSlot slot) const { return std::find(begin(), end(), slot) != end(); }
+
+  /**
+   * Adds a value to the list, which must not already contain it
+   * @param slot value to add
+   */
+  void Add(const TupleSlot slot) {
+    TERRIER_ASSERT(!Contains(slot), "Values in a TupleSlotList should be unique.");
+    if (size_ == capacity_) Reallocate(capacity_ * 2);
+    Data()[size_++] = slot;
+  }
+
+  /**
+   * Removes a value from the list. The last value takes its place.
+   * @param slot value to remove
+   * @return true if the value was in the list
+   */
+  bool Remove(const TupleSlot slot) {
+    TupleSlot *const data = Data();
+    TupleSlot *const it = std::find(data, data + size_, slot);
+    if (it == data + size_) return false;
+    *it = data[--size_];
+    if (!IsInline() && size_ <= INLINE_CAPACITY) Reallocate(INLINE_CAPACITY);
+    return true;
+  }
+
+ private:
+  bool IsInline() const { return capacity_ == INLINE_CAPACITY; }
+
+  TupleSlot *Data() { return IsInline() ? inline_ : heap_; }
+
+  // Moves the values to storage of the given capacity, which is inline storage if it is INLINE_CAPACITY
+  void Reallocate(const uint32_t capacity) {
+    TERRIER_ASSERT(capacity >= size_, "Values should fit in the new storage.");
+    TupleSlot *const old_data = Data();
+    const bool was_inline = IsInline();
+    if (capacity == INLINE_CAPACITY) {
+      std::copy(old_data, old_data + size_, inline_);
+    } else {
+      auto *const new_data = new TupleSlot[capacity];
+      std::copy(old_data, old_data + size_, new_data);
+      heap_ = new_data;
+    }
+    if (!was_inline) delete[] old_data;
+    capacity_ = capacity;
+  }
+
+  uint32_t size_;
+  uint32_t capacity_;
+  union {
+    TupleSlot inline_[INLINE_CAPACITY];
+    TupleSlot *heap_;
+  };
+};
+
+}  // namespace terrier::storage::index
@@ -51,6 +51,19 @@ class PACKED ProjectedRow {
    */
   static ProjectedRow *CopyProjectedRowLayout(void *head, const ProjectedRow &other);
 
+  /**
+   * Populates the ProjectedRow's members for the given columns, laying them out the same way a ProjectedRowInitializer
+   * would, with every attribute null. The column ids may already be in place in the byte buffer, since they are
+   * written out in the same spot.
+   *
+   * @param head pointer to the byte buffer to initialize as a ProjectedRow
+   * @param layout layout of the table the columns are from
+   * @param col_ids the columns of the new ProjectedRow, in the order they should appear in
+   * @param num_cols the number of columns
+   * @return pointer to the initialized ProjectedRow
+   */
+  static ProjectedRow *InitializeRow(void *head, const BlockLayout &layout, const col_id_t *col_ids, uint16_t num_cols);
+
   /**
    * @return the size of this ProjectedRow in memory, in bytes
    */
@@ -304,6 +304,13 @@ class UndoBuffer {
    */
   byte *NewEntry(uint32_t size);
 
+  /**
+   * Changes the size of the last entry reserved, giving back whatever space it turned out not to need. The entry
+   * cannot grow past the size it was reserved with.
+   * @param size the new size of the last entry
+   */
+  void ResizeLastEntry(uint32_t size);
+
   /**
    * @return a pointer to the beginning of the last record requested, or nullptr if no record exists.
    */
@@ -313,6 +320,7 @@ class UndoBuffer {
   RecordBufferSegmentPool *buffer_pool_;
   std::vector<RecordBufferSegment *> buffers_;
   byte *last_record_ = nullptr;
+  uint32_t last_record_reserved_size_ = 0;
 };
 
 class LogManager;  // forward declaration
@@ -342,7 +350,8 @@ class RedoBuffer {
 
   /**
    * Flush all contents of the redo buffer to be logged out, effectively closing this redo buffer. No further entries
-   * can be written to this redo buffer after the function returns.
+   * can be written to this redo buffer after the function returns. A flushed buffer ends its transaction, so the log
+   * manager serializes it right away.
    * @param flush_buffer whether the transaction holding this RedoBuffer should flush the its redo buffer
    */
   void Finalize(bool flush_buffer);
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <stdexcept>
+#include <string>
+#include "storage/recovery/abstract_log_provider.h"
+#include "storage/write_ahead_log/log_io.h"
+#include "transaction/transaction_defs.h"
+
+namespace terrier::storage {
+
+/**
+ * Header at the start of every checkpoint file, followed by the checkpointed tuples as log records
+ */
+struct CheckpointHeader {
+  /**
+   * Magic number identifying checkpoint files
+   */
+  static constexpr uint64_t MAGIC = 0x544e494f504b4843;  // "CHKPOINT" in little endian
+
+  /**
+   * Must be equal to MAGIC
+   */
+  uint64_t magic_;
+  /**
+   * Start timestamp of the snapshot the checkpoint was taken at. Every transaction that committed before this is
+   * contained in the checkpoint.
+   */
+  transaction::timestamp_t checkpoint_ts_;
+  /**
+   * Offset in the log file recovery should start replaying from after loading the checkpoint
+   */
+  uint64_t log_offset_;
+};
+
+/**
+ * @brief Log provider for checkpoints stored on disk
+ * Provides the contents of a checkpoint to the recovery manager. Checkpoints are stored in the same format as the log,
+ * so that they can be replayed like any other log.
+ */
+class CheckpointLogProvider : public AbstractLogProvider {
+ public:
+  /**
+   * @param checkpoint_path path to the checkpoint file to read
+   */
+  explicit CheckpointLogProvider(const std::string &checkpoint_path) : in_(BufferedLogReader(checkpoint_path.c_str())) {
+    if (!in_.Read(&header_, sizeof(CheckpointHeader)) || header_.magic_ != CheckpointHeader::MAGIC)
+      throw std::runtime_error("Not a valid checkpoint file: " + checkpoint_path);
+  }
+
+  /**
+   * @return start timestamp of the snapshot the checkpoint was taken at
+   */
+  transaction::timestamp_t CheckpointTimestamp() const { return header_.checkpoint_ts_; }
+
+  /**
+   * @return offset in the log file to replay from after loading the checkpoint
+   */
+  uint64_t LogOffset() const { return header_.log_offset_; }
+
+ private:
+  // Buffered checkpoint file reader
+  storage::BufferedLogReader in_;
+  // Header read from the start of the checkpoint file
+  CheckpointHeader header_;
+
+  /**
+   * @return true if checkpoint file contains more records, false otherwise
+   */
+  bool HasMoreRecords() override { return in_.HasMore(); }
+
+  /**
+   * Read data from the checkpoint file into the destination provided
+   * @param dest pointer to location to read into
+   * @param size number of bytes to read
+   * @return true if we read the given number of bytes
+   */
+  bool Read(void *dest, uint32_t size) override { return in_.Read(dest, size); }
+};
+
+}  // namespace terrier::storage
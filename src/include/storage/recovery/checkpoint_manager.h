@@ -0,0 +1,132 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "catalog/catalog.h"
+#include "catalog/catalog_defs.h"
+#include "catalog/schema.h"
+#include "common/managed_pointer.h"
+#include "storage/recovery/checkpoint_log_provider.h"
+#include "storage/sql_table.h"
+#include "storage/write_ahead_log/log_io.h"
+#include "storage/write_ahead_log/log_manager.h"
+#include "transaction/transaction_manager.h"
+
+namespace terrier::storage {
+
+/**
+ * Checkpoint Manager
+ * Takes consistent checkpoints of every table in the system, catalog tables included, without blocking concurrent
+ * transactions. A checkpoint is the snapshot seen by a read-only transaction, written out as a sequence of committed
+ * transactions that insert every visible tuple. Checkpoints use the same format as the log, so that recovery can load
+ * them the same way it replays the log, and only needs to replay the log from the offset recorded in the checkpoint.
+ * Once a checkpoint is durable, older checkpoints are deleted and the log before that offset is truncated.
+ */
+class CheckpointManager {
+ public:
+  /**
+   * Prefix of the names of checkpoint files. The full name is the prefix followed by the checkpoint timestamp.
+   */
+  static constexpr const char *CHECKPOINT_FILE_PREFIX = "checkpoint_";
+
+  /**
+   * @param checkpoint_dir directory to write checkpoints to, must already exist
+   * @param txn_manager txn manager to take the snapshot with
+   * @param catalog catalog to find the tables to checkpoint in
+   * @param log_manager log manager to truncate the log of once a checkpoint is taken. If nullptr, logging is disabled
+   * and recovery will only load the checkpoint.
+   */
+  CheckpointManager(std::string checkpoint_dir, transaction::TransactionManager *txn_manager,
+                    common::ManagedPointer<catalog::Catalog> catalog, LogManager *log_manager)
+      : checkpoint_dir_(std::move(checkpoint_dir)),
+        txn_manager_(txn_manager),
+        catalog_(catalog),
+        log_manager_(log_manager) {}
+
+  /**
+   * Takes a checkpoint, and blocks until it is durable. Transactions can keep running while the checkpoint is taken.
+   * Must not be called concurrently with itself.
+   * @return path to the checkpoint file written
+   */
+  std::string Checkpoint();
+
+  /**
+   * @param checkpoint_dir directory to look for checkpoints in
+   * @return path to the most recent checkpoint in the directory, or an empty string if there are none
+   */
+  static std::string GetLatestCheckpoint(const std::string &checkpoint_dir);
+
+ private:
+  // Number of tuples of a table written out per checkpoint transaction, to bound the memory recovery needs to buffer
+  // a transaction
+  static constexpr uint32_t TUPLES_PER_TXN = 1 << 12;
+
+  const std::string checkpoint_dir_;
+  transaction::TransactionManager *const txn_manager_;
+  const common::ManagedPointer<catalog::Catalog> catalog_;
+  LogManager *const log_manager_;
+
+  // Writer for the checkpoint currently being taken
+  std::unique_ptr<BufferedLogWriter> out_;
+  // Id of the transaction records are currently written out under. Only used to group records, never compared against
+  // timestamps of the live system.
+  transaction::timestamp_t txn_id_;
+  // Number of records written out under the current transaction
+  uint32_t txn_size_;
+
+  /**
+   * @param checkpoint_ts timestamp of the checkpoint
+   * @return path to the checkpoint file for the given timestamp
+   */
+  std::string CheckpointPath(transaction::timestamp_t checkpoint_ts) const;
+
+  /**
+   * Writes bytes out to the checkpoint file currently being written
+   * @param data bytes to write
+   * @param size number of bytes to write
+   */
+  void Write(const void *data, uint32_t size);
+
+  /**
+   * Serializes a record out to the checkpoint file, as part of the current checkpoint transaction
+   * @param record record to write
+   */
+  void WriteRecord(const LogRecord &record);
+
+  /**
+   * Writes out a commit record for the current checkpoint transaction, if it has any records, and starts a new one
+   */
+  void CommitCheckpointTxn();
+
+  /**
+   * Writes out every tuple of the table that is visible to the given transaction as an insert
+   * @param txn checkpoint transaction
+   * @param db_oid database of the table
+   * @param table_oid oid of the table
+   * @param table table to write out
+   * @param col_oids columns of the table
+   * @param is_pg_class true if the table is pg_class, in which case the schema and object pointers are written out as
+   * null, as recovery recreates the objects they point to
+   * @param class_slots if is_pg_class, filled with the slots of the written tuples that have their object pointer set
+   */
+  void WriteTable(transaction::TransactionContext *txn, catalog::db_oid_t db_oid, catalog::table_oid_t table_oid,
+                  SqlTable *table, const std::vector<catalog::col_oid_t> &col_oids, bool is_pg_class,
+                  std::vector<TupleSlot> *class_slots);
+
+  /**
+   * Writes out the catalog tables of a database, followed by all of its user tables
+   * @param txn checkpoint transaction
+   * @param db_oid database to write out
+   */
+  void WriteDatabase(transaction::TransactionContext *txn, catalog::db_oid_t db_oid);
+
+  /**
+   * Deletes all checkpoints older than the given one
+   * @param checkpoint_ts timestamp of the latest checkpoint
+   */
+  void RemoveOldCheckpoints(transaction::timestamp_t checkpoint_ts) const;
+};
+}  // namespace terrier::storage
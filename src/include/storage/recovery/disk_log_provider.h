@@ -1,31 +1,41 @@
 #pragma once
 
+#include <memory>
 #include <string>
 #include "storage/recovery/abstract_log_provider.h"
 #include "storage/write_ahead_log/log_io.h"
+#include "storage/write_ahead_log/log_segment.h"
 
 namespace terrier::storage {
 
 /**
  * @brief Log provider for logs stored on disk
- * Provides logs to the recovery manager from logs persisted on disk. The log file is read in using the
- * BufferedLogReader.
+ * Provides logs to the recovery manager from logs persisted on disk. A log written out as segments is read in using the
+ * LogSegmentReader, and a single log file using the BufferedLogReader.
  */
 class DiskLogProvider : public AbstractLogProvider {
  public:
   /**
    * @param log_file_path path to log file to read logs from
+   * @param offset offset in the log file to start reading from, e.g. the log offset of the checkpoint recovered from
    */
-  explicit DiskLogProvider(const std::string &log_file_path) : in_(BufferedLogReader(log_file_path.c_str())) {}
+  explicit DiskLogProvider(const std::string &log_file_path, const uint64_t offset = 0) {
+    if (LogSegmentWriter::ListSegments(log_file_path).empty())
+      in_ = std::make_unique<BufferedLogReader>(log_file_path.c_str(), offset);
+    else
+      segments_in_ = std::make_unique<LogSegmentReader>(log_file_path, offset);
+  }
 
  private:
-  // Buffered log file reader
-  storage::BufferedLogReader in_;
+  // Buffered log file reader, if the log is a single file
+  std::unique_ptr<BufferedLogReader> in_;
+  // Segment reader, if the log is segmented
+  std::unique_ptr<LogSegmentReader> segments_in_;
 
   /**
    * @return true if log file contains more records, false otherwise
    */
-  bool HasMoreRecords() override { return in_.HasMore(); }
+  bool HasMoreRecords() override { return in_ != nullptr ? in_->HasMore() : segments_in_->HasMore(); }
 
   /**
    * Read data from the log file into the destination provided
@@ -33,7 +43,9 @@ class DiskLogProvider : public AbstractLogProvider {
    * @param size number of bytes to read
    * @return true if we read the given number of bytes
    */
-  bool Read(void *dest, uint32_t size) override { return in_.Read(dest, size); }
+  bool Read(void *dest, uint32_t size) override {
+    return in_ != nullptr ? in_->Read(dest, size) : segments_in_->Read(dest, size);
+  }
 };
 
 }  // namespace terrier::storage
@@ -3,6 +3,7 @@
 #include <set>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -15,7 +16,10 @@
 #include "catalog/postgres/pg_index.h"
 #include "catalog/postgres/pg_namespace.h"
 #include "common/dedicated_thread_owner.h"
+#include "common/spin_latch.h"
+#include "common/worker_pool.h"
 #include "storage/recovery/abstract_log_provider.h"
+#include "storage/recovery/checkpoint_log_provider.h"
 #include "storage/sql_table.h"
 #include "transaction/transaction_manager.h"
 
@@ -63,18 +67,21 @@ class RecoveryManager : public common::DedicatedThreadOwner {
    * @param deferred_action_manager manager to use for deferred deletes
    * @param thread_registry thread registry to register tasks
    * @param store block store used for SQLTable creation during recovery
+   * @param worker_pool pool to replay non-conflicting transactions on concurrently. If nullptr, transactions are
+   * replayed one at a time on the recovery thread. The pool may be shared with other work.
    */
   explicit RecoveryManager(AbstractLogProvider *log_provider, common::ManagedPointer<catalog::Catalog> catalog,
                            transaction::TransactionManager *txn_manager,
                            transaction::DeferredActionManager *deferred_action_manager,
                            common::ManagedPointer<terrier::common::DedicatedThreadRegistry> thread_registry,
-                           BlockStore *store)
+                           BlockStore *store, common::WorkerPool *worker_pool = nullptr)
       : DedicatedThreadOwner(thread_registry),
         log_provider_(log_provider),
         catalog_(catalog),
         txn_manager_(txn_manager),
         deferred_action_manager_(deferred_action_manager),
         block_store_(store),
+        worker_pool_(worker_pool),
         recovered_txns_(0) {
     // Initialize catalog_table_schemas_ map
     catalog_table_schemas_[catalog::postgres::CLASS_TABLE_OID] = catalog::postgres::Builder::GetClassTableSchema();
@@ -96,6 +103,17 @@ class RecoveryManager : public common::DedicatedThreadOwner {
         thread_registry_->RegisterDedicatedThread<RecoveryTask>(this /* dedicated thread owner */, this /* task arg */);
   }
 
+  /**
+   * Makes recovery load the given checkpoint before replaying the log. The log provider given at construction must
+   * start at the log offset of the checkpoint, and transactions in it that committed before the checkpoint was taken
+   * are skipped. Must be called before recovery is started.
+   * @param checkpoint provider for the checkpoint to load
+   */
+  void SetCheckpoint(CheckpointLogProvider *checkpoint) {
+    TERRIER_ASSERT(recovery_task_ == nullptr, "Recovery already started");
+    checkpoint_ = checkpoint;
+  }
+
   /**
    * Blocks until recovery finishes, if it has not already, and stops background thread.
    */
@@ -107,6 +125,22 @@ class RecoveryManager : public common::DedicatedThreadOwner {
   }
 
  private:
+  /**
+   * A set of committed transactions that can be replayed concurrently. No two transactions in a batch touch the same
+   * tuple, and no transaction in a batch deletes from a table that another one writes to. The latter keeps a delete
+   * and a later insert of the same key from racing on a unique index.
+   */
+  struct ReplayBatch {
+    std::vector<transaction::timestamp_t> txns_;
+    std::unordered_set<TupleSlot> slots_;
+    std::unordered_set<uint64_t> written_tables_;
+    std::unordered_set<uint64_t> deleted_tables_;
+  };
+
+  // Number of deferred transactions to accumulate before replaying them when running with a worker pool, so that there
+  // is enough non-conflicting work to spread across workers
+  static constexpr uint32_t PARALLEL_REPLAY_THRESHOLD = 512;
+
   FRIEND_TEST(RecoveryTests, DoubleRecoveryTest);
   friend class RecoveryTests;
   friend class terrier::RecoveryBenchmark;
@@ -114,6 +148,11 @@ class RecoveryManager : public common::DedicatedThreadOwner {
   // Log provider for reading in logs
   AbstractLogProvider *log_provider_;
 
+  // Checkpoint to load before replaying the log, or nullptr if recovering from the log alone
+  CheckpointLogProvider *checkpoint_ = nullptr;
+  // True once the checkpoint has been loaded, after which transactions committed before it are skipped
+  bool checkpoint_loaded_ = false;
+
   // Catalog to fetch table pointers
   common::ManagedPointer<catalog::Catalog> catalog_;
 
@@ -128,10 +167,16 @@ class RecoveryManager : public common::DedicatedThreadOwner {
   // tables during recovery
   BlockStore *block_store_;
 
+  // Worker pool to replay transactions on, or nullptr if replay is serial
+  common::WorkerPool *worker_pool_;
+
   // Used during recovery from log. Maps old tuple slot to new tuple slot
   // TODO(Gus): This map may get huge, benchmark whether this becomes a problem and if we need a more sophisticated data
   // structure
   std::unordered_map<TupleSlot, TupleSlot> tuple_slot_map_;
+  // Protects tuple_slot_map_ when replaying in parallel. Catalog transactions are always replayed alone, so the special
+  // case catalog handling does not need to take it when writing to the map.
+  mutable common::SpinLatch tuple_slot_map_latch_;
 
   // Used during recovery from log. Stores deferred transactions in sorted sorted order to be able to execute them in
   // serial order. Transactions are defered when there is an older active transaction at the time it committed. Even
@@ -158,13 +203,29 @@ class RecoveryManager : public common::DedicatedThreadOwner {
    * Recovers the databases using the provided log provider
    * @return number of committed transactions replayed
    */
-  void Recover() { RecoverFromLogs(); }
+  void Recover() {
+    if (checkpoint_ != nullptr) RecoverFromCheckpoint();
+    RecoverFromLogs();
+  }
+
+  /**
+   * Recovers the databases from the checkpoint
+   */
+  void RecoverFromCheckpoint() {
+    Replay(checkpoint_);
+    checkpoint_loaded_ = true;
+  }
 
   /**
    * Recovers the databases from the logs.
-   * @note this is a separate method so in the future, we can also have a RecoverFromCheckpoint method
    */
-  void RecoverFromLogs();
+  void RecoverFromLogs() { Replay(log_provider_); }
+
+  /**
+   * Replays all committed transactions from the given provider, until it no longer provides logs
+   * @param provider provider to read logs from
+   */
+  void Replay(AbstractLogProvider *provider);
 
   /**
    * @brief Replay a committed transaction corresponding to txn_id.
@@ -172,6 +233,37 @@ class RecoveryManager : public common::DedicatedThreadOwner {
    */
   void ProcessCommittedTransaction(transaction::timestamp_t txn_id);
 
+  /**
+   * Replays a list of buffered changes in a new transaction, and commits it. Safe to call concurrently for
+   * transactions that do not conflict.
+   * @param buffered_changes changes of the committed transaction to replay
+   */
+  void ReplayTransaction(std::vector<std::pair<LogRecord *, std::vector<byte *>>> *buffered_changes);
+
+  /**
+   * Replays the given committed transactions, in order, on the worker pool. Consecutive transactions that do not
+   * conflict are replayed concurrently, and transactions that modify the catalog are replayed alone.
+   * @param begin first transaction to replay
+   * @param end one past the last transaction to replay
+   */
+  void ProcessTransactionsInParallel(std::set<transaction::timestamp_t>::const_iterator begin,
+                                     std::set<transaction::timestamp_t>::const_iterator end);
+
+  /**
+   * Adds a transaction to a batch, unless it conflicts with a transaction already in it
+   * @param txn_id start timestamp of the transaction to add
+   * @param batch batch to add to
+   * @return true if the transaction was added, false on conflict
+   */
+  bool TryAddToBatch(transaction::timestamp_t txn_id, ReplayBatch *batch);
+
+  /**
+   * Replays every transaction in the batch concurrently on the worker pool and waits for them to commit. The batch is
+   * cleared afterwards.
+   * @param batch batch to replay
+   */
+  void ReplayBatchInParallel(ReplayBatch *batch);
+
   /**
    * Defers log records deletes with the transaction manager
    * @param txn_id txn_id for txn who's records to delete
@@ -193,6 +285,7 @@ class RecoveryManager : public common::DedicatedThreadOwner {
    * @return new tuple slot
    */
   TupleSlot GetTupleSlotMapping(TupleSlot slot) {
+    common::SpinLatch::ScopedSpinLatch guard(&tuple_slot_map_latch_);
     TERRIER_ASSERT(tuple_slot_map_.find(slot) != tuple_slot_map_.end(), "No tuple slot mapping exists");
     return tuple_slot_map_[slot];
   }
@@ -277,6 +370,7 @@ class RecoveryManager : public common::DedicatedThreadOwner {
    * @return true if record is an insert redo, false if it is an update redo
    */
   bool IsInsertRecord(const RedoRecord *record) const {
+    common::SpinLatch::ScopedSpinLatch guard(&tuple_slot_map_latch_);
     return tuple_slot_map_.find(record->GetTupleSlot()) == tuple_slot_map_.end();
   }
 
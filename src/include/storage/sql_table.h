@@ -1,4 +1,5 @@
 #pragma once
+#include <functional>
 #include <list>
 #include <set>
 #include <utility>
@@ -148,6 +149,21 @@ class SqlTable {
     return table_.data_table_->Scan(txn, start_pos, out_buffer);
   }
 
+  /**
+   * Sequentially scans the table from the given iterator(inclusive) up to the given end iterator(exclusive). See the
+   * other Scan for the semantics of the output buffer.
+   *
+   * @param txn the calling transaction
+   * @param start_pos iterator to the starting location for the sequential scan
+   * @param end_pos iterator to one slot past the last slot to scan
+   * @param out_buffer output buffer. The object should already contain projection list information. This buffer is
+   *                   always cleared of old values.
+   */
+  void Scan(transaction::TransactionContext *const txn, DataTable::SlotIterator *const start_pos,
+            const DataTable::SlotIterator &end_pos, ProjectedColumns *const out_buffer) const {
+    return table_.data_table_->Scan(txn, start_pos, end_pos, out_buffer);
+  }
+
   /**
    * @return the first tuple slot contained in the underlying DataTable
    */
@@ -158,6 +174,40 @@ class SqlTable {
    */
   DataTable::SlotIterator end() const { return table_.data_table_->end(); }  // NOLINT for STL name compability
 
+  /**
+   * @param block_index index of the block in the underlying DataTable
+   * @return the first tuple slot of the block at the given index, or end() if there is no such block
+   */
+  DataTable::SlotIterator beginAt(uint32_t block_index) const {  // NOLINT for STL name compability
+    return table_.data_table_->beginAt(block_index);
+  }
+
+  /**
+   * @param block_index index of the block one past the end of the range
+   * @return one past the last tuple slot of the blocks in the range [0, block_index)
+   */
+  DataTable::SlotIterator endAt(uint32_t block_index) const {  // NOLINT for STL name compability
+    return table_.data_table_->endAt(block_index);
+  }
+
+  /**
+   * @return the number of blocks in the underlying DataTable
+   */
+  uint32_t GetNumBlocks() const { return table_.data_table_->GetNumBlocks(); }
+
+  /**
+   * Hands out every frozen block in the table as a zero-copy Arrow view of the given columns. The view is only valid
+   * for the duration of the visitor call. @see DataTable::ExportFrozenBlocks
+   * @param col_oids the columns to expose in the view, in order
+   * @param visitor function to call on the view of every frozen block
+   * @return number of blocks that were skipped because they were not frozen
+   * @warning col_oids must be a set (no repeats)
+   */
+  uint32_t ExportFrozenBlocks(const std::vector<catalog::col_oid_t> &col_oids,
+                              const std::function<void(const ArrowBlockView &)> &visitor) const {
+    return table_.data_table_->ExportFrozenBlocks(ColIdsForOids(col_oids), visitor);
+  }
+
   /**
    * Generates an ProjectedColumnsInitializer for the execution layer to use. This performs the translation from col_oid
    * to col_id for the Initializer's constructor so that the execution layer doesn't need to know anything about col_id.
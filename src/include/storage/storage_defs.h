@@ -75,12 +75,24 @@ class alignas(common::Constants::BLOCK_SIZE) RawBlock {
    * and the transformation thread. In practice this can be used almost like a lock.
    */
   BlockAccessController controller_;
+  /**
+   * Version synopsis of this block: the number of slots in the block that currently have a non-null version pointer.
+   * While this is 0, every tuple in the block is visible to every running transaction as is, and scans can skip MVCC
+   * checks on the block altogether.
+   */
+  std::atomic<uint32_t> num_versioned_slots_;
+  /**
+   * Bumped whenever a slot in this block goes from having no version pointer to having one, which always happens
+   * before the tuple in it is modified in place. Scans that skip MVCC checks use this to detect concurrent changes
+   * to the block.
+   */
+  std::atomic<uint32_t> version_epoch_;
 
   /**
    * Contents of the raw block.
    */
   byte content_[common::Constants::BLOCK_SIZE - sizeof(uintptr_t) - sizeof(uint16_t) - sizeof(layout_version_t) -
-                sizeof(uint32_t) - sizeof(BlockAccessController)];
+                sizeof(uint32_t) - sizeof(BlockAccessController) - 2 * sizeof(uint32_t)];
   // A Block needs to always be aligned to 1 MB, so we can get free bytes to
   // store offsets within a block in one 8-byte word
 
@@ -13,6 +13,7 @@ class Schema;
 }
 
 namespace terrier::storage {
+class ProjectedColumns;
 class ProjectedRow;
 class TupleAccessStrategy;
 class UndoRecord;
@@ -56,6 +57,22 @@ class StorageUtil {
   static void CopyAttrIntoProjection(const TupleAccessStrategy &accessor, TupleSlot from, RowType *to,
                                      uint16_t projection_list_offset);
 
+  /**
+   * Bulk copy a contiguous range of values of a column in a block, along with their null bits, into a column of a
+   * ProjectedColumns. This does no visibility checks, so it is only safe to use when the caller knows the range to be
+   * visible and free of concurrent writers (e.g. the block is frozen and the caller holds an in-place read lock).
+   * @param accessor TupleAccessStrategy used to interact with the given block.
+   * @param block block to copy from
+   * @param from_offset offset of the first slot to copy in the block
+   * @param to ProjectedColumns to copy into
+   * @param projection_list_index the projection_list index to copy to on the ProjectedColumns
+   * @param to_offset index of the first tuple to copy into in the ProjectedColumns
+   * @param num_tuples number of tuples to copy
+   */
+  static void CopyColumnIntoProjection(const TupleAccessStrategy &accessor, RawBlock *block, uint32_t from_offset,
+                                       ProjectedColumns *to, uint16_t projection_list_index, uint32_t to_offset,
+                                       uint32_t num_tuples);
+
   /**
    * Copy an attribute from a ProjectedRow into a block.
    * @param accessor TupleAccessStrategy used to interact with the given block.
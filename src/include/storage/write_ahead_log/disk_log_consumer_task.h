@@ -2,10 +2,12 @@
 
 #include <utility>
 #include <vector>
+#include "common/constants.h"
 #include "common/container/concurrent_blocking_queue.h"
 #include "common/dedicated_thread_registry.h"
 #include "storage/storage_defs.h"
 #include "storage/write_ahead_log/log_io.h"
+#include "storage/write_ahead_log/log_segment.h"
 
 namespace terrier::storage {
 
@@ -16,24 +18,31 @@ namespace terrier::storage {
 class DiskLogConsumerTask : public common::DedicatedThreadTask {
  public:
   /**
-   * Constructs a new DiskLogConsumerTask
+   * Constructs a new DiskLogConsumerTask. The log file is persisted as soon as commit records arrive, so that commit
+   * callbacks fire as soon as possible. All commits that arrive while a persist is in progress are persisted together
+   * by the next one. The interval and threshold only bound how long data without commit records stays unpersisted.
    * @param persist_interval Interval time for when to persist log file
    * @param persist_threshold threshold of data written since the last persist to trigger another persist
    * @param buffers pointer to list of all buffers used by log manager, used to persist log file
    * @param empty_buffer_queue pointer to queue to push empty buffers to
    * @param filled_buffer_queue pointer to queue to pop filled buffers from
+   * @param segment_writer writer of the segmented log to write buffers to, or nullptr if the buffers write to the log
+   * file themselves
    */
   explicit DiskLogConsumerTask(const std::chrono::milliseconds persist_interval, uint64_t persist_threshold,
                                std::vector<BufferedLogWriter> *buffers,
                                common::ConcurrentBlockingQueue<BufferedLogWriter *> *empty_buffer_queue,
-                               common::ConcurrentQueue<storage::SerializedLogs> *filled_buffer_queue)
+                               common::ConcurrentQueue<storage::SerializedLogs> *filled_buffer_queue,
+                               LogSegmentWriter *segment_writer = nullptr)
       : run_task_(false),
         persist_interval_(persist_interval),
         persist_threshold_(persist_threshold),
         current_data_written_(0),
+        preallocated_bytes_(0),
         buffers_(buffers),
         empty_buffer_queue_(empty_buffer_queue),
-        filled_buffer_queue_(filled_buffer_queue) {}
+        filled_buffer_queue_(filled_buffer_queue),
+        segment_writer_(segment_writer) {}
 
   /**
    * Runs main disk log writer loop. Called by thread registry upon initialization of thread
@@ -47,6 +56,9 @@ class DiskLogConsumerTask : public common::DedicatedThreadTask {
 
  private:
   friend class LogManager;
+  // Disk space to reserve for the log file at a time, so that persisting appends rarely has to allocate blocks
+  static constexpr uint64_t LOG_PREALLOCATION_SIZE = 16 * common::Constants::MB;
+
   // Flag to signal task to run or stop
   bool run_task_;
   // Stores callbacks for commit records written to disk but not yet persisted
@@ -58,6 +70,8 @@ class DiskLogConsumerTask : public common::DedicatedThreadTask {
   uint64_t persist_threshold_;
   // Amount of data written since last persist
   uint64_t current_data_written_;
+  // Amount of data that can still be written before the space reserved for the log file runs out
+  uint64_t preallocated_bytes_;
 
   // This stores a reference to all the buffers the log manager has created. Used for persisting
   std::vector<BufferedLogWriter> *buffers_;
@@ -65,6 +79,8 @@ class DiskLogConsumerTask : public common::DedicatedThreadTask {
   common::ConcurrentBlockingQueue<BufferedLogWriter *> *empty_buffer_queue_;
   // The queue containing filled buffers. Task should dequeue filled buffers from this queue to flush
   common::ConcurrentQueue<SerializedLogs> *filled_buffer_queue_;
+  // Writer of the segmented log, or nullptr if the log is a single file written to by the buffers
+  LogSegmentWriter *segment_writer_;
 
   // Flag used by the serializer thread to signal the disk log consumer task thread to persist the data on disk
   volatile bool do_persist_;
@@ -84,8 +100,9 @@ class DiskLogConsumerTask : public common::DedicatedThreadTask {
 
   /**
    * Flush all buffers in the filled buffers queue to the log file
+   * @return true if any of the buffers contained commit records, which then need to be persisted
    */
-  void WriteBuffersToLogFile();
+  bool WriteBuffersToLogFile();
 
   /*
    * Persists the log file on disk by calling fsync, as well as calling callbacks for all committed transactions that
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include "common/macros.h"
+#include "common/strong_typedef.h"
+
+namespace terrier::storage {
+
+/**
+ * Compression and checksumming of serialized log buffers. Compression uses the LZ4 block format, which is fast enough
+ * to keep up with the log writer and works well on log records, which repeat a lot of their header bytes. Checksums are
+ * CRC-32C, computed with the SSE4.2 crc32 instruction.
+ */
+class LogCodec {
+ public:
+  LogCodec() = delete;
+
+  /**
+   * @param size number of bytes to compress
+   * @return maximum size the given number of bytes can compress to, if the data is not compressible
+   */
+  static constexpr uint32_t CompressBound(const uint32_t size) { return size + size / 255 + 16; }
+
+  /**
+   * Compresses the given bytes
+   * @param src bytes to compress
+   * @param size number of bytes to compress
+   * @param dst location to write compressed bytes to
+   * @param capacity number of bytes available at dst
+   * @return size of the compressed bytes, or 0 if they do not fit in capacity
+   */
+  static uint32_t Compress(const byte *src, uint32_t size, byte *dst, uint32_t capacity);
+
+  /**
+   * Decompresses bytes compressed by Compress
+   * @param src compressed bytes
+   * @param size number of compressed bytes
+   * @param dst location to write decompressed bytes to
+   * @param raw_size size of the bytes before compression
+   * @return true on success, false if the compressed bytes are malformed or do not decompress to exactly raw_size
+   */
+  static bool Decompress(const byte *src, uint32_t size, byte *dst, uint32_t raw_size);
+
+  /**
+   * @param data bytes to checksum
+   * @param size number of bytes to checksum
+   * @return CRC-32C of the bytes
+   */
+  static uint32_t Checksum(const void *data, uint64_t size);
+};
+}  // namespace terrier::storage
@@ -10,6 +10,7 @@
 #include "common/constants.h"
 #include "common/macros.h"
 #include "loggers/storage_logger.h"
+#include "storage/write_ahead_log/log_segment.h"
 
 namespace terrier::storage {
 
@@ -76,8 +77,14 @@ struct PosixIoWrappers {
  * Handles buffered writes to the write ahead log, and provides control over flushing.
  */
 class BufferedLogWriter {
-  // TODO(Tianyu): Checksum
+  // Checksums are only written for segmented logs, see LogSegmentWriter
  public:
+  /**
+   * Instantiates a new BufferedLogWriter that is not tied to a log file. Its buffer can only be flushed to a
+   * LogSegmentWriter, and it cannot be persisted.
+   */
+  BufferedLogWriter() : out_(-1) {}
+
   /**
    * Instantiates a new BufferedLogWriter to write to the specified log file.
    *
@@ -90,7 +97,9 @@ class BufferedLogWriter {
   /**
    * Must call before object is destructed
    */
-  void Close() { PosixIoWrappers::Close(out_); }
+  void Close() {
+    if (out_ != -1) PosixIoWrappers::Close(out_);
+  }
 
   /**
    * Write to the log file the given amount of bytes from the given location in memory, but buffer the write so the
@@ -114,10 +123,30 @@ class BufferedLogWriter {
   }
 
   /**
-   * Call fsync to make sure that all writes are consistent.
+   * Call fdatasync to make sure that all writes are consistent. Unlike fsync, this skips flushing file metadata that is
+   * not needed to read the data back, such as the modification time.
    */
   void Persist() {
+#ifdef __APPLE__
     if (fsync(out_) == -1) throw std::runtime_error("fsync failed with errno " + std::to_string(errno));
+#else
+    if (fdatasync(out_) == -1) throw std::runtime_error("fdatasync failed with errno " + std::to_string(errno));
+#endif
+  }
+
+  /**
+   * Reserves disk space for the given number of bytes past the current end of the file, without changing the file
+   * size. Appends into reserved space do not have to allocate blocks, which makes persisting them cheaper. This is only
+   * a hint, and does nothing if the file system does not support it.
+   * @param size number of bytes to reserve
+   */
+  void Preallocate(uint64_t size) {
+#ifndef __APPLE__
+    const off_t end = lseek(out_, 0, SEEK_END);
+    if (end == -1) throw std::runtime_error("lseek failed with errno " + std::to_string(errno));
+    if (fallocate(out_, FALLOC_FL_KEEP_SIZE, end, static_cast<off_t>(size)) == -1 && errno != EOPNOTSUPP)
+      throw std::runtime_error("fallocate failed with errno " + std::to_string(errno));
+#endif
   }
 
   /**
@@ -131,6 +160,18 @@ class BufferedLogWriter {
     return size;
   }
 
+  /**
+   * Flush any buffered writes to the given segmented log instead of this writer's log file
+   * @param segment_writer writer of the segmented log
+   * @return amount of data flushed
+   */
+  uint64_t FlushBuffer(LogSegmentWriter *const segment_writer) {
+    auto size = buffer_size_;
+    if (size > 0) segment_writer->Append(reinterpret_cast<const byte *>(buffer_), size);
+    buffer_size_ = 0;
+    return size;
+  }
+
   /**
    * @return if the buffer is full
    */
@@ -156,8 +197,15 @@ class BufferedLogReader {
   /**
    * Instantiates a new BufferedLogReader to read from the specified log file.
    * @param log_file_path path to the the log file to read from.
+   * @param offset offset in the file to start reading from
    */
-  explicit BufferedLogReader(const char *log_file_path) : in_(PosixIoWrappers::Open(log_file_path, O_RDONLY)) {}
+  explicit BufferedLogReader(const char *log_file_path, const uint64_t offset = 0)
+      : in_(PosixIoWrappers::Open(log_file_path, O_RDONLY)) {
+    if (offset > 0 && lseek(in_, static_cast<off_t>(offset), SEEK_SET) == -1) {
+      PosixIoWrappers::Close(in_);
+      throw std::runtime_error("Failed to seek in log file with errno " + std::to_string(errno));
+    }
+  }
 
   /**
    * Closes log file if it has not been closed already. While Read will close the file if it reaches the end, this will
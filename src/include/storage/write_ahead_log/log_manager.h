@@ -17,6 +17,7 @@
 #include "storage/write_ahead_log/disk_log_consumer_task.h"
 #include "storage/write_ahead_log/log_io.h"
 #include "storage/write_ahead_log/log_record.h"
+#include "storage/write_ahead_log/log_segment.h"
 #include "storage/write_ahead_log/log_serializer_task.h"
 #include "transaction/transaction_defs.h"
 
@@ -27,7 +28,8 @@ namespace terrier::storage {
  * are persistent. The standard flow of a log record from a transaction all the way to disk is as follows:
  *      1. The LogManager receives buffers containing records from transactions via the AddBufferToFlushQueue, and
  * adds them to the serializer task's flush queue (flush_queue_)
- *      2. The LogSerializerTask will periodically process and serialize buffers in its flush queue
+ *      2. The LogSerializerTask will periodically, or as soon as a transaction hands over its commit or abort record,
+ * process and serialize buffers in its flush queue
  * and hand them over to the consumer queue (filled_buffer_queue_). The reason this is done in the background and not as
  * soon as logs are received is to reduce the amount of time a transaction spends interacting with the log manager
  *      3. When a buffer of logs is handed over to a consumer, the consumer will wake up and process the logs. In the
@@ -36,6 +38,7 @@ namespace terrier::storage {
  *          a) Someone calls ForceFlush on the LogManager, or
  *          b) Periodically
  *          c) A sufficient amount of data has been written since the last persist
+ *          d) Commit records have been written, whose transactions wait on the persist
  *      5. When the persist is done, the `DiskLogConsumerTask` will call the commit callbacks for any CommitRecords that
  * were just persisted.
  */
@@ -106,8 +109,42 @@ class LogManager : public common::DedicatedThreadOwner {
    * write to the buffer. This method can be called safely from concurrent execution threads.
    *
    * @param buffer_segment the (perhaps partially) filled log buffer ready to be consumed
+   * @param ends_txn whether the buffer holds the commit or abort record of its transaction, in which case it is
+   * serialized right away instead of at the next serialization interval
    */
-  void AddBufferToFlushQueue(RecordBufferSegment *buffer_segment);
+  void AddBufferToFlushQueue(RecordBufferSegment *buffer_segment, bool ends_txn = false);
+
+  /**
+   * Returns the offset in the log file a checkpoint taken from now on can start replaying the log from. All records of
+   * transactions that are still running, or have yet to be serialized, are at or after this offset. Records before it
+   * only belong to transactions whose effects will be visible to any transaction that begins after this call.
+   * @return offset in the log file
+   */
+  uint64_t GetCheckpointLogOffset() {
+    TERRIER_ASSERT(run_log_manager_, "Log manager must be running to get a log offset");
+    return log_serializer_task_->OldestUnfinishedTxnOffset();
+  }
+
+  /**
+   * Releases the disk space of the log file before the given offset, once a checkpoint has made the records there
+   * unnecessary. Offsets of later records do not change, the front of the file simply reads back as zeros.
+   * @param offset offset in the log file to truncate up to, usually the log offset of the latest checkpoint
+   */
+  void TruncateLog(uint64_t offset);
+
+  /**
+   * Configures the log to be written as a sequence of checksummed segment files instead of a single file. Segments are
+   * named after the log file path with their sequence number appended. Once the log manager has started, a checkpoint
+   * truncates the log by deleting segments instead of punching holes into the log file. With both options turned off,
+   * which is the default, the log is written out as a single plain file.
+   * @param segment_size size in bytes at which to start a new segment, or 0 to not rotate segments
+   * @param compress whether to compress buffers before writing them out
+   */
+  void SetSegmentOptions(const uint64_t segment_size, const bool compress) {
+    TERRIER_ASSERT(!run_log_manager_, "Segment options must be set before the log manager starts");
+    segment_size_ = segment_size;
+    compress_log_ = compress;
+  }
 
   /**
    * For testing only
@@ -126,7 +163,7 @@ class LogManager : public common::DedicatedThreadOwner {
     if (new_num_buffers >= num_buffers_) {
       // Add in new buffers
       for (size_t i = 0; i < new_num_buffers - num_buffers_; i++) {
-        buffers_.emplace_back(BufferedLogWriter(log_file_path_.c_str()));
+        AddBuffer();
         empty_buffer_queue_.Enqueue(&buffers_[num_buffers_ + i]);
       }
       num_buffers_ = new_num_buffers;
@@ -145,6 +182,13 @@ class LogManager : public common::DedicatedThreadOwner {
   // Number of buffers to use for buffering and serializing logs
   uint64_t num_buffers_;
 
+  // Size at which to start a new log segment, and whether to compress segments. The log is a single plain file if the
+  // segment size is 0 and compression is off.
+  uint64_t segment_size_ = 0;
+  bool compress_log_ = false;
+  // Writer of the segmented log while the log manager runs, nullptr if the log is a single file
+  std::unique_ptr<LogSegmentWriter> segment_writer_;
+
   // TODO(Tianyu): This can be changed later to be include things that are not necessarily backed by a disk
   //  (e.g. logs can be streamed out to the network for remote replication)
   RecordBufferSegmentPool *buffer_pool_;
@@ -170,6 +214,21 @@ class LogManager : public common::DedicatedThreadOwner {
   // Threshold used by disk consumer task
   uint64_t persist_threshold_;
 
+  /**
+   * @return whether the log is written out as segments
+   */
+  bool UseSegments() const { return segment_size_ != 0 || compress_log_; }
+
+  /**
+   * Adds a buffer to buffers_. Buffers of a segmented log do not write to a file of their own.
+   */
+  void AddBuffer() {
+    if (UseSegments())
+      buffers_.emplace_back();
+    else
+      buffers_.emplace_back(BufferedLogWriter(log_file_path_.c_str()));
+  }
+
   /**
    * If the central registry wants to removes our thread used for the disk log consumer task, we only allow removal if
    * we are in shut down, else we need to keep the task, so we reject the removal
@@ -0,0 +1,206 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+#include "common/macros.h"
+#include "common/spin_latch.h"
+#include "common/strong_typedef.h"
+
+namespace terrier::storage {
+
+/**
+ * Header at the start of every log segment file
+ */
+struct LogSegmentHeader {
+  /**
+   * Magic number identifying log segment files
+   */
+  static constexpr uint64_t MAGIC = 0x544e454d47455354;  // "TSEGMENT" in little endian
+  /**
+   * Version of the segment format described here
+   */
+  static constexpr uint32_t VERSION = 1;
+
+  /**
+   * Must be equal to MAGIC
+   */
+  uint64_t magic_;
+  /**
+   * Must be equal to VERSION
+   */
+  uint32_t version_;
+  /**
+   * Checksum of the header, computed with this field set to 0
+   */
+  uint32_t checksum_;
+  /**
+   * Sequence number of the segment. Segments are numbered in the order they are written, starting from 1.
+   */
+  uint64_t sequence_number_;
+  /**
+   * Offset of the first byte in this segment in the log, i.e. the total number of log bytes in all the segments before
+   * it. Offsets count log bytes before compression, and are what log offsets such as those in checkpoints refer to.
+   */
+  uint64_t start_offset_;
+};
+
+/**
+ * Header in front of every buffer of log bytes written to a segment. The header is followed by the stored bytes.
+ */
+struct LogFrameHeader {
+  /**
+   * Number of log bytes in the frame
+   */
+  uint32_t raw_size_;
+  /**
+   * Number of bytes stored after the header. If this differs from raw_size_, the bytes are compressed.
+   */
+  uint32_t stored_size_;
+  /**
+   * Checksum of the stored bytes
+   */
+  uint32_t checksum_;
+  /**
+   * Checksum of the other fields of the header, so that a torn header is not mistaken for a huge frame
+   */
+  uint32_t header_checksum_;
+};
+
+/**
+ * Writes the log out as a sequence of segment files, named after the log file path with their sequence number
+ * appended. A new segment is started whenever the current one reaches the configured size, and when the writer is
+ * opened, so that a segment that was being written during a crash is never appended to. Segments are preallocated to
+ * their full size when they are created, so that persisting writes to them does not have to allocate disk blocks.
+ *
+ * Every buffer of log bytes is written out as a frame with a checksum, and is optionally compressed. Writes and
+ * persists must come from a single thread, while segments can be removed concurrently.
+ */
+class LogSegmentWriter {
+ public:
+  /**
+   * Opens a writer. Writing starts in a new segment after any existing segments.
+   * @param log_file_path path to the log file. Segments are stored next to it, with the sequence number appended.
+   * @param segment_size size in bytes at which to start a new segment, or 0 to keep writing to a single segment
+   * @param compress whether to compress buffers before writing them out
+   */
+  LogSegmentWriter(std::string log_file_path, uint64_t segment_size, bool compress);
+
+  /**
+   * Closes the writer. Must have been persisted before, if the contents are meant to be durable.
+   */
+  ~LogSegmentWriter();
+
+  DISALLOW_COPY_AND_MOVE(LogSegmentWriter)
+
+  /**
+   * @return offset in the log the next byte written out will have
+   */
+  uint64_t EndOffset() const { return end_offset_; }
+
+  /**
+   * Writes out a buffer of log bytes as a single frame, starting a new segment first if the current one is full
+   * @param data log bytes to write
+   * @param size number of bytes to write
+   */
+  void Append(const byte *data, uint32_t size);
+
+  /**
+   * Makes everything written so far durable
+   */
+  void Persist();
+
+  /**
+   * Deletes every segment whose contents are all before the given offset. The current segment is never deleted.
+   * @param offset offset in the log before which records are no longer needed
+   */
+  void RemoveSegmentsBefore(uint64_t offset);
+
+  /**
+   * @param log_file_path path to the log file
+   * @return sequence number and path of every segment of the given log, in order
+   */
+  static std::vector<std::pair<uint64_t, std::string>> ListSegments(const std::string &log_file_path);
+
+  /**
+   * @param log_file_path path to the log file
+   * @param sequence_number sequence number of the segment
+   * @return path of the segment file
+   */
+  static std::string SegmentPath(const std::string &log_file_path, uint64_t sequence_number);
+
+ private:
+  const std::string log_file_path_;
+  const uint64_t segment_size_;
+  const bool compress_;
+
+  // fd of the current segment
+  int out_ = -1;
+  // Bytes written to the current segment, header included
+  uint64_t segment_bytes_ = 0;
+  uint64_t sequence_number_ = 0;
+  uint64_t end_offset_ = 0;
+  // Buffer to assemble frames in
+  std::vector<byte> frame_;
+
+  // Protects segments_, which is also accessed by whoever removes segments
+  common::SpinLatch segments_latch_;
+  // Start offset of every segment that has not been removed, keyed by sequence number
+  std::map<uint64_t, uint64_t> segments_;
+
+  void StartSegment();
+};
+
+/**
+ * Reads the log bytes back out of the segments written by a LogSegmentWriter, verifying checksums and decompressing
+ * along the way. A frame that is torn or fails its checksum ends its segment, as that only happens at the end of a
+ * segment that was being written during a crash. Reading continues from the next segment.
+ */
+class LogSegmentReader {
+ public:
+  /**
+   * @param log_file_path path to the log file the segments belong to
+   * @param offset offset in the log to start reading from
+   */
+  explicit LogSegmentReader(const std::string &log_file_path, uint64_t offset = 0);
+
+  /**
+   * Closes the reader
+   */
+  ~LogSegmentReader();
+
+  DISALLOW_COPY_AND_MOVE(LogSegmentReader)
+
+  /**
+   * @return if there are contents left in the log
+   */
+  bool HasMore();
+
+  /**
+   * Read the specified number of bytes into the target location from the log. The method reads as many as possible if
+   * there are not enough bytes in the log.
+   * @param dest pointer location to read into
+   * @param size number of bytes to read
+   * @return whether the log has the given number of bytes left
+   */
+  bool Read(void *dest, uint32_t size);
+
+ private:
+  std::vector<std::pair<uint64_t, std::string>> segments_;
+  // Index of the next segment to open
+  size_t next_segment_ = 0;
+  // fd of the current segment, or -1 if none is open
+  int in_ = -1;
+  // Number of log bytes to skip before the offset reading started at is reached
+  uint64_t skip_;
+  // Log bytes of the current frame, and how much of them have been read
+  std::vector<byte> frame_;
+  uint32_t frame_head_ = 0;
+  // Stored bytes of the current frame
+  std::vector<byte> stored_;
+
+  bool OpenNextSegment();
+  bool ReadFrame();
+};
+}  // namespace terrier::storage
@@ -1,12 +1,17 @@
 #pragma once
 
+#include <algorithm>
+#include <condition_variable>  // NOLINT
+#include <mutex>               // NOLINT
 #include <queue>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 #include "common/container/concurrent_blocking_queue.h"
 #include "common/dedicated_thread_task.h"
+#include "storage/data_table.h"
 #include "storage/record_buffer.h"
+#include "storage/storage_util.h"
 #include "storage/write_ahead_log/log_record.h"
 
 namespace terrier::storage {
@@ -23,15 +28,17 @@ class LogSerializerTask : public common::DedicatedThreadTask {
    * @param empty_buffer_queue pointer to queue to pop empty buffers from
    * @param filled_buffer_queue pointer to queue to push filled buffers to
    * @param disk_log_writer_thread_cv pointer to condition variable to notify consumer when a new buffer has handed over
+   * @param log_file_offset offset in the log file the first serialized byte will be written to
    */
   explicit LogSerializerTask(const std::chrono::microseconds serialization_interval,
                              RecordBufferSegmentPool *buffer_pool,
                              common::ConcurrentBlockingQueue<BufferedLogWriter *> *empty_buffer_queue,
                              common::ConcurrentQueue<storage::SerializedLogs> *filled_buffer_queue,
-                             std::condition_variable *disk_log_writer_thread_cv)
+                             std::condition_variable *disk_log_writer_thread_cv, const uint64_t log_file_offset = 0)
       : run_task_(false),
         serialization_interval_(serialization_interval),
         buffer_pool_(buffer_pool),
+        log_file_offset_(log_file_offset),
         filled_buffer_(nullptr),
         empty_buffer_queue_(empty_buffer_queue),
         filled_buffer_queue_(filled_buffer_queue),
@@ -52,16 +59,56 @@ class LogSerializerTask : public common::DedicatedThreadTask {
     // If the task hasn't run yet, yield the thread until it's started
     while (!run_task_) std::this_thread::yield();
     TERRIER_ASSERT(run_task_, "Cant terminate a task that isnt running");
-    run_task_ = false;
+    {
+      std::lock_guard<std::mutex> guard(wake_up_latch_);
+      run_task_ = false;
+    }
+    wake_up_cv_.notify_one();
   }
 
   /**
    * Hands a (possibly partially) filled buffer to the serializer task to be serialized
    * @param buffer_segment the (perhaps partially) filled log buffer ready to be consumed
+   * @param ends_txn whether the buffer is the last one of its transaction, holding its commit or abort record. The task
+   * is woken up to serialize such buffers right away, as the transaction's commit callback waits on them.
    */
-  void AddBufferToFlushQueue(RecordBufferSegment *const buffer_segment) {
-    common::SpinLatch::ScopedSpinLatch guard(&flush_queue_latch_);
-    flush_queue_.push(buffer_segment);
+  void AddBufferToFlushQueue(RecordBufferSegment *const buffer_segment, const bool ends_txn = false) {
+    {
+      common::SpinLatch::ScopedSpinLatch guard(&flush_queue_latch_);
+      flush_queue_.push(buffer_segment);
+    }
+    if (ends_txn) {
+      {
+        std::lock_guard<std::mutex> guard(wake_up_latch_);
+        wake_up_ = true;
+      }
+      wake_up_cv_.notify_one();
+    }
+  }
+
+  /**
+   * Serializes a log record in the format log providers read it back in. This is what the serializer task writes to
+   * the log, but it can be used to write log records out anywhere else as well.
+   * @tparam WriteFn callable taking a pointer to bytes to write and the number of bytes to write, and returning the
+   * number of bytes written
+   * @param record the record to serialize
+   * @param write_value callable that writes out the serialized bytes
+   * @return bytes serialized
+   */
+  template <class WriteFn>
+  static uint64_t SerializeRecord(const LogRecord &record, const WriteFn &write_value);
+
+  /**
+   * Returns the offset in the log file that a checkpoint taken from now on can start replaying the log from. Every
+   * transaction that has not yet had its commit or abort record serialized has all of its records at or after this
+   * offset.
+   * @return log file offset
+   */
+  uint64_t OldestUnfinishedTxnOffset() {
+    common::SpinLatch::ScopedSpinLatch serialization_guard(&serialization_latch_);
+    uint64_t result = log_file_offset_;
+    for (const auto &txn : unfinished_txns_) result = std::min(result, txn.second);
+    return result;
   }
 
  private:
@@ -77,6 +124,13 @@ class LogSerializerTask : public common::DedicatedThreadTask {
   // Ensures only one thread is serializing at a time.
   common::SpinLatch serialization_latch_;
 
+  // Offset in the log file the next serialized byte will be written to. Buffers are written out in the order they are
+  // filled, so this is simply the number of bytes serialized so far plus the size of the file at startup.
+  uint64_t log_file_offset_;
+  // Transactions that had records serialized but no commit or abort record yet, along with the offset of their first
+  // record in the log file
+  std::unordered_map<transaction::timestamp_t, uint64_t> unfinished_txns_;
+
   // TODO(Tianyu): Might not be necessary, since commit on txn manager is already protected with a latch
   // TODO(Tianyu): benchmark for if these should be concurrent data structures, and if we should apply the same
   //  optimization we applied to the GC queue.
@@ -85,6 +139,13 @@ class LogSerializerTask : public common::DedicatedThreadTask {
   // Stores unserialized buffers handed off by transactions
   std::queue<RecordBufferSegment *> flush_queue_;
 
+  // Protects wake_up_, and run_task_ when it is cleared
+  std::mutex wake_up_latch_;
+  // Set when a transaction hands over its last buffer, so the task serializes it without waiting out its sleep
+  bool wake_up_ = false;
+  // Notified when wake_up_ is set or the task is terminated
+  std::condition_variable wake_up_cv_;
+
   // Current buffer we are serializing logs to
   BufferedLogWriter *filled_buffer_;
   // Commit callbacks for commit records currently in filled_buffer
@@ -107,8 +168,8 @@ class LogSerializerTask : public common::DedicatedThreadTask {
   std::condition_variable *disk_log_writer_thread_cv_;
 
   /**
-   * Main serialization loop. Calls Process every interval. Processes all the accumulated log records and
-   * serializes them to log consumer tasks.
+   * Main serialization loop. Calls Process every interval, or as soon as a transaction hands over its commit or abort
+   * record. Processes all the accumulated log records and serializes them to log consumer tasks.
    */
   void LogSerializerTaskLoop();
 
@@ -164,4 +225,99 @@ class LogSerializerTask : public common::DedicatedThreadTask {
    */
   void HandFilledBufferToWriter();
 };
+
+template <class WriteFn>
+uint64_t LogSerializerTask::SerializeRecord(const LogRecord &record, const WriteFn &write_value) {
+  // Writes out a copy of a single value
+  auto write_copy = [&](const auto val) { return write_value(&val, static_cast<uint32_t>(sizeof(val))); };
+  uint64_t num_bytes = 0;
+  // First, serialize out fields common across all LogRecordType's.
+
+  // Note: This is the in-memory size of the log record itself, i.e. inclusive of padding and not considering the size
+  // of any potential varlen entries. It is logically different from the size of the serialized record, which the log
+  // manager generates in this function. In particular, the later value is very likely to be strictly smaller when the
+  // LogRecordType is REDO. On recovery, the goal is to turn the serialized format back into an in-memory log record of
+  // this size.
+  num_bytes += write_copy(record.Size());
+
+  num_bytes += write_copy(record.RecordType());
+  num_bytes += write_copy(record.TxnBegin());
+
+  switch (record.RecordType()) {
+    case LogRecordType::REDO: {
+      auto *record_body = record.GetUnderlyingRecordBodyAs<RedoRecord>();
+      num_bytes += write_copy(record_body->GetDatabaseOid());
+      num_bytes += write_copy(record_body->GetTableOid());
+      num_bytes += write_copy(record_body->GetTupleSlot());
+
+      auto *delta = record_body->Delta();
+      // Write out which column ids this redo record is concerned with. On recovery, we can construct the appropriate
+      // ProjectedRowInitializer from these ids and their corresponding block layout.
+      num_bytes += write_copy(delta->NumColumns());
+      num_bytes += write_value(delta->ColumnIds(), static_cast<uint32_t>(sizeof(col_id_t)) * delta->NumColumns());
+
+      // Write out the attr sizes boundaries, this way we can deserialize the records without the need of the block
+      // layout
+      const auto &block_layout = record_body->GetTupleSlot().GetBlock()->data_table_->GetBlockLayout();
+      uint16_t boundaries[NUM_ATTR_BOUNDARIES];
+      memset(boundaries, 0, sizeof(uint16_t) * NUM_ATTR_BOUNDARIES);
+      StorageUtil::ComputeAttributeSizeBoundaries(block_layout, delta->ColumnIds(), delta->NumColumns(), boundaries);
+      num_bytes += write_value(boundaries, static_cast<uint32_t>(sizeof(uint16_t) * NUM_ATTR_BOUNDARIES));
+
+      // Write out the null bitmap.
+      num_bytes += write_value(&(delta->Bitmap()), common::RawBitmap::SizeInBytes(delta->NumColumns()));
+
+      // Write out attribute values
+      for (uint16_t i = 0; i < delta->NumColumns(); i++) {
+        const auto *column_value_address = delta->AccessWithNullCheck(i);
+        if (column_value_address == nullptr) {
+          // If the column in this REDO record is null, then there's nothing to serialize out. The bitmap contains all
+          // the relevant information.
+          continue;
+        }
+        // Get the column id of the current column in the ProjectedRow.
+        col_id_t col_id = delta->ColumnIds()[i];
+
+        if (block_layout.IsVarlen(col_id)) {
+          // Inline column value is a pointer to a VarlenEntry, so reinterpret as such.
+          const auto *varlen_entry = reinterpret_cast<const VarlenEntry *>(column_value_address);
+          // Serialize out length of the varlen entry.
+          num_bytes += write_copy(varlen_entry->Size());
+          if (varlen_entry->IsInlined()) {
+            // Serialize out the prefix of the varlen entry.
+            num_bytes += write_value(varlen_entry->Prefix(), varlen_entry->Size());
+          } else {
+            // Serialize out the content field of the varlen entry.
+            num_bytes += write_value(varlen_entry->Content(), varlen_entry->Size());
+          }
+        } else {
+          // Inline column value is the actual data we want to serialize out.
+          // Note that by writing out AttrSize(col_id) bytes instead of just the difference between successive offsets
+          // of the delta record, we avoid serializing out any potential padding.
+          num_bytes += write_value(column_value_address, block_layout.AttrSize(col_id));
+        }
+      }
+      break;
+    }
+    case LogRecordType::DELETE: {
+      auto *record_body = record.GetUnderlyingRecordBodyAs<DeleteRecord>();
+      num_bytes += write_copy(record_body->GetDatabaseOid());
+      num_bytes += write_copy(record_body->GetTableOid());
+      num_bytes += write_copy(record_body->GetTupleSlot());
+      break;
+    }
+    case LogRecordType::COMMIT: {
+      auto *record_body = record.GetUnderlyingRecordBodyAs<CommitRecord>();
+      num_bytes += write_copy(record_body->CommitTime());
+      num_bytes += write_copy(record_body->OldestActiveTxn());
+      break;
+    }
+    case LogRecordType::ABORT: {
+      // AbortRecord does not hold any additional metadata
+      break;
+    }
+  }
+
+  return num_bytes;
+}
 }  // namespace terrier::storage
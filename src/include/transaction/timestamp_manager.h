@@ -1,7 +1,10 @@
 #pragma once
 #include <algorithm>
-#include <unordered_set>
+#include <atomic>
+#include <memory>
 #include <vector>
+#include "common/constants.h"
+#include "common/macros.h"
 #include "common/spin_latch.h"
 #include "common/strong_typedef.h"
 #include "transaction/transaction_defs.h"
@@ -18,10 +21,24 @@ class TransactionManager;
  */
 class TimestampManager {
  public:
+  /**
+   * Instantiates a new timestamp manager
+   * @param batch_checkouts true if concurrent checkouts should be served together with a single increment of the clock,
+   * false if every checkout should increment the clock itself
+   */
+  explicit TimestampManager(const bool batch_checkouts = false) : batch_checkouts_(batch_checkouts) {}
+
+  /**
+   * Frees the active txn tables
+   */
+  ~TimestampManager();
+
+  DISALLOW_COPY_AND_MOVE(TimestampManager)
+
   /**
    * @return unique timestamp based on current time, and advances one tick
    */
-  timestamp_t CheckOutTimestamp() { return time_++; }
+  timestamp_t CheckOutTimestamp() { return batch_checkouts_ ? BatchedCheckOutTimestamp() : time_++; }
 
   /**
    * @return current time without advancing the tick
@@ -31,18 +48,17 @@ class TimestampManager {
   /**
    * Get the oldest transaction alive (by start timestamp given out by this timestamp manager at this time)
    * Because of concurrent operations, it is not guaranteed that upon return the txn is still alive. However,
-   * it is guaranteed that the return timestamp is older than any transactions live.
-   * @warning If logging is enabled, txns are not removed from the txn set until they are serialized. Thus, the active
-   * txn set can grow greatly in size, making this call expensive. Consider using CachedOldestTransactionStartTime for
-   * better peformance at the cost of a more stale timestamp.
+   * it is guaranteed that the return timestamp is older than any transactions live. This does not block transactions
+   * from beginning or finishing, but scans all of the active txn tables, so CachedOldestTransactionStartTime is still
+   * cheaper for callers that can use a more stale timestamp.
    * @return timestamp that is older than any transactions alive
    */
   timestamp_t OldestTransactionStartTime();
 
   /**
    * Get the cached timestamp of the oldest active txn. The cached timestamp is only refreshed upon every invocation of
-   * OldestTransactionStartTime, so it may be stale. On the other hand, this function does not require taking a latch or
-   * iterating through the running txns set, making it much cheaper than OldestTransactionStartTime. This has the same
+   * OldestTransactionStartTime, so it may be stale. On the other hand, this function does not require iterating
+   * through the active txn tables, making it much cheaper than OldestTransactionStartTime. This has the same
    * correctness guarantee as OldestTransactionStartTime, but may cause performance degradations for processes that rely
    * on very fresh oldest txn timestamps
    * @return timestamp that is older than any transactions alive
@@ -50,31 +66,50 @@ class TimestampManager {
   timestamp_t CachedOldestTransactionStartTime();
 
  private:
-  // TransactionManager needs to be able to use the curr_running_txns_latch to guard more than just the
-  // duration of the following method calls --- things such as adding to the GC queue needs to be atomic
-  // along with removing a transaction from the table of active transactions. We need this for correctness
-  // in the deferred action framework when dropping tables.
   friend class TransactionManager;
   friend class storage::LogSerializerTask;
-  timestamp_t BeginTransaction() {
-    timestamp_t start_time;
-    {
-      common::SpinLatch::ScopedSpinLatch running_guard(&curr_running_txns_latch_);
-      // There is a three-way race that needs to be prevented.  Specifically, we
-      // cannot allow both a transaction to commit and the GC to poll for the
-      // oldest running transaction in between this transaction acquiring its
-      // begin timestamp and getting inserted into the current running
-      // transactions list.  Using the current running transactions latch
-      // prevents the GC from polling and stops the race.  This allows us to
-      // replace acquiring a shared instance of the commit latch with a
-      // read-only spin-latch and move the allocation out of a critical section.
-      start_time = time_++;
-
-      const auto ret UNUSED_ATTRIBUTE = curr_running_txns_.emplace(start_time);
-      TERRIER_ASSERT(ret.second, "commit start time should be globally unique");
-    }  // Release latch on current running transactions
-    return start_time;
-  }
+
+  // Number of slots beginning transactions announce themselves in. A slot is only held for the duration of a begin.
+  static constexpr uint32_t NUM_BEGIN_SLOTS = 64;
+  // Number of slots in the first table of active transactions. Every table added after it is twice as large.
+  static constexpr uint32_t INITIAL_TABLE_SIZE = 1U << 12U;
+  // Number of slots probed in every table before moving on to the next one
+  static constexpr uint32_t PROBE_LIMIT = 16;
+  // Marks a slot not in use. It compares larger than any real timestamp, so scans for the minimum can ignore it.
+  static constexpr timestamp_t EMPTY_SLOT = INVALID_TXN_TIMESTAMP;
+  // Number of slots threads wait for their timestamps in when checkouts are batched
+  static constexpr uint32_t NUM_CHECKOUT_SLOTS = 64;
+  // Number of times a thread waiting for its timestamp fails to take the checkout latch before it yields
+  static constexpr uint32_t MAX_CHECKOUT_SPINS = 64;
+  // Marks a checkout slot whose owner is waiting for a timestamp
+  static constexpr timestamp_t REQUESTED_SLOT = timestamp_t(UINT64_MAX);
+
+  /**
+   * A slot on a cache line of its own, so that threads using different slots do not contend on the same line
+   */
+  struct alignas(common::Constants::CACHELINE_SIZE) TimestampSlot {
+    std::atomic<timestamp_t> timestamp_{EMPTY_SLOT};
+  };
+
+  /**
+   * Open-addressed table of start timestamps of active transactions. Slots are claimed with a compare-and-swap and
+   * released with a store, and the probe sequence of a timestamp is bounded, so there are no tombstones. A table that
+   * has no free slot within the probe sequence of a timestamp passes it on to the next table.
+   */
+  struct ActiveTxnTable {
+    explicit ActiveTxnTable(const uint32_t size) : size_(size), slots_(new std::atomic<timestamp_t>[size]) {
+      for (uint32_t i = 0; i < size; i++) slots_[i].store(EMPTY_SLOT, std::memory_order_relaxed);
+    }
+    const uint32_t size_;
+    const std::unique_ptr<std::atomic<timestamp_t>[]> slots_;
+    std::atomic<ActiveTxnTable *> next_{nullptr};
+  };
+
+  timestamp_t BeginTransaction();
+
+  timestamp_t BatchedCheckOutTimestamp();
+
+  void ServeCheckOutRequests();
 
   /**
    * Remove a timestamp from active txn set
@@ -83,22 +118,32 @@ class TimestampManager {
   void RemoveTransaction(timestamp_t timestamp);
 
   /**
-   * Bulk remove a set of timestamps from the active txn set. Only grabs the curr_running_txns_latch_ once for all the
-   * timestamps.
+   * Bulk remove a set of timestamps from the active txn set
    * @param timestamps vector of timestamps to remove
    */
   void RemoveTransactions(const std::vector<timestamp_t> &timestamps);
 
-  // TODO(Tianyu): Timestamp generation needs to be more efficient (batches)
+  void InsertActiveTransaction(timestamp_t start_time);
+
   // TODO(Tianyu): We don't handle timestamp wrap-arounds. I doubt this would be an issue any time soon.
   std::atomic<timestamp_t> time_{INITIAL_TXN_TIMESTAMP};
+  const bool batch_checkouts_;
+  // With batched checkouts, a thread that wants a timestamp posts a request here. Whoever holds checkout_latch_ serves
+  // all of the requests posted at the time with a single increment of the clock, so the clock's cache line only moves
+  // once per batch instead of once per checkout.
+  TimestampSlot checkout_slots_[NUM_CHECKOUT_SLOTS];
+  common::SpinLatch checkout_latch_;
   // We cache the oldest txn start time
   std::atomic<timestamp_t> cached_oldest_txn_start_time_{INITIAL_TXN_TIMESTAMP};
-  // TODO(Matt): consider a different data structure if this becomes a measured bottleneck
-  // TODO(Gus): This data structure initially only held items in the order of # of workers. With the logging change, it
-  // can hold many more, since txns are only removed when serialized. We should consider if there is a possible better
-  // data structure
-  std::unordered_set<timestamp_t> curr_running_txns_;
-  mutable common::SpinLatch curr_running_txns_latch_;
+
+  // A transaction checks out its start time and only then inserts it into the active txn tables, so a scan for the
+  // oldest transaction could miss it in between. To prevent that, a beginning transaction first announces a start time
+  // no later than its real one here, and keeps it there until it has inserted the real one.
+  TimestampSlot begin_slots_[NUM_BEGIN_SLOTS];
+  // Start timestamps of active transactions. With logging enabled, txns are only removed once they are serialized, so
+  // this can hold many more transactions than there are workers. More tables are chained on when it fills up.
+  ActiveTxnTable active_txns_{INITIAL_TABLE_SIZE};
+  // Protects adding tables to the chain
+  common::SpinLatch tables_latch_;
 };
 }  // namespace terrier::transaction
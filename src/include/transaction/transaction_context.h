@@ -40,10 +40,17 @@ class TransactionContext {
    * MVCC semantics
    * @param buffer_pool the buffer pool to draw this transaction's undo buffer from
    * @param log_manager pointer to log manager in the system, or nullptr, if logging is disabled
+   * @param read_only true if the transaction is declared read-only and will never write, false otherwise. Nothing a
+   * read-only transaction does is logged.
    */
   TransactionContext(const timestamp_t start, const timestamp_t finish,
-                     storage::RecordBufferSegmentPool *const buffer_pool, storage::LogManager *const log_manager)
-      : start_time_(start), finish_time_(finish), undo_buffer_(buffer_pool), redo_buffer_(log_manager, buffer_pool) {}
+                     storage::RecordBufferSegmentPool *const buffer_pool, storage::LogManager *const log_manager,
+                     const bool read_only = false)
+      : start_time_(start),
+        finish_time_(finish),
+        undo_buffer_(buffer_pool),
+        redo_buffer_(read_only ? DISABLED : log_manager, buffer_pool),
+        read_only_(read_only) {}
 
   /**
    * @warning In the src/ folder this should only be called by the Garbage Collector to adhere to MVCC semantics. Tests
@@ -85,10 +92,18 @@ class TransactionContext {
    */
   storage::UndoRecord *UndoRecordForUpdate(storage::DataTable *const table, const storage::TupleSlot slot,
                                            const storage::ProjectedRow &redo) {
+    TERRIER_ASSERT(!read_only_, "read-only transactions cannot write");
     const uint32_t size = storage::UndoRecord::Size(redo);
     return storage::UndoRecord::InitializeUpdate(undo_buffer_.NewEntry(size), finish_time_.load(), slot, table, redo);
   }
 
+  /**
+   * Fits the space taken up by the last undo record reserved for an update to its before-image, which may leave out
+   * some of the columns of the update
+   * @param undo the undo record last reserved
+   */
+  void ResizeLastUndoRecord(const storage::UndoRecord &undo) { undo_buffer_.ResizeLastEntry(undo.Size()); }
+
   /**
    * Reserve space on this transaction's undo buffer for a record to log the insert given
    * @param table pointer to the updated DataTable object
@@ -96,6 +111,7 @@ class TransactionContext {
    * @return a persistent pointer to the head of a memory chunk large enough to hold the undo record
    */
   storage::UndoRecord *UndoRecordForInsert(storage::DataTable *const table, const storage::TupleSlot slot) {
+    TERRIER_ASSERT(!read_only_, "read-only transactions cannot write");
     byte *const result = undo_buffer_.NewEntry(sizeof(storage::UndoRecord));
     return storage::UndoRecord::InitializeInsert(result, finish_time_.load(), slot, table);
   }
@@ -107,6 +123,7 @@ class TransactionContext {
    * @return a persistent pointer to the head of a memory chunk large enough to hold the undo record
    */
   storage::UndoRecord *UndoRecordForDelete(storage::DataTable *const table, const storage::TupleSlot slot) {
+    TERRIER_ASSERT(!read_only_, "read-only transactions cannot write");
     byte *const result = undo_buffer_.NewEntry(sizeof(storage::UndoRecord));
     return storage::UndoRecord::InitializeDelete(result, finish_time_.load(), slot, table);
   }
@@ -126,6 +143,7 @@ class TransactionContext {
    */
   storage::RedoRecord *StageWrite(const catalog::db_oid_t db_oid, const catalog::table_oid_t table_oid,
                                   const storage::ProjectedRowInitializer &initializer) {
+    TERRIER_ASSERT(!read_only_, "read-only transactions cannot write");
     const uint32_t size = storage::RedoRecord::Size(initializer);
     auto *const log_record =
         storage::RedoRecord::Initialize(redo_buffer_.NewEntry(size), start_time_, db_oid, table_oid, initializer);
@@ -142,6 +160,7 @@ class TransactionContext {
    */
   void StageDelete(const catalog::db_oid_t db_oid, const catalog::table_oid_t table_oid,
                    const storage::TupleSlot slot) {
+    TERRIER_ASSERT(!read_only_, "read-only transactions cannot write");
     const uint32_t size = storage::DeleteRecord::Size();
     storage::DeleteRecord::Initialize(redo_buffer_.NewEntry(size), start_time_, db_oid, table_oid, slot);
   }
@@ -150,7 +169,12 @@ class TransactionContext {
   /**
    * @return whether the transaction is read-only
    */
-  bool IsReadOnly() const { return undo_buffer_.Empty() && loose_ptrs_.empty(); }
+  bool IsReadOnly() const { return read_only_ || (undo_buffer_.Empty() && loose_ptrs_.empty()); }
+
+  /**
+   * @return whether the transaction was begun as read-only, as opposed to just not having written anything so far
+   */
+  bool DeclaredReadOnly() const { return read_only_; }
 
   /**
    * Defers an action to be called if and only if the transaction aborts.  Actions executed LIFO.
@@ -220,6 +244,9 @@ class TransactionContext {
   // conflicts) and checked in Commit().
   bool must_abort_ = false;
 
+  // Declared read-only at begin. Such a transaction has nothing to log or to hand to the GC for unlinking.
+  const bool read_only_;
+
   /**
    * @warning This method is ONLY for recovery
    * Copy the log record into the transaction's redo buffer.
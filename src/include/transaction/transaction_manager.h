@@ -50,6 +50,15 @@ class TransactionManager {
    */
   TransactionContext *BeginTransaction();
 
+  /**
+   * Begins a transaction that promises to only read. The transaction still takes a snapshot that the GC respects, but
+   * it never writes, so nothing it does is logged, and committing it is as cheap as giving up the snapshot.
+   * @warning The commit callback of a read-only transaction is invoked right away, instead of after the log manager
+   * catches up. Results read from writes that are not yet durable may thus be acknowledged before those writes are.
+   * @return transaction context for the newly begun transaction
+   */
+  TransactionContext *BeginReadOnlyTransaction();
+
   /**
    * Commits a transaction, making all of its changes visible to others.
    * @param txn the transaction to commit
@@ -71,6 +80,11 @@ class TransactionManager {
    */
   bool GCEnabled() const { return gc_enabled_; }
 
+  /**
+   * @return the timestamp manager that hands out the timestamps of this manager's transactions
+   */
+  TimestampManager *GetTimestampManager() const { return timestamp_manager_; }
+
   /**
    * Return a copy of the completed txns queue and empty the local version
    * @return copy of the completed txns for the GC to process
@@ -85,11 +99,17 @@ class TransactionManager {
   common::Gate txn_gate_;
 
   bool gc_enabled_ = false;
+  // Protects completed_txns_, which the GC takes from concurrently
+  common::SpinLatch completed_txns_latch_;
   TransactionQueue completed_txns_;
   storage::LogManager *const log_manager_;
 
+  TransactionContext *BeginTransaction(bool read_only);
+
   timestamp_t UpdatingCommitCriticalSection(TransactionContext *txn);
 
+  void ReadOnlyCommit(TransactionContext *txn, transaction::callback_fn callback, void *callback_arg);
+
   void LogCommit(TransactionContext *txn, timestamp_t commit_time, transaction::callback_fn commit_callback,
                  void *commit_callback_arg, timestamp_t oldest_active_txn);
 
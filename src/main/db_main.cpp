@@ -37,12 +37,18 @@ DBMain::DBMain(std::unordered_map<settings::Param, settings::ParamInfo> &&param_
       std::chrono::milliseconds{settings_manager_->GetInt(settings::Param::log_persist_interval)},
       settings_manager_->GetInt(settings::Param::log_persist_threshold), buffer_segment_pool_,
       common::ManagedPointer(thread_registry_));
+  log_manager_->SetSegmentOptions(settings_manager_->GetInt(settings::Param::log_segment_size),
+                                  settings_manager_->GetBool(settings::Param::log_compression));
   log_manager_->Start();
 
-  timestamp_manager_ = new transaction::TimestampManager;
+  timestamp_manager_ =
+      new transaction::TimestampManager(settings_manager_->GetBool(settings::Param::batch_timestamp_checkouts));
   txn_manager_ =
       new transaction::TransactionManager(timestamp_manager_, DISABLED, buffer_segment_pool_, true, log_manager_);
   garbage_collector_ = new storage::GarbageCollector(timestamp_manager_, DISABLED, txn_manager_, DISABLED);
+  const auto gc_num_threads = static_cast<uint32_t>(settings_manager_->GetInt(settings::Param::gc_num_threads));
+  gc_worker_pool_ = gc_num_threads > 1 ? new common::WorkerPool(gc_num_threads, {}) : nullptr;
+  garbage_collector_->SetWorkerPool(gc_worker_pool_);
   gc_thread_ = new storage::GarbageCollectorThread(garbage_collector_,
                                                    std::chrono::milliseconds{type::TransientValuePeeker::PeekInteger(
                                                        param_map_.find(settings::Param::gc_interval)->second.value_)});
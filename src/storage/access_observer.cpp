@@ -2,6 +2,10 @@
 #include "storage/block_compactor.h"
 
 namespace terrier::storage {
+AccessObserver::AccessObserver(BlockCompactor *const compactor) : compactor_(compactor) {
+  compactor_->SetAccessObserver(this);
+}
+
 void AccessObserver::ObserveGCInvocation() {
   gc_epoch_++;
   for (auto it = last_touched_.begin(), end = last_touched_.end(); it != end;) {
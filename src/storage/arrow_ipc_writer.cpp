@@ -0,0 +1,381 @@
+#include "storage/arrow_ipc_writer.h"
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+#include "common/container/bitmap.h"
+#include "storage/storage_util.h"
+
+namespace terrier::storage {
+
+namespace {
+// Arrow IPC messages are described by flatbuffers (see Schema.fbs and Message.fbs in the Arrow repository). We only
+// ever need to write a handful of small metadata messages, so instead of pulling in the flatbuffers library we build
+// them with the minimal builder below. Like the real thing, it builds the buffer back to front, so that an object
+// is always written before anything that refers to it, and identifies objects by their distance from the end of
+// the buffer.
+class FlatBufferBuilder {
+ public:
+  uint32_t Size() const { return static_cast<uint32_t>(buf_.size()); }
+
+  const std::string &Data() const { return buf_; }
+
+  template <class T>
+  void Push(const T value) {
+    // Flatbuffers are little-endian, same as every platform we run on
+    PushBytes(&value, sizeof(T));
+  }
+
+  void PushBytes(const void *data, uint32_t size) {
+    buf_.insert(0, reinterpret_cast<const char *>(data), size);
+  }
+
+  // Pads the buffer so that it is aligned to the given alignment after another size bytes are written
+  void PreAlign(uint32_t size, uint32_t alignment) {
+    min_align_ = std::max(min_align_, alignment);
+    buf_.insert(0, (alignment - (Size() + size) % alignment) % alignment, '\0');
+  }
+
+  void PushOffset(uint32_t target) {
+    PreAlign(0, sizeof(uint32_t));
+    // Offsets are relative to where they are stored
+    Push<uint32_t>(Size() + static_cast<uint32_t>(sizeof(uint32_t)) - target);
+  }
+
+  uint32_t CreateString(const std::string &str) {
+    const auto size = static_cast<uint32_t>(str.size());
+    PreAlign(size + 1, sizeof(uint32_t));
+    Push<char>('\0');
+    PushBytes(str.data(), size);
+    Push<uint32_t>(size);
+    return Size();
+  }
+
+  uint32_t CreateOffsetVector(const std::vector<uint32_t> &targets) {
+    const auto size = static_cast<uint32_t>(targets.size());
+    PreAlign(size * static_cast<uint32_t>(sizeof(uint32_t)), sizeof(uint32_t));
+    for (auto it = targets.rbegin(); it != targets.rend(); ++it) PushOffset(*it);
+    Push<uint32_t>(size);
+    return Size();
+  }
+
+  // Every struct we write consists of two longs
+  uint32_t CreateStructVector(const std::vector<std::pair<int64_t, int64_t>> &structs) {
+    const auto size = static_cast<uint32_t>(structs.size());
+    PreAlign(size * 2 * static_cast<uint32_t>(sizeof(int64_t)), sizeof(uint32_t));
+    PreAlign(size * 2 * static_cast<uint32_t>(sizeof(int64_t)), sizeof(int64_t));
+    for (auto it = structs.rbegin(); it != structs.rend(); ++it) {
+      Push<int64_t>(it->second);
+      Push<int64_t>(it->first);
+    }
+    Push<uint32_t>(size);
+    return Size();
+  }
+
+  void StartTable() {
+    fields_.clear();
+    table_end_ = Size();
+  }
+
+  template <class T>
+  void AddField(uint16_t field_id, const T value) {
+    PreAlign(sizeof(T), sizeof(T));
+    Push<T>(value);
+    fields_.emplace_back(field_id, Size());
+  }
+
+  void AddOffsetField(uint16_t field_id, uint32_t target) {
+    PushOffset(target);
+    fields_.emplace_back(field_id, Size());
+  }
+
+  uint32_t EndTable() {
+    // A table starts with the offset to its vtable, which we can only fill in once the vtable is written
+    PreAlign(sizeof(int32_t), sizeof(int32_t));
+    Push<int32_t>(0);
+    const uint32_t table = Size();
+
+    uint16_t num_fields = 0;
+    for (const auto &field : fields_) num_fields = std::max(num_fields, static_cast<uint16_t>(field.first + 1));
+    std::vector<uint16_t> field_offsets(num_fields, 0);
+    for (const auto &field : fields_) field_offsets[field.first] = static_cast<uint16_t>(table - field.second);
+    for (auto it = field_offsets.rbegin(); it != field_offsets.rend(); ++it) Push<uint16_t>(*it);
+    Push<uint16_t>(static_cast<uint16_t>(table - table_end_));
+    Push<uint16_t>(static_cast<uint16_t>((num_fields + 2) * sizeof(uint16_t)));
+
+    // The vtable sits right before the table, so its offset is always positive
+    const auto vtable_offset = static_cast<int32_t>(Size() - table);
+    std::memcpy(&buf_[Size() - table], &vtable_offset, sizeof(int32_t));
+    return table;
+  }
+
+  void Finish(uint32_t root) {
+    PreAlign(sizeof(uint32_t), min_align_);
+    PushOffset(root);
+  }
+
+ private:
+  std::string buf_;
+  uint32_t min_align_ = 1;
+  uint32_t table_end_ = 0;
+  std::vector<std::pair<uint16_t, uint32_t>> fields_;
+};
+
+// Constants from Schema.fbs and Message.fbs
+constexpr int16_t METADATA_VERSION_V5 = 4;
+constexpr uint8_t HEADER_SCHEMA = 1, HEADER_DICTIONARY_BATCH = 2, HEADER_RECORD_BATCH = 3;
+constexpr uint8_t TYPE_INT = 2, TYPE_FLOATING_POINT = 3, TYPE_BINARY = 4, TYPE_UTF8 = 5;
+constexpr int16_t PRECISION_DOUBLE = 2;
+constexpr uint32_t CONTINUATION_MARKER = 0xFFFFFFFF;
+// Arrow requires buffers in a message body to be at least 8-byte aligned
+constexpr uint32_t BODY_ALIGNMENT = 8;
+
+// A contiguous range of memory to be written out as a buffer in the body of a message
+struct BodyBuffer {
+  const byte *data_;
+  uint64_t size_;
+};
+
+uint32_t BuildIntType(FlatBufferBuilder *fbb, int32_t bit_width, bool is_signed) {
+  fbb->StartTable();
+  fbb->AddField<int32_t>(0, bit_width);
+  fbb->AddField<uint8_t>(1, static_cast<uint8_t>(is_signed));
+  return fbb->EndTable();
+}
+
+// Builds a RecordBatch table that describes the given buffers laid out back to back in the message body
+uint32_t BuildRecordBatch(FlatBufferBuilder *fbb, uint32_t length,
+                          const std::vector<std::pair<int64_t, int64_t>> &field_nodes,
+                          const std::vector<BodyBuffer> &body) {
+  std::vector<std::pair<int64_t, int64_t>> buffers;
+  uint64_t body_offset = 0;
+  for (const auto &buffer : body) {
+    buffers.emplace_back(body_offset, buffer.size_);
+    body_offset += StorageUtil::PadUpToSize(BODY_ALIGNMENT, static_cast<uint32_t>(buffer.size_));
+  }
+  const uint32_t nodes_offset = fbb->CreateStructVector(field_nodes);
+  const uint32_t buffers_offset = fbb->CreateStructVector(buffers);
+  fbb->StartTable();
+  fbb->AddField<int64_t>(0, length);
+  fbb->AddOffsetField(1, nodes_offset);
+  fbb->AddOffsetField(2, buffers_offset);
+  return fbb->EndTable();
+}
+
+// Writes out an encapsulated message, which is the flatbuffer Message followed by its body
+void WriteMessage(std::ostream *out, FlatBufferBuilder *fbb, uint8_t header_type, uint32_t header,
+                  const std::vector<BodyBuffer> &body) {
+  uint64_t body_length = 0;
+  for (const auto &buffer : body)
+    body_length += StorageUtil::PadUpToSize(BODY_ALIGNMENT, static_cast<uint32_t>(buffer.size_));
+
+  fbb->StartTable();
+  fbb->AddField<int64_t>(3, static_cast<int64_t>(body_length));
+  fbb->AddOffsetField(2, header);
+  fbb->AddField<int16_t>(0, METADATA_VERSION_V5);
+  fbb->AddField<uint8_t>(1, header_type);
+  fbb->Finish(fbb->EndTable());
+
+  // The metadata is padded so that the body starts at an aligned offset in the stream
+  const uint32_t prefix_size = 2 * sizeof(uint32_t);
+  const auto metadata_size =
+      static_cast<int32_t>(StorageUtil::PadUpToSize(BODY_ALIGNMENT, prefix_size + fbb->Size()) - prefix_size);
+  const char zeros[BODY_ALIGNMENT] = {};
+  out->write(reinterpret_cast<const char *>(&CONTINUATION_MARKER), sizeof(uint32_t));
+  out->write(reinterpret_cast<const char *>(&metadata_size), sizeof(int32_t));
+  out->write(fbb->Data().data(), fbb->Size());
+  out->write(zeros, metadata_size - fbb->Size());
+
+  for (const auto &buffer : body) {
+    out->write(reinterpret_cast<const char *>(buffer.data_), static_cast<std::streamsize>(buffer.size_));
+    out->write(zeros, StorageUtil::PadUpToSize(BODY_ALIGNMENT, static_cast<uint32_t>(buffer.size_)) - buffer.size_);
+  }
+}
+}  // namespace
+
+uint32_t ArrowIpcWriter::WriteTable(const SqlTable &table, const catalog::Schema &schema) {
+  std::vector<catalog::col_oid_t> col_oids;
+  for (const auto &column : schema.GetColumns()) col_oids.push_back(column.Oid());
+
+  // We can only decide how varlen columns are encoded once we have seen the first block, so the schema is written
+  // lazily. Varlen columns of an empty table are simply written as gathered.
+  column_types_.clear();
+  uint32_t num_skipped = 0;
+  const uint32_t num_not_frozen = table.ExportFrozenBlocks(col_oids, [&](const ArrowBlockView &view) {
+    if (column_types_.empty()) {
+      for (uint16_t i = 0; i < view.NumColumns(); i++) column_types_.push_back(view.ColumnType(i));
+      if (!CanWriteBlock(view)) {
+        column_types_.clear();
+        num_skipped++;
+        return;
+      }
+      WriteSchema(schema);
+    }
+    if (!CanWriteBlock(view)) {
+      num_skipped++;
+      return;
+    }
+    for (uint16_t i = 0; i < view.NumColumns(); i++)
+      if (column_types_[i] == ArrowColumnType::DICTIONARY_COMPRESSED) WriteDictionaryBatch(view, i);
+    WriteRecordBatch(view);
+  });
+
+  if (column_types_.empty()) {
+    for (const auto &column : schema.GetColumns())
+      column_types_.push_back(column.AttrSize() == VARLEN_COLUMN ? ArrowColumnType::GATHERED_VARLEN
+                                                                 : ArrowColumnType::FIXED_LENGTH);
+    WriteSchema(schema);
+  }
+  WriteEndOfStream();
+  return num_skipped + num_not_frozen;
+}
+
+void ArrowIpcWriter::WriteSchema(const catalog::Schema &schema) {
+  FlatBufferBuilder fbb;
+  std::vector<uint32_t> fields;
+  const auto &columns = schema.GetColumns();
+  for (uint16_t i = 0; i < columns.size(); i++) {
+    const auto &column = columns[i];
+    const uint32_t name = fbb.CreateString(column.Name());
+    // Readers insist on the children vector being there, even for primitive types
+    const uint32_t children = fbb.CreateOffsetVector({});
+
+    uint8_t type_type;
+    uint32_t type;
+    switch (column.Type()) {
+      case type::TypeId::BOOLEAN:
+        type_type = TYPE_INT;
+        type = BuildIntType(&fbb, 8, false);
+        break;
+      case type::TypeId::TINYINT:
+        type_type = TYPE_INT;
+        type = BuildIntType(&fbb, 8, true);
+        break;
+      case type::TypeId::SMALLINT:
+        type_type = TYPE_INT;
+        type = BuildIntType(&fbb, 16, true);
+        break;
+      case type::TypeId::INTEGER:
+        type_type = TYPE_INT;
+        type = BuildIntType(&fbb, 32, true);
+        break;
+      case type::TypeId::BIGINT:
+        type_type = TYPE_INT;
+        type = BuildIntType(&fbb, 64, true);
+        break;
+      case type::TypeId::DATE:
+        type_type = TYPE_INT;
+        type = BuildIntType(&fbb, 32, false);
+        break;
+      case type::TypeId::TIMESTAMP:
+        type_type = TYPE_INT;
+        type = BuildIntType(&fbb, 64, false);
+        break;
+      case type::TypeId::DECIMAL:
+        type_type = TYPE_FLOATING_POINT;
+        fbb.StartTable();
+        fbb.AddField<int16_t>(0, PRECISION_DOUBLE);
+        type = fbb.EndTable();
+        break;
+      case type::TypeId::VARCHAR:
+        type_type = TYPE_UTF8;
+        fbb.StartTable();
+        type = fbb.EndTable();
+        break;
+      case type::TypeId::VARBINARY:
+        type_type = TYPE_BINARY;
+        fbb.StartTable();
+        type = fbb.EndTable();
+        break;
+      default:
+        throw std::runtime_error("unexpected switch case value");
+    }
+
+    uint32_t dictionary = 0;
+    if (column_types_[i] == ArrowColumnType::DICTIONARY_COMPRESSED) {
+      // Dictionary codes are unsigned, but Arrow recommends signed indices, and no block has 2^31 distinct words
+      const uint32_t index_type = BuildIntType(&fbb, 32, true);
+      fbb.StartTable();
+      fbb.AddField<int64_t>(0, i);
+      fbb.AddOffsetField(1, index_type);
+      dictionary = fbb.EndTable();
+    }
+
+    fbb.StartTable();
+    fbb.AddOffsetField(0, name);
+    fbb.AddOffsetField(3, type);
+    if (dictionary != 0) fbb.AddOffsetField(4, dictionary);
+    fbb.AddOffsetField(5, children);
+    fbb.AddField<uint8_t>(1, static_cast<uint8_t>(column.Nullable()));
+    fbb.AddField<uint8_t>(2, type_type);
+    fields.push_back(fbb.EndTable());
+  }
+
+  const uint32_t fields_vector = fbb.CreateOffsetVector(fields);
+  fbb.StartTable();
+  fbb.AddOffsetField(1, fields_vector);
+  WriteMessage(out_, &fbb, HEADER_SCHEMA, fbb.EndTable(), {});
+}
+
+bool ArrowIpcWriter::CanWriteBlock(const ArrowBlockView &view) const {
+  for (uint16_t i = 0; i < view.NumColumns(); i++) {
+    const ArrowColumnType type = view.ColumnType(i);
+    if (type != column_types_[i]) return false;
+    // A varlen column that has not been gathered does not have a valid Arrow representation
+    if (type == ArrowColumnType::FIXED_LENGTH && view.AttrSize(i) == VARLEN_COLUMN) return false;
+  }
+  return true;
+}
+
+void ArrowIpcWriter::WriteDictionaryBatch(const ArrowBlockView &view, const uint16_t col) {
+  const uint32_t dictionary_size = view.OffsetsLength(col) - 1;
+  const std::vector<BodyBuffer> body = {
+      {nullptr, 0},
+      {reinterpret_cast<const byte *>(view.Offsets(col)), view.OffsetsLength(col) * sizeof(uint32_t)},
+      {view.Values(col), view.ValuesLength(col)}};
+
+  FlatBufferBuilder fbb;
+  const uint32_t data = BuildRecordBatch(&fbb, dictionary_size, {{dictionary_size, 0}}, body);
+  fbb.StartTable();
+  fbb.AddField<int64_t>(0, col);
+  fbb.AddOffsetField(1, data);
+  // Every block has its own dictionary, which replaces the previous one
+  fbb.AddField<uint8_t>(2, 0);
+  WriteMessage(out_, &fbb, HEADER_DICTIONARY_BATCH, fbb.EndTable(), body);
+}
+
+void ArrowIpcWriter::WriteRecordBatch(const ArrowBlockView &view) {
+  const uint32_t num_records = view.NumRecords();
+  std::vector<std::pair<int64_t, int64_t>> field_nodes;
+  std::vector<BodyBuffer> body;
+  for (uint16_t i = 0; i < view.NumColumns(); i++) {
+    field_nodes.emplace_back(num_records, view.NullCount(i));
+    body.push_back({view.Validity(i), common::RawBitmap::SizeInBytes(num_records)});
+    switch (view.ColumnType(i)) {
+      case ArrowColumnType::FIXED_LENGTH:
+        body.push_back({view.Values(i), view.ValuesLength(i)});
+        break;
+      case ArrowColumnType::GATHERED_VARLEN:
+        body.push_back({reinterpret_cast<const byte *>(view.Offsets(i)), view.OffsetsLength(i) * sizeof(uint32_t)});
+        body.push_back({view.Values(i), view.ValuesLength(i)});
+        break;
+      case ArrowColumnType::DICTIONARY_COMPRESSED:
+        body.push_back({reinterpret_cast<const byte *>(view.Indices(i)), num_records * sizeof(uint32_t)});
+        break;
+      default:
+        throw std::runtime_error("unexpected switch case value");
+    }
+  }
+
+  FlatBufferBuilder fbb;
+  const uint32_t record_batch = BuildRecordBatch(&fbb, num_records, field_nodes, body);
+  WriteMessage(out_, &fbb, HEADER_RECORD_BATCH, record_batch, body);
+}
+
+void ArrowIpcWriter::WriteEndOfStream() {
+  const uint32_t end_of_stream[] = {CONTINUATION_MARKER, 0};
+  out_->write(reinterpret_cast<const char *>(end_of_stream), sizeof(end_of_stream));
+}
+
+}  // namespace terrier::storage
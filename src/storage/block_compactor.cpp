@@ -1,7 +1,9 @@
 #include "storage/block_compactor.h"
 #include <algorithm>
+#include <functional>
 #include <queue>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 #include "storage/index/bwtree_index.h"
@@ -12,50 +14,22 @@
 namespace terrier::storage {
 void BlockCompactor::ProcessCompactionQueue(transaction::DeferredActionManager *deferred_action_manager,
                                             transaction::TransactionManager *txn_manager) {
-  std::queue<RawBlock *> to_process = std::move(compaction_queue_);
-  while (!to_process.empty()) {
+  std::queue<RawBlock *> to_process;
+  to_process.swap(compaction_queue_);
+  // A block can show up in the queue more than once, but must only be processed once per run
+  std::unordered_set<RawBlock *> seen;
+  std::unordered_map<DataTable *, std::vector<RawBlock *>> hot_blocks;
+  std::vector<std::function<void()>> tasks;
+  for (; !to_process.empty(); to_process.pop()) {
     RawBlock *block = to_process.front();
-    BlockAccessController &controller = block->controller_;
-    switch (controller.GetBlockState()->load()) {
-      case BlockState::HOT: {
-        // TODO(Tianyu): The policy about how to group blocks together into compaction group can be a lot
-        // more sophisticated. Compacting more blocks together frees up more memory per compaction run,
-        // but makes the compaction transaction larger, which can have performance impact on the rest
-        // of the system. As it currently stands, no memory is freed from this one-block-per-group scheme.
-        CompactionGroup cg(txn_manager->BeginTransaction(), block->data_table_);
-        // TODO(Tianyu): Additionally, frozen blocks can still have empty slots within them. To make sure
-        // these memory are not gone forever, we still need to periodically shuffle tuples around within
-        // frozen blocks. Although code can be reused for doing the compaction, some logic needs to be
-        // written to enqueue these frozen blocks into the compaction queue.
-        cg.blocks_to_compact_.emplace(block, std::vector<uint32_t>());
-        if (EliminateGaps(&cg)) {
-          controller.GetBlockState()->store(BlockState::COOLING);
-          // If no compaction was performed, we still need to shut out any potentially racey transactions that
-          // are alive at the same time as us flipping the block status flag to cooling. However, we must manually
-          // ask the GC to enqueue this block, because no access will be observed from the empty compaction transaction.
-          if (cg.txn_->IsReadOnly())
-            deferred_action_manager->RegisterDeferredAction([this, block]() { PutInQueue(block); });
-          txn_manager->Commit(cg.txn_, transaction::TransactionUtil::EmptyCallback, nullptr);
-        } else {
-          txn_manager->Abort(cg.txn_);
-        }
+    if (!seen.insert(block).second) continue;
+    switch (block->controller_.GetBlockState()->load()) {
+      case BlockState::HOT:
+        hot_blocks[block->data_table_].push_back(block);
         break;
-      }
-      case BlockState::COOLING: {
-        if (!CheckForVersionsAndGaps(block->data_table_->accessor_, block)) continue;
-        // This is used to clean up any dangling pointers using a deferred action in GC.
-        // We need this piece of memory to live on the heap, so its life time extends to
-        // beyond this function call.
-        auto *loose_ptrs = new std::vector<const byte *>;
-        GatherVarlens(loose_ptrs, block, block->data_table_);
-        controller.GetBlockState()->store(BlockState::FROZEN);
-        // When the old variable length values are no longer visible by running transactions, delete them.
-        deferred_action_manager->RegisterDeferredAction([=]() {
-          for (auto *loose_ptr : *loose_ptrs) delete[] loose_ptr;
-          delete loose_ptrs;
-        });
+      case BlockState::COOLING:
+        tasks.emplace_back([=] { GatherBlock(block, deferred_action_manager); });
         break;
-      }
       case BlockState::FROZEN:
         // This is okay. In a rare race, the block can show up in the compaction queue, be accessed, compacted,
         // and show up again because of the early access.
@@ -63,8 +37,116 @@ void BlockCompactor::ProcessCompactionQueue(transaction::DeferredActionManager *
       default:
         throw std::runtime_error("unexpected control flow");
     }
-    to_process.pop();
   }
+
+  // Every group lives in its own transaction and touches a disjoint set of blocks, as does every gathered block, so
+  // they are all safe to process in parallel.
+  for (auto &group : FormCompactionGroups(hot_blocks))
+    tasks.emplace_back([=, group{std::move(group)}] { CompactGroup(group, deferred_action_manager, txn_manager); });
+  RunTasks(tasks);
+}
+
+std::vector<std::vector<RawBlock *>> BlockCompactor::FormCompactionGroups(
+    const std::unordered_map<DataTable *, std::vector<RawBlock *>> &hot_blocks) const {
+  std::vector<std::vector<RawBlock *>> result;
+  for (auto &entry : hot_blocks) {
+    const TupleAccessStrategy &accessor = entry.first->accessor_;
+    const BlockLayout &layout = accessor.GetBlockLayout();
+    // Only the bitmap portion of the block is read here, so this is cheap compared to the compaction itself
+    std::vector<std::pair<uint32_t, RawBlock *>> blocks_by_fill;
+    for (RawBlock *block : entry.second) {
+      auto *bitmap = accessor.AllocationBitmap(block);
+      uint32_t num_filled = 0;
+      for (uint32_t offset = 0; offset < layout.NumSlots(); offset++)
+        if (bitmap->Test(offset)) num_filled++;
+      blocks_by_fill.emplace_back(num_filled, block);
+    }
+    // Grouping the sparsest blocks together frees up the most blocks. Dense blocks end up grouped with each other,
+    // where they only shuffle around the few tuples needed to close their gaps.
+    std::sort(blocks_by_fill.begin(), blocks_by_fill.end());
+    for (uint32_t i = 0; i < blocks_by_fill.size(); i++) {
+      if (i % max_blocks_per_group_ == 0) result.emplace_back();
+      result.back().push_back(blocks_by_fill[i].second);
+    }
+  }
+  return result;
+}
+
+void BlockCompactor::RunTasks(const std::vector<std::function<void()>> &tasks) {
+  if (worker_pool_ == nullptr) {
+    for (auto &task : tasks) task();
+    return;
+  }
+  worker_pool_->RunTasksAndWait(tasks);
+}
+
+void BlockCompactor::CompactGroup(const std::vector<RawBlock *> &blocks,
+                                  transaction::DeferredActionManager *deferred_action_manager,
+                                  transaction::TransactionManager *txn_manager) {
+  // TODO(Tianyu): Frozen blocks can still have empty slots within them. To make sure these memory are not gone
+  // forever, we still need to periodically shuffle tuples around within frozen blocks. Although code can be reused
+  // for doing the compaction, some logic needs to be written to enqueue these frozen blocks into the compaction queue.
+  CompactionGroup cg(txn_manager->BeginTransaction(), blocks.front()->data_table_);
+  for (RawBlock *block : blocks) cg.blocks_to_compact_.emplace(block, std::vector<uint32_t>());
+  if (!EliminateGaps(&cg)) {
+    txn_manager->Abort(cg.txn_);
+    return;
+  }
+
+  for (RawBlock *block : blocks) {
+    // Empty blocks are about to leave the table, so there is nothing to freeze
+    if (std::find(cg.emptied_blocks_.begin(), cg.emptied_blocks_.end(), block) != cg.emptied_blocks_.end()) continue;
+    block->controller_.GetBlockState()->store(BlockState::COOLING);
+    // If no compaction was performed, we still need to shut out any potentially racey transactions that
+    // are alive at the same time as us flipping the block status flag to cooling. However, we must manually
+    // ask the GC to enqueue this block, because no access will be observed from the empty compaction transaction.
+    if (cg.txn_->IsReadOnly())
+      deferred_action_manager->RegisterDeferredAction([this, block]() { PutInQueue(block); });
+  }
+  txn_manager->Commit(cg.txn_, transaction::TransactionUtil::EmptyCallback, nullptr);
+  if (cg.emptied_blocks_.empty()) return;
+
+  // Transactions that started before the commit can still see the old copies of the tuples in the emptied blocks, so
+  // the blocks need to stay in the table until they are gone. Once the blocks are out of the table, we need to wait
+  // again for scans that were already on them before the memory can be reused. This is the same double deferral used
+  // to drop a table.
+  DataTable *table = cg.table_;
+  std::vector<RawBlock *> emptied = std::move(cg.emptied_blocks_);
+  deferred_action_manager->RegisterDeferredAction([=]() {
+    std::vector<RawBlock *> detached;
+    for (RawBlock *block : emptied)
+      if (table->DetachBlock(block)) detached.push_back(block);
+    deferred_action_manager->RegisterDeferredAction([=]() {
+      for (RawBlock *block : detached) ReleaseBlock(block);
+    });
+  });
+}
+
+void BlockCompactor::GatherBlock(RawBlock *block, transaction::DeferredActionManager *deferred_action_manager) {
+  // If there are still versions around, the block will be sent back to us by the access observer once the GC
+  // prunes them
+  if (!CheckForVersionsAndGaps(block->data_table_->accessor_, block)) return;
+  // This is used to clean up any dangling pointers using a deferred action in GC.
+  // We need this piece of memory to live on the heap, so its life time extends to
+  // beyond this function call.
+  auto *loose_ptrs = new std::vector<const byte *>;
+  GatherVarlens(loose_ptrs, block, block->data_table_);
+  block->controller_.GetBlockState()->store(BlockState::FROZEN);
+  // When the old variable length values are no longer visible by running transactions, delete them.
+  deferred_action_manager->RegisterDeferredAction([=]() {
+    for (auto *loose_ptr : *loose_ptrs) delete[] loose_ptr;
+    delete loose_ptrs;
+  });
+}
+
+void BlockCompactor::ReleaseBlock(RawBlock *block) {
+  // The block may have been observed one last time by the GC when it pruned the compaction transaction
+  if (observer_ != nullptr) observer_->ObserveBlockRelease(block);
+  std::queue<RawBlock *> remaining;
+  for (; !compaction_queue_.empty(); compaction_queue_.pop())
+    if (compaction_queue_.front() != block) remaining.push(compaction_queue_.front());
+  compaction_queue_ = std::move(remaining);
+  block->data_table_->ReleaseBlock(block);
 }
 
 bool BlockCompactor::EliminateGaps(CompactionGroup *cg) {
@@ -102,6 +184,11 @@ bool BlockCompactor::EliminateGaps(CompactionGroup *cg) {
     return a_empty < b_empty;
   });
 
+  // Keep track of how many tuples are in each block, so we know which blocks we managed to empty out
+  std::unordered_map<RawBlock *, uint32_t> num_tuples;
+  for (auto &entry : cg->blocks_to_compact_)
+    num_tuples[entry.first] = layout.NumSlots() - static_cast<uint32_t>(entry.second.size());
+
   cg->all_cols_initializer_.InitializeRow(cg->read_buffer_);
   // We assume that there are a lot more filled slots than empty slots, so we only store the list of empty slots
   // and construct the vector of filled slots on the fly in order to reduce the memory footprint.
@@ -115,10 +202,13 @@ bool BlockCompactor::EliminateGaps(CompactionGroup *cg) {
     std::vector<uint32_t> &taker_empty = cg->blocks_to_compact_.find(*taker)->second;
 
     for (uint32_t empty_offset : taker_empty) {
-      if (filled.empty()) {
+      // Find the next tuple to move, skipping over blocks that have nothing left to give
+      while (filled.empty() && giver != taker) {
         giver--;
         ComputeFilled(layout, &filled, cg->blocks_to_compact_.find(*giver)->second);
       }
+      // Every tuple left in the group is already in place
+      if (filled.empty()) break;
       TupleSlot empty_slot(*taker, empty_offset);
       // fill the first empty slot with the last filled slot, essentially
       // We will only shuffle tuples within a block if it is the last block to compact. Then, we can stop
@@ -129,14 +219,15 @@ bool BlockCompactor::EliminateGaps(CompactionGroup *cg) {
       if (taker == giver && filled_slot.GetOffset() < empty_slot.GetOffset()) break;
       // A failed move implies conflict
       if (!MoveTuple(cg, filled_slot, empty_slot)) return false;
+      num_tuples[filled_slot.GetBlock()]--;
+      num_tuples[empty_slot.GetBlock()]++;
     }
   }
 
-  // TODO(Tianyu): This compaction process could leave blocks empty within a group and we will need to figure out
-  // how those blocks are garbage collected. These blocks should have the same life-cycle as the compacting
-  // transaction itself. (i.e. when the txn context is being GCed, we should be able to free these blocks as well)
-  // For now we are not implementing this because each compaction group is one block. This suggests the use of
-  // deferred action.
+  // Blocks left empty are handed back to the caller, who needs to release them once the compacting transaction is no
+  // longer visible to anyone.
+  for (auto &entry : num_tuples)
+    if (entry.second == 0) cg->emptied_blocks_.push_back(entry.first);
   return true;
 }
 
@@ -191,6 +282,8 @@ bool BlockCompactor::MoveTuple(CompactionGroup *cg, TupleSlot from, TupleSlot to
 
 bool BlockCompactor::CheckForVersionsAndGaps(const TupleAccessStrategy &accessor, RawBlock *block) {
   const BlockLayout &layout = accessor.GetBlockLayout();
+  // The version synopsis lets us bail out early without looking at individual version pointers
+  if (block->num_versioned_slots_.load() != 0) return false;
 
   auto *allocation_bitmap = accessor.AllocationBitmap(block);
   auto *version_ptrs = reinterpret_cast<UndoRecord **>(accessor.ColumnStart(block, VERSION_POINTER_COLUMN_ID));
@@ -269,9 +362,9 @@ void BlockCompactor::CopyToArrowVarlen(std::vector<const byte *> *loose_ptrs, Ar
                                        col_id_t col_id, common::RawConcurrentBitmap *column_bitmap,
                                        ArrowColumnInfo *col, VarlenEntry *values) {
   uint32_t varlen_size = 0;
+  metadata->NullCount(col_id) = 0;
   // Read through every tuple and update null count and total varlen size
   for (uint32_t i = 0; i < metadata->NumRecords(); i++) {
-    metadata->NullCount(col_id) = 0;
     if (!column_bitmap->Test(i))
       // Update null count
       metadata->NullCount(col_id)++;
@@ -312,8 +405,8 @@ void BlockCompactor::BuildDictionary(std::vector<const byte *> *loose_ptrs, Arro
   VarlenEntryMap<uint32_t> dictionary;
   // Read through every tuple and update null count and build the dictionary
   uint32_t varlen_size = 0;
+  metadata->NullCount(col_id) = 0;
   for (uint32_t i = 0; i < metadata->NumRecords(); i++) {
-    metadata->NullCount(col_id) = 0;
     if (!column_bitmap->Test(i)) {
       // Update null count
       metadata->NullCount(col_id)++;
@@ -347,7 +440,11 @@ void BlockCompactor::BuildDictionary(std::vector<const byte *> *loose_ptrs, Arro
 
   // Swing all references in the table to point there, and build the encoded column
   for (uint32_t i = 0; i < metadata->NumRecords(); i++) {
-    if (!column_bitmap->Test(i)) continue;
+    if (!column_bitmap->Test(i)) {
+      // Give null entries a valid code so the indices array can be handed out to Arrow readers as is
+      new_col_info.Indices()[i] = 0;
+      continue;
+    }
     // Only do a gather operation if the column is varlen
     VarlenEntry &entry = values[i];
     // Need to GC
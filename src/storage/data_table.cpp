@@ -1,8 +1,10 @@
 #include "storage/data_table.h"
 #include <pthread.h>
+#include <algorithm>
+#include <atomic>
 #include <cstring>
-#include <list>
 #include <unordered_map>
+#include <vector>
 #include "common/allocator.h"
 #include "storage/block_access_controller.h"
 #include "storage/storage_util.h"
@@ -16,17 +18,14 @@ DataTable::DataTable(BlockStore *const store, const BlockLayout &layout, const l
                  "First column must have size 8 for the version chain.");
   TERRIER_ASSERT(layout.NumColumns() > NUM_RESERVED_COLUMNS,
                  "First column is reserved for version info, second column is reserved for logical delete.");
-  if (block_store_ != nullptr) {
-    RawBlock *new_block = NewBlock();
-    // insert block
-    blocks_.push_back(new_block);
-  }
-  insertion_head_ = blocks_.begin();
+  if (block_store_ != nullptr) blocks_.Append(NewBlock());
 }
 
 DataTable::~DataTable() {
-  common::SpinLatch::ScopedSpinLatch guard(&blocks_latch_);
-  for (RawBlock *block : blocks_) {
+  for (uint32_t i = 0; i < blocks_.Size(); i++) {
+    RawBlock *const block = blocks_[i];
+    // Blocks released by the compactor are no longer ours to free
+    if (block == nullptr) continue;
     StorageUtil::DeallocateVarlens(block, accessor_);
     for (col_id_t i : accessor_.GetBlockLayout().Varlens())
       accessor_.GetArrowBlockMetadata(block).GetColumnInfo(accessor_.GetBlockLayout(), i).Deallocate();
@@ -42,50 +41,170 @@ bool DataTable::Select(terrier::transaction::TransactionContext *txn, terrier::s
 
 void DataTable::Scan(transaction::TransactionContext *const txn, SlotIterator *const start_pos,
                      ProjectedColumns *const out_buffer) const {
-  // TODO(Tianyu): So far this is not that much better than tuple-at-a-time access,
-  // but can be improved if block is read-only, or if we implement version synopsis, to just use std::memcpy when it's
-  // safe
+  Scan(txn, start_pos, end(), out_buffer);
+}
+
+void DataTable::Scan(transaction::TransactionContext *const txn, SlotIterator *const start_pos,
+                     const SlotIterator &end_pos, ProjectedColumns *const out_buffer) const {
   uint32_t filled = 0;
-  while (filled < out_buffer->MaxTuples() && *start_pos != end()) {
-    ProjectedColumns::RowView row = out_buffer->InterpretAsRow(filled);
-    const TupleSlot slot = **start_pos;
-    // Only fill the buffer with valid, visible tuples
-    if (SelectIntoBuffer(txn, slot, &row)) {
-      out_buffer->TupleSlots()[filled] = slot;
-      filled++;
+  while (filled < out_buffer->MaxTuples() && *start_pos != end_pos) {
+    // Frozen blocks can be copied over column by column without looking at individual versions
+    if (ScanFrozenBlock(start_pos, end_pos, out_buffer, &filled)) continue;
+    // Blocks with no versions in them can be copied without chasing version chains either
+    if (ScanCleanBlock(start_pos, end_pos, out_buffer, &filled)) continue;
+    // Otherwise, materialize the tuples that fit in this block one at a time
+    const RawBlock *const block = start_pos->current_slot_.GetBlock();
+    while (filled < out_buffer->MaxTuples() && *start_pos != end_pos && start_pos->current_slot_.GetBlock() == block) {
+      ProjectedColumns::RowView row = out_buffer->InterpretAsRow(filled);
+      const TupleSlot slot = **start_pos;
+      // Only fill the buffer with valid, visible tuples
+      if (SelectIntoBuffer(txn, slot, &row)) {
+        out_buffer->TupleSlots()[filled] = slot;
+        filled++;
+      }
+      ++(*start_pos);
     }
-    ++(*start_pos);
   }
   out_buffer->SetNumTuples(filled);
 }
 
+bool DataTable::ScanFrozenBlock(SlotIterator *const start_pos, const SlotIterator &end_pos,
+                                ProjectedColumns *const out_buffer, uint32_t *const filled) const {
+  RawBlock *const block = start_pos->current_slot_.GetBlock();
+  // A scan that ends within this block is left to the slow path, since it cannot be done in bulk anyways.
+  if (end_pos.current_slot_.GetBlock() == block) return false;
+  // Holding the in-place read lock keeps writers from flipping the block back to hot until we are done copying
+  if (!block->controller_.TryAcquireInPlaceRead()) return false;
+
+  // A frozen block has all of its tuples packed at the front with no versions alive, so every tuple in there is
+  // visible to every running transaction and can be copied as is.
+  const uint32_t offset = start_pos->current_slot_.GetOffset();
+  const uint32_t num_records = accessor_.GetArrowBlockMetadata(block).NumRecords();
+  const uint32_t num_to_copy =
+      offset < num_records ? std::min(num_records - offset, out_buffer->MaxTuples() - *filled) : 0;
+  for (uint16_t i = 0; i < out_buffer->NumColumns(); i++) {
+    TERRIER_ASSERT(out_buffer->ColumnIds()[i] != VERSION_POINTER_COLUMN_ID,
+                   "Output buffer should not read the version pointer column.");
+    StorageUtil::CopyColumnIntoProjection(accessor_, block, offset, out_buffer, i, *filled, num_to_copy);
+  }
+  block->controller_.ReleaseInPlaceRead();
+
+  for (uint32_t i = 0; i < num_to_copy; i++) out_buffer->TupleSlots()[*filled + i] = {block, offset + i};
+  *filled += num_to_copy;
+
+  if (offset + num_to_copy >= num_records) {
+    // Everything past the last record in a frozen block is empty, so we can skip straight to the next block
+    start_pos->current_slot_ = {block, accessor_.GetBlockLayout().NumSlots() - 1};
+    ++(*start_pos);
+  } else {
+    start_pos->current_slot_ = {block, offset + num_to_copy};
+  }
+  return true;
+}
+
+uint32_t DataTable::ExportFrozenBlocks(const std::vector<col_id_t> &col_ids,
+                                       const std::function<void(const ArrowBlockView &)> &visitor) const {
+  TERRIER_ASSERT(std::find(col_ids.cbegin(), col_ids.cend(), VERSION_POINTER_COLUMN_ID) == col_ids.cend(),
+                 "Cannot export the version pointer column.");
+  // Blocks appended while we are going are left out, as they cannot be frozen yet anyways
+  const uint32_t num_blocks = blocks_.Size();
+  uint32_t num_skipped = 0;
+  for (uint32_t i = 0; i < num_blocks; i++) {
+    RawBlock *const block = blocks_[i];
+    if (block == nullptr) continue;
+    if (!block->controller_.TryAcquireInPlaceRead()) {
+      num_skipped++;
+      continue;
+    }
+    // Make sure the block goes back to its normal state even if the visitor throws
+    try {
+      visitor(ArrowBlockView(accessor_, block, col_ids));
+    } catch (...) {
+      block->controller_.ReleaseInPlaceRead();
+      throw;
+    }
+    block->controller_.ReleaseInPlaceRead();
+  }
+  return num_skipped;
+}
+
+bool DataTable::ScanCleanBlock(SlotIterator *const start_pos, const SlotIterator &end_pos,
+                               ProjectedColumns *const out_buffer, uint32_t *const filled) const {
+  RawBlock *const block = start_pos->current_slot_.GetBlock();
+  // This works like a seqlock: any writer that could have changed the block under us must have bumped the epoch.
+  const uint32_t epoch = block->version_epoch_.load();
+  if (block->num_versioned_slots_.load() != 0) return false;
+
+  // Nothing past the insert head has ever been allocated, and inserts there after this point bump the epoch anyways
+  const uint32_t num_slots = accessor_.GetBlockLayout().NumSlots();
+  const bool ends_in_block = end_pos.current_slot_.GetBlock() == block;
+  const uint32_t last = std::min(ends_in_block ? end_pos.current_slot_.GetOffset() : num_slots, block->GetInsertHead());
+
+  uint32_t offset = start_pos->current_slot_.GetOffset();
+  uint32_t num_filled = *filled;
+  for (; offset < last && num_filled < out_buffer->MaxTuples(); offset++) {
+    const TupleSlot slot(block, offset);
+    // With no versions around, a tuple is visible to everyone exactly when it is there and not deleted
+    if (!Visible(slot, accessor_)) continue;
+    ProjectedColumns::RowView row = out_buffer->InterpretAsRow(num_filled);
+    for (uint16_t i = 0; i < out_buffer->NumColumns(); i++)
+      StorageUtil::CopyAttrIntoProjection(accessor_, slot, &row, i);
+    out_buffer->TupleSlots()[num_filled++] = slot;
+  }
+
+  // Make sure none of the reads above are reordered past the epoch check
+  std::atomic_thread_fence(std::memory_order_acquire);
+  // Whatever we wrote to the buffer past filled is garbage now, but will be overwritten by the slow path anyways.
+  if (block->version_epoch_.load() != epoch) return false;
+
+  *filled = num_filled;
+  if (offset >= last && !ends_in_block) {
+    // Everything past the insert head is empty, so we can skip straight to the next block
+    start_pos->current_slot_ = {block, num_slots - 1};
+    ++(*start_pos);
+  } else {
+    start_pos->current_slot_ = {block, offset};
+  }
+  return true;
+}
+
 DataTable::SlotIterator &DataTable::SlotIterator::operator++() {
-  common::SpinLatch::ScopedSpinLatch guard(&table_->blocks_latch_);
   // Jump to the next block if already the last slot in the block.
   if (current_slot_.GetOffset() == table_->accessor_.GetBlockLayout().NumSlots() - 1) {
-    ++block_;
-    // Cannot dereference if the next block is end(), so just use nullptr to denote
-    current_slot_ = {block_ == table_->blocks_.end() ? nullptr : *block_, 0};
+    ++block_index_;
+    current_slot_ = {table_->SkipErasedBlocks(&block_index_), 0};
   } else {
-    current_slot_ = {*block_, current_slot_.GetOffset() + 1};
+    current_slot_ = {current_slot_.GetBlock(), current_slot_.GetOffset() + 1};
   }
   return *this;
 }
 
 DataTable::SlotIterator DataTable::end() const {  // NOLINT for STL name compability
-  common::SpinLatch::ScopedSpinLatch guard(&blocks_latch_);
   // TODO(Tianyu): Need to look in detail at how this interacts with compaction when that gets in.
 
   // The end iterator could either point to an unfilled slot in a block, or point to nothing if every block in the
-  // table is full. In the case that it points to nothing, we will use the end-iterator of the blocks list and
-  // 0 to denote that this is the case. This solution makes increment logic simple and natural.
-  if (blocks_.empty()) return {this, blocks_.end(), 0};
-  auto last_block = --blocks_.end();
-  uint32_t insert_head = (*last_block)->GetInsertHead();
+  // table is full. In the case that it points to nothing, we will use one past the last index in the block directory
+  // and 0 to denote that this is the case. This solution makes increment logic simple and natural.
+  const uint32_t num_blocks = blocks_.Size();
+  if (num_blocks == 0) return {this, 0, 0};
+  RawBlock *const last_block = blocks_[num_blocks - 1];
+  // A block only leaves the table once it is full, so treat it as such
+  uint32_t insert_head = last_block == nullptr ? accessor_.GetBlockLayout().NumSlots() : last_block->GetInsertHead();
   // Last block is full, return the default end iterator that doesn't point to anything
-  if (insert_head == accessor_.GetBlockLayout().NumSlots()) return {this, blocks_.end(), 0};
+  if (insert_head == accessor_.GetBlockLayout().NumSlots()) return {this, num_blocks, 0};
   // Otherwise, insert head points to the slot that will be inserted next, which would be exactly what we want.
-  return {this, last_block, insert_head};
+  return {this, num_blocks - 1, insert_head};
+}
+
+DataTable::SlotIterator DataTable::beginAt(const uint32_t block_index) const {  // NOLINT for STL name compability
+  if (block_index < blocks_.Size()) return {this, block_index, 0};
+  return end();
+}
+
+DataTable::SlotIterator DataTable::endAt(const uint32_t block_index) const {  // NOLINT for STL name compability
+  // An iterator that runs off the last slot of the block before block_index lands on the first slot of block_index,
+  // so the end of a range of blocks is the beginning of the next one.
+  return beginAt(block_index);
 }
 
 bool DataTable::Update(transaction::TransactionContext *const txn, const TupleSlot slot, const ProjectedRow &redo) {
@@ -108,8 +227,8 @@ bool DataTable::Update(transaction::TransactionContext *const txn, const TupleSl
     }
 
     // Store before-image before making any changes or grabbing lock
-    for (uint16_t i = 0; i < undo->Delta()->NumColumns(); i++)
-      StorageUtil::CopyAttrIntoProjection(accessor_, slot, undo->Delta(), i);
+    CopyBeforeImage(slot, redo, undo);
+    txn->ResizeLastUndoRecord(*undo);
 
     // Update the next pointer of the new head of the version chain
     undo->Next() = version_ptr;
@@ -129,24 +248,28 @@ bool DataTable::Update(transaction::TransactionContext *const txn, const TupleSl
   return true;
 }
 
-void DataTable::CheckMoveHead(std::list<RawBlock *>::iterator block) {
-  // Assume block is full
-  common::SpinLatch::ScopedSpinLatch guard_head(&header_latch_);
-  if (block == insertion_head_) {
-    // If the header block is full, move the header to point to the next block
-    insertion_head_++;
+void DataTable::CopyBeforeImage(const TupleSlot slot, const ProjectedRow &redo, UndoRecord *const undo) const {
+  const BlockLayout &layout = accessor_.GetBlockLayout();
+  ProjectedRow *const delta = undo->Delta();
+  // Collect the columns that change in place. Nobody else looks at the undo record until it is installed.
+  uint16_t num_changed = 0;
+  for (uint16_t i = 0; i < redo.NumColumns(); i++) {
+    const col_id_t col_id = redo.ColumnIds()[i];
+    const byte *const stored = accessor_.AccessWithNullCheck(slot, col_id);
+    const byte *const written = redo.AccessWithNullCheck(i);
+    const bool same = !layout.IsVarlen(col_id) &&
+                      (stored == nullptr || written == nullptr
+                           ? stored == written
+                           : std::memcmp(stored, written, layout.AttrSize(col_id)) == 0);
+    if (!same) delta->ColumnIds()[num_changed++] = col_id;
   }
 
-  // If there are no more free blocks, create a new empty block and  point the insertion_head to it
-  if (insertion_head_ == blocks_.end()) {
-    RawBlock *new_block = NewBlock();
-    // take latch
-    common::SpinLatch::ScopedSpinLatch guard_block(&blocks_latch_);
-    // insert block
-    blocks_.push_back(new_block);
-    // set insertion header to --end()
-    insertion_head_ = --blocks_.end();
-  }
+  if (num_changed != redo.NumColumns())
+    ProjectedRow::InitializeRow(delta, layout, delta->ColumnIds(), num_changed);
+  else if (delta->NumColumns() != redo.NumColumns())
+    // An earlier attempt left some columns out
+    ProjectedRow::CopyProjectedRowLayout(delta, redo);
+  for (uint16_t i = 0; i < delta->NumColumns(); i++) StorageUtil::CopyAttrIntoProjection(accessor_, slot, delta, i);
 }
 
 TupleSlot DataTable::Insert(transaction::TransactionContext *const txn, const ProjectedRow &redo) {
@@ -154,8 +277,8 @@ TupleSlot DataTable::Insert(transaction::TransactionContext *const txn, const Pr
                  "The input buffer never changes the version pointer column, so it should have  exactly 1 fewer "
                  "attribute than the DataTable's layout.");
 
-  // Insertion header points to the first block that has free tuple slots
-  // Once a txn arrives, it will start from the insertion header to find the first
+  // Insertion head points to the first block that might have free tuple slots
+  // Once a txn arrives, it will start from the insertion head to find the first
   // idle (no other txn is trying to get tuple slots in that block) and non-full block.
   // If no such block is found, the txn will create a new block.
   // Before the txn writes to the block, it will set block status to busy.
@@ -163,41 +286,38 @@ TupleSlot DataTable::Insert(transaction::TransactionContext *const txn, const Pr
   // If the first bit is 1, it indicates one txn is writing to the block.
 
   TupleSlot result;
-  auto block = insertion_head_;
-  while (true) {
+  for (uint32_t index = insertion_head_.load();; index++) {
     // No free block left
-    if (block == blocks_.end()) {
+    if (index >= blocks_.Size()) {
+      // Nobody else can see the new block until it is appended, so there is no need to mark it busy
       RawBlock *new_block = NewBlock();
-      TERRIER_ASSERT(accessor_.SetBlockBusyStatus(new_block), "Status of new block should not be busy");
-      // No need to flip the busy status bit
       accessor_.Allocate(new_block, &result);
-      // take latch
-      common::SpinLatch::ScopedSpinLatch guard(&blocks_latch_);
-      // insert block
-      blocks_.push_back(new_block);
-      block = --blocks_.end();
+      blocks_.Append(new_block);
       break;
     }
 
-    if (accessor_.SetBlockBusyStatus(*block)) {
+    RawBlock *block = blocks_[index];
+    if (block == nullptr) {
+      // The block was full and has since been released by the compactor, so it is as good as full
+      uint32_t expected = index;
+      insertion_head_.compare_exchange_strong(expected, index + 1);
+      continue;
+    }
+    if (accessor_.SetBlockBusyStatus(block)) {
       // No one is inserting into this block
-      if (accessor_.Allocate(*block, &result)) {
-        // The block is not full, succeed
-        break;
-      }
-      // Fail to insert into the block, flip back the status bit
-      accessor_.ClearBlockBusyStatus(*block);
-      // if the full block is the insertion_header, move the insertion_header
-      // Next insert txn will search from the new insertion_header
-      CheckMoveHead(block);
+      const bool allocated = accessor_.Allocate(block, &result);
+      // Do not need to wait unit finish inserting,
+      // can flip back the status bit once the thread gets the allocated tuple slot
+      accessor_.ClearBlockBusyStatus(block);
+      if (allocated) break;
+      // The block is full and will stay that way, so move the insertion head past it unless someone already did.
+      // Next insert txn will search from the new insertion head
+      uint32_t expected = index;
+      insertion_head_.compare_exchange_strong(expected, index + 1);
     }
     // The block is full or the block is being inserted by other txn, try next block
-    ++block;
   }
 
-  // Do not need to wait unit finish inserting,
-  // can flip back the status bit once the thread gets the allocated tuple slot
-  accessor_.ClearBlockBusyStatus(*block);
   InsertInto(txn, redo, result);
 
   data_table_counter_.IncrementNumInsert(1);
@@ -347,7 +467,8 @@ void DataTable::AtomicallyWriteVersionPtr(const TupleSlot slot, const TupleAcces
                                           UndoRecord *const desired) {
   // Okay to ignore presence bit, because we use that for logical delete, not for validity of the version pointer value
   byte *ptr_location = accessor.AccessWithoutNullCheck(slot, VERSION_POINTER_COLUMN_ID);
-  reinterpret_cast<std::atomic<UndoRecord *> *>(ptr_location)->store(desired);
+  UndoRecord *const old_ptr = reinterpret_cast<std::atomic<UndoRecord *> *>(ptr_location)->exchange(desired);
+  UpdateVersionSynopsis(slot.GetBlock(), old_ptr, desired);
 }
 
 bool DataTable::Visible(const TupleSlot slot, const TupleAccessStrategy &accessor) const {
@@ -372,7 +493,23 @@ bool DataTable::CompareAndSwapVersionPtr(const TupleSlot slot, const TupleAccess
                                          UndoRecord *expected, UndoRecord *const desired) {
   // Okay to ignore presence bit, because we use that for logical delete, not for validity of the version pointer value
   byte *ptr_location = accessor.AccessWithoutNullCheck(slot, VERSION_POINTER_COLUMN_ID);
-  return reinterpret_cast<std::atomic<UndoRecord *> *>(ptr_location)->compare_exchange_strong(expected, desired);
+  if (!reinterpret_cast<std::atomic<UndoRecord *> *>(ptr_location)->compare_exchange_strong(expected, desired))
+    return false;
+  UpdateVersionSynopsis(slot.GetBlock(), expected, desired);
+  return true;
+}
+
+void DataTable::UpdateVersionSynopsis(RawBlock *const block, const UndoRecord *const old_ptr,
+                                      const UndoRecord *const new_ptr) {
+  if (old_ptr == nullptr && new_ptr != nullptr) {
+    // The count needs to go up before the caller goes on to modify the tuple in place, so that scans that skip MVCC
+    // checks either see a dirty block or a changed epoch
+    block->num_versioned_slots_.fetch_add(1);
+    block->version_epoch_.fetch_add(1);
+  } else if (old_ptr != nullptr && new_ptr == nullptr) {
+    TERRIER_ASSERT(block->num_versioned_slots_.load() > 0, "version synopsis out of sync with version pointers");
+    block->num_versioned_slots_.fetch_sub(1);
+  }
 }
 
 RawBlock *DataTable::NewBlock() {
@@ -382,11 +519,46 @@ RawBlock *DataTable::NewBlock() {
   return new_block;
 }
 
+RawBlock *DataTable::SkipErasedBlocks(uint32_t *const block_index) const {
+  for (const uint32_t num_blocks = blocks_.Size(); *block_index < num_blocks; (*block_index)++) {
+    RawBlock *const block = blocks_[*block_index];
+    if (block != nullptr) return block;
+  }
+  // Cannot read past the end of the block directory, so just use nullptr to denote
+  return nullptr;
+}
+
+bool DataTable::DetachBlock(RawBlock *const block) {
+  for (uint32_t i = 0; i < blocks_.Size(); i++) {
+    if (blocks_[i] != block) continue;
+    blocks_.Erase(i);
+    return true;
+  }
+  return false;
+}
+
+void DataTable::ReleaseBlock(RawBlock *const block) {
+  TERRIER_ASSERT(block->data_table_ == this, "block should belong to this table");
+  // The block may have been frozen at some point in the past, in which case its Arrow buffers are still around
+  for (col_id_t i : accessor_.GetBlockLayout().Varlens())
+    accessor_.GetArrowBlockMetadata(block).GetColumnInfo(accessor_.GetBlockLayout(), i).Deallocate();
+  block_store_->Release(block);
+}
+
 bool DataTable::HasConflict(const transaction::TransactionContext &txn, const TupleSlot slot) const {
   UndoRecord *const version_ptr = AtomicallyReadVersionPtr(slot, accessor_);
   return HasConflict(txn, version_ptr);
 }
 
+void DataTable::PrefetchVisibility(const TupleSlot slot) const {
+  const uint32_t bitmap_byte = slot.GetOffset() / BYTE_SIZE;
+  __builtin_prefetch(accessor_.AccessWithoutNullCheck(slot, VERSION_POINTER_COLUMN_ID));
+  __builtin_prefetch(
+      reinterpret_cast<const byte *>(accessor_.ColumnNullBitmap(slot.GetBlock(), VERSION_POINTER_COLUMN_ID)) +
+      bitmap_byte);
+  __builtin_prefetch(reinterpret_cast<const byte *>(accessor_.AllocationBitmap(slot.GetBlock())) + bitmap_byte);
+}
+
 bool DataTable::IsVisible(const transaction::TransactionContext &txn, const TupleSlot slot) const {
   UndoRecord *version_ptr;
   bool visible;
@@ -1,6 +1,8 @@
 #include "storage/garbage_collector.h"
+#include <functional>
 #include <unordered_set>
 #include <utility>
+#include <vector>
 #include "common/macros.h"
 #include "loggers/storage_logger.h"
 #include "storage/data_table.h"
@@ -39,11 +41,22 @@ uint32_t GarbageCollector::ProcessDeallocateQueue(transaction::timestamp_t oldes
     // All of the transactions in my deallocation queue were unlinked before the oldest running txn in the system, and
     // have been serialized by the log manager. We are now safe to deallocate these txns because no running
     // transaction should hold a reference to them anymore
-    for (auto &txn : txns_to_deallocate_) {
-      delete txn;
-      txns_processed++;
-    }
+    std::vector<transaction::TransactionContext *> txns(txns_to_deallocate_.begin(), txns_to_deallocate_.end());
     txns_to_deallocate_.clear();
+    txns_processed = static_cast<uint32_t>(txns.size());
+    if (worker_pool_ != nullptr && txns.size() >= PARALLEL_GC_THRESHOLD) {
+      // Freeing a transaction frees its buffers and loose varlens, none of which are shared with other transactions
+      const uint32_t num_workers = worker_pool_->NumWorkers();
+      std::vector<std::function<void()>> tasks;
+      for (uint32_t worker = 0; worker < num_workers; worker++) {
+        tasks.emplace_back([&txns, worker, num_workers] {
+          for (size_t i = worker; i < txns.size(); i += num_workers) delete txns[i];
+        });
+      }
+      worker_pool_->RunTasksAndWait(tasks);
+    } else {
+      for (auto *txn : txns) delete txn;
+    }
   }
   return txns_processed;
 }
@@ -61,10 +74,8 @@ uint32_t GarbageCollector::ProcessUnlinkQueue(transaction::timestamp_t oldest_tx
   uint32_t txns_processed = 0;
   // Certain transactions might not be yet safe to gc. Need to requeue them
   transaction::TransactionQueue requeue;
-  // It is sufficient to truncate each version chain once in a GC invocation because we only read the maximal safe
-  // timestamp once, and the version chain is sorted by timestamp. Here we keep a set of slots to truncate to avoid
-  // wasteful traversals of the version chain.
-  std::unordered_set<TupleSlot> visited_slots;
+  // Transactions that are safe to unlink
+  std::vector<transaction::TransactionContext *> txns;
 
   // Process every transaction in the unlink queue
   while (!txns_to_unlink_.empty()) {
@@ -77,21 +88,7 @@ uint32_t GarbageCollector::ProcessUnlinkQueue(transaction::timestamp_t oldest_tx
       txns_processed++;
     } else if (transaction::TransactionUtil::NewerThan(oldest_txn, txn->FinishTime())) {
       // Safe to garbage collect.
-      for (auto &undo_record : txn->undo_buffer_) {
-        // It is possible for the table field to be null, for aborted transaction's last conflicting record
-        DataTable *&table = undo_record.Table();
-        // Each version chain needs to be traversed and truncated at most once every GC period. Check
-        // if we have already visited this tuple slot; if not, proceed to prune the version chain.
-        if (table != nullptr && visited_slots.insert(undo_record.Slot()).second)
-          TruncateVersionChain(table, undo_record.Slot(), oldest_txn);
-        // Regardless of the version chain we will need to reclaim deleted slots and any dangling pointers to varlens,
-        // unless the transaction is aborted, and the record holds a version that is still visible.
-        if (!txn->Aborted()) {
-          ReclaimSlotIfDeleted(&undo_record);
-          ReclaimBufferIfVarlen(txn, &undo_record);
-        }
-        if (observer_ != nullptr) observer_->ObserveWrite(undo_record.Slot().GetBlock());
-      }
+      txns.push_back(txn);
       txns_to_deallocate_.push_front(txn);
       txns_processed++;
     } else {
@@ -100,12 +97,85 @@ uint32_t GarbageCollector::ProcessUnlinkQueue(transaction::timestamp_t oldest_tx
     }
   }
 
+  if (worker_pool_ != nullptr && txns.size() >= PARALLEL_GC_THRESHOLD)
+    UnlinkTransactionsInParallel(txns, oldest_txn);
+  else
+    UnlinkTransactions(txns, oldest_txn);
+
   // Requeue any txns that we were still visible to running transactions
   txns_to_unlink_ = transaction::TransactionQueue(std::move(requeue));
 
   return txns_processed;
 }
 
+void GarbageCollector::UnlinkTransactions(const std::vector<transaction::TransactionContext *> &txns,
+                                          const transaction::timestamp_t oldest_txn) {
+  // It is sufficient to truncate each version chain once in a GC invocation because we only read the maximal safe
+  // timestamp once, and the version chain is sorted by timestamp. Here we keep a set of slots to truncate to avoid
+  // wasteful traversals of the version chain.
+  std::unordered_set<TupleSlot> visited_slots;
+  for (auto *txn : txns) {
+    for (auto &undo_record : txn->undo_buffer_) {
+      // It is possible for the table field to be null, for aborted transaction's last conflicting record
+      DataTable *&table = undo_record.Table();
+      // Each version chain needs to be traversed and truncated at most once every GC period. Check
+      // if we have already visited this tuple slot; if not, proceed to prune the version chain.
+      if (table != nullptr && visited_slots.insert(undo_record.Slot()).second)
+        TruncateVersionChain(table, undo_record.Slot(), oldest_txn);
+      // Regardless of the version chain we will need to reclaim deleted slots and any dangling pointers to varlens,
+      // unless the transaction is aborted, and the record holds a version that is still visible.
+      if (!txn->Aborted()) {
+        ReclaimSlotIfDeleted(&undo_record);
+        ReclaimBufferIfVarlen(txn, &undo_record);
+      }
+      if (observer_ != nullptr) observer_->ObserveWrite(undo_record.Slot().GetBlock());
+    }
+  }
+}
+
+void GarbageCollector::UnlinkTransactionsInParallel(const std::vector<transaction::TransactionContext *> &txns,
+                                                    const transaction::timestamp_t oldest_txn) {
+  const uint32_t num_workers = worker_pool_->NumWorkers();
+  // Partition the version chains by slot, so that each chain is truncated by exactly one worker. The observer is not
+  // thread-safe, so it is notified here.
+  std::vector<std::vector<std::pair<DataTable *, TupleSlot>>> chains(num_workers);
+  for (auto *txn : txns) {
+    for (auto &undo_record : txn->undo_buffer_) {
+      // It is possible for the table field to be null, for aborted transaction's last conflicting record
+      DataTable *const table = undo_record.Table();
+      if (table != nullptr)
+        chains[std::hash<TupleSlot>()(undo_record.Slot()) % num_workers].emplace_back(table, undo_record.Slot());
+      if (observer_ != nullptr) observer_->ObserveWrite(undo_record.Slot().GetBlock());
+    }
+  }
+  std::vector<std::function<void()>> truncate_tasks;
+  for (uint32_t worker = 0; worker < num_workers; worker++) {
+    truncate_tasks.emplace_back([this, &chains, worker, oldest_txn] {
+      std::unordered_set<TupleSlot> visited_slots;
+      for (const auto &chain : chains[worker]) {
+        if (visited_slots.insert(chain.second).second) TruncateVersionChain(chain.first, chain.second, oldest_txn);
+      }
+    });
+  }
+  worker_pool_->RunTasksAndWait(truncate_tasks);
+
+  // Every version chain is truncated now, so reclaiming can go in any order. Varlens are reclaimed into the
+  // transaction that owns the record, so transactions are partitioned among the workers instead.
+  std::vector<std::function<void()>> reclaim_tasks;
+  for (uint32_t worker = 0; worker < num_workers; worker++) {
+    reclaim_tasks.emplace_back([this, &txns, worker, num_workers] {
+      for (size_t i = worker; i < txns.size(); i += num_workers) {
+        if (txns[i]->Aborted()) continue;
+        for (auto &undo_record : txns[i]->undo_buffer_) {
+          ReclaimSlotIfDeleted(&undo_record);
+          ReclaimBufferIfVarlen(txns[i], &undo_record);
+        }
+      }
+    });
+  }
+  worker_pool_->RunTasksAndWait(reclaim_tasks);
+}
+
 void GarbageCollector::ProcessDeferredActions(transaction::timestamp_t oldest_txn) {
   if (deferred_action_manager_ != DISABLED) {
     // TODO(Tianyu): Eventually we will remove the GC and implement version chain pruning with deferred actions
@@ -163,6 +233,7 @@ void GarbageCollector::ReclaimBufferIfVarlen(transaction::TransactionContext *co
                                              UndoRecord *const undo_record) const {
   const TupleAccessStrategy &accessor = undo_record->Table()->accessor_;
   const BlockLayout &layout = accessor.GetBlockLayout();
+  if (layout.Varlens().empty()) return;  // nothing to reclaim, no matter how large the delta
   switch (undo_record->Type()) {
     case DeltaRecordType::INSERT:
       return;  // no possibility of outdated varlen to gc
@@ -178,7 +249,6 @@ void GarbageCollector::ReclaimBufferIfVarlen(transaction::TransactionContext *co
       }
       break;
     case DeltaRecordType::UPDATE:
-      // TODO(Tianyu): This might be a really bad idea for large deltas...
       for (uint16_t i = 0; i < undo_record->Delta()->NumColumns(); i++) {
         col_id_t col_id = undo_record->Delta()->ColumnIds()[i];
         if (layout.IsVarlen(col_id)) {
@@ -208,6 +278,13 @@ void GarbageCollector::UnregisterIndexForGC(const common::ManagedPointer<index::
 
 void GarbageCollector::ProcessIndexes() {
   common::SharedLatch::ScopedSharedLatch guard(&indexes_latch_);
+  if (worker_pool_ != nullptr && indexes_.size() > 1) {
+    // Indexes are independent of each other, so they can be collected concurrently
+    std::vector<std::function<void()>> tasks;
+    for (const auto &index : indexes_) tasks.emplace_back([index] { index->PerformGarbageCollection(); });
+    worker_pool_->RunTasksAndWait(tasks);
+    return;
+  }
   for (const auto &index : indexes_) index->PerformGarbageCollection();
 }
 
@@ -0,0 +1,128 @@
+#include "storage/index/index_builder.h"
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/task_scheduler_init.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cstring>
+#include <limits>
+#include <thread>  // NOLINT
+#include <unordered_set>
+
+#include "common/allocator.h"
+#include "common/constants.h"
+#include "storage/projected_columns.h"
+#include "transaction/transaction_util.h"
+
+namespace terrier::storage::index {
+
+bool IndexBuilder::BulkLoad(Index *const index) const {
+  TERRIER_ASSERT(sql_table_ != nullptr && txn_manager_ != nullptr,
+                 "Bulk loading needs the table and the transaction manager.");
+  TERRIER_ASSERT(index->UnderConstruction(), "Only an index built for the table needs to be loaded.");
+
+  // Transactions that started before now may not know of the index. Once they are done, a snapshot sees all they did.
+  WaitForTransactionsBefore(txn_manager_->GetTimestampManager()->CurrentTime());
+
+  // Load the entries of every tuple visible to the snapshot. Deletes of these entries by later transactions are
+  // deferred until the snapshot is done.
+  auto *const snapshot_txn = txn_manager_->BeginReadOnlyTransaction();
+  ScanKeys(snapshot_txn, *index, [index](const std::vector<std::pair<const ProjectedRow *, TupleSlot>> &entries) {
+    index->BulkInsert(entries);
+  });
+  txn_manager_->Commit(snapshot_txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+  bool unique = true;
+  if (index->metadata_.GetSchema().Unique()) {
+    // Transactions that inserted until now checked uniqueness against an incomplete index. Once they are done, check
+    // that no key maps to more than one visible tuple.
+    WaitForTransactionsBefore(txn_manager_->GetTimestampManager()->CurrentTime());
+    auto *const check_txn = txn_manager_->BeginReadOnlyTransaction();
+    std::atomic<bool> violated = false;
+    ScanKeys(check_txn, *index, [&](const std::vector<std::pair<const ProjectedRow *, TupleSlot>> &entries) {
+      std::vector<TupleSlot> values;
+      for (const auto &entry : entries) {
+        if (violated.load()) return;
+        index->ScanKey(*check_txn, *entry.first, &values);
+        if (values.size() > 1) violated = true;
+        values.clear();
+      }
+    });
+    txn_manager_->Commit(check_txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+    unique = !violated.load();
+  }
+
+  index->under_construction_ = false;
+  return unique;
+}
+
+void IndexBuilder::WaitForTransactionsBefore(const transaction::timestamp_t time) const {
+  while (txn_manager_->GetTimestampManager()->OldestTransactionStartTime() < time)
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+}
+
+void IndexBuilder::ScanKeys(
+    transaction::TransactionContext *const txn, const Index &index,
+    const std::function<void(const std::vector<std::pair<const ProjectedRow *, TupleSlot>> &)> &consumer) const {
+  // Columns of the table that make up the key, in the order of the key's columns. We assume there are no indexes on
+  // expressions, so that every key column is a table column.
+  const auto &key_cols = key_schema_.GetColumns();
+  const auto &indexed_oids = key_schema_.GetIndexedColOids();
+  TERRIER_ASSERT(key_cols.size() == indexed_oids.size(), "Only support index keys that are a single column oid");
+  const std::unordered_set<catalog::col_oid_t> indexed_oid_set(indexed_oids.cbegin(), indexed_oids.cend());
+  const std::vector<catalog::col_oid_t> scan_oids(indexed_oid_set.cbegin(), indexed_oid_set.cend());
+  const auto pc_map = sql_table_->ProjectionMapForOids(scan_oids);
+  const auto pc_init =
+      sql_table_->InitializerForProjectedColumns(scan_oids, common::Constants::K_DEFAULT_VECTOR_SIZE);
+  const auto &key_init = index.GetProjectedRowInitializer();
+  const uint32_t key_size = key_init.ProjectedRowSize();
+  std::vector<uint16_t> key_offsets, pc_offsets;
+  for (uint16_t i = 0; i < key_cols.size(); i++) {
+    key_offsets.push_back(index.GetKeyOidToOffsetMap().at(key_cols[i].Oid()));
+    pc_offsets.push_back(pc_map.at(indexed_oids[i]));
+  }
+
+  // Each morsel is a contiguous range of blocks, scanned a vector of tuples at a time and handed to the consumer as a
+  // whole. The last morsel extends to the end of the table so that it covers blocks added after the range was split.
+  tbb::task_scheduler_init scan_scheduler;
+  tbb::blocked_range<uint32_t> block_range(0, sql_table_->GetNumBlocks());
+  tbb::parallel_for(block_range, [&](const tbb::blocked_range<uint32_t> &morsel) {
+    const uint32_t end_block_idx =
+        morsel.end() == block_range.end() ? std::numeric_limits<uint32_t>::max() : morsel.end();
+    byte *const pc_buffer = common::AllocationUtil::AllocateAligned(pc_init.ProjectedColumnsSize());
+    ProjectedColumns *const pc = pc_init.Initialize(pc_buffer);
+    std::vector<byte *> key_buffers;
+    std::vector<std::pair<const ProjectedRow *, TupleSlot>> entries;
+
+    auto it = sql_table_->beginAt(morsel.begin());
+    const auto end = sql_table_->endAt(end_block_idx);
+    while (it != end) {
+      sql_table_->Scan(txn, &it, end, pc);
+      byte *const key_buffer = common::AllocationUtil::AllocateAligned(key_size * pc->NumTuples());
+      key_buffers.push_back(key_buffer);
+      for (uint32_t row = 0; row < pc->NumTuples(); row++) {
+        const auto row_view = pc->InterpretAsRow(row);
+        auto *const key = key_init.InitializeRow(key_buffer + key_size * row);
+        // Copy in each value from the table row into the key, like recovery does
+        for (uint16_t i = 0; i < key_cols.size(); i++) {
+          const byte *const value = row_view.AccessWithNullCheck(pc_offsets[i]);
+          if (value == nullptr) {
+            key->SetNull(key_offsets[i]);
+          } else {
+            std::memcpy(key->AccessForceNotNull(key_offsets[i]), value, key_cols[i].AttrSize() & INT8_MAX);
+          }
+        }
+        entries.emplace_back(key, pc->TupleSlots()[row]);
+      }
+    }
+
+    consumer(entries);
+    for (auto *const key_buffer : key_buffers) delete[] key_buffer;
+    delete[] pc_buffer;
+  });
+}
+
+}  // namespace terrier::storage::index
@@ -16,6 +16,33 @@ ProjectedRow *ProjectedRow::CopyProjectedRowLayout(void *head, const ProjectedRo
   return result;
 }
 
+ProjectedRow *ProjectedRow::InitializeRow(void *const head, const BlockLayout &layout, const col_id_t *const col_ids,
+                                          const uint16_t num_cols) {
+  TERRIER_ASSERT(reinterpret_cast<uintptr_t>(head) % sizeof(uint64_t) == 0,
+                 "start of ProjectedRow needs to be aligned to 8 bytes to"
+                 "ensure correctness of alignment of its members");
+  auto *result = reinterpret_cast<ProjectedRow *>(head);
+  result->num_cols_ = num_cols;
+  for (uint16_t i = 0; i < num_cols; i++) result->ColumnIds()[i] = col_ids[i];
+  // This follows the same steps as the constructor of ProjectedRowInitializer
+  uint32_t size = StorageUtil::PadUpToSize(sizeof(uint32_t), static_cast<uint32_t>(sizeof(ProjectedRow)) +
+                                                                 num_cols * static_cast<uint32_t>(sizeof(uint16_t)));
+  size += num_cols * static_cast<uint32_t>(sizeof(uint32_t));
+  const auto first_alignment = static_cast<uint8_t>(
+      num_cols == 0 ? sizeof(uint64_t) : std::min<uint8_t>(layout.AttrSize(col_ids[0]), sizeof(uint64_t)));
+  size = StorageUtil::PadUpToSize(first_alignment, size + common::RawBitmap::SizeInBytes(num_cols));
+  for (uint16_t i = 0; i < num_cols; i++) {
+    result->AttrValueOffsets()[i] = size;
+    const auto next_alignment = static_cast<uint8_t>(
+        i == num_cols - 1 ? sizeof(uint64_t)
+                          : std::min<uint8_t>(layout.AttrSize(col_ids[i + 1]), sizeof(uint64_t)));
+    size = StorageUtil::PadUpToSize(next_alignment, size + layout.AttrSize(col_ids[i]));
+  }
+  result->size_ = size;
+  result->Bitmap().Clear(num_cols);
+  return result;
+}
+
 template <typename AttrType>
 ProjectedRowInitializer::ProjectedRowInitializer(const std::vector<AttrType> &attr_sizes, std::vector<col_id_t> col_ids)
     : col_ids_(std::move(col_ids)), offsets_(col_ids_.size()) {
@@ -10,9 +10,18 @@ byte *UndoBuffer::NewEntry(const uint32_t size) {
     buffers_.push_back(new_segment);
   }
   last_record_ = buffers_.back()->Reserve(size);
+  last_record_reserved_size_ = size;
   return last_record_;
 }
 
+void UndoBuffer::ResizeLastEntry(const uint32_t size) {
+  TERRIER_ASSERT(last_record_ != nullptr && size <= last_record_reserved_size_,
+                 "can only resize the last entry within the space reserved for it");
+  TERRIER_ASSERT(size % 8 == 0, "a delta entry should be aligned to 8 bytes");
+  RecordBufferSegment *const segment = buffers_.back();
+  segment->size_ = static_cast<uint32_t>(last_record_ - segment->bytes_) + size;
+}
+
 byte *RedoBuffer::NewEntry(const uint32_t size) {
   if (buffer_seg_ == nullptr) {
     // this is the first write
@@ -36,7 +45,7 @@ byte *RedoBuffer::NewEntry(const uint32_t size) {
 void RedoBuffer::Finalize(bool flush_buffer) {
   if (buffer_seg_ == nullptr) return;  // If we never initialized a buffer (logging was disabled), we don't do anything
   if (log_manager_ != DISABLED && flush_buffer) {
-    log_manager_->AddBufferToFlushQueue(buffer_seg_);
+    log_manager_->AddBufferToFlushQueue(buffer_seg_, true);
     has_flushed_ = true;
   } else {
     buffer_pool_->Release(buffer_seg_);
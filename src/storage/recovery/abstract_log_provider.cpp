@@ -45,7 +45,8 @@ std::pair<LogRecord *, std::vector<byte *>> AbstractLogProvider::ReadNextRecord(
       auto table_oid = ReadValue<catalog::table_oid_t>();
       auto tuple_slot = ReadValue<storage::TupleSlot>();
 
-      // TODO(Gus, PR #468): Future addition of checksums should validate these values in case of data corruption.
+      // Segmented logs verify a checksum of every frame before records are read out of it, but a single log file is not
+      // checksummed, so these values are still sanity checked in case of data corruption.
       auto num_cols = ReadValue<uint16_t>();
       if (num_cols > common::Constants::MAX_COL) {
         throw std::runtime_error("Number of columns deserialized exceeds max columns. possible data corrution");
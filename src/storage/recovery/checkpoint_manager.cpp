@@ -0,0 +1,257 @@
+#include "storage/recovery/checkpoint_manager.h"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "catalog/postgres/pg_attribute.h"
+#include "catalog/postgres/pg_class.h"
+#include "catalog/postgres/pg_constraint.h"
+#include "catalog/postgres/pg_database.h"
+#include "catalog/postgres/pg_index.h"
+#include "catalog/postgres/pg_namespace.h"
+#include "catalog/postgres/pg_type.h"
+#include "common/allocator.h"
+#include "storage/write_ahead_log/log_serializer_task.h"
+#include "transaction/transaction_util.h"
+
+namespace terrier::storage {
+
+namespace {
+// Parses the checkpoint timestamp out of the name of a checkpoint file. Returns false if the name does not belong to a
+// complete checkpoint.
+bool ParseCheckpointName(const std::string &name, uint64_t *checkpoint_ts) {
+  const std::string prefix(CheckpointManager::CHECKPOINT_FILE_PREFIX);
+  if (name.size() <= prefix.size() || name.compare(0, prefix.size(), prefix) != 0) return false;
+  const std::string suffix = name.substr(prefix.size());
+  if (suffix.find_first_not_of("0123456789") != std::string::npos) return false;
+  *checkpoint_ts = std::stoull(suffix);
+  return true;
+}
+}  // namespace
+
+std::string CheckpointManager::Checkpoint() {
+  // Step 1: Find where replaying the log has to start from. This has to happen before the snapshot is taken, so that
+  // any transaction that commits after the snapshot was still unfinished, and therefore has all its records after this
+  // offset.
+  const uint64_t log_offset = log_manager_ == nullptr ? 0 : log_manager_->GetCheckpointLogOffset();
+
+  // Step 2: Take the snapshot. The transaction never writes, so it does not block or get blocked by anyone.
+  auto *txn = txn_manager_->BeginTransaction();
+  const transaction::timestamp_t checkpoint_ts = txn->StartTime();
+  const std::string checkpoint_path = CheckpointPath(checkpoint_ts);
+  const std::string tmp_path = checkpoint_path + ".tmp";
+
+  // Step 3: Write out the contents of every table visible to the snapshot
+  unlink(tmp_path.c_str());
+  out_ = std::make_unique<BufferedLogWriter>(tmp_path.c_str());
+  txn_id_ = transaction::timestamp_t(1);
+  txn_size_ = 0;
+  const CheckpointHeader header{CheckpointHeader::MAGIC, checkpoint_ts, log_offset};
+  Write(&header, sizeof(CheckpointHeader));
+
+  // Databases are written first, as recovery needs to create their catalogs before anything can be written to them
+  std::vector<catalog::col_oid_t> database_cols(catalog::postgres::PG_DATABASE_ALL_COL_OIDS.cbegin(),
+                                                catalog::postgres::PG_DATABASE_ALL_COL_OIDS.cend());
+  WriteTable(txn, catalog::INVALID_DATABASE_OID, catalog::postgres::DATABASE_TABLE_OID, catalog_->databases_,
+             database_cols, false, nullptr);
+  CommitCheckpointTxn();
+
+  auto *pg_database = catalog_->databases_;
+  auto db_oid_pri = pg_database->InitializerForProjectedRow({catalog::postgres::DATOID_COL_OID});
+  auto *buffer = common::AllocationUtil::AllocateAligned(db_oid_pri.ProjectedRowSize());
+  for (auto it = pg_database->begin(); it != pg_database->end(); it++) {
+    auto *pr = db_oid_pri.InitializeRow(buffer);
+    if (!pg_database->Select(txn, *it, pr)) continue;
+    WriteDatabase(txn, *(reinterpret_cast<catalog::db_oid_t *>(pr->AccessForceNotNull(0))));
+  }
+  delete[] buffer;
+  txn_manager_->Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+  out_->FlushBuffer();
+  out_->Persist();
+  out_->Close();
+  out_.reset();
+
+  // Step 4: Make the checkpoint durable. The log up to the replay offset has to be durable before the checkpoint can be
+  // used, or recovery could find a gap between the two.
+  if (log_manager_ != nullptr) log_manager_->ForceFlush();
+  if (std::rename(tmp_path.c_str(), checkpoint_path.c_str()) != 0)
+    throw std::runtime_error("Failed to rename checkpoint file with errno " + std::to_string(errno));
+  int dir_fd = PosixIoWrappers::Open(checkpoint_dir_.c_str(), O_RDONLY);
+  if (fsync(dir_fd) == -1) throw std::runtime_error("fsync failed with errno " + std::to_string(errno));
+  PosixIoWrappers::Close(dir_fd);
+
+  // Step 5: Nothing before this checkpoint is needed for recovery anymore
+  RemoveOldCheckpoints(checkpoint_ts);
+  if (log_manager_ != nullptr) log_manager_->TruncateLog(log_offset);
+  return checkpoint_path;
+}
+
+std::string CheckpointManager::GetLatestCheckpoint(const std::string &checkpoint_dir) {
+  DIR *dir = opendir(checkpoint_dir.c_str());
+  if (dir == nullptr) return "";
+  std::string latest;
+  uint64_t latest_ts = 0;
+  for (struct dirent *entry = readdir(dir); entry != nullptr; entry = readdir(dir)) {
+    uint64_t checkpoint_ts;
+    if (!ParseCheckpointName(entry->d_name, &checkpoint_ts)) continue;
+    if (latest.empty() || checkpoint_ts > latest_ts) {
+      latest = checkpoint_dir + "/" + entry->d_name;
+      latest_ts = checkpoint_ts;
+    }
+  }
+  closedir(dir);
+  return latest;
+}
+
+std::string CheckpointManager::CheckpointPath(const transaction::timestamp_t checkpoint_ts) const {
+  return checkpoint_dir_ + "/" + CHECKPOINT_FILE_PREFIX + std::to_string(!checkpoint_ts);
+}
+
+void CheckpointManager::Write(const void *data, uint32_t size) {
+  const auto *bytes = reinterpret_cast<const byte *>(data);
+  while (size > 0) {
+    const uint32_t written = out_->BufferWrite(bytes, size);
+    bytes += written;
+    size -= written;
+    if (out_->IsBufferFull()) out_->FlushBuffer();
+  }
+}
+
+void CheckpointManager::WriteRecord(const LogRecord &record) {
+  LogSerializerTask::SerializeRecord(record, [this](const void *data, uint32_t size) {
+    Write(data, size);
+    return size;
+  });
+  txn_size_++;
+}
+
+void CheckpointManager::CommitCheckpointTxn() {
+  if (txn_size_ == 0) return;
+  // The transaction is its own oldest active transaction, so recovery replays it as soon as it reads the commit
+  byte buffer[sizeof(LogRecord) + sizeof(CommitRecord)];
+  auto *record =
+      CommitRecord::Initialize(buffer, txn_id_, txn_id_, nullptr, nullptr, txn_id_, false, nullptr, nullptr);
+  LogSerializerTask::SerializeRecord(*record, [this](const void *data, uint32_t size) {
+    Write(data, size);
+    return size;
+  });
+  txn_id_++;
+  txn_size_ = 0;
+}
+
+void CheckpointManager::WriteTable(transaction::TransactionContext *const txn, const catalog::db_oid_t db_oid,
+                                   const catalog::table_oid_t table_oid, SqlTable *const table,
+                                   const std::vector<catalog::col_oid_t> &col_oids, const bool is_pg_class,
+                                   std::vector<TupleSlot> *const class_slots) {
+  auto initializer = table->InitializerForProjectedRow(col_oids);
+  auto pr_map = table->ProjectionMapForOids(col_oids);
+  auto *buffer = common::AllocationUtil::AllocateAligned(RedoRecord::Size(initializer));
+  for (auto it = table->begin(); it != table->end(); it++) {
+    auto *record = RedoRecord::Initialize(buffer, txn_id_, db_oid, table_oid, initializer);
+    auto *redo = record->GetUnderlyingRecordBodyAs<RedoRecord>();
+    if (!table->Select(txn, *it, redo->Delta())) continue;
+    redo->SetTupleSlot(*it);
+
+    if (is_pg_class) {
+      // The pointers are only meaningful in this process. Recovery recreates the objects from the rest of the catalog
+      // when it replays the pointer updates written out after all the catalog tables.
+      if (redo->Delta()->AccessWithNullCheck(pr_map[catalog::postgres::REL_PTR_COL_OID]) != nullptr)
+        class_slots->push_back(*it);
+      redo->Delta()->SetNull(pr_map[catalog::postgres::REL_PTR_COL_OID]);
+      redo->Delta()->SetNull(pr_map[catalog::postgres::REL_SCHEMA_COL_OID]);
+    }
+
+    WriteRecord(*record);
+    if (txn_size_ == TUPLES_PER_TXN) CommitCheckpointTxn();
+  }
+  delete[] buffer;
+}
+
+void CheckpointManager::WriteDatabase(transaction::TransactionContext *const txn, const catalog::db_oid_t db_oid) {
+  auto db_catalog = catalog_->GetDatabaseCatalog(txn, db_oid);
+  TERRIER_ASSERT(db_catalog != nullptr, "Database visible in pg_database must have a catalog");
+
+  // Step 1: Write out the catalog tables
+  std::vector<TupleSlot> class_slots;
+  auto write_catalog_table = [&](catalog::table_oid_t table_oid, SqlTable *table, const auto &all_col_oids) {
+    std::vector<catalog::col_oid_t> col_oids(all_col_oids.cbegin(), all_col_oids.cend());
+    WriteTable(txn, db_oid, table_oid, table, col_oids, table_oid == catalog::postgres::CLASS_TABLE_OID,
+               &class_slots);
+  };
+  write_catalog_table(catalog::postgres::NAMESPACE_TABLE_OID, db_catalog->namespaces_,
+                      catalog::postgres::PG_NAMESPACE_ALL_COL_OIDS);
+  write_catalog_table(catalog::postgres::CLASS_TABLE_OID, db_catalog->classes_,
+                      catalog::postgres::PG_CLASS_ALL_COL_OIDS);
+  write_catalog_table(catalog::postgres::INDEX_TABLE_OID, db_catalog->indexes_,
+                      catalog::postgres::PG_INDEX_ALL_COL_OIDS);
+  write_catalog_table(catalog::postgres::COLUMN_TABLE_OID, db_catalog->columns_,
+                      catalog::postgres::PG_ATTRIBUTE_ALL_COL_OIDS);
+  write_catalog_table(catalog::postgres::TYPE_TABLE_OID, db_catalog->types_, catalog::postgres::PG_TYPE_ALL_COL_OIDS);
+  write_catalog_table(catalog::postgres::CONSTRAINT_TABLE_OID, db_catalog->constraints_,
+                      catalog::postgres::PG_CONSTRAINT_ALL_COL_OIDS);
+  CommitCheckpointTxn();
+
+  // Step 2: Write out an update of the object pointer for every object in pg_class, which is how recovery knows to
+  // recreate it. The whole catalog is in place by then.
+  auto *pg_class = db_catalog->classes_;
+  const std::vector<catalog::col_oid_t> class_cols = {catalog::postgres::RELOID_COL_OID,
+                                                      catalog::postgres::RELKIND_COL_OID};
+  auto class_pri = pg_class->InitializerForProjectedRow(class_cols);
+  auto class_pr_map = pg_class->ProjectionMapForOids(class_cols);
+  auto ptr_pri = pg_class->InitializerForProjectedRow({catalog::postgres::REL_PTR_COL_OID});
+  auto *buffer = common::AllocationUtil::AllocateAligned(
+      std::max(class_pri.ProjectedRowSize(), RedoRecord::Size(ptr_pri)));
+  std::vector<catalog::table_oid_t> user_tables;
+  for (const auto slot : class_slots) {
+    auto *pr = class_pri.InitializeRow(buffer);
+    bool visible UNUSED_ATTRIBUTE = pg_class->Select(txn, slot, pr);
+    TERRIER_ASSERT(visible, "Tuple was visible when pg_class was written out");
+    const auto class_oid =
+        *(reinterpret_cast<uint32_t *>(pr->AccessWithNullCheck(class_pr_map[catalog::postgres::RELOID_COL_OID])));
+    const auto class_kind = *(reinterpret_cast<catalog::postgres::ClassKind *>(
+        pr->AccessWithNullCheck(class_pr_map[catalog::postgres::RELKIND_COL_OID])));
+    if (class_kind == catalog::postgres::ClassKind::REGULAR_TABLE && class_oid >= catalog::START_OID)
+      user_tables.emplace_back(class_oid);
+
+    auto *record = RedoRecord::Initialize(buffer, txn_id_, db_oid, catalog::postgres::CLASS_TABLE_OID, ptr_pri);
+    auto *redo = record->GetUnderlyingRecordBodyAs<RedoRecord>();
+    visible = pg_class->Select(txn, slot, redo->Delta());
+    TERRIER_ASSERT(visible, "Tuple was visible when pg_class was written out");
+    redo->SetTupleSlot(slot);
+    WriteRecord(*record);
+  }
+  delete[] buffer;
+  CommitCheckpointTxn();
+
+  // Step 3: Write out the user tables
+  for (const auto table_oid : user_tables) {
+    const auto &schema = db_catalog->GetSchema(txn, table_oid);
+    std::vector<catalog::col_oid_t> col_oids;
+    for (const auto &col : schema.GetColumns()) col_oids.emplace_back(col.Oid());
+    WriteTable(txn, db_oid, table_oid, db_catalog->GetTable(txn, table_oid).operator->(), col_oids, false, nullptr);
+    CommitCheckpointTxn();
+  }
+}
+
+void CheckpointManager::RemoveOldCheckpoints(const transaction::timestamp_t checkpoint_ts) const {
+  DIR *dir = opendir(checkpoint_dir_.c_str());
+  if (dir == nullptr)
+    throw std::runtime_error("Failed to open checkpoint directory with errno " + std::to_string(errno));
+  std::vector<std::string> old_checkpoints;
+  for (struct dirent *entry = readdir(dir); entry != nullptr; entry = readdir(dir)) {
+    uint64_t entry_ts;
+    if (ParseCheckpointName(entry->d_name, &entry_ts) && entry_ts < !checkpoint_ts)
+      old_checkpoints.emplace_back(checkpoint_dir_ + "/" + entry->d_name);
+  }
+  closedir(dir);
+  for (const auto &path : old_checkpoints) unlink(path.c_str());
+}
+}  // namespace terrier::storage
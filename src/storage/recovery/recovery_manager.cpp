@@ -1,4 +1,6 @@
 #include <algorithm>
+#include <functional>
+#include <iterator>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
@@ -19,10 +21,10 @@
 
 namespace terrier::storage {
 
-void RecoveryManager::RecoverFromLogs() {
+void RecoveryManager::Replay(AbstractLogProvider *const provider) {
   // Replay logs until the log provider no longer gives us logs
   while (true) {
-    auto pair = log_provider_->GetNextRecord();
+    auto pair = provider->GetNextRecord();
     auto *log_record = pair.first;
 
     // If we have exhausted all the logs, break from the loop
@@ -41,11 +43,22 @@ void RecoveryManager::RecoverFromLogs() {
         TERRIER_ASSERT(pair.second.empty(), "Commit records should not have any varlen pointers");
         auto *commit_record = log_record->GetUnderlyingRecordBodyAs<CommitRecord>();
 
+        // Transactions that committed before the checkpoint was taken are already in it
+        if (checkpoint_loaded_ && commit_record->CommitTime() < checkpoint_->CheckpointTimestamp()) {
+          DeferRecordDeletes(log_record->TxnBegin(), true);
+          buffered_changes_map_.erase(log_record->TxnBegin());
+          deferred_action_manager_->RegisterDeferredAction([=] { delete[] reinterpret_cast<byte *>(log_record); });
+          break;
+        }
+
         // We defer all transactions initially
         deferred_txns_.insert(log_record->TxnBegin());
 
-        // Process any deferred transactions that are safe to execute
-        recovered_txns_ += ProcessDeferredTransactions(commit_record->OldestActiveTxn());
+        // Process any deferred transactions that are safe to execute. Holding on to transactions for longer is always
+        // safe, as they are replayed in serial order regardless, so when replaying in parallel we let them pile up to
+        // give the workers enough non-conflicting transactions to work on.
+        if (worker_pool_ == nullptr || deferred_txns_.size() >= PARALLEL_REPLAY_THRESHOLD)
+          recovered_txns_ += ProcessDeferredTransactions(commit_record->OldestActiveTxn());
 
         // Clean up the log record
         deferred_action_manager_->RegisterDeferredAction([=] { delete[] reinterpret_cast<byte *>(log_record); });
@@ -60,7 +73,7 @@ void RecoveryManager::RecoverFromLogs() {
     }
   }
   // Process all deferred txns
-  ProcessDeferredTransactions(transaction::INVALID_TXN_TIMESTAMP);
+  recovered_txns_ += ProcessDeferredTransactions(transaction::INVALID_TXN_TIMESTAMP);
   TERRIER_ASSERT(deferred_txns_.empty(), "We should have no unprocessed deferred transactions at the end of recovery");
 
   // If we have unprocessed buffered changes, then these transactions were in-process at the time of system shutdown.
@@ -74,18 +87,26 @@ void RecoveryManager::RecoverFromLogs() {
 }
 
 void RecoveryManager::ProcessCommittedTransaction(terrier::transaction::timestamp_t txn_id) {
+  ReplayTransaction(&buffered_changes_map_[txn_id]);
+
+  // Defer deletes of the log records
+  DeferRecordDeletes(txn_id, false);
+  buffered_changes_map_.erase(txn_id);
+}
+
+void RecoveryManager::ReplayTransaction(std::vector<std::pair<LogRecord *, std::vector<byte *>>> *buffered_changes) {
   // Begin a txn to replay changes with.
   auto *txn = txn_manager_->BeginTransaction();
 
   // Apply all buffered changes. They should all succeed. After applying we can safely delete the record
-  for (uint32_t idx = 0; idx < buffered_changes_map_[txn_id].size(); idx++) {
-    auto *buffered_record = buffered_changes_map_[txn_id][idx].first;
+  for (uint32_t idx = 0; idx < buffered_changes->size(); idx++) {
+    auto *buffered_record = (*buffered_changes)[idx].first;
     TERRIER_ASSERT(
         buffered_record->RecordType() == LogRecordType::REDO || buffered_record->RecordType() == LogRecordType::DELETE,
         "Buffered record must be a redo or delete.");
 
     if (IsSpecialCaseCatalogRecord(buffered_record)) {
-      idx += ProcessSpecialCaseCatalogRecord(txn, &buffered_changes_map_[txn_id], idx);
+      idx += ProcessSpecialCaseCatalogRecord(txn, buffered_changes, idx);
     } else if (buffered_record->RecordType() == LogRecordType::REDO) {
       ReplayRedoRecord(txn, buffered_record);
     } else {
@@ -93,10 +114,6 @@ void RecoveryManager::ProcessCommittedTransaction(terrier::transaction::timestam
     }
   }
 
-  // Defer deletes of the log records
-  DeferRecordDeletes(txn_id, false);
-  buffered_changes_map_.erase(txn_id);
-
   // Commit the txn
   txn_manager_->Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
 }
@@ -123,9 +140,14 @@ uint32_t RecoveryManager::ProcessDeferredTransactions(terrier::transaction::time
       (upper_bound_ts == transaction::INVALID_TXN_TIMESTAMP) ? transaction::timestamp_t(INT64_MAX) : upper_bound_ts;
   auto upper_bound_it = deferred_txns_.upper_bound(upper_bound_ts);
 
-  for (auto it = deferred_txns_.begin(); it != upper_bound_it; it++) {
-    ProcessCommittedTransaction(*it);
-    txns_processed++;
+  if (worker_pool_ != nullptr) {
+    ProcessTransactionsInParallel(deferred_txns_.begin(), upper_bound_it);
+    txns_processed = static_cast<uint32_t>(std::distance(deferred_txns_.begin(), upper_bound_it));
+  } else {
+    for (auto it = deferred_txns_.begin(); it != upper_bound_it; it++) {
+      ProcessCommittedTransaction(*it);
+      txns_processed++;
+    }
   }
 
   // If we actually processed some txns, remove them from the set
@@ -134,6 +156,99 @@ uint32_t RecoveryManager::ProcessDeferredTransactions(terrier::transaction::time
   return txns_processed;
 }
 
+void RecoveryManager::ProcessTransactionsInParallel(std::set<transaction::timestamp_t>::const_iterator begin,
+                                                    std::set<transaction::timestamp_t>::const_iterator end) {
+  ReplayBatch batch;
+  for (auto it = begin; it != end; it++) {
+    // Transactions that touch the catalog can change what every later transaction sees (e.g. CREATE or DROP TABLE), so
+    // they act as a barrier and are replayed alone on this thread.
+    const auto &buffered_changes = buffered_changes_map_[*it];
+    const bool touches_catalog =
+        std::any_of(buffered_changes.begin(), buffered_changes.end(),
+                    [](const std::pair<LogRecord *, std::vector<byte *>> &change) {
+                      const auto *record = change.first;
+                      const auto table_oid = record->RecordType() == LogRecordType::REDO
+                                                 ? record->GetUnderlyingRecordBodyAs<RedoRecord>()->GetTableOid()
+                                                 : record->GetUnderlyingRecordBodyAs<DeleteRecord>()->GetTableOid();
+                      return (!table_oid) < catalog::START_OID;
+                    });
+    if (touches_catalog) {
+      ReplayBatchInParallel(&batch);
+      ProcessCommittedTransaction(*it);
+      continue;
+    }
+
+    if (!TryAddToBatch(*it, &batch)) {
+      // Conflicts with something in the current batch, so it has to wait for the batch to commit first
+      ReplayBatchInParallel(&batch);
+      bool added UNUSED_ATTRIBUTE = TryAddToBatch(*it, &batch);
+      TERRIER_ASSERT(added, "A transaction cannot conflict with an empty batch");
+    }
+  }
+  ReplayBatchInParallel(&batch);
+}
+
+bool RecoveryManager::TryAddToBatch(const transaction::timestamp_t txn_id, ReplayBatch *const batch) {
+  const auto &buffered_changes = buffered_changes_map_[txn_id];
+  // Key tables by both oids, as table oids are only unique within a database
+  auto table_key = [](catalog::db_oid_t db_oid, catalog::table_oid_t table_oid) {
+    return (static_cast<uint64_t>(!db_oid) << 32u) | static_cast<uint64_t>(!table_oid);
+  };
+
+  for (const auto &change : buffered_changes) {
+    const auto *record = change.first;
+    if (record->RecordType() == LogRecordType::REDO) {
+      const auto *redo_record = record->GetUnderlyingRecordBodyAs<RedoRecord>();
+      if (batch->slots_.count(redo_record->GetTupleSlot()) > 0 ||
+          batch->deleted_tables_.count(table_key(redo_record->GetDatabaseOid(), redo_record->GetTableOid())) > 0)
+        return false;
+    } else {
+      const auto *delete_record = record->GetUnderlyingRecordBodyAs<DeleteRecord>();
+      if (batch->slots_.count(delete_record->GetTupleSlot()) > 0 ||
+          batch->written_tables_.count(table_key(delete_record->GetDatabaseOid(), delete_record->GetTableOid())) > 0)
+        return false;
+    }
+  }
+
+  for (const auto &change : buffered_changes) {
+    const auto *record = change.first;
+    if (record->RecordType() == LogRecordType::REDO) {
+      const auto *redo_record = record->GetUnderlyingRecordBodyAs<RedoRecord>();
+      batch->slots_.insert(redo_record->GetTupleSlot());
+      batch->written_tables_.insert(table_key(redo_record->GetDatabaseOid(), redo_record->GetTableOid()));
+    } else {
+      const auto *delete_record = record->GetUnderlyingRecordBodyAs<DeleteRecord>();
+      const auto key = table_key(delete_record->GetDatabaseOid(), delete_record->GetTableOid());
+      batch->slots_.insert(delete_record->GetTupleSlot());
+      batch->written_tables_.insert(key);
+      batch->deleted_tables_.insert(key);
+    }
+  }
+  batch->txns_.push_back(txn_id);
+  return true;
+}
+
+void RecoveryManager::ReplayBatchInParallel(ReplayBatch *const batch) {
+  if (batch->txns_.empty()) return;
+
+  // Look up the changes before handing them to the workers, so that the map is not touched while they run
+  std::vector<std::function<void()>> tasks;
+  for (const auto txn_id : batch->txns_) {
+    auto *buffered_changes = &buffered_changes_map_[txn_id];
+    tasks.emplace_back([this, buffered_changes] { ReplayTransaction(buffered_changes); });
+  }
+  worker_pool_->RunTasksAndWait(tasks);
+
+  for (const auto txn_id : batch->txns_) {
+    DeferRecordDeletes(txn_id, false);
+    buffered_changes_map_.erase(txn_id);
+  }
+  batch->txns_.clear();
+  batch->slots_.clear();
+  batch->written_tables_.clear();
+  batch->deleted_tables_.clear();
+}
+
 void RecoveryManager::ReplayRedoRecord(transaction::TransactionContext *txn, LogRecord *record) {
   auto *redo_record = record->GetUnderlyingRecordBodyAs<RedoRecord>();
   auto sql_table_ptr = GetSqlTable(txn, redo_record->GetDatabaseOid(), redo_record->GetTableOid());
@@ -154,9 +269,10 @@ void RecoveryManager::ReplayRedoRecord(transaction::TransactionContext *txn, Log
     TERRIER_ASSERT(staged_record->GetTupleSlot() == new_tuple_slot,
                    "Insert should update redo record with new tuple slot");
     // Create a mapping of the old to new tuple. The new tuple slot should be used for future updates and deletes.
+    common::SpinLatch::ScopedSpinLatch guard(&tuple_slot_map_latch_);
     tuple_slot_map_[old_tuple_slot] = new_tuple_slot;
   } else {
-    auto new_tuple_slot = tuple_slot_map_[redo_record->GetTupleSlot()];
+    auto new_tuple_slot = GetTupleSlotMapping(redo_record->GetTupleSlot());
     redo_record->SetTupleSlot(new_tuple_slot);
     // Stage the write. This way the recovery operation is logged if logging is enabled
     auto staged_record = txn->StageRecoveryWrite(record);
@@ -195,7 +311,10 @@ void RecoveryManager::ReplayDeleteRecord(transaction::TransactionContext *txn, L
   UpdateIndexesOnTable(txn, delete_record->GetDatabaseOid(), delete_record->GetTableOid(), sql_table_ptr,
                        new_tuple_slot, pr, false /* delete */);
   // We can delete the TupleSlot from the map
-  tuple_slot_map_.erase(delete_record->GetTupleSlot());
+  {
+    common::SpinLatch::ScopedSpinLatch guard(&tuple_slot_map_latch_);
+    tuple_slot_map_.erase(delete_record->GetTupleSlot());
+  }
   delete[] buffer;
 }
 
@@ -44,6 +44,27 @@ template void StorageUtil::CopyAttrIntoProjection<ProjectedRow>(const TupleAcces
 template void StorageUtil::CopyAttrIntoProjection<ProjectedColumns::RowView>(const TupleAccessStrategy &, TupleSlot,
                                                                              ProjectedColumns::RowView *, uint16_t);
 
+void StorageUtil::CopyColumnIntoProjection(const TupleAccessStrategy &accessor, RawBlock *const block,
+                                           const uint32_t from_offset, ProjectedColumns *const to,
+                                           const uint16_t projection_list_index, const uint32_t to_offset,
+                                           const uint32_t num_tuples) {
+  const col_id_t col_id = to->ColumnIds()[projection_list_index];
+  const uint8_t attr_size = accessor.GetBlockLayout().AttrSize(col_id);
+  std::memcpy(to->ColumnStart(projection_list_index) + attr_size * to_offset,
+              accessor.ColumnStart(block, col_id) + attr_size * from_offset, attr_size * num_tuples);
+
+  // Null bitmaps can be copied byte-wise if both ranges start on a byte boundary, otherwise we have to go bit by bit.
+  const common::RawConcurrentBitmap *from_bitmap = accessor.ColumnNullBitmap(block, col_id);
+  common::RawBitmap *to_bitmap = to->ColumnNullBitmap(projection_list_index);
+  uint32_t copied = 0;
+  if (from_offset % BYTE_SIZE == 0 && to_offset % BYTE_SIZE == 0) {
+    copied = num_tuples - num_tuples % BYTE_SIZE;
+    std::memcpy(reinterpret_cast<byte *>(to_bitmap) + to_offset / BYTE_SIZE,
+                reinterpret_cast<const byte *>(from_bitmap) + from_offset / BYTE_SIZE, copied / BYTE_SIZE);
+  }
+  for (; copied < num_tuples; copied++) to_bitmap->Set(to_offset + copied, from_bitmap->Test(from_offset + copied));
+}
+
 template <class RowType>
 void StorageUtil::CopyAttrFromProjection(const TupleAccessStrategy &accessor, const TupleSlot to, const RowType &from,
                                          const uint16_t projection_list_offset) {
@@ -19,24 +19,43 @@ void DiskLogConsumerTask::Terminate() {
   disk_log_writer_thread_cv_.notify_one();
 }
 
-void DiskLogConsumerTask::WriteBuffersToLogFile() {
+bool DiskLogConsumerTask::WriteBuffersToLogFile() {
+  bool has_commits = false;
   // Persist all the filled buffers to the disk
   SerializedLogs logs;
   while (!filled_buffer_queue_->Empty()) {
     // Dequeue filled buffers and flush them to disk, as well as storing commit callbacks
     filled_buffer_queue_->Dequeue(&logs);
-    current_data_written_ += logs.first->FlushBuffer();
+    uint64_t written;
+    if (segment_writer_ != nullptr) {
+      // Segments reserve their space when they are created
+      written = logs.first->FlushBuffer(segment_writer_);
+    } else {
+      // Reserve space ahead of the writes, so that the file does not have to grow block by block as we persist
+      if (preallocated_bytes_ < common::Constants::LOG_BUFFER_SIZE) {
+        logs.first->Preallocate(LOG_PREALLOCATION_SIZE);
+        preallocated_bytes_ = LOG_PREALLOCATION_SIZE;
+      }
+      written = logs.first->FlushBuffer();
+      preallocated_bytes_ -= written;
+    }
+    current_data_written_ += written;
+    has_commits = has_commits || !logs.second.empty();
     commit_callbacks_.insert(commit_callbacks_.end(), logs.second.begin(), logs.second.end());
     // Enqueue the flushed buffer to the empty buffer queue
     empty_buffer_queue_->Enqueue(logs.first);
   }
+  return has_commits;
 }
 
 uint64_t DiskLogConsumerTask::PersistLogFile() {
   TERRIER_ASSERT(!buffers_->empty(), "Buffers vector should not be empty until Shutdown");
   // Force the buffers to be written to disk. Because all buffers log to the same file, it suffices to call persist on
   // any buffer.
-  buffers_->front().Persist();
+  if (segment_writer_ != nullptr)
+    segment_writer_->Persist();
+  else
+    buffers_->front().Persist();
   const auto num_buffers = commit_callbacks_.size();
   // Execute the callbacks for the transactions that have been persisted
   for (auto &callback : commit_callbacks_) callback.first(callback.second);
@@ -66,21 +85,24 @@ void DiskLogConsumerTask::DiskLogConsumerTaskLoop() {
     }
 
     uint64_t elapsed_us = 0;
+    bool has_commits;
     {
       common::ScopedTimer<std::chrono::microseconds> scoped_timer(&elapsed_us);
       // Flush all the buffers to the log file
-      WriteBuffersToLogFile();
+      has_commits = WriteBuffersToLogFile();
     }
     write_us += elapsed_us;
 
     // We persist the log file if the following conditions are met
-    // 1) The persist interval amount of time has passed since the last persist
-    // 2) We have written more data since the last persist than the threshold
-    // 3) We are signaled to persist
-    // 4) We are shutting down this task
+    // 1) We wrote out commit records, whose transactions are waiting on the persist. Commits that arrive while we
+    // persist pile up in the filled buffer queue, and are persisted together in the next round (group commit).
+    // 2) The persist interval amount of time has passed since the last persist
+    // 3) We have written more data since the last persist than the threshold
+    // 4) We are signaled to persist
+    // 5) We are shutting down this task
     bool timeout = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() -
                                                                          last_persist) > persist_interval_;
-    if (timeout || current_data_written_ > persist_threshold_ || do_persist_ || !run_task_) {
+    if (has_commits || timeout || current_data_written_ > persist_threshold_ || do_persist_ || !run_task_) {
       common::ScopedTimer<std::chrono::microseconds> scoped_timer(&elapsed_us);
       {
         std::unique_lock<std::mutex> lock(persist_lock_);
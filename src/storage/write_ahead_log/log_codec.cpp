@@ -0,0 +1,152 @@
+#include "storage/write_ahead_log/log_codec.h"
+#include <nmmintrin.h>
+#include <algorithm>
+#include <cstring>
+
+namespace terrier::storage {
+
+namespace {
+// Matches are at least this long. This is also the number of bytes hashed to find match candidates.
+constexpr uint32_t MIN_MATCH = 4;
+// The format requires the last bytes of the input to always be literals
+constexpr uint32_t LAST_LITERALS = 5;
+// No match may start within this many bytes of the end of the input
+constexpr uint32_t MATCH_FIND_LIMIT = 12;
+// Matches can only reach back as far as a 16-bit offset allows
+constexpr uint32_t MAX_OFFSET = UINT16_MAX;
+// Length fields that do not fit in the 4 bits of the token continue in extra bytes
+constexpr uint32_t TOKEN_LENGTH_MASK = 15;
+constexpr uint32_t HASH_BITS = 12;
+
+uint32_t Load32(const byte *ptr) {
+  uint32_t result;
+  std::memcpy(&result, ptr, sizeof(uint32_t));
+  return result;
+}
+
+uint32_t HashSequence(const uint32_t sequence) { return (sequence * 2654435761U) >> (32 - HASH_BITS); }
+
+// Writes a length that did not fit in the token as a sequence of 255s followed by the remainder
+byte *WriteExtraLength(byte *out, uint32_t length) {
+  for (; length >= 255; length -= 255) *out++ = static_cast<byte>(255);
+  *out++ = static_cast<byte>(length);
+  return out;
+}
+
+// Writes a sequence of literals followed by a match. A match length of 0 means the literals are the last sequence.
+bool WriteSequence(byte **out, const byte *const out_end, const byte *literals, const uint32_t num_literals,
+                   const uint32_t offset, const uint32_t match_length) {
+  // Token, extra length bytes for literals and matches, the literals themselves and the match offset
+  const uint64_t worst_case = 1 + (num_literals / 255 + 1) + num_literals + 2 + (match_length / 255 + 1);
+  if (static_cast<uint64_t>(out_end - *out) < worst_case) return false;
+
+  byte *token = (*out)++;
+  const uint32_t literal_bits = std::min(num_literals, TOKEN_LENGTH_MASK);
+  if (num_literals >= TOKEN_LENGTH_MASK) *out = WriteExtraLength(*out, num_literals - TOKEN_LENGTH_MASK);
+  std::memcpy(*out, literals, num_literals);
+  *out += num_literals;
+  if (match_length == 0) {
+    *token = static_cast<byte>(literal_bits << 4U);
+    return true;
+  }
+
+  (*out)[0] = static_cast<byte>(offset & 0xFFU);
+  (*out)[1] = static_cast<byte>(offset >> 8U);
+  *out += 2;
+  const uint32_t match_bits = std::min(match_length - MIN_MATCH, TOKEN_LENGTH_MASK);
+  if (match_length - MIN_MATCH >= TOKEN_LENGTH_MASK)
+    *out = WriteExtraLength(*out, match_length - MIN_MATCH - TOKEN_LENGTH_MASK);
+  *token = static_cast<byte>((literal_bits << 4U) | match_bits);
+  return true;
+}
+
+// Reads the remainder of a length that did not fit in the token
+bool ReadExtraLength(const byte **in, const byte *const in_end, uint32_t *length) {
+  uint8_t next;
+  do {
+    if (*in == in_end) return false;
+    next = static_cast<uint8_t>(*(*in)++);
+    *length += next;
+  } while (next == 255);
+  return true;
+}
+}  // namespace
+
+uint32_t LogCodec::Compress(const byte *const src, const uint32_t size, byte *const dst, const uint32_t capacity) {
+  // Last position seen for every hash of 4 bytes. Candidates are verified, so stale or colliding entries are harmless.
+  uint32_t positions[1U << HASH_BITS] = {};
+  byte *out = dst;
+  const byte *const out_end = dst + capacity;
+  uint32_t anchor = 0;  // start of the literals not yet written out
+
+  if (size > MATCH_FIND_LIMIT) {
+    uint32_t pos = 0;
+    while (pos + MATCH_FIND_LIMIT < size) {
+      const uint32_t sequence = Load32(src + pos);
+      const uint32_t hash = HashSequence(sequence);
+      const uint32_t candidate = positions[hash];
+      positions[hash] = pos;
+      if (candidate >= pos || pos - candidate > MAX_OFFSET || Load32(src + candidate) != sequence) {
+        pos++;
+        continue;
+      }
+
+      uint32_t match_length = MIN_MATCH;
+      while (pos + match_length < size - LAST_LITERALS && src[candidate + match_length] == src[pos + match_length])
+        match_length++;
+      if (!WriteSequence(&out, out_end, src + anchor, pos - anchor, pos - candidate, match_length)) return 0;
+      pos += match_length;
+      anchor = pos;
+    }
+  }
+
+  if (!WriteSequence(&out, out_end, src + anchor, size - anchor, 0, 0)) return 0;
+  return static_cast<uint32_t>(out - dst);
+}
+
+bool LogCodec::Decompress(const byte *const src, const uint32_t size, byte *const dst, const uint32_t raw_size) {
+  const byte *in = src;
+  const byte *const in_end = src + size;
+  byte *out = dst;
+  byte *const out_end = dst + raw_size;
+
+  while (in < in_end) {
+    const auto token = static_cast<uint8_t>(*in++);
+    uint32_t num_literals = token >> 4U;
+    if (num_literals == TOKEN_LENGTH_MASK && !ReadExtraLength(&in, in_end, &num_literals)) return false;
+    if (num_literals > static_cast<uint64_t>(in_end - in) || num_literals > static_cast<uint64_t>(out_end - out))
+      return false;
+    std::memcpy(out, in, num_literals);
+    in += num_literals;
+    out += num_literals;
+    // The last sequence has no match
+    if (in == in_end) break;
+
+    if (in_end - in < 2) return false;
+    const uint32_t offset = static_cast<uint8_t>(in[0]) | (static_cast<uint32_t>(static_cast<uint8_t>(in[1])) << 8U);
+    in += 2;
+    if (offset == 0 || offset > static_cast<uint64_t>(out - dst)) return false;
+    uint32_t match_length = token & TOKEN_LENGTH_MASK;
+    if (match_length == TOKEN_LENGTH_MASK && !ReadExtraLength(&in, in_end, &match_length)) return false;
+    match_length += MIN_MATCH;
+    if (match_length > static_cast<uint64_t>(out_end - out)) return false;
+    // Matches can overlap with the bytes they produce, so they have to be copied forward one byte at a time
+    const byte *match = out - offset;
+    for (uint32_t i = 0; i < match_length; i++) out[i] = match[i];
+    out += match_length;
+  }
+  return out == out_end;
+}
+
+uint32_t LogCodec::Checksum(const void *const data, uint64_t size) {
+  const auto *bytes = reinterpret_cast<const uint8_t *>(data);
+  uint64_t crc = UINT32_MAX;
+  for (; size >= sizeof(uint64_t); size -= sizeof(uint64_t), bytes += sizeof(uint64_t)) {
+    uint64_t word;
+    std::memcpy(&word, bytes, sizeof(uint64_t));
+    crc = _mm_crc32_u64(crc, word);
+  }
+  for (; size > 0; size--, bytes++) crc = _mm_crc32_u8(static_cast<uint32_t>(crc), *bytes);
+  return ~static_cast<uint32_t>(crc);
+}
+}  // namespace terrier::storage
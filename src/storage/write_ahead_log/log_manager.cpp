@@ -8,23 +8,34 @@ void LogManager::Start() {
   TERRIER_ASSERT(!run_log_manager_, "Can't call Start on already started LogManager");
   // Initialize buffers for logging
   for (size_t i = 0; i < num_buffers_; i++) {
-    buffers_.emplace_back(BufferedLogWriter(log_file_path_.c_str()));
+    AddBuffer();
   }
   for (size_t i = 0; i < num_buffers_; i++) {
     empty_buffer_queue_.Enqueue(&buffers_[i]);
   }
+  // New records are appended to the log, so serialized bytes will start going at the current end of the log
+  uint64_t log_end_offset;
+  if (UseSegments()) {
+    segment_writer_ = std::make_unique<LogSegmentWriter>(log_file_path_, segment_size_, compress_log_);
+    log_end_offset = segment_writer_->EndOffset();
+  } else {
+    struct stat log_file_stat;
+    if (stat(log_file_path_.c_str(), &log_file_stat) == -1)
+      throw std::runtime_error("Failed to stat log file with errno " + std::to_string(errno));
+    log_end_offset = static_cast<uint64_t>(log_file_stat.st_size);
+  }
 
   run_log_manager_ = true;
 
   // Register DiskLogConsumerTask
   disk_log_writer_task_ = thread_registry_->RegisterDedicatedThread<DiskLogConsumerTask>(
       this /* requester */, persist_interval_, persist_threshold_, &buffers_, &empty_buffer_queue_,
-      &filled_buffer_queue_);
+      &filled_buffer_queue_, segment_writer_.get());
 
   // Register LogSerializerTask
   log_serializer_task_ = thread_registry_->RegisterDedicatedThread<LogSerializerTask>(
       this /* requester */, serialization_interval_, buffer_pool_, &empty_buffer_queue_, &filled_buffer_queue_,
-      &disk_log_writer_task_->disk_log_writer_thread_cv_);
+      &disk_log_writer_task_->disk_log_writer_thread_cv_, log_end_offset);
 }
 
 void LogManager::ForceFlush() {
@@ -62,11 +73,38 @@ void LogManager::PersistAndStop() {
   empty_buffer_queue_.Clear();
   filled_buffer_queue_.Clear();
   buffers_.clear();
+  segment_writer_.reset();
+}
+
+void LogManager::TruncateLog(const uint64_t offset) {
+  if (UseSegments()) {
+    TERRIER_ASSERT(run_log_manager_, "Segments can only be removed while the log manager is running");
+    segment_writer_->RemoveSegmentsBefore(offset);
+    return;
+  }
+#if __APPLE__
+  // There is no portable way to punch a hole into a file on macOS, so the log is left as it is
+  STORAGE_LOG_DEBUG("Log truncation is not supported on this platform, ignoring truncation up to {}", offset);
+#else
+  int fd = PosixIoWrappers::Open(log_file_path_.c_str(), O_WRONLY);
+  // Punching a hole keeps the file size, and with it the offsets of everything after, intact
+  if (fallocate(fd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE, 0, static_cast<off_t>(offset)) == -1) {
+    const int error = errno;
+    PosixIoWrappers::Close(fd);
+    // Not every file system can do this, in which case the log simply keeps its size
+    if (error == EOPNOTSUPP) {
+      STORAGE_LOG_WARN("File system does not support punching holes, log file {} is not truncated", log_file_path_);
+      return;
+    }
+    throw std::runtime_error("Failed to truncate log file with errno " + std::to_string(error));
+  }
+  PosixIoWrappers::Close(fd);
+#endif
 }
 
-void LogManager::AddBufferToFlushQueue(RecordBufferSegment *const buffer_segment) {
+void LogManager::AddBufferToFlushQueue(RecordBufferSegment *const buffer_segment, const bool ends_txn) {
   TERRIER_ASSERT(run_log_manager_, "Must call Start on log manager before handing it buffers");
-  log_serializer_task_->AddBufferToFlushQueue(buffer_segment);
+  log_serializer_task_->AddBufferToFlushQueue(buffer_segment, ends_txn);
 }
 
 }  // namespace terrier::storage
@@ -0,0 +1,245 @@
+#include "storage/write_ahead_log/log_segment.h"
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include "loggers/storage_logger.h"
+#include "storage/write_ahead_log/log_codec.h"
+#include "storage/write_ahead_log/log_io.h"
+
+namespace terrier::storage {
+
+namespace {
+// Splits a path into the directory it is in and the file name
+std::pair<std::string, std::string> SplitPath(const std::string &path) {
+  const auto slash = path.find_last_of('/');
+  if (slash == std::string::npos) return {".", path};
+  return {slash == 0 ? "/" : path.substr(0, slash), path.substr(slash + 1)};
+}
+
+uint32_t HeaderChecksum(LogSegmentHeader header) {
+  header.checksum_ = 0;
+  return LogCodec::Checksum(&header, sizeof(LogSegmentHeader));
+}
+
+uint32_t HeaderChecksum(const LogFrameHeader &header) {
+  return LogCodec::Checksum(&header, offsetof(LogFrameHeader, header_checksum_));
+}
+
+// Reads the header of a segment. Returns false if the segment does not start with a valid header.
+bool ReadSegmentHeader(const int fd, LogSegmentHeader *const header) {
+  return PosixIoWrappers::ReadFully(fd, header, sizeof(LogSegmentHeader)) == sizeof(LogSegmentHeader) &&
+         header->magic_ == LogSegmentHeader::MAGIC && header->version_ == LogSegmentHeader::VERSION &&
+         header->checksum_ == HeaderChecksum(*header);
+}
+
+// Reads the next frame of a segment, leaving its stored bytes in the given buffer. Returns false at the end of the
+// segment, or if the frame is torn or corrupted.
+bool ReadFrameHeaderAndBytes(const int fd, LogFrameHeader *const header, std::vector<byte> *const stored) {
+  if (PosixIoWrappers::ReadFully(fd, header, sizeof(LogFrameHeader)) != sizeof(LogFrameHeader)) return false;
+  if (header->header_checksum_ != HeaderChecksum(*header)) return false;
+  stored->resize(header->stored_size_);
+  if (PosixIoWrappers::ReadFully(fd, stored->data(), header->stored_size_) != header->stored_size_) return false;
+  return header->checksum_ == LogCodec::Checksum(stored->data(), header->stored_size_);
+}
+
+void PersistFd(const int fd) {
+#ifdef __APPLE__
+  if (fsync(fd) == -1) throw std::runtime_error("fsync failed with errno " + std::to_string(errno));
+#else
+  if (fdatasync(fd) == -1) throw std::runtime_error("fdatasync failed with errno " + std::to_string(errno));
+#endif
+}
+}  // namespace
+
+LogSegmentWriter::LogSegmentWriter(std::string log_file_path, const uint64_t segment_size, const bool compress)
+    : log_file_path_(std::move(log_file_path)), segment_size_(segment_size), compress_(compress) {
+  // Find out where the log left off. Only the valid frames of the last segment count, anything after them was torn.
+  for (const auto &segment : ListSegments(log_file_path_)) {
+    sequence_number_ = segment.first;
+    int fd = PosixIoWrappers::Open(segment.second.c_str(), O_RDONLY);
+    LogSegmentHeader header;
+    if (ReadSegmentHeader(fd, &header)) {
+      segments_[segment.first] = header.start_offset_;
+      end_offset_ = header.start_offset_;
+      LogFrameHeader frame_header;
+      while (ReadFrameHeaderAndBytes(fd, &frame_header, &frame_)) end_offset_ += frame_header.raw_size_;
+    }
+    PosixIoWrappers::Close(fd);
+  }
+  StartSegment();
+}
+
+LogSegmentWriter::~LogSegmentWriter() { PosixIoWrappers::Close(out_); }
+
+void LogSegmentWriter::Append(const byte *const data, const uint32_t size) {
+  frame_.resize(sizeof(LogFrameHeader) + std::max(LogCodec::CompressBound(size), size));
+  byte *const stored = frame_.data() + sizeof(LogFrameHeader);
+  // Only keep the compressed bytes if compressing actually saved space
+  uint32_t stored_size = compress_ && size > 0 ? LogCodec::Compress(data, size, stored, size - 1) : 0;
+  if (stored_size == 0) {
+    std::memcpy(stored, data, size);
+    stored_size = size;
+  }
+  LogFrameHeader header{size, stored_size, LogCodec::Checksum(stored, stored_size), 0};
+  header.header_checksum_ = HeaderChecksum(header);
+  std::memcpy(frame_.data(), &header, sizeof(LogFrameHeader));
+
+  const uint64_t frame_size = sizeof(LogFrameHeader) + stored_size;
+  if (segment_size_ != 0 && segment_bytes_ > sizeof(LogSegmentHeader) && segment_bytes_ + frame_size > segment_size_) {
+    // The old segment will not be written to again, so it has to be durable before anything in the new one is
+    PersistFd(out_);
+    PosixIoWrappers::Close(out_);
+    StartSegment();
+  }
+  PosixIoWrappers::WriteFully(out_, frame_.data(), frame_size);
+  segment_bytes_ += frame_size;
+  end_offset_ += size;
+}
+
+void LogSegmentWriter::Persist() { PersistFd(out_); }
+
+void LogSegmentWriter::RemoveSegmentsBefore(const uint64_t offset) {
+  std::vector<uint64_t> removed;
+  {
+    common::SpinLatch::ScopedSpinLatch guard(&segments_latch_);
+    // A segment ends where the next one starts, and the current segment has no next one
+    for (auto it = segments_.begin(); it != segments_.end() && std::next(it) != segments_.end(); it++) {
+      if (std::next(it)->second > offset) break;
+      removed.push_back(it->first);
+    }
+    for (const auto sequence_number : removed) segments_.erase(sequence_number);
+  }
+  for (const auto sequence_number : removed) unlink(SegmentPath(log_file_path_, sequence_number).c_str());
+}
+
+std::vector<std::pair<uint64_t, std::string>> LogSegmentWriter::ListSegments(const std::string &log_file_path) {
+  const auto path = SplitPath(log_file_path);
+  const std::string prefix = path.second + ".";
+  std::vector<std::pair<uint64_t, std::string>> result;
+  DIR *dir = opendir(path.first.c_str());
+  if (dir == nullptr) return result;
+  for (struct dirent *entry = readdir(dir); entry != nullptr; entry = readdir(dir)) {
+    const std::string name(entry->d_name);
+    if (name.size() <= prefix.size() || name.compare(0, prefix.size(), prefix) != 0) continue;
+    const std::string suffix = name.substr(prefix.size());
+    if (suffix.find_first_not_of("0123456789") != std::string::npos) continue;
+    const uint64_t sequence_number = std::stoull(suffix);
+    result.emplace_back(sequence_number, SegmentPath(log_file_path, sequence_number));
+  }
+  closedir(dir);
+  std::sort(result.begin(), result.end());
+  return result;
+}
+
+std::string LogSegmentWriter::SegmentPath(const std::string &log_file_path, const uint64_t sequence_number) {
+  return log_file_path + "." + std::to_string(sequence_number);
+}
+
+void LogSegmentWriter::StartSegment() {
+  sequence_number_++;
+  const std::string path = SegmentPath(log_file_path_, sequence_number_);
+  out_ = PosixIoWrappers::Open(path.c_str(), O_WRONLY | O_APPEND | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
+#ifndef __APPLE__
+  // Reserve the whole segment up front. Not every file system supports this, but it is only an optimization.
+  if (segment_size_ != 0 && fallocate(out_, FALLOC_FL_KEEP_SIZE, 0, static_cast<off_t>(segment_size_)) == -1 &&
+      errno != EOPNOTSUPP)
+    throw std::runtime_error("fallocate failed with errno " + std::to_string(errno));
+#endif
+
+  LogSegmentHeader header{LogSegmentHeader::MAGIC, LogSegmentHeader::VERSION, 0, sequence_number_, end_offset_};
+  header.checksum_ = HeaderChecksum(header);
+  PosixIoWrappers::WriteFully(out_, &header, sizeof(LogSegmentHeader));
+  segment_bytes_ = sizeof(LogSegmentHeader);
+
+  // Make sure the new segment can be found after a crash
+  PersistFd(out_);
+  int dir_fd = PosixIoWrappers::Open(SplitPath(log_file_path_).first.c_str(), O_RDONLY);
+  if (fsync(dir_fd) == -1) throw std::runtime_error("fsync failed with errno " + std::to_string(errno));
+  PosixIoWrappers::Close(dir_fd);
+
+  common::SpinLatch::ScopedSpinLatch guard(&segments_latch_);
+  segments_[sequence_number_] = end_offset_;
+}
+
+LogSegmentReader::LogSegmentReader(const std::string &log_file_path, const uint64_t offset) : skip_(0) {
+  // Start from the last segment that begins at or before the offset
+  for (const auto &segment : LogSegmentWriter::ListSegments(log_file_path)) {
+    int fd = PosixIoWrappers::Open(segment.second.c_str(), O_RDONLY);
+    LogSegmentHeader header;
+    const bool valid = ReadSegmentHeader(fd, &header);
+    PosixIoWrappers::Close(fd);
+    if (!valid) {
+      STORAGE_LOG_WARN("Skipping log segment {} with a corrupted header", segment.second);
+      continue;
+    }
+    if (header.start_offset_ <= offset) {
+      segments_.clear();
+      skip_ = offset - header.start_offset_;
+    }
+    segments_.push_back(segment);
+  }
+}
+
+LogSegmentReader::~LogSegmentReader() {
+  if (in_ != -1) PosixIoWrappers::Close(in_);
+}
+
+bool LogSegmentReader::HasMore() {
+  while (frame_head_ == frame_.size()) {
+    if (!ReadFrame()) return false;
+  }
+  return true;
+}
+
+bool LogSegmentReader::Read(void *const dest, const uint32_t size) {
+  uint32_t bytes_read = 0;
+  while (bytes_read < size) {
+    if (!HasMore()) return false;
+    const auto read_size = std::min(size - bytes_read, static_cast<uint32_t>(frame_.size()) - frame_head_);
+    std::memcpy(reinterpret_cast<byte *>(dest) + bytes_read, frame_.data() + frame_head_, read_size);
+    frame_head_ += read_size;
+    bytes_read += read_size;
+  }
+  return true;
+}
+
+bool LogSegmentReader::OpenNextSegment() {
+  if (in_ != -1) PosixIoWrappers::Close(in_);
+  in_ = -1;
+  if (next_segment_ == segments_.size()) return false;
+  const auto &path = segments_[next_segment_++].second;
+  in_ = PosixIoWrappers::Open(path.c_str(), O_RDONLY);
+  LogSegmentHeader header;
+  if (!ReadSegmentHeader(in_, &header)) throw std::runtime_error("Log segment " + path + " changed while reading it");
+  return true;
+}
+
+bool LogSegmentReader::ReadFrame() {
+  LogFrameHeader header;
+  while (in_ == -1 || !ReadFrameHeaderAndBytes(in_, &header, &stored_)) {
+    if (!OpenNextSegment()) return false;
+  }
+
+  frame_.resize(header.raw_size_);
+  if (header.stored_size_ == header.raw_size_) {
+    std::memcpy(frame_.data(), stored_.data(), header.raw_size_);
+  } else if (!LogCodec::Decompress(stored_.data(), header.stored_size_, frame_.data(), header.raw_size_)) {
+    throw std::runtime_error("Failed to decompress log frame with a valid checksum");
+  }
+
+  // Skip over anything before the offset reading started at
+  const auto skipped = static_cast<uint32_t>(std::min<uint64_t>(skip_, header.raw_size_));
+  frame_head_ = skipped;
+  skip_ -= skipped;
+  return true;
+}
+}  // namespace terrier::storage
@@ -1,5 +1,6 @@
 #include "storage/write_ahead_log/log_serializer_task.h"
 #include <algorithm>
+#include <mutex>  // NOLINT
 #include <queue>
 #include <utility>
 #include <vector>
@@ -18,13 +19,21 @@ void LogSerializerTask::LogSerializerTaskLoop() {
       serialization_interval_ * (1u << 10u);  // We cap the back-off in case of long gaps with no transactions
   do {
     // Serializing is now on the "critical txn path" because txns wait to commit until their logs are serialized. Thus,
-    // a sleep is not fast enough. We perform exponential back-off, doubling the sleep duration if we don't process any
-    // buffers in our call to Process. Calls to Process will process as long as new buffers are available.
-    std::this_thread::sleep_for(curr_sleep);
+    // transactions handing over their commit or abort record wake us up, and we serialize it right away. Buffers that
+    // fill up while their transaction runs are only polled for: we perform exponential back-off, doubling the sleep
+    // duration if we don't process any buffers in our call to Process. Calls to Process will process as long as new
+    // buffers are available.
+    bool woken_up;
+    {
+      std::unique_lock<std::mutex> lock(wake_up_latch_);
+      wake_up_cv_.wait_for(lock, curr_sleep, [&] { return wake_up_ || !run_task_; });
+      woken_up = wake_up_;
+      wake_up_ = false;
+    }
     // If Process did not find any new buffers, we perform exponential back-off to reduce our rate of polling for new
     // buffers. We cap the maximum back-off, since in the case of large gaps of no txns, we don't want to unboundedly
-    // sleep
-    curr_sleep = std::min(Process() ? serialization_interval_ : curr_sleep * 2, max_sleep);
+    // sleep. Being woken up resets the back-off, even if a ForceFlush serialized the buffer before us.
+    curr_sleep = std::min(Process() || woken_up ? serialization_interval_ : curr_sleep * 2, max_sleep);
   } while (run_task_);
   // To be extra sure we processed everything
   Process();
@@ -75,8 +84,7 @@ bool LogSerializerTask::Process() {
     // Mark the last buffer that was written to as full
     if (filled_buffer_ != nullptr) HandFilledBufferToWriter();
 
-    // Bulk remove all the transactions we serialized. This prevents having to take the TimestampManager's latch once
-    // for each timestamp we remove.
+    // Remove all the transactions we serialized from the active txn set, now that the GC is free to clean them up
     for (const auto &txns : serialized_txns_) {
       txns.first->RemoveTransactions(txns.second);
     }
@@ -116,6 +124,8 @@ void LogSerializerTask::HandFilledBufferToWriter() {
 std::pair<uint64_t, uint64_t> LogSerializerTask::SerializeBuffer(
     IterableBufferSegment<LogRecord> *buffer_to_serialize) {
   uint64_t num_bytes = 0, num_records = 0;
+  // All records in a buffer segment usually come from the same transaction, so only look it up when it changes
+  transaction::timestamp_t last_txn = transaction::INVALID_TXN_TIMESTAMP;
 
   // Iterate over all redo records in the redo buffer through the provided iterator
   for (LogRecord &record : *buffer_to_serialize) {
@@ -127,6 +137,7 @@ std::pair<uint64_t, uint64_t> LogSerializerTask::SerializeBuffer(
         // necessary for the transaction's callback function to be invoked, but there is no need to serialize it, as
         // it corresponds to a transaction with nothing to redo.
         if (!commit_record->IsReadOnly()) num_bytes += SerializeRecord(record);
+        unfinished_txns_.erase(record.TxnBegin());
         commits_in_buffer_.emplace_back(commit_record->CommitCallback(), commit_record->CommitCallbackArg());
         // Once serialization is done, we notify the txn manager to let GC know this txn is ready to clean up
         serialized_txns_[commit_record->TimestampManager()].push_back(record.TxnBegin());
@@ -136,12 +147,18 @@ std::pair<uint64_t, uint64_t> LogSerializerTask::SerializeBuffer(
       case (LogRecordType::ABORT): {
         // If an abort record shows up at all, the transaction cannot be read-only
         num_bytes += SerializeRecord(record);
+        unfinished_txns_.erase(record.TxnBegin());
         auto *abord_record = record.GetUnderlyingRecordBodyAs<AbortRecord>();
         serialized_txns_[abord_record->TimestampManager()].push_back(record.TxnBegin());
         break;
       }
 
       default:
+        if (record.TxnBegin() != last_txn) {
+          // Remember where the transaction's first record went in the log file, unless we have seen it before
+          unfinished_txns_.emplace(record.TxnBegin(), log_file_offset_);
+          last_txn = record.TxnBegin();
+        }
         // Any record that is not a commit record is always serialized.`
         num_bytes += SerializeRecord(record);
     }
@@ -152,101 +169,14 @@ std::pair<uint64_t, uint64_t> LogSerializerTask::SerializeBuffer(
 }
 
 uint64_t LogSerializerTask::SerializeRecord(const terrier::storage::LogRecord &record) {
-  uint64_t num_bytes = 0;
-  // First, serialize out fields common across all LogRecordType's.
-
-  // Note: This is the in-memory size of the log record itself, i.e. inclusive of padding and not considering the size
-  // of any potential varlen entries. It is logically different from the size of the serialized record, which the log
-  // manager generates in this function. In particular, the later value is very likely to be strictly smaller when the
-  // LogRecordType is REDO. On recovery, the goal is to turn the serialized format back into an in-memory log record of
-  // this size.
-  num_bytes += WriteValue(record.Size());
-
-  num_bytes += WriteValue(record.RecordType());
-  num_bytes += WriteValue(record.TxnBegin());
-
-  switch (record.RecordType()) {
-    case LogRecordType::REDO: {
-      auto *record_body = record.GetUnderlyingRecordBodyAs<RedoRecord>();
-      num_bytes += WriteValue(record_body->GetDatabaseOid());
-      num_bytes += WriteValue(record_body->GetTableOid());
-      num_bytes += WriteValue(record_body->GetTupleSlot());
-
-      auto *delta = record_body->Delta();
-      // Write out which column ids this redo record is concerned with. On recovery, we can construct the appropriate
-      // ProjectedRowInitializer from these ids and their corresponding block layout.
-      num_bytes += WriteValue(delta->NumColumns());
-      num_bytes += WriteValue(delta->ColumnIds(), static_cast<uint32_t>(sizeof(col_id_t)) * delta->NumColumns());
-
-      // Write out the attr sizes boundaries, this way we can deserialize the records without the need of the block
-      // layout
-      const auto &block_layout = record_body->GetTupleSlot().GetBlock()->data_table_->GetBlockLayout();
-      uint16_t boundaries[NUM_ATTR_BOUNDARIES];
-      memset(boundaries, 0, sizeof(uint16_t) * NUM_ATTR_BOUNDARIES);
-      StorageUtil::ComputeAttributeSizeBoundaries(block_layout, delta->ColumnIds(), delta->NumColumns(), boundaries);
-      WriteValue(boundaries, sizeof(uint16_t) * NUM_ATTR_BOUNDARIES);
-
-      // Write out the null bitmap.
-      num_bytes += WriteValue(&(delta->Bitmap()), common::RawBitmap::SizeInBytes(delta->NumColumns()));
-
-      // Write out attribute values
-      for (uint16_t i = 0; i < delta->NumColumns(); i++) {
-        const auto *column_value_address = delta->AccessWithNullCheck(i);
-        if (column_value_address == nullptr) {
-          // If the column in this REDO record is null, then there's nothing to serialize out. The bitmap contains all
-          // the relevant information.
-          continue;
-        }
-        // Get the column id of the current column in the ProjectedRow.
-        col_id_t col_id = delta->ColumnIds()[i];
-
-        if (block_layout.IsVarlen(col_id)) {
-          // Inline column value is a pointer to a VarlenEntry, so reinterpret as such.
-          const auto *varlen_entry = reinterpret_cast<const VarlenEntry *>(column_value_address);
-          // Serialize out length of the varlen entry.
-          num_bytes += WriteValue(varlen_entry->Size());
-          if (varlen_entry->IsInlined()) {
-            // Serialize out the prefix of the varlen entry.
-            num_bytes += WriteValue(varlen_entry->Prefix(), varlen_entry->Size());
-          } else {
-            // Serialize out the content field of the varlen entry.
-            num_bytes += WriteValue(varlen_entry->Content(), varlen_entry->Size());
-          }
-        } else {
-          // Inline column value is the actual data we want to serialize out.
-          // Note that by writing out AttrSize(col_id) bytes instead of just the difference between successive offsets
-          // of the delta record, we avoid serializing out any potential padding.
-          num_bytes += WriteValue(column_value_address, block_layout.AttrSize(col_id));
-        }
-      }
-      break;
-    }
-    case LogRecordType::DELETE: {
-      auto *record_body = record.GetUnderlyingRecordBodyAs<DeleteRecord>();
-      num_bytes += WriteValue(record_body->GetDatabaseOid());
-      num_bytes += WriteValue(record_body->GetTableOid());
-      num_bytes += WriteValue(record_body->GetTupleSlot());
-      break;
-    }
-    case LogRecordType::COMMIT: {
-      auto *record_body = record.GetUnderlyingRecordBodyAs<CommitRecord>();
-      num_bytes += WriteValue(record_body->CommitTime());
-      num_bytes += WriteValue(record_body->OldestActiveTxn());
-      break;
-    }
-    case LogRecordType::ABORT: {
-      // AbortRecord does not hold any additional metadata
-      break;
-    }
-  }
-
-  return num_bytes;
+  return SerializeRecord(record, [this](const void *val, uint32_t size) { return WriteValue(val, size); });
 }
 
 uint32_t LogSerializerTask::WriteValue(const void *val, const uint32_t size) {
   // Serialize the value and copy it to the buffer
   BufferedLogWriter *out = GetCurrentWriteBuffer();
   uint32_t size_written = 0;
+  log_file_offset_ += size;
 
   while (size_written < size) {
     const byte *val_byte = reinterpret_cast<const byte *>(val) + size_written;
@@ -1,31 +1,129 @@
 #include "transaction/timestamp_manager.h"
 #include <algorithm>
+#include <thread>  // NOLINT
 #include <vector>
 
 namespace terrier::transaction {
 
+namespace {
+// Scatters consecutive timestamps over the table, so that transactions beginning at the same time do not share lines
+uint64_t SlotHash(const timestamp_t timestamp) { return (!timestamp * 0x9E3779B97F4A7C15ULL) >> 32U; }
+
+// Every thread starts probing for a free slot at its own position, so that threads rarely compete for a slot
+uint32_t ThreadSlot() {
+  static std::atomic<uint32_t> next_thread_slot{0};
+  static thread_local const uint32_t thread_slot = next_thread_slot++;
+  return thread_slot;
+}
+}  // namespace
+
+TimestampManager::~TimestampManager() {
+  ActiveTxnTable *table = active_txns_.next_.load();
+  while (table != nullptr) {
+    ActiveTxnTable *next = table->next_.load();
+    delete table;
+    table = next;
+  }
+}
+
+timestamp_t TimestampManager::BeginTransaction() {
+  // Announce a start time no later than the one we are about to check out. OldestTransactionStartTime reads the
+  // current time before it scans, so if it misses the announcement, it is guaranteed to return a time no later than
+  // our start time anyways.
+  std::atomic<timestamp_t> *begin_slot;
+  for (uint32_t i = ThreadSlot();; i++) {
+    begin_slot = &begin_slots_[i % NUM_BEGIN_SLOTS].timestamp_;
+    timestamp_t expected = EMPTY_SLOT;
+    if (begin_slot->load() == EMPTY_SLOT && begin_slot->compare_exchange_strong(expected, time_.load())) break;
+  }
+
+  const timestamp_t start_time = CheckOutTimestamp();
+  InsertActiveTransaction(start_time);
+  begin_slot->store(EMPTY_SLOT);
+  return start_time;
+}
+
+timestamp_t TimestampManager::BatchedCheckOutTimestamp() {
+  std::atomic<timestamp_t> *request;
+  for (uint32_t i = ThreadSlot();; i++) {
+    request = &checkout_slots_[i % NUM_CHECKOUT_SLOTS].timestamp_;
+    timestamp_t expected = EMPTY_SLOT;
+    if (request->load() == EMPTY_SLOT && request->compare_exchange_strong(expected, REQUESTED_SLOT)) break;
+  }
+  // Either serve the batch our request is in, or wait for whoever does. A request is only ever served by an increment
+  // of the clock that happens after it is posted, so the timestamp is still later than any checked out before this
+  // call, which is all snapshot isolation needs.
+  for (uint32_t attempt = 1; request->load() == REQUESTED_SLOT; attempt++) {
+    if (checkout_latch_.TryLock()) {
+      if (request->load() == REQUESTED_SLOT) ServeCheckOutRequests();
+      checkout_latch_.Unlock();
+    } else if (attempt % MAX_CHECKOUT_SPINS == 0) {
+      // Whoever holds the latch might not be running
+      std::this_thread::yield();
+    }
+  }
+  const timestamp_t result = request->load();
+  request->store(EMPTY_SLOT);
+  return result;
+}
+
+void TimestampManager::ServeCheckOutRequests() {
+  // Only the latch holder hands out timestamps, so requests seen here stay pending until we serve them
+  std::atomic<timestamp_t> *pending[NUM_CHECKOUT_SLOTS];
+  uint32_t num_pending = 0;
+  for (auto &slot : checkout_slots_)
+    if (slot.timestamp_.load() == REQUESTED_SLOT) pending[num_pending++] = &slot.timestamp_;
+  timestamp_t next = time_.fetch_add(num_pending);
+  for (uint32_t i = 0; i < num_pending; i++) pending[i]->store(next++);
+}
+
+void TimestampManager::InsertActiveTransaction(const timestamp_t start_time) {
+  const uint64_t hash = SlotHash(start_time);
+  for (ActiveTxnTable *table = &active_txns_;; table = table->next_.load()) {
+    for (uint32_t i = 0; i < PROBE_LIMIT; i++) {
+      auto &slot = table->slots_[(hash + i) & (table->size_ - 1)];
+      timestamp_t expected = EMPTY_SLOT;
+      if (slot.load() == EMPTY_SLOT && slot.compare_exchange_strong(expected, start_time)) return;
+    }
+    // No room in this table, so move on to the next one, adding it if this is the last table
+    if (table->next_.load() == nullptr) {
+      common::SpinLatch::ScopedSpinLatch guard(&tables_latch_);
+      if (table->next_.load() == nullptr) table->next_.store(new ActiveTxnTable(2 * table->size_));
+    }
+  }
+}
+
 timestamp_t TimestampManager::OldestTransactionStartTime() {
-  common::SpinLatch::ScopedSpinLatch guard(&curr_running_txns_latch_);
-  const auto &oldest_txn = std::min_element(curr_running_txns_.cbegin(), curr_running_txns_.cend());
-  timestamp_t result = (oldest_txn != curr_running_txns_.end()) ? *oldest_txn : time_.load();
+  // The order matters here: the current time first, then the announcements of beginning transactions, then the tables.
+  // A transaction only stops announcing itself once its start time is in the tables.
+  timestamp_t result = time_.load();
+  for (auto &begin_slot : begin_slots_) result = std::min(result, begin_slot.timestamp_.load());
+  for (ActiveTxnTable *table = &active_txns_; table != nullptr; table = table->next_.load()) {
+    for (uint32_t i = 0; i < table->size_; i++) result = std::min(result, table->slots_[i].load());
+  }
   cached_oldest_txn_start_time_.store(result);  // Cache the timestamp
   return result;
 }
 
 timestamp_t TimestampManager::CachedOldestTransactionStartTime() { return cached_oldest_txn_start_time_.load(); }
 
-void TimestampManager::RemoveTransaction(timestamp_t timestamp) {
-  common::SpinLatch::ScopedSpinLatch guard(&curr_running_txns_latch_);
-  const size_t ret UNUSED_ATTRIBUTE = curr_running_txns_.erase(timestamp);
-  TERRIER_ASSERT(ret == 1, "erased timestamp did not exist");
+void TimestampManager::RemoveTransaction(const timestamp_t timestamp) {
+  const uint64_t hash = SlotHash(timestamp);
+  for (ActiveTxnTable *table = &active_txns_; table != nullptr; table = table->next_.load()) {
+    for (uint32_t i = 0; i < PROBE_LIMIT; i++) {
+      auto &slot = table->slots_[(hash + i) & (table->size_ - 1)];
+      // Start timestamps are unique, so nobody else can touch a slot holding ours
+      if (slot.load() == timestamp) {
+        slot.store(EMPTY_SLOT);
+        return;
+      }
+    }
+  }
+  TERRIER_ASSERT(false, "erased timestamp did not exist");
 }
 
 void TimestampManager::RemoveTransactions(const std::vector<terrier::transaction::timestamp_t> &timestamps) {
-  common::SpinLatch::ScopedSpinLatch guard(&curr_running_txns_latch_);
-  for (const auto &timestamp : timestamps) {
-    const size_t ret UNUSED_ATTRIBUTE = curr_running_txns_.erase(timestamp);
-    TERRIER_ASSERT(ret == 1, "erased timestamp did not exist");
-  }
+  for (const auto &timestamp : timestamps) RemoveTransaction(timestamp);
 }
 
 }  // namespace terrier::transaction
@@ -6,13 +6,18 @@
 #include "metrics/metrics_store.h"
 
 namespace terrier::transaction {
-TransactionContext *TransactionManager::BeginTransaction() {
+TransactionContext *TransactionManager::BeginTransaction() { return BeginTransaction(false); }
+
+TransactionContext *TransactionManager::BeginReadOnlyTransaction() { return BeginTransaction(true); }
+
+TransactionContext *TransactionManager::BeginTransaction(const bool read_only) {
   uint64_t elapsed_us = 0;
   timestamp_t start_time;
   TransactionContext *result;
   {
+    // Read-only transactions register their start time all the same, as the GC must not reclaim versions they can see
     start_time = timestamp_manager_->BeginTransaction();
-    result = new TransactionContext(start_time, start_time + INT64_MIN, buffer_pool_, log_manager_);
+    result = new TransactionContext(start_time, start_time + INT64_MIN, buffer_pool_, log_manager_, read_only);
     // Ensure we do not return from this function if there are ongoing write commits
     if (common::thread_context.metrics_store_ != nullptr &&
         common::thread_context.metrics_store_->ComponentEnabled(metrics::MetricsComponent::TRANSACTION))
@@ -70,6 +75,14 @@ timestamp_t TransactionManager::UpdatingCommitCriticalSection(TransactionContext
   return commit_time;
 }
 
+void TransactionManager::ReadOnlyCommit(TransactionContext *const txn, const transaction::callback_fn callback,
+                                        void *const callback_arg) {
+  // There is no commit record to write out, so all that is left is to stop holding the snapshot back from the GC
+  txn->finish_time_.store(txn->StartTime());
+  timestamp_manager_->RemoveTransaction(txn->StartTime());
+  callback(callback_arg);
+}
+
 timestamp_t TransactionManager::Commit(TransactionContext *const txn, transaction::callback_fn callback,
                                        void *callback_arg) {
   uint64_t elapsed_us = 0;
@@ -82,27 +95,35 @@ timestamp_t TransactionManager::Commit(TransactionContext *const txn, transactio
         !txn->must_abort_,
         "This txn was marked that it must abort. Set a breakpoint at TransactionContext::MustAbort() to see a "
         "stack trace for when this flag is getting tripped.");
-    result = txn->IsReadOnly() ? timestamp_manager_->CheckOutTimestamp() : UpdatingCommitCriticalSection(txn);
+    if (txn->DeclaredReadOnly())
+      // A declared read-only transaction is serialized at its snapshot, so it does not need a new timestamp
+      result = txn->StartTime();
+    else
+      result = txn->IsReadOnly() ? timestamp_manager_->CheckOutTimestamp() : UpdatingCommitCriticalSection(txn);
     while (!txn->commit_actions_.empty()) {
       TERRIER_ASSERT(deferred_action_manager_ != DISABLED, "No deferred action manager exists to process actions");
       txn->commit_actions_.front()(deferred_action_manager_);
       txn->commit_actions_.pop_front();
     }
 
-    // If logging is enabled and our txn is not read only, we need to persist the oldest active txn at the time we
-    // committed. This will allow us to correctly order and execute transactions during recovery.
-    timestamp_t oldest_active_txn = INVALID_TXN_TIMESTAMP;
-    if (log_manager_ != DISABLED && !txn->IsReadOnly()) {
-      // TODO(Gus): Getting the cached timestamp may cause replication delays, as the cached timestamp is a stale value,
-      // so transactions may wait for longer than they need to. We should analyze the impact of this when replication is
-      // added.
-      oldest_active_txn = timestamp_manager_->CachedOldestTransactionStartTime();
+    if (txn->DeclaredReadOnly()) {
+      ReadOnlyCommit(txn, callback, callback_arg);
+    } else {
+      // If logging is enabled and our txn is not read only, we need to persist the oldest active txn at the time we
+      // committed. This will allow us to correctly order and execute transactions during recovery.
+      timestamp_t oldest_active_txn = INVALID_TXN_TIMESTAMP;
+      if (log_manager_ != DISABLED && !txn->IsReadOnly()) {
+        // TODO(Gus): Getting the cached timestamp may cause replication delays, as the cached timestamp is a stale
+        // value, so transactions may wait for longer than they need to. We should analyze the impact of this when
+        // replication is added.
+        oldest_active_txn = timestamp_manager_->CachedOldestTransactionStartTime();
+      }
+      LogCommit(txn, result, callback, callback_arg, oldest_active_txn);
     }
-    LogCommit(txn, result, callback, callback_arg, oldest_active_txn);
 
     // We hand off txn to GC, however, it won't be GC'd until the LogManager marks it as serialized
     if (gc_enabled_) {
-      common::SpinLatch::ScopedSpinLatch guard(&timestamp_manager_->curr_running_txns_latch_);
+      common::SpinLatch::ScopedSpinLatch guard(&completed_txns_latch_);
       // It is not necessary to have to GC process read-only transactions, but it's probably faster to call free off
       // the critical path there anyway
       // Also note here that GC will figure out what varlen entries to GC, as opposed to in the abort case.
@@ -177,7 +198,7 @@ timestamp_t TransactionManager::Abort(TransactionContext *const txn) {
 
   // We hand off txn to GC, however, it won't be GC'd until the LogManager marks it as serialized
   if (gc_enabled_) {
-    common::SpinLatch::ScopedSpinLatch guard(&timestamp_manager_->curr_running_txns_latch_);
+    common::SpinLatch::ScopedSpinLatch guard(&completed_txns_latch_);
     // It is not necessary to have to GC process read-only transactions, but it's probably faster to call free off
     // the critical path there anyway
     // Also note here that GC will figure out what varlen entries to GC, as opposed to in the abort case.
@@ -222,7 +243,7 @@ void TransactionManager::GCLastUpdateOnAbort(TransactionContext *const txn) {
 }
 
 TransactionQueue TransactionManager::CompletedTransactionsForGC() {
-  common::SpinLatch::ScopedSpinLatch guard(&timestamp_manager_->curr_running_txns_latch_);
+  common::SpinLatch::ScopedSpinLatch guard(&completed_txns_latch_);
   return std::move(completed_txns_);
 }
 
@@ -68,6 +68,46 @@ TEST(ObjectPoolTests, ResetLimitTest) {
   }
 }
 
+// Objects cached for reuse by a thread count towards the reuse limit, and so the objects over it are freed
+// NOLINTNEXTLINE
+TEST(ObjectPoolTests, CachedReuseLimitTest) {
+  const uint64_t size_limit = 100;
+  const uint64_t reuse_limit = 10;
+  common::ObjectPool<uint32_t> tested(size_limit, reuse_limit);
+  std::vector<uint32_t *> ptrs;
+  for (uint32_t i = 0; i < 2 * reuse_limit; i++) ptrs.push_back(tested.Get());
+  for (auto *ptr : ptrs) tested.Release(ptr);
+  // Only the reusable objects are still around
+  EXPECT_FALSE(tested.SetSizeLimit(reuse_limit - 1));
+  EXPECT_TRUE(tested.SetSizeLimit(reuse_limit));
+  ptrs.clear();
+  for (uint32_t i = 0; i < reuse_limit; i++) ptrs.push_back(tested.Get());
+  EXPECT_THROW(tested.Get(), common::NoMoreObjectException);
+  for (auto *ptr : ptrs) tested.Release(ptr);
+}
+
+// Objects released by one thread can be handed out to another, even when the pool cannot allocate any more
+// NOLINTNEXTLINE
+TEST(ObjectPoolTests, CrossThreadReuseTest) {
+  const uint64_t size_limit = 100;
+  common::ObjectPool<uint32_t> tested(size_limit, size_limit);
+  std::unordered_set<uint32_t *> released;
+  std::thread releaser([&] {
+    for (uint32_t i = 0; i < size_limit; i++) released.insert(tested.Get());
+    for (auto *ptr : released) tested.Release(ptr);
+  });
+  releaser.join();
+
+  std::vector<uint32_t *> ptrs;
+  std::thread getter([&] {
+    for (uint32_t i = 0; i < size_limit; i++) ptrs.push_back(tested.Get());
+    EXPECT_THROW(tested.Get(), common::NoMoreObjectException);
+  });
+  getter.join();
+  for (auto *ptr : ptrs) EXPECT_TRUE(released.find(ptr) != released.end());
+  for (auto *ptr : ptrs) tested.Release(ptr);
+}
+
 class ObjectPoolTestType {
  public:
   ObjectPoolTestType *Use(uint32_t thread_id) {
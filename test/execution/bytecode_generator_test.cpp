@@ -320,4 +320,41 @@ TEST_F(BytecodeGeneratorTest, FunctionTest) {
   EXPECT_EQ(20, s.b_);
 }
 
+// NOLINTNEXTLINE
+TEST_F(BytecodeGeneratorTest, SuperinstructionTest) {
+  // The loop header, the counter updates and both comparisons are fused into superinstructions. When the first
+  // comparison fails, the short-circuiting jump lands in the middle of the second one's superinstruction.
+  auto src = R"(
+    fun test(n: int64) -> int64 {
+      var c = 0
+      for (var i = 0; i < n; i = i + 1) {
+        var b = i > 3 and i != 7
+        if (b) {
+          c = c + i
+        } else {
+          c = c - 1
+        }
+      }
+      return c
+    })";
+  auto compiler = ModuleCompiler();
+  auto *ast = compiler.CompileToAst(src);
+  ASSERT_FALSE(compiler.HasErrors());
+  auto bytecode_module = BytecodeGenerator::Compile(ast, nullptr, "test");
+  auto *bytecode_module_ptr = bytecode_module.get();
+  auto module = std::make_unique<Module>(std::move(bytecode_module));
+
+  std::function<int64_t(int64_t)> f;
+  EXPECT_TRUE(module->GetFunction("test", ExecutionMode::Interpret, &f)) << "Function 'test' not found in module";
+
+  for (const bool enabled : {true, false}) {
+    bytecode_module_ptr->SetSuperinstructionsEnabled(enabled);
+    for (int64_t n = 0; n < 20; n++) {
+      int64_t expected = 0;
+      for (int64_t i = 0; i < n; i++) expected += (i > 3 && i != 7) ? i : -1;
+      EXPECT_EQ(expected, f(n));
+    }
+  }
+}
+
 }  // namespace terrier::execution::vm::test
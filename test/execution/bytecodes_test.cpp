@@ -1,3 +1,5 @@
+#include <vector>
+
 #include "execution/tpl_test.h"
 
 #include "execution/vm/bytecodes.h"
@@ -102,4 +104,23 @@ TEST_F(BytecodesTest, OperandTypesTest) {
   EXPECT_EQ(OperandType::Local, Bytecodes::GetNthOperandType(Bytecode::Add_int32_t, 2));
 }
 
+// NOLINTNEXTLINE
+TEST_F(BytecodesTest, SuperinstructionTest) {
+  // Superinstructions come after all bytecodes
+  EXPECT_FALSE(Bytecodes::IsSuperinstruction(Bytecode::JumpIfFalse));
+  EXPECT_TRUE(Bytecodes::IsSuperinstruction(Bytecode::PCIHasNext_JumpIfFalse));
+  EXPECT_EQ(Bytecodes::NumBytecodes(), Bytecodes::ToByte(Bytecode::TableVectorIteratorNext_JumpIfFalse));
+  EXPECT_STREQ("LessThan_int32_t_JumpIfFalse", Bytecodes::ToString(Bytecode::LessThan_int32_t_JumpIfFalse));
+
+  // Non-exhaustive test of the sequences superinstructions fuse
+  EXPECT_EQ(std::vector<Bytecode>({Bytecode::PCIHasNext, Bytecode::JumpIfFalse}),
+            Bytecodes::GetFusedBytecodes(Bytecode::PCIHasNext_JumpIfFalse));
+  EXPECT_EQ(std::vector<Bytecode>({Bytecode::LessThan_int32_t, Bytecode::JumpIfFalse}),
+            Bytecodes::GetFusedBytecodes(Bytecode::LessThan_int32_t_JumpIfFalse));
+  EXPECT_EQ(std::vector<Bytecode>({Bytecode::LessThanInteger, Bytecode::ForceBoolTruth, Bytecode::JumpIfFalse}),
+            Bytecodes::GetFusedBytecodes(Bytecode::LessThanInteger_JumpIfFalse));
+  EXPECT_EQ(std::vector<Bytecode>({Bytecode::AssignImm8, Bytecode::Add_int64_t}),
+            Bytecodes::GetFusedBytecodes(Bytecode::AssignImm8_Add_int64_t));
+}
+
 }  // namespace terrier::execution::vm::test
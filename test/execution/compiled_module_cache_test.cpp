@@ -0,0 +1,228 @@
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "execution/jit_test.h"
+
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include "execution/exec/execution_context.h"
+#include "execution/vm/llvm_engine.h"
+#include "execution/vm/module.h"
+#include "execution/vm/module_compiler.h"
+
+namespace terrier::execution::vm::test {
+
+class CompiledModuleCacheTest : public JitTest {
+ protected:
+  // Compile the source into a new module. Modules compiled from the same source have the same contents.
+  const BytecodeModule &Compile(const std::string &source, exec::ExecutionContext *exec_ctx = nullptr) {
+    // The module refers to types owned by the compiler, so both are kept until the end of the test
+    compilers_.push_back(std::make_unique<ModuleCompiler>());
+    modules_.push_back(compilers_.back()->CompileToModule(source, exec_ctx));
+    EXPECT_FALSE(compilers_.back()->HasErrors());
+    return *modules_.back()->GetBytecodeModule();
+  }
+
+  static int32_t CallMain(const LLVMEngine::CompiledModule &compiled_module) {
+    return reinterpret_cast<int32_t (*)()>(compiled_module.GetFunctionPointer("main"))();
+  }
+
+  // Files the cache persisted modules to in the current directory, with the given extension
+  static std::vector<std::string> PersistedFiles(const std::string &extension) {
+    std::vector<std::string> files;
+    std::error_code error_code;
+    for (llvm::sys::fs::directory_iterator it(".", error_code), end; it != end && !error_code;
+         it.increment(error_code)) {
+      if (llvm::sys::path::filename(it->path()).startswith("tpl_") &&
+          llvm::sys::path::extension(it->path()) == extension) {
+        files.push_back(it->path());
+      }
+    }
+    return files;
+  }
+
+ private:
+  std::vector<std::unique_ptr<ModuleCompiler>> compilers_;
+  std::vector<std::unique_ptr<Module>> modules_;
+};
+
+// NOLINTNEXTLINE
+TEST_F(CompiledModuleCacheTest, HitAndMiss) {
+  LLVMEngine::CompiledModuleCache cache;
+  const auto &module = Compile("fun main() -> int32 { return 42 }");
+  const auto &same_module = Compile("fun main() -> int32 { return 42 }");
+  const auto &other_module = Compile("fun main() -> int32 { return 7 }");
+
+  EXPECT_FALSE(cache.Contains(module));
+  auto compiled_module = cache.GetOrCompile(module);
+  EXPECT_EQ(42, CallMain(*compiled_module));
+  EXPECT_EQ(0, cache.NumHits());
+  EXPECT_EQ(1, cache.NumMisses());
+
+  // A module with the same contents gets the cached machine code
+  EXPECT_TRUE(cache.Contains(same_module));
+  EXPECT_EQ(compiled_module, cache.GetOrCompile(same_module));
+  EXPECT_EQ(1, cache.NumHits());
+  EXPECT_EQ(1, cache.NumMisses());
+
+  // A module with other contents does not
+  EXPECT_FALSE(cache.Contains(other_module));
+  auto other_compiled_module = cache.GetOrCompile(other_module);
+  EXPECT_NE(compiled_module, other_compiled_module);
+  EXPECT_EQ(7, CallMain(*other_compiled_module));
+  EXPECT_EQ(1, cache.NumHits());
+  EXPECT_EQ(2, cache.NumMisses());
+  EXPECT_EQ(2, cache.Size());
+
+  cache.Clear();
+  EXPECT_EQ(0, cache.Size());
+  EXPECT_FALSE(cache.Contains(module));
+  // Modules dropped from the cache stay usable
+  EXPECT_EQ(42, CallMain(*compiled_module));
+}
+
+// NOLINTNEXTLINE
+TEST_F(CompiledModuleCacheTest, EvictLeastRecentlyUsed) {
+  LLVMEngine::CompiledModuleCache cache(2);
+  const auto &first = Compile("fun main() -> int32 { return 1 }");
+  const auto &second = Compile("fun main() -> int32 { return 2 }");
+  const auto &third = Compile("fun main() -> int32 { return 3 }");
+
+  cache.GetOrCompile(first);
+  auto second_compiled_module = cache.GetOrCompile(second);
+  // Using the first module again makes the second one the least recently used
+  cache.GetOrCompile(first);
+  cache.GetOrCompile(third);
+
+  EXPECT_EQ(2, cache.Size());
+  EXPECT_TRUE(cache.Contains(first));
+  EXPECT_FALSE(cache.Contains(second));
+  EXPECT_TRUE(cache.Contains(third));
+  EXPECT_EQ(2, CallMain(*second_compiled_module));
+
+  // The evicted module is compiled again, evicting the first one
+  EXPECT_NE(second_compiled_module, cache.GetOrCompile(second));
+  EXPECT_EQ(4, cache.NumMisses());
+  EXPECT_FALSE(cache.Contains(first));
+}
+
+// NOLINTNEXTLINE
+TEST_F(CompiledModuleCacheTest, ConcurrentMissesCompileOnce) {
+  constexpr uint32_t num_threads = 8;
+  LLVMEngine::CompiledModuleCache cache;
+  std::vector<const BytecodeModule *> modules;
+  for (uint32_t i = 0; i < num_threads; i++) {
+    modules.push_back(&Compile("fun main() -> int32 { var x = 0 for (var i = 0; i < 100; i = i + 1) { x = x + i } "
+                               "return x }"));
+  }
+
+  std::vector<std::shared_ptr<LLVMEngine::CompiledModule>> compiled_modules(num_threads);
+  std::vector<std::thread> threads;
+  for (uint32_t i = 0; i < num_threads; i++) {
+    threads.emplace_back([&, i] { compiled_modules[i] = cache.GetOrCompile(*modules[i]); });
+  }
+  for (auto &thread : threads) thread.join();
+
+  EXPECT_EQ(1, cache.NumMisses());
+  EXPECT_EQ(num_threads - 1, cache.NumHits());
+  for (const auto &compiled_module : compiled_modules) {
+    EXPECT_EQ(compiled_modules[0], compiled_module);
+  }
+  EXPECT_EQ(4950, CallMain(*compiled_modules[0]));
+}
+
+// NOLINTNEXTLINE
+TEST_F(CompiledModuleCacheTest, FailedCompilationIsNotCached) {
+  LLVMEngine::CompiledModuleCache cache;
+  const auto &module = Compile("fun main() -> int32 { return 42 }");
+
+  // Without the bytecode handlers, compilation fails
+  const std::string bc_path = LLVMEngine::CompilerOptions().GetBytecodeHandlersBcPath();
+  const std::string moved_bc_path = bc_path + ".moved";
+  ASSERT_FALSE(llvm::sys::fs::rename(bc_path, moved_bc_path));
+  EXPECT_THROW(cache.GetOrCompile(module), std::runtime_error);
+  EXPECT_EQ(0, cache.Size());
+  EXPECT_FALSE(cache.Contains(module));
+
+  // The next request tries again
+  ASSERT_FALSE(llvm::sys::fs::rename(moved_bc_path, bc_path));
+  EXPECT_EQ(42, CallMain(*cache.GetOrCompile(module)));
+  EXPECT_EQ(2, cache.NumMisses());
+  EXPECT_EQ(1, cache.Size());
+}
+
+// NOLINTNEXTLINE
+TEST_F(CompiledModuleCacheTest, PersistedModulesAreVerifiedBeforeLoading) {
+  LLVMEngine::CompiledModuleCache cache;
+  cache.SetOptions(LLVMEngine::CompilerOptions().SetPersistObjectFile(true));
+  const auto &module = Compile("fun main() -> int32 { return 42 }");
+
+  // Start from a clean directory, in case an earlier run persisted the module
+  for (const auto &extension : {".to", ".key"}) {
+    for (const auto &file : PersistedFiles(extension)) {
+      llvm::sys::fs::remove(file);
+    }
+  }
+
+  // The first miss compiles the module, and persists it along with its key file
+  EXPECT_EQ(42, CallMain(*cache.GetOrCompile(module)));
+  EXPECT_EQ(0, cache.NumFileLoads());
+
+  // Once the module is dropped from the cache, the next miss loads the persisted object file
+  cache.Clear();
+  EXPECT_EQ(42, CallMain(*cache.GetOrCompile(module)));
+  EXPECT_EQ(1, cache.NumFileLoads());
+
+  // A key file that does not describe the module, as if written by another build, keeps the object file from loading
+  const auto key_files = PersistedFiles(".key");
+  ASSERT_EQ(1, key_files.size());
+  const std::string &key_file_name = key_files[0];
+  std::error_code error_code;
+  {
+    llvm::raw_fd_ostream key_file(key_file_name, error_code, llvm::sys::fs::F_None);
+    ASSERT_FALSE(error_code);
+    key_file << "tpl-object-v0\n";
+  }
+  cache.Clear();
+  EXPECT_EQ(42, CallMain(*cache.GetOrCompile(module)));
+  EXPECT_EQ(1, cache.NumFileLoads());
+
+  // Recompiling wrote a key file that matches again
+  cache.Clear();
+  EXPECT_EQ(42, CallMain(*cache.GetOrCompile(module)));
+  EXPECT_EQ(2, cache.NumFileLoads());
+  EXPECT_EQ(4, cache.NumMisses());
+
+  llvm::sys::fs::remove(key_file_name);
+  llvm::sys::fs::remove(key_file_name.substr(0, key_file_name.size() - 4) + ".to");
+}
+
+// NOLINTNEXTLINE
+TEST_F(CompiledModuleCacheTest, StringLiteralsAreNotCached) {
+  // String literals live in the execution context of the query that compiled them
+  exec::ExecutionContext exec_ctx(catalog::db_oid_t(0), nullptr, nullptr, nullptr, nullptr);
+  const std::string source =
+      "fun main() -> int32 {"
+      "  var str = @stringToSql(\"StrAing\")"
+      "  if (str != @stringToSql(\"StrAing\")) { return 1 }"
+      "  return 0"
+      "}";
+  LLVMEngine::CompiledModuleCache cache;
+  const auto &module = Compile(source, &exec_ctx);
+  const auto &same_module = Compile(source, &exec_ctx);
+
+  auto compiled_module = cache.GetOrCompile(module);
+  EXPECT_EQ(0, CallMain(*compiled_module));
+  EXPECT_FALSE(cache.Contains(module));
+  EXPECT_NE(compiled_module, cache.GetOrCompile(same_module));
+  EXPECT_EQ(2, cache.NumUncacheable());
+  EXPECT_EQ(0, cache.NumMisses());
+  EXPECT_EQ(0, cache.Size());
+}
+
+}  // namespace terrier::execution::vm::test
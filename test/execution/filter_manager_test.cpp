@@ -10,8 +10,10 @@
 #include "execution/sql_test.h"
 
 #include "catalog/catalog.h"
+#include "execution/sql/bloom_filter.h"
 #include "execution/sql/filter_manager.h"
 #include "execution/sql/table_vector_iterator.h"
+#include "execution/util/hash.h"
 #include "type/type_id.h"
 
 namespace terrier::execution::sql::test {
@@ -52,6 +54,21 @@ uint32_t VectorizedLt500(ProjectedColumnsIterator *pci) {
   return pci->FilterColByVal<std::less>(Col::A, type::TypeId ::INTEGER, param);
 }
 
+hash_t HashColA(ProjectedColumnsIterator *pci) {
+  auto cola = *pci->Get<int32_t, false>(Col::A, nullptr);
+  return util::Hasher::Hash(reinterpret_cast<const uint8_t *>(&cola), sizeof(cola));
+}
+
+hash_t SlowHashColA(ProjectedColumnsIterator *pci) {
+  // Burn some cycles so that probing a bloom filter clearly costs more than
+  // skipping it
+  volatile hash_t sink = 0;
+  for (uint32_t i = 0; i < 500; i++) {
+    sink = sink + HashColA(pci);
+  }
+  return HashColA(pci);
+}
+
 // NOLINTNEXTLINE
 TEST_F(FilterManagerTest, SimpleFilterManagerTest) {
   FilterManager filter(bandit::Policy::Kind::FixedAction);
@@ -103,4 +120,139 @@ TEST_F(FilterManagerTest, AdaptiveFilterManagerTest) {
   EXPECT_EQ(1u, filter.GetOptimalFlavorForClause(0));
 }
 
+// NOLINTNEXTLINE
+TEST_F(FilterManagerTest, JoinFilterTest) {
+  auto table_oid = exec_ctx_->GetAccessor()->GetTableOid(NSOid(), "test_1");
+  std::array<uint32_t, 1> col_oids{1};
+
+  // Build a bloom filter over the even values of colA, as the build side of a
+  // join would
+  std::vector<hash_t> build_hashes;
+  {
+    TableVectorIterator tvi(exec_ctx_.get(), !table_oid, col_oids.data(), static_cast<uint32_t>(col_oids.size()));
+    for (tvi.Init(); tvi.Advance();) {
+      auto *pci = tvi.GetProjectedColumnsIterator();
+      pci->ForEach([pci, &build_hashes]() {
+        auto cola = *pci->Get<int32_t, false>(Col::A, nullptr);
+        if (cola % 2 == 0) build_hashes.push_back(HashColA(pci));
+      });
+    }
+  }
+  MemoryPool memory(nullptr);
+  BloomFilter bloom_filter(&memory, static_cast<uint32_t>(build_hashes.size()));
+  for (const auto hash : build_hashes) {
+    bloom_filter.Add(hash);
+  }
+
+  FilterManager filter(bandit::Policy::Kind::FixedAction);
+  filter.InsertJoinFilterClause(&bloom_filter, HashColA);
+  filter.Finalize();
+  TableVectorIterator tvi(exec_ctx_.get(), !table_oid, col_oids.data(), static_cast<uint32_t>(col_oids.size()));
+  uint32_t num_vectors = 0, num_matches = 0, num_selected = 0;
+  for (tvi.Init(); tvi.Advance();) {
+    auto *pci = tvi.GetProjectedColumnsIterator();
+    num_vectors++;
+
+    // Run the filters
+    filter.RunFilters(pci);
+
+    // Check
+    pci->ForEach([pci, &num_matches, &num_selected]() {
+      auto cola = *pci->Get<int32_t, false>(Col::A, nullptr);
+      num_matches += static_cast<uint32_t>(cola % 2 == 0);
+      num_selected++;
+    });
+  }
+
+  // All tuples with a match on the build side survive, and only a few false
+  // positives do
+  EXPECT_EQ(build_hashes.size(), num_matches);
+  EXPECT_LT(num_selected - num_matches, num_matches / 10);
+
+  // Every vector but the last one, which is still in flight, was rewarded, and
+  // the fixed policy never skipped the filter
+  const auto &attempts = filter.GetFlavorAttemptsForClause(0);
+  EXPECT_EQ(num_vectors - 1, attempts[FilterManager::K_APPLY_JOIN_FILTER]);
+  EXPECT_EQ(0u, attempts[FilterManager::K_SKIP_JOIN_FILTER]);
+}
+
+// NOLINTNEXTLINE
+TEST_F(FilterManagerTest, AdaptiveJoinFilterTest) {
+  // A very selective join: nothing on the build side matches
+  MemoryPool memory(nullptr);
+  BloomFilter bloom_filter(&memory, 10);
+  for (int32_t i = -10; i < 0; i++) {
+    bloom_filter.Add(util::Hasher::Hash(reinterpret_cast<const uint8_t *>(&i), sizeof(i)));
+  }
+
+  FilterManager filter(bandit::Policy::Kind::UCB);
+  filter.InsertJoinFilterClause(&bloom_filter, HashColA);
+  filter.Finalize();
+  auto table_oid = exec_ctx_->GetAccessor()->GetTableOid(NSOid(), "test_1");
+  std::array<uint32_t, 1> col_oids{1};
+  for (uint32_t run = 0; run < 5; run++) {
+    TableVectorIterator tvi(exec_ctx_.get(), !table_oid, col_oids.data(), static_cast<uint32_t>(col_oids.size()));
+    for (tvi.Init(); tvi.Advance();) {
+      auto *pci = tvi.GetProjectedColumnsIterator();
+
+      // Run the filters
+      filter.RunFilters(pci);
+
+      // Stand-in for an expensive probe of the join hash table with whatever
+      // tuples survived the filters
+      uint32_t num_selected = 0;
+      pci->ForEach([&num_selected]() { num_selected++; });
+      std::this_thread::sleep_for(std::chrono::microseconds(10 * num_selected));
+    }
+  }
+
+  // Both flavors were tried, and discarding tuples before the probe better be
+  // the optimal!
+  const auto &attempts = filter.GetFlavorAttemptsForClause(0);
+  EXPECT_GT(attempts[FilterManager::K_SKIP_JOIN_FILTER], 0u);
+  EXPECT_GT(attempts[FilterManager::K_APPLY_JOIN_FILTER], attempts[FilterManager::K_SKIP_JOIN_FILTER]);
+  EXPECT_EQ(FilterManager::K_APPLY_JOIN_FILTER, filter.GetOptimalFlavorForClause(0));
+}
+
+// NOLINTNEXTLINE
+TEST_F(FilterManagerTest, AdaptiveSkipJoinFilterTest) {
+  auto table_oid = exec_ctx_->GetAccessor()->GetTableOid(NSOid(), "test_1");
+  std::array<uint32_t, 1> col_oids{1};
+
+  // A join that discards nothing: every probe key is on the build side
+  MemoryPool memory(nullptr);
+  BloomFilter bloom_filter(&memory, sql::TEST1_SIZE);
+  {
+    TableVectorIterator tvi(exec_ctx_.get(), !table_oid, col_oids.data(), static_cast<uint32_t>(col_oids.size()));
+    for (tvi.Init(); tvi.Advance();) {
+      auto *pci = tvi.GetProjectedColumnsIterator();
+      pci->ForEach([pci, &bloom_filter]() { bloom_filter.Add(HashColA(pci)); });
+    }
+  }
+
+  FilterManager filter(bandit::Policy::Kind::UCB);
+  filter.InsertJoinFilterClause(&bloom_filter, SlowHashColA);
+  filter.Finalize();
+  for (uint32_t run = 0; run < 10; run++) {
+    TableVectorIterator tvi(exec_ctx_.get(), !table_oid, col_oids.data(), static_cast<uint32_t>(col_oids.size()));
+    uint32_t num_selected = 0;
+    for (tvi.Init(); tvi.Advance();) {
+      auto *pci = tvi.GetProjectedColumnsIterator();
+
+      // Run the filters. There is no work downstream, so the time of a vector
+      // is the time spent filtering it.
+      filter.RunFilters(pci);
+      pci->ForEach([&num_selected]() { num_selected++; });
+    }
+    EXPECT_EQ(sql::TEST1_SIZE, num_selected);
+  }
+
+  // Both flavors were tried, and skipping a filter that discards nothing better
+  // be the optimal!
+  const auto &attempts = filter.GetFlavorAttemptsForClause(0);
+  EXPECT_GT(attempts[FilterManager::K_APPLY_JOIN_FILTER], 0u);
+  EXPECT_GT(attempts[FilterManager::K_SKIP_JOIN_FILTER], attempts[FilterManager::K_APPLY_JOIN_FILTER]);
+  EXPECT_EQ(FilterManager::K_SKIP_JOIN_FILTER, filter.GetOptimalFlavorForClause(0));
+}
+
 }  // namespace terrier::execution::sql::test
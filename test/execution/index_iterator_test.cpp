@@ -59,4 +59,45 @@ TEST_F(IndexIteratorTest, SimpleIndexIteratorTest) {
   }
 }
 
+// NOLINTNEXTLINE
+TEST_F(IndexIteratorTest, BatchedIndexIteratorTest) {
+  //
+  // Access table data through the index, one vector of keys at a time
+  //
+
+  auto table_oid = exec_ctx_->GetAccessor()->GetTableOid(NSOid(), "test_1");
+  auto index_oid = exec_ctx_->GetAccessor()->GetIndexOid(NSOid(), "index_1");
+  std::array<uint32_t, 1> col_oids{1};
+  TableVectorIterator table_iter(exec_ctx_.get(), !table_oid, col_oids.data(), static_cast<uint32_t>(col_oids.size()));
+  IndexIterator index_iter{exec_ctx_.get(), !table_oid, !index_oid, col_oids.data(),
+                           static_cast<uint32_t>(col_oids.size())};
+  table_iter.Init();
+  index_iter.Init();
+  ProjectedColumnsIterator *pci = table_iter.GetProjectedColumnsIterator();
+
+  // Iterate through the table.
+  while (table_iter.Advance()) {
+    for (; pci->HasNext(); pci->Advance()) {
+      auto *key = pci->Get<int32_t, false>(0, nullptr);
+      index_iter.SetKey<int32_t, false>(0, *key, false);
+      index_iter.AddBatchKey();
+    }
+    index_iter.ScanKeyBatch();
+    // Check that every key of the vector can be recovered through the index, in order
+    for (pci->Reset(); pci->HasNext(); pci->Advance()) {
+      ASSERT_TRUE(index_iter.NextBatchKey());
+      auto *key = pci->Get<int32_t, false>(0, nullptr);
+      // One entry should be found
+      ASSERT_TRUE(index_iter.Advance());
+      auto *val = index_iter.Get<int32_t, false>(0, nullptr);
+      ASSERT_EQ(*key, *val);
+      // Check that there are no more entries.
+      ASSERT_FALSE(index_iter.Advance());
+    }
+    // Check that there are no more keys.
+    ASSERT_FALSE(index_iter.NextBatchKey());
+    pci->Reset();
+  }
+}
+
 }  // namespace terrier::execution::sql::test
@@ -164,6 +164,38 @@ TEST_F(JoinHashTableTest, UniqueKeyConciseTableTest) { BuildAndProbeTest<true>(4
 // NOLINTNEXTLINE
 TEST_F(JoinHashTableTest, DuplicateKeyLookupConciseTableTest) { BuildAndProbeTest<true>(400, 5); }
 
+template <bool UseConciseHashTable>
+void BuildBloomFilterTest(uint32_t num_tuples) {
+  MemoryPool memory(nullptr);
+  JoinHashTable join_hash_table(&memory, sizeof(Tuple), UseConciseHashTable);
+
+  // Request the filter before building, as a probe-side join filter would
+  const BloomFilter *bloom_filter = join_hash_table.RequestBloomFilter();
+  PopulateJoinHashTable(&join_hash_table, num_tuples, 1);
+  join_hash_table.Build();
+
+  // No false negatives
+  for (uint32_t i = 0; i < num_tuples; i++) {
+    auto hash_val = util::Hasher::Hash(reinterpret_cast<const uint8_t *>(&i), sizeof(i));
+    EXPECT_TRUE(bloom_filter->Contains(hash_val)) << "Key [" << i << "] is missing from the bloom filter";
+  }
+
+  // Few false positives
+  const uint32_t num_probes = 10000;
+  uint32_t num_false_positives = 0;
+  for (uint32_t i = num_tuples; i < num_tuples + num_probes; i++) {
+    auto hash_val = util::Hasher::Hash(reinterpret_cast<const uint8_t *>(&i), sizeof(i));
+    num_false_positives += static_cast<uint32_t>(bloom_filter->Contains(hash_val));
+  }
+  EXPECT_LT(num_false_positives, num_probes / 10);
+}
+
+// NOLINTNEXTLINE
+TEST_F(JoinHashTableTest, BloomFilterTest) { BuildBloomFilterTest<false>(1000); }
+
+// NOLINTNEXTLINE
+TEST_F(JoinHashTableTest, BloomFilterConciseTableTest) { BuildBloomFilterTest<true>(1000); }
+
 // NOLINTNEXTLINE
 TEST_F(JoinHashTableTest, ParallelBuildTest) {
   const uint32_t num_tuples = 100000;
@@ -187,6 +219,14 @@ TEST_F(JoinHashTableTest, ParallelBuildTest) {
 
   JoinHashTable main_jht(&memory, sizeof(Tuple), false);
   main_jht.MergeParallel(&container, 0);
+
+  // A bloom filter requested after the merge covers the tuples of all
+  // thread-local tables
+  const BloomFilter *bloom_filter = main_jht.RequestBloomFilter();
+  for (uint32_t i = 0; i < num_tuples; i++) {
+    auto hash_val = util::Hasher::Hash(reinterpret_cast<const uint8_t *>(&i), sizeof(i));
+    EXPECT_TRUE(bloom_filter->Contains(hash_val));
+  }
 }
 
 // NOLINTNEXTLINE
@@ -0,0 +1,147 @@
+#include <chrono>  // NOLINT
+#include <functional>
+#include <mutex>  // NOLINT
+#include <thread>  // NOLINT
+
+#include "execution/jit_test.h"
+
+#include "execution/vm/llvm_engine.h"
+#include "execution/vm/module.h"
+#include "execution/vm/module_compiler.h"
+
+namespace terrier::execution::vm::test {
+
+class ModuleTieringTest : public JitTest {
+ protected:
+  static bool IsCompiled(const Module &module, const FunctionId func_id) {
+    return module.IsCallableCompiledImpl(func_id);
+  }
+
+  static bool IsCompileRequested(const Module &module, const FunctionId func_id) {
+    return module.compile_requested_[func_id].load();
+  }
+
+  // Wait until the function runs compiled code, which the module compiles in the background
+  static bool WaitUntilCompiled(const Module &module, const FunctionId func_id) {
+    for (uint32_t i = 0; i < 6000 && !module.IsCallableCompiledImpl(func_id); i++) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return module.IsCallableCompiledImpl(func_id);
+  }
+
+  // Wait until the background compilation of the whole module is done, so that it does not outlive the module
+  static bool WaitUntilModuleCompiled(Module *module) {
+    const auto module_compiled = [module] {
+      std::lock_guard<std::mutex> guard(module->tiering_latch_);
+      return module->jit_module_ != nullptr;
+    };
+    for (uint32_t i = 0; i < 6000 && !module_compiled(); i++) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    if (!module_compiled()) return false;
+    // Returns once the background compilation is done
+    module->CompileToMachineCode();
+    return true;
+  }
+
+  static void *GetDispatchStub(const Module &module, const FunctionId func_id) {
+    return module.GetDispatchStub(func_id);
+  }
+
+  static void *GetCompiledImpl(const Module &module, const FunctionId func_id) {
+    return module.GetCompiledImpl(func_id);
+  }
+
+  // Replace the current implementation of the function, e.g., to observe whether it is called
+  static void SetFunctionImpl(Module *module, const FunctionId func_id, void *impl) {
+    module->functions_[func_id].store(impl);
+  }
+};
+
+// Stands in for the compiled implementation of add(), so that tests can tell whether it was called
+int32_t FakeCompiledAdd(UNUSED_ATTRIBUTE int32_t a, UNUSED_ATTRIBUTE int32_t b) { return -1; }
+
+// NOLINTNEXTLINE
+TEST_F(ModuleTieringTest, HotFunctionIsCalledThroughDispatchStub) {
+  LLVMEngine::CompiledModuleCache::Instance()->Clear();
+  auto compiler = ModuleCompiler();
+  auto module = compiler.CompileToModule(
+      "fun add(a: int32, b: int32) -> int32 { return a + b }"
+      "fun sum(n: int32) -> int32 {"
+      "  var x = 0"
+      "  for (var i = 0; i < n; i = i + 1) { x = add(x, i) }"
+      "  return x"
+      "}");
+  ASSERT_FALSE(compiler.HasErrors());
+  const FunctionId add_id = module->GetFuncInfoByName("add")->Id();
+
+  std::function<int32_t(int32_t, int32_t)> add;
+  ASSERT_TRUE(module->GetFunction("add", ExecutionMode::Adaptive, &add));
+  for (uint32_t i = 0; i < Module::K_HOT_FUNCTION_THRESHOLD - 1; i++) {
+    EXPECT_EQ(static_cast<int32_t>(i) + 1, add(static_cast<int32_t>(i), 1));
+  }
+  EXPECT_FALSE(IsCompileRequested(*module, add_id));
+  EXPECT_FALSE(IsCompiled(*module, add_id));
+
+  // The call crossing the threshold triggers the compilation of the function
+  EXPECT_EQ(5, add(2, 3));
+  EXPECT_TRUE(IsCompileRequested(*module, add_id));
+  ASSERT_TRUE(WaitUntilCompiled(*module, add_id));
+
+  // Compiled code calls the function through its dispatch stub, which jumps to the compiled implementation
+  auto *add_stub = reinterpret_cast<int32_t (*)(int32_t, int32_t)>(GetDispatchStub(*module, add_id));
+  EXPECT_EQ(5, add_stub(2, 3));
+  EXPECT_EQ(-7, add_stub(-10, 3));
+
+  // Interpreted callers hand off to the compiled implementation
+  std::function<int32_t(int32_t)> sum;
+  ASSERT_TRUE(module->GetFunction("sum", ExecutionMode::Adaptive, &sum));
+  EXPECT_EQ(4950, sum(100));
+
+  // Once the whole module is compiled, the stub jumps to the module's implementation
+  ASSERT_TRUE(WaitUntilModuleCompiled(module.get()));
+  EXPECT_EQ(GetCompiledImpl(*module, add_id), module->GetRawFunctionImpl(add_id));
+  EXPECT_EQ(5, add_stub(2, 3));
+  EXPECT_EQ(4950, sum(100));
+}
+
+// NOLINTNEXTLINE
+TEST_F(ModuleTieringTest, InterpretedFunctionStaysInterpretedOnceCompiled) {
+  LLVMEngine::CompiledModuleCache::Instance()->Clear();
+  auto compiler = ModuleCompiler();
+  auto module = compiler.CompileToModule(
+      "fun add(a: int32, b: int32) -> int32 { return a + b }"
+      "fun sum(n: int32) -> int32 {"
+      "  var x = 0"
+      "  for (var i = 0; i < n; i = i + 1) { x = add(x, i) }"
+      "  return x"
+      "}");
+  ASSERT_FALSE(compiler.HasErrors());
+  const FunctionId add_id = module->GetFuncInfoByName("add")->Id();
+
+  // Compiling the module swaps in compiled implementations of all functions
+  std::function<int32_t(int32_t, int32_t)> compiled_add;
+  ASSERT_TRUE(module->GetFunction("add", ExecutionMode::Compiled, &compiled_add));
+  EXPECT_EQ(5, compiled_add(2, 3));
+  ASSERT_TRUE(IsCompiled(*module, add_id));
+  SetFunctionImpl(module.get(), add_id, reinterpret_cast<void *>(&FakeCompiledAdd));
+
+  // Interpreted functions, and the functions they call, neither of which hand off to compiled code
+  std::function<int32_t(int32_t, int32_t)> add;
+  std::function<int32_t(int32_t)> sum;
+  ASSERT_TRUE(module->GetFunction("add", ExecutionMode::Interpret, &add));
+  ASSERT_TRUE(module->GetFunction("sum", ExecutionMode::Interpret, &sum));
+  EXPECT_EQ(5, add(2, 3));
+  EXPECT_EQ(4950, sum(100));
+
+  // Adaptive execution does hand off
+  std::function<int32_t(int32_t, int32_t)> adaptive_add;
+  ASSERT_TRUE(module->GetFunction("add", ExecutionMode::Adaptive, &adaptive_add));
+  EXPECT_EQ(-1, adaptive_add(2, 3));
+
+  // Even in a module that executes adaptively, interpreted functions stay interpreted
+  EXPECT_EQ(5, add(2, 3));
+  EXPECT_EQ(4950, sum(100));
+}
+
+}  // namespace terrier::execution::vm::test
@@ -450,4 +450,59 @@ TEST_F(ProjectedColumnsIteratorTest, MultipleVectorizedFilterTest) {
   EXPECT_LE(count, 10u);
 }
 
+// NOLINTNEXTLINE
+TEST_F(ProjectedColumnsIteratorTest, NullableVectorizedFilterTest) {
+  //
+  // Apply NULL-aware filters on the NULLable columns:
+  //  - IS_NULL(col_b) and IS_NOT_NULL(col_b) must split the tuples
+  //  - col_d < half its range must only select non-NULL tuples
+  //
+
+  const auto &col_b_data = ColumnData(ColId::col_b);
+  {
+    ProjectedColumnsIterator iter(GetProjectedColumn());
+    SetSize(common::Constants::K_DEFAULT_VECTOR_SIZE);
+    EXPECT_EQ(col_b_data.num_nulls_, iter.FilterColNull(GetColOffset(ColId::col_b)));
+  }
+  {
+    ProjectedColumnsIterator iter(GetProjectedColumn());
+    SetSize(common::Constants::K_DEFAULT_VECTOR_SIZE);
+    EXPECT_EQ(col_b_data.num_tuples_ - col_b_data.num_nulls_, iter.FilterColNotNull(GetColOffset(ColId::col_b)));
+    for (; iter.HasNextFiltered(); iter.AdvanceFiltered()) {
+      bool null = false;
+      iter.Get<int32_t, true>(GetColOffset(ColId::col_b), &null);
+      EXPECT_FALSE(null);
+    }
+  }
+
+  ProjectedColumnsIterator iter(GetProjectedColumn());
+  SetSize(common::Constants::K_DEFAULT_VECTOR_SIZE);
+  const int64_t bound = std::numeric_limits<int64_t>::max() / 2;
+
+  // Compute expected result
+  uint32_t expected = 0;
+  for (; iter.HasNext(); iter.Advance()) {
+    bool null = false;
+    auto val = *iter.Get<int64_t, true>(GetColOffset(ColId::col_d), &null);
+    expected += static_cast<uint32_t>(!null && val < bound);
+  }
+  iter.Reset();
+
+  // Filter
+  iter.FilterColByVal<std::less, true>(GetColOffset(ColId::col_d), type::TypeId::BIGINT,
+                                       ProjectedColumnsIterator::FilterVal{.bi_ = bound});
+
+  // Check
+  uint32_t count = 0;
+  for (; iter.HasNextFiltered(); iter.AdvanceFiltered()) {
+    bool null = false;
+    auto val = *iter.Get<int64_t, true>(GetColOffset(ColId::col_d), &null);
+    EXPECT_FALSE(null);
+    EXPECT_LT(val, bound);
+    count++;
+  }
+
+  EXPECT_EQ(expected, count);
+}
+
 }  // namespace terrier::execution::sql::test
@@ -6,6 +6,7 @@
 
 #include "catalog/catalog_defs.h"
 #include "execution/sql/table_vector_iterator.h"
+#include "execution/sql/thread_state_container.h"
 #include "execution/util/timer.h"
 
 namespace terrier::execution::sql::test {
@@ -129,4 +130,43 @@ TEST_F(TableVectorIteratorTest, IteratorColOidsTest) {
   EXPECT_EQ(sql::TEST2_SIZE, num_tuples);
 }
 
+// NOLINTNEXTLINE
+TEST_F(TableVectorIteratorTest, ParallelScanTest) {
+  //
+  // Simple test to ensure we iterate over the whole table in parallel
+  //
+
+  struct Counter {
+    uint32_t c_;
+  };
+
+  auto init_count = [](UNUSED_ATTRIBUTE void *ctx, void *tls) { reinterpret_cast<Counter *>(tls)->c_ = 0; };
+
+  // Scan function just counts all tuples it sees
+  auto scanner = [](UNUSED_ATTRIBUTE void *state, void *tls, TableVectorIterator *tvi) {
+    auto *counter = reinterpret_cast<Counter *>(tls);
+    while (tvi->Advance()) {
+      for (auto *pci = tvi->GetProjectedColumnsIterator(); pci->HasNext(); pci->Advance()) {
+        counter->c_++;
+      }
+    }
+  };
+
+  // Setup thread states
+  ThreadStateContainer thread_state_container(exec_ctx_->GetMemoryPool());
+  thread_state_container.Reset(sizeof(Counter), init_count, nullptr, nullptr);
+
+  // Scan with the smallest possible grain size so that every block is its own morsel
+  auto table_oid = exec_ctx_->GetAccessor()->GetTableOid(NSOid(), "test_1");
+  std::array<uint32_t, 1> col_oids{1};
+  ASSERT_TRUE(TableVectorIterator::ParallelScan(!table_oid, col_oids.data(), static_cast<uint32_t>(col_oids.size()),
+                                                nullptr, exec_ctx_.get(), &thread_state_container, scanner, 1));
+
+  // Count total aggregate tuple count seen by all threads
+  uint32_t aggregate_tuple_count = 0;
+  thread_state_container.ForEach<Counter>([&](const Counter *counter) { aggregate_tuple_count += counter->c_; });
+
+  EXPECT_EQ(sql::TEST1_SIZE, aggregate_tuple_count);
+}
+
 }  // namespace terrier::execution::sql::test
@@ -1,6 +1,8 @@
 #include <sys/mman.h>
 #include <algorithm>
+#include <limits>
 #include <random>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -480,6 +482,216 @@ TEST_F(VectorUtilTest, VectorVectorFilterTest) {
 #undef CHECK
 }
 
+// NOLINTNEXTLINE
+TEST_F(VectorUtilTest, NegativeFilterTest) {
+  //
+  // Test: comparisons against negative values must be signed, for every integer width.
+  //
+
+  const uint32_t num_elems = 1000;
+  std::vector<int8_t> arr_8(num_elems);
+  std::vector<int16_t> arr_16(num_elems);
+  std::vector<int32_t> arr_32(num_elems);
+  std::vector<int64_t> arr_64(num_elems);
+  for (uint32_t i = 0; i < num_elems; i++) {
+    arr_8[i] = static_cast<int8_t>(static_cast<int32_t>(i % 100) - 50);
+    arr_16[i] = arr_8[i];
+    arr_32[i] = arr_8[i];
+    arr_64[i] = arr_8[i];
+  }
+
+  // Values in [-50, 50), so each value appears 10 times
+  alignas(common::Constants::CACHELINE_SIZE) uint32_t out[num_elems] = {0};
+  EXPECT_EQ(600u, VectorUtil::FilterGe(arr_8.data(), num_elems, int8_t(-10), out, nullptr));
+  EXPECT_EQ(600u, VectorUtil::FilterGe(arr_16.data(), num_elems, int16_t(-10), out, nullptr));
+  EXPECT_EQ(600u, VectorUtil::FilterGe(arr_32.data(), num_elems, int32_t(-10), out, nullptr));
+  EXPECT_EQ(600u, VectorUtil::FilterGe(arr_64.data(), num_elems, int64_t(-10), out, nullptr));
+  EXPECT_EQ(410u, VectorUtil::FilterLe(arr_32.data(), num_elems, int32_t(-10), out, nullptr));
+  for (uint32_t i = 0; i < 410; i++) {
+    EXPECT_LE(arr_32[out[i]], -10);
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(VectorUtilTest, FloatingPointFilterTest) {
+  //
+  // Test: fill an array with random doubles, some of which are NaN. Verify all filters against their scalar versions,
+  //       both on the full array and through a selection vector.
+  //
+
+  const uint32_t num_elems = 10000;
+  const double val = 0.25;
+
+  std::vector<double> arr_1(num_elems);
+  std::vector<double> arr_2(num_elems);
+  {
+    std::mt19937 gen;
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+    for (uint32_t i = 0; i < num_elems; i++) {
+      arr_1[i] = (i % 97 == 0 ? std::numeric_limits<double>::quiet_NaN() : dist(gen));
+      arr_2[i] = (i % 89 == 0 ? val : dist(gen));
+    }
+  }
+
+  alignas(common::Constants::CACHELINE_SIZE) uint32_t out[common::Constants::K_DEFAULT_VECTOR_SIZE] = {0};
+  alignas(common::Constants::CACHELINE_SIZE) uint32_t sel[common::Constants::K_DEFAULT_VECTOR_SIZE] = {0};
+
+#define CHECK(vec_op, scalar_op)                                                                            \
+  {                                                                                                         \
+    uint32_t by_val_count = 0, by_vec_count = 0, sel_count = 0;                                             \
+    uint32_t scalar_by_val_count = 0, scalar_by_vec_count = 0, scalar_sel_count = 0;                        \
+    for (uint32_t offset = 0; offset < num_elems; offset += common::Constants::K_DEFAULT_VECTOR_SIZE) {     \
+      auto size = std::min(common::Constants::K_DEFAULT_VECTOR_SIZE, num_elems - offset);                   \
+      const double *in_1 = &arr_1[offset], *in_2 = &arr_2[offset];                                          \
+      auto found = VectorUtil::Filter##vec_op(in_1, size, val, out, nullptr);                               \
+      by_val_count += found;                                                                                \
+      for (uint32_t i = 0; i < found; i++) EXPECT_TRUE(in_1[out[i]] scalar_op val);                         \
+      by_vec_count += VectorUtil::Filter##vec_op(in_1, in_2, size, out, nullptr);                           \
+      /* Every other element through a selection vector */                                                  \
+      uint32_t num_sel = 0;                                                                                 \
+      for (uint32_t i = 0; i < size; i += 2) sel[num_sel++] = i;                                            \
+      sel_count += VectorUtil::Filter##vec_op(in_1, num_sel, val, out, sel);                                \
+      for (uint32_t i = 0; i < size; i++) {                                                                 \
+        scalar_by_val_count += in_1[i] scalar_op val;                                                       \
+        scalar_by_vec_count += in_1[i] scalar_op in_2[i];                                                   \
+        scalar_sel_count += i % 2 == 0 && in_1[i] scalar_op val;                                            \
+      }                                                                                                     \
+    }                                                                                                       \
+    EXPECT_EQ(scalar_by_val_count, by_val_count);                                                           \
+    EXPECT_EQ(scalar_by_vec_count, by_vec_count);                                                           \
+    EXPECT_EQ(scalar_sel_count, sel_count);                                                                 \
+  }
+
+  CHECK(Eq, ==)
+  CHECK(Ge, >=)
+  CHECK(Gt, >)
+  CHECK(Le, <=)
+  CHECK(Lt, <)
+  CHECK(Ne, !=)
+
+#undef CHECK
+}
+
+// NOLINTNEXTLINE
+TEST_F(VectorUtilTest, NullBitmapFilterTest) {
+  const uint32_t num_elems = 1003;
+  auto *null_bitmap = common::RawBitmap::Allocate(num_elems);
+  uint32_t num_non_null = 0;
+  for (uint32_t i = 0; i < num_elems; i++) {
+    // Long runs of non-NULL values, with a few NULLs sprinkled in
+    const bool non_null = (i < 512 && i % 31 != 0) || i % 3 == 0;
+    null_bitmap->Set(i, non_null);
+    num_non_null += static_cast<uint32_t>(non_null);
+  }
+
+  alignas(common::Constants::CACHELINE_SIZE) uint32_t out[num_elems] = {0};
+  alignas(common::Constants::CACHELINE_SIZE) uint32_t sel[num_elems] = {0};
+
+  // Unfiltered
+  auto found = VectorUtil::SelectNotNull(null_bitmap, num_elems, out, nullptr);
+  EXPECT_EQ(num_non_null, found);
+  for (uint32_t i = 0; i < found; i++) {
+    EXPECT_TRUE(null_bitmap->Test(out[i]));
+    if (i > 0) {
+      EXPECT_LT(out[i - 1], out[i]);
+    }
+  }
+  EXPECT_EQ(num_elems - num_non_null, VectorUtil::SelectNull(null_bitmap, num_elems, out, nullptr));
+
+  // Through a selection vector of the even elements
+  uint32_t num_sel = 0, expected = 0;
+  for (uint32_t i = 0; i < num_elems; i += 2) {
+    sel[num_sel++] = i;
+    expected += static_cast<uint32_t>(null_bitmap->Test(i));
+  }
+  found = VectorUtil::SelectNotNull(null_bitmap, num_sel, out, sel);
+  EXPECT_EQ(expected, found);
+  for (uint32_t i = 0; i < found; i++) {
+    EXPECT_TRUE(null_bitmap->Test(out[i]));
+    EXPECT_EQ(0u, out[i] % 2);
+  }
+  EXPECT_EQ(num_sel - expected, VectorUtil::SelectNull(null_bitmap, num_sel, out, sel));
+
+  common::RawBitmap::Deallocate(null_bitmap);
+}
+
+// NOLINTNEXTLINE
+TEST_F(VectorUtilTest, StringFilterTest) {
+  // Strings both short enough to be inlined and long enough to be stored out of line
+  const std::vector<std::string> strings = {"", "a", "ab", "abc", "abcd", "abcde", "abd", "b", "xxabcdxx",
+                                            "bcd_efg%hij", "abcdefghij", "abcdefghijkl", "abcdefghijklmnop",
+                                            "abcdefghijklmnoq"};
+  std::vector<storage::VarlenEntry> entries;
+  for (const auto &str : strings) {
+    const auto *content = reinterpret_cast<const byte *>(str.data());
+    entries.push_back(str.size() <= storage::VarlenEntry::InlineThreshold()
+                          ? storage::VarlenEntry::CreateInline(content, static_cast<uint32_t>(str.size()))
+                          : storage::VarlenEntry::Create(const_cast<byte *>(content),
+                                                         static_cast<uint32_t>(str.size()), false));
+  }
+  const auto num_elems = static_cast<uint32_t>(entries.size());
+  uint32_t out[32] = {0};
+
+  // Comparisons against a constant, checked against std::string
+  for (const auto &val : strings) {
+    uint32_t eq = 0, ne = 0, lt = 0, ge = 0;
+    for (const auto &str : strings) {
+      eq += static_cast<uint32_t>(str == val);
+      ne += static_cast<uint32_t>(str != val);
+      lt += static_cast<uint32_t>(str < val);
+      ge += static_cast<uint32_t>(str >= val);
+    }
+    EXPECT_EQ(eq, VectorUtil::FilterStringByVal<std::equal_to>(entries.data(), num_elems, val, out, nullptr));
+    EXPECT_EQ(ne, VectorUtil::FilterStringByVal<std::not_equal_to>(entries.data(), num_elems, val, out, nullptr));
+    EXPECT_EQ(lt, VectorUtil::FilterStringByVal<std::less>(entries.data(), num_elems, val, out, nullptr));
+    EXPECT_EQ(ge, VectorUtil::FilterStringByVal<std::greater_equal>(entries.data(), num_elems, val, out, nullptr));
+  }
+
+  // Comparison of two columns: the strings against themselves shifted by one
+  std::vector<storage::VarlenEntry> shifted(entries.begin() + 1, entries.end());
+  shifted.push_back(entries.front());
+  uint32_t lt = 0;
+  for (uint32_t i = 0; i < num_elems; i++) {
+    lt += static_cast<uint32_t>(entries[i].StringView() < shifted[i].StringView());
+  }
+  EXPECT_EQ(lt, VectorUtil::FilterStringByVector<std::less>(entries.data(), shifted.data(), num_elems, out, nullptr));
+
+  // Prefixes
+  EXPECT_EQ(10u, VectorUtil::FilterStringPrefix(entries.data(), num_elems, "a", out, nullptr));
+  EXPECT_EQ(5u, VectorUtil::FilterStringPrefix(entries.data(), num_elems, "abcde", out, nullptr));
+  EXPECT_EQ(2u, VectorUtil::FilterStringPrefix(entries.data(), num_elems, "abcdefghijklmno", out, nullptr));
+  EXPECT_EQ(num_elems, VectorUtil::FilterStringPrefix(entries.data(), num_elems, "", out, nullptr));
+
+  // LIKE, through every kind of pattern, checked against the general matcher
+  for (const std::string_view pattern : {"abc", "abc%", "%abcd%", "%", "", "a_c%", "%j", "%cd%kl%", "bcd\\_efg\\%%",
+                                         "_", "___", "%x%x%", "abcdefghijklmno_"}) {
+    uint32_t expected = 0;
+    for (const auto &str : strings) expected += static_cast<uint32_t>(VectorUtil::MatchLike(str, pattern));
+    const auto found = VectorUtil::FilterStringLike(entries.data(), num_elems, pattern, out, nullptr);
+    EXPECT_EQ(expected, found) << pattern;
+    for (uint32_t i = 0; i < found; i++) EXPECT_TRUE(VectorUtil::MatchLike(strings[out[i]], pattern));
+  }
+
+  // The general matcher itself
+  EXPECT_TRUE(VectorUtil::MatchLike("abcdefghij", "a%e%j"));
+  EXPECT_TRUE(VectorUtil::MatchLike("abcdefghij", "%%%"));
+  EXPECT_TRUE(VectorUtil::MatchLike("aaab", "%a_b"));
+  EXPECT_TRUE(VectorUtil::MatchLike("bcd_efg%hij", "bcd\\_efg\\%hij"));
+  EXPECT_FALSE(VectorUtil::MatchLike("bcdxefg%hij", "bcd\\_efg%"));
+  EXPECT_FALSE(VectorUtil::MatchLike("abcdefghij", "a%e%i"));
+  EXPECT_FALSE(VectorUtil::MatchLike("", "_"));
+  EXPECT_FALSE(VectorUtil::MatchLike("ab", "abc%"));
+
+  // Through a selection vector of the odd elements
+  uint32_t sel[32] = {0}, num_sel = 0;
+  for (uint32_t i = 1; i < num_elems; i += 2) sel[num_sel++] = i;
+  const auto found = VectorUtil::FilterStringLike(entries.data(), num_sel, "abc%", out, sel);
+  uint32_t expected = 0;
+  for (uint32_t i = 1; i < num_elems; i += 2) expected += static_cast<uint32_t>(strings[i].rfind("abc", 0) == 0);
+  EXPECT_EQ(expected, found);
+  for (uint32_t i = 0; i < found; i++) EXPECT_EQ(1u, out[i] % 2);
+}
+
 // NOLINTNEXTLINE
 TEST_F(VectorUtilTest, GatherTest) {
   auto array = AllocateArray<uint32_t>(800000);
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <string>
+
+#include "llvm/Support/FileSystem.h"
+
+#include "execution/tpl_test.h"
+#include "execution/vm/llvm_engine.h"
+
+namespace terrier::execution {
+
+/**
+ * Base class for tests that compile TPL to machine code. The LLVM engine loads the bytecode handlers' bitcode from the
+ * working directory, so it is copied there from the build directory, where building tpl generates it.
+ */
+class JitTest : public TplTest {
+ public:
+  static void SetUpTestCase() { vm::LLVMEngine::Initialize(); }
+
+  void SetUp() override {
+    TplTest::SetUp();
+    const std::string bc_path = vm::LLVMEngine::CompilerOptions().GetBytecodeHandlersBcPath();
+    if (!llvm::sys::fs::exists(bc_path)) {
+      ASSERT_FALSE(llvm::sys::fs::copy_file(BYTECODE_HANDLERS_BC_FILE, bc_path)) << "Is tpl built?";
+    }
+  }
+};
+
+}  // namespace terrier::execution
@@ -30,10 +30,11 @@ class ModuleCompiler {
     return ast;
   }
 
-  std::unique_ptr<Module> CompileToModule(const std::string &source) {
+  // String literals are allocated from the execution context, so sources using them need one
+  std::unique_ptr<Module> CompileToModule(const std::string &source, exec::ExecutionContext *exec_ctx = nullptr) {
     auto *ast = CompileToAst(source);
     if (HasErrors()) return nullptr;
-    return std::make_unique<Module>(vm::BytecodeGenerator::Compile(ast, nullptr, "test"));
+    return std::make_unique<Module>(vm::BytecodeGenerator::Compile(ast, exec_ctx, "test"));
   }
 
   // Does the error reporter have any errors?
@@ -0,0 +1,271 @@
+#include "storage/arrow_ipc_writer.h"
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "parser/expression/constant_value_expression.h"
+#include "storage/block_access_controller.h"
+#include "storage/block_compactor.h"
+#include "storage/garbage_collector.h"
+#include "storage/sql_table.h"
+#include "transaction/deferred_action_manager.h"
+#include "transaction/transaction_manager.h"
+#include "type/transient_value_factory.h"
+#include "util/catalog_test_util.h"
+#include "util/storage_test_util.h"
+#include "util/test_harness.h"
+
+namespace terrier {
+
+struct ArrowIpcWriterTest : public TerrierTest {
+  storage::BlockStore block_store_{100, 100};
+  storage::RecordBufferSegmentPool buffer_pool_{10000, 10000};
+  uint32_t num_tuples_;
+  const std::vector<std::string> tags_ = {"apple", "a much longer banana", "cherry"};
+  const std::vector<catalog::col_oid_t> col_oids_ = {catalog::col_oid_t(1), catalog::col_oid_t(2),
+                                                     catalog::col_oid_t(3), catalog::col_oid_t(4)};
+
+  static catalog::Schema::Column MakeColumn(const std::string &name, type::TypeId type, bool nullable,
+                                            catalog::col_oid_t oid) {
+    const parser::ConstantValueExpression default_value(type::TransientValueFactory::GetNull(type));
+    auto col = type == type::TypeId::VARCHAR ? catalog::Schema::Column(name, type, 100, nullable, default_value)
+                                             : catalog::Schema::Column(name, type, nullable, default_value);
+    StorageTestUtil::ForceOid(&col, oid);
+    return col;
+  }
+
+  catalog::Schema MakeSchema() const {
+    return catalog::Schema({MakeColumn("id", type::TypeId::BIGINT, false, col_oids_[0]),
+                            MakeColumn("val", type::TypeId::INTEGER, true, col_oids_[1]),
+                            MakeColumn("name", type::TypeId::VARCHAR, true, col_oids_[2]),
+                            MakeColumn("tag", type::TypeId::VARCHAR, true, col_oids_[3])});
+  }
+
+  static std::string Name(uint32_t i) { return std::string(i % 20, static_cast<char>('a' + i % 26)); }
+
+  static storage::VarlenEntry MakeVarlen(const std::string &str) {
+    const auto size = static_cast<uint32_t>(str.size());
+    if (size <= storage::VarlenEntry::InlineThreshold())
+      return storage::VarlenEntry::CreateInline(reinterpret_cast<const byte *>(str.data()), size);
+    byte *content = common::AllocationUtil::AllocateAligned(size);
+    std::memcpy(content, str.data(), size);
+    return storage::VarlenEntry::Create(content, size, true);
+  }
+
+  // Fills up the first block of the table with rows where the value of every column is determined by the id, and then
+  // compacts it with every varlen column stored as the given type
+  void PopulateAndFreeze(storage::SqlTable *table, transaction::TransactionManager *txn_manager,
+                         transaction::DeferredActionManager *deferred_action_manager, storage::GarbageCollector *gc,
+                         storage::ArrowColumnType varlen_type) {
+    storage::RawBlock *block = table->begin()->GetBlock();
+    const storage::BlockLayout &layout = block->data_table_->GetBlockLayout();
+    // The compactor only works on full blocks
+    num_tuples_ = layout.NumSlots();
+
+    auto initializer = table->InitializerForProjectedRow(col_oids_);
+    auto projection_map = table->ProjectionMapForOids(col_oids_);
+    auto *txn = txn_manager->BeginTransaction();
+    for (uint32_t i = 0; i < num_tuples_; i++) {
+      auto *redo = txn->StageWrite(CatalogTestUtil::TEST_DB_OID, CatalogTestUtil::TEST_TABLE_OID, initializer);
+      storage::ProjectedRow *row = redo->Delta();
+      *reinterpret_cast<int64_t *>(row->AccessForceNotNull(projection_map[col_oids_[0]])) = i;
+      if (i % 5 == 0)
+        row->SetNull(projection_map[col_oids_[1]]);
+      else
+        *reinterpret_cast<int32_t *>(row->AccessForceNotNull(projection_map[col_oids_[1]])) = i * 7;
+      if (i % 7 == 0)
+        row->SetNull(projection_map[col_oids_[2]]);
+      else
+        *reinterpret_cast<storage::VarlenEntry *>(row->AccessForceNotNull(projection_map[col_oids_[2]])) =
+            MakeVarlen(Name(i));
+      *reinterpret_cast<storage::VarlenEntry *>(row->AccessForceNotNull(projection_map[col_oids_[3]])) =
+          MakeVarlen(tags_[i % tags_.size()]);
+      EXPECT_EQ(block, table->Insert(txn, redo).GetBlock());
+    }
+    txn_manager->Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+    storage::TupleAccessStrategy accessor(layout);
+    auto &arrow_metadata = accessor.GetArrowBlockMetadata(block);
+    for (storage::col_id_t col_id : layout.AllColumns())
+      arrow_metadata.GetColumnInfo(layout, col_id).Type() =
+          layout.IsVarlen(col_id) ? varlen_type : storage::ArrowColumnType::FIXED_LENGTH;
+
+    storage::BlockCompactor compactor;
+    compactor.PutInQueue(block);
+    compactor.ProcessCompactionQueue(deferred_action_manager, txn_manager);  // compaction pass
+    gc->PerformGarbageCollection();
+    compactor.PutInQueue(block);
+    compactor.ProcessCompactionQueue(deferred_action_manager, txn_manager);  // gathering pass
+    EXPECT_EQ(storage::BlockState::FROZEN, block->controller_.GetBlockState()->load());
+  }
+
+  static std::string VarlenAt(const storage::ArrowBlockView &view, uint16_t col, uint32_t i) {
+    const uint32_t *offsets = view.Offsets(col);
+    return std::string(reinterpret_cast<const char *>(view.Values(col)) + offsets[i], offsets[i + 1] - offsets[i]);
+  }
+
+  // Checks every value in the view against what PopulateAndFreeze inserted
+  void CheckView(const storage::ArrowBlockView &view, storage::ArrowColumnType varlen_type) {
+    EXPECT_EQ(num_tuples_, view.NumRecords());
+    EXPECT_EQ(storage::ArrowColumnType::FIXED_LENGTH, view.ColumnType(0));
+    EXPECT_EQ(storage::ArrowColumnType::FIXED_LENGTH, view.ColumnType(1));
+    EXPECT_EQ(varlen_type, view.ColumnType(2));
+    EXPECT_EQ(varlen_type, view.ColumnType(3));
+    EXPECT_EQ(0, view.NullCount(0));
+    EXPECT_EQ((num_tuples_ + 4) / 5, view.NullCount(1));
+    EXPECT_EQ((num_tuples_ + 6) / 7, view.NullCount(2));
+    EXPECT_EQ(0, view.NullCount(3));
+
+    std::vector<bool> seen(num_tuples_, false);
+    for (uint32_t i = 0; i < view.NumRecords(); i++) {
+      const auto *validity = reinterpret_cast<const common::RawBitmap *>(view.Validity(0));
+      ASSERT_TRUE(validity->Test(i));
+      const auto id = static_cast<uint32_t>(reinterpret_cast<const int64_t *>(view.Values(0))[i]);
+      ASSERT_LT(id, num_tuples_);
+      EXPECT_FALSE(seen[id]);
+      seen[id] = true;
+
+      validity = reinterpret_cast<const common::RawBitmap *>(view.Validity(1));
+      EXPECT_EQ(id % 5 != 0, validity->Test(i));
+      if (id % 5 != 0) {
+        EXPECT_EQ(id * 7, reinterpret_cast<const int32_t *>(view.Values(1))[i]);
+      }
+
+      validity = reinterpret_cast<const common::RawBitmap *>(view.Validity(2));
+      EXPECT_EQ(id % 7 != 0, validity->Test(i));
+      if (varlen_type == storage::ArrowColumnType::GATHERED_VARLEN) {
+        if (id % 7 != 0) {
+          EXPECT_EQ(Name(id), VarlenAt(view, 2, i));
+        }
+        EXPECT_EQ(tags_[id % tags_.size()], VarlenAt(view, 3, i));
+      } else {
+        if (id % 7 != 0) {
+          EXPECT_EQ(Name(id), VarlenAt(view, 2, view.Indices(2)[i]));
+        }
+        EXPECT_EQ(tags_[id % tags_.size()], VarlenAt(view, 3, view.Indices(3)[i]));
+      }
+    }
+    if (varlen_type == storage::ArrowColumnType::DICTIONARY_COMPRESSED) {
+      EXPECT_EQ(tags_.size() + 1, view.OffsetsLength(3));
+    }
+  }
+
+  // Returns the address of a field in a flatbuffer table, or nullptr if the field is not present
+  static const byte *FieldAddress(const byte *table, uint16_t field_id) {
+    const byte *vtable = table - *reinterpret_cast<const int32_t *>(table);
+    const auto slot = static_cast<uint16_t>((field_id + 2) * sizeof(uint16_t));
+    if (slot >= *reinterpret_cast<const uint16_t *>(vtable)) return nullptr;
+    const uint16_t field_offset = *reinterpret_cast<const uint16_t *>(vtable + slot);
+    return field_offset == 0 ? nullptr : table + field_offset;
+  }
+
+  template <class T>
+  static T ReadField(const byte *table, uint16_t field_id, T default_value) {
+    const byte *field = FieldAddress(table, field_id);
+    if (field == nullptr) return default_value;
+    T result;
+    std::memcpy(&result, field, sizeof(T));
+    return result;
+  }
+
+  static const byte *ReadTableField(const byte *table, uint16_t field_id) {
+    const byte *field = FieldAddress(table, field_id);
+    return field + *reinterpret_cast<const uint32_t *>(field);
+  }
+
+  // Walks the messages in an Arrow IPC stream, and returns the header type of every message in order. Also checks
+  // that every record batch has the expected length.
+  static std::vector<uint8_t> ReadMessageTypes(const std::string &stream, uint32_t expected_length) {
+    std::vector<uint8_t> result;
+    const auto *data = reinterpret_cast<const byte *>(stream.data());
+    uint64_t pos = 0;
+    while (true) {
+      EXPECT_LE(pos + 8, stream.size());
+      EXPECT_EQ(0, pos % 8);
+      EXPECT_EQ(0xFFFFFFFF, *reinterpret_cast<const uint32_t *>(data + pos));
+      const int32_t metadata_size = *reinterpret_cast<const int32_t *>(data + pos + 4);
+      pos += 8;
+      if (metadata_size == 0) break;
+      EXPECT_EQ(0, metadata_size % 8);
+
+      const byte *message = data + pos + *reinterpret_cast<const uint32_t *>(data + pos);
+      EXPECT_EQ(4, ReadField<int16_t>(message, 0, 0));
+      const auto header_type = ReadField<uint8_t>(message, 1, 0);
+      result.push_back(header_type);
+      if (header_type == 3) {
+        const byte *record_batch = ReadTableField(message, 2);
+        EXPECT_EQ(expected_length, ReadField<int64_t>(record_batch, 0, 0));
+      }
+      const auto body_length = ReadField<int64_t>(message, 3, 0);
+      EXPECT_EQ(0, body_length % 8);
+      pos += metadata_size + body_length;
+    }
+    EXPECT_EQ(stream.size(), pos);
+    return result;
+  }
+};
+
+// Tests that the zero-copy view of a frozen block exposes the correct Arrow buffers for all column types
+// NOLINTNEXTLINE
+TEST_F(ArrowIpcWriterTest, ExportFrozenBlocksTest) {
+  for (auto varlen_type :
+       {storage::ArrowColumnType::GATHERED_VARLEN, storage::ArrowColumnType::DICTIONARY_COMPRESSED}) {
+    transaction::TimestampManager timestamp_manager;
+    transaction::DeferredActionManager deferred_action_manager{&timestamp_manager};
+    transaction::TransactionManager txn_manager(&timestamp_manager, &deferred_action_manager, &buffer_pool_, true,
+                                                DISABLED);
+    storage::GarbageCollector gc(&timestamp_manager, &deferred_action_manager, &txn_manager, DISABLED);
+    storage::SqlTable table(&block_store_, MakeSchema());
+
+    // Nothing is frozen yet, so nothing should be exported
+    uint32_t num_visited = 0;
+    EXPECT_EQ(1, table.ExportFrozenBlocks(col_oids_, [&](const storage::ArrowBlockView &) { num_visited++; }));
+    EXPECT_EQ(0, num_visited);
+
+    PopulateAndFreeze(&table, &txn_manager, &deferred_action_manager, &gc, varlen_type);
+    EXPECT_EQ(0, table.ExportFrozenBlocks(col_oids_, [&](const storage::ArrowBlockView &view) {
+      num_visited++;
+      // Exporting is a read in-place, and should not change the block state
+      EXPECT_EQ(storage::BlockState::FROZEN, view.GetBlock()->controller_.GetBlockState()->load());
+      CheckView(view, varlen_type);
+    }));
+    EXPECT_EQ(1, num_visited);
+
+    gc.PerformGarbageCollection();
+    gc.PerformGarbageCollection();  // Second call to deallocate.
+  }
+}
+
+// Tests that the stream written out for a table is well-formed and contains a record batch for the frozen block
+// NOLINTNEXTLINE
+TEST_F(ArrowIpcWriterTest, WriteTableTest) {
+  for (auto varlen_type :
+       {storage::ArrowColumnType::GATHERED_VARLEN, storage::ArrowColumnType::DICTIONARY_COMPRESSED}) {
+    transaction::TimestampManager timestamp_manager;
+    transaction::DeferredActionManager deferred_action_manager{&timestamp_manager};
+    transaction::TransactionManager txn_manager(&timestamp_manager, &deferred_action_manager, &buffer_pool_, true,
+                                                DISABLED);
+    storage::GarbageCollector gc(&timestamp_manager, &deferred_action_manager, &txn_manager, DISABLED);
+    catalog::Schema schema = MakeSchema();
+    storage::SqlTable table(&block_store_, schema);
+
+    // A table without frozen blocks still has a valid stream, with just the schema in it
+    std::ostringstream empty_stream;
+    EXPECT_EQ(1, storage::ArrowIpcWriter(&empty_stream).WriteTable(table, schema));
+    EXPECT_EQ(std::vector<uint8_t>({1}), ReadMessageTypes(empty_stream.str(), 0));
+
+    PopulateAndFreeze(&table, &txn_manager, &deferred_action_manager, &gc, varlen_type);
+    std::ostringstream stream;
+    EXPECT_EQ(0, storage::ArrowIpcWriter(&stream).WriteTable(table, schema));
+    // Dictionary compressed columns have their dictionaries sent ahead of the record batch
+    const std::vector<uint8_t> expected = varlen_type == storage::ArrowColumnType::GATHERED_VARLEN
+                                              ? std::vector<uint8_t>({1, 3})
+                                              : std::vector<uint8_t>({1, 2, 2, 3});
+    EXPECT_EQ(expected, ReadMessageTypes(stream.str(), num_tuples_));
+
+    gc.PerformGarbageCollection();
+    gc.PerformGarbageCollection();  // Second call to deallocate.
+  }
+}
+
+}  // namespace terrier
@@ -1,5 +1,6 @@
 #include "storage/block_compactor.h"
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 #include "common/hash_util.h"
 #include "storage/block_access_controller.h"
@@ -71,9 +72,8 @@ struct BlockCompactorTest : public ::terrier::TerrierTest {
 // compact and its contents unmodified.
 // NOLINTNEXTLINE
 TEST_F(BlockCompactorTest, CompactionTest) {
-  // TODO(Tianyu): This test currently still only tests one block at a time. We do this because the implementation
-  // only compacts block-at-a-time, although the logic handles more blocks. When we change that to have a more
-  // intelligent policy, we need to rewrite this test as well.
+  // Compaction of a single block only shuffles tuples within it. MultiBlockCompactionTest covers moving tuples across
+  // blocks in a group.
   uint32_t repeat = 10;
   for (uint32_t iteration = 0; iteration < repeat; iteration++) {
     storage::BlockLayout layout = StorageTestUtil::RandomLayoutWithVarlens(100, &generator_);
@@ -371,4 +371,182 @@ TEST_F(BlockCompactorTest, DictionaryCompressionTest) {
   }
 }
 
+// This tests generates random single blocks in a table and freezes them. It then verifies that scans, which copy frozen
+// blocks in bulk, return the same tuples as reading the block tuple-at-a-time, and that they do not thaw the block.
+// NOLINTNEXTLINE
+TEST_F(BlockCompactorTest, FrozenScanTest) {
+  uint32_t repeat = 10;
+  for (uint32_t iteration = 0; iteration < repeat; iteration++) {
+    storage::BlockLayout layout = StorageTestUtil::RandomLayoutWithVarlens(100, &generator_);
+    storage::TupleAccessStrategy accessor(layout);
+    // Unlike the other tests, we need the block to be in the table so a sequential scan can reach it
+    storage::DataTable table(&block_store_, layout, storage::layout_version_t(0));
+    storage::RawBlock *block = table.begin()->GetBlock();
+
+    // Enable GC to cleanup transactions started by the block compactor
+    transaction::TimestampManager timestamp_manager;
+    transaction::DeferredActionManager deferred_action_manager{&timestamp_manager};
+    transaction::TransactionManager txn_manager(&timestamp_manager, &deferred_action_manager, &buffer_pool_, true,
+                                                DISABLED);
+    storage::GarbageCollector gc(&timestamp_manager, &deferred_action_manager, &txn_manager, DISABLED);
+
+    auto tuples = StorageTestUtil::PopulateBlockRandomly(&table, block, percent_empty_, &generator_);
+    auto num_tuples = tuples.size();
+
+    // Manually populate the block header's arrow metadata for test initialization
+    auto &arrow_metadata = accessor.GetArrowBlockMetadata(block);
+    for (storage::col_id_t col_id : layout.AllColumns()) {
+      if (layout.IsVarlen(col_id)) {
+        arrow_metadata.GetColumnInfo(layout, col_id).Type() = storage::ArrowColumnType::GATHERED_VARLEN;
+      } else {
+        arrow_metadata.GetColumnInfo(layout, col_id).Type() = storage::ArrowColumnType::FIXED_LENGTH;
+      }
+    }
+
+    storage::BlockCompactor compactor;
+    compactor.PutInQueue(block);
+    compactor.ProcessCompactionQueue(&deferred_action_manager, &txn_manager);  // compaction pass
+
+    // Need to prune the version chain in order to make sure that the second pass succeeds
+    gc.PerformGarbageCollection();
+    compactor.PutInQueue(block);
+    compactor.ProcessCompactionQueue(&deferred_action_manager, &txn_manager);  // gathering pass
+    EXPECT_EQ(storage::BlockState::FROZEN, block->controller_.GetBlockState()->load());
+
+    auto row_initializer =
+        storage::ProjectedRowInitializer::Create(layout, StorageTestUtil::ProjectionListAllColumns(layout));
+    byte *row_buffer = common::AllocationUtil::AllocateAligned(row_initializer.ProjectedRowSize());
+    auto *read_row = row_initializer.InitializeRow(row_buffer);
+    // Use an odd-sized output buffer so that scans stop in the middle of the block and at unaligned offsets
+    storage::ProjectedColumnsInitializer columns_initializer(layout, StorageTestUtil::ProjectionListAllColumns(layout),
+                                                             layout.NumSlots() / 3 + 1);
+    byte *columns_buffer = common::AllocationUtil::AllocateAligned(columns_initializer.ProjectedColumnsSize());
+    storage::ProjectedColumns *columns = columns_initializer.Initialize(columns_buffer);
+
+    transaction::TransactionContext *txn = txn_manager.BeginTransaction();
+    uint32_t num_scanned = 0;
+    auto it = table.begin();
+    while (it != table.end()) {
+      table.Scan(txn, &it, columns);
+      for (uint32_t i = 0; i < columns->NumTuples(); i++) {
+        EXPECT_EQ(storage::TupleSlot(block, num_scanned), columns->TupleSlots()[i]);
+        storage::ProjectedColumns::RowView scanned = columns->InterpretAsRow(i);
+        EXPECT_TRUE(table.Select(txn, columns->TupleSlots()[i], read_row));
+        EXPECT_TRUE(StorageTestUtil::ProjectionListEqualDeep(layout, &scanned, read_row));
+        num_scanned++;
+      }
+    }
+    EXPECT_EQ(num_tuples, num_scanned);
+    // Scans are reads in-place, and should not have changed the block state
+    EXPECT_EQ(storage::BlockState::FROZEN, block->controller_.GetBlockState()->load());
+
+    txn_manager.Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);  // Commit: will be cleaned up by GC
+    delete[] row_buffer;
+    delete[] columns_buffer;
+
+    for (auto &entry : tuples) delete[] reinterpret_cast<byte *>(entry.second);  // reclaim memory used for bookkeeping
+
+    gc.PerformGarbageCollection();
+    gc.PerformGarbageCollection();  // Second call to deallocate.
+    // The table owns the block, and frees it along with its gathered varlens when it is destructed
+  }
+}
+
+// This test fills up a table through regular inserts, deletes most of the tuples, and then compacts all of its blocks
+// in parallel groups. It verifies that the tuples are packed into as few blocks as possible, the emptied blocks are
+// taken out of the table, and the logical contents of the table do not change.
+// NOLINTNEXTLINE
+TEST_F(BlockCompactorTest, MultiBlockCompactionTest) {
+  uint32_t repeat = 5;
+  const uint32_t num_blocks = 8;
+  const uint32_t blocks_per_group = 4;
+  const double percent_deleted = 0.7;
+  common::WorkerPool thread_pool(num_blocks / blocks_per_group, {});
+  for (uint32_t iteration = 0; iteration < repeat; iteration++) {
+    // Varlens would be reclaimed by the GC after their tuples are moved, so stick to fixed length columns here to keep
+    // the reference tuples valid
+    storage::BlockLayout layout = StorageTestUtil::RandomLayoutNoVarlen(100, &generator_);
+    storage::DataTable table(&block_store_, layout, storage::layout_version_t(0));
+
+    transaction::TimestampManager timestamp_manager;
+    transaction::DeferredActionManager deferred_action_manager{&timestamp_manager};
+    transaction::TransactionManager txn_manager(&timestamp_manager, &deferred_action_manager, &buffer_pool_, true,
+                                                DISABLED);
+    storage::GarbageCollector gc(&timestamp_manager, &deferred_action_manager, &txn_manager, DISABLED);
+
+    // Fill up exactly num_blocks blocks, so that all of them are full and eligible for compaction
+    auto initializer =
+        storage::ProjectedRowInitializer::Create(layout, StorageTestUtil::ProjectionListAllColumns(layout));
+    std::unordered_map<storage::TupleSlot, storage::ProjectedRow *> tuples;
+    std::unordered_set<storage::RawBlock *> blocks;
+    transaction::TransactionContext *txn = txn_manager.BeginTransaction();
+    for (uint32_t i = 0; i < num_blocks * layout.NumSlots(); i++) {
+      byte *buffer = common::AllocationUtil::AllocateAligned(initializer.ProjectedRowSize());
+      storage::ProjectedRow *row = initializer.InitializeRow(buffer);
+      StorageTestUtil::PopulateRandomRow(row, layout, 0.1, &generator_);
+      storage::TupleSlot slot = table.Insert(txn, *row);
+      tuples[slot] = row;
+      blocks.insert(slot.GetBlock());
+    }
+    txn_manager.Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+    ASSERT_EQ(num_blocks, blocks.size());
+
+    txn = txn_manager.BeginTransaction();
+    std::bernoulli_distribution delete_dist(percent_deleted);
+    for (auto it = tuples.begin(); it != tuples.end();) {
+      if (!delete_dist(generator_)) {
+        ++it;
+        continue;
+      }
+      EXPECT_TRUE(table.Delete(txn, it->first));
+      delete[] reinterpret_cast<byte *>(it->second);
+      it = tuples.erase(it);
+    }
+    txn_manager.Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+    // Prune the deletes so that their slots show up as gaps
+    gc.PerformGarbageCollection();
+    gc.PerformGarbageCollection();
+    auto num_tuples = tuples.size();
+    auto tuple_set = GetTupleSet(layout, tuples);
+
+    storage::BlockCompactor compactor(blocks_per_group, &thread_pool);
+    for (storage::RawBlock *block : blocks) compactor.PutInQueue(block);
+    compactor.ProcessCompactionQueue(&deferred_action_manager, &txn_manager);
+    // Emptied blocks are taken out of the table and released only after two rounds of deferred actions
+    for (uint32_t i = 0; i < 4; i++) gc.PerformGarbageCollection();
+
+    // Every group should have packed its tuples into as few blocks as possible, and given the rest back
+    std::unordered_set<storage::RawBlock *> remaining_blocks;
+    for (auto it = table.begin(); it != table.end(); ++it) remaining_blocks.insert(it->GetBlock());
+    // Each group keeps at most one partially filled block
+    EXPECT_LE(remaining_blocks.size(), num_tuples / layout.NumSlots() + num_blocks / blocks_per_group);
+    EXPECT_LT(remaining_blocks.size(), num_blocks);
+    for (storage::RawBlock *block : remaining_blocks) EXPECT_EQ(1, blocks.count(block));
+
+    // A full scan should see exactly the tuples that survived the deletes
+    byte *buffer = common::AllocationUtil::AllocateAligned(initializer.ProjectedRowSize());
+    auto *read_row = initializer.InitializeRow(buffer);
+    txn = txn_manager.BeginTransaction();
+    uint32_t num_visible = 0;
+    for (auto it = table.begin(); it != table.end(); ++it) {
+      if (!table.Select(txn, *it, read_row)) continue;
+      num_visible++;
+      auto entry = tuple_set.find(read_row);
+      EXPECT_NE(entry, tuple_set.end());  // Should be present in the original
+      if (entry != tuple_set.end()) {
+        EXPECT_GT(entry->second, 0);
+        entry->second--;
+      }
+    }
+    txn_manager.Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+    delete[] buffer;
+    EXPECT_EQ(num_tuples, num_visible);
+    for (auto &entry : tuple_set) EXPECT_EQ(entry.second, 0);
+
+    for (auto &entry : tuples) delete[] reinterpret_cast<byte *>(entry.second);
+    gc.PerformGarbageCollection();
+    gc.PerformGarbageCollection();
+  }
+}
+
 }  // namespace terrier
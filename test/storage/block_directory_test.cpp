@@ -0,0 +1,59 @@
+#include "storage/block_directory.h"
+#include <atomic>
+#include <unordered_set>
+#include <vector>
+#include "util/multithread_test_util.h"
+#include "util/test_harness.h"
+
+namespace terrier {
+struct BlockDirectoryTests : public TerrierTest {
+  // The directory never looks at the blocks, so any distinct non-null pointer will do
+  static storage::RawBlock *FakeBlock(const uint64_t id) { return reinterpret_cast<storage::RawBlock *>(id + 1); }
+};
+
+// Appends enough blocks to span several chunks and checks that every index reads back what was appended to it
+// NOLINTNEXTLINE
+TEST_F(BlockDirectoryTests, SimpleAppend) {
+  const uint32_t num_blocks = 10000;
+  storage::BlockDirectory tested;
+  EXPECT_EQ(0, tested.Size());
+  for (uint32_t i = 0; i < num_blocks; i++) {
+    EXPECT_EQ(i, tested.Append(FakeBlock(i)));
+    EXPECT_EQ(i + 1, tested.Size());
+  }
+  for (uint32_t i = 0; i < num_blocks; i++) EXPECT_EQ(FakeBlock(i), tested[i]);
+}
+
+// Multiple threads append to the directory while another thread keeps reading all of it. Readers should never see an
+// index that has not been written, and no append should be lost.
+// NOLINTNEXTLINE
+TEST_F(BlockDirectoryTests, ConcurrentAppend) {
+  const uint32_t num_iterations = 10;
+  const uint32_t num_blocks = 100000;
+  const uint32_t num_threads = MultiThreadTestUtil::HardwareConcurrency() + 1;
+  common::WorkerPool thread_pool(num_threads, {});
+  for (uint32_t iteration = 0; iteration < num_iterations; iteration++) {
+    storage::BlockDirectory tested;
+    std::atomic<uint32_t> num_finished = 0;
+    const uint32_t num_writers = num_threads - 1;
+    auto workload = [&](uint32_t id) {
+      if (id == num_writers) {
+        // Reader, keep going until all the writers are done
+        while (num_finished.load() != num_writers) {
+          const uint32_t size = tested.Size();
+          for (uint32_t i = 0; i < size; i++) EXPECT_NE(nullptr, tested[i]);
+        }
+        return;
+      }
+      for (uint32_t i = id; i < num_blocks; i += num_writers) tested.Append(FakeBlock(i));
+      num_finished++;
+    };
+    MultiThreadTestUtil::RunThreadsUntilFinish(&thread_pool, num_threads, workload);
+
+    EXPECT_EQ(num_blocks, tested.Size());
+    std::unordered_set<storage::RawBlock *> seen;
+    for (uint32_t i = 0; i < num_blocks; i++) EXPECT_TRUE(seen.insert(tested[i]).second);
+    for (uint32_t i = 0; i < num_blocks; i++) EXPECT_EQ(1, seen.count(FakeBlock(i)));
+  }
+}
+}  // namespace terrier
@@ -0,0 +1,315 @@
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <utility>
+#include <vector>
+#include "parser/expression/column_value_expression.h"
+#include "storage/garbage_collector_thread.h"
+#include "storage/index/index_builder.h"
+#include "storage/projected_row.h"
+#include "storage/sql_table.h"
+#include "transaction/transaction_context.h"
+#include "transaction/transaction_manager.h"
+#include "type/type_id.h"
+#include "util/catalog_test_util.h"
+#include "util/storage_test_util.h"
+#include "util/test_harness.h"
+
+namespace terrier::storage::index {
+
+/**
+ * Tests of the BPlusTreeIndex under loads that the tests shared with the other index types do not get to: enough
+ * entries to grow the tree by several levels, and many threads working on the same few nodes. See index_test.cpp for
+ * the rest.
+ */
+class BPlusTreeIndexTests : public TerrierTest {
+ private:
+  const std::chrono::milliseconds gc_period_{10};
+  storage::GarbageCollector *gc_;
+  storage::GarbageCollectorThread *gc_thread_;
+
+  storage::BlockStore block_store_{1000, 1000};
+  storage::RecordBufferSegmentPool buffer_pool_{1000000, 1000000};
+  catalog::Schema table_schema_;
+  catalog::IndexSchema default_schema_;
+
+ public:
+  BPlusTreeIndexTests() {
+    auto col = catalog::Schema::Column(
+        "attribute", type::TypeId::INTEGER, false,
+        parser::ConstantValueExpression(type::TransientValueFactory::GetNull(type::TypeId::INTEGER)));
+    StorageTestUtil::ForceOid(&(col), catalog::col_oid_t(1));
+    table_schema_ = catalog::Schema({col});
+    sql_table_ = new storage::SqlTable(&block_store_, table_schema_);
+    tuple_initializer_ = sql_table_->InitializerForProjectedRow({catalog::col_oid_t(1)});
+
+    std::vector<catalog::IndexSchema::Column> keycols;
+    keycols.emplace_back("", type::TypeId::INTEGER, false,
+                         parser::ColumnValueExpression(CatalogTestUtil::TEST_DB_OID, CatalogTestUtil::TEST_TABLE_OID,
+                                                       catalog::col_oid_t(1)));
+    StorageTestUtil::ForceOid(&(keycols[0]), catalog::indexkeycol_oid_t(1));
+    default_schema_ = catalog::IndexSchema(keycols, storage::index::IndexType::BPLUSTREE, false, false, false, true);
+  }
+
+  std::default_random_engine generator_;
+  const uint32_t num_threads_ = 4;
+
+  // SqlTable
+  storage::SqlTable *sql_table_;
+  storage::ProjectedRowInitializer tuple_initializer_ =
+      storage::ProjectedRowInitializer::Create(std::vector<uint8_t>{1}, std::vector<uint16_t>{1});
+
+  // BPlusTreeIndex
+  Index *default_index_;
+  transaction::TimestampManager *timestamp_manager_;
+  transaction::DeferredActionManager *deferred_action_manager_;
+  transaction::TransactionManager *txn_manager_;
+
+  byte *key_buffer_1_, *key_buffer_2_;
+
+  common::WorkerPool thread_pool_{num_threads_, {}};
+
+  // Inserts a tuple with the given key into the table and the index
+  storage::TupleSlot InsertKey(transaction::TransactionContext *const txn, ProjectedRow *const key_pr,
+                               const int32_t key) {
+    auto *const insert_redo =
+        txn->StageWrite(CatalogTestUtil::TEST_DB_OID, CatalogTestUtil::TEST_TABLE_OID, tuple_initializer_);
+    *reinterpret_cast<int32_t *>(insert_redo->Delta()->AccessForceNotNull(0)) = key;
+    const auto tuple_slot = sql_table_->Insert(txn, insert_redo);
+    *reinterpret_cast<int32_t *>(key_pr->AccessForceNotNull(0)) = key;
+    EXPECT_TRUE(default_index_->Insert(txn, *key_pr, tuple_slot));
+    return tuple_slot;
+  }
+
+  // Reads the key of every tuple back from the table, in order
+  std::vector<int32_t> KeysOf(transaction::TransactionContext *const txn,
+                              const std::vector<storage::TupleSlot> &slots) const {
+    auto *const buffer = common::AllocationUtil::AllocateAligned(tuple_initializer_.ProjectedRowSize());
+    auto *const tuple = tuple_initializer_.InitializeRow(buffer);
+    std::vector<int32_t> keys;
+    for (const auto slot : slots) {
+      EXPECT_TRUE(sql_table_->Select(txn, slot, tuple));
+      keys.push_back(*reinterpret_cast<int32_t *>(tuple->AccessForceNotNull(0)));
+    }
+    delete[] buffer;
+    return keys;
+  }
+
+ protected:
+  void SetUp() override {
+    TerrierTest::SetUp();
+
+    timestamp_manager_ = new transaction::TimestampManager;
+    deferred_action_manager_ = new transaction::DeferredActionManager(timestamp_manager_);
+    txn_manager_ = new transaction::TransactionManager(timestamp_manager_, deferred_action_manager_, &buffer_pool_,
+                                                       true, DISABLED);
+    gc_ = new storage::GarbageCollector(timestamp_manager_, deferred_action_manager_, txn_manager_, DISABLED);
+    gc_thread_ = new storage::GarbageCollectorThread(gc_, gc_period_);
+
+    default_index_ = (IndexBuilder().SetKeySchema(default_schema_)).Build();
+
+    gc_thread_->GetGarbageCollector().RegisterIndexForGC(common::ManagedPointer<Index>(default_index_));
+
+    key_buffer_1_ =
+        common::AllocationUtil::AllocateAligned(default_index_->GetProjectedRowInitializer().ProjectedRowSize());
+    key_buffer_2_ =
+        common::AllocationUtil::AllocateAligned(default_index_->GetProjectedRowInitializer().ProjectedRowSize());
+  }
+  void TearDown() override {
+    gc_thread_->GetGarbageCollector().UnregisterIndexForGC(common::ManagedPointer<Index>(default_index_));
+
+    delete gc_thread_;
+    delete gc_;
+    delete sql_table_;
+    delete default_index_;
+    delete[] key_buffer_1_;
+    delete[] key_buffer_2_;
+    delete txn_manager_;
+    delete deferred_action_manager_;
+    delete timestamp_manager_;
+    TerrierTest::TearDown();
+  }
+};
+
+/**
+ * Threads insert interleaved keys, so that they keep splitting the same leaves, and then all insert tuples for one
+ * key, so that they split a run of equal keys. A node holds a few hundred entries at most, so the tree grows to at
+ * least three levels and inner nodes split as well. Every tuple should be found exactly once, in key order.
+ */
+// NOLINTNEXTLINE
+TEST_F(BPlusTreeIndexTests, ConcurrentSplits) {
+  const uint32_t num_inserts = 50000;  // number of keys for each worker to insert
+  const int32_t shared_key = -1;
+  auto workload = [&](uint32_t worker_id) {
+    auto *const key_buffer =
+        common::AllocationUtil::AllocateAligned(default_index_->GetProjectedRowInitializer().ProjectedRowSize());
+    auto *const insert_key = default_index_->GetProjectedRowInitializer().InitializeRow(key_buffer);
+    for (uint32_t i = 0; i < num_inserts; i += 100) {
+      auto *const insert_txn = txn_manager_->BeginTransaction();
+      for (uint32_t j = i; j < i + 100; j++)
+        InsertKey(insert_txn, insert_key, static_cast<int32_t>(j * num_threads_ + worker_id));
+      txn_manager_->Commit(insert_txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+    }
+    auto *const insert_txn = txn_manager_->BeginTransaction();
+    for (uint32_t i = 0; i < num_inserts / 10; i++) InsertKey(insert_txn, insert_key, shared_key);
+    txn_manager_->Commit(insert_txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+    delete[] key_buffer;
+  };
+
+  for (uint32_t i = 0; i < num_threads_; i++) {
+    thread_pool_.SubmitTask([i, &workload] { workload(i); });
+  }
+  thread_pool_.WaitUntilAllFinished();
+
+  auto *const scan_txn = txn_manager_->BeginTransaction();
+  std::vector<storage::TupleSlot> results;
+  auto *const low_key_pr = default_index_->GetProjectedRowInitializer().InitializeRow(key_buffer_1_);
+  auto *const high_key_pr = default_index_->GetProjectedRowInitializer().InitializeRow(key_buffer_2_);
+
+  *reinterpret_cast<int32_t *>(low_key_pr->AccessForceNotNull(0)) = shared_key;
+  default_index_->ScanKey(*scan_txn, *low_key_pr, &results);
+  EXPECT_EQ(num_inserts / 10 * num_threads_, results.size());
+  results.clear();
+
+  *reinterpret_cast<int32_t *>(low_key_pr->AccessForceNotNull(0)) = 0;
+  *reinterpret_cast<int32_t *>(high_key_pr->AccessForceNotNull(0)) = num_inserts * num_threads_;
+  default_index_->ScanAscending(*scan_txn, *low_key_pr, *high_key_pr, &results);
+  const auto keys = KeysOf(scan_txn, results);
+  ASSERT_EQ(num_inserts * num_threads_, keys.size());
+  for (uint32_t i = 0; i < keys.size(); i++) EXPECT_EQ(static_cast<int32_t>(i), keys[i]);
+
+  txn_manager_->Commit(scan_txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+}
+
+/**
+ * Writers keep inserting tuples for a handful of keys and aborting, which deletes the entries again, while readers
+ * scan the same keys. Everybody works on the same few leaves, so lock attempts and version checks keep failing and
+ * operations restart. Readers should still always see exactly the committed tuples, in key order.
+ */
+// NOLINTNEXTLINE
+TEST_F(BPlusTreeIndexTests, ContendedRestarts) {
+  const int32_t num_keys = 16;
+  const uint32_t tuples_per_key = 8;
+  const uint32_t num_aborts = 20000;  // number of inserts for each writer to abort
+  const uint32_t num_writers = num_threads_ / 2;
+
+  auto *const key_pr = default_index_->GetProjectedRowInitializer().InitializeRow(key_buffer_1_);
+  auto *const populate_txn = txn_manager_->BeginTransaction();
+  for (int32_t key = 0; key < num_keys; key++)
+    for (uint32_t i = 0; i < tuples_per_key; i++) InsertKey(populate_txn, key_pr, key);
+  txn_manager_->Commit(populate_txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+  std::atomic<uint32_t> num_writers_done = 0;
+  auto workload = [&](uint32_t worker_id) {
+    auto *const key_buffer_1 =
+        common::AllocationUtil::AllocateAligned(default_index_->GetProjectedRowInitializer().ProjectedRowSize());
+    auto *const key_buffer_2 =
+        common::AllocationUtil::AllocateAligned(default_index_->GetProjectedRowInitializer().ProjectedRowSize());
+    auto *const low_key_pr = default_index_->GetProjectedRowInitializer().InitializeRow(key_buffer_1);
+    auto *const high_key_pr = default_index_->GetProjectedRowInitializer().InitializeRow(key_buffer_2);
+    std::default_random_engine generator(worker_id);
+    std::uniform_int_distribution<int32_t> key_dist(0, num_keys - 1);
+
+    if (worker_id < num_writers) {
+      for (uint32_t i = 0; i < num_aborts; i++) {
+        auto *const insert_txn = txn_manager_->BeginTransaction();
+        InsertKey(insert_txn, low_key_pr, key_dist(generator));
+        txn_manager_->Abort(insert_txn);
+      }
+      num_writers_done++;
+    } else {
+      while (num_writers_done.load() != num_writers) {
+        int32_t low = key_dist(generator), high = key_dist(generator);
+        if (low > high) std::swap(low, high);
+        *reinterpret_cast<int32_t *>(low_key_pr->AccessForceNotNull(0)) = low;
+        *reinterpret_cast<int32_t *>(high_key_pr->AccessForceNotNull(0)) = high;
+        std::vector<storage::TupleSlot> ascending, descending;
+        auto *const scan_txn = txn_manager_->BeginTransaction();
+        default_index_->ScanAscending(*scan_txn, *low_key_pr, *high_key_pr, &ascending);
+        default_index_->ScanDescending(*scan_txn, *low_key_pr, *high_key_pr, &descending);
+        const auto keys = KeysOf(scan_txn, ascending);
+        txn_manager_->Commit(scan_txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+        ASSERT_EQ((high - low + 1) * tuples_per_key, keys.size());
+        for (uint32_t j = 0; j < keys.size(); j++) EXPECT_EQ(low + static_cast<int32_t>(j / tuples_per_key), keys[j]);
+        std::reverse(descending.begin(), descending.end());
+        EXPECT_EQ(ascending, descending);
+      }
+    }
+    delete[] key_buffer_1;
+    delete[] key_buffer_2;
+  };
+
+  for (uint32_t i = 0; i < num_threads_; i++) {
+    thread_pool_.SubmitTask([i, &workload] { workload(i); });
+  }
+  thread_pool_.WaitUntilAllFinished();
+}
+
+/**
+ * Fills many leaves with a few tuples per key, some of them not yet committed, and checks that every kind of scan
+ * over random ranges, which mostly start and end in different leaves, finds the visible tuples in the right order.
+ */
+// NOLINTNEXTLINE
+TEST_F(BPlusTreeIndexTests, ScansAcrossLeaves) {
+  const int32_t num_keys = 10000;
+  const uint32_t tuples_per_key = 3;
+  auto *const key_pr = default_index_->GetProjectedRowInitializer().InitializeRow(key_buffer_1_);
+
+  // Key i maps to tuples_per_key committed tuples, and to one more tuple if i % 7 == 0 that is not committed yet
+  std::vector<std::vector<storage::TupleSlot>> reference(num_keys);
+  auto *const insert_txn = txn_manager_->BeginTransaction();
+  for (int32_t key = 0; key < num_keys; key++)
+    for (uint32_t i = 0; i < tuples_per_key; i++) reference[key].push_back(InsertKey(insert_txn, key_pr, key));
+  txn_manager_->Commit(insert_txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+  auto *const uncommitted_txn = txn_manager_->BeginTransaction();
+  for (int32_t key = 0; key < num_keys; key += 7) InsertKey(uncommitted_txn, key_pr, key);
+
+  auto *const scan_txn = txn_manager_->BeginTransaction();
+  auto *const low_key_pr = default_index_->GetProjectedRowInitializer().InitializeRow(key_buffer_1_);
+  auto *const high_key_pr = default_index_->GetProjectedRowInitializer().InitializeRow(key_buffer_2_);
+  std::uniform_int_distribution<int32_t> key_dist(-10, num_keys + 10);
+  const auto slot_less = [](const storage::TupleSlot &a, const storage::TupleSlot &b) {
+    return std::make_pair(a.GetBlock(), a.GetOffset()) < std::make_pair(b.GetBlock(), b.GetOffset());
+  };
+  for (uint32_t i = 0; i < 200; i++) {
+    int32_t low = key_dist(generator_), high = key_dist(generator_);
+    if (low > high) std::swap(low, high);
+    *reinterpret_cast<int32_t *>(low_key_pr->AccessForceNotNull(0)) = low;
+    *reinterpret_cast<int32_t *>(high_key_pr->AccessForceNotNull(0)) = high;
+
+    // Tuples of the same key come back in the order the tree keeps them in, so only compare the sets per key
+    std::vector<storage::TupleSlot> ascending;
+    default_index_->ScanAscending(*scan_txn, *low_key_pr, *high_key_pr, &ascending);
+    const auto keys = KeysOf(scan_txn, ascending);
+    const int32_t first = std::max(low, 0), last = std::min(high, num_keys - 1);
+    ASSERT_EQ((last - first + 1) * tuples_per_key, ascending.size());
+    for (int32_t key = first; key <= last; key++) {
+      const auto begin = ascending.begin() + (key - first) * tuples_per_key;
+      std::vector<storage::TupleSlot> found(begin, begin + tuples_per_key);
+      std::vector<storage::TupleSlot> expected = reference[key];
+      std::sort(found.begin(), found.end(), slot_less);
+      std::sort(expected.begin(), expected.end(), slot_less);
+      EXPECT_EQ(expected, found);
+    }
+    EXPECT_TRUE(std::is_sorted(keys.begin(), keys.end()));
+
+    std::vector<storage::TupleSlot> descending;
+    default_index_->ScanDescending(*scan_txn, *low_key_pr, *high_key_pr, &descending);
+    EXPECT_EQ(std::vector<storage::TupleSlot>(ascending.rbegin(), ascending.rend()), descending);
+
+    if (ascending.empty()) continue;
+    const uint32_t limit = std::uniform_int_distribution<uint32_t>(1, 2 * ascending.size())(generator_);
+    const uint32_t num_expected = std::min<uint32_t>(limit, ascending.size());
+    std::vector<storage::TupleSlot> results;
+    default_index_->ScanLimitAscending(*scan_txn, *low_key_pr, *high_key_pr, &results, limit);
+    EXPECT_EQ(std::vector<storage::TupleSlot>(ascending.begin(), ascending.begin() + num_expected), results);
+    results.clear();
+    default_index_->ScanLimitDescending(*scan_txn, *low_key_pr, *high_key_pr, &results, limit);
+    EXPECT_EQ(std::vector<storage::TupleSlot>(descending.begin(), descending.begin() + num_expected), results);
+  }
+  txn_manager_->Commit(scan_txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+  txn_manager_->Abort(uncommitted_txn);
+}
+
+}  // namespace terrier::storage::index
@@ -0,0 +1,182 @@
+#include "storage/index/bplustree.h"
+#include <algorithm>
+#include <map>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+#include "util/multithread_test_util.h"
+#include "util/test_harness.h"
+
+namespace terrier {
+
+struct BPlusTreeTests : public TerrierTest {
+  using Tree = storage::index::BPlusTree<int64_t>;
+  using Entry = std::pair<int64_t, uintptr_t>;
+
+  // TupleSlots that are never dereferenced by the tree, only compared, so they need not point to real blocks
+  static storage::TupleSlot FakeSlot(const uint32_t block, const uint32_t offset) {
+    return {reinterpret_cast<const storage::RawBlock *>(static_cast<uintptr_t>(block) * common::Constants::BLOCK_SIZE),
+            offset};
+  }
+
+  static uintptr_t SlotBits(const storage::TupleSlot slot) {
+    return reinterpret_cast<uintptr_t>(slot.GetBlock()) | slot.GetOffset();
+  }
+
+  static std::vector<storage::TupleSlot> Ascending(const Tree &tree, const int64_t low, const int64_t high) {
+    std::vector<storage::TupleSlot> result;
+    tree.ScanAscending(low, high, [&](const storage::TupleSlot slot) {
+      result.push_back(slot);
+      return true;
+    });
+    return result;
+  }
+
+  static std::vector<storage::TupleSlot> Descending(const Tree &tree, const int64_t low, const int64_t high) {
+    std::vector<storage::TupleSlot> result;
+    tree.ScanDescending(low, high, [&](const storage::TupleSlot slot) {
+      result.push_back(slot);
+      return true;
+    });
+    return result;
+  }
+
+  // The values of all reference entries with keys between low and high, in ascending order
+  static std::vector<storage::TupleSlot> Expected(const std::map<Entry, storage::TupleSlot> &reference,
+                                                  const int64_t low, const int64_t high) {
+    std::vector<storage::TupleSlot> result;
+    for (auto it = reference.lower_bound({low, 0}); it != reference.end() && it->first.first <= high; ++it)
+      result.push_back(it->second);
+    return result;
+  }
+
+  std::default_random_engine generator_;
+};
+
+// Inserts and deletes random entries, with many values per key, and checks every kind of scan against a reference
+// NOLINTNEXTLINE
+TEST_F(BPlusTreeTests, RandomInsertDeleteScan) {
+  Tree tree;
+  std::map<Entry, storage::TupleSlot> reference;
+  std::uniform_int_distribution<int64_t> key_dist(0, 5000);
+  std::uniform_int_distribution<uint32_t> slot_dist(0, 7);
+  for (uint32_t i = 0; i < 100000; i++) {
+    const int64_t key = key_dist(generator_);
+    const storage::TupleSlot slot = FakeSlot(slot_dist(generator_), slot_dist(generator_));
+    const Entry entry{key, SlotBits(slot)};
+    if (i % 3 == 2) {
+      EXPECT_EQ(reference.erase(entry) == 1, tree.Delete(key, slot));
+    } else {
+      EXPECT_EQ(reference.emplace(entry, slot).second, tree.Insert(key, slot));
+    }
+  }
+
+  EXPECT_EQ(Expected(reference, INT64_MIN, INT64_MAX), Ascending(tree, INT64_MIN, INT64_MAX));
+  for (uint32_t i = 0; i < 1000; i++) {
+    int64_t low = key_dist(generator_), high = key_dist(generator_);
+    if (low > high) std::swap(low, high);
+    const auto expected = Expected(reference, low, high);
+    EXPECT_EQ(expected, Ascending(tree, low, high));
+    EXPECT_EQ(std::vector<storage::TupleSlot>(expected.rbegin(), expected.rend()), Descending(tree, low, high));
+  }
+  // Empty ranges
+  EXPECT_TRUE(Ascending(tree, 10, 9).empty());
+  EXPECT_TRUE(Descending(tree, 10, 9).empty());
+  EXPECT_TRUE(Ascending(tree, 6000, INT64_MAX).empty());
+
+  // Scans stop as soon as the callback says so
+  uint32_t num_visited = 0;
+  tree.ScanDescending(INT64_MIN, INT64_MAX, [&](storage::TupleSlot) { return ++num_visited < 10; });
+  EXPECT_EQ(10, num_visited);
+}
+
+// A conditional insert only goes through if the predicate holds for no value the key already maps to
+// NOLINTNEXTLINE
+TEST_F(BPlusTreeTests, ConditionalInsert) {
+  Tree tree;
+  bool predicate_satisfied;
+  const auto never = [](storage::TupleSlot) { return false; };
+  const auto always = [](storage::TupleSlot) { return true; };
+  EXPECT_TRUE(tree.ConditionalInsert(42, FakeSlot(1, 0), always, &predicate_satisfied));
+  EXPECT_FALSE(predicate_satisfied);
+  EXPECT_FALSE(tree.ConditionalInsert(42, FakeSlot(1, 1), always, &predicate_satisfied));
+  EXPECT_TRUE(predicate_satisfied);
+  EXPECT_TRUE(tree.ConditionalInsert(42, FakeSlot(1, 1), never, &predicate_satisfied));
+  EXPECT_FALSE(predicate_satisfied);
+  // Neighboring keys are not checked
+  EXPECT_TRUE(tree.ConditionalInsert(41, FakeSlot(1, 2), always, &predicate_satisfied));
+  EXPECT_TRUE(tree.ConditionalInsert(43, FakeSlot(1, 3), always, &predicate_satisfied));
+  EXPECT_EQ(std::vector<storage::TupleSlot>({FakeSlot(1, 0), FakeSlot(1, 1)}), Ascending(tree, 42, 42));
+}
+
+// Writers insert and delete their own keys while readers scan. A scan sees entries in order and exactly once, and sees
+// every entry that is not touched during the scan. In the end, the tree holds exactly what the writers left behind.
+// NOLINTNEXTLINE
+TEST_F(BPlusTreeTests, ConcurrentMixed) {
+  const uint32_t num_threads = MultiThreadTestUtil::HardwareConcurrency() + 2;
+  const uint32_t num_writers = num_threads / 2;
+  const int64_t num_keys = 20000 * num_writers;
+  // Every value names its key, so that readers can tell the order of what they see
+  const auto key_slot = [](const int64_t key) { return FakeSlot(static_cast<uint32_t>(key), 0); };
+  const auto slot_key = [](const storage::TupleSlot slot) {
+    return static_cast<int64_t>(SlotBits(slot) / common::Constants::BLOCK_SIZE);
+  };
+  Tree tree;
+  // Even keys are inserted up front and never touched, so that every scan knows some of what it should find
+  for (int64_t key = 0; key < num_keys; key += 2) tree.Insert(key, key_slot(key));
+
+  std::vector<std::set<int64_t>> remaining(num_writers);
+  std::atomic<uint32_t> num_writers_done = 0;
+  common::WorkerPool thread_pool(num_threads, {});
+  auto workload = [&](const uint32_t id) {
+    std::default_random_engine generator(id);
+    if (id < num_writers) {
+      // Writer, owning the odd keys that are its id more than a multiple of the number of writers
+      std::uniform_int_distribution<int64_t> multiple_dist(0, num_keys / 2 / num_writers - 1);
+      for (uint32_t i = 0; i < 20000; i++) {
+        const int64_t key = 2 * (multiple_dist(generator) * num_writers + id) + 1;
+        if (remaining[id].count(key) != 0) {
+          EXPECT_TRUE(tree.Delete(key, key_slot(key)));
+          remaining[id].erase(key);
+        } else {
+          EXPECT_TRUE(tree.Insert(key, key_slot(key)));
+          remaining[id].insert(key);
+        }
+      }
+      num_writers_done++;
+      return;
+    }
+    // Reader, scanning random ranges until the writers are done
+    std::uniform_int_distribution<int64_t> key_dist(0, num_keys);
+    while (num_writers_done.load() != num_writers) {
+      const int64_t low = key_dist(generator), high = low + 1000;
+      const bool ascending = id % 2 == 0;
+      int64_t last = ascending ? low - 1 : high + 1;
+      int64_t num_untouched = 0;
+      auto callback = [&](const storage::TupleSlot slot) {
+        const int64_t key = slot_key(slot);
+        EXPECT_TRUE(ascending ? key > last : key < last);
+        EXPECT_TRUE(low <= key && key <= high);
+        last = key;
+        if (key % 2 == 0) num_untouched++;
+        return true;
+      };
+      if (ascending)
+        tree.ScanAscending(low, high, callback);
+      else
+        tree.ScanDescending(low, high, callback);
+      const int64_t first_even = low + low % 2, last_even = std::min(high - high % 2, num_keys - 2);
+      EXPECT_EQ(last_even < first_even ? 0 : (last_even - first_even) / 2 + 1, num_untouched);
+    }
+  };
+  MultiThreadTestUtil::RunThreadsUntilFinish(&thread_pool, num_threads, workload);
+
+  std::set<int64_t> expected;
+  for (int64_t key = 0; key < num_keys; key += 2) expected.insert(key);
+  for (const auto &keys : remaining) expected.insert(keys.begin(), keys.end());
+  std::vector<storage::TupleSlot> expected_slots;
+  for (const int64_t key : expected) expected_slots.push_back(key_slot(key));
+  EXPECT_EQ(expected_slots, Ascending(tree, INT64_MIN, INT64_MAX));
+}
+}  // namespace terrier
@@ -1,3 +1,4 @@
+#include <atomic>
 #include <memory>
 #include <unordered_map>
 #include <vector>
@@ -117,6 +118,62 @@ TEST_F(DataTableConcurrentTests, ConcurrentInsert) {
   }
 }
 
+// Spawns multiple transactions that insert random tuples, while another thread keeps scanning the table from the
+// beginning. Scans should never block or crash on blocks being added concurrently, every scan should see at least as
+// many tuples as the one before it, and a final scan should see every tuple inserted.
+// NOLINTNEXTLINE
+TEST_F(DataTableConcurrentTests, ConcurrentInsertWithScan) {
+  const uint32_t num_iterations = 10;
+  const uint32_t num_inserts = 100000;
+  const uint16_t max_columns = 20;
+  const uint32_t num_threads = MultiThreadTestUtil::HardwareConcurrency() + 1;
+  common::WorkerPool thread_pool(num_threads, {});
+  for (uint32_t iteration = 0; iteration < num_iterations; iteration++) {
+    storage::BlockLayout layout = StorageTestUtil::RandomLayoutNoVarlen(max_columns, &generator_);
+    storage::DataTable tested(&block_store_, layout, storage::layout_version_t(0));
+    const uint32_t num_writers = num_threads - 1;
+    std::vector<std::unique_ptr<FakeTransaction>> fake_txns;
+    for (uint32_t thread = 0; thread < num_writers; thread++)
+      // timestamps are irrelevant for inserts
+      fake_txns.emplace_back(std::make_unique<FakeTransaction>(layout, &tested, null_ratio_(generator_),
+                                                               transaction::timestamp_t(0), transaction::timestamp_t(0),
+                                                               &buffer_pool_));
+    // The scanning transaction starts after the inserts so all of them are visible to it
+    transaction::TransactionContext scan_txn(transaction::timestamp_t(1), transaction::timestamp_t(1), &buffer_pool_,
+                                             DISABLED);
+    storage::ProjectedColumnsInitializer initializer(layout, StorageTestUtil::ProjectionListAllColumns(layout), 1000);
+    auto *buffer = common::AllocationUtil::AllocateAligned(initializer.ProjectedColumnsSize());
+    storage::ProjectedColumns *columns = initializer.Initialize(buffer);
+    auto count_visible = [&] {
+      uint32_t result = 0;
+      for (auto it = tested.begin(); it != tested.end();) {
+        tested.Scan(&scan_txn, &it, columns);
+        result += columns->NumTuples();
+      }
+      return result;
+    };
+
+    std::atomic<uint32_t> num_finished = 0;
+    auto workload = [&](uint32_t id) {
+      if (id == num_writers) {
+        uint32_t last_count = 0;
+        while (num_finished.load() != num_writers) {
+          const uint32_t count = count_visible();
+          EXPECT_LE(last_count, count);
+          last_count = count;
+        }
+        return;
+      }
+      std::default_random_engine thread_generator(id);
+      for (uint32_t i = 0; i < num_inserts / num_writers; i++) fake_txns[id]->InsertRandomTuple(&thread_generator);
+      num_finished++;
+    };
+    MultiThreadTestUtil::RunThreadsUntilFinish(&thread_pool, num_threads, workload);
+    EXPECT_EQ(num_inserts / num_writers * num_writers, count_visible());
+    delete[] buffer;
+  }
+}
+
 // Spawns multiple transactions that all begin at the same time.
 // Each transaction attempts to update the same tuple.
 // Therefore only one transaction should win, which is what we test for.
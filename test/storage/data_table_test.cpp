@@ -287,6 +287,59 @@ TEST_F(DataTableTests, WriteWriteConflictUpdateFails) {
   }
 }
 
+// Generates a random table layout and inserts 1 random tuple. Then, updates every column of the tuple but only changes
+// the values of some of them. The undo record should only hold the before-image of the changed columns, and Selects
+// at both timestamps should still produce the correct tuple. Repeats for num_iterations.
+// NOLINTNEXTLINE
+TEST_F(DataTableTests, UpdateSkipsUnchangedColumns) {
+  const uint32_t num_iterations = 50;
+  const uint16_t max_columns = 100;
+  std::bernoulli_distribution coin(0.5);
+
+  for (uint32_t iteration = 0; iteration < num_iterations; ++iteration) {
+    RandomDataTableTestObject tested(&block_store_, max_columns, null_ratio_(generator_), &generator_);
+    const storage::BlockLayout &layout = tested.Layout();
+    storage::TupleSlot tuple = tested.InsertRandomTuple(transaction::timestamp_t(0), &generator_, &buffer_pool_);
+
+    // Start the update from a copy of the inserted tuple, and change some of the columns
+    const storage::ProjectedRow *original = tested.GetReferenceVersionedTuple(tuple, transaction::timestamp_t(0));
+    auto *update_buffer = common::AllocationUtil::AllocateAligned(original->Size());
+    std::memcpy(update_buffer, original, original->Size());
+    auto *update = reinterpret_cast<storage::ProjectedRow *>(update_buffer);
+    std::vector<storage::col_id_t> changed;
+    for (uint16_t i = 0; i < update->NumColumns(); i++) {
+      if (!coin(generator_)) continue;
+      const storage::col_id_t col_id = update->ColumnIds()[i];
+      byte *value = update->AccessWithNullCheck(i);
+      if (value == nullptr)
+        std::memset(update->AccessForceNotNull(i), 0, layout.AttrSize(col_id));
+      else
+        value[0] ^= static_cast<byte>(1);
+      changed.push_back(col_id);
+    }
+
+    auto *txn = new transaction::TransactionContext(transaction::timestamp_t(1), transaction::timestamp_t(1),
+                                                    &buffer_pool_, DISABLED);
+    EXPECT_TRUE(tested.GetTable().Update(txn, tuple, *update));
+
+    // Bypass the table to look at the undo record it installed
+    storage::TupleAccessStrategy accessor(layout);
+    auto *undo =
+        *reinterpret_cast<storage::UndoRecord **>(accessor.AccessWithNullCheck(tuple, VERSION_POINTER_COLUMN_ID));
+    ASSERT_NE(nullptr, undo);
+    EXPECT_EQ(changed, std::vector<storage::col_id_t>(undo->Delta()->ColumnIds(),
+                                                      undo->Delta()->ColumnIds() + undo->Delta()->NumColumns()));
+
+    storage::ProjectedRow *stored = tested.SelectIntoBuffer(tuple, transaction::timestamp_t(0), &buffer_pool_);
+    EXPECT_TRUE(StorageTestUtil::ProjectionListEqualShallow(layout, original, stored));
+    stored = tested.SelectIntoBuffer(tuple, transaction::timestamp_t(1), &buffer_pool_);
+    EXPECT_TRUE(StorageTestUtil::ProjectionListEqualShallow(layout, update, stored));
+
+    delete txn;
+    delete[] update_buffer;
+  }
+}
+
 // Test that insertion into a block does not wrap around even in the presence of deleted slots. This makes compaction
 // a lot easier to write.
 // NOLINTNEXTLINE
@@ -24,6 +24,7 @@ class GarbageCollectorDataTableTestObject {
   ~GarbageCollectorDataTableTestObject() {
     for (auto ptr : loose_pointers_) delete[] ptr;
     delete[] select_buffer_;
+    delete[] scan_buffer_;
   }
 
   const storage::BlockLayout &Layout() const { return layout_; }
@@ -67,6 +68,13 @@ class GarbageCollectorDataTableTestObject {
     return select_row;
   }
 
+  storage::ProjectedColumns *ScanIntoBuffer(transaction::TransactionContext *const txn) {
+    storage::ProjectedColumns *columns = scan_initializer_.Initialize(scan_buffer_);
+    auto it = table_.begin();
+    table_.Scan(txn, &it, columns);
+    return columns;
+  }
+
   storage::BlockLayout layout_;
   storage::DataTable table_;
   // We want null_bias_ to be zero when testing CC. We already evaluate null correctness in other directed tests, and
@@ -77,6 +85,9 @@ class GarbageCollectorDataTableTestObject {
       storage::ProjectedRowInitializer::Create(layout_, StorageTestUtil::ProjectionListAllColumns(layout_));
   byte *select_buffer_ = common::AllocationUtil::AllocateAligned(initializer_.ProjectedRowSize());
   bool select_result_;
+  storage::ProjectedColumnsInitializer scan_initializer_{layout_, StorageTestUtil::ProjectionListAllColumns(layout_),
+                                                         100};
+  byte *scan_buffer_ = common::AllocationUtil::AllocateAligned(scan_initializer_.ProjectedColumnsSize());
 };
 
 struct GarbageCollectorTests : public ::terrier::TerrierTest {
@@ -674,4 +685,87 @@ TEST_F(GarbageCollectorTests, InsertUpdate1) {
     EXPECT_EQ(std::make_pair(2U, 0U), gc.PerformGarbageCollection());
   }
 }
+
+// Check that the version synopsis of a block follows the version pointers in it through inserts, updates, deletes and
+// GC, and that scans read the correct versions both when the block is clean and when it is not.
+// NOLINTNEXTLINE
+TEST_F(GarbageCollectorTests, VersionSynopsis) {
+  const uint32_t num_inserts = 10;
+  for (uint32_t iteration = 0; iteration < num_iterations_; ++iteration) {
+    transaction::TimestampManager timestamp_manager;
+    transaction::TransactionManager txn_manager(&timestamp_manager, DISABLED, &buffer_pool_, true, DISABLED);
+    GarbageCollectorDataTableTestObject tested(&block_store_, max_columns_, &generator_);
+    storage::GarbageCollector gc(&timestamp_manager, DISABLED, &txn_manager, DISABLED);
+
+    auto *txn0 = txn_manager.BeginTransaction();
+    std::vector<storage::ProjectedRow *> tuples;
+    std::vector<storage::TupleSlot> slots;
+    for (uint32_t i = 0; i < num_inserts; i++) {
+      tuples.push_back(tested.GenerateRandomTuple(&generator_));
+      slots.push_back(tested.table_.Insert(txn0, *tuples.back()));
+    }
+    storage::RawBlock *block = slots[0].GetBlock();
+    EXPECT_EQ(num_inserts, block->num_versioned_slots_.load());
+    txn_manager.Commit(txn0, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+    // Once the inserts are no longer visible to anyone, the block is clean
+    gc.PerformGarbageCollection();
+    gc.PerformGarbageCollection();
+    EXPECT_EQ(0, block->num_versioned_slots_.load());
+
+    // An uncommitted update dirties the block, and scans need to look past it
+    auto *txn1 = txn_manager.BeginTransaction();
+    storage::ProjectedRow *update = tested.GenerateRandomUpdate(&generator_);
+    EXPECT_TRUE(tested.table_.Update(txn1, slots[0], *update));
+    EXPECT_EQ(1, block->num_versioned_slots_.load());
+
+    auto *txn2 = txn_manager.BeginTransaction();
+    storage::ProjectedColumns *scanned = tested.ScanIntoBuffer(txn2);
+    EXPECT_EQ(num_inserts, scanned->NumTuples());
+    for (uint32_t i = 0; i < scanned->NumTuples(); i++) {
+      storage::ProjectedColumns::RowView row = scanned->InterpretAsRow(i);
+      EXPECT_EQ(slots[i], scanned->TupleSlots()[i]);
+      EXPECT_TRUE(StorageTestUtil::ProjectionListEqualShallow(tested.Layout(), &row, tuples[i]));
+    }
+    txn_manager.Commit(txn1, transaction::TransactionUtil::EmptyCallback, nullptr);
+    txn_manager.Commit(txn2, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+    gc.PerformGarbageCollection();
+    gc.PerformGarbageCollection();
+    EXPECT_EQ(0, block->num_versioned_slots_.load());
+
+    // With the block clean again, scans should see the update in place
+    tuples[0] = tested.GenerateVersionFromUpdate(*update, *tuples[0]);
+    auto *txn3 = txn_manager.BeginTransaction();
+    scanned = tested.ScanIntoBuffer(txn3);
+    EXPECT_EQ(num_inserts, scanned->NumTuples());
+    for (uint32_t i = 0; i < scanned->NumTuples(); i++) {
+      storage::ProjectedColumns::RowView row = scanned->InterpretAsRow(i);
+      EXPECT_EQ(slots[i], scanned->TupleSlots()[i]);
+      EXPECT_TRUE(StorageTestUtil::ProjectionListEqualShallow(tested.Layout(), &row, tuples[i]));
+    }
+
+    // Deleted tuples should disappear from scans once the delete is cleaned up
+    EXPECT_TRUE(tested.table_.Delete(txn3, slots[1]));
+    EXPECT_EQ(1, block->num_versioned_slots_.load());
+    txn_manager.Commit(txn3, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+    gc.PerformGarbageCollection();
+    gc.PerformGarbageCollection();
+    EXPECT_EQ(0, block->num_versioned_slots_.load());
+
+    auto *txn4 = txn_manager.BeginTransaction();
+    scanned = tested.ScanIntoBuffer(txn4);
+    EXPECT_EQ(num_inserts - 1, scanned->NumTuples());
+    for (uint32_t i = 0; i < scanned->NumTuples(); i++) {
+      const uint32_t expected = i == 0 ? 0 : i + 1;
+      storage::ProjectedColumns::RowView row = scanned->InterpretAsRow(i);
+      EXPECT_EQ(slots[expected], scanned->TupleSlots()[i]);
+      EXPECT_TRUE(StorageTestUtil::ProjectionListEqualShallow(tested.Layout(), &row, tuples[expected]));
+    }
+    txn_manager.Commit(txn4, transaction::TransactionUtil::EmptyCallback, nullptr);
+    gc.PerformGarbageCollection();
+    gc.PerformGarbageCollection();
+  }
+}
 }  // namespace terrier
@@ -1,3 +1,5 @@
+#include <algorithm>
+#include <atomic>
 #include <cstring>
 #include <functional>
 #include <limits>
@@ -23,7 +25,11 @@
 
 namespace terrier::storage::index {
 
-class BwTreeIndexTests : public TerrierTest {
+/**
+ * Builds the indexes under test with the index type given as the test parameter, so that every index type runs the
+ * same tests.
+ */
+class IndexTests : public TerrierTest, public ::testing::WithParamInterface<IndexType> {
  private:
   const std::chrono::milliseconds gc_period_{10};
   storage::GarbageCollector *gc_;
@@ -36,7 +42,7 @@ class BwTreeIndexTests : public TerrierTest {
   catalog::IndexSchema default_schema_;
 
  public:
-  BwTreeIndexTests() {
+  IndexTests() {
     auto col = catalog::Schema::Column(
         "attribute", type::TypeId::INTEGER, false,
         parser::ConstantValueExpression(type::TransientValueFactory::GetNull(type::TypeId::INTEGER)));
@@ -50,8 +56,8 @@ class BwTreeIndexTests : public TerrierTest {
                          parser::ColumnValueExpression(CatalogTestUtil::TEST_DB_OID, CatalogTestUtil::TEST_TABLE_OID,
                                                        catalog::col_oid_t(1)));
     StorageTestUtil::ForceOid(&(keycols[0]), catalog::indexkeycol_oid_t(1));
-    unique_schema_ = catalog::IndexSchema(keycols, storage::index::IndexType::BWTREE, true, true, false, true);
-    default_schema_ = catalog::IndexSchema(keycols, storage::index::IndexType::BWTREE, false, false, false, true);
+    unique_schema_ = catalog::IndexSchema(keycols, GetParam(), true, true, false, true);
+    default_schema_ = catalog::IndexSchema(keycols, GetParam(), false, false, false, true);
   }
 
   std::default_random_engine generator_;
@@ -62,7 +68,7 @@ class BwTreeIndexTests : public TerrierTest {
   storage::ProjectedRowInitializer tuple_initializer_ =
       storage::ProjectedRowInitializer::Create(std::vector<uint8_t>{1}, std::vector<uint16_t>{1});
 
-  // BwTreeIndex
+  // Indexes under test
   Index *default_index_, *unique_index_;
   transaction::TimestampManager *timestamp_manager_;
   transaction::DeferredActionManager *deferred_action_manager_;
@@ -72,6 +78,19 @@ class BwTreeIndexTests : public TerrierTest {
 
   common::WorkerPool thread_pool_{num_threads_, {}};
 
+  // Replaces the unique or the default index with a new one over the populated table, which stays under construction
+  // until the builder loads it. The fixture deletes the new index once the GC is done with it.
+  Index *RebuildIndex(const bool unique, IndexBuilder *const builder) {
+    Index **const index = unique ? &unique_index_ : &default_index_;
+    gc_thread_->GetGarbageCollector().UnregisterIndexForGC(common::ManagedPointer<Index>(*index));
+    delete *index;
+    builder->SetKeySchema(unique ? unique_schema_ : default_schema_)
+        .SetSqlTableAndTransactionManager(common::ManagedPointer(sql_table_), txn_manager_);
+    *index = builder->Build();
+    gc_thread_->GetGarbageCollector().RegisterIndexForGC(common::ManagedPointer<Index>(*index));
+    return *index;
+  }
+
  protected:
   void SetUp() override {
     TerrierTest::SetUp();
@@ -112,13 +131,18 @@ class BwTreeIndexTests : public TerrierTest {
   }
 };
 
+/**
+ * Tests that rely on keys being ordered, which run on every ordered index type
+ */
+class OrderedIndexTests : public IndexTests {};
+
 /**
  * This test creates multiple worker threads that all try to insert [0,num_inserts) as tuples in the table and into the
  * primary key index. At completion of the workload, only num_inserts_ txns should have committed with visible versions
  * in the index and table.
  */
 // NOLINTNEXTLINE
-TEST_F(BwTreeIndexTests, UniqueInsert) {
+TEST_P(OrderedIndexTests, UniqueInsert) {
   const uint32_t num_inserts = 100000;  // number of tuples/primary keys for each worker to attempt to insert
   auto workload = [&](uint32_t worker_id) {
     //    auto *const insert_buffer =
@@ -196,7 +220,7 @@ TEST_F(BwTreeIndexTests, UniqueInsert) {
  * visible versions in the index and table.
  */
 // NOLINTNEXTLINE
-TEST_F(BwTreeIndexTests, DefaultInsert) {
+TEST_P(OrderedIndexTests, DefaultInsert) {
   const uint32_t num_inserts = 100000;  // number of tuples/primary keys for each worker to attempt to insert
   auto workload = [&](uint32_t worker_id) {
     auto *const key_buffer =
@@ -263,7 +287,7 @@ TEST_F(BwTreeIndexTests, DefaultInsert) {
  * exactly, etc.)
  */
 // NOLINTNEXTLINE
-TEST_F(BwTreeIndexTests, ScanAscending) {
+TEST_P(OrderedIndexTests, ScanAscending) {
   // populate index with [0..20] even keys
   std::map<int32_t, storage::TupleSlot> reference;
   auto *const insert_txn = txn_manager_->BeginTransaction();
@@ -337,7 +361,7 @@ TEST_F(BwTreeIndexTests, ScanAscending) {
  * exactly, etc.)
  */
 // NOLINTNEXTLINE
-TEST_F(BwTreeIndexTests, ScanDescending) {
+TEST_P(OrderedIndexTests, ScanDescending) {
   // populate index with [0..20] even keys
   std::map<int32_t, storage::TupleSlot> reference;
   auto *const insert_txn = txn_manager_->BeginTransaction();
@@ -410,7 +434,7 @@ TEST_F(BwTreeIndexTests, ScanDescending) {
  * exactly, etc.)
  */
 // NOLINTNEXTLINE
-TEST_F(BwTreeIndexTests, ScanLimitAscending) {
+TEST_P(OrderedIndexTests, ScanLimitAscending) {
   // populate index with [0..20] even keys
   std::map<int32_t, storage::TupleSlot> reference;
   auto *const insert_txn = txn_manager_->BeginTransaction();
@@ -479,7 +503,7 @@ TEST_F(BwTreeIndexTests, ScanLimitAscending) {
  * exactly, etc.)
  */
 // NOLINTNEXTLINE
-TEST_F(BwTreeIndexTests, ScanLimitDescending) {
+TEST_P(OrderedIndexTests, ScanLimitDescending) {
   // populate index with [0..20] even keys
   std::map<int32_t, storage::TupleSlot> reference;
   auto *const insert_txn = txn_manager_->BeginTransaction();
@@ -545,7 +569,7 @@ TEST_F(BwTreeIndexTests, ScanLimitDescending) {
 
 // Verifies that primary key insert fails on write-write conflict
 // NOLINTNEXTLINE
-TEST_F(BwTreeIndexTests, UniqueKey1) {
+TEST_P(OrderedIndexTests, UniqueKey1) {
   auto *txn0 = txn_manager_->BeginTransaction();
 
   // txn 0 inserts into table
@@ -606,7 +630,7 @@ TEST_F(BwTreeIndexTests, UniqueKey1) {
 
 // Verifies that primary key insert fails on visible key conflict
 // NOLINTNEXTLINE
-TEST_F(BwTreeIndexTests, UniqueKey2) {
+TEST_P(OrderedIndexTests, UniqueKey2) {
   auto *txn0 = txn_manager_->BeginTransaction();
 
   // txn 0 inserts into table
@@ -662,7 +686,7 @@ TEST_F(BwTreeIndexTests, UniqueKey2) {
 
 // Verifies that primary key insert fails on same txn trying to insert key twice
 // NOLINTNEXTLINE
-TEST_F(BwTreeIndexTests, UniqueKey3) {
+TEST_P(OrderedIndexTests, UniqueKey3) {
   auto *txn0 = txn_manager_->BeginTransaction();
 
   // txn 0 inserts into table
@@ -713,7 +737,7 @@ TEST_F(BwTreeIndexTests, UniqueKey3) {
 
 // Verifies that primary key insert fails even if conflicting transaction is an uncommitted delete
 // NOLINTNEXTLINE
-TEST_F(BwTreeIndexTests, UniqueKey4) {
+TEST_P(OrderedIndexTests, UniqueKey4) {
   auto *txn0 = txn_manager_->BeginTransaction();
 
   // txn 0 inserts into table
@@ -795,7 +819,7 @@ TEST_F(BwTreeIndexTests, UniqueKey4) {
 //
 // This test confirms that we are not susceptible to the DIRTY READS and UNREPEATABLE READS anomalies
 // NOLINTNEXTLINE
-TEST_F(BwTreeIndexTests, CommitInsert1) {
+TEST_P(OrderedIndexTests, CommitInsert1) {
   auto *txn0 = txn_manager_->BeginTransaction();
 
   // txn 0 inserts into table
@@ -868,7 +892,7 @@ TEST_F(BwTreeIndexTests, CommitInsert1) {
 //
 // This test confirms that we are not susceptible to the DIRTY READS and UNREPEATABLE READS anomalies
 // NOLINTNEXTLINE
-TEST_F(BwTreeIndexTests, CommitInsert2) {
+TEST_P(OrderedIndexTests, CommitInsert2) {
   auto *txn0 = txn_manager_->BeginTransaction();
   auto *txn1 = txn_manager_->BeginTransaction();
 
@@ -940,7 +964,7 @@ TEST_F(BwTreeIndexTests, CommitInsert2) {
 //
 // This test confirms that we are not susceptible to the DIRTY READS and UNREPEATABLE READS anomalies
 // NOLINTNEXTLINE
-TEST_F(BwTreeIndexTests, AbortInsert1) {
+TEST_P(OrderedIndexTests, AbortInsert1) {
   auto *txn0 = txn_manager_->BeginTransaction();
 
   // txn 0 inserts into table
@@ -1012,7 +1036,7 @@ TEST_F(BwTreeIndexTests, AbortInsert1) {
 //
 // This test confirms that we are not susceptible to the DIRTY READS and UNREPEATABLE READS anomalies
 // NOLINTNEXTLINE
-TEST_F(BwTreeIndexTests, AbortInsert2) {
+TEST_P(OrderedIndexTests, AbortInsert2) {
   auto *txn0 = txn_manager_->BeginTransaction();
   auto *txn1 = txn_manager_->BeginTransaction();
 
@@ -1083,7 +1107,7 @@ TEST_F(BwTreeIndexTests, AbortInsert2) {
 //
 // This test confirms that we are not susceptible to the DIRTY READS and UNREPEATABLE READS anomalies
 // NOLINTNEXTLINE
-TEST_F(BwTreeIndexTests, CommitUpdate1) {
+TEST_P(OrderedIndexTests, CommitUpdate1) {
   auto *insert_txn = txn_manager_->BeginTransaction();
 
   // insert_txn inserts into table
@@ -1210,7 +1234,7 @@ TEST_F(BwTreeIndexTests, CommitUpdate1) {
 //
 // This test confirms that we are not susceptible to the DIRTY READS and UNREPEATABLE READS anomalies
 // NOLINTNEXTLINE
-TEST_F(BwTreeIndexTests, CommitUpdate2) {
+TEST_P(OrderedIndexTests, CommitUpdate2) {
   auto *insert_txn = txn_manager_->BeginTransaction();
 
   // insert_txn inserts into table
@@ -1337,7 +1361,7 @@ TEST_F(BwTreeIndexTests, CommitUpdate2) {
 //
 // This test confirms that we are not susceptible to the DIRTY READS and UNREPEATABLE READS anomalies
 // NOLINTNEXTLINE
-TEST_F(BwTreeIndexTests, AbortUpdate1) {
+TEST_P(OrderedIndexTests, AbortUpdate1) {
   auto *insert_txn = txn_manager_->BeginTransaction();
 
   // insert_txn inserts into table
@@ -1464,7 +1488,7 @@ TEST_F(BwTreeIndexTests, AbortUpdate1) {
 //
 // This test confirms that we are not susceptible to the DIRTY READS and UNREPEATABLE READS anomalies
 // NOLINTNEXTLINE
-TEST_F(BwTreeIndexTests, AbortUpdate2) {
+TEST_P(OrderedIndexTests, AbortUpdate2) {
   auto *insert_txn = txn_manager_->BeginTransaction();
 
   // insert_txn inserts into table
@@ -1591,7 +1615,7 @@ TEST_F(BwTreeIndexTests, AbortUpdate2) {
 //
 // This test confirms that we are not susceptible to the DIRTY READS and UNREPEATABLE READS anomalies
 // NOLINTNEXTLINE
-TEST_F(BwTreeIndexTests, CommitDelete1) {
+TEST_P(OrderedIndexTests, CommitDelete1) {
   auto *insert_txn = txn_manager_->BeginTransaction();
 
   // insert_txn inserts into table
@@ -1683,7 +1707,7 @@ TEST_F(BwTreeIndexTests, CommitDelete1) {
 //
 // This test confirms that we are not susceptible to the DIRTY READS and UNREPEATABLE READS anomalies
 // NOLINTNEXTLINE
-TEST_F(BwTreeIndexTests, CommitDelete2) {
+TEST_P(OrderedIndexTests, CommitDelete2) {
   auto *insert_txn = txn_manager_->BeginTransaction();
 
   // insert_txn inserts into table
@@ -1775,7 +1799,7 @@ TEST_F(BwTreeIndexTests, CommitDelete2) {
 //
 // This test confirms that we are not susceptible to the DIRTY READS and UNREPEATABLE READS anomalies
 // NOLINTNEXTLINE
-TEST_F(BwTreeIndexTests, AbortDelete1) {
+TEST_P(OrderedIndexTests, AbortDelete1) {
   auto *insert_txn = txn_manager_->BeginTransaction();
 
   // insert_txn inserts into table
@@ -1868,7 +1892,7 @@ TEST_F(BwTreeIndexTests, AbortDelete1) {
 //
 // This test confirms that we are not susceptible to the DIRTY READS and UNREPEATABLE READS anomalies
 // NOLINTNEXTLINE
-TEST_F(BwTreeIndexTests, AbortDelete2) {
+TEST_P(OrderedIndexTests, AbortDelete2) {
   auto *insert_txn = txn_manager_->BeginTransaction();
 
   // insert_txn inserts into table
@@ -1941,4 +1965,307 @@ TEST_F(BwTreeIndexTests, AbortDelete2) {
   txn_manager_->Commit(txn2, transaction::TransactionUtil::EmptyCallback, nullptr);
 }
 
+/**
+ * Probes a batch of keys, some of which match several tuples, some of which match a tuple that is not yet visible,
+ * and some of which match nothing. Each key's visible matches should come back in its own range of the results.
+ */
+// NOLINTNEXTLINE
+TEST_P(IndexTests, ScanKeyBatch) {
+  const uint32_t num_keys = 1000;
+  auto *const key_pr = default_index_->GetProjectedRowInitializer().InitializeRow(key_buffer_1_);
+
+  // key i maps to i % 3 committed tuples, and to one more tuple if i % 5 == 0 that is not committed yet
+  auto *const insert_txn = txn_manager_->BeginTransaction();
+  for (uint32_t i = 0; i < num_keys; i++) {
+    for (uint32_t j = 0; j < i % 3; j++) {
+      auto *const insert_redo =
+          insert_txn->StageWrite(CatalogTestUtil::TEST_DB_OID, CatalogTestUtil::TEST_TABLE_OID, tuple_initializer_);
+      *reinterpret_cast<int32_t *>(insert_redo->Delta()->AccessForceNotNull(0)) = i;
+      const auto tuple_slot = sql_table_->Insert(insert_txn, insert_redo);
+      *reinterpret_cast<int32_t *>(key_pr->AccessForceNotNull(0)) = i;
+      EXPECT_TRUE(default_index_->Insert(insert_txn, *key_pr, tuple_slot));
+    }
+  }
+  txn_manager_->Commit(insert_txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+  auto *const uncommitted_txn = txn_manager_->BeginTransaction();
+  for (uint32_t i = 0; i < num_keys; i += 5) {
+    auto *const insert_redo =
+        uncommitted_txn->StageWrite(CatalogTestUtil::TEST_DB_OID, CatalogTestUtil::TEST_TABLE_OID, tuple_initializer_);
+    *reinterpret_cast<int32_t *>(insert_redo->Delta()->AccessForceNotNull(0)) = i;
+    const auto tuple_slot = sql_table_->Insert(uncommitted_txn, insert_redo);
+    *reinterpret_cast<int32_t *>(key_pr->AccessForceNotNull(0)) = i;
+    EXPECT_TRUE(default_index_->Insert(uncommitted_txn, *key_pr, tuple_slot));
+  }
+
+  // Probe every key in reverse order, plus keys that were never inserted
+  auto *const scan_txn = txn_manager_->BeginTransaction();
+  const uint32_t key_size = default_index_->GetProjectedRowInitializer().ProjectedRowSize();
+  auto *const batch_buffer = common::AllocationUtil::AllocateAligned(key_size * (num_keys + 10));
+  std::vector<const ProjectedRow *> keys;
+  for (uint32_t i = num_keys + 10; i-- > 0;) {
+    auto *const batch_key =
+        default_index_->GetProjectedRowInitializer().InitializeRow(batch_buffer + key_size * keys.size());
+    *reinterpret_cast<int32_t *>(batch_key->AccessForceNotNull(0)) = i;
+    keys.push_back(batch_key);
+  }
+  std::vector<storage::TupleSlot> results;
+  std::vector<uint32_t> key_ends;
+  default_index_->ScanKeyBatch(*scan_txn, keys, &results, &key_ends);
+
+  ASSERT_EQ(keys.size(), key_ends.size());
+  EXPECT_EQ(key_ends.back(), results.size());
+  const auto slot_less = [](const storage::TupleSlot a, const storage::TupleSlot b) {
+    return std::make_pair(a.GetBlock(), a.GetOffset()) < std::make_pair(b.GetBlock(), b.GetOffset());
+  };
+  std::vector<storage::TupleSlot> expected;
+  for (uint32_t k = 0; k < keys.size(); k++) {
+    default_index_->ScanKey(*scan_txn, *keys[k], &expected);
+    const uint32_t begin = k == 0 ? 0 : key_ends[k - 1];
+    std::vector<storage::TupleSlot> key_results(results.begin() + begin, results.begin() + key_ends[k]);
+    EXPECT_EQ(keys.size() - k - 1 < num_keys ? (keys.size() - k - 1) % 3 : 0, key_results.size());
+    std::sort(expected.begin(), expected.end(), slot_less);
+    std::sort(key_results.begin(), key_results.end(), slot_less);
+    EXPECT_EQ(expected, key_results);
+    expected.clear();
+  }
+
+  txn_manager_->Commit(scan_txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+  txn_manager_->Abort(uncommitted_txn);
+  delete[] batch_buffer;
+}
+
+/**
+ * Populates the table, then builds an index over it while a writer deletes half of the tuples and inserts new ones,
+ * maintaining the index as it goes. Once loaded, the index should hold exactly the visible tuples.
+ */
+// NOLINTNEXTLINE
+TEST_P(IndexTests, BulkLoad) {
+  const uint32_t num_keys = 100000;
+
+  std::vector<storage::TupleSlot> slots;
+  auto *const populate_txn = txn_manager_->BeginTransaction();
+  for (uint32_t i = 0; i < num_keys; i++) {
+    auto *const insert_redo =
+        populate_txn->StageWrite(CatalogTestUtil::TEST_DB_OID, CatalogTestUtil::TEST_TABLE_OID, tuple_initializer_);
+    *reinterpret_cast<int32_t *>(insert_redo->Delta()->AccessForceNotNull(0)) = i;
+    slots.push_back(sql_table_->Insert(populate_txn, insert_redo));
+  }
+  txn_manager_->Commit(populate_txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+  IndexBuilder builder;
+  RebuildIndex(false, &builder);
+  EXPECT_TRUE(default_index_->UnderConstruction());
+
+  // Key i is deleted if it is even, and key num_keys + i is inserted
+  thread_pool_.SubmitTask([&] {
+    auto *const key_buffer =
+        common::AllocationUtil::AllocateAligned(default_index_->GetProjectedRowInitializer().ProjectedRowSize());
+    auto *const write_key = default_index_->GetProjectedRowInitializer().InitializeRow(key_buffer);
+    for (uint32_t i = 0; i < num_keys; i++) {
+      auto *const write_txn = txn_manager_->BeginTransaction();
+      if (i % 2 == 0) {
+        write_txn->StageDelete(CatalogTestUtil::TEST_DB_OID, CatalogTestUtil::TEST_TABLE_OID, slots[i]);
+        EXPECT_TRUE(sql_table_->Delete(write_txn, slots[i]));
+        *reinterpret_cast<int32_t *>(write_key->AccessForceNotNull(0)) = i;
+        default_index_->Delete(write_txn, *write_key, slots[i]);
+      }
+      auto *const insert_redo =
+          write_txn->StageWrite(CatalogTestUtil::TEST_DB_OID, CatalogTestUtil::TEST_TABLE_OID, tuple_initializer_);
+      *reinterpret_cast<int32_t *>(insert_redo->Delta()->AccessForceNotNull(0)) = num_keys + i;
+      const auto tuple_slot = sql_table_->Insert(write_txn, insert_redo);
+      *reinterpret_cast<int32_t *>(write_key->AccessForceNotNull(0)) = num_keys + i;
+      EXPECT_TRUE(default_index_->Insert(write_txn, *write_key, tuple_slot));
+      txn_manager_->Commit(write_txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+    }
+    delete[] key_buffer;
+  });
+
+  EXPECT_TRUE(builder.BulkLoad(default_index_));
+  EXPECT_FALSE(default_index_->UnderConstruction());
+  thread_pool_.WaitUntilAllFinished();
+
+  auto *const key_pr = default_index_->GetProjectedRowInitializer().InitializeRow(key_buffer_1_);
+  auto *const scan_txn = txn_manager_->BeginTransaction();
+  std::vector<storage::TupleSlot> results;
+  for (uint32_t i = 0; i < 2 * num_keys; i++) {
+    *reinterpret_cast<int32_t *>(key_pr->AccessForceNotNull(0)) = i;
+    default_index_->ScanKey(*scan_txn, *key_pr, &results);
+    ASSERT_EQ(i < num_keys && i % 2 == 0 ? 0 : 1, results.size());
+    if (i < num_keys && i % 2 == 1) {
+      EXPECT_EQ(slots[i], results[0]);
+    }
+    results.clear();
+  }
+  txn_manager_->Commit(scan_txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+}
+
+/**
+ * Deletes tuples while the load waits for an older transaction to finish. The deletes maintain the index, but the
+ * snapshot the index is loaded from does not see the deleted tuples, so their entries are never loaded and the deferred
+ * deletes find nothing to remove. The index should put up with that, as it was under construction at the time.
+ */
+// NOLINTNEXTLINE
+TEST_P(IndexTests, BulkLoadDeleteNotLoaded) {
+  const uint32_t num_keys = 1000;
+
+  std::vector<storage::TupleSlot> slots;
+  auto *const populate_txn = txn_manager_->BeginTransaction();
+  for (uint32_t i = 0; i < num_keys; i++) {
+    auto *const insert_redo =
+        populate_txn->StageWrite(CatalogTestUtil::TEST_DB_OID, CatalogTestUtil::TEST_TABLE_OID, tuple_initializer_);
+    *reinterpret_cast<int32_t *>(insert_redo->Delta()->AccessForceNotNull(0)) = i;
+    slots.push_back(sql_table_->Insert(populate_txn, insert_redo));
+  }
+  txn_manager_->Commit(populate_txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+  IndexBuilder builder;
+  RebuildIndex(false, &builder);
+
+  // The load cannot take its snapshot before this transaction is done
+  auto *const blocking_txn = txn_manager_->BeginTransaction();
+  std::atomic<bool> loaded = false;
+  thread_pool_.SubmitTask([&] {
+    EXPECT_TRUE(builder.BulkLoad(default_index_));
+    loaded = true;
+  });
+
+  // Key i is deleted if it is even
+  auto *const key_pr = default_index_->GetProjectedRowInitializer().InitializeRow(key_buffer_1_);
+  auto *const delete_txn = txn_manager_->BeginTransaction();
+  for (uint32_t i = 0; i < num_keys; i += 2) {
+    delete_txn->StageDelete(CatalogTestUtil::TEST_DB_OID, CatalogTestUtil::TEST_TABLE_OID, slots[i]);
+    EXPECT_TRUE(sql_table_->Delete(delete_txn, slots[i]));
+    *reinterpret_cast<int32_t *>(key_pr->AccessForceNotNull(0)) = i;
+    default_index_->Delete(delete_txn, *key_pr, slots[i]);
+  }
+  txn_manager_->Commit(delete_txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+  EXPECT_FALSE(loaded.load());
+  txn_manager_->Commit(blocking_txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+  thread_pool_.WaitUntilAllFinished();
+  EXPECT_FALSE(default_index_->UnderConstruction());
+
+  auto *const scan_txn = txn_manager_->BeginTransaction();
+  std::vector<storage::TupleSlot> results;
+  for (uint32_t i = 0; i < num_keys; i++) {
+    *reinterpret_cast<int32_t *>(key_pr->AccessForceNotNull(0)) = i;
+    default_index_->ScanKey(*scan_txn, *key_pr, &results);
+    ASSERT_EQ(i % 2 == 0 ? 0 : 1, results.size());
+    if (i % 2 == 1) {
+      EXPECT_EQ(slots[i], results[0]);
+    }
+    results.clear();
+  }
+  txn_manager_->Commit(scan_txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+}
+
+/**
+ * Builds an index over the populated table while writers insert new tuples, maintaining the index, and abort every
+ * other transaction. The aborts take their entries out of the index while the load puts its own in. Once loaded, the
+ * index should hold exactly the visible tuples.
+ */
+// NOLINTNEXTLINE
+TEST_P(IndexTests, BulkLoadAbortedInsert) {
+  const uint32_t num_keys = 100000;
+  const uint32_t num_writers = num_threads_ - 1;
+  const uint32_t num_writes = 10000;  // number of inserts for each writer to attempt
+
+  auto *const populate_txn = txn_manager_->BeginTransaction();
+  for (uint32_t i = 0; i < num_keys; i++) {
+    auto *const insert_redo =
+        populate_txn->StageWrite(CatalogTestUtil::TEST_DB_OID, CatalogTestUtil::TEST_TABLE_OID, tuple_initializer_);
+    *reinterpret_cast<int32_t *>(insert_redo->Delta()->AccessForceNotNull(0)) = i;
+    sql_table_->Insert(populate_txn, insert_redo);
+  }
+  txn_manager_->Commit(populate_txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+  IndexBuilder builder;
+  RebuildIndex(false, &builder);
+
+  // Writer w inserts key num_keys + i * num_writers + w, and aborts if i is even
+  auto workload = [&](uint32_t worker_id) {
+    auto *const key_buffer =
+        common::AllocationUtil::AllocateAligned(default_index_->GetProjectedRowInitializer().ProjectedRowSize());
+    auto *const insert_key = default_index_->GetProjectedRowInitializer().InitializeRow(key_buffer);
+    for (uint32_t i = 0; i < num_writes; i++) {
+      const uint32_t key = num_keys + i * num_writers + worker_id;
+      auto *const insert_txn = txn_manager_->BeginTransaction();
+      auto *const insert_redo =
+          insert_txn->StageWrite(CatalogTestUtil::TEST_DB_OID, CatalogTestUtil::TEST_TABLE_OID, tuple_initializer_);
+      *reinterpret_cast<int32_t *>(insert_redo->Delta()->AccessForceNotNull(0)) = key;
+      const auto tuple_slot = sql_table_->Insert(insert_txn, insert_redo);
+      *reinterpret_cast<int32_t *>(insert_key->AccessForceNotNull(0)) = key;
+      EXPECT_TRUE(default_index_->Insert(insert_txn, *insert_key, tuple_slot));
+      if (i % 2 == 0) {
+        txn_manager_->Abort(insert_txn);
+      } else {
+        txn_manager_->Commit(insert_txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+      }
+    }
+    delete[] key_buffer;
+  };
+  for (uint32_t i = 0; i < num_writers; i++) {
+    thread_pool_.SubmitTask([i, &workload] { workload(i); });
+  }
+
+  EXPECT_TRUE(builder.BulkLoad(default_index_));
+  thread_pool_.WaitUntilAllFinished();
+
+  auto *const key_pr = default_index_->GetProjectedRowInitializer().InitializeRow(key_buffer_1_);
+  auto *const scan_txn = txn_manager_->BeginTransaction();
+  std::vector<storage::TupleSlot> results;
+  for (uint32_t i = 0; i < num_keys + num_writes * num_writers; i++) {
+    *reinterpret_cast<int32_t *>(key_pr->AccessForceNotNull(0)) = i;
+    default_index_->ScanKey(*scan_txn, *key_pr, &results);
+    EXPECT_EQ(i < num_keys || (i - num_keys) / num_writers % 2 == 1 ? 1 : 0, results.size());
+    results.clear();
+  }
+  txn_manager_->Commit(scan_txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+}
+
+/**
+ * Builds a unique index over a table holding a duplicate key, which should fail once the duplicate is visible, and
+ * succeed once it is deleted.
+ */
+// NOLINTNEXTLINE
+TEST_P(IndexTests, BulkLoadUnique) {
+  const uint32_t num_keys = 1000;
+
+  storage::TupleSlot duplicate_slot;
+  auto *const populate_txn = txn_manager_->BeginTransaction();
+  for (uint32_t i = 0; i <= num_keys; i++) {
+    auto *const insert_redo =
+        populate_txn->StageWrite(CatalogTestUtil::TEST_DB_OID, CatalogTestUtil::TEST_TABLE_OID, tuple_initializer_);
+    *reinterpret_cast<int32_t *>(insert_redo->Delta()->AccessForceNotNull(0)) = i == num_keys ? 7 : i;
+    duplicate_slot = sql_table_->Insert(populate_txn, insert_redo);
+  }
+  txn_manager_->Commit(populate_txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+  IndexBuilder builder;
+  EXPECT_FALSE(builder.BulkLoad(RebuildIndex(true, &builder)));
+
+  auto *const delete_txn = txn_manager_->BeginTransaction();
+  delete_txn->StageDelete(CatalogTestUtil::TEST_DB_OID, CatalogTestUtil::TEST_TABLE_OID, duplicate_slot);
+  EXPECT_TRUE(sql_table_->Delete(delete_txn, duplicate_slot));
+  txn_manager_->Commit(delete_txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+  // Drop the failed index and build it again
+  EXPECT_TRUE(builder.BulkLoad(RebuildIndex(true, &builder)));
+
+  auto *const key_pr = unique_index_->GetProjectedRowInitializer().InitializeRow(key_buffer_1_);
+  auto *const scan_txn = txn_manager_->BeginTransaction();
+  std::vector<storage::TupleSlot> results;
+  for (uint32_t i = 0; i < num_keys; i++) {
+    *reinterpret_cast<int32_t *>(key_pr->AccessForceNotNull(0)) = i;
+    unique_index_->ScanKey(*scan_txn, *key_pr, &results);
+    EXPECT_EQ(1, results.size());
+    results.clear();
+  }
+  txn_manager_->Commit(scan_txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+}
+
+INSTANTIATE_TEST_CASE_P(AllIndexes, IndexTests,
+                        ::testing::Values(IndexType::BWTREE, IndexType::BPLUSTREE, IndexType::HASHMAP));
+INSTANTIATE_TEST_CASE_P(OrderedIndexes, OrderedIndexTests, ::testing::Values(IndexType::BWTREE, IndexType::BPLUSTREE));
+
 }  // namespace terrier::storage::index
@@ -3,6 +3,7 @@
 #include <vector>
 #include "di/di_help.h"
 #include "di/injectors.h"
+#include "common/worker_pool.h"
 #include "gtest/gtest.h"
 #include "storage/garbage_collector_thread.h"
 #include "util/data_table_test_util.h"
@@ -10,7 +11,7 @@
 namespace terrier {
 class LargeGCTests : public TerrierTest {
  public:
-  void RunTest(const LargeDataTableTestConfiguration &config) {
+  void RunTest(const LargeDataTableTestConfiguration &config, const uint32_t num_gc_threads = 1) {
     for (uint32_t iteration = 0; iteration < config.NumIterations(); iteration++) {
       auto injector = di::make_injector<di::TestBindingPolicy>(
           di::storage_injector(), di::bind<storage::AccessObserver>().in(di::disabled),
@@ -29,7 +30,14 @@ class LargeGCTests : public TerrierTest {
               .named(storage::GarbageCollectorThread::GC_PERIOD)
               .to(std::chrono::milliseconds(10)));
       auto tested = injector.create<std::unique_ptr<LargeDataTableTestObject>>();
+      // The worker pool has to be in place before the GC thread starts collecting
+      std::unique_ptr<common::WorkerPool> gc_worker_pool;
+      if (num_gc_threads > 1) {
+        gc_worker_pool = std::make_unique<common::WorkerPool>(num_gc_threads, common::TaskQueue());
+        injector.create<storage::GarbageCollector *>()->SetWorkerPool(gc_worker_pool.get());
+      }
       auto gc_thread = injector.create<std::unique_ptr<storage::GarbageCollectorThread>>();
+      EXPECT_EQ(injector.create<storage::GarbageCollector *>(), &gc_thread->GetGarbageCollector());
       for (uint32_t batch = 0; batch * config.BatchSize() < config.NumTxns(); batch++) {
         auto result = tested->SimulateOltp(config.BatchSize(), config.NumConcurrentTxns());
         gc_thread->PauseGC();
@@ -181,4 +189,22 @@ TEST_F(LargeGCTests, TPCCishHighThreadWithGC) {
                     .Build();
   RunTest(config);
 }
+
+// This test duplicates TPCCishWithGC with the GC spread over a worker pool, and batches large enough that the GC
+// shards its work among the workers.
+// NOLINTNEXTLINE
+TEST_F(LargeGCTests, TPCCishWithParallelGC) {
+  auto config = LargeDataTableTestConfiguration::Builder()
+                    .SetNumIterations(10)
+                    .SetNumTxns(5000)
+                    .SetBatchSize(1000)
+                    .SetNumConcurrentTxns(MultiThreadTestUtil::HardwareConcurrency())
+                    .SetUpdateSelectRatio({0.4, 0.6})
+                    .SetTxnLength(5)
+                    .SetInitialTableSize(1000)
+                    .SetMaxColumns(20)
+                    .SetVarlenAllowed(true)
+                    .Build();
+  RunTest(config, 4);
+}
 }  // namespace terrier
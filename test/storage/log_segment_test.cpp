@@ -0,0 +1,195 @@
+#include "storage/write_ahead_log/log_segment.h"
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+#include "common/constants.h"
+#include "storage/write_ahead_log/log_codec.h"
+#include "util/test_harness.h"
+
+#define LOG_FILE_NAME "./test_segment.log"
+
+namespace terrier {
+struct LogSegmentTests : public TerrierTest {
+  std::default_random_engine generator_;
+
+  void SetUp() override {
+    TerrierTest::SetUp();
+    RemoveSegments();
+  }
+
+  void TearDown() override {
+    RemoveSegments();
+    TerrierTest::TearDown();
+  }
+
+  static void RemoveSegments() {
+    for (const auto &segment : storage::LogSegmentWriter::ListSegments(LOG_FILE_NAME)) unlink(segment.second.c_str());
+  }
+
+  // Log-like bytes: runs of random bytes repeated a random number of times, so that they compress somewhat
+  std::vector<byte> RandomBytes(const uint32_t size) {
+    std::uniform_int_distribution<uint32_t> byte_dist(0, UINT8_MAX), length_dist(1, 64);
+    std::vector<byte> result;
+    while (result.size() < size) {
+      std::vector<byte> run(length_dist(generator_));
+      for (auto &b : run) b = static_cast<byte>(byte_dist(generator_));
+      for (uint32_t repeat = length_dist(generator_) % 4; repeat < 4 && result.size() < size; repeat++)
+        result.insert(result.end(), run.begin(), run.begin() + std::min<size_t>(run.size(), size - result.size()));
+    }
+    return result;
+  }
+
+  void CheckRoundTrip(const std::vector<byte> &raw) {
+    const auto size = static_cast<uint32_t>(raw.size());
+    std::vector<byte> compressed(storage::LogCodec::CompressBound(size));
+    const uint32_t compressed_size = storage::LogCodec::Compress(raw.data(), size, compressed.data(),
+                                                                 static_cast<uint32_t>(compressed.size()));
+    ASSERT_GT(compressed_size, 0);
+    std::vector<byte> decompressed(size);
+    EXPECT_TRUE(storage::LogCodec::Decompress(compressed.data(), compressed_size, decompressed.data(), size));
+    EXPECT_EQ(raw, decompressed);
+  }
+};
+
+// Compresses and decompresses inputs of various sizes and compressibility
+// NOLINTNEXTLINE
+TEST_F(LogSegmentTests, CodecRoundTrip) {
+  CheckRoundTrip({});
+  CheckRoundTrip(std::vector<byte>(1, static_cast<byte>(42)));
+  CheckRoundTrip(std::vector<byte>(common::Constants::LOG_BUFFER_SIZE, static_cast<byte>(0)));
+  for (uint32_t size = 1; size <= common::Constants::LOG_BUFFER_SIZE; size *= 2) CheckRoundTrip(RandomBytes(size));
+
+  std::uniform_int_distribution<uint32_t> byte_dist(0, UINT8_MAX);
+  std::vector<byte> incompressible(common::Constants::LOG_BUFFER_SIZE);
+  for (auto &b : incompressible) b = static_cast<byte>(byte_dist(generator_));
+  CheckRoundTrip(incompressible);
+  // Incompressible data does not fit in fewer bytes than it has
+  std::vector<byte> compressed(incompressible.size());
+  EXPECT_EQ(0, storage::LogCodec::Compress(incompressible.data(), static_cast<uint32_t>(incompressible.size()),
+                                           compressed.data(), static_cast<uint32_t>(incompressible.size() - 1)));
+}
+
+// Decompressing corrupted bytes should fail instead of reading or writing out of bounds
+// NOLINTNEXTLINE
+TEST_F(LogSegmentTests, CodecRejectsCorruption) {
+  const std::vector<byte> raw = RandomBytes(common::Constants::LOG_BUFFER_SIZE);
+  const auto size = static_cast<uint32_t>(raw.size());
+  std::vector<byte> compressed(storage::LogCodec::CompressBound(size));
+  const uint32_t compressed_size =
+      storage::LogCodec::Compress(raw.data(), size, compressed.data(), static_cast<uint32_t>(compressed.size()));
+  std::vector<byte> decompressed(size);
+  // Truncated input, or the wrong expected size
+  EXPECT_FALSE(storage::LogCodec::Decompress(compressed.data(), compressed_size / 2, decompressed.data(), size));
+  EXPECT_FALSE(storage::LogCodec::Decompress(compressed.data(), compressed_size, decompressed.data(), size - 1));
+  // Random garbage either fails or produces exactly the expected number of bytes
+  std::uniform_int_distribution<uint32_t> pos_dist(0, compressed_size - 1), byte_dist(0, UINT8_MAX);
+  for (uint32_t i = 0; i < 1000; i++) {
+    std::vector<byte> corrupted(compressed.begin(), compressed.begin() + compressed_size);
+    corrupted[pos_dist(generator_)] = static_cast<byte>(byte_dist(generator_));
+    storage::LogCodec::Decompress(corrupted.data(), compressed_size, decompressed.data(), size);
+  }
+  // Every single bit flip is caught by the checksum
+  const uint32_t checksum = storage::LogCodec::Checksum(raw.data(), size);
+  for (uint32_t bit = 0; bit < 8 * 64; bit++) {
+    std::vector<byte> flipped(raw);
+    flipped[bit / 8] ^= static_cast<byte>(1U << (bit % 8));
+    EXPECT_NE(checksum, storage::LogCodec::Checksum(flipped.data(), size));
+  }
+}
+
+// Writes enough buffers to fill several segments, across two writers, and reads them all back from various offsets
+// NOLINTNEXTLINE
+TEST_F(LogSegmentTests, SegmentRoundTrip) {
+  for (const bool compress : {false, true}) {
+    RemoveSegments();
+    std::vector<byte> written;
+    for (uint32_t writer_num = 0; writer_num < 2; writer_num++) {
+      storage::LogSegmentWriter writer(LOG_FILE_NAME, 4 * common::Constants::LOG_BUFFER_SIZE, compress);
+      EXPECT_EQ(written.size(), writer.EndOffset());
+      for (uint32_t i = 0; i < 20; i++) {
+        const auto buffer = RandomBytes(common::Constants::LOG_BUFFER_SIZE);
+        writer.Append(buffer.data(), static_cast<uint32_t>(buffer.size()));
+        written.insert(written.end(), buffer.begin(), buffer.end());
+      }
+      writer.Persist();
+    }
+    EXPECT_GT(storage::LogSegmentWriter::ListSegments(LOG_FILE_NAME).size(), 4);
+
+    for (const uint64_t offset : {uint64_t{0}, uint64_t{1}, uint64_t{5 * common::Constants::LOG_BUFFER_SIZE + 7},
+                                  uint64_t{written.size() - 1}}) {
+      storage::LogSegmentReader reader(LOG_FILE_NAME, offset);
+      std::vector<byte> read(written.size() - offset);
+      EXPECT_TRUE(reader.Read(read.data(), static_cast<uint32_t>(read.size())));
+      EXPECT_FALSE(reader.HasMore());
+      EXPECT_TRUE(std::equal(read.begin(), read.end(), written.begin() + offset));
+    }
+  }
+}
+
+// Removing segments before an offset keeps everything from that offset on readable
+// NOLINTNEXTLINE
+TEST_F(LogSegmentTests, RemoveSegments) {
+  std::vector<byte> written;
+  storage::LogSegmentWriter writer(LOG_FILE_NAME, 2 * common::Constants::LOG_BUFFER_SIZE, false);
+  for (uint32_t i = 0; i < 10; i++) {
+    const auto buffer = RandomBytes(common::Constants::LOG_BUFFER_SIZE);
+    writer.Append(buffer.data(), static_cast<uint32_t>(buffer.size()));
+    written.insert(written.end(), buffer.begin(), buffer.end());
+  }
+  writer.Persist();
+  const uint64_t offset = 4 * common::Constants::LOG_BUFFER_SIZE + 1;
+  writer.RemoveSegmentsBefore(offset);
+  // Every segment holds a single buffer, so the first four are gone
+  EXPECT_EQ(5, storage::LogSegmentWriter::ListSegments(LOG_FILE_NAME).front().first);
+
+  storage::LogSegmentReader reader(LOG_FILE_NAME, offset);
+  std::vector<byte> read(written.size() - offset);
+  EXPECT_TRUE(reader.Read(read.data(), static_cast<uint32_t>(read.size())));
+  EXPECT_FALSE(reader.HasMore());
+  EXPECT_TRUE(std::equal(read.begin(), read.end(), written.begin() + offset));
+
+  // The current segment is never removed
+  writer.RemoveSegmentsBefore(written.size());
+  EXPECT_EQ(1, storage::LogSegmentWriter::ListSegments(LOG_FILE_NAME).size());
+}
+
+// A frame torn by a crash ends its segment. Reading continues in the next segment, which the writer starts where the
+// valid frames ended.
+// NOLINTNEXTLINE
+TEST_F(LogSegmentTests, TornFrame) {
+  std::vector<byte> written;
+  {
+    storage::LogSegmentWriter writer(LOG_FILE_NAME, 0, true);
+    for (uint32_t i = 0; i < 3; i++) {
+      const auto buffer = RandomBytes(common::Constants::LOG_BUFFER_SIZE);
+      writer.Append(buffer.data(), static_cast<uint32_t>(buffer.size()));
+      written.insert(written.end(), buffer.begin(), buffer.end());
+    }
+    writer.Persist();
+  }
+  // Chop the last frame in half
+  const std::string first_segment = storage::LogSegmentWriter::SegmentPath(LOG_FILE_NAME, 1);
+  struct stat segment_stat;
+  ASSERT_EQ(0, stat(first_segment.c_str(), &segment_stat));
+  ASSERT_EQ(0, truncate(first_segment.c_str(), segment_stat.st_size - 100));
+  written.resize(2 * common::Constants::LOG_BUFFER_SIZE);
+
+  {
+    storage::LogSegmentWriter writer(LOG_FILE_NAME, 0, true);
+    EXPECT_EQ(written.size(), writer.EndOffset());
+    const auto buffer = RandomBytes(common::Constants::LOG_BUFFER_SIZE);
+    writer.Append(buffer.data(), static_cast<uint32_t>(buffer.size()));
+    written.insert(written.end(), buffer.begin(), buffer.end());
+    writer.Persist();
+  }
+
+  storage::LogSegmentReader reader(LOG_FILE_NAME);
+  std::vector<byte> read(written.size());
+  EXPECT_TRUE(reader.Read(read.data(), static_cast<uint32_t>(read.size())));
+  EXPECT_FALSE(reader.HasMore());
+  EXPECT_EQ(written, read);
+}
+}  // namespace terrier
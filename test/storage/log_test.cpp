@@ -1,3 +1,4 @@
+#include <atomic>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -28,7 +29,9 @@
 namespace terrier::storage {
 class WriteAheadLoggingTests : public TerrierTest {
  protected:
-  auto Injector(const LargeDataTableTestConfiguration &config) {
+  auto Injector(const LargeDataTableTestConfiguration &config,
+                const std::chrono::milliseconds persist_interval = std::chrono::milliseconds(20),
+                const uint64_t persist_threshold = (1U << 20U)) {
     return di::make_injector<di::TestBindingPolicy>(
         di::storage_injector(), di::bind<AccessObserver>().in(di::disabled),
         di::bind<LargeDataTableTestConfiguration>().to(config),
@@ -48,8 +51,8 @@ class WriteAheadLoggingTests : public TerrierTest {
             .to(std::chrono::microseconds(10)),
         di::bind<std::chrono::milliseconds>()
             .named(storage::LogManager::PERSIST_INTERVAL)
-            .to(std::chrono::milliseconds(20)),
-        di::bind<uint64_t>().named(storage::LogManager::PERSIST_THRESHOLD).to(static_cast<uint64_t>((1U << 20U))));
+            .to(persist_interval),
+        di::bind<uint64_t>().named(storage::LogManager::PERSIST_THRESHOLD).to(persist_threshold));
   }
 
   void SetUp() override {
@@ -386,6 +389,50 @@ TEST_F(WriteAheadLoggingTests, AbortRecordTest) {
   gc->PerformGarbageCollection();
 }
 
+// This test checks that transactions are persisted, and their commit callbacks invoked, as soon as their commit records
+// are written out. The persist interval and threshold are set so that neither would trigger a persist during the test.
+// NOLINTNEXTLINE
+TEST_F(WriteAheadLoggingTests, GroupCommitTest) {
+  auto injector = Injector(LargeDataTableTestConfiguration::Empty(), std::chrono::milliseconds(1000000), UINT64_MAX);
+  auto *log_manager = injector.create<storage::LogManager *>();
+  log_manager->Start();
+
+  // Create SQLTable
+  auto col = catalog::Schema::Column(
+      "attribute", type::TypeId::INTEGER, false,
+      parser::ConstantValueExpression(type::TransientValueFactory::GetNull(type::TypeId::INTEGER)));
+  StorageTestUtil::ForceOid(&(col), catalog::col_oid_t(0));
+  auto table_schema = catalog::Schema(std::vector<catalog::Schema::Column>({col}));
+  storage::SqlTable sql_table(injector.create<storage::BlockStore *>(), table_schema);
+  auto tuple_initializer = sql_table.InitializerForProjectedRow({catalog::col_oid_t(0)});
+
+  auto *txn_manager = injector.create<transaction::TransactionManager *>();
+  const uint32_t num_txns = 100;
+  std::atomic<uint32_t> num_persisted = 0;
+  for (uint32_t i = 0; i < num_txns; i++) {
+    auto *txn = txn_manager->BeginTransaction();
+    auto *insert_redo =
+        txn->StageWrite(CatalogTestUtil::TEST_DB_OID, CatalogTestUtil::TEST_TABLE_OID, tuple_initializer);
+    *reinterpret_cast<int32_t *>(insert_redo->Delta()->AccessForceNotNull(0)) = static_cast<int32_t>(i);
+    sql_table.Insert(txn, insert_redo);
+    txn_manager->Commit(
+        txn, [](void *arg) { (*reinterpret_cast<std::atomic<uint32_t> *>(arg))++; }, &num_persisted);
+  }
+
+  // Give the log manager plenty of time, but far less than the persist interval
+  const auto deadline = std::chrono::high_resolution_clock::now() + std::chrono::seconds(10);
+  while (num_persisted.load() != num_txns && std::chrono::high_resolution_clock::now() < deadline)
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  EXPECT_EQ(num_txns, num_persisted.load());
+
+  log_manager->PersistAndStop();
+
+  // Perform GC, will clean up transactions for us
+  auto *gc = injector.create<storage::GarbageCollector *>();
+  gc->PerformGarbageCollection();
+  gc->PerformGarbageCollection();
+}
+
 // This test verifies that we don't write an abort record for an aborted transaction that never flushed its redo buffer
 // NOLINTNEXTLINE
 TEST_F(WriteAheadLoggingTests, NoAbortRecordTest) {
@@ -1,3 +1,4 @@
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -7,6 +8,8 @@
 #include "main/db_main.h"
 #include "storage/garbage_collector_thread.h"
 #include "storage/index/index_builder.h"
+#include "storage/recovery/checkpoint_log_provider.h"
+#include "storage/recovery/checkpoint_manager.h"
 #include "storage/recovery/disk_log_provider.h"
 #include "storage/recovery/recovery_manager.h"
 #include "storage/sql_table.h"
@@ -22,6 +25,7 @@
 // executions will read old test's data, and the cause of the errors will be hard to identify. Trust me it will drive
 // you nuts...
 #define LOG_FILE_NAME "./test.log"
+#define CHECKPOINT_DIR "."
 
 namespace terrier::storage {
 class RecoveryTests : public TerrierTest {
@@ -31,6 +35,9 @@ class RecoveryTests : public TerrierTest {
   const std::chrono::microseconds log_serialization_interval_{10};
   const std::chrono::milliseconds log_persist_interval_{20};
   const uint64_t log_persist_threshold_ = (1 << 20);  // 1MB
+  // The log is a single file unless a test turns on segments or compression
+  uint64_t log_segment_size_ = 0;
+  bool compress_log_ = false;
 
   std::default_random_engine generator_;
   storage::RecordBufferSegmentPool buffer_pool_{2000, 100};
@@ -61,9 +68,12 @@ class RecoveryTests : public TerrierTest {
     TerrierTest::SetUp();
     // Unlink log file incase one exists from previous test iteration
     unlink(LOG_FILE_NAME);
+    RemoveLogSegments();
+    RemoveCheckpoints();
     thread_registry_ = new common::DedicatedThreadRegistry(DISABLED);
     log_manager_ = new LogManager(LOG_FILE_NAME, num_log_buffers_, log_serialization_interval_, log_persist_interval_,
                                   log_persist_threshold_, &buffer_pool_, common::ManagedPointer(thread_registry_));
+    log_manager_->SetSegmentOptions(log_segment_size_, compress_log_);
     log_manager_->Start();
     timestamp_manager_ = new transaction::TimestampManager;
     deferred_action_manager_ = new transaction::DeferredActionManager(timestamp_manager_);
@@ -86,6 +96,7 @@ class RecoveryTests : public TerrierTest {
   void TearDown() override {
     // Delete log file
     unlink(LOG_FILE_NAME);
+    RemoveCheckpoints();
     TerrierTest::TearDown();
 
     // Destroy recovered catalog if the test has not cleaned it up already
@@ -114,6 +125,18 @@ class RecoveryTests : public TerrierTest {
     delete timestamp_manager_;
     delete log_manager_;
     delete thread_registry_;
+    // Segments can still be started while the log manager stops, so they are only removed once it has
+    RemoveLogSegments();
+  }
+
+  void RemoveLogSegments() {
+    for (const auto &segment : LogSegmentWriter::ListSegments(LOG_FILE_NAME)) unlink(segment.second.c_str());
+  }
+
+  void RemoveCheckpoints() {
+    for (auto path = CheckpointManager::GetLatestCheckpoint(CHECKPOINT_DIR); !path.empty();
+         path = CheckpointManager::GetLatestCheckpoint(CHECKPOINT_DIR))
+      unlink(path.c_str());
   }
 
   catalog::IndexSchema DummyIndexSchema() {
@@ -205,18 +228,37 @@ class RecoveryTests : public TerrierTest {
     gc_thread_ = new storage::GarbageCollectorThread(gc_, gc_period_);
   }
 
-  void RunTest(const LargeSqlTableTestConfiguration &config) {
-    // Run workload
+  void RunTest(const LargeSqlTableTestConfiguration &config, common::WorkerPool *worker_pool = nullptr,
+               bool take_checkpoint = false) {
+    // Run workload, taking a checkpoint halfway through if requested
     auto *tested = new LargeSqlTableTestObject(config, txn_manager_, catalog_, &block_store_, &generator_);
-    tested->SimulateOltp(100, 4);
+    std::string checkpoint_path;
+    if (take_checkpoint) {
+      tested->SimulateOltp(50, 4);
+      CheckpointManager checkpoint_manager(CHECKPOINT_DIR, txn_manager_, common::ManagedPointer(catalog_),
+                                           log_manager_);
+      checkpoint_path = checkpoint_manager.Checkpoint();
+      tested->SimulateOltp(50, 4);
+    } else {
+      tested->SimulateOltp(100, 4);
+    }
 
     ShutdownAndRestartSystem();
 
-    // Instantiate recovery manager, and recover the tables.
-    DiskLogProvider log_provider(LOG_FILE_NAME);
+    // Instantiate recovery manager, and recover the tables. With a checkpoint, only the log after it is replayed.
+    std::unique_ptr<CheckpointLogProvider> checkpoint;
+    uint64_t log_offset = 0;
+    if (take_checkpoint) {
+      EXPECT_EQ(checkpoint_path, CheckpointManager::GetLatestCheckpoint(CHECKPOINT_DIR));
+      checkpoint = std::make_unique<CheckpointLogProvider>(checkpoint_path);
+      log_offset = checkpoint->LogOffset();
+      EXPECT_GT(log_offset, 0);
+    }
+    DiskLogProvider log_provider(LOG_FILE_NAME, log_offset);
     RecoveryManager recovery_manager(&log_provider, common::ManagedPointer(recovery_catalog_), recovery_txn_manager_,
                                      recovery_deferred_action_manager_, common::ManagedPointer(thread_registry_),
-                                     &block_store_);
+                                     &block_store_, worker_pool);
+    if (take_checkpoint) recovery_manager.SetCheckpoint(checkpoint.get());
     recovery_manager.StartRecovery();
     recovery_manager.WaitForRecoveryToFinish();
 
@@ -298,6 +340,85 @@ TEST_F(RecoveryTests, MultiDatabaseTest) {
   RecoveryTests::RunTest(config);
 }
 
+// This test runs the multi-database workload, but replays the log on a worker pool. Transactions that do not conflict
+// are replayed concurrently, and the recovered tables should be the same as with serial replay.
+// NOLINTNEXTLINE
+TEST_F(RecoveryTests, ParallelReplayTest) {
+  LargeSqlTableTestConfiguration config = LargeSqlTableTestConfiguration::Builder()
+                                              .SetNumDatabases(3)
+                                              .SetNumTables(5)
+                                              .SetMaxColumns(5)
+                                              .SetInitialTableSize(100)
+                                              .SetTxnLength(5)
+                                              .SetInsertUpdateSelectDeleteRatio({0.3, 0.5, 0.1, 0.1})
+                                              .SetVarlenAllowed(true)
+                                              .Build();
+  common::WorkerPool worker_pool(4, {});
+  RecoveryTests::RunTest(config, &worker_pool);
+}
+
+// This test takes a checkpoint in the middle of the multi-database workload, and recovers from the checkpoint and the
+// log after it. The log before the checkpoint is truncated, so this only succeeds if the checkpoint has everything that
+// committed before it, catalog included.
+// NOLINTNEXTLINE
+TEST_F(RecoveryTests, CheckpointTest) {
+  LargeSqlTableTestConfiguration config = LargeSqlTableTestConfiguration::Builder()
+                                              .SetNumDatabases(3)
+                                              .SetNumTables(5)
+                                              .SetMaxColumns(5)
+                                              .SetInitialTableSize(100)
+                                              .SetTxnLength(5)
+                                              .SetInsertUpdateSelectDeleteRatio({0.3, 0.5, 0.1, 0.1})
+                                              .SetVarlenAllowed(true)
+                                              .Build();
+  RecoveryTests::RunTest(config, nullptr, true);
+}
+
+class SegmentedLogRecoveryTests : public RecoveryTests {
+ protected:
+  SegmentedLogRecoveryTests() {
+    // Small segments, so that the workloads below span many of them
+    log_segment_size_ = (1 << 14);  // 16KB
+    compress_log_ = true;
+  }
+};
+
+// This test runs the multi-database workload with the log written out as compressed segments. The system restarts
+// before recovery, which starts a new segment after the existing ones, so recovery has to read across segments.
+// NOLINTNEXTLINE
+TEST_F(SegmentedLogRecoveryTests, SegmentedLogTest) {
+  LargeSqlTableTestConfiguration config = LargeSqlTableTestConfiguration::Builder()
+                                              .SetNumDatabases(3)
+                                              .SetNumTables(5)
+                                              .SetMaxColumns(5)
+                                              .SetInitialTableSize(100)
+                                              .SetTxnLength(5)
+                                              .SetInsertUpdateSelectDeleteRatio({0.3, 0.5, 0.1, 0.1})
+                                              .SetVarlenAllowed(true)
+                                              .Build();
+  RecoveryTests::RunTest(config);
+  EXPECT_GT(LogSegmentWriter::ListSegments(LOG_FILE_NAME).size(), 2);
+}
+
+// This test takes a checkpoint with the log written out as compressed segments. The checkpoint deletes the segments
+// before it, and recovery starts reading from the middle of a segment.
+// NOLINTNEXTLINE
+TEST_F(SegmentedLogRecoveryTests, SegmentedLogCheckpointTest) {
+  LargeSqlTableTestConfiguration config = LargeSqlTableTestConfiguration::Builder()
+                                              .SetNumDatabases(3)
+                                              .SetNumTables(5)
+                                              .SetMaxColumns(5)
+                                              .SetInitialTableSize(100)
+                                              .SetTxnLength(5)
+                                              .SetInsertUpdateSelectDeleteRatio({0.3, 0.5, 0.1, 0.1})
+                                              .SetVarlenAllowed(true)
+                                              .Build();
+  RecoveryTests::RunTest(config, nullptr, true);
+  const auto segments = LogSegmentWriter::ListSegments(LOG_FILE_NAME);
+  ASSERT_FALSE(segments.empty());
+  EXPECT_GT(segments.front().first, 1);
+}
+
 // Tests that we correctly process records corresponding to a drop database command.
 // NOLINTNEXTLINE
 TEST_F(RecoveryTests, DropDatabaseTest) {
@@ -0,0 +1,81 @@
+#include "storage/index/tuple_slot_list.h"
+#include <algorithm>
+#include <random>
+#include <utility>
+#include <vector>
+#include "util/test_harness.h"
+
+namespace terrier {
+
+struct TupleSlotListTests : public TerrierTest {
+  // TupleSlots that are never dereferenced by the list, only compared, so they need not point to real blocks
+  static storage::TupleSlot FakeSlot(const uint32_t offset) {
+    return {reinterpret_cast<const storage::RawBlock *>(common::Constants::BLOCK_SIZE), offset};
+  }
+
+  static std::vector<storage::TupleSlot> Sorted(const storage::index::TupleSlotList &list) {
+    std::vector<storage::TupleSlot> result(list.begin(), list.end());
+    std::sort(result.begin(), result.end(), [](const storage::TupleSlot a, const storage::TupleSlot b) {
+      return a.GetOffset() < b.GetOffset();
+    });
+    return result;
+  }
+
+  std::default_random_engine generator_;
+};
+
+// Adds and removes random values, crossing back and forth between inline and spilled storage, and checks the list
+// against a reference after every operation
+// NOLINTNEXTLINE
+TEST_F(TupleSlotListTests, RandomAddRemove) {
+  storage::index::TupleSlotList list(FakeSlot(0));
+  std::vector<storage::TupleSlot> reference{FakeSlot(0)};
+  std::uniform_int_distribution<uint32_t> offset_dist(0, 20);
+  for (uint32_t i = 0; i < 10000; i++) {
+    const storage::TupleSlot slot = FakeSlot(offset_dist(generator_));
+    const auto it = std::find(reference.begin(), reference.end(), slot);
+    if (it != reference.end()) {
+      if (reference.size() == 1) continue;
+      reference.erase(it);
+      EXPECT_TRUE(list.Remove(slot));
+      EXPECT_FALSE(list.Contains(slot));
+    } else {
+      reference.push_back(slot);
+      list.Add(slot);
+      EXPECT_TRUE(list.Contains(slot));
+    }
+    std::sort(reference.begin(), reference.end(), [](const storage::TupleSlot a, const storage::TupleSlot b) {
+      return a.GetOffset() < b.GetOffset();
+    });
+    EXPECT_EQ(reference.size(), list.Size());
+    EXPECT_EQ(reference, Sorted(list));
+  }
+  EXPECT_FALSE(list.Remove(FakeSlot(21)));
+}
+
+// Copies and moves of inline and spilled lists hold the same values, and moved-from lists are empty
+// NOLINTNEXTLINE
+TEST_F(TupleSlotListTests, CopyAndMove) {
+  for (const uint32_t num_values : {1u, storage::index::TupleSlotList::INLINE_CAPACITY, 100u}) {
+    storage::index::TupleSlotList list(FakeSlot(0));
+    for (uint32_t i = 1; i < num_values; i++) list.Add(FakeSlot(i));
+    const auto expected = Sorted(list);
+
+    storage::index::TupleSlotList copy(list);
+    EXPECT_EQ(expected, Sorted(copy));
+    storage::index::TupleSlotList moved(std::move(copy));
+    EXPECT_EQ(expected, Sorted(moved));
+    EXPECT_EQ(0, copy.Size());  // NOLINT (use after move is what's being tested)
+
+    storage::index::TupleSlotList assigned(FakeSlot(1000));
+    for (uint32_t i = 1; i < 10; i++) assigned.Add(FakeSlot(1000 + i));
+    assigned = list;
+    EXPECT_EQ(expected, Sorted(assigned));
+    assigned = std::move(moved);
+    EXPECT_EQ(expected, Sorted(assigned));
+    EXPECT_EQ(0, moved.Size());  // NOLINT (use after move is what's being tested)
+    EXPECT_EQ(expected, Sorted(list));
+  }
+}
+
+}  // namespace terrier
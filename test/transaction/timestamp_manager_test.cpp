@@ -0,0 +1,134 @@
+#include <algorithm>
+#include <random>
+#include <set>
+#include <vector>
+#include "storage/garbage_collector.h"
+#include "transaction/deferred_action_manager.h"
+#include "transaction/transaction_context.h"
+#include "transaction/transaction_manager.h"
+#include "transaction/transaction_util.h"
+#include "util/multithread_test_util.h"
+#include "util/test_harness.h"
+
+namespace terrier {
+
+class TimestampManagerTests : public TerrierTest {
+ protected:
+  void TearDown() override {
+    gc_.PerformGarbageCollection();
+    gc_.PerformGarbageCollection();
+    TerrierTest::TearDown();
+  }
+
+  std::default_random_engine generator_;
+  storage::RecordBufferSegmentPool buffer_pool_ = {10000, 10000};
+  transaction::TimestampManager timestamp_manager_;
+  transaction::DeferredActionManager deferred_action_manager_{&timestamp_manager_};
+  transaction::TransactionManager txn_manager_{&timestamp_manager_, &deferred_action_manager_, &buffer_pool_, true,
+                                               DISABLED};
+  storage::GarbageCollector gc_{&timestamp_manager_, &deferred_action_manager_, &txn_manager_, DISABLED};
+};
+
+// Keeps more transactions open than fit in the first table of active transactions, then finishes them in random
+// order. The oldest transaction reported should always be the oldest one still open.
+// NOLINTNEXTLINE
+TEST_F(TimestampManagerTests, ManyActiveTransactions) {
+  const uint32_t num_txns = 20000;
+  std::vector<transaction::TransactionContext *> txns;
+  std::set<transaction::timestamp_t> open;
+  for (uint32_t i = 0; i < num_txns; i++) {
+    txns.push_back(txn_manager_.BeginTransaction());
+    open.insert(txns.back()->StartTime());
+  }
+  EXPECT_EQ(*open.begin(), timestamp_manager_.OldestTransactionStartTime());
+
+  std::shuffle(txns.begin(), txns.end(), generator_);
+  for (uint32_t i = 0; i < num_txns; i++) {
+    open.erase(txns[i]->StartTime());
+    if (i % 2 == 0)
+      txn_manager_.Commit(txns[i], transaction::TransactionUtil::EmptyCallback, nullptr);
+    else
+      txn_manager_.Abort(txns[i]);
+    if (i % 100 == 0 && !open.empty()) {
+      EXPECT_EQ(*open.begin(), timestamp_manager_.OldestTransactionStartTime());
+    }
+  }
+  EXPECT_EQ(timestamp_manager_.CurrentTime(), timestamp_manager_.OldestTransactionStartTime());
+}
+
+// Many threads begin and commit transactions while the GC thread keeps scanning for the oldest transaction. A
+// transaction should never see an oldest transaction start time after its own.
+// NOLINTNEXTLINE
+TEST_F(TimestampManagerTests, ConcurrentBeginCommit) {
+  const uint32_t num_threads = MultiThreadTestUtil::HardwareConcurrency() + 1;
+  const uint32_t num_txns = 10000;
+  common::WorkerPool thread_pool(num_threads, {});
+  std::atomic<uint32_t> num_finished = 0;
+  auto workload = [&](uint32_t id) {
+    if (id == 0) {
+      // Scanner, keep going until all the others are done
+      while (num_finished.load() != num_threads - 1) gc_.PerformGarbageCollection();
+      return;
+    }
+    for (uint32_t i = 0; i < num_txns; i++) {
+      auto *txn = txn_manager_.BeginTransaction();
+      EXPECT_LE(timestamp_manager_.CachedOldestTransactionStartTime(), txn->StartTime());
+      EXPECT_LE(timestamp_manager_.OldestTransactionStartTime(), txn->StartTime());
+      txn_manager_.Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+    }
+    num_finished++;
+  };
+  MultiThreadTestUtil::RunThreadsUntilFinish(&thread_pool, num_threads, workload);
+  EXPECT_EQ(timestamp_manager_.CurrentTime(), timestamp_manager_.OldestTransactionStartTime());
+}
+
+// A read-only transaction holds back the oldest transaction start time like any other transaction, and gives it up as
+// soon as it commits. It commits at its snapshot, and its callback is invoked right away.
+// NOLINTNEXTLINE
+TEST_F(TimestampManagerTests, ReadOnlyTransaction) {
+  auto *read_only = txn_manager_.BeginReadOnlyTransaction();
+  EXPECT_TRUE(read_only->DeclaredReadOnly());
+  EXPECT_TRUE(read_only->IsReadOnly());
+  auto *writer = txn_manager_.BeginTransaction();
+  EXPECT_FALSE(writer->DeclaredReadOnly());
+  EXPECT_EQ(read_only->StartTime(), timestamp_manager_.OldestTransactionStartTime());
+  txn_manager_.Commit(writer, transaction::TransactionUtil::EmptyCallback, nullptr);
+  EXPECT_EQ(read_only->StartTime(), timestamp_manager_.OldestTransactionStartTime());
+
+  const transaction::timestamp_t time_before_commit = timestamp_manager_.CurrentTime();
+  bool callback_invoked = false;
+  const transaction::timestamp_t commit_time = txn_manager_.Commit(
+      read_only, [](void *arg) { *reinterpret_cast<bool *>(arg) = true; }, &callback_invoked);
+  EXPECT_TRUE(callback_invoked);
+  EXPECT_EQ(read_only->StartTime(), commit_time);
+  EXPECT_EQ(time_before_commit, timestamp_manager_.CurrentTime());
+  EXPECT_EQ(timestamp_manager_.CurrentTime(), timestamp_manager_.OldestTransactionStartTime());
+}
+
+// Many threads check out timestamps with batching turned on. Every timestamp should be unique, and no earlier than the
+// time before it was asked for.
+// NOLINTNEXTLINE
+TEST_F(TimestampManagerTests, BatchedCheckOut) {
+  const uint32_t num_threads = MultiThreadTestUtil::HardwareConcurrency() + 1;
+  const uint32_t num_checkouts = 10000;
+  transaction::TimestampManager batched_timestamp_manager(true);
+  std::vector<std::vector<transaction::timestamp_t>> checked_out(num_threads);
+  common::WorkerPool thread_pool(num_threads, {});
+  auto workload = [&](uint32_t id) {
+    for (uint32_t i = 0; i < num_checkouts; i++) {
+      const transaction::timestamp_t before = batched_timestamp_manager.CurrentTime();
+      checked_out[id].push_back(batched_timestamp_manager.CheckOutTimestamp());
+      EXPECT_LE(before, checked_out[id].back());
+      if (i > 0) {
+        EXPECT_LT(checked_out[id][i - 1], checked_out[id][i]);
+      }
+    }
+  };
+  MultiThreadTestUtil::RunThreadsUntilFinish(&thread_pool, num_threads, workload);
+
+  std::set<transaction::timestamp_t> unique;
+  for (const auto &timestamps : checked_out) unique.insert(timestamps.begin(), timestamps.end());
+  EXPECT_EQ(num_threads * num_checkouts, unique.size());
+  EXPECT_EQ(transaction::timestamp_t(num_threads * num_checkouts), batched_timestamp_manager.CurrentTime());
+}
+}  // namespace terrier
@@ -10,7 +10,7 @@ bool OrderStatus::Execute(transaction::TransactionManager *const txn_manager, Da
                           const TransactionArgs &args) const {
   TERRIER_ASSERT(args.type_ == TransactionType::OrderStatus, "Wrong transaction type.");
 
-  auto *const txn = txn_manager->BeginTransaction();
+  auto *const txn = txn_manager->BeginReadOnlyTransaction();
 
   storage::TupleSlot customer_slot;
   std::vector<storage::TupleSlot> index_scan_results;
@@ -10,7 +10,7 @@ bool StockLevel::Execute(transaction::TransactionManager *const txn_manager, Dat
   TERRIER_ASSERT(args.type_ == TransactionType::StockLevel, "Wrong transaction type.");
   // ARGS: W_ID, D_ID, S_QUANTITY_THRESHOLD
 
-  auto *const txn = txn_manager->BeginTransaction();
+  auto *const txn = txn_manager->BeginReadOnlyTransaction();
   std::vector<storage::TupleSlot> index_scan_results;
 
   // Look up D_W_ID and D_ID, retrieve D_NEXT_O_ID
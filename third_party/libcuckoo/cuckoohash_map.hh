@@ -478,6 +478,25 @@ class cuckoohash_map {
     }
   }
 
+  /**
+   * Prefetches the two buckets that @p key can live in, and the locks that
+   * guard them, so that a lookup of @p key soon after is less likely to miss
+   * the cache. Takes no locks, so the table may change before the lookup, in
+   * which case the lookup is still correct, only slower.
+   *
+   * @tparam K type of the key. This can be any type comparable with @c key_type
+   * @param key the key to prefetch the buckets of
+   */
+  template <typename K>
+  void prefetch(const K &key) const {
+    const hash_value hv = hashed_key(key);
+    const size_type hp = hashpower();
+    const size_type i1 = index_hash(hp, hv.hash);
+    const size_type i2 = alt_index(hp, hv.partial, i1);
+    prefetch_bucket(i1);
+    prefetch_bucket(i2);
+  }
+
   /**
    * Searches the table for @p key, and invokes @p fn on the value. @p fn is
    * allow to modify the contents of the value if found.
@@ -743,6 +762,16 @@ class cuckoohash_map {
     return hash_function()(key);
   }
 
+  // prefetch_bucket prefetches the first and last lines of a bucket, which
+  // hold the first slots and the partial keys and occupancy flags, and the
+  // lock of the bucket.
+  void prefetch_bucket(const size_type ind) const {
+    const char *const b = reinterpret_cast<const char *>(&buckets_[ind]);
+    __builtin_prefetch(b);
+    __builtin_prefetch(b + sizeof(bucket) - 1);
+    __builtin_prefetch(&get_current_locks()[lock_ind(ind)]);
+  }
+
   // hashsize returns the number of buckets corresponding to a given
   // hashpower.
   static inline size_type hashsize(const size_type hp) { return size_type(1) << hp; }
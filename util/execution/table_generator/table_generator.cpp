@@ -3,6 +3,7 @@
 #include <memory>
 #include <random>
 #include <string>
+#include <type_traits>
 #include <utility>
 #include <vector>
 #include "execution/util/bit_util.h"
@@ -19,7 +20,9 @@ T *TableGenerator::CreateNumberColumnData(Dist dist, uint32_t num_vals, uint64_t
   switch (dist) {
     case Dist::Uniform: {
       std::mt19937 generator{};
-      std::uniform_int_distribution<T> distribution(static_cast<T>(min), static_cast<T>(max));
+      std::conditional_t<std::is_floating_point_v<T>, std::uniform_real_distribution<T>,
+                         std::uniform_int_distribution<T>>
+          distribution(static_cast<T>(min), static_cast<T>(max));
 
       for (uint32_t i = 0; i < num_vals; i++) {
         val[i] = distribution(generator);
@@ -41,6 +44,21 @@ T *TableGenerator::CreateNumberColumnData(Dist dist, uint32_t num_vals, uint64_t
   return val;
 }
 
+// Create strings holding the decimal representation of integers with the given distribution. They are short enough to
+// be inlined in the VarlenEntry.
+storage::VarlenEntry *TableGenerator::CreateVarcharColumnData(Dist dist, uint32_t num_vals, uint64_t min,
+                                                              uint64_t max) {
+  auto *nums = CreateNumberColumnData<uint32_t>(dist, num_vals, min, max);
+  auto *val = new storage::VarlenEntry[num_vals];
+  for (uint32_t i = 0; i < num_vals; i++) {
+    const std::string str = std::to_string(nums[i]);
+    val[i] = storage::VarlenEntry::CreateInline(reinterpret_cast<const byte *>(str.data()),
+                                                static_cast<uint32_t>(str.size()));
+  }
+  delete[] nums;
+  return val;
+}
+
 // Generate column data
 std::pair<byte *, uint32_t *> TableGenerator::GenerateColumnData(const ColumnInsertMeta &col_meta, uint32_t num_rows) {
   // Create data
@@ -59,12 +77,21 @@ std::pair<byte *, uint32_t *> TableGenerator::GenerateColumnData(const ColumnIns
           CreateNumberColumnData<int32_t>(col_meta.dist_, num_rows, col_meta.min_, col_meta.max_));
       break;
     }
-    case type::TypeId::BIGINT:
-    case type::TypeId::DECIMAL: {
+    case type::TypeId::BIGINT: {
       col_data = reinterpret_cast<byte *>(
           CreateNumberColumnData<int64_t>(col_meta.dist_, num_rows, col_meta.min_, col_meta.max_));
       break;
     }
+    case type::TypeId::DECIMAL: {
+      col_data = reinterpret_cast<byte *>(
+          CreateNumberColumnData<double>(col_meta.dist_, num_rows, col_meta.min_, col_meta.max_));
+      break;
+    }
+    case type::TypeId::VARCHAR: {
+      col_data = reinterpret_cast<byte *>(
+          CreateVarcharColumnData(col_meta.dist_, num_rows, col_meta.min_, col_meta.max_));
+      break;
+    }
     default: {
       throw std::runtime_error("Implement me!");
     }
@@ -126,7 +153,8 @@ void TableGenerator::FillTable(catalog::table_oid_t table_oid, common::ManagedPo
           redo->Delta()->SetNull(offset);
         } else {
           byte *data = redo->Delta()->AccessForceNotNull(offset);
-          uint32_t elem_size = type::TypeUtil::GetTypeSize(table_meta.col_meta_[k].type_);
+          // Strip the bit marking VARCHAR columns as variable-length, leaving the size of a VarlenEntry
+          uint32_t elem_size = type::TypeUtil::GetTypeSize(table_meta.col_meta_[k].type_) & INT8_MAX;
           std::memcpy(data, column_data[k].first + j * elem_size, elem_size);
         }
       }
@@ -169,6 +197,14 @@ void TableGenerator::GenerateTestTables() {
         {"col3", type::TypeId::BIGINT, false, Dist::Uniform, 0, common::Constants::K_DEFAULT_VECTOR_SIZE},
         {"col4", type::TypeId::INTEGER, true, Dist::Uniform, 0, 2 * common::Constants::K_DEFAULT_VECTOR_SIZE}}},
 
+      // Table 3, with columns of other types
+      {"test_3",
+       TEST3_SIZE,
+       {{"colA", type::TypeId::INTEGER, false, Dist::Serial, 0, 0},
+        {"colB", type::TypeId::DECIMAL, false, Dist::Serial, 0, 0},
+        {"colC", type::TypeId::VARCHAR, false, Dist::Serial, 0, 0},
+        {"colD", type::TypeId::INTEGER, true, Dist::Uniform, 0, 9}}},
+
       // Empty table with two columns
       {"empty_table2",
        0,
@@ -179,7 +215,13 @@ void TableGenerator::GenerateTestTables() {
     // Create Schema.
     std::vector<catalog::Schema::Column> cols;
     for (const auto &col_meta : table_meta.col_meta_) {
-      cols.emplace_back(col_meta.name_, col_meta.type_, col_meta.nullable_, DummyCVE());
+      if (col_meta.type_ == type::TypeId::VARCHAR) {
+        // Generated strings are always inlined
+        cols.emplace_back(col_meta.name_, col_meta.type_, storage::VarlenEntry::InlineThreshold(), col_meta.nullable_,
+                          DummyCVE());
+      } else {
+        cols.emplace_back(col_meta.name_, col_meta.type_, col_meta.nullable_, DummyCVE());
+      }
     }
     catalog::Schema tmp_schema(cols);
     // Create Table.
@@ -22,6 +22,10 @@ constexpr uint32_t TEST1_SIZE = 10000;
  * Size of the second table
  */
 constexpr uint32_t TEST2_SIZE = 1000;
+/**
+ * Size of the third table
+ */
+constexpr uint32_t TEST3_SIZE = 1000;
 
 /**
  * Helper class to generate test tables and their indexes.
@@ -172,6 +176,9 @@ class TableGenerator {
   template <typename T>
   T *CreateNumberColumnData(Dist dist, uint32_t num_vals, uint64_t min, uint64_t max);
 
+  // Create string data from integers with the given distribution
+  storage::VarlenEntry *CreateVarcharColumnData(Dist dist, uint32_t num_vals, uint64_t min, uint64_t max);
+
   // Generate column data
   std::pair<byte *, uint32_t *> GenerateColumnData(const ColumnInsertMeta &col_meta, uint32_t num_rows);
 